@@ -0,0 +1,275 @@
+/* bench_flux.cpp — flux decode micro-benchmark (src/hw/flux).
+ *
+ * Purpose: time the SCP decode pipeline on a FIXED, deterministic disc so a
+ * change to the PLL or the MFM extraction is measured, not guessed. The disc
+ * is synthesized here — 80 cylinders × 5 captured revolutions of AMSDOS-format
+ * tracks (9 × 512-byte sectors), +1% spindle speed and ±5% per-interval
+ * jitter — or read from a real dump with --scp.
+ *
+ * Three timed passes over every (cylinder, revolution):
+ *   - DECODE  flux_decode_track_rev: PLL → MFM → sector map, what the FDC and
+ *             the predecode pool run (docs/hardware/flux-media.md §7, §7a);
+ *   - PLL     flux_pll_bitcells, the fixed-point PLL alone;
+ *   - REF     flux_pll_bitcells reference = 1, the double-precision PLL the
+ *             fixed-point one replaced (§2).
+ * PLL and REF must agree bitcell for bitcell on every track (IDENTICAL=yes);
+ * the FluxPll tests hold the same line on the test corpus.
+ *
+ * Usage: koncepcja_bench_flux [--scp PATH] [--repeat N] [--quiet]
+ *   Prints a human line to stderr and a machine-readable line to stdout:
+ *     DECODE_MS=<ms> PLL_MS=<ms> REF_MS=<ms> TRACKS=<n> SECTORS=<n>
+ *     CKSUM=<hex> IDENTICAL=<yes|no>
+ *   Times are per pass over the whole disc, best of N. The checksum covers
+ *   every decoded sector map and payload, so a fast-but-wrong build shows.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "hw/flux.h"
+
+namespace {
+
+constexpr int kCyls = 80;
+constexpr int kRevs = 5;
+
+std::vector<uint8_t> read_file(const char* path) {
+  std::ifstream f(path, std::ios::binary);
+  return std::vector<uint8_t>((std::istreambuf_iterator<char>(f)),
+                              std::istreambuf_iterator<char>());
+}
+
+// ------------------------------------------------------ disc synthesis ----
+// A compact copy of the test-side encoder (test/hw/flux_synth.h): sector
+// map → MFM bitcells → flux intervals → SCP container.
+
+uint16_t crc_ccitt(uint16_t crc, uint8_t b) {
+  crc ^= static_cast<uint16_t>(b) << 8;
+  for (int i = 0; i < 8; i++)
+    crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                         : static_cast<uint16_t>(crc << 1);
+  return crc;
+}
+
+struct Mfm {
+  std::vector<uint8_t> bits;  // one 0/1 per bitcell
+  int last = 0;
+  void byte(uint8_t d) {
+    for (int k = 7; k >= 0; k--) {
+      const int bit = (d >> k) & 1;
+      bits.push_back(static_cast<uint8_t>((!last && !bit) ? 1 : 0));
+      bits.push_back(static_cast<uint8_t>(bit));
+      last = bit;
+    }
+  }
+  void raw16(uint16_t w) {
+    for (int k = 15; k >= 0; k--)
+      bits.push_back(static_cast<uint8_t>((w >> k) & 1));
+    last = w & 1;
+  }
+  void gap(int n, uint8_t v) {
+    for (int i = 0; i < n; i++) byte(v);
+  }
+};
+
+// Deterministic PRNG (LCG) — no wall-clock seeding.
+struct Prng {
+  uint32_t s;
+  double unit() {
+    s = s * 1664525u + 1013904223u;
+    return static_cast<double>(s >> 8) / 16777216.0;
+  }
+};
+
+std::vector<uint8_t> track_bits(int cyl, Prng* rng) {
+  Mfm t;
+  t.gap(80, 0x4E);
+  t.gap(12, 0x00);
+  for (int i = 0; i < 3; i++) t.raw16(0x5224);
+  t.byte(0xFC);
+  t.gap(50, 0x4E);
+  uint16_t preset = 0xFFFF;
+  for (int i = 0; i < 3; i++) preset = crc_ccitt(preset, 0xA1);
+  for (int s = 0; s < 9; s++) {
+    const uint8_t id[4] = {static_cast<uint8_t>(cyl), 0,
+                           static_cast<uint8_t>(0xC1 + s), 2};
+    t.gap(12, 0x00);
+    for (int i = 0; i < 3; i++) t.raw16(0x4489);
+    t.byte(0xFE);
+    uint16_t crc = crc_ccitt(preset, 0xFE);
+    for (uint8_t b : id) {
+      t.byte(b);
+      crc = crc_ccitt(crc, b);
+    }
+    t.byte(static_cast<uint8_t>(crc >> 8));
+    t.byte(static_cast<uint8_t>(crc & 0xFF));
+    t.gap(22, 0x4E);
+    t.gap(12, 0x00);
+    for (int i = 0; i < 3; i++) t.raw16(0x4489);
+    t.byte(0xFB);
+    crc = crc_ccitt(preset, 0xFB);
+    for (int i = 0; i < 512; i++) {  // real-looking data, not one fill byte
+      const uint8_t b = static_cast<uint8_t>(rng->unit() * 256.0);
+      t.byte(b);
+      crc = crc_ccitt(crc, b);
+    }
+    t.byte(static_cast<uint8_t>(crc >> 8));
+    t.byte(static_cast<uint8_t>(crc & 0xFF));
+    t.gap(54, 0x4E);
+  }
+  t.gap(120, 0x4E);
+  return t.bits;
+}
+
+void put32(std::vector<uint8_t>& f, size_t off, uint32_t v) {
+  for (int i = 0; i < 4; i++) f[off + i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+std::vector<uint8_t> synth_scp() {
+  Prng data{0x5EED}, jit{0xC0FFEE};
+  std::vector<uint8_t> f(0x2B0, 0);
+  std::memcpy(f.data(), "SCP", 3);
+  f[0x03] = 0x22;
+  f[0x05] = kRevs;
+  f[0x07] = static_cast<uint8_t>((kCyls - 1) * 2);
+  f[0x08] = 0x01;  // index-cued; 16-bit cells, side 0, 25 ns ticks
+  f[0x0A] = 1;
+  for (int c = 0; c < kCyls; c++) {
+    const std::vector<uint8_t> bits = track_bits(c, &data);
+    const size_t tdh = f.size();
+    put32(f, 0x10 + 4 * (c * 2), static_cast<uint32_t>(tdh));
+    f.insert(f.end(), {'T', 'R', 'K', static_cast<uint8_t>(c * 2)});
+    f.resize(f.size() + 12 * kRevs, 0);
+    for (int r = 0; r < kRevs; r++) {
+      const size_t data_off = f.size() - tdh;
+      uint32_t duration = 0, words = 0;
+      int run = 0;
+      for (uint8_t b : bits) {
+        run++;
+        if (!b) continue;
+        const double t =
+            run * 80.0 * 1.01 * (1.0 + 0.05 * (2.0 * jit.unit() - 1.0));
+        const uint32_t v = static_cast<uint32_t>(t + 0.5);
+        f.push_back(static_cast<uint8_t>(v >> 8));  // flux words: big-endian
+        f.push_back(static_cast<uint8_t>(v & 0xFF));
+        duration += v;
+        words++;
+        run = 0;
+      }
+      put32(f, tdh + 4 + 12 * r, duration);
+      put32(f, tdh + 8 + 12 * r, words);
+      put32(f, tdh + 12 + 12 * r, static_cast<uint32_t>(data_off));
+    }
+  }
+  uint32_t sum = 0;
+  for (size_t i = 0x10; i < f.size(); i++) sum += f[i];
+  put32(f, 0x0C, sum);
+  return f;
+}
+
+double ms_since(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - t0)
+      .count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* scp_path = nullptr;
+  int repeat = 3;
+  bool quiet = false;
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--scp") && i + 1 < argc) scp_path = argv[++i];
+    else if (!std::strcmp(argv[i], "--repeat") && i + 1 < argc) repeat = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--quiet")) quiet = true;
+  }
+  if (repeat < 1) repeat = 1;
+
+  const std::vector<uint8_t> scp = scp_path ? read_file(scp_path) : synth_scp();
+  if (!flux_scp_probe(scp.data(), scp.size())) {
+    std::fprintf(stderr, "bench_flux: %s is not a supported SCP dump\n",
+                 scp_path ? scp_path : "(synthesized disc)");
+    return 1;
+  }
+  const int cyls = flux_scp_cylinders(scp.data(), scp.size());
+  const int revs = flux_scp_revolutions(scp.data(), scp.size());
+
+  std::vector<uint8_t> payload(8192);
+  std::vector<uint8_t> fixed(1 << 16), ref(1 << 16);
+  double decode_ms = 1e30, pll_ms = 1e30, ref_ms = 1e30;
+  long sectors = 0;
+  uint32_t cksum = 0;
+  for (int pass = 0; pass < repeat; ++pass) {
+    sectors = 0;
+    cksum = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int c = 0; c < cyls; c++) {
+      for (int r = 0; r < revs; r++) {
+        FluxTrack ft;
+        flux_decode_track_rev(scp.data(), scp.size(), static_cast<uint8_t>(c),
+                              static_cast<uint8_t>(r), &ft, payload.data(),
+                              payload.size());
+        sectors += ft.count;
+        for (int i = 0; i < ft.count; i++)
+          cksum = cksum * 7 + ft.sec[i].idam_cell * 3 + ft.sec[i].data_cell;
+        for (uint32_t i = 0; i < ft.payload_used; i++)
+          cksum = cksum * 31 + payload[i];
+      }
+    }
+    const double d = ms_since(t0);
+    if (d < decode_ms) decode_ms = d;
+
+    for (int which = 0; which < 2; ++which) {
+      std::vector<uint8_t>& out = which ? ref : fixed;
+      t0 = std::chrono::steady_clock::now();
+      for (int c = 0; c < cyls; c++)
+        for (int r = 0; r < revs; r++)
+          flux_pll_bitcells(scp.data(), scp.size(), static_cast<uint8_t>(c),
+                            static_cast<uint8_t>(r), which, out.data(),
+                            out.size());
+      const double p = ms_since(t0);
+      double& best = which ? ref_ms : pll_ms;
+      if (p < best) best = p;
+    }
+  }
+
+  // Untimed: the two PLLs agree on every track.
+  bool identical = true;
+  for (int c = 0; c < cyls && identical; c++) {
+    for (int r = 0; r < revs && identical; r++) {
+      const long nf = flux_pll_bitcells(scp.data(), scp.size(),
+                                        static_cast<uint8_t>(c),
+                                        static_cast<uint8_t>(r), 0,
+                                        fixed.data(), fixed.size());
+      const long nr = flux_pll_bitcells(scp.data(), scp.size(),
+                                        static_cast<uint8_t>(c),
+                                        static_cast<uint8_t>(r), 1, ref.data(),
+                                        ref.size());
+      identical = nf == nr &&
+                  (nf <= 0 || std::memcmp(fixed.data(), ref.data(),
+                                          static_cast<size_t>((nf + 7) / 8)) == 0);
+    }
+  }
+
+  if (!quiet) {
+    std::fprintf(stderr,
+                 "bench_flux: %d cyl x %d rev  decode %.1f ms  (PLL %.1f ms, "
+                 "reference PLL %.1f ms = %.2fx)  %ld sectors  cksum=%08x  "
+                 "bitcells %s\n",
+                 cyls, revs, decode_ms, pll_ms, ref_ms, ref_ms / pll_ms,
+                 sectors, cksum, identical ? "identical" : "DIFFER");
+  }
+  std::printf(
+      "DECODE_MS=%.2f PLL_MS=%.2f REF_MS=%.2f TRACKS=%d SECTORS=%ld "
+      "CKSUM=%08x IDENTICAL=%s\n",
+      decode_ms, pll_ms, ref_ms, cyls * revs, sectors, cksum,
+      identical ? "yes" : "no");
+  return identical ? 0 : 2;
+}
@@ -38,8 +38,9 @@ constexpr OptionSpec kOptions[] = {
     {'H', "headless", false},  {'h', "help", false},
     {'i', "inject", true},     {'L', "list-plugins", false},
     {'o', "offset", true},     {'O', "override", true},
-    {'s', "sym_file", true},   {'V', "version", false},
-    {'v', "verbose", false},
+    {'R', "render-audio", true}, {'U', "render-until", true},
+    {'Y', "render-ym", true},  {'s', "sym_file", true},
+    {'V', "version", false},   {'v', "verbose", false},
 };
 
 const OptionSpec* findShort(char name) {
@@ -95,6 +96,13 @@ void usage(std::ostream& os, const char* progPath, int errcode) {
         "provided with -i (default: 0x6000)\n";
   os << "   -O/--override:          override an option from the config. Can be "
         "repeated. (example: -O system.model=3)\n";
+  os << "   -R/--render-audio=<wav>: render audio offline (headless, "
+        "unpaced) for the\n";
+  os << "      --exit-after length once the autocmd is typed, then exit.\n";
+  os << "   -Y/--render-ym=<file>:  also write the render's PSG registers as "
+        "a YM file.\n";
+  os << "   -U/--render-until=silence:<n>: end the render early after <n> "
+        "silent frames.\n";
   os << "   -s/--sym_file=<file>:   use <file> as a source of symbols and "
         "entry points for disassembling in developers' tools.\n";
   os << "   -V/--version:           outputs version and exit\n";
@@ -235,15 +243,24 @@ void applyOption(char name, const std::string& value, char* progname,
     case 'O':
       applyOverride(value, args);
       break;
+    case 'R':
+      args.renderAudio = value;
+      break;
     case 's':
       args.symFilePath = value;
       break;
+    case 'U':
+      args.renderUntil = value;
+      break;
     case 'V':
       printVersion();
       break;
     case 'v':
       log_verbose = true;
       break;
+    case 'Y':
+      args.renderYm = value;
+      break;
     default:
       usage(std::cerr, progname, 1);
       break;
@@ -20,6 +20,9 @@ class CapriceArgs {
   bool exitOnBreak = false;
   bool debug = false;
   bool fps = false;  // --fps: log once-per-second FPS to stdout
+  std::string renderAudio;  // --render-audio: offline WAV, length = exitAfter
+  std::string renderYm;     // --render-ym: YM file alongside the render
+  std::string renderUntil;  // --render-until: e.g. "silence:100"
 };
 
 // Expands KONCPC_*/CPC_* keywords in an autocmd string into the internal
@@ -0,0 +1,161 @@
+#include "audio_render.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+#include "hw/psg.h"
+#include "subcycle/machine.h"
+#include "wav_recorder.h"
+#include "ym_recorder.h"
+
+namespace {
+
+bool parse_u32(const std::string& s, uint32_t& out) {
+  if (s.empty()) return false;
+  char* end = nullptr;
+  const unsigned long long v = std::strtoull(s.c_str(), &end, 10);
+  if (end == s.c_str() || *end != '\0' || v > 0xFFFFFFFFULL) return false;
+  out = static_cast<uint32_t>(v);
+  return true;
+}
+
+// Sound must last this many frames to arm the silence stop, so the DC
+// blocker settling after power-on (two frames) does not count as the tune.
+constexpr uint32_t kHeardFrames = 4;
+
+bool frame_is_silent(const std::vector<int16_t>& audio, int16_t threshold) {
+  for (const int16_t s : audio)
+    if (s > threshold || s < -threshold) return false;
+  return true;
+}
+
+// Restores the tier and paint state the render borrowed, however it exits.
+struct MachineModeGuard {
+  subcycle::Machine& m;
+  subcycle::Machine::RunTier tier;
+  explicit MachineModeGuard(subcycle::Machine& machine)
+      : m(machine), tier(machine.run_tier()) {}
+  ~MachineModeGuard() {
+    m.set_run_tier(tier);
+    m.set_skip_paint(false);
+  }
+  MachineModeGuard(const MachineModeGuard&) = delete;
+  MachineModeGuard& operator=(const MachineModeGuard&) = delete;
+};
+
+}  // namespace
+
+double AudioRenderResult::audio_seconds() const {
+  return static_cast<double>(sample_frames) / subcycle::kAudioHz;
+}
+
+bool audio_render_parse_length(const std::string& spec, uint32_t& frames) {
+  uint32_t n = 0;
+  if (spec.size() > 2 && spec.compare(spec.size() - 2, 2, "ms") == 0) {
+    if (!parse_u32(spec.substr(0, spec.size() - 2), n)) return false;
+    frames = n / 20;
+  } else if (!spec.empty() && spec.back() == 's') {
+    if (!parse_u32(spec.substr(0, spec.size() - 1), n) || n > 0xFFFFFFFFu / 50)
+      return false;
+    frames = n * 50;
+  } else if (!spec.empty() && spec.back() == 'f') {
+    if (!parse_u32(spec.substr(0, spec.size() - 1), frames)) return false;
+  } else if (!parse_u32(spec, frames)) {
+    return false;
+  }
+  return frames > 0;
+}
+
+bool audio_render_parse_until(const std::string& spec,
+                              AudioRenderOptions& opts) {
+  static const char kSilence[] = "silence:";
+  if (spec.compare(0, sizeof(kSilence) - 1, kSilence) != 0) return false;
+  uint32_t n = 0;
+  if (!parse_u32(spec.substr(sizeof(kSilence) - 1), n) || n == 0) return false;
+  opts.silent_frames = n;
+  return true;
+}
+
+AudioRenderResult render_audio_offline(subcycle::Machine& machine,
+                                       const AudioRenderOptions& opts) {
+  AudioRenderResult r;
+  if (opts.wav_path.empty()) {
+    r.error = "missing wav path";
+    return r;
+  }
+  if (opts.max_frames == 0) {
+    r.error = "missing length";
+    return r;
+  }
+  // Local recorders: the globals may be busy with a live `record` session.
+  WavRecorder wav;
+  std::string err = wav.start(opts.wav_path, subcycle::kAudioHz, 16, 2);
+  if (!err.empty()) {
+    r.error = opts.wav_path + ": " + err;
+    return r;
+  }
+  YmRecorder ym;
+  if (!opts.ym_path.empty()) {
+    err = ym.start(opts.ym_path);
+    if (!err.empty()) {
+      wav.stop();
+      r.error = opts.ym_path + ": " + err;
+      return r;
+    }
+  }
+
+  const auto t0 = std::chrono::steady_clock::now();
+  {
+    MachineModeGuard guard(machine);
+    machine.set_run_tier(subcycle::Machine::RunTier::Fast);  // degrades as
+    machine.set_skip_paint(true);  // the composition requires; never paints
+    uint32_t loud = 0;  // consecutive audible frames, capped at kHeardFrames
+    uint32_t quiet = 0;
+    while (r.frames < opts.max_frames) {
+      if (opts.before_frame) opts.before_frame(r.frames);
+      machine.run_frame();
+      r.frames++;
+      const std::vector<int16_t>& audio = machine.audio();
+      wav.write_samples(reinterpret_cast<const uint8_t*>(audio.data()),
+                        static_cast<uint32_t>(audio.size() * sizeof(int16_t)));
+      r.sample_frames += audio.size() / 2;
+      if (ym.is_recording()) {
+        PsgRegs ps{};
+        psg_peek(machine.psg(), &ps);
+        ym.capture_frame(ps.reg);
+      }
+      if (wav.has_error()) break;
+      if (opts.silent_frames != 0) {
+        if (!frame_is_silent(audio, opts.silence_threshold)) {
+          if (loud < kHeardFrames) loud++;
+          quiet = 0;
+        } else if (loud < kHeardFrames) {
+          loud = 0;
+        } else if (++quiet >= opts.silent_frames) {
+          r.stopped_on_silence = true;
+          break;
+        }
+      }
+    }
+  }
+  r.wall_seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - t0)
+                       .count();
+
+  const bool wav_failed = wav.has_error();
+  wav.stop();
+  if (ym.is_recording()) {
+    r.ym_frames = ym.stop();
+    if (ym.has_error()) {
+      r.error = opts.ym_path + ": write failed";
+      return r;
+    }
+  }
+  if (wav_failed) {
+    r.error = opts.wav_path + ": write failed";
+    return r;
+  }
+  r.ok = true;
+  return r;
+}
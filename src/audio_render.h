@@ -0,0 +1,55 @@
+#pragma once
+
+// Offline audio rendering: run the machine unpaced (Fast tier, no painting)
+// and stream each frame's audio straight into a WAV file, optionally with
+// the PSG register stream as a YM5 file alongside — a 5-minute tune renders
+// in seconds instead of the 5 real minutes `record wav` needs.
+//
+// The caller owns the machine and must hold it exclusively for the call
+// (the IPC command pauses the emulation thread first). The machine's tier
+// and paint state are restored afterwards; the emulated time it advanced is
+// not (a render is a fast-forward).
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace subcycle {
+class Machine;
+}
+
+struct AudioRenderOptions {
+  std::string wav_path;  // required: 16-bit stereo at the machine's rate
+  std::string ym_path;   // optional: PSG registers, one frame per VBL
+  uint32_t max_frames = 0;  // stop after this many frames (required, > 0)
+  // Stop early once this many consecutive frames are silent after sound has
+  // played for a few frames (0 = off): "until the tune ends".
+  uint32_t silent_frames = 0;
+  // Frame samples within ±this count as silence (DC offset, dither).
+  int16_t silence_threshold = 64;
+  // Called before every frame (input, autotype); may be empty.
+  std::function<void(uint32_t frame)> before_frame;
+};
+
+struct AudioRenderResult {
+  bool ok = false;
+  std::string error;            // set when !ok
+  uint32_t frames = 0;          // frames run
+  uint64_t sample_frames = 0;   // stereo sample pairs written
+  uint32_t ym_frames = 0;       // YM frames written (0 without ym_path)
+  bool stopped_on_silence = false;
+  double wall_seconds = 0;
+
+  double audio_seconds() const;
+};
+
+// Parse a length as frames: "<n>f", "<n>s", "<n>ms", or a bare frame count
+// (the --exit-after spelling; 50 frames per second). False on junk or zero.
+bool audio_render_parse_length(const std::string& spec, uint32_t& frames);
+
+// Parse "silence:<frames>" into opts.silent_frames. False on junk.
+bool audio_render_parse_until(const std::string& spec,
+                              AudioRenderOptions& opts);
+
+AudioRenderResult render_audio_offline(subcycle::Machine& machine,
+                                       const AudioRenderOptions& opts);
@@ -0,0 +1,141 @@
+#include "audio_ring.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kMinTargetMs = 2;
+constexpr double kMaxTargetMs = 250;
+// Fill smoothing per pull(): the device asks every few ms, so this follows
+// the producer's frame-sized sawtooth only loosely — steering, not chasing.
+constexpr double kFillSmoothing = 0.05;
+// Integral gain per pull(): trims out the steady offset a constant clock
+// mismatch would otherwise leave (proportional steering alone settles off
+// target by drift / kMaxCorrection).
+constexpr double kIntegralGain = 2e-5;
+
+}  // namespace
+
+void AudioRing::configure(int src_rate, int dst_rate, double target_ms) {
+  src_rate_ = std::max(src_rate, 1);
+  dst_rate_ = std::max(dst_rate, 1);
+  nominal_ = static_cast<double>(src_rate_) / dst_rate_;
+  // Room for the overrun ceiling at the largest target (see set_target_ms).
+  const auto ceiling = static_cast<size_t>(
+      (4 * kMaxTargetMs * src_rate_ / 1000) + (src_rate_ / 10));
+  size_t cap = 1024;
+  while (cap < ceiling) cap <<= 1;
+  buf_.assign(cap * kChannels, 0);
+  mask_ = cap - 1;
+  head_.store(0, std::memory_order_relaxed);
+  tail_.store(0, std::memory_order_relaxed);
+  set_target_ms(target_ms);
+  primed_ = false;
+  pos_ = 1.0;
+  trim_ = 0;
+  std::fill(std::begin(prev_), std::end(prev_), 0);
+  std::fill(std::begin(cur_), std::end(cur_), 0);
+  ratio_.store(1.0, std::memory_order_relaxed);
+  underruns_ = dropped_ = pushed_ = pulled_ = 0;
+}
+
+void AudioRing::set_target_ms(double ms) {
+  ms = std::clamp(ms, kMinTargetMs, kMaxTargetMs);
+  target_.store(static_cast<uint32_t>(std::lround(ms * src_rate_ / 1000)),
+                std::memory_order_relaxed);
+}
+
+size_t AudioRing::push(const int16_t* frames, size_t n) {
+  if (mask_ == 0) return 0;
+  const size_t target = target_.load(std::memory_order_relaxed);
+  // Overrun ceiling: 4x the target, and never less than the target plus
+  // 100 ms so a whole emulated frame fits even at tiny targets.
+  const size_t ceiling =
+      std::max(4 * target, target + static_cast<size_t>(src_rate_ / 10));
+  const size_t head = head_.load(std::memory_order_relaxed);
+  const size_t used = head - tail_.load(std::memory_order_acquire);
+  const size_t take = used >= ceiling ? 0 : std::min(n, ceiling - used);
+  for (size_t i = 0; i < take; ++i) {
+    int16_t* d = &buf_[((head + i) & mask_) * kChannels];
+    d[0] = frames[i * kChannels];
+    d[1] = frames[(i * kChannels) + 1];
+  }
+  head_.store(head + take, std::memory_order_release);
+  pushed_.fetch_add(take, std::memory_order_relaxed);
+  if (take < n) dropped_.fetch_add(n - take, std::memory_order_relaxed);
+  return take;
+}
+
+bool AudioRing::next_frame() {
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  if (head_.load(std::memory_order_acquire) == tail) return false;
+  const int16_t* s = &buf_[(tail & mask_) * kChannels];
+  for (int c = 0; c < kChannels; ++c) {
+    prev_[c] = cur_[c];
+    cur_[c] = s[c];
+  }
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+void AudioRing::pull(int16_t* out, size_t n) {
+  pulled_.fetch_add(n, std::memory_order_relaxed);
+  const auto target = static_cast<double>(target_.load(std::memory_order_relaxed));
+  size_t i = 0;
+  if (mask_ != 0) {
+    if (!primed_ && static_cast<double>(fill()) >= target) {
+      primed_ = true;
+      avg_fill_ = target;
+      next_frame();  // cur_ = the first frame; the loop below shifts it in
+      pos_ = 1.0;
+    }
+    if (primed_) {
+      avg_fill_ += kFillSmoothing * (static_cast<double>(fill()) - avg_fill_);
+      const double err =
+          std::clamp((avg_fill_ - target) / std::max(target, 1.0), -1.0, 1.0);
+      trim_ = std::clamp(trim_ + (err * kIntegralGain), -kMaxCorrection,
+                         kMaxCorrection);
+      const double ratio =
+          1.0 + std::clamp((err * kMaxCorrection) + trim_, -kMaxCorrection,
+                           kMaxCorrection);
+      ratio_.store(ratio, std::memory_order_relaxed);
+      const double step = nominal_ * ratio;
+      for (; i < n; ++i) {
+        while (pos_ >= 1.0) {
+          if (!next_frame()) break;
+          pos_ -= 1.0;
+        }
+        if (pos_ >= 1.0) {  // ran dry: silence until re-primed
+          underruns_.fetch_add(1, std::memory_order_relaxed);
+          primed_ = false;
+          break;
+        }
+        for (int c = 0; c < kChannels; ++c)
+          out[(i * kChannels) + c] = static_cast<int16_t>(std::lround(
+              prev_[c] + ((cur_[c] - prev_[c]) * pos_)));
+        pos_ += step;
+      }
+    }
+  }
+  std::fill(out + (i * kChannels), out + (n * kChannels), int16_t{0});
+}
+
+void AudioRing::clear() {
+  tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+  primed_ = false;
+}
+
+AudioRingStats AudioRing::stats() const {
+  AudioRingStats s;
+  s.src_rate = src_rate_;
+  s.dst_rate = dst_rate_;
+  s.target_frames = target_.load(std::memory_order_relaxed);
+  s.fill_frames = static_cast<uint32_t>(fill());
+  s.ratio = ratio_.load(std::memory_order_relaxed);
+  s.underruns = underruns_.load(std::memory_order_relaxed);
+  s.dropped = dropped_.load(std::memory_order_relaxed);
+  s.pushed = pushed_.load(std::memory_order_relaxed);
+  s.pulled = pulled_.load(std::memory_order_relaxed);
+  return s;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+// Emulation -> audio device handoff: a single-producer/single-consumer ring of
+// interleaved stereo s16 frames plus an adaptive resampler on the read side.
+//
+// The emulation thread push()es each frame's samples; the SDL audio callback
+// pull()s exactly what the device asks for. Instead of dropping or padding
+// whole buffers when the two clocks drift, pull() runs the source through a
+// linear-interpolating resampler whose ratio is nudged (at most ±0.5%, far
+// below audible pitch change) by a slow PI loop that holds the ring's fill at
+// a target latency.
+// Underruns play silence and re-prime to the target; pushes beyond a ceiling
+// (an unpaced emulation) are dropped so latency stays bounded.
+//
+// No locks and no allocation after configure(): head/tail are the only
+// shared state, the counters are relaxed atomics read by stats().
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct AudioRingStats {
+  int src_rate = 0, dst_rate = 0;
+  uint32_t target_frames = 0;  // source frames the resampler steers toward
+  uint32_t fill_frames = 0;    // source frames buffered right now
+  double ratio = 1.0;          // current rate correction (1.0 = nominal)
+  uint64_t underruns = 0;      // times the device found the ring empty
+  uint64_t dropped = 0;        // source frames refused by push() (overrun)
+  uint64_t pushed = 0;         // source frames accepted
+  uint64_t pulled = 0;         // device frames delivered (incl. silence)
+
+  double target_ms() const { return frames_ms(target_frames); }
+  double fill_ms() const { return frames_ms(fill_frames); }
+  double frames_ms(uint32_t frames) const {
+    return src_rate ? frames * 1000.0 / src_rate : 0;
+  }
+};
+
+class AudioRing {
+ public:
+  static constexpr int kChannels = 2;
+  static constexpr double kMaxCorrection = 0.005;  // ±0.5% rate steering
+
+  AudioRing() = default;
+  AudioRing(const AudioRing&) = delete;
+  AudioRing& operator=(const AudioRing&) = delete;
+
+  // Size the ring for src_rate -> dst_rate at `target_ms` latency and empty
+  // it. Not thread-safe: call while neither side is running.
+  void configure(int src_rate, int dst_rate, double target_ms);
+  // Move the target (any thread); clamped to 2..250 ms.
+  void set_target_ms(double ms);
+
+  // Producer: append n frames (2n samples). Returns the frames accepted; the
+  // rest are dropped when the ring already holds the overrun ceiling.
+  size_t push(const int16_t* frames, size_t n);
+
+  // Consumer: write exactly n device-rate frames to `out`.
+  void pull(int16_t* out, size_t n);
+
+  // Drop buffered audio and re-prime (e.g. after a pause). Consumer side, or
+  // while the device is stopped.
+  void clear();
+
+  AudioRingStats stats() const;
+  bool configured() const { return mask_ != 0; }
+
+ private:
+  size_t fill() const {  // tail first: head can only be >= it afterwards
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    return head_.load(std::memory_order_acquire) - tail;
+  }
+  bool next_frame();  // advance prev_/cur_ by one source frame
+
+  std::vector<int16_t> buf_;  // capacity * kChannels samples
+  size_t mask_ = 0;           // capacity - 1 (capacity is a power of two)
+  std::atomic<size_t> head_{0};  // producer-owned write index (frames)
+  std::atomic<size_t> tail_{0};  // consumer-owned read index (frames)
+  std::atomic<uint32_t> target_{0};
+  int src_rate_ = 0, dst_rate_ = 0;
+  double nominal_ = 1.0;  // src_rate / dst_rate
+
+  // Consumer state.
+  bool primed_ = false;
+  double pos_ = 0;  // fraction between prev_ and cur_
+  double avg_fill_ = 0;
+  double trim_ = 0;  // integral term of the steering
+  int16_t prev_[kChannels] = {}, cur_[kChannels] = {};
+
+  std::atomic<double> ratio_{1.0};
+  std::atomic<uint64_t> underruns_{0}, dropped_{0}, pushed_{0}, pulled_{0};
+};
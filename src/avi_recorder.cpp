@@ -1,6 +1,8 @@
 #include "avi_recorder.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <cstring>
 
 #ifdef HAS_LIBJPEG
@@ -14,16 +16,13 @@ AviRecorder g_avi_recorder;
 namespace {
 
 // AVI chunk IDs used for index entries (little-endian)
+constexpr uint32_t FOURCC_00dc = 0x63643030;  // "00dc" - video data chunk
 constexpr uint32_t FOURCC_01wb = 0x62773130;  // "01wb" - audio data chunk
+constexpr uint32_t AVIIF_KEYFRAME = 0x00000010;
 
 constexpr uint32_t AVIF_HASINDEX = 0x00000010;
 constexpr uint32_t CPC_FPS = 50;
 
-#ifdef HAS_LIBJPEG
-constexpr uint32_t FOURCC_00dc = 0x63643030;  // "00dc" - video data chunk
-constexpr uint32_t AVIIF_KEYFRAME = 0x00000010;
-#endif
-
 // File offsets for fields that patch_sizes() must update after recording.
 // Layout: RIFF(4) + size(4) + "AVI "(4) = 12 bytes
 //         LIST(4) + size(4) + "hdrl"(4) = 12 bytes
@@ -54,23 +53,17 @@ void AviRecorder::write_le_u32(uint32_t val, FILE* f) {
 
 void AviRecorder::write_fourcc(const char* cc, FILE* f) { fwrite(cc, 1, 4, f); }
 
-AviRecorder::~AviRecorder() {
-  if (file_) {
-    stop();
-  }
-}
+AviRecorder::AviRecorder() : slots_(new Slot[kQueueSlots]) {}
+
+AviRecorder::~AviRecorder() { stop(); }
 
 std::string AviRecorder::start(const std::string& path, int quality,
                                uint32_t sample_rate, uint16_t channels,
-                               uint16_t bits_per_sample) {
+                               uint16_t bits_per_sample, Codec codec) {
 #ifndef HAS_LIBJPEG
-  (void)path;
-  (void)quality;
-  (void)sample_rate;
-  (void)channels;
-  (void)bits_per_sample;
-  return "AVI recording requires libjpeg (not found at build time)";
-#else
+  if (codec == Codec::Mjpeg)
+    return "MJPEG recording requires libjpeg (not found at build time)";
+#endif
   std::scoped_lock const lock(mutex_);
   if (file_) {
     return "already recording";
@@ -83,6 +76,7 @@ std::string AviRecorder::start(const std::string& path, int quality,
 
   path_ = path;
   quality_ = std::clamp(quality, 1, 100);
+  codec_ = codec;
   sample_rate_ = sample_rate;
   channels_ = channels;
   bits_per_sample_ = bits_per_sample;
@@ -103,8 +97,22 @@ std::string AviRecorder::start(const std::string& path, int quality,
   height_ = 270;
   write_headers();
 
+  // Fresh queue (no producer can be inside it: accepting_ is still false).
+  for (size_t i = 0; i < kQueueSlots; ++i)
+    slots_[i].seq.store(i, std::memory_order_relaxed);
+  enqueue_pos_.store(0, std::memory_order_relaxed);
+  dequeue_pos_ = 0;
+  enqueued_ = 0;
+  written_ = 0;
+  queue_peak_ = 0;
+  dropped_frames_ = 0;
+  backpressure_waits_ = 0;
+  frames_out_ = 0;
+  worker_stop_ = false;
+  worker_ = std::thread(&AviRecorder::worker_main, this);
+  accepting_.store(true, std::memory_order_release);
+
   return "";
-#endif
 }
 
 uint32_t AviRecorder::stop() {
@@ -113,6 +121,7 @@ uint32_t AviRecorder::stop() {
     return 0;
   }
 
+  stop_worker();  // drains the queue: every accepted chunk reaches the file
   finalize();
   fclose(file_);
   file_ = nullptr;
@@ -121,67 +130,203 @@ uint32_t AviRecorder::stop() {
   video_frames_ = 0;
   audio_bytes_ = 0;
   total_bytes_ = 0;
+  frames_out_ = 0;
   path_.clear();
   index_entries_.clear();
   return result;
 }
 
+void AviRecorder::stop_worker() {
+  // A Dekker handshake with the captures: each side stores its flag, then
+  // loads the other's. Only seq_cst orders a store before a later load of a
+  // different variable, so all four are seq_cst — with acquire/release a
+  // capture could still see accepting_ true after we saw in_flight_ zero.
+  accepting_.store(false, std::memory_order_seq_cst);
+  // A capture that saw accepting_ before the store may still be enqueueing;
+  // once none is in flight nothing new can arrive.
+  while (in_flight_.load(std::memory_order_seq_cst) != 0)
+    std::this_thread::yield();
+  worker_stop_.store(true, std::memory_order_release);
+  wake_cv_.notify_one();
+  if (worker_.joinable()) worker_.join();
+}
+
+// Bounded MPMC ring (Vyukov): a slot's sequence says whose turn it is — equal
+// to the claim position when free for a producer, position+1 once filled.
+template <typename Fill>
+bool AviRecorder::try_enqueue(Fill&& fill) {
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  for (;;) {
+    Slot& slot = slots_[pos & (kQueueSlots - 1)];
+    size_t const seq = slot.seq.load(std::memory_order_acquire);
+    auto const dif = static_cast<std::ptrdiff_t>(seq - pos);
+    if (dif == 0) {
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+        fill(slot.job);
+        slot.seq.store(pos + 1, std::memory_order_release);
+        break;
+      }
+    } else if (dif < 0) {
+      return false;  // full: the worker has not released this lap's slot
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+  uint64_t const depth =
+      enqueued_.fetch_add(1, std::memory_order_relaxed) + 1 -
+      written_.load(std::memory_order_relaxed);
+  uint32_t peak = queue_peak_.load(std::memory_order_relaxed);
+  while (depth > peak && !queue_peak_.compare_exchange_weak(
+                             peak, static_cast<uint32_t>(depth),
+                             std::memory_order_relaxed)) {
+  }
+  wake_cv_.notify_one();
+  return true;
+}
+
+bool AviRecorder::dequeue_and_write() {
+  Slot& slot = slots_[dequeue_pos_ & (kQueueSlots - 1)];
+  if (slot.seq.load(std::memory_order_acquire) != dequeue_pos_ + 1)
+    return false;
+  if (slot.job.video) {
+    write_video(slot.job);
+  } else {
+    write_audio(slot.job);
+  }
+  slot.seq.store(dequeue_pos_ + kQueueSlots, std::memory_order_release);
+  dequeue_pos_++;
+  written_.fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+void AviRecorder::worker_main() {
+  for (;;) {
+    if (dequeue_and_write()) continue;
+    if (worker_stop_.load(std::memory_order_acquire)) {
+      while (dequeue_and_write()) {
+      }
+      return;
+    }
+    // Producers notify without the lock, so a wakeup can slip past; the
+    // timeout bounds that to one short nap.
+    std::unique_lock<std::mutex> lk(wake_mutex_);
+    wake_cv_.wait_for(lk, std::chrono::milliseconds(2));
+  }
+}
+
 void AviRecorder::capture_video_frame(const uint8_t* pixels, int width,
                                       int height, int stride) {
-#ifndef HAS_LIBJPEG
-  (void)pixels;
-  (void)width;
-  (void)height;
-  (void)stride;
-#else
-  std::scoped_lock const lock(mutex_);
-  if (!file_ || !pixels) return;
+  if (!pixels || width <= 0 || height <= 0) return;
+  in_flight_.fetch_add(1, std::memory_order_seq_cst);  // see stop_worker
+  if (accepting_.load(std::memory_order_seq_cst)) {
+    auto fill = [&](Job& job) {
+      job.video = true;
+      job.width = width;
+      job.height = height;
+      size_t const row = static_cast<size_t>(width) * 4;
+      job.data.resize(row * static_cast<size_t>(height));
+      for (int y = 0; y < height; y++)
+        memcpy(job.data.data() + (row * y),
+               pixels + (static_cast<size_t>(y) * stride), row);
+    };
+    bool ok = try_enqueue(fill);
+    if (!ok) {  // full: give the worker about a frame period, then drop
+      backpressure_waits_.fetch_add(1, std::memory_order_relaxed);
+      auto const deadline =
+          std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+      while (!ok && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        ok = try_enqueue(fill);
+      }
+    }
+    if (!ok) dropped_frames_.fetch_add(1, std::memory_order_relaxed);
+  }
+  in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void AviRecorder::capture_audio_samples(const int16_t* samples, size_t count) {
+  if (!samples || count == 0) return;
+  in_flight_.fetch_add(1, std::memory_order_seq_cst);  // see stop_worker
+  if (accepting_.load(std::memory_order_seq_cst)) {
+    auto fill = [&](Job& job) {
+      job.video = false;
+      job.data.resize(count * sizeof(int16_t));
+      memcpy(job.data.data(), samples, job.data.size());
+    };
+    if (!try_enqueue(fill)) {  // audio is never dropped: wait for a slot
+      backpressure_waits_.fetch_add(1, std::memory_order_relaxed);
+      do {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      } while (!try_enqueue(fill));
+    }
+  }
+  in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+}
 
+void AviRecorder::flush() {
+  while (written_.load(std::memory_order_acquire) <
+         enqueued_.load(std::memory_order_acquire))
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+}
+
+void AviRecorder::write_video(const Job& job) {
   // Update dimensions if this is first frame with actual data
-  if (video_frames_ == 0 && (width != width_ || height != height_)) {
-    width_ = width;
-    height_ = height;
-    // Rewrite headers with correct dimensions
+  if (video_frames_ == 0 && (job.width != width_ || job.height != height_)) {
+    width_ = job.width;
+    height_ = job.height;
+    // Rewrite headers with correct dimensions (fixed layout, so the same
+    // size), then return past any audio chunks already in movi.
+    long const resume = ftell(file_);
     fseek(file_, 0, SEEK_SET);
     movi_start_ = 0;
     write_headers();
+    fseek(file_, resume, SEEK_SET);
   }
-
-  auto jpeg_data = compress_jpeg(pixels, width, height, stride);
-  if (jpeg_data.empty()) return;
+  uint32_t flags = AVIIF_KEYFRAME;
+  if (codec_ == Codec::Zmbv) {
+    // A ZMBV stream has one frame size; a frame of another is skipped.
+    if (job.width != width_ || job.height != height_) return;
+    if (video_frames_ == 0 && !zmbv_.reset(width_, height_)) return;
+    bool key = false;
+    if (!zmbv_.encode(job.data.data(), job.width * 4, video_buf_, key)) return;
+    if (!key) flags = 0;
+  } else {
+#ifdef HAS_LIBJPEG
+    video_buf_ =
+        compress_jpeg(job.data.data(), job.width, job.height, job.width * 4);
+#endif
+  }
+  if (video_buf_.empty()) return;
 
   uint32_t const chunk_offset =
       static_cast<uint32_t>(ftell(file_) - movi_start_ - 4);
 
   // Write video chunk: "00dc" + size + data (+ pad byte if odd size)
   write_le_u32(FOURCC_00dc, file_);
-  uint32_t const data_size = static_cast<uint32_t>(jpeg_data.size());
+  uint32_t const data_size = static_cast<uint32_t>(video_buf_.size());
   write_le_u32(data_size, file_);
-  fwrite(jpeg_data.data(), 1, jpeg_data.size(), file_);
+  fwrite(video_buf_.data(), 1, video_buf_.size(), file_);
   // AVI chunks must be word-aligned
   if (data_size & 1) {
     fputc(0, file_);
   }
 
-  index_entries_.push_back(
-      {FOURCC_00dc, AVIIF_KEYFRAME, chunk_offset, data_size});
+  index_entries_.push_back({FOURCC_00dc, flags, chunk_offset, data_size});
   video_frames_++;
+  frames_out_.store(video_frames_, std::memory_order_relaxed);
   total_bytes_ = static_cast<uint64_t>(ftell(file_));
-#endif
 }
 
-void AviRecorder::capture_audio_samples(const int16_t* samples, size_t count) {
-  std::scoped_lock const lock(mutex_);
-  if (!file_ || !samples || count == 0) return;
-
-  uint32_t const byte_count = static_cast<uint32_t>(count * sizeof(int16_t));
+void AviRecorder::write_audio(const Job& job) {
+  uint32_t const byte_count = static_cast<uint32_t>(job.data.size());
   uint32_t const chunk_offset =
       static_cast<uint32_t>(ftell(file_) - movi_start_ - 4);
 
   // Write audio chunk: "01wb" + size + data (+ pad byte if odd)
   write_le_u32(FOURCC_01wb, file_);
   write_le_u32(byte_count, file_);
-  fwrite(samples, 1, byte_count, file_);
+  fwrite(job.data.data(), 1, byte_count, file_);
   if (byte_count & 1) {
     fputc(0, file_);
   }
@@ -192,18 +337,15 @@ void AviRecorder::capture_audio_samples(const int16_t* samples, size_t count) {
 }
 
 bool AviRecorder::is_recording() const {
-  std::scoped_lock const lock(mutex_);
-  return file_ != nullptr;
+  return accepting_.load(std::memory_order_acquire);
 }
 
 uint32_t AviRecorder::frame_count() const {
-  std::scoped_lock const lock(mutex_);
-  return video_frames_;
+  return frames_out_.load(std::memory_order_relaxed);
 }
 
 uint64_t AviRecorder::bytes_written() const {
-  std::scoped_lock const lock(mutex_);
-  return total_bytes_;
+  return total_bytes_.load(std::memory_order_relaxed);
 }
 
 std::string AviRecorder::current_path() const {
@@ -211,6 +353,17 @@ std::string AviRecorder::current_path() const {
   return path_;
 }
 
+AviRecorder::PipelineStats AviRecorder::pipeline_stats() const {
+  PipelineStats st;
+  st.capacity = kQueueSlots;
+  st.queued = static_cast<uint32_t>(enqueued_.load(std::memory_order_relaxed) -
+                                    written_.load(std::memory_order_relaxed));
+  st.queue_peak = queue_peak_.load(std::memory_order_relaxed);
+  st.dropped_frames = dropped_frames_.load(std::memory_order_relaxed);
+  st.backpressure_waits = backpressure_waits_.load(std::memory_order_relaxed);
+  return st;
+}
+
 // Write the full AVI header structure.
 // Layout:
 //   RIFF 'AVI '
@@ -227,6 +380,8 @@ std::string AviRecorder::current_path() const {
 //     idx1
 //       ... index ...
 void AviRecorder::write_headers() {
+  const char* const codec_fourcc = codec_ == Codec::Zmbv ? "ZMBV" : "MJPG";
+
   // RIFF header
   write_fourcc("RIFF", file_);
   write_le_u32(0, file_);  // placeholder for file size
@@ -268,7 +423,7 @@ void AviRecorder::write_headers() {
   write_fourcc("strh", file_);
   write_le_u32(56, file_);          // strh chunk size
   write_fourcc("vids", file_);      // fccType
-  write_fourcc("MJPG", file_);      // fccHandler
+  write_fourcc(codec_fourcc, file_);  // fccHandler
   write_le_u32(0, file_);           // dwFlags
   write_le_u16(0, file_);           // wPriority
   write_le_u16(0, file_);           // wLanguage
@@ -292,9 +447,11 @@ void AviRecorder::write_headers() {
   write_le_u32(static_cast<uint32_t>(width_), file_);   // biWidth
   write_le_u32(static_cast<uint32_t>(height_), file_);  // biHeight
   write_le_u16(1, file_);                               // biPlanes
-  write_le_u16(24, file_);      // biBitCount (MJPEG outputs 24bpp)
-  write_fourcc("MJPG", file_);  // biCompression
-  write_le_u32(static_cast<uint32_t>(width_ * height_ * 3),
+  // biBitCount: MJPEG outputs 24bpp; ZMBV decodes to the 32bpp it may use
+  write_le_u16(codec_ == Codec::Zmbv ? 32 : 24, file_);
+  write_fourcc(codec_fourcc, file_);  // biCompression
+  write_le_u32(static_cast<uint32_t>(width_ * height_ *
+                                     (codec_ == Codec::Zmbv ? 4 : 3)),
                file_);     // biSizeImage
   write_le_u32(0, file_);  // biXPelsPerMeter
   write_le_u32(0, file_);  // biYPelsPerMeter
@@ -305,7 +462,7 @@ void AviRecorder::write_headers() {
   uint32_t const vstrl_end = static_cast<uint32_t>(ftell(file_));
   fseek(file_, static_cast<long>(vstrl_start - 4), SEEK_SET);
   write_le_u32(vstrl_end - vstrl_start, file_);
-  fseek(file_, 0, SEEK_END);
+  fseek(file_, static_cast<long>(vstrl_end), SEEK_SET);
 
   // --- Audio stream ---
   // LIST 'strl'
@@ -354,13 +511,13 @@ void AviRecorder::write_headers() {
   uint32_t const astrl_end = static_cast<uint32_t>(ftell(file_));
   fseek(file_, static_cast<long>(astrl_start - 4), SEEK_SET);
   write_le_u32(astrl_end - astrl_start, file_);
-  fseek(file_, 0, SEEK_END);
+  fseek(file_, static_cast<long>(astrl_end), SEEK_SET);
 
   // Patch hdrl LIST size
   uint32_t const hdrl_end = static_cast<uint32_t>(ftell(file_));
   fseek(file_, static_cast<long>(hdrl_start - 4), SEEK_SET);
   write_le_u32(hdrl_end - hdrl_start, file_);
-  fseek(file_, 0, SEEK_END);
+  fseek(file_, static_cast<long>(hdrl_end), SEEK_SET);
 
   // LIST 'movi'
   write_fourcc("LIST", file_);
@@ -1,43 +1,118 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <cstdio>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "zmbv_codec.h"
+
+// MJPEG or ZMBV + PCM AVI writer. Capture calls only copy into a bounded
+// lock-free queue; a dedicated worker thread does the compression and every
+// file write, in capture order, so the on-disk AVI (chunks and idx1) is the one a
+// synchronous writer would produce. A full queue back-pressures audio (it must
+// not be lost) and drops a video frame after a short wait — both counted.
 class AviRecorder {
  public:
+  // Video codec. Mjpeg is lossy (quality 1-100) and needs libjpeg; Zmbv is
+  // lossless XOR-delta + zlib (see zmbv_codec.h) — exact pixels, and a
+  // mostly static frame costs microseconds and a few bytes. Quality is
+  // ignored for Zmbv.
+  enum class Codec { Mjpeg, Zmbv };
+
+  AviRecorder();
   ~AviRecorder();
 
   // Start recording. Returns empty string on success, error message on failure.
   std::string start(const std::string& path, int quality = 85,
                     uint32_t sample_rate = 44100, uint16_t channels = 2,
-                    uint16_t bits_per_sample = 16);
+                    uint16_t bits_per_sample = 16, Codec codec = Codec::Mjpeg);
 
   // Stop recording and finalize AVI file. Returns frame count.
   uint32_t stop();
 
-  // Capture a video frame (RGBA pixel data).
+  // Capture a video frame (RGBA pixel data). Thread-safe; copies and returns.
   void capture_video_frame(const uint8_t* pixels, int width, int height,
                            int stride);
 
-  // Capture audio samples (interleaved PCM). Thread-safe.
+  // Capture audio samples (interleaved PCM). Thread-safe; copies and returns.
   void capture_audio_samples(const int16_t* samples, size_t count);
 
+  // Block until everything captured so far is on disk.
+  void flush();
+
   bool is_recording() const;
+  // Video frames in the file so far. Written by the worker, so it can trail
+  // capture (flush() catches it up); frames dropped on a full queue or skipped
+  // by the encoder (a ZMBV size change) never count.
   uint32_t frame_count() const;
+  // Bytes on disk so far (the worker may be a few chunks behind capture).
   uint64_t bytes_written() const;
   std::string current_path() const;
+  Codec codec() const { return codec_; }
+
+  // Pipeline counters for this recording (IPC "record status").
+  struct PipelineStats {
+    uint32_t queued = 0;      // chunks waiting for the worker
+    uint32_t queue_peak = 0;  // deepest the queue has been
+    uint32_t capacity = 0;
+    uint64_t dropped_frames = 0;      // video frames lost to a full queue
+    uint64_t backpressure_waits = 0;  // captures that had to wait for a slot
+  };
+  PipelineStats pipeline_stats() const;
+
+  static constexpr size_t kQueueSlots = 32;  // power of two
 
  private:
+  // One captured chunk. Slots keep their buffer between laps, so a steady
+  // recording stops allocating after the first kQueueSlots captures.
+  struct Job {
+    bool video = false;
+    int width = 0, height = 0;
+    std::vector<uint8_t> data;  // packed RGBA rows, or raw PCM bytes
+  };
+  struct Slot {
+    std::atomic<size_t> seq{0};
+    Job job;
+  };
+  template <typename Fill>
+  bool try_enqueue(Fill&& fill);
+  bool dequeue_and_write();
+  void worker_main();
+  void stop_worker();
+  void write_video(const Job& job);
+  void write_audio(const Job& job);
+
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<size_t> enqueue_pos_{0};
+  size_t dequeue_pos_ = 0;  // worker-owned
+  std::atomic<uint64_t> enqueued_{0}, written_{0};
+  std::atomic<uint32_t> queue_peak_{0};
+  std::atomic<uint64_t> dropped_frames_{0}, backpressure_waits_{0};
+  std::atomic<bool> accepting_{false};
+  std::atomic<int> in_flight_{0};  // captures between the accepting check and
+                                   // their enqueue (stop waits them out)
+  std::atomic<bool> worker_stop_{false};
+  std::thread worker_;
+  std::mutex wake_mutex_;
+  std::condition_variable wake_cv_;
+
   FILE* file_ = nullptr;
   std::string path_;
   int quality_ = 85;
+  Codec codec_ = Codec::Mjpeg;
+  ZmbvEncoder zmbv_;                // worker-owned while recording
+  std::vector<uint8_t> video_buf_;  // encoded frame, reused
 
   int width_ = 0;
   int height_ = 0;
-  uint32_t video_frames_ = 0;
+  uint32_t video_frames_ = 0;  // worker-owned; frame_count() reads frames_out_
+  std::atomic<uint32_t> frames_out_{0};
 
   uint32_t sample_rate_ = 44100;
   uint16_t channels_ = 2;
@@ -45,7 +120,7 @@ class AviRecorder {
   uint32_t audio_bytes_ = 0;
 
   uint32_t movi_start_ = 0;
-  uint64_t total_bytes_ = 0;
+  std::atomic<uint64_t> total_bytes_{0};
 
   struct IndexEntry {
     uint32_t chunk_id;
@@ -55,7 +130,8 @@ class AviRecorder {
   };
   std::vector<IndexEntry> index_entries_;
 
-  mutable std::mutex mutex_;
+  mutable std::mutex mutex_;  // start/stop and the path; the worker owns the
+                              // file and index while recording
 
   void write_headers();
   void finalize();
@@ -14,6 +14,7 @@ void CommandPalette::open() {
   selected_index_ = 0;
   std::memset(input_buf_, 0, sizeof(input_buf_));
   std::memset(ipc_input_buf_, 0, sizeof(ipc_input_buf_));
+  std::memset(lib_input_buf_, 0, sizeof(lib_input_buf_));
   ipc_history_pos_ = -1;
 }
 
@@ -84,6 +85,10 @@ std::string CommandPalette::execute_ipc(const std::string& command) const {
   return "ERR no IPC handler\n";
 }
 
+void CommandPalette::set_library_handler(LibraryHandler handler) {
+  library_handler_ = std::move(handler);
+}
+
 void CommandPalette::render() {
   if (!open_) return;
 
@@ -124,6 +129,10 @@ void CommandPalette::render() {
       mode_ = 1;
       ImGui::EndTabItem();
     }
+    if (ImGui::BeginTabItem("Library")) {
+      mode_ = 2;
+      ImGui::EndTabItem();
+    }
     ImGui::EndTabBar();
   }
 
@@ -187,6 +196,74 @@ void CommandPalette::render() {
       ImGui::PopID();
     }
     ImGui::EndChild();
+  } else if (mode_ == 2) {
+    if (focus_input_) {
+      ImGui::SetKeyboardFocusHere();
+      focus_input_ = false;
+    }
+    bool const enter_pressed =
+        ImGui::InputText("##LibSearch", lib_input_buf_, sizeof(lib_input_buf_),
+                         ImGuiInputTextFlags_EnterReturnsTrue);
+
+    // Re-query only when the text changes or a rescan swapped the index in.
+    library::Service const& lib = library::service();
+    if (lib_query_ != lib_input_buf_ || lib_generation_ != lib.generation()) {
+      lib_query_ = lib_input_buf_;
+      lib_generation_ = lib.generation();
+      lib_hits_ = lib_query_.empty() ? std::vector<library::Hit>{}
+                                     : lib.query(lib_query_, 50);
+      selected_index_ = 0;
+    }
+
+    if (ImGui::IsKeyPressed(ImGuiKey_DownArrow)) {
+      selected_index_ =
+          std::min(selected_index_ + 1, static_cast<int>(lib_hits_.size()) - 1);
+    }
+    if (ImGui::IsKeyPressed(ImGuiKey_UpArrow)) {
+      selected_index_ = std::max(selected_index_ - 1, 0);
+    }
+
+    int picked = -1;
+    if (enter_pressed && selected_index_ >= 0 &&
+        selected_index_ < static_cast<int>(lib_hits_.size())) {
+      picked = selected_index_;
+    }
+
+    if (lib.scanning()) {
+      ImGui::TextDisabled("Scanning %d/%d...", lib.scan_done(),
+                          lib.scan_total());
+    } else {
+      ImGui::TextDisabled("%zu entries", lib.size());
+    }
+
+    ImGui::BeginChild("##LibList", ImVec2(0, 0), ImGuiChildFlags_None);
+    for (size_t i = 0; i < lib_hits_.size() && picked < 0; i++) {
+      const library::Entry& e = lib_hits_[i].entry;
+      bool const is_selected = (static_cast<int>(i) == selected_index_);
+
+      ImGui::PushID(static_cast<int>(i));
+      if (ImGui::Selectable("##lib", is_selected, 0, ImVec2(0, 24))) {
+        picked = static_cast<int>(i);
+      }
+      ImGui::SameLine();
+      const size_t slash = e.path.find_last_of("/\\");
+      ImGui::Text("%s", e.path.c_str() +
+                            (slash == std::string::npos ? 0 : slash + 1));
+      ImGui::SameLine();
+      ImGui::TextDisabled(" - %s %s", e.format.c_str(), e.hints.c_str());
+      if (ImGui::IsItemHovered() && !e.catalog.empty()) {
+        ImGui::SetTooltip("%s\n%s", e.path.c_str(), e.catalog.c_str());
+      }
+      ImGui::PopID();
+    }
+    ImGui::EndChild();
+
+    if (picked >= 0) {
+      library::Entry const entry =
+          lib_hits_[static_cast<size_t>(picked)].entry;
+      close();
+      if (library_handler_) library_handler_(entry);
+    }
   } else {
     if (focus_input_) {
       ImGui::SetKeyboardFocusHere();
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <vector>
 
+#include "media_library.h"
+
 struct CommandEntry {
   std::string name;
   std::string description;
@@ -41,12 +44,16 @@ class CommandPalette {
   void set_ipc_handler(IpcHandler handler);
   std::string execute_ipc(const std::string& command) const;
 
+  // Library tab: called with the entry picked from the media library search
+  using LibraryHandler = std::function<void(const library::Entry&)>;
+  void set_library_handler(LibraryHandler handler);
+
   // Access commands (for testing)
   const std::vector<CommandEntry>& commands() const { return commands_; }
 
  private:
   bool open_ = false;
-  int mode_ = 0;  // 0 = Commands, 1 = IPC
+  int mode_ = 0;  // 0 = Commands, 1 = IPC, 2 = Library
   char input_buf_[512] = {};
   int selected_index_ = 0;
   bool focus_input_ = false;
@@ -57,8 +64,15 @@ class CommandPalette {
   int ipc_history_pos_ = -1;
   char ipc_input_buf_[512] = {};
 
+  // Library mode state: hits cached per query and index generation
+  char lib_input_buf_[256] = {};
+  std::string lib_query_;
+  uint64_t lib_generation_ = ~uint64_t{0};
+  std::vector<library::Hit> lib_hits_;
+
   std::vector<CommandEntry> commands_;
   IpcHandler ipc_handler_;
+  LibraryHandler library_handler_;
 };
 
 // Global command palette instance
@@ -3550,12 +3550,18 @@ void DevToolsUI::render_recording_controls() {
                          "Recording (%u frames, %s)", fc,
                          format_size(g_avi_recorder.bytes_written()).c_str());
     } else {
-      ImGui::SetNextItemWidth(120);
-      ImGui::SliderInt("Quality##avi", &rc_avi_quality_, 1, 100);
+      ImGui::Checkbox("Lossless (ZMBV)##avi", &rc_avi_lossless_);
+      if (!rc_avi_lossless_) {
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(120);
+        ImGui::SliderInt("Quality##avi", &rc_avi_quality_, 1, 100);
+      }
       if (ImGui::Button("Record##avi")) {
         if (rc_avi_path_[0] != '\0') {
           std::string const err = g_avi_recorder.start(
-              rc_avi_path_, rc_avi_quality_, sample_rate, channels, bits);
+              rc_avi_path_, rc_avi_quality_, sample_rate, channels, bits,
+              rc_avi_lossless_ ? AviRecorder::Codec::Zmbv
+                               : AviRecorder::Codec::Mjpeg);
           rc_status_ = err.empty() ? "AVI recording started" : err;
         } else {
           rc_status_ = "Error: no AVI path specified";
@@ -261,6 +261,7 @@ class DevToolsUI {
   char rc_ym_path_[256] = "";
   char rc_avi_path_[256] = "";
   int rc_avi_quality_ = 85;
+  bool rc_avi_lossless_ = false;
   std::string rc_status_;
 
   // Assembler state
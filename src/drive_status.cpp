@@ -5,6 +5,7 @@
 
 #include "flux_save.h"
 #include "hw/fdc.h"
+#include "hw/flux.h"
 #include "hw_views.h"
 #include "koncepcja.h"
 #include "subcycle_bridge.h"
@@ -23,17 +24,17 @@ std::string image_basename(const std::string& path) {
 }  // namespace
 
 DriveMedium drive_medium_from(const FluxSaveCaps& caps, unsigned sector_tracks,
-                              unsigned sector_sides, int flux_ntracks) {
+                              unsigned sector_sides, int flux_ntracks,
+                              unsigned flux_sides) {
   DriveMedium m;
   if (!caps.present) return m;  // empty drive: t_drive may hold stale geometry
 
   m.present = true;
   m.flux = caps.can_scp;  // .scp/.hfe export ⇔ the medium is flux-backed
   if (m.flux && sector_tracks == 0) {
-    // Flux with no sector view: the cylinder count comes from the flux medium,
-    // and the FDC captures side 0 only, so the disc is single-sided here.
+    // Flux with no sector view: the geometry comes from the flux medium.
     m.tracks = flux_ntracks > 0 ? static_cast<unsigned>(flux_ntracks) : 0;
-    m.sides = 1;
+    m.sides = flux_sides;
   } else {
     m.tracks = sector_tracks;
     m.sides = sector_sides;
@@ -44,12 +45,16 @@ DriveMedium drive_medium_from(const FluxSaveCaps& caps, unsigned sector_tracks,
 DriveMedium drive_medium(int unit) {
   const t_drive& d = (unit & 1) != 0 ? driveB : driveA;
   int ntracks = 0;
-  if ((unit & 1) == 0) {  // flux is drive-A-only
-    if (const Device* fdc = subcycle_bridge_fdc()) {
-      fdc_media_track_dirty(fdc, ntracks);
-    }
+  unsigned sides = 1;
+  if (const Device* fdc = subcycle_bridge_fdc()) {
+    const auto u = static_cast<uint8_t>(unit & 1);
+    fdc_media_track_dirty(fdc, ntracks, u);
+    size_t scp_len = 0;
+    if (const uint8_t* scp = fdc_media_flux_scp(fdc, scp_len, u))
+      sides = flux_scp_heads(scp, scp_len) == 2 ? 2 : 1;
   }
-  return drive_medium_from(flux_save_caps(unit), d.tracks, d.sides, ntracks);
+  return drive_medium_from(flux_save_caps(unit), d.tracks, d.sides, ntracks,
+                           sides);
 }
 
 std::string emulator_status_summary() {
@@ -14,17 +14,18 @@ struct DriveMedium {
   bool present = false;  // a disc is in the drive
   bool flux = false;     // flux-backed (no sector view; .scp/.hfe export)
   unsigned tracks = 0;   // cylinder count, 0 when unknown
-  unsigned sides = 0;    // 1 for flux — the FDC captures side 0 only
+  unsigned sides = 0;    // for flux, the sides the capture holds
 };
 
 // Pure decision: describe the medium `caps` reports, filling in the geometry
 // from whichever view holds it. A sector-backed disc knows its own tracks and
 // sides; a flux-backed one has neither, so its cylinder count comes from
-// `flux_ntracks` (fdc_media_track_dirty) and it is single-sided by
-// construction. No disc in the drive means no geometry, whatever t_drive
-// happens to still hold.
+// `flux_ntracks` (fdc_media_track_dirty) and its sides from the capture
+// (`flux_sides`, flux_scp_heads). No disc in the drive means no geometry,
+// whatever t_drive happens to still hold.
 DriveMedium drive_medium_from(const FluxSaveCaps& caps, unsigned sector_tracks,
-                              unsigned sector_sides, int flux_ntracks);
+                              unsigned sector_sides, int flux_ntracks,
+                              unsigned flux_sides = 1);
 
 // The live medium of drive `unit` (0=A, 1=B).
 DriveMedium drive_medium(int unit);
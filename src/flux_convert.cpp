@@ -0,0 +1,232 @@
+/* flux_convert.cpp — batch flux / disc conversion (see flux_convert.h). */
+#include "flux_convert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "flux_ingest.h"  // flux::sniff / flux::to_scp
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// A full 102-track double-sided DD disc, as Machine::attach_flux sizes its
+// overlay; flux_scp_to_dsk shrinks the result to the real size.
+constexpr size_t kDskCap = 0x100 + (2 * 102 * (0x100 + 8192));
+
+const char* format_ext(SaveFormat fmt) {
+  switch (fmt) {
+    case SaveFormat::Dsk:
+      return ".dsk";
+    case SaveFormat::Scp:
+      return ".scp";
+    case SaveFormat::Hfe:
+      return ".hfe";
+  }
+  return "";
+}
+
+std::string lower_ext(const fs::path& p) {
+  std::string e = p.extension().string();
+  for (char& c : e)
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  return e;
+}
+
+bool is_flux_ext(const std::string& ext) {
+  return ext == ".ipf" || ext == ".raw" || ext == ".a2r" || ext == ".hfe" ||
+         ext == ".scp";
+}
+
+const char* dsk_error_text(long code) {
+  switch (code) {
+    case FLUX_E_NOT_SCP:
+      return "not a usable flux capture";
+    case FLUX_E_GEOMETRY:
+      return "unsupported flux geometry";
+    case FLUX_E_TRUNCATED:
+      return "truncated flux data";
+    case FLUX_E_TOO_LONG:
+      return "a track is longer than the decoder holds";
+    case FLUX_E_DSK_OVERFLOW:
+      return "the disc is larger than a DSK can hold";
+    case FLUX_E_NO_SECTORS:
+      return "no readable sectors (unformatted or non-IBM disc)";
+    default:
+      return "flux decode error";
+  }
+}
+
+struct Job {
+  fs::path input;
+  fs::path output;
+};
+
+}  // namespace
+
+const char* flux_weak_reason_text(uint8_t reason) {
+  switch (reason & (FLUX_WEAK_CRC | FLUX_WEAK_DIFFER)) {
+    case FLUX_WEAK_CRC:
+      return "crc";
+    case FLUX_WEAK_DIFFER:
+      return "differs";
+    case FLUX_WEAK_CRC | FLUX_WEAK_DIFFER:
+      return "crc+differs";
+    default:
+      return "?";
+  }
+}
+
+std::vector<uint8_t> flux_convert_bytes(const uint8_t* data, size_t len,
+                                        std::string_view ext, SaveFormat fmt,
+                                        FluxWeakReport* weak, std::string& err) {
+  err.clear();
+  if (weak != nullptr) *weak = FluxWeakReport{};
+  if (flux::sniff(data, len, ext) == flux::Container::Unknown) {
+    err = "not a flux image";
+    return {};
+  }
+  const std::vector<uint8_t> scp = flux::to_scp(data, len, ext);
+  if (scp.empty()) {
+    err = "unsupported or corrupt flux image";
+    return {};
+  }
+
+  // The sector view: the .dsk itself, and the clean-track source the flux
+  // writers splice from. A disc that will not decode to sectors can still
+  // be re-containered as flux.
+  std::vector<uint8_t> dsk(kDskCap);
+  FluxWeakReport report{};
+  const long dsk_len =
+      flux_scp_to_dsk(scp.data(), scp.size(), dsk.data(), dsk.size(), &report);
+  if (dsk_len > 0) {
+    dsk.resize(static_cast<size_t>(dsk_len));
+    if (weak != nullptr) *weak = report;
+  } else {
+    dsk.clear();
+    if (fmt == SaveFormat::Dsk) {
+      err = dsk_error_text(dsk_len);
+      return {};
+    }
+  }
+  return flux_save_bytes_from_medium(
+      scp.data(), scp.size(), dsk.empty() ? nullptr : dsk.data(), dsk.size(),
+      nullptr, 0, fmt, err);
+}
+
+std::vector<FluxConvertResult> flux_convert_tree(
+    const std::vector<std::string>& inputs, const FluxConvertOptions& opt,
+    const FluxConvertProgress& progress) {
+  const std::string to_ext = format_ext(opt.to);
+  std::vector<FluxConvertResult> results;
+  std::vector<Job> jobs;
+  std::map<fs::path, fs::path> claimed;  // output -> the input that owns it
+
+  auto plan = [&](const fs::path& file, const fs::path& rel) {
+    FluxConvertResult r;
+    r.input = file.string();
+    fs::path out = opt.out_dir.empty() ? file.parent_path()
+                                       : fs::path(opt.out_dir) /
+                                             rel.parent_path();
+    out /= file.stem().string() + to_ext;
+    r.output = out.string();
+    if (lower_ext(file) == to_ext) {
+      r.status = FluxConvertResult::Status::Skipped;
+      r.error = "already " + to_ext.substr(1);
+    } else if (!claimed.emplace(out, file).second) {
+      r.status = FluxConvertResult::Status::Skipped;
+      r.error = "same output as " + claimed[out].string();
+    } else {
+      jobs.push_back({file, out});
+      return;
+    }
+    results.push_back(std::move(r));
+  };
+
+  for (const std::string& in : inputs) {
+    std::error_code ec;
+    const fs::path root(in);
+    if (fs::is_directory(root, ec)) {
+      std::vector<fs::path> files;
+      fs::recursive_directory_iterator it(
+          root, fs::directory_options::skip_permission_denied, ec);
+      for (; !ec && it != fs::recursive_directory_iterator();
+           it.increment(ec)) {
+        if (it->is_regular_file(ec) && is_flux_ext(lower_ext(it->path())))
+          files.push_back(it->path());
+      }
+      std::sort(files.begin(), files.end());
+      for (const fs::path& f : files) plan(f, f.lexically_relative(root));
+    } else if (fs::is_regular_file(root, ec)) {
+      plan(root, root.filename());
+    } else {
+      FluxConvertResult r;
+      r.input = in;
+      r.error = "no such file or directory";
+      results.push_back(std::move(r));
+    }
+  }
+
+  std::vector<FluxConvertResult> done_jobs(jobs.size());
+  std::atomic<size_t> next{0};
+  std::mutex progress_mutex;
+  int done = 0;
+  const int total = static_cast<int>(jobs.size() + results.size());
+  if (progress) {
+    for (const FluxConvertResult& r : results) progress(r, ++done, total);
+  }
+  auto work = [&]() {
+    for (size_t i = next++; i < jobs.size(); i = next++) {
+      const Job& j = jobs[i];
+      FluxConvertResult& r = done_jobs[i];
+      r.input = j.input.string();
+      r.output = j.output.string();
+      std::error_code ec;
+      if (!opt.overwrite && fs::exists(j.output, ec)) {
+        r.status = FluxConvertResult::Status::Skipped;
+        r.error = "output exists";
+      } else {
+        std::ifstream f(j.input, std::ios::binary);
+        const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(f)),
+                                         std::istreambuf_iterator<char>());
+        const std::vector<uint8_t> out =
+            bytes.empty() ? std::vector<uint8_t>{}
+                          : flux_convert_bytes(bytes.data(), bytes.size(),
+                                               lower_ext(j.input), opt.to,
+                                               &r.weak, r.error);
+        if (bytes.empty()) r.error = "cannot read input";
+        if (!out.empty()) {
+          fs::create_directories(j.output.parent_path(), ec);
+          if (flux_write_file(out, r.output, r.error))
+            r.status = FluxConvertResult::Status::Converted;
+        }
+      }
+      if (progress) {
+        std::scoped_lock const lock(progress_mutex);
+        progress(r, ++done, total);
+      }
+    }
+  };
+  unsigned threads = opt.threads;
+  if (threads == 0)
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  threads = std::min<unsigned>(threads, std::max<size_t>(jobs.size(), 1));
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < threads; ++t) pool.emplace_back(work);
+  work();  // the caller is one of the workers
+  for (std::thread& t : pool) t.join();
+
+  for (FluxConvertResult& r : done_jobs) results.push_back(std::move(r));
+  std::sort(results.begin(), results.end(),
+            [](const FluxConvertResult& a, const FluxConvertResult& b) {
+              return a.input < b.input;
+            });
+  return results;
+}
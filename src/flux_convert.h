@@ -0,0 +1,65 @@
+/* flux_convert.h — batch flux / disc conversion, the core of the
+ * koncepcja_convert CLI (tools/koncepcja_convert.cpp). See
+ * docs/hardware/flux-media.md.
+ *
+ * One image goes through exactly the pipeline the emulator runs when the
+ * disc is inserted and then Save-As'd: flux::to_scp (any container → SCP),
+ * flux_scp_to_dsk (SCP → DSK, with its weak-sector report), then
+ * flux_save_bytes_from_medium for the chosen container. Nothing here touches
+ * a live machine, so a whole tree converts on every core at once.
+ *
+ * The flux writers are side-0 only (flux_save.h): a double-sided dump
+ * converts to .dsk, and to .scp / .hfe it fails with that advice. */
+#ifndef KONCPC_FLUX_CONVERT_H
+#define KONCPC_FLUX_CONVERT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flux_save.h"  // SaveFormat
+#include "hw/flux.h"    // FluxWeakReport
+
+// The bytes of `data` (a flux image; `ext` its lowercased extension, which
+// only breaks the magic-less KryoFlux tie) converted to `fmt`. `weak`
+// (optional) receives the weak-sector report of the decode; it is left
+// zeroed when the flux would not decode to sectors at all. Returns {} and
+// sets `err` on failure.
+std::vector<uint8_t> flux_convert_bytes(const uint8_t* data, size_t len,
+                                        std::string_view ext, SaveFormat fmt,
+                                        FluxWeakReport* weak, std::string& err);
+
+struct FluxConvertOptions {
+  SaveFormat to = SaveFormat::Dsk;
+  std::string out_dir;     // "" = beside each input; else mirrors the tree
+  unsigned threads = 0;    // 0 = one per hardware thread
+  bool overwrite = false;  // replace an existing output (else skip it)
+};
+
+struct FluxConvertResult {
+  enum class Status : uint8_t { Converted, Skipped, Failed };
+  std::string input;
+  std::string output;
+  Status status = Status::Failed;
+  std::string error;  // why it failed / was skipped
+  FluxWeakReport weak{};
+};
+
+// Called once per file as it finishes, from the worker pool (serialized).
+using FluxConvertProgress =
+    std::function<void(const FluxConvertResult& r, int done, int total)>;
+
+// Convert every flux image (.ipf .raw .a2r .hfe .scp) named in `inputs`,
+// walking directories recursively. An input already in the target container
+// is skipped. Results come back sorted by input path.
+std::vector<FluxConvertResult> flux_convert_tree(
+    const std::vector<std::string>& inputs, const FluxConvertOptions& opt,
+    const FluxConvertProgress& progress = {});
+
+// "crc", "differs" or "crc+differs" for a FluxWeakSector::reason.
+const char* flux_weak_reason_text(uint8_t reason);
+
+#endif  // KONCPC_FLUX_CONVERT_H
@@ -47,7 +47,8 @@ Container sniff(const uint8_t* data, size_t len, std::string_view ext_hint) {
 }
 
 std::vector<uint8_t> to_scp(const uint8_t* data, size_t len,
-                            std::string_view ext_hint) {
+                            std::string_view ext_hint,
+                            const Progress& progress) {
   std::vector<uint8_t> out;
   switch (sniff(data, len, ext_hint)) {
     case Container::Scp:
@@ -87,7 +88,7 @@ std::vector<uint8_t> to_scp(const uint8_t* data, size_t len,
       ipf::Image img;
       const ipf::Status ipf_status = img.open(data, len);
       if (ipf_status == ipf::Status::Ok) {
-        out = scp_from_mfm_tracks(img.mirror_side0(/*revs=*/3));
+        out = scp_from_mfm_tracks(img.mirror_side0(/*revs=*/3, progress));
         if (out.empty())
           LOG_ERROR("flux_ingest: clean IPF decoded to no flux (empty image?)");
         return out;
@@ -28,6 +28,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <string_view>
 #include <vector>
 
@@ -47,14 +48,22 @@ enum class Container : std::uint8_t {
 // `ext_hint` may be empty. Returns Container::Unknown for empty/garbage input.
 Container sniff(const uint8_t* data, size_t len, std::string_view ext_hint);
 
+// `done` of `total` steps of a transcode; see to_scp. Same shape as
+// ipf::Progress, so the IPF decoder reports through it directly.
+using Progress = std::function<void(int done, int total)>;
+
 // Transcode ANY supported flux container to in-memory SCP bytes ready for
 // insert_flux(). Returns {} on unsupported/failure, logging exactly one reason.
 //
 // IPF note: the clean-room decoder (ipf::Image) handles SPS-encoder IPFs. A
 // CAPS-encoder (encoderType 1) IPF is unsupported and returns {} with a clear
-// log — there is no fallback (re-image such a disc as SPS/SCP/HFE).
+// log — there is no fallback (re-image such a disc as SPS/SCP/HFE). An IPF is
+// the one slow container: its tracks decode on a thread pool, and `progress`
+// (optional) is called from the pool as they finish. The other containers
+// transcode in one quick pass and do not report.
 std::vector<uint8_t> to_scp(const uint8_t* data, size_t len,
-                            std::string_view ext_hint);
+                            std::string_view ext_hint,
+                            const Progress& progress = {});
 
 }  // namespace flux
 
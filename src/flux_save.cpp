@@ -11,6 +11,7 @@
 #include "hfe_write.h"        // hfe_from_disk
 #include "hw/device.h"        // Device
 #include "hw/fdc.h"           // fdc_media_* accessors
+#include "hw/flux.h"          // flux_scp_heads
 #include "scp_write.h"        // scp_from_disk
 #include "subcycle_bridge.h"  // subcycle_bridge_fdc
 
@@ -21,6 +22,13 @@ bool medium_is_flux(const std::uint8_t* scp, std::size_t scp_len) {
   return scp != nullptr && scp_len > 0;
 }
 
+// The flux writers (scp_write.h / hfe_write.h) re-encode side 0 only: a
+// double-sided capture would lose its second side, so it saves as .dsk
+// (the export is refused with that advice rather than silently halved).
+bool medium_is_single_sided(const std::uint8_t* scp, std::size_t scp_len) {
+  return flux_scp_heads(scp, scp_len) == 1;
+}
+
 // A read-only flux dump (no overlay) has no per-track dirty map, so treat every
 // track as clean → the encoders splice the original flux verbatim.
 int effective_ntracks(const bool* track_dirty, int ntracks) {
@@ -47,6 +55,10 @@ std::vector<std::uint8_t> save_as_scp(const std::uint8_t* scp,
     err = "SCP export needs a flux-backed disc (this one is sector-backed)";
     return {};
   }
+  if (!medium_is_single_sided(scp, scp_len)) {
+    err = "SCP export is side-0 only (save this double-sided disc as .dsk)";
+    return {};
+  }
   std::vector<std::uint8_t> out =
       scp_from_disk(scp, scp_len, image, image_len, track_dirty,
                     effective_ntracks(track_dirty, ntracks));
@@ -79,6 +91,10 @@ std::vector<std::uint8_t> save_as_hfe(const std::uint8_t* scp,
     err = "HFE export needs a flux-backed disc (this one is sector-backed)";
     return {};
   }
+  if (!medium_is_single_sided(scp, scp_len)) {
+    err = "HFE export is side-0 only (save this double-sided disc as .dsk)";
+    return {};
+  }
   std::vector<std::uint8_t> out;
   const int code = hfe_from_disk(scp, scp_len, image, image_len, track_dirty,
                                  effective_ntracks(track_dirty, ntracks), out);
@@ -115,10 +131,8 @@ FluxSaveCaps flux_save_caps_dev(const Device* fdc, std::uint8_t unit) {
   if (fdc == nullptr) return caps;
   std::size_t image_len = 0;
   const std::uint8_t* image = fdc_media_image_unit(fdc, unit, image_len);
-  const std::uint8_t* scp = nullptr;
   std::size_t scp_len = 0;
-  if ((unit & 1u) == 0)
-    scp = fdc_media_flux_scp(fdc, scp_len);  // flux = drive A
+  const std::uint8_t* scp = fdc_media_flux_scp(fdc, scp_len, unit);
   const bool flux = medium_is_flux(scp, scp_len);
   caps.can_dsk = image != nullptr && image_len > 0;
   caps.can_scp = flux;
@@ -136,14 +150,10 @@ std::vector<std::uint8_t> flux_save_bytes_dev(const Device* fdc,
   }
   std::size_t image_len = 0;
   const std::uint8_t* image = fdc_media_image_unit(fdc, unit, image_len);
-  const std::uint8_t* scp = nullptr;
   std::size_t scp_len = 0;
-  const bool* track_dirty = nullptr;
+  const std::uint8_t* scp = fdc_media_flux_scp(fdc, scp_len, unit);
   int ntracks = 0;
-  if ((unit & 1u) == 0) {  // flux is drive-A-only; drive B is always sector
-    scp = fdc_media_flux_scp(fdc, scp_len);
-    track_dirty = fdc_media_track_dirty(fdc, ntracks);
-  }
+  const bool* track_dirty = fdc_media_track_dirty(fdc, ntracks, unit);
   return flux_save_bytes_from_medium(scp, scp_len, image, image_len,
                                      track_dirty, ntracks, fmt, err);
 }
@@ -154,7 +164,8 @@ bool flux_write_file(const std::vector<std::uint8_t>& bytes,
     err = "nothing to write (empty image)";
     return false;
   }
-  FILE* file = std::fopen(path.c_str(), "wb");
+  const std::string tmp = path + ".tmp";
+  FILE* file = std::fopen(tmp.c_str(), "wb");
   if (file == nullptr) {
     err = "cannot open '" + path + "' for writing";
     return false;
@@ -164,9 +175,18 @@ bool flux_write_file(const std::vector<std::uint8_t>& bytes,
   const bool flushed = std::fflush(file) == 0;
   const bool closed = std::fclose(file) == 0;
   if (!wrote || !flushed || !closed) {
+    std::remove(tmp.c_str());
     err = "write error for '" + path + "' (disk full or I/O error)";
     return false;
   }
+#ifdef _WIN32
+  std::remove(path.c_str());  // Windows rename() will not replace
+#endif
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    err = "cannot replace '" + path + "'";
+    return false;
+  }
   return true;
 }
 
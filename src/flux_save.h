@@ -27,8 +27,10 @@ struct Device;  // hw/device.h — the live FDC handle
 enum class SaveFormat : std::uint8_t { Dsk, Scp, Hfe };
 
 // What a drive's live medium can be saved as. A sector-backed disc offers .dsk
-// only; a flux-backed drive-A disc additionally offers .scp / .hfe (the flux
-// container preserves the weak/protection bits of tracks the CPC never wrote).
+// only; a flux-backed disc additionally offers .scp / .hfe (the flux container
+// preserves the weak/protection bits of tracks the CPC never wrote). The flux
+// writers are side-0 only: exporting a double-sided flux disc fails with an
+// error that points at .dsk.
 struct FluxSaveCaps {
   bool present = false;  // a disc is in the drive at all
   bool can_dsk = false;  // .dsk save available (a sector image / DSK overlay)
@@ -52,8 +54,8 @@ std::vector<uint8_t> flux_save_bytes_from_medium(
     std::string& err);
 
 // Read the live medium of drive `unit` off a live FDC Device (unit 0 = A,
-// 1 = B) and delegate to flux_save_bytes_from_medium. Flux is drive-A-only, so
-// unit 1 always resolves to the sector path.
+// 1 = B) and delegate to flux_save_bytes_from_medium. Either drive may hold
+// flux.
 std::vector<uint8_t> flux_save_bytes_dev(const Device* fdc, std::uint8_t unit,
                                          SaveFormat fmt, std::string& err);
 
@@ -61,7 +63,10 @@ std::vector<uint8_t> flux_save_bytes_dev(const Device* fdc, std::uint8_t unit,
 FluxSaveCaps flux_save_caps_dev(const Device* fdc, std::uint8_t unit);
 
 // Write `bytes` to `path` with checked stdio (disk-full / I/O errors are
-// reported, never silent). Returns true on success; sets `err` otherwise.
+// reported, never silent). The bytes go to `path`.tmp, renamed over `path`:
+// a Save-As onto the image a drive has mapped (media_file.h) replaces the
+// file instead of truncating the pages under the FDC. Returns true on
+// success; sets `err` otherwise.
 bool flux_write_file(const std::vector<uint8_t>& bytes, const std::string& path,
                      std::string& err);
 
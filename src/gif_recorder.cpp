@@ -1,69 +1,411 @@
-#define MSF_GIF_IMPL
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
-#include "msf_gif.h"
-#pragma GCC diagnostic pop
+#include "gif_recorder.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
 #include <cstring>
-#include <fstream>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
-#include "gif_recorder.h"
+namespace {
+
+// Frames the emulation side may run ahead of the encoder before add_frame
+// waits. Each is one w*h*4 copy, so this is the recorder's memory bound.
+constexpr size_t kMaxQueued = 8;
+
+constexpr int kLzwMaxCode = 4096;
+
+// GIF LZW, variable width, LSB-first bit packing into 255-byte sub-blocks.
+class LzwWriter {
+ public:
+  explicit LzwWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+  void encode(const uint8_t* idx, size_t n, int min_bits) {
+    out_.push_back(static_cast<uint8_t>(min_bits));
+    const int clear = 1 << min_bits;
+    reset(min_bits);
+    put(clear);
+    int prefix = idx[0];
+    for (size_t i = 1; i < n; ++i) {
+      const uint8_t c = idx[i];
+      const uint32_t key = (static_cast<uint32_t>(prefix) << 8) | c;
+      const int code = find(key);
+      if (code >= 0) {
+        prefix = code;
+        continue;
+      }
+      put(prefix);
+      if (next_ < kLzwMaxCode) {
+        insert(key, next_++);
+        // The decoder adds each entry one code later than we do; widen once
+        // our next code no longer fits what it will read at.
+        if (next_ > (1 << bits_) && bits_ < 12) bits_++;
+      } else {
+        put(clear);
+        reset(min_bits);
+      }
+      prefix = c;
+    }
+    put(prefix);
+    put(clear + 1);  // end of information
+    if (nbits_ > 0) byte(static_cast<uint8_t>(acc_));
+    acc_ = 0;
+    nbits_ = 0;
+    if (block_len_ > 0) flush_block();
+    out_.push_back(0);  // block terminator
+  }
+
+ private:
+  static constexpr int kHashSize = 8192;  // > 4096 codes, power of two
+
+  void reset(int min_bits) {
+    std::fill(std::begin(keys_), std::end(keys_), ~uint32_t{0});
+    next_ = (1 << min_bits) + 2;
+    bits_ = min_bits + 1;
+  }
+  int find(uint32_t key) const {
+    uint32_t h = (key * 2654435761u) >> 19;
+    while (keys_[h] != ~uint32_t{0}) {
+      if (keys_[h] == key) return codes_[h];
+      h = (h + 1) & (kHashSize - 1);
+    }
+    return -1;
+  }
+  void insert(uint32_t key, int code) {
+    uint32_t h = (key * 2654435761u) >> 19;
+    while (keys_[h] != ~uint32_t{0}) h = (h + 1) & (kHashSize - 1);
+    keys_[h] = key;
+    codes_[h] = static_cast<uint16_t>(code);
+  }
+  void put(int code) {
+    acc_ |= static_cast<uint32_t>(code) << nbits_;
+    nbits_ += bits_;
+    while (nbits_ >= 8) {
+      byte(static_cast<uint8_t>(acc_));
+      acc_ >>= 8;
+      nbits_ -= 8;
+    }
+  }
+  void byte(uint8_t b) {
+    block_[block_len_++] = b;
+    if (block_len_ == 255) flush_block();
+  }
+  void flush_block() {
+    out_.push_back(static_cast<uint8_t>(block_len_));
+    out_.insert(out_.end(), block_, block_ + block_len_);
+    block_len_ = 0;
+  }
+
+  std::vector<uint8_t>& out_;
+  uint32_t keys_[kHashSize];
+  uint16_t codes_[kHashSize];
+  int next_ = 0, bits_ = 0;
+  uint32_t acc_ = 0;
+  int nbits_ = 0;
+  uint8_t block_[255];
+  int block_len_ = 0;
+};
+
+void put_u16(std::vector<uint8_t>& out, int v) {
+  out.push_back(static_cast<uint8_t>(v & 0xFF));
+  out.push_back(static_cast<uint8_t>((v >> 8) & 0xFF));
+}
+
+// Fallback for a rect with more than 255 colours: a 6x7x6 cube (252 entries).
+uint8_t cube_index(uint32_t rgb) {
+  const uint32_t r = (rgb >> 16) & 0xFF, g = (rgb >> 8) & 0xFF, b = rgb & 0xFF;
+  return static_cast<uint8_t>(((r * 6 / 256) * 42) + ((g * 7 / 256) * 6) +
+                              (b * 6 / 256));
+}
+uint32_t cube_rgb(int i) {
+  const uint32_t r = ((i / 42) * 255 + 2) / 5;
+  const uint32_t g = (((i / 6) % 7) * 255 + 3) / 6;
+  const uint32_t b = ((i % 6) * 255 + 2) / 5;
+  return (r << 16) | (g << 8) | b;
+}
+
+}  // namespace
+
+struct GifRecorder::Encoder {
+  FILE* file = nullptr;
+  std::string path;
+  int w = 0, h = 0, delay_cs = 2;
+
+  std::mutex m;
+  std::condition_variable cv;
+  std::deque<std::vector<uint32_t>> queue;  // 0x00RRGGBB per pixel
+  std::vector<std::vector<uint32_t>> pool;  // recycled frame buffers
+  bool stopping = false;
+  bool failed = false;
+  std::thread worker;
+
+  // Worker-owned.
+  std::vector<uint32_t> shown;    // what a decoder displays after the last frame
+  bool have_shown = false;
+  std::vector<uint8_t> pending;   // last frame's encoded bytes, delay unsettled
+  int pending_delay = 0;
+  std::vector<uint8_t> idx;       // rect colour indices
+  // ~48K of dictionary: heap, not the worker's stack. Appends to pending.
+  std::unique_ptr<LzwWriter> lzw = std::make_unique<LzwWriter>(pending);
 
-bool GifRecorder::begin(int width, int height, int delay) {
+  bool write(const std::vector<uint8_t>& bytes) {
+    return std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+  }
+
+  // The pending frame's delay is only final once the next frame differs (or
+  // the recording ends): patch it into its graphic control extension, write.
+  bool flush_pending() {
+    if (pending.empty()) return true;
+    pending[4] = static_cast<uint8_t>(pending_delay & 0xFF);
+    pending[5] = static_cast<uint8_t>((pending_delay >> 8) & 0xFF);
+    const bool ok = write(pending);
+    pending.clear();
+    return ok;
+  }
+
+  bool encode(const std::vector<uint32_t>& px) {
+    // Changed rectangle against what is on screen.
+    if (!have_shown) shown.assign(static_cast<size_t>(w) * h, 0);
+    int x0 = 0, y0 = 0, x1 = w - 1, y1 = h - 1;
+    if (have_shown) {
+      y0 = 0;
+      while (y0 < h && std::memcmp(&px[static_cast<size_t>(y0) * w],
+                                   &shown[static_cast<size_t>(y0) * w],
+                                   static_cast<size_t>(w) * 4) == 0)
+        y0++;
+      if (y0 == h) {  // identical: the previous frame just stays up longer
+        pending_delay = std::min(pending_delay + delay_cs, 0xFFFF);
+        return true;
+      }
+      y1 = h - 1;
+      while (std::memcmp(&px[static_cast<size_t>(y1) * w],
+                         &shown[static_cast<size_t>(y1) * w],
+                         static_cast<size_t>(w) * 4) == 0)
+        y1--;
+      x0 = w;
+      x1 = -1;
+      for (int y = y0; y <= y1; ++y) {
+        const uint32_t* a = &px[static_cast<size_t>(y) * w];
+        const uint32_t* b = &shown[static_cast<size_t>(y) * w];
+        int l = 0;
+        while (l < x0 && a[l] == b[l]) l++;
+        x0 = std::min(x0, l);
+        int r = w - 1;
+        while (r > x1 && a[r] == b[r]) r--;
+        x1 = std::max(x1, r);
+      }
+    }
+    const int rw = x1 - x0 + 1, rh = y1 - y0 + 1;
+
+    // Exact palette over the changed pixels; pixels already on screen become
+    // transparent (index 0 is reserved for that once a frame is shown).
+    const bool transp = have_shown;
+    uint32_t pal[256];
+    pal[0] = 0;  // the transparent slot still goes out in the colour table
+    int npal = transp ? 1 : 0;
+    uint32_t hkeys[512];
+    uint8_t hvals[512];
+    std::fill(std::begin(hkeys), std::end(hkeys), ~uint32_t{0});
+    idx.resize(static_cast<size_t>(rw) * rh);
+    bool exact = true;
+    size_t o = 0;
+    for (int y = y0; y <= y1 && exact; ++y) {
+      const uint32_t* a = &px[(static_cast<size_t>(y) * w) + x0];
+      const uint32_t* b = &shown[(static_cast<size_t>(y) * w) + x0];
+      for (int x = 0; x < rw; ++x) {
+        const uint32_t c = a[x];
+        if (transp && c == b[x]) {
+          idx[o++] = 0;
+          continue;
+        }
+        uint32_t hh = (c * 2654435761u) >> 23;
+        while (hkeys[hh] != ~uint32_t{0} && hkeys[hh] != c) hh = (hh + 1) & 511;
+        if (hkeys[hh] == ~uint32_t{0}) {
+          if (npal == 256) {
+            exact = false;
+            break;
+          }
+          hkeys[hh] = c;
+          hvals[hh] = static_cast<uint8_t>(npal);
+          pal[npal++] = c;
+        }
+        idx[o++] = hvals[hh];
+      }
+    }
+    if (!exact) {  // > 255 colours in the rect: the fixed cube, offset by one
+      npal = 253;
+      pal[0] = 0;
+      for (int i = 0; i < 252; ++i) pal[i + 1] = cube_rgb(i);
+      o = 0;
+      for (int y = y0; y <= y1; ++y) {
+        const uint32_t* a = &px[(static_cast<size_t>(y) * w) + x0];
+        const uint32_t* b = &shown[(static_cast<size_t>(y) * w) + x0];
+        for (int x = 0; x < rw; ++x)
+          idx[o++] = (transp && a[x] == b[x])
+                         ? 0
+                         : static_cast<uint8_t>(cube_index(a[x]) + 1);
+      }
+    }
+
+    // Track the displayed image (the cube path shows approximations).
+    o = 0;
+    for (int y = y0; y <= y1; ++y) {
+      uint32_t* s = &shown[(static_cast<size_t>(y) * w) + x0];
+      for (int x = 0; x < rw; ++x, ++o)
+        if (!transp || idx[o] != 0) s[x] = pal[idx[o]];
+    }
+    have_shown = true;
+
+    if (!flush_pending()) return false;
+    int bits = 1;
+    while ((1 << bits) < npal) bits++;
+    std::vector<uint8_t>& out = pending;
+    // Graphic control extension: disposal 1 (keep), delay patched on flush.
+    out.insert(out.end(), {0x21, 0xF9, 0x04,
+                           static_cast<uint8_t>((1 << 2) | (transp ? 1 : 0)),
+                           0, 0, 0, 0});
+    pending_delay = delay_cs;
+    // Image descriptor + local colour table.
+    out.push_back(0x2C);
+    put_u16(out, x0);
+    put_u16(out, y0);
+    put_u16(out, rw);
+    put_u16(out, rh);
+    out.push_back(static_cast<uint8_t>(0x80 | (bits - 1)));
+    for (int i = 0; i < (1 << bits); ++i) {
+      const uint32_t c = i < npal ? pal[i] : 0;
+      out.push_back(static_cast<uint8_t>(c >> 16));
+      out.push_back(static_cast<uint8_t>(c >> 8));
+      out.push_back(static_cast<uint8_t>(c));
+    }
+    lzw->encode(idx.data(), idx.size(), std::max(bits, 2));
+    return true;
+  }
+
+  void run() {
+    std::unique_lock<std::mutex> lock(m);
+    for (;;) {
+      cv.wait(lock, [&] { return stopping || !queue.empty(); });
+      if (queue.empty()) break;  // stopping and drained
+      std::vector<uint32_t> frame = std::move(queue.front());
+      queue.pop_front();
+      cv.notify_all();  // a slot is free for add_frame
+      const bool skip = failed;
+      lock.unlock();
+      const bool ok = skip || encode(frame);
+      lock.lock();
+      if (!ok) failed = true;
+      pool.push_back(std::move(frame));
+    }
+    lock.unlock();
+    if (!failed && !flush_pending()) failed = true;
+  }
+};
+
+GifRecorder::GifRecorder() = default;
+
+GifRecorder::~GifRecorder() {
   if (recording) abort();
-  auto* s = new MsfGifState{};
-  if (!msf_gif_begin(s, width, height)) {
-    delete s;
+}
+
+bool GifRecorder::begin(const std::string& path, int width, int height,
+                        int delay) {
+  if (recording) abort();
+  if (width <= 0 || height <= 0 || width > 0xFFFF || height > 0xFFFF)
+    return false;
+  FILE* f = std::fopen(path.c_str(), "wb");
+  if (!f) return false;
+  auto e = std::make_unique<Encoder>();
+  e->file = f;
+  e->path = path;
+  e->w = width;
+  e->h = height;
+  e->delay_cs = std::clamp(delay, 1, 0xFFFF);
+  // Header + logical screen (no global table: every frame carries its exact
+  // local one) + NETSCAPE2.0 loop-forever.
+  std::vector<uint8_t> hdr = {'G', 'I', 'F', '8', '9', 'a'};
+  put_u16(hdr, width);
+  put_u16(hdr, height);
+  hdr.insert(hdr.end(), {0x00, 0x00, 0x00});
+  hdr.insert(hdr.end(), {0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P',
+                         'E', '2', '.', '0', 0x03, 0x01, 0x00, 0x00, 0x00});
+  if (!e->write(hdr)) {
+    std::fclose(f);
+    std::remove(path.c_str());
     return false;
   }
-  state = s;
-  delay_cs = delay;
+  Encoder* raw = e.get();
+  e->worker = std::thread([raw] { raw->run(); });
+  enc = std::move(e);
   frames_added = 0;
   recording = true;
   return true;
 }
 
 bool GifRecorder::add_frame(const uint8_t* pixels, int pitch) {
-  if (!recording || !state) return false;
-  auto* s = static_cast<MsfGifState*>(state);
-  // msf_gif_frame takes non-const uint8_t* but doesn't modify pixels
-  int const ok =
-      msf_gif_frame(s, const_cast<uint8_t*>(pixels), delay_cs, 16, pitch);
-  if (ok) frames_added++;
-  return ok != 0;
+  if (!recording || !enc) return false;
+  Encoder& e = *enc;
+  std::vector<uint32_t> frame;
+  {
+    std::unique_lock<std::mutex> lock(e.m);
+    e.cv.wait(lock, [&] { return e.queue.size() < kMaxQueued || e.failed; });
+    if (e.failed) return false;
+    if (!e.pool.empty()) {
+      frame = std::move(e.pool.back());
+      e.pool.pop_back();
+    }
+  }
+  frame.resize(static_cast<size_t>(e.w) * e.h);
+  uint32_t* d = frame.data();
+  for (int y = 0; y < e.h; ++y) {
+    const uint8_t* s = pixels + (static_cast<size_t>(y) * pitch);
+    for (int x = 0; x < e.w; ++x, s += 4)
+      *d++ = (static_cast<uint32_t>(s[0]) << 16) |
+             (static_cast<uint32_t>(s[1]) << 8) | s[2];
+  }
+  {
+    std::lock_guard<std::mutex> lock(e.m);
+    e.queue.push_back(std::move(frame));
+  }
+  e.cv.notify_all();
+  frames_added++;
+  return true;
 }
 
-bool GifRecorder::end(const std::string& path) {
-  if (!recording || !state) return false;
-  auto* s = static_cast<MsfGifState*>(state);
-  MsfGifResult const result = msf_gif_end(s);
-  delete s;
-  state = nullptr;
-  recording = false;
-
-  if (!result.data) return false;
-
-  std::ofstream ofs(path, std::ios::binary);
-  // NOLINTNEXTLINE(misc-const-correctness): clang-tidy FP — variable is mutated
-  // (out-param/compound-assign/loop/reference)
-  bool ok = false;
-  if (ofs) {
-    ofs.write(static_cast<const char*>(static_cast<const void*>(result.data)),
-              result.dataSize);
-    ok = ofs.good();
+bool GifRecorder::end() {
+  if (!recording || !enc) return false;
+  Encoder& e = *enc;
+  {
+    std::lock_guard<std::mutex> lock(e.m);
+    e.stopping = true;
   }
-  msf_gif_free(result);
+  e.cv.notify_all();
+  e.worker.join();
+  bool ok = !e.failed && frames_added > 0;
+  const uint8_t trailer = 0x3B;
+  ok = ok && std::fwrite(&trailer, 1, 1, e.file) == 1;
+  ok = (std::fclose(e.file) == 0) && ok;
+  if (!ok) std::remove(e.path.c_str());
+  enc.reset();
+  recording = false;
   return ok;
 }
 
 void GifRecorder::abort() {
-  if (state) {
-    auto* s = static_cast<MsfGifState*>(state);
-    msf_gif_end(s);  // frees internal allocations
-    delete s;
-    state = nullptr;
+  if (enc) {
+    {
+      std::lock_guard<std::mutex> lock(enc->m);
+      enc->stopping = true;
+      enc->failed = true;  // drain without encoding
+    }
+    enc->cv.notify_all();
+    enc->worker.join();
+    std::fclose(enc->file);
+    std::remove(enc->path.c_str());
+    enc.reset();
   }
   recording = false;
   frames_added = 0;
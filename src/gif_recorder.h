@@ -1,35 +1,47 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
 // Animated GIF recorder for frame dumps.
-// Uses msf_gif.h internally for LZW-compressed, delta-encoded GIF output.
+//
+// Frames stream to the file while recording: add_frame() copies the pixels
+// into a bounded queue and a worker thread encodes each one against the
+// previous frame — only the changed rectangle is emitted (unchanged pixels
+// inside it transparent), with an EXACT local palette (a CPC screen holds at
+// most 27 classic / 4096 Plus colours, rarely more than 255 in one rect; a
+// rect that does exceed that falls back to a fixed 6x7x6 colour cube).
+// Identical frames extend the previous frame's delay instead of adding one.
+// Memory is bounded by the queue depth and end() only drains what is queued.
 
 class GifRecorder {
  public:
-  ~GifRecorder() {
-    if (recording) abort();
-  }
-  // Begin recording frames for an animated GIF.
+  GifRecorder();
+  ~GifRecorder();
+  GifRecorder(const GifRecorder&) = delete;
+  GifRecorder& operator=(const GifRecorder&) = delete;
+
+  // Begin recording an animated GIF to path (the header is written now).
   // delay_cs: inter-frame delay in centiseconds (default 2 = 50fps CPC timing)
-  bool begin(int width, int height, int delay_cs = 2);
+  bool begin(const std::string& path, int width, int height, int delay_cs = 2);
 
-  // Add one frame (RGBA8 pixel data, pitch in bytes).
+  // Add one frame (RGBA8 pixel data — R,G,B,x byte order — pitch in bytes).
+  // Blocks only while the encoder is a full queue behind.
   bool add_frame(const uint8_t* pixels, int pitch);
 
-  // Finish and write the GIF to path. Returns true on success.
-  bool end(const std::string& path);
+  // Drain the queue, write the trailer and close. Returns true on success.
+  bool end();
 
-  // Discard without saving.
+  // Discard without saving (the partial file is removed).
   void abort();
 
   bool is_recording() const { return recording; }
   int frame_count() const { return frames_added; }
 
  private:
-  void* state = nullptr;  // MsfGifState*, opaque to avoid header leak
+  struct Encoder;  // worker thread + queue, opaque to avoid header leak
+  std::unique_ptr<Encoder> enc;
   bool recording = false;
-  int delay_cs = 2;
   int frames_added = 0;
 };
@@ -5,7 +5,7 @@
  * transcode rather than write a second decoder: parse the A2R3 RWCP capture and
  * emit an SCP byte image that flux_scp_* consumes unchanged.
  *
- * Only side-0 timing captures are emitted (the decoder is side-0 only). A2R's
+ * Only side-0 timing captures are emitted (CPC media are single-sided). A2R's
  * tick is 125 ns; we set the SCP resolution byte to 4 (25 ns * (4+1) = 125 ns)
  * so the flux values copy across without rescaling and the decoder's nominal
  * half-cell (80/(res+1) = 16 ticks = 2 us) is physically correct for DD.
@@ -90,9 +90,14 @@ struct asic_state {
   // palette incl. classic-ink snoops, scroll/config) — F8 R17. The video
   // device skips its per-line re-snapshot while this is unchanged (a re-read
   // of unchanged registers is idempotent, so the skip is exact). Monotonic;
-  // MUST REMAIN THE LAST MEMBER: version-1 save blobs load as
-  // offsetof(asic_state, vid_gen) bytes.
+  // version-1 save blobs load as offsetof(asic_state, vid_gen) bytes.
   uint32_t vid_gen = 1;
+  // Write generation of the sprite pixel RAM (&4000-&4FFF). Pixels are read
+  // live (never line-snapshot), so this is the video device's key for its
+  // per-line sprite layer: unchanged ⟹ the composited spans are still exact.
+  // Session-local like vid_gen; version-2 blobs load as
+  // offsetof(asic_state, spr_gen) bytes. MUST REMAIN THE LAST MEMBER.
+  uint32_t spr_gen = 1;
 };
 
 // The DMA engine's cycle-by-cycle state. A burst: request the bus, wait for the
@@ -150,6 +155,7 @@ void decode_sprite_pixel(asic_state* a, uint16_t addr, uint8_t val) {
   const int y = (addr & 0x00F0) >> 4;
   const int x = addr & 0x000F;
   a->sprite_px[id][x][y] = val & 0x0F;
+  a->spr_gen++;
 }
 
 // &6000-&607F: sprite attributes, 8 bytes each. type 0/1 = X lo/hi (10-bit),
@@ -599,19 +605,24 @@ size_t asic_dev_state_size(const void* /*unused*/) {
 }
 void asic_save(const void* self, void* buf) {
   uint8_t* b = static_cast<uint8_t*>(buf);
-  b[0] = 2;  // v2 appends vid_gen to the struct (v1 blobs still load)
+  b[0] = 3;  // v2 appended vid_gen, v3 spr_gen (older blobs still load)
   std::memcpy(b + 1, self, sizeof(asic_state));
-  // vid_gen is a session-local cache key, not machine state: zero it in the
-  // blob so saves stay canonical (byte-identical for identical hardware
-  // state); every load re-keys it below.
+  // The generations are session-local cache keys, not machine state: zero
+  // them in the blob so saves stay canonical (byte-identical for identical
+  // hardware state); every load re-keys them below.
   std::memset(b + 1 + offsetof(asic_state, vid_gen), 0, sizeof(uint32_t));
+  std::memset(b + 1 + offsetof(asic_state, spr_gen), 0, sizeof(uint32_t));
 }
 void asic_load(void* self, const void* buf) {
   asic_state* a = self_of(self);
   const uint32_t live_gen = a->vid_gen;
+  const uint32_t live_spr_gen = a->spr_gen;
   const uint8_t* b = static_cast<const uint8_t*>(buf);
-  if (b[0] == 2) {
+  if (b[0] == 3) {
     std::memcpy(self, b + 1, sizeof(asic_state));
+  } else if (b[0] == 2) {
+    // v2 predates spr_gen (now the last member).
+    std::memcpy(self, b + 1, offsetof(asic_state, spr_gen));
   } else if (b[0] == 1) {
     // v1 predates vid_gen (the last member) — its blob holds exactly the
     // bytes before it.
@@ -620,6 +631,7 @@ void asic_load(void* self, const void* buf) {
   // Any load moves the snapshot inputs out from under a cached generation —
   // re-key past every generation this process has seen.
   a->vid_gen = live_gen + 1;
+  a->spr_gen = live_spr_gen + 1;
 }
 
 }  // namespace
@@ -709,6 +721,16 @@ uint8_t asic_vid_sprite_pixel(const Device* dev, int id, int x, int y) {
   return a->sprite_px[id & 0x0F][x & 0x0F][y & 0x0F];
 }
 
+uint32_t asic_vid_sprite_gen(const Device* dev) {
+  return static_cast<const asic_state*>(dev->self)->spr_gen;
+}
+
+void asic_vid_sprite_row(const Device* dev, int id, int y, uint8_t out[16]) {
+  const asic_state* a = static_cast<const asic_state*>(dev->self);
+  const int i = id & 0x0F, row = y & 0x0F;
+  for (int x = 0; x < 16; ++x) out[x] = a->sprite_px[i][x][row];
+}
+
 void asic_vid_sprite_attr(const Device* dev, int id, uint16_t* x, uint16_t* y,
                           uint8_t* mag_x, uint8_t* mag_y) {
   const asic_state* a = static_cast<const asic_state*>(dev->self);
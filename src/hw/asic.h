@@ -99,6 +99,16 @@ int asic_vid_palette_set(const Device* dev, int index);
  * 16+n (the sprite palette bank). */
 uint8_t asic_vid_sprite_pixel(const Device* dev, int id, int x, int y);
 
+/* One whole pixel row `y` (0..15) of sprite `id`, left to right — the span
+ * builder's bulk form of asic_vid_sprite_pixel. */
+void asic_vid_sprite_row(const Device* dev, int id, int y, uint8_t out[16]);
+
+/* Write generation of the sprite pixel RAM. Pixels are read live, not
+ * snapshot: the video device keys its per-line sprite layer on this and
+ * rebuilds it whenever a pixel write lands mid-line. Session-local, re-keyed
+ * by load like asic_vid_gen. */
+uint32_t asic_vid_sprite_gen(const Device* dev);
+
 /* Sprite `id` attributes: X (10-bit), Y (9-bit), per-axis magnification
  * (0/1/2/4). Any out-pointer may be null. */
 void asic_vid_sprite_attr(const Device* dev, int id, uint16_t* x, uint16_t* y,
@@ -87,7 +87,6 @@ struct fdc_track {
 };
 
 constexpr size_t kFluxPayload = 8192;  // one DD revolution carries ~6250 bytes
-constexpr int kFluxRevs = 2;           // revolutions cached per track
 
 // The caller attachment + parsed geometry: live wiring (docs §5), never
 // serialized. MUST stay the LAST member of fdc_state — save/load cover only the
@@ -96,20 +95,23 @@ struct fdc_media {
   uint8_t* image = nullptr;  // caller-owned DSK buffer, mutated by writes (§10)
   size_t len = 0;
   bool dirty = false;  // buffer diverged from its file since attach/mark_clean
+  // Write-back map: bit s of track_written[c] = side s of cylinder c was
+  // written since attach/mark_clean (fdc_media_written_tracks).
+  uint8_t track_written[kMaxTracks] = {};
   uint8_t tracks = 0;
   uint8_t sides = 0;  // 1 or 2
   fdc_track track[kMaxTracks][kMaxSides];
 
   // Flux backend (Stage 3): when scp != nullptr it replaces the DSK image. The
-  // track under the head is decoded on demand into a per-revolution cache; the
-  // serving revolution follows the platter (docs flux-media.md §7).
+  // track under the head is decoded on demand into the shared flux cache
+  // (fdc_state::fc); the serving revolution follows the platter (docs
+  // flux-media.md §7).
   const uint8_t* scp = nullptr;  // caller-owned SCP dump
   size_t scp_len = 0;
-  uint8_t scp_revs = 0;      // revolutions captured in the file
-  uint8_t cache_cyl = 0xFF;  // cylinder currently cached (0xFF = none)
-  uint8_t cache_revs = 1;    // revolutions represented in the cache (1..2)
-  fdc_track cache_trk[kFluxRevs];
-  uint8_t cache_pay[kFluxRevs][kFluxPayload];
+  uint8_t scp_revs = 0;   // revolutions captured in the file
+  uint8_t scp_heads = 1;  // sides captured in the file (1..2)
+  FdcFluxSourceFn flux_src = nullptr;  // pre-decoded tracks (§7a), if any
+  void* flux_src_ctx = nullptr;
 
   // Hybrid writable-flux state (Stage 2). backing == FDC_BACKING_FLUX marks a
   // flux medium; a written track flips track_dirty[t] and serves `image` (the
@@ -122,6 +124,25 @@ struct fdc_media {
 
 bool flux_backed(const fdc_media* m) { return m->scp != nullptr; }
 
+// Record a write to (t, head) for the host's write-back, and flag the image.
+void mark_written(fdc_media* m, uint8_t t, uint8_t head) {
+  m->dirty = true;
+  if (t < kMaxTracks)
+    m->track_written[t] |= static_cast<uint8_t>(1u << (m->sides > 1 ? head & 1
+                                                                     : 0));
+}
+
+// One decoded flux track: the sector map and payload of (drive, cylinder,
+// head, revolution). unit == kFreeSlot marks an empty slot.
+constexpr uint8_t kFreeSlot = 0xFF;
+struct flux_slot {
+  uint8_t unit = kFreeSlot;
+  uint8_t cyl = 0, head = 0, rev = 0;
+  uint32_t stamp = 0;  // fc_clock at the last lookup
+  fdc_track trk;
+  uint8_t pay[kFluxPayload];
+};
+
 // Does cylinder `t` read from the rotating flux cache (vs the DSK `image`)? A
 // flux medium serves the cache for every track that has NOT been written; a
 // written (dirty) track — and any sector-backed medium — serves `image`. This
@@ -180,7 +201,18 @@ struct fdc_state {
   uint8_t fmt_pos = 0;                     // bytes of fmt_ids received
 
   fdc_media media;   // live wiring — everything from here on is NOT serialized
-  fdc_media media1;  // drive B (unit 1) image; attach-wired, not yet read (§6)
+  fdc_media media1;  // drive B (unit 1) medium
+
+  // The flux cache (flux-media.md §7b): decoded tracks of both drives' flux
+  // media, LRU by `stamp`. `fc_ext` (fdc_set_flux_cache) replaces the
+  // built-in slots when set. `fc_serve` is the slot the in-flight flux
+  // transfer reads its bytes from.
+  flux_slot fc_builtin[FDC_FLUX_BUILTIN_SLOTS];
+  flux_slot* fc_ext = nullptr;
+  uint32_t fc_count = FDC_FLUX_BUILTIN_SLOTS;
+  uint32_t fc_clock = 0;  // LRU clock: bumped on every lookup
+  uint32_t fc_fills = 0;  // misses since attach of the cache
+  uint32_t fc_serve = 0;
 
   // Mechanical event ring (fdc.h): live telemetry for the audio bridge.
   // Sits AFTER `media`, outside the kSaveBytes prefix. Drop-oldest overflow.
@@ -203,10 +235,9 @@ void push_event(fdc_state* f, uint8_t type, uint8_t arg) {
 
 // ---------------------------------------------------------------- helpers ---
 
-// The DSK medium behind the addressed unit: 0 = drive A (media), 1 = drive B
-// (media1). The µPD765A drives two units and the CPC wires both; flux capture
-// stays drive-A-only (fdc_attach_flux only ever fills `media`, so media1 is
-// never flux_backed — the flux branches below are unreachable for unit 1).
+// The medium behind the addressed unit: 0 = drive A (media), 1 = drive B
+// (media1). The µPD765A drives two units and the CPC wires both; either may
+// hold a DSK image or a flux dump.
 fdc_media* sel_media(fdc_state* f, uint8_t unit) {
   return (unit & 1) ? &f->media1 : &f->media;
 }
@@ -225,52 +256,104 @@ bool drive_ready(const fdc_state* f, uint8_t unit) {
   return disc_in && f->motor_st == M_READY;
 }
 
-// Decode the cylinder under the head into the per-revolution cache (flux
-// backend). Called lazily whenever the map is needed; a no-op when the cache
-// already holds this cylinder. Decode errors leave an unformatted track.
-void ensure_flux_cache(fdc_state* f) {
-  fdc_media* m = &f->media;
-  const uint8_t cyl = f->track_pos[0];
-  if (m->cache_cyl == cyl) return;
-  m->cache_revs = (m->scp_revs >= kFluxRevs) ? kFluxRevs : 1;
-  for (uint8_t r = 0; r < m->cache_revs; ++r) {
-    fdc_track* trk = &m->cache_trk[r];
-    *trk = fdc_track{};
-    FluxTrack ft;
-    if (flux_decode_track_rev(m->scp, m->scp_len, cyl, r, &ft, m->cache_pay[r],
-                              kFluxPayload) != 0)
-      continue;  // unreadable: nothing under the head this revolution
-    trk->sectors =
-        static_cast<uint8_t>(ft.count < kMaxSectors ? ft.count : kMaxSectors);
-    trk->data_off = 0;  // offsets are relative to the payload
-    trk->data_len = ft.payload_used;
-    for (int i = 0; i < trk->sectors; ++i) {
-      const FluxSector* fs = &ft.sec[i];
-      fdc_sector* sec = &trk->sec[i];
-      std::memcpy(sec->chrn, fs->chrn, 4);
-      sec->st1 = fs->st1;
-      sec->st2 = fs->st2;
-      sec->off = fs->off;
-      sec->stored = fs->len;
-      sec->idam_at = fs->idam_cell;  // angles measured from the real bitstream
-      sec->data_at = fs->data_cell;
+// ------------------------------------------------------------ flux cache ---
+
+flux_slot* flux_slots(fdc_state* f) {
+  return f->fc_ext != nullptr ? f->fc_ext : f->fc_builtin;
+}
+
+// Drop every cached track of `unit` (its medium changed).
+void flux_forget(fdc_state* f, uint8_t unit) {
+  flux_slot* sl = flux_slots(f);
+  for (uint32_t i = 0; i < f->fc_count; ++i)
+    if (sl[i].unit == unit) sl[i].unit = kFreeSlot;
+}
+
+// Fill slot `s` with (cyl, head, rev) of `m`: copied from the pre-decode
+// source when it has the track, else decoded here. Decode errors leave an
+// unformatted track.
+void flux_fill(fdc_media* m, flux_slot* s) {
+  s->trk = fdc_track{};
+  FluxTrack ft;
+  const FluxTrack* pre = nullptr;
+  const uint8_t* pre_pay = nullptr;
+  if (m->flux_src != nullptr &&
+      m->flux_src(m->flux_src_ctx, s->cyl, s->head, s->rev, &pre, &pre_pay) !=
+          0 &&
+      pre->payload_used <= kFluxPayload) {
+    ft = *pre;
+    std::memcpy(s->pay, pre_pay, pre->payload_used);
+  } else if (flux_decode_track(m->scp, m->scp_len, s->cyl, s->head, s->rev,
+                               &ft, s->pay, kFluxPayload) != 0) {
+    return;  // unreadable: nothing under the head this revolution
+  }
+  fdc_track* trk = &s->trk;
+  trk->sectors =
+      static_cast<uint8_t>(ft.count < kMaxSectors ? ft.count : kMaxSectors);
+  trk->data_off = 0;  // offsets are relative to the payload
+  trk->data_len = ft.payload_used;
+  for (int i = 0; i < trk->sectors; ++i) {
+    const FluxSector* fs = &ft.sec[i];
+    fdc_sector* sec = &trk->sec[i];
+    std::memcpy(sec->chrn, fs->chrn, 4);
+    sec->st1 = fs->st1;
+    sec->st2 = fs->st2;
+    sec->off = fs->off;
+    sec->stored = fs->len;
+    sec->idam_at = fs->idam_cell;  // angles measured from the real bitstream
+    sec->data_at = fs->data_cell;
+  }
+}
+
+// The cache slot holding (unit, cyl, head, rev), filled on a miss into a
+// free slot or the least recently used one. The most recently used slot is
+// never the victim (fc_count ≥ 2), so a track just looked up stays valid
+// across the next lookup.
+uint32_t flux_lookup(fdc_state* f, uint8_t unit, uint8_t cyl, uint8_t head,
+                     uint8_t rev) {
+  flux_slot* sl = flux_slots(f);
+  const uint32_t now = ++f->fc_clock;
+  uint32_t victim = 0;
+  for (uint32_t i = 0; i < f->fc_count; ++i) {
+    flux_slot* s = &sl[i];
+    if (s->unit == unit && s->cyl == cyl && s->head == head && s->rev == rev) {
+      s->stamp = now;
+      return i;
     }
+    // Prefer a free slot, else the one unused the longest.
+    if (sl[victim].unit == kFreeSlot) continue;
+    if (s->unit == kFreeSlot || now - s->stamp > now - sl[victim].stamp)
+      victim = i;
   }
-  m->cache_cyl = cyl;
+  flux_slot* s = &sl[victim];
+  s->unit = unit;
+  s->cyl = cyl;
+  s->head = head;
+  s->rev = rev;
+  s->stamp = now;
+  flux_fill(sel_media(f, unit), s);
+  f->fc_fills++;
+  return victim;
+}
+
+// The side of a flux medium a head reads: single-sided dumps ignore HD, like
+// single-sided DSK images.
+uint8_t flux_side(const fdc_media* m, uint8_t head) {
+  return m->scp_heads > 1 ? (head & 1) : 0;
 }
 
-// The cached revolution passing the head right now (flux backend).
-uint8_t passing_rev(const fdc_state* f) {
-  return static_cast<uint8_t>(f->rev_count % f->media.cache_revs);
+// The captured revolution passing the head right now (flux backend): every
+// capture takes its turn — the platter keeps turning, the captures repeat.
+uint8_t passing_rev(const fdc_state* f, const fdc_media* m) {
+  return static_cast<uint8_t>(f->rev_count % m->scp_revs);
 }
 
 // The revolution that will be passing when byte cell `cell` next arrives
 // (crossing the index hole advances the capture — the platter keeps turning).
-uint8_t rev_at_cell(const fdc_state* f, uint16_t cell) {
+uint8_t rev_at_cell(const fdc_state* f, const fdc_media* m, uint16_t cell) {
   const uint32_t target = static_cast<uint32_t>(cell) * kByteCycles;
-  uint8_t rev = passing_rev(f);
-  if (target <= f->rot)
-    rev = static_cast<uint8_t>((rev + 1) % f->media.cache_revs);
+  uint8_t rev = passing_rev(f, m);
+  if (target <= f->rot) rev = static_cast<uint8_t>((rev + 1) % m->scp_revs);
   return rev;
 }
 
@@ -301,16 +384,16 @@ uint8_t next_idam_index(const fdc_state* f, const fdc_track* trk) {
 
 // The track under the head of the addressed unit, or nullptr if the head sits
 // past the image / the track is unformatted. Single-sided images ignore HD.
-// Flux backend: the on-demand cache of the currently-passing revolution.
+// Flux backend: the cached decode of the currently-passing revolution.
 fdc_track* head_track(fdc_state* f, uint8_t unit, uint8_t head) {
   if (unit > 1) return nullptr;
   fdc_media* m = sel_media(f, unit);
   const uint8_t t = f->track_pos[unit];
-  if (serve_from_flux(m,
-                      t)) {  // drive-A-only: media1 is never flux (sel_media)
+  if (serve_from_flux(m, t)) {
     if (t >= m->tracks) return nullptr;
-    ensure_flux_cache(f);
-    fdc_track* trk = &m->cache_trk[passing_rev(f)];
+    fdc_track* trk = &flux_slots(f)[flux_lookup(f, unit, t, flux_side(m, head),
+                                                passing_rev(f, m))]
+                          .trk;
     return trk->sectors ? trk : nullptr;
   }
   if (m->image == nullptr) return nullptr;
@@ -450,13 +533,21 @@ void start_sector(fdc_state* f, fdc_track* trk, bool to_cpu) {
     // Serve the revolution that will be passing when the data field arrives —
     // the physical substrate of weak/fuzzy protection bits (flux-media.md §7):
     // re-reads land on different captures and return their differing bytes,
-    // with each capture's own CRC status.
-    f->serve_rev = rev_at_cell(f, sec->data_at);
-    fdc_track* strk = &f->media.cache_trk[f->serve_rev];
+    // with each capture's own CRC status. `trk` is the passing revolution's
+    // slot head_track just looked up: touching it again first keeps it the
+    // most recently used, so the serving lookup cannot evict it.
+    const fdc_media* sm = sel_media(f, sunit);
+    const uint8_t side = flux_side(sm, (f->cmd[C_UNIT] >> 2) & 1);
+    const uint8_t t = f->track_pos[sunit];
+    f->fc_serve = flux_lookup(f, sunit, t, side, passing_rev(f, sm));
+    f->serve_rev = rev_at_cell(f, sm, sec->data_at);
+    const uint32_t si = flux_lookup(f, sunit, t, side, f->serve_rev);
+    fdc_track* strk = &flux_slots(f)[si].trk;
     for (int i = 0; i < strk->sectors; ++i) {
       if (std::memcmp(strk->sec[i].chrn, sec->chrn, 4) == 0) {
         sec = &strk->sec[i];  // this revolution's copy: payload + status
         trk = strk;
+        f->fc_serve = si;
         break;
       }  // absent on that capture: fall back to the scanned revolution's copy
     }
@@ -540,19 +631,29 @@ void do_format(fdc_state* f) {
   const uint8_t* saved_scp = m->scp;
   const size_t saved_scp_len = m->scp_len;
   const uint8_t saved_scp_revs = m->scp_revs;
+  const uint8_t saved_scp_heads = m->scp_heads;
+  const FdcFluxSourceFn saved_src = m->flux_src;
+  void* const saved_src_ctx = m->flux_src_ctx;
   bool saved_dirty[kMaxTracks];
   std::memcpy(saved_dirty, m->track_dirty, sizeof(saved_dirty));
+  uint8_t saved_written[kMaxTracks];
+  std::memcpy(saved_written, m->track_written, sizeof(saved_written));
   parse_dsk(m, image, len);  // rebuild every window and angle
+  std::memcpy(m->track_written, saved_written, sizeof(saved_written));
   if (backing == FDC_BACKING_FLUX) {
+    // The cached flux tracks stay valid: the SCP did not change, and the
+    // formatted track serves the overlay from now on.
     m->backing = backing;
     m->scp = saved_scp;
     m->scp_len = saved_scp_len;
     m->scp_revs = saved_scp_revs;
-    m->cache_cyl = 0xFF;  // force a re-decode if a clean track is read again
+    m->scp_heads = saved_scp_heads;
+    m->flux_src = saved_src;
+    m->flux_src_ctx = saved_src_ctx;
     std::memcpy(m->track_dirty, saved_dirty, sizeof(saved_dirty));
     if (t < kMaxTracks) m->track_dirty[t] = true;
   }
-  m->dirty = true;
+  mark_written(m, t, head);
   f->sector_idx = 0;
   f->res[R_ST0] = f->cmd[C_UNIT] & 7;  // normal termination
   f->res[R_C] = f->track_pos[unit];
@@ -885,10 +986,12 @@ void exec_write_byte(fdc_state* f, uint8_t val) {
     return;
   }
   // WRITE DATA / WRITE DELETED: one byte onto the addressed unit's medium.
-  fdc_media* wm = sel_media(f, f->cmd[C_UNIT] & 1);
+  const uint8_t wunit = f->cmd[C_UNIT] & 1;
+  const uint8_t whead = (f->cmd[C_UNIT] >> 2) & 1;
+  fdc_media* wm = sel_media(f, wunit);
   if (wm->image != nullptr && f->data_pos < wm->len) {
     wm->image[f->data_pos] = val;
-    wm->dirty = true;
+    mark_written(wm, f->track_pos[wunit], whead);
   }
   if (++f->data_pos >= f->trk_end) f->data_pos = f->trk_begin;  // track wrap
   f->next_byte_at += kByteCycles;
@@ -903,7 +1006,7 @@ void exec_write_byte(fdc_state* f, uint8_t val) {
         trk->sec[f->sector_idx - 1].st2 |= 0x40;
       if (f->wr_st2_off != 0 && f->wr_st2_off < wm->len) {
         wm->image[f->wr_st2_off] |= 0x40;
-        wm->dirty = true;
+        mark_written(wm, f->track_pos[wunit], whead);
       }
     }
     if (f->cmd[C_R] != f->cmd[C_EOT]) {
@@ -957,9 +1060,9 @@ uint8_t data_read(fdc_state* f) {
       // One byte of the current sector; overruns past the stored data wrap
       // inside the track's data block (docs §4, the legacy behaviour).
       uint8_t val = 0xFF;
-      if (f->from_flux) {  // the passing revolution's payload cache (drive A)
-        const uint8_t* pay = f->media.cache_pay[f->serve_rev % kFluxRevs];
-        if (f->data_pos < kFluxPayload) val = pay[f->data_pos];
+      if (f->from_flux) {  // the serving revolution's cached payload
+        if (f->fc_serve < f->fc_count && f->data_pos < kFluxPayload)
+          val = flux_slots(f)[f->fc_serve].pay[f->data_pos];
       } else {  // DSK image of the addressed unit (drive A or B)
         const fdc_media* m = sel_media(f, f->cmd[C_UNIT] & 1);
         if (m->image && f->data_pos < m->len) val = m->image[f->data_pos];
@@ -1252,6 +1355,8 @@ void fdc_peek(const Device* dev, FdcRegs* out) {
   out->st2 = f->st_latch[2];
   out->sectors_read = f->sectors_read;
   out->ready = drive_ready(f, 0) ? 1 : 0;
+  out->flux_slots = f->fc_count;
+  out->flux_fills = f->fc_fills;
 }
 
 void fdc_poke_mechanics(const Device* dev, uint8_t motor, uint8_t track_a,
@@ -1267,6 +1372,7 @@ int fdc_attach_disk(const Device* dev, uint8_t* dsk, size_t len, uint8_t unit) {
   const uint8_t u = unit ? 1 : 0;
   fdc_media* m = u ? &f->media1 : &f->media;
   const bool ok = parse_dsk(m, dsk, len);
+  flux_forget(f, u);
   f->sector_idx = 0;
   f->status_changed[u] = true;  // the disc (and the ready line) changed
   return ok ? 0 : -1;
@@ -1284,31 +1390,49 @@ int fdc_media_dirty_unit(const Device* dev, uint8_t unit) {
 }
 
 void fdc_media_mark_clean(const Device* dev) {
-  static_cast<fdc_state*>(dev->self)->media.dirty = false;
+  fdc_media_mark_clean_unit(dev, 0);
 }
 
 void fdc_media_mark_clean_unit(const Device* dev, uint8_t unit) {
   fdc_state* f = static_cast<fdc_state*>(dev->self);
-  (unit ? f->media1 : f->media).dirty = false;
+  fdc_media* m = sel_media(f, unit ? 1 : 0);
+  m->dirty = false;
+  std::memset(m->track_written, 0, sizeof(m->track_written));
+}
+
+const uint8_t* fdc_media_written_tracks(const Device* dev, int& ntracks_out,
+                                        uint8_t unit) {
+  const fdc_state* f = static_cast<const fdc_state*>(dev->self);
+  const fdc_media* m = sel_media(f, unit ? 1 : 0);
+  if (m->image == nullptr) {
+    ntracks_out = 0;
+    return nullptr;
+  }
+  ntracks_out = m->tracks;
+  return m->track_written;
 }
 
-const bool* fdc_media_track_dirty(const Device* dev, int& ntracks_out) {
+const bool* fdc_media_track_dirty(const Device* dev, int& ntracks_out,
+                                  uint8_t unit) {
   const fdc_state* f = static_cast<const fdc_state*>(dev->self);
+  const fdc_media* m = sel_media(f, unit);
   // Only a WRITABLE flux medium (flux backing + a DSK overlay to serve written
   // tracks from) has an exportable dirty map; a read-only dump has nothing to
   // export per-track, so it reports none.
-  if (f->media.backing != FDC_BACKING_FLUX || f->media.image == nullptr) {
+  if (m->backing != FDC_BACKING_FLUX || m->image == nullptr) {
     ntracks_out = 0;
     return nullptr;
   }
-  ntracks_out = f->media.tracks;
-  return f->media.track_dirty;
+  ntracks_out = m->tracks;
+  return m->track_dirty;
 }
 
-const uint8_t* fdc_media_flux_scp(const Device* dev, size_t& len_out) {
+const uint8_t* fdc_media_flux_scp(const Device* dev, size_t& len_out,
+                                  uint8_t unit) {
   const fdc_state* f = static_cast<const fdc_state*>(dev->self);
-  len_out = f->media.scp_len;
-  return f->media.scp;
+  const fdc_media* m = sel_media(f, unit);
+  len_out = m->scp_len;
+  return m->scp;
 }
 
 const uint8_t* fdc_media_image(const Device* dev, size_t& len_out) {
@@ -1325,31 +1449,39 @@ const uint8_t* fdc_media_image_unit(const Device* dev, uint8_t unit,
   return m->image;
 }
 
-int fdc_attach_flux(const Device* dev, const uint8_t* scp, size_t len) {
+int fdc_attach_flux(const Device* dev, const uint8_t* scp, size_t len,
+                    uint8_t unit) {
   fdc_state* f = static_cast<fdc_state*>(dev->self);
+  const uint8_t u = unit ? 1 : 0;
   const int cyls = flux_scp_cylinders(scp, len);
   const int revs = flux_scp_revolutions(scp, len);
   if (cyls <= 0 || revs <= 0) return -1;
-  f->media = fdc_media{};               // replaces any DSK attachment
-  f->media.backing = FDC_BACKING_FLUX;  // read-only: no `image` overlay
-  f->media.scp = scp;
-  f->media.scp_len = len;
-  f->media.scp_revs = static_cast<uint8_t>(revs < 255 ? revs : 255);
-  f->media.tracks = static_cast<uint8_t>(cyls < kMaxTracks ? cyls : kMaxTracks);
-  f->media.sides = 1;  // side 0 (flux-media.md §5)
+  fdc_media* m = sel_media(f, u);
+  *m = fdc_media{};               // replaces any DSK attachment
+  m->backing = FDC_BACKING_FLUX;  // read-only: no `image` overlay
+  m->scp = scp;
+  m->scp_len = len;
+  m->scp_revs = static_cast<uint8_t>(revs < 255 ? revs : 255);
+  m->scp_heads = static_cast<uint8_t>(flux_scp_heads(scp, len));
+  m->tracks = static_cast<uint8_t>(cyls < kMaxTracks ? cyls : kMaxTracks);
+  m->sides = m->scp_heads;
+  flux_forget(f, u);
   f->sector_idx = 0;
-  f->status_changed[0] = true;  // the disc (and the ready line) changed
+  f->status_changed[u] = true;  // the disc (and the ready line) changed
   return 0;
 }
 
 int fdc_attach_flux_writable(const Device* dev, const uint8_t* scp,
-                             size_t scp_len, uint8_t* dsk, size_t dsk_len) {
+                             size_t scp_len, uint8_t* dsk, size_t dsk_len,
+                             uint8_t unit) {
   fdc_state* f = static_cast<fdc_state*>(dev->self);
+  const uint8_t u = unit ? 1 : 0;
   const int revs = flux_scp_revolutions(scp, scp_len);
+  const int heads = flux_scp_heads(scp, scp_len);
   // Parse the mutable DSK overlay in place (WRITE DATA / FORMAT edit it), then
   // overlay the flux backing parse_dsk cleared. scp stays const — the pristine
   // source for verbatim export of unwritten tracks.
-  fdc_media* m = &f->media;
+  fdc_media* m = sel_media(f, u);
   if (!parse_dsk(m, dsk, dsk_len)) return -1;
   m->backing =
       FDC_BACKING_FLUX;  // hybrid: overlay present, clean tracks = flux
@@ -1357,16 +1489,54 @@ int fdc_attach_flux_writable(const Device* dev, const uint8_t* scp,
   m->scp_len = scp_len;
   const int rev_count = revs > 0 ? revs : 1;  // ≥1 revolution; a flux dump has
   m->scp_revs = static_cast<uint8_t>(rev_count < 255 ? rev_count : 255);
+  m->scp_heads = static_cast<uint8_t>(heads > 1 ? 2 : 1);
   // track_dirty stays all-false: every track starts clean (serves the cache).
+  flux_forget(f, u);
   f->sector_idx = 0;
-  f->status_changed[0] = true;  // the disc (and the ready line) changed
+  f->status_changed[u] = true;  // the disc (and the ready line) changed
   return 0;
 }
 
+void fdc_set_flux_source(const Device* dev, FdcFluxSourceFn fn, void* ctx,
+                         uint8_t unit) {
+  fdc_state* f = static_cast<fdc_state*>(dev->self);
+  fdc_media* m = sel_media(f, unit ? 1 : 0);
+  m->flux_src = fn;
+  m->flux_src_ctx = ctx;
+}
+
+size_t fdc_flux_slot_size(void) { return sizeof(flux_slot); }
+
+void fdc_set_flux_cache(const Device* dev, void* storage, size_t bytes) {
+  fdc_state* f = static_cast<fdc_state*>(dev->self);
+  // Carve whole, aligned slots out of the caller's bytes.
+  const uintptr_t raw = reinterpret_cast<uintptr_t>(storage);
+  const uintptr_t base =
+      (raw + alignof(flux_slot) - 1) & ~uintptr_t{alignof(flux_slot) - 1};
+  const size_t skew = static_cast<size_t>(base - raw);
+  const size_t count =
+      storage != nullptr && bytes > skew ? (bytes - skew) / sizeof(flux_slot)
+                                         : 0;
+  if (count >= 2) {
+    f->fc_ext = reinterpret_cast<flux_slot*>(base);
+    f->fc_count = static_cast<uint32_t>(
+        count < UINT32_MAX ? count : static_cast<size_t>(UINT32_MAX));
+    for (uint32_t i = 0; i < f->fc_count; ++i) new (&f->fc_ext[i]) flux_slot;
+  } else {
+    f->fc_ext = nullptr;
+    f->fc_count = FDC_FLUX_BUILTIN_SLOTS;
+    for (flux_slot& sl : f->fc_builtin) sl.unit = kFreeSlot;
+  }
+  f->fc_clock = 0;
+  f->fc_fills = 0;
+  f->fc_serve = 0;
+}
+
 void fdc_eject_disk(const Device* dev, uint8_t unit) {
   fdc_state* f = static_cast<fdc_state*>(dev->self);
   const uint8_t u = unit ? 1 : 0;
   (u ? f->media1 : f->media) = fdc_media{};
+  flux_forget(f, u);
   f->sector_idx = 0;
   f->status_changed[u] = true;
 }
@@ -36,6 +36,8 @@ typedef struct FdcRegs {
   uint8_t track[2]; /* physical head position per unit */
   uint8_t st0, st1, st2; /* status bytes of the last completed operation */
   uint32_t sectors_read; /* sectors fully delivered by READ DATA since reset */
+  uint32_t flux_slots;   /* decoded-track slots in the flux cache */
+  uint32_t flux_fills;   /* flux cache misses: tracks decoded or copied in */
 } FdcRegs;
 
 /* --- Mechanical event ring (drive sounds / telemetry) ---
@@ -96,6 +98,15 @@ int fdc_media_dirty_unit(const Device* dev, uint8_t unit);
 void fdc_media_mark_clean(const Device* dev);
 void fdc_media_mark_clean_unit(const Device* dev, uint8_t unit);
 
+/* The write-back map of a drive's DSK image (the overlay, for a writable flux
+ * medium): entry c has bit s set when WRITE DATA / FORMAT wrote side s of
+ * cylinder c since attach or the last mark_clean, so the host can persist
+ * just those tracks. Single-sided images only use bit 0. Unlike
+ * fdc_media_track_dirty (which tracks stay promoted to the overlay), mark_clean
+ * clears it. nullptr with no writable image; `ntracks_out` = cylinders. */
+const uint8_t* fdc_media_written_tracks(const Device* dev, int& ntracks_out,
+                                        uint8_t unit = 0);
+
 /* How the medium behind a drive is backed (fdc_media.backing). SECTOR = a plain
  * DSK image; FLUX = a flux dump. A flux medium may still carry a writable DSK
  * overlay (fdc_attach_flux_writable): clean tracks serve the rotating flux
@@ -103,17 +114,19 @@ void fdc_media_mark_clean_unit(const Device* dev, uint8_t unit);
  */
 enum FdcBacking : uint8_t { FDC_BACKING_SECTOR = 0, FDC_BACKING_FLUX = 1 };
 
-/* Attach a caller-owned SCP flux dump as drive A's medium (Stage 3). The FDC
- * decodes the track under the head on demand — one captured revolution at a
- * time — and serves whichever revolution is physically passing the head, so
+/* Attach a caller-owned SCP flux dump as a drive's medium (Stage 3); `unit`
+ * as in fdc_attach_disk. The FDC decodes the track under the head on demand —
+ * one captured revolution of one side at a time, into the flux cache below —
+ * and serves whichever revolution is physically passing the head, so
  * weak/fuzzy protection bits emerge from capture differences with no special
- * casing. Live wiring like fdc_attach_disk (replaces any attached DSK).
- * READ-ONLY: with no DSK overlay the medium has image == nullptr, so WRITE DATA
- * / FORMAT terminate Not-Writable. Returns 0, or -1 if the buffer is not a
- * usable SCP. */
-int fdc_attach_flux(const Device* dev, const uint8_t* scp, size_t len);
+ * casing. A double-sided dump answers both heads. Live wiring like
+ * fdc_attach_disk (replaces any attached DSK). READ-ONLY: with no DSK overlay
+ * the medium has image == nullptr, so WRITE DATA / FORMAT terminate
+ * Not-Writable. Returns 0, or -1 if the buffer is not a usable SCP. */
+int fdc_attach_flux(const Device* dev, const uint8_t* scp, size_t len,
+                    uint8_t unit = 0);
 
-/* Attach a WRITABLE flux medium to drive A (Stage 2): the pristine `scp` stays
+/* Attach a WRITABLE flux medium to a drive (Stage 2): the pristine `scp` stays
  * the verbatim source for unwritten tracks, while `dsk` — a standard/extended
  * DSK the caller synthesized from that same SCP (flux_scp_to_dsk) — is the
  * mutable overlay. A clean (unwritten) track keeps serving the rotating flux
@@ -122,18 +135,53 @@ int fdc_attach_flux(const Device* dev, const uint8_t* scp, size_t len);
  * real drive replaces a track's flux fuzz with fresh MFM when it writes. Both
  * buffers are caller-owned and must outlive the attachment. `dsk` is MUTABLE —
  * writes/FORMAT edit it in place (like fdc_attach_disk); `scp` stays const, the
- * pristine source. Returns 0, or -1 if the DSK overlay is malformed (nothing
- * attached). */
+ * pristine source. A written cylinder serves the overlay on both heads, so a
+ * double-sided dump needs a double-sided overlay (flux_scp_to_dsk makes one).
+ * Returns 0, or -1 if the DSK overlay is malformed (nothing attached). */
 int fdc_attach_flux_writable(const Device* dev, const uint8_t* scp,
-                             size_t scp_len, uint8_t* dsk, size_t dsk_len);
-
-/* Export introspection for a writable flux medium on drive A (Stage 4 save-as
- * feeds these to scp_from_disk). `fdc_media_track_dirty` returns the per-track
- * dirty map and fills `ntracks_out`; `fdc_media_flux_scp` / `fdc_media_image`
- * return the pristine SCP and the mutable DSK overlay with their lengths. Any
- * pointer is nullptr when the medium does not carry that backing. */
-const bool* fdc_media_track_dirty(const Device* dev, int& ntracks_out);
-const uint8_t* fdc_media_flux_scp(const Device* dev, size_t& len_out);
+                             size_t scp_len, uint8_t* dsk, size_t dsk_len,
+                             uint8_t unit = 0);
+
+/* Pre-decoded flux tracks (flux-media.md §7a). A source answers "is cylinder
+ * `cyl`, side `head`, revolution `rev` already decoded?" with 1 plus the
+ * decoded track and its payload (exactly what flux_decode_track would have
+ * produced), or 0 when it is not ready yet. The FDC asks on every cache miss
+ * and decodes lazily itself on a 0, so the source may fill in any order from
+ * any thread as long as a track it reported stays valid and unchanged. */
+struct FluxTrack;
+typedef int (*FdcFluxSourceFn)(void* ctx, uint8_t cyl, uint8_t head,
+                               uint8_t rev, const struct FluxTrack** track,
+                               const uint8_t** payload);
+
+/* Serve a drive's flux medium from `fn` (nullptr = lazy decode only). Live
+ * wiring: cleared by the next attach or eject on that drive, never
+ * serialized. `ctx` must outlive the attachment or the next call. */
+void fdc_set_flux_source(const Device* dev, FdcFluxSourceFn fn, void* ctx,
+                         uint8_t unit = 0);
+
+/* The flux cache (flux-media.md §7b): decoded (drive, cylinder, head,
+ * revolution) tracks shared by both drives, least-recently-used out. A
+ * track stays decoded while it fits, so every captured revolution rotates
+ * under the head without being decoded again. The FDC carries a small
+ * built-in cache (FDC_FLUX_BUILTIN_SLOTS tracks); hand it a caller-owned
+ * buffer to set the memory budget — `bytes` / fdc_flux_slot_size() tracks,
+ * at least two. nullptr (or a buffer too small for two) returns to the
+ * built-in cache. Either way the cache starts empty. Live wiring: the buffer
+ * must outlive the attachment or the next call; never serialized. */
+enum : std::uint8_t { FDC_FLUX_BUILTIN_SLOTS = 8 };
+size_t fdc_flux_slot_size(void);
+void fdc_set_flux_cache(const Device* dev, void* storage, size_t bytes);
+
+/* Export introspection for a writable flux medium (Stage 4 save-as
+ * feeds these to scp_from_disk). `fdc_media_track_dirty` returns the per-
+ * cylinder dirty map and fills `ntracks_out`; `fdc_media_flux_scp` /
+ * `fdc_media_image` return the pristine SCP and the mutable DSK overlay with
+ * their lengths. Any pointer is nullptr when the medium does not carry that
+ * backing. The flux accessors take the drive (drive B may hold flux too). */
+const bool* fdc_media_track_dirty(const Device* dev, int& ntracks_out,
+                                  uint8_t unit = 0);
+const uint8_t* fdc_media_flux_scp(const Device* dev, size_t& len_out,
+                                  uint8_t unit = 0);
 const uint8_t* fdc_media_image(const Device* dev, size_t& len_out);
 
 /* Unit-aware DSK/overlay image accessor (unit 0 = A, 1 = B); fdc_media_image is
@@ -40,20 +40,152 @@ uint32_t rd16be(const uint8_t* p) {  // big-endian (the flux words)
 // ------------------------------------------------------- PLL → bitcells -----
 
 struct BitBuf {
-  uint8_t bits[kMaxBits / 8];  // packed, MSB-first
-  size_t n;                    // bitcells decoded so far
+  uint8_t bits[(kMaxBits / 8) + 2];  // packed, MSB-first; +2: load16 slack
+  size_t n;                          // bitcells decoded so far
 };
 
 int bit_at(const BitBuf* bb, size_t i) {
   return (bb->bits[i >> 3] >> (7 - (i & 7))) & 1;
 }
 
+// The PLL runs in Q16 fixed point: cell and clock widths are in 1/65536
+// ticks, so the serial per-interval recurrence is integer multiplies and
+// compares with no division on the common path (docs §2, "fixed point").
+constexpr int kQ = 16;
+constexpr int64_t kOne = int64_t{1} << kQ;
+
+int64_t nominal_q(const uint8_t* scp) {  // 80 ticks / (resolution + 1)
+  return (80 * kOne) / (static_cast<int64_t>(scp[0x0B]) + 1);
+}
+
 // Estimate this revolution's true half-cell width from the interval
-// population itself (docs §2): two reclassification passes of mean(t / n)
-// over the intervals that look like legal MFM (2..4 half-cells), clamped to
+// population itself (docs §2): two reclassification passes of Σt / Σn over
+// the intervals that look like legal MFM (2..4 half-cells), clamped to
 // nominal ±15 %. Spindle-speed error scales every interval, so the mean is a
 // direct speed measurement; zero-mean jitter averages out over a revolution.
-double estimate_cell(const uint8_t* flux, uint32_t words, double nominal) {
+// Branch-free over the raw words so the compiler vectorizes each pass: an
+// overflow word (0) and the word completing an overflow run (≥ 65536 ticks,
+// never a legal interval) are masked out instead of carried.
+//
+// One word of it: `p` points at the word; the previous word is re-read, not
+// carried, so successive words are independent lanes.
+inline void cell_sample(const uint8_t* p, uint32_t inv, uint32_t half, int sh,
+                        uint32_t* st, uint32_t* sn) {
+  const uint32_t w = (static_cast<uint32_t>(p[0]) << 8) | p[1];
+  const uint32_t prev = (static_cast<uint32_t>(p[-2]) << 8) | p[-1];
+  const uint32_t n = ((w * inv) + half) >> sh;
+  const uint32_t legal =
+      0u - static_cast<uint32_t>((w != 0) & (prev != 0) & (n - 2 <= 2));
+  *st += w & legal;
+  *sn += n & legal;
+}
+
+int64_t estimate_cell(const uint8_t* flux, uint32_t words, int64_t nominal) {
+  int64_t cell = nominal;
+  constexpr size_t kLanes = 8;
+  constexpr size_t kBlock = size_t{1} << 14;  // per-lane sums cannot wrap
+  for (int pass = 0; pass < 2; pass++) {
+    // n = round(t / cell) = (t · inv + half) >> sh, all in 32 bits: inv is
+    // the reciprocal scaled as far as a 16-bit word times it still fits.
+    int sh = 31;
+    while (((uint64_t{1} << (sh + kQ)) / static_cast<uint64_t>(cell)) >= 0x10000u)
+      sh--;
+    const uint32_t inv = static_cast<uint32_t>(
+        (uint64_t{1} << (sh + kQ)) / static_cast<uint64_t>(cell));
+    const uint32_t half = 1u << (sh - 1);
+    uint64_t sum_t = 0, sum_n = 0;
+    if (words > 0) {  // word 0: nothing was carried into it
+      const uint32_t w = rd16be(flux);
+      const uint32_t n = ((w * inv) + half) >> sh;
+      if (w != 0 && n - 2 <= 2) {
+        sum_t += w;
+        sum_n += n;
+      }
+    }
+    for (size_t base = 1; base < words; base += kBlock) {
+      const size_t end = std::min<size_t>(words, base + kBlock);
+      uint32_t st[kLanes] = {}, sn[kLanes] = {};  // not reachable via flux
+      size_t i = base;
+      for (; i + kLanes <= end; i += kLanes)  // fixed trip: vectorizes at -O2
+        for (size_t k = 0; k < kLanes; k++)
+          cell_sample(flux + (2 * (i + k)), inv, half, sh, &st[k], &sn[k]);
+      for (; i < end; i++)
+        cell_sample(flux + (2 * i), inv, half, sh, &st[0], &sn[0]);
+      for (size_t k = 0; k < kLanes; k++) {
+        sum_t += st[k];
+        sum_n += sn[k];
+      }
+    }
+    if (sum_n >= 128)  // enough signal
+      cell = static_cast<int64_t>((sum_t << kQ) / sum_n);
+  }
+  return std::clamp(cell, (nominal * 85) / 100, (nominal * 115) / 100);
+}
+
+// 0.02 / n in Q32 for the clock correction (n = 1..31; longer runs divide).
+struct GainTable {
+  int64_t k[32];
+  constexpr GainTable() : k() {
+    for (int n = 1; n < 32; n++) k[n] = ((int64_t{1} << 32) + 25 * n) / (50 * n);
+  }
+};
+constexpr GainTable kGain;
+
+// Decode one revolution's flux words into bb (appending). The software PLL of
+// docs §2: classify against the estimated half-cell by rounding to the
+// nearest whole cell count, then correct the clock by 2 % of the per-cell
+// error, clamped to the estimate ±1.5 %. The tight clamp is what makes
+// worst-case ±10 % per-interval jitter provably classification-safe (a
+// 4-cell interval 10 % short against a 1.5 %-fast clock still reads
+// 3.6 / 1.015 = 3.55 > 3.5). The rounding is exact against the fixed-point
+// clock: a guess from the cell's reciprocal, settled by two-sided compares.
+int pll_decode(const uint8_t* flux, uint32_t words, int64_t nominal,
+               BitBuf* bb) {
+  const int64_t cell = estimate_cell(flux, words, nominal);
+  int64_t clock = cell;
+  const int64_t lo = (cell * 985) / 1000, hi = (cell * 1015) / 1000;
+  const uint64_t inv = (uint64_t{1} << 48) / static_cast<uint64_t>(cell);
+  uint8_t* const bits = bb->bits;
+  size_t nb = bb->n;  // a local: the byte stores below would alias bb->n
+  uint32_t carry = 0;
+  for (uint32_t i = 0; i < words; i++) {
+    const uint32_t w =
+        (static_cast<uint32_t>(flux[2 * i]) << 8) | flux[(2 * i) + 1];
+    if (w == 0) {  // 0x0000 = overflow: 65536 ticks carried into the next word
+      carry += 0x10000u;
+      continue;
+    }
+    const uint64_t t = static_cast<uint64_t>(carry) + w;
+    carry = 0;
+    const int64_t tq = static_cast<int64_t>(t << kQ);
+    // round(t / clock): n with (2n - 1)·clock <= 2t < (2n + 1)·clock. The
+    // guess is within one of it for MFM-sized intervals; gaps divide.
+    int64_t n = (t < (uint64_t{1} << 24))
+                    ? static_cast<int64_t>(((t * inv) + (uint64_t{1} << 31)) >> 32)
+                    : 32;
+    if (n >= 32) n = tq / clock;
+    while ((((2 * n) + 1) * clock) <= 2 * tq) n++;
+    while (n > 1 && (((2 * n) - 1) * clock) > 2 * tq) n--;
+    n = std::max<int64_t>(n, 1);
+    if (nb + static_cast<size_t>(n) > kMaxBits) {
+      bb->n = nb;
+      return FLUX_E_TOO_LONG;
+    }
+    nb += static_cast<size_t>(n) - 1;  // the zeros: buffer is pre-cleared
+    bits[nb >> 3] |= static_cast<uint8_t>(0x80u >> (nb & 7));
+    nb++;
+    const int64_t err = tq - (n * clock);  // this interval's error, Q16
+    clock += (n < 32) ? ((err * kGain.k[n]) + (int64_t{1} << 31)) >> 32
+                      : err / (50 * n);
+    clock = std::clamp(clock, lo, hi);
+  }
+  bb->n = nb;
+  return 0;  // a trailing unterminated overflow run is discarded (docs §1.4)
+}
+
+// The double-precision PLL the fixed-point one replaced, kept verbatim as
+// its oracle (flux_pll_bitcells reference = 1; FluxPll tests).
+double estimate_cell_ref(const uint8_t* flux, uint32_t words, double nominal) {
   double cell = nominal;
   for (int pass = 0; pass < 2; pass++) {
     double sum_t = 0.0;
@@ -61,7 +193,7 @@ double estimate_cell(const uint8_t* flux, uint32_t words, double nominal) {
     uint32_t carry = 0;
     for (uint32_t i = 0; i < words; i++) {
       const uint32_t w = rd16be(flux + (2u * i));
-      if (w == 0) {  // overflow run: not a legal MFM interval anyway
+      if (w == 0) {
         carry += 0x10000u;
         continue;
       }
@@ -73,8 +205,7 @@ double estimate_cell(const uint8_t* flux, uint32_t words, double nominal) {
         sum_n += n;
       }
     }
-    if (sum_n >= 128)
-      cell = sum_t / static_cast<double>(sum_n);  // enough signal
+    if (sum_n >= 128) cell = sum_t / static_cast<double>(sum_n);
   }
   if (cell < nominal * 0.85)
     cell = nominal * 0.85;
@@ -83,22 +214,15 @@ double estimate_cell(const uint8_t* flux, uint32_t words, double nominal) {
   return cell;
 }
 
-// Decode one revolution's flux words into bb (appending). The software PLL of
-// docs §2: classify against the estimated half-cell by rounding to the
-// nearest whole cell count, then correct the clock by 2 % of the per-cell
-// error, clamped to the estimate ±1.5 %. The tight clamp is what makes
-// worst-case ±10 % per-interval jitter provably classification-safe (a
-// 4-cell interval 10 % short against a 1.5 %-fast clock still reads
-// 3.6 / 1.015 = 3.55 > 3.5).
-int pll_decode(const uint8_t* flux, uint32_t words, double nominal,
-               BitBuf* bb) {
-  const double cell = estimate_cell(flux, words, nominal);
+int pll_decode_ref(const uint8_t* flux, uint32_t words, double nominal,
+                   BitBuf* bb) {
+  const double cell = estimate_cell_ref(flux, words, nominal);
   double clock = cell;
   const double lo = cell * 0.985, hi = cell * 1.015;
   uint32_t carry = 0;
   for (uint32_t i = 0; i < words; i++) {
     const uint32_t w = rd16be(flux + (2u * i));
-    if (w == 0) {  // 0x0000 = overflow: 65536 ticks carried into the next word
+    if (w == 0) {
       carry += 0x10000u;
       continue;
     }
@@ -107,7 +231,7 @@ int pll_decode(const uint8_t* flux, uint32_t words, double nominal,
     long n = static_cast<long>((t / clock) + 0.5);
     n = std::max<long>(n, 1);
     if (bb->n + static_cast<size_t>(n) > kMaxBits) return FLUX_E_TOO_LONG;
-    bb->n += static_cast<size_t>(n) - 1;  // the zeros: buffer is pre-cleared
+    bb->n += static_cast<size_t>(n) - 1;
     bb->bits[bb->n >> 3] |= static_cast<uint8_t>(0x80u >> (bb->n & 7));
     bb->n++;
     clock += ((t - (static_cast<double>(n) * clock)) / static_cast<double>(n)) *
@@ -117,32 +241,45 @@ int pll_decode(const uint8_t* flux, uint32_t words, double nominal,
     else if (clock > hi)
       clock = hi;
   }
-  return 0;  // a trailing unterminated overflow run is discarded (docs §1.4)
+  return 0;
 }
 
 // --------------------------------------------------- MFM byte extraction ----
 
+// The 16 raw bitcells starting at bit i (MSB-first), in one 3-byte load.
+unsigned load16(const BitBuf* bb, size_t i) {
+  const uint8_t* p = bb->bits + (i >> 3);
+  const uint32_t v = (static_cast<uint32_t>(p[0]) << 16) |
+                     (static_cast<uint32_t>(p[1]) << 8) | p[2];
+  return (v >> (8 - (i & 7))) & 0xFFFFu;
+}
+
+// Raw MFM byte (8 cells) → its 4 data bits: the cells at odd offsets.
+struct OddBits {
+  uint8_t v[256];
+  constexpr OddBits() : v() {
+    for (int b = 0; b < 256; b++)
+      v[b] = static_cast<uint8_t>(((b >> 3) & 8) | ((b >> 2) & 4) |
+                                  ((b >> 1) & 2) | (b & 1));
+  }
+};
+constexpr OddBits kOdd;
+
 // Read 16 raw bitcells at *pos as one byte (data bits at the odd offsets —
 // the stream is byte-synced right after a 0x4489 match). -1 = past the end.
 int read_mfm_byte(const BitBuf* bb, size_t* pos) {
   if (*pos + 16 > bb->n) return -1;
-  unsigned v = 0;
-  for (int k = 0; k < 8; k++)
-    v = (v << 1) | static_cast<unsigned>(
-                       bit_at(bb, *pos + (2 * static_cast<size_t>(k)) + 1));
+  const unsigned raw = load16(bb, *pos);
   *pos += 16;
-  return static_cast<int>(v);
+  return (kOdd.v[raw >> 8] << 4) | kOdd.v[raw & 0xFF];
 }
 
 // Read 16 raw bitcells as a raw word (sync detection). -1 = past the end.
 long read_raw16(const BitBuf* bb, size_t* pos) {
   if (*pos + 16 > bb->n) return -1;
-  unsigned v = 0;
-  for (int k = 0; k < 16; k++)
-    v = (v << 1) |
-        static_cast<unsigned>(bit_at(bb, *pos + static_cast<size_t>(k)));
+  const unsigned raw = load16(bb, *pos);
   *pos += 16;
-  return static_cast<long>(v);
+  return static_cast<long>(raw);
 }
 
 // CRC-CCITT: poly 0x1021, MSB-first. Preset with init 0xFFFF over A1 A1 A1
@@ -295,9 +432,10 @@ size_t scan_track(const BitBuf* bb, uint8_t* data, TrackScan* ts) {
 
 struct ScpGeom {
   uint8_t revs;
-  bool legacy;     // old single-sided layout: slot = cyl (docs §1.2)
-  double nominal;  // half-cell in ticks: 80 / (resolution + 1)
-  int cyls;        // last present cylinder + 1
+  uint8_t heads;    // 2 when side-1 tracks are present, else 1
+  bool legacy;      // old single-sided layout: slot = cyl (docs §1.2)
+  int64_t nominal;  // half-cell in Q16 ticks: 80 / (resolution + 1)
+  int cyls;         // last present cylinder (either side) + 1
 };
 
 // Header + offset-table validation shared by probe and convert. Returns 0 or
@@ -311,7 +449,7 @@ int scp_geometry(const uint8_t* scp, size_t len, ScpGeom* g) {
   if (heads == 2) return FLUX_E_GEOMETRY;      // side-1-only dump
   if (scp[0x06] > scp[0x07]) return FLUX_E_GEOMETRY;
   g->revs = scp[0x05];
-  g->nominal = 80.0 / (static_cast<double>(scp[0x0B]) + 1.0);
+  g->nominal = nominal_q(scp);
   g->legacy = false;
   if (heads != 0) {  // legacy consecutive single-sided layout?
     for (int slot = 1; slot < 168; slot += 2)
@@ -320,19 +458,31 @@ int scp_geometry(const uint8_t* scp, size_t len, ScpGeom* g) {
         break;
       }
   }
+  g->heads = 1;
   g->cyls = 0;
+  bool side0 = false;
   for (int cyl = 0; cyl < kMaxCyls; cyl++) {
     const int slot = g->legacy ? cyl : cyl * 2;
-    if (rd32(scp + kTlutOff + (4 * static_cast<size_t>(slot))) != 0)
+    if (rd32(scp + kTlutOff + (4 * static_cast<size_t>(slot))) != 0) {
+      g->cyls = cyl + 1;
+      side0 = true;
+    }
+    if (!g->legacy && heads == 0 &&
+        rd32(scp + kTlutOff + (4 * static_cast<size_t>(slot + 1))) != 0) {
+      g->heads = 2;
       g->cyls = cyl + 1;
+    }
   }
-  if (g->cyls == 0) return FLUX_E_GEOMETRY;  // nothing on side 0
+  if (!side0) return FLUX_E_GEOMETRY;  // nothing on side 0
   return 0;
 }
 
-// Append ONE revolution `r` of the track at `toff` to bb. 0 or a FLUX_E_* code.
+// Append ONE revolution `r` of the track at `toff` to bb, through the
+// fixed-point PLL or (reference) its double-precision oracle. 0 or a
+// FLUX_E_* code.
 int decode_one_rev(const uint8_t* scp, size_t len, uint32_t toff,
-                   const ScpGeom* g, int r, BitBuf* bb) {
+                   const ScpGeom* g, int r, BitBuf* bb,
+                   bool reference = false) {
   const uint64_t tdh_end =
       static_cast<uint64_t>(toff) + 4 + (12u * static_cast<uint64_t>(g->revs));
   if (tdh_end > len || std::memcmp(scp + toff, "TRK", 3) != 0)
@@ -342,6 +492,9 @@ int decode_one_rev(const uint8_t* scp, size_t len, uint32_t toff,
   const uint32_t doff = rd32(e + 8);
   if (static_cast<uint64_t>(toff) + doff + (2ull * words) > len)
     return FLUX_E_TRUNCATED;
+  if (reference)
+    return pll_decode_ref(scp + toff + doff, words,
+                          80.0 / (static_cast<double>(scp[0x0B]) + 1.0), bb);
   return pll_decode(scp + toff + doff, words, g->nominal, bb);
 }
 
@@ -359,9 +512,11 @@ int decode_track(const uint8_t* scp, size_t len, uint32_t toff,
   return 0;
 }
 
-// The side-0 track-offset-table entry for `cyl` (0 = absent).
-uint32_t track_offset(const uint8_t* scp, const ScpGeom* g, int cyl) {
-  const int slot = g->legacy ? cyl : cyl * 2;
+// The track-offset-table entry for (`cyl`, `head`) (0 = absent).
+uint32_t track_offset(const uint8_t* scp, const ScpGeom* g, int cyl,
+                      int head = 0) {
+  if (head >= g->heads) return 0;
+  const int slot = g->legacy ? cyl : (cyl * 2) + head;
   return rd32(scp + kTlutOff + (4 * static_cast<size_t>(slot)));
 }
 
@@ -385,20 +540,21 @@ long flux_scp_to_dsk(const uint8_t* scp, size_t scp_len, uint8_t* dsk_out,
   if (dsk_out == nullptr || dsk_cap < 0x100) return FLUX_E_DSK_OVERFLOW;
   std::memset(dsk_out, 0, 0x100);  // disc header, finished at the end
 
-  static_assert(kMaxCyls <= 102, "must fit a DSK header's track count");
+  static_assert(kMaxCyls * 2 <= 0x100 - 0x34,
+                "both sides must fit a DSK header's track table");
   BitBuf bb;  // 32 KB packed bitcells (docs §5)
   uint8_t trk_data[kMaxTrackBytes];
-  uint32_t block_of[kMaxCyls];
+  uint32_t block_of[kMaxCyls * 2];
   size_t off = 0x100;
   long total_sectors = 0;
   bool uniform = true;
   uint32_t common_block = 0;
   int common_n = -1;
 
-  for (int cyl = 0; cyl < g.cyls; cyl++) {
-    const int slot = g.legacy ? cyl : cyl * 2;
-    const uint32_t toff =
-        rd32(scp + kTlutOff + (4 * static_cast<size_t>(slot)));
+  // DSK track order: cylinder-major, side 0 then side 1 (docs §6).
+  for (int ti = 0; ti < g.cyls * g.heads; ti++) {
+    const int cyl = ti / g.heads, head = ti % g.heads;
+    const uint32_t toff = track_offset(scp, &g, cyl, head);
 
     TrackScan ts;
     ts.count = 0;
@@ -418,7 +574,7 @@ long flux_scp_to_dsk(const uint8_t* scp, size_t scp_len, uint8_t* dsk_out,
     std::memset(th, 0, block);
     std::memcpy(th, "Track-Info\r\n", 12);
     th[0x10] = static_cast<uint8_t>(cyl);
-    th[0x11] = 0;  // side 0
+    th[0x11] = static_cast<uint8_t>(head);
     const uint8_t size_code = ts.count ? ts.sec[0].chrn[3] : 2;
     th[0x14] = size_code;
     th[0x15] = static_cast<uint8_t>(ts.count);
@@ -440,7 +596,7 @@ long flux_scp_to_dsk(const uint8_t* scp, size_t scp_len, uint8_t* dsk_out,
         if (weak->count < FLUX_WEAK_MAX) {
           FluxWeakSector* w = &weak->sec[weak->count];
           w->cyl = static_cast<uint8_t>(cyl);
-          w->side = 0;
+          w->side = static_cast<uint8_t>(head);
           w->sector_id = s->chrn[2];
           w->reason = static_cast<uint8_t>((s->crc_bad ? FLUX_WEAK_CRC : 0) |
                                            (s->differs ? FLUX_WEAK_DIFFER : 0));
@@ -449,9 +605,9 @@ long flux_scp_to_dsk(const uint8_t* scp, size_t scp_len, uint8_t* dsk_out,
       }
     }
     std::memcpy(th + 0x100, trk_data, used);
-    block_of[cyl] = block;
-    dsk_out[0x34 + cyl] = static_cast<uint8_t>(block >> 8);  // extended table
-    if (cyl == 0)
+    block_of[ti] = block;
+    dsk_out[0x34 + ti] = static_cast<uint8_t>(block >> 8);  // extended table
+    if (ti == 0)
       common_block = block;
     else if (block != common_block)
       uniform = false;
@@ -466,9 +622,10 @@ long flux_scp_to_dsk(const uint8_t* scp, size_t scp_len, uint8_t* dsk_out,
     std::memcpy(dsk_out + 0x22, "konCePCja-flux", 14);
     dsk_out[0x32] = static_cast<uint8_t>(common_block & 0xFF);
     dsk_out[0x33] = static_cast<uint8_t>(common_block >> 8);
-    std::memset(dsk_out + 0x34, 0, static_cast<size_t>(g.cyls));  // unused
+    std::memset(dsk_out + 0x34, 0,
+                static_cast<size_t>(g.cyls * g.heads));  // unused
     size_t t_off = 0x100;
-    for (int t = 0; t < g.cyls; t++) {  // stored-length fields: unused too
+    for (int t = 0; t < g.cyls * g.heads; t++) {  // stored lengths: unused too
       uint8_t* th = dsk_out + t_off;
       for (int i = 0; i < th[0x15]; i++)
         th[0x18 + (8 * static_cast<size_t>(i)) + 6] =
@@ -480,7 +637,7 @@ long flux_scp_to_dsk(const uint8_t* scp, size_t scp_len, uint8_t* dsk_out,
     std::memcpy(dsk_out + 0x22, "konCePCja-flux", 14);
   }
   dsk_out[0x30] = static_cast<uint8_t>(g.cyls);
-  dsk_out[0x31] = 1;  // side 0 only (docs §5)
+  dsk_out[0x31] = g.heads;
   return static_cast<long>(off);
 }
 
@@ -496,9 +653,41 @@ int flux_scp_cylinders(const uint8_t* scp, size_t len) {
   return scp_geometry(scp, len, &g) == 0 ? g.cyls : 0;
 }
 
+int flux_scp_heads(const uint8_t* scp, size_t len) {
+  ScpGeom g;
+  return scp_geometry(scp, len, &g) == 0 ? g.heads : 0;
+}
+
+long flux_pll_bitcells(const uint8_t* scp, size_t len, uint8_t cyl,
+                       uint8_t rev, int reference, uint8_t* bits, size_t cap) {
+  ScpGeom g;
+  {
+    const int rc = scp_geometry(scp, len, &g);
+    if (rc != 0) return rc;
+  }
+  if (cyl >= g.cyls) return 0;
+  const uint32_t toff = track_offset(scp, &g, cyl);
+  if (toff == 0) return 0;
+  BitBuf bb;
+  bb.n = 0;
+  std::memset(bb.bits, 0, sizeof(bb.bits));
+  const int rc = decode_one_rev(scp, len, toff, &g, rev % g.revs, &bb,
+                                reference != 0);
+  if (rc != 0) return rc;
+  const size_t n = bb.n <= cap * 8 ? bb.n : cap * 8;
+  std::memcpy(bits, bb.bits, (n + 7) / 8);
+  return static_cast<long>(n);
+}
+
 int flux_decode_track_rev(const uint8_t* scp, size_t len, uint8_t cyl,
                           uint8_t rev, FluxTrack* out, uint8_t* payload,
                           size_t payload_cap) {
+  return flux_decode_track(scp, len, cyl, 0, rev, out, payload, payload_cap);
+}
+
+int flux_decode_track(const uint8_t* scp, size_t len, uint8_t cyl,
+                      uint8_t head, uint8_t rev, FluxTrack* out,
+                      uint8_t* payload, size_t payload_cap) {
   std::memset(out, 0, sizeof(*out));
   ScpGeom g;
   {
@@ -506,8 +695,8 @@ int flux_decode_track_rev(const uint8_t* scp, size_t len, uint8_t cyl,
     if (rc != 0) return rc;
   }
   if (cyl >= g.cyls) return 0;  // past the dump: nothing under the head
-  const uint32_t toff = track_offset(scp, &g, cyl);
-  if (toff == 0) return 0;  // unformatted / absent cylinder
+  const uint32_t toff = track_offset(scp, &g, cyl, head);
+  if (toff == 0) return 0;  // unformatted / absent track (or no such side)
 
   BitBuf bb;  // one revolution only
   bb.n = 0;
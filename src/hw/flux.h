@@ -43,7 +43,7 @@ enum : std::uint8_t {
 
 typedef struct FluxWeakSector {
   uint8_t cyl;       /* physical cylinder (DSK track number)        */
-  uint8_t side;      /* always 0 in Stage 1 (side 0 only)           */
+  uint8_t side;      /* head: 1 only on a double-sided dump         */
   uint8_t sector_id; /* R from the sector's ID field                */
   uint8_t reason;    /* FLUX_WEAK_* bits                            */
 } FluxWeakSector;
@@ -88,8 +88,11 @@ typedef struct FluxTrack {
 
 /* Revolutions captured per track in this SCP (0 = not a usable SCP). */
 int flux_scp_revolutions(const uint8_t* scp, size_t len);
-/* Highest side-0 cylinder present + 1 (0 = not a usable SCP). */
+/* Highest cylinder present on either side + 1 (0 = not a usable SCP). */
 int flux_scp_cylinders(const uint8_t* scp, size_t len);
+/* Sides captured: 2 when the dump carries side-1 tracks, else 1 (0 = not a
+ * usable SCP). */
+int flux_scp_heads(const uint8_t* scp, size_t len);
 
 /* Decode ONE revolution of ONE side-0 cylinder: PLL → MFM → sector map with
  * angular byte-cell positions, payloads into the caller's buffer. An absent /
@@ -100,12 +103,28 @@ int flux_decode_track_rev(const uint8_t* scp, size_t len, uint8_t cyl,
                           uint8_t rev, FluxTrack* out, uint8_t* payload,
                           size_t payload_cap);
 
-/* The whole pipeline: for each side-0 track present in the SCP, PLL-decode
+/* flux_decode_track_rev for either side: `head` 1 reads the side-1 track of
+ * a double-sided dump; a side the dump lacks reads as unformatted (count 0,
+ * returns 0). flux_decode_track_rev is the head-0 shorthand. */
+int flux_decode_track(const uint8_t* scp, size_t len, uint8_t cyl,
+                      uint8_t head, uint8_t rev, FluxTrack* out,
+                      uint8_t* payload, size_t payload_cap);
+
+/* Diagnostics: PLL-decode ONE revolution of ONE side-0 cylinder to its raw
+ * MFM bitcell stream, packed MSB-first into `bits` (`cap` bytes; a longer
+ * stream is cut there). reference = 0 runs the shipping fixed-point PLL,
+ * 1 the double-precision PLL it replaced, kept as its oracle (docs §2).
+ * Returns the bitcells stored (0 for an absent cylinder) or a FLUX_E_* code. */
+long flux_pll_bitcells(const uint8_t* scp, size_t len, uint8_t cyl,
+                       uint8_t rev, int reference, uint8_t* bits, size_t cap);
+
+/* The whole pipeline: for each track present in the SCP, PLL-decode
  * revolution 0 (and revolution 1 when the dump has ≥2 — docs §2/§4) to MFM
  * bitcells, locate the IBM System 34 address marks, CRC-check ID and data
  * fields, and emit a standard DSK — extended when sector sizes vary — into
- * dsk_out. `weak` (optional, may be NULL) receives the weak/suspect-sector
- * report; the DSK always carries the revolution-0 data.
+ * dsk_out — double-sided when the dump carries side-1 tracks. `weak`
+ * (optional, may be NULL) receives the weak/suspect-sector report; the DSK
+ * always carries the revolution-0 data.
  *
  * Returns the DSK byte size, or a negative FLUX_E_* code. On error dsk_out's
  * contents are unspecified. */
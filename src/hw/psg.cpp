@@ -69,7 +69,20 @@ struct psg_state {
   uint8_t key_matrix[16];
 };
 
+// The device storage: the saved state first (self_of's view), then the
+// detached-sound and level hooks — live wiring, never saved or reset.
+struct psg_dev {
+  psg_state s;
+  PsgWriteFn detach_fn = nullptr;
+  void* detach_ctx = nullptr;
+  uint64_t detach_steps = 0;  // clk.psg steps counted since psg_detach_sound
+  PsgLevelFn level_fn = nullptr;
+  void* level_ctx = nullptr;
+  uint64_t steps = 0;  // sound steps since init (psg_sound_steps)
+};
+
 psg_state* self_of(void* self) { return static_cast<psg_state*>(self); }
+psg_dev* dev_of(psg_state* p) { return reinterpret_cast<psg_dev*>(p); }
 
 uint16_t tone_period(const psg_state* p, int chan) {
   const int lo = chan * 2;
@@ -196,6 +209,19 @@ void sound_step(psg_state* p) {
   mixer_step(p);
 }
 
+// One counted sound step; a step that moves any channel level reports the
+// new levels to the level sink, tagged with its own index.
+void sound_step_counted(psg_dev* d) {
+  psg_state* p = &d->s;
+  uint8_t was[3];
+  std::memcpy(was, p->chan_level, sizeof(was));
+  sound_step(p);
+  const uint64_t step = d->steps++;
+  if (d->level_fn != nullptr &&
+      std::memcmp(was, p->chan_level, sizeof(was)) != 0)
+    d->level_fn(d->level_ctx, step, p->chan_level);
+}
+
 // --- AY bus protocol
 // -------------------------------------------------------------
 
@@ -211,6 +237,9 @@ void ay_apply(psg_state* p, bool bdir, bool bc1, uint8_t da) {
       if (p->sel == 13)
         env_restart(p);  // writing the shape restarts the envelope — ONCE per
                          // write event (edge semantics, see the shadow above)
+      const psg_dev* d = dev_of(p);
+      if (d->detach_fn != nullptr)
+        d->detach_fn(d->detach_ctx, d->detach_steps, p->sel, p->reg[p->sel]);
     }
   }
 }
@@ -249,7 +278,15 @@ void ay_bus(psg_state* p, const Bus* in, Bus* out) {
 void psg_tick(void* self, const Bus* __restrict in, Bus* __restrict out) {
   psg_state* p = self_of(self);
   ay_bus(p, in, out);
-  if (in->clk.psg) sound_step(p);
+  if (in->clk.psg) {
+    psg_dev* d = dev_of(p);
+    if (d->detach_fn == nullptr) {
+      sound_step_counted(d);
+    } else {
+      d->detach_steps++;  // the replica steps; this one only keeps time
+      d->steps++;
+    }
+  }
 }
 
 void psg_reset(void* self) {
@@ -308,10 +345,10 @@ void psg_load(void* self, const void* buf) {
 
 extern "C" {
 
-size_t psg_state_size(void) { return sizeof(psg_state); }
+size_t psg_state_size(void) { return sizeof(psg_dev); }
 
 Device psg_init(void* storage) {
-  psg_state* p = new (storage) psg_state();
+  psg_state* p = &(new (storage) psg_dev())->s;
   std::memset(p->key_matrix, 0xFF, sizeof(p->key_matrix));  // no keys pressed
   psg_reset(p);
   return Device{p,        "psg",   psg_tick, psg_reset, psg_dev_state_size,
@@ -377,6 +414,45 @@ void psg_poke_env(const Device* dev, uint8_t half_level, uint8_t direction) {
   }
 }
 
+void psg_detach_sound(const Device* dev, PsgWriteFn fn, void* ctx) {
+  psg_dev* d = dev_of(static_cast<psg_state*>(dev->self));
+  d->detach_fn = fn;
+  d->detach_ctx = ctx;
+  d->detach_steps = 0;
+}
+
+uint64_t psg_detached_steps(const Device* dev) {
+  return dev_of(static_cast<psg_state*>(dev->self))->detach_steps;
+}
+
+void psg_set_level_sink(const Device* dev, PsgLevelFn fn, void* ctx) {
+  psg_dev* d = dev_of(static_cast<psg_state*>(dev->self));
+  d->level_fn = fn;
+  d->level_ctx = ctx;
+}
+
+uint64_t psg_sound_steps(const Device* dev) {
+  return dev_of(static_cast<psg_state*>(dev->self))->steps;
+}
+
+void psg_write(const Device* dev, uint8_t reg, uint8_t val) {
+  psg_state* p = static_cast<psg_state*>(dev->self);
+  reg &= 15;
+  p->reg[reg] = static_cast<uint8_t>(val & kRegMask[reg]);
+  if (reg == 13) env_restart(p);
+}
+
+void psg_copy_sound(const Device* dst, const Device* src) {
+  psg_state* d = static_cast<psg_state*>(dst->self);
+  const psg_state* s = static_cast<const psg_state*>(src->self);
+  std::memcpy(d->reg, s->reg, sizeof(d->reg));
+  // The generator: everything from the tone prescaler up to the key matrix.
+  constexpr size_t kFrom = offsetof(psg_state, tone_div);
+  constexpr size_t kTo = offsetof(psg_state, key_matrix);
+  std::memcpy(reinterpret_cast<uint8_t*>(d) + kFrom,
+              reinterpret_cast<const uint8_t*>(s) + kFrom, kTo - kFrom);
+}
+
 void psg_fast_lines(const Device* dev, int bdir, int bc1, uint8_t da) {
   // Fast tier: one AY line-state change event — the same edge core the
   // per-cycle ay_bus feeds, and it maintains the same shadow, so tiers can
@@ -412,7 +488,7 @@ uint16_t psg_take_scanned_rows(const Device* dev) {
 }
 
 void psg_batch_step(const Device* dev) {
-  sound_step(static_cast<psg_state*>(dev->self));  // one 1 MHz sound step
+  sound_step_counted(dev_of(static_cast<psg_state*>(dev->self)));
 }
 
 // F8 bulk pair — see psg.h. A prescaler of width `presc` at phase `div`
@@ -451,6 +527,7 @@ uint32_t psg_batch_quiet_steps(const Device* dev) {
 
 void psg_batch_skip(const Device* dev, uint32_t n) {
   psg_state* p = static_cast<psg_state*>(dev->self);
+  dev_of(p)->steps += n;
   const uint32_t tone_total = p->tone_div + n;
   const uint32_t tone_ticks = tone_total / 8;
   p->tone_div = static_cast<uint16_t>(tone_total % 8);
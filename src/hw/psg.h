@@ -89,6 +89,40 @@ uint32_t psg_batch_quiet_steps(const Device* dev);
  * forward in closed form; chan_level is untouched by construction. */
 void psg_batch_skip(const Device* dev, uint32_t n);
 
+/* --- Detached sound generator (psg-device.md §detached) ---
+ *
+ * The Machine's audio worker runs tone/noise/envelope on a REPLICA PSG that
+ * replays this one's register writes. While detached, clk.psg only counts
+ * steps here (the generator state goes stale until copied back) and every
+ * register write is reported to fn with the number of steps counted before
+ * it — the same tick's step runs after the write. fn = NULL reattaches. The
+ * hook is live wiring: not saved, and it survives reset. */
+typedef void (*PsgWriteFn)(void* ctx, uint64_t step, uint8_t reg, uint8_t val);
+void psg_detach_sound(const Device* dev, PsgWriteFn fn, void* ctx);
+/* clk.psg steps counted since psg_detach_sound. */
+uint64_t psg_detached_steps(const Device* dev);
+/* One register write as the AY bus applies it (mask; reg 13 restarts the
+ * envelope) — the replica's input. */
+void psg_write(const Device* dev, uint8_t reg, uint8_t val);
+/* Copy the register file and the sound generator (counters, LFSR, envelope,
+ * channel levels) — not the bus shadow, the selection or the key matrix. */
+void psg_copy_sound(const Device* dst, const Device* src);
+
+/* --- Level events (psg-device.md §levels) ---
+ *
+ * The channel levels move only at sound steps. Every step that changes one
+ * calls fn with the step's index (psg_sound_steps() before it) and the new
+ * A/B/C levels, so a mixer can clock steady runs without sampling each step.
+ * Steps taken by the clk.psg tick, psg_batch_step and psg_batch_skip all
+ * count (a detached PSG counts the steps its replica takes); state loads,
+ * resets and pokes report nothing — re-read psg_levels() after them. Live
+ * wiring like the detach hook: not saved, survives reset. fn = NULL
+ * detaches. */
+typedef void (*PsgLevelFn)(void* ctx, uint64_t step, const uint8_t levels[3]);
+void psg_set_level_sink(const Device* dev, PsgLevelFn fn, void* ctx);
+/* Sound steps counted since psg_init (the level events' clock). */
+uint64_t psg_sound_steps(const Device* dev);
+
 #ifdef __cplusplus
 }
 #endif
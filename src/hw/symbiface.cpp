@@ -50,6 +50,10 @@ struct sf2_state {
   // Live wiring (never serialized): MUST stay the LAST members.
   uint8_t* img[2] = {nullptr, nullptr};
   uint32_t total_sectors[2] = {0, 0};
+  // Write-back map per drive: bit i = region i written since attach or the
+  // last mark_clean; a region is `region_sectors` sectors (sf2.h).
+  uint8_t written[2][SF2_DIRTY_REGIONS / 8] = {};
+  uint32_t region_sectors[2] = {1, 1};
 };
 
 sf2_state* self_of(void* self) { return static_cast<sf2_state*>(self); }
@@ -156,6 +160,8 @@ void ide_do_write_commit(sf2_state* f) {
   }
   std::memcpy(f->img[n] + (static_cast<size_t>(lba) * 512), d->sector_buf, 512);
   f->dirty = 1;
+  const uint32_t region = lba / f->region_sectors[n];
+  f->written[n][region >> 3] |= static_cast<uint8_t>(1u << (region & 7));
   d->write_pending = 0;
   d->sector_count--;  // multi-sector chaining, per the golden master
   if (d->sector_count > 0) {
@@ -429,6 +435,10 @@ void sf2_ide_attach(const Device* dev, int drive, uint8_t* img, size_t len) {
   const int n = drive ? 1 : 0;
   f->img[n] = img;
   f->total_sectors[n] = static_cast<uint32_t>(len / 512);
+  f->region_sectors[n] =
+      (f->total_sectors[n] + SF2_DIRTY_REGIONS - 1) / SF2_DIRTY_REGIONS;
+  if (f->region_sectors[n] == 0) f->region_sectors[n] = 1;
+  std::memset(f->written[n], 0, sizeof(f->written[n]));
   f->ide[n].status = kSrDrdy;
   f->ide[n].error = 0;
 }
@@ -446,7 +456,18 @@ int sf2_media_dirty(const Device* dev) {
 }
 
 void sf2_media_mark_clean(const Device* dev) {
-  static_cast<sf2_state*>(dev->self)->dirty = 0;
+  sf2_state* f = static_cast<sf2_state*>(dev->self);
+  f->dirty = 0;
+  std::memset(f->written, 0, sizeof(f->written));
+}
+
+const uint8_t* sf2_media_written(const Device* dev, int drive,
+                                 uint32_t* region_sectors) {
+  const sf2_state* f = static_cast<const sf2_state*>(dev->self);
+  const int n = drive ? 1 : 0;
+  if (!present(f, n)) return nullptr;
+  *region_sectors = f->region_sectors[n];
+  return f->written[n];
 }
 
 void sf2_rtc_set_time(const Device* dev, const uint8_t regs10[10]) {
@@ -35,6 +35,15 @@ void sf2_ide_detach(const Device* dev, int drive);
 int sf2_media_dirty(const Device* dev);
 void sf2_media_mark_clean(const Device* dev);
 
+/* Which parts of a drive's image WRITE SECTORS touched since attach or the
+ * last mark_clean, for an incremental write-back: bit i of the returned
+ * SF2_DIRTY_REGIONS-bit map (byte i / 8, bit i % 8) covers sectors
+ * [i * per, (i + 1) * per), `per` stored to *region_sectors. nullptr when the
+ * drive has no image. */
+enum { SF2_DIRTY_REGIONS = 1024 };
+const uint8_t* sf2_media_written(const Device* dev, int drive,
+                                 uint32_t* region_sectors);
+
 /* The DS12887 clock registers 0..9 (BCD, the golden master's layout:
  * sec, x, min, x, hour, x, day-of-week, day, month, year). The host
  * refreshes whenever it likes; reads serve the fed values (spec §3). */
@@ -9,59 +9,36 @@
 
 namespace {
 
-// CDT durations are 3.5 MHz T-states; 3.5/16 = 7/32 exactly: pulses load as
-// t-states * 32 sub-units, the deck consumes 7 sub-units per master cycle.
-constexpr int32_t kSubPerCycle = 7;
-constexpr int32_t kSubPerTs = 32;
+// CDT durations are 3.5 MHz T-states; 3.5/16 = 7/32 exactly: a pulse of
+// `ts` t-states is ts * 32 sub-units, and a master cycle is 7 of them.
+constexpr uint32_t kSubPerCycle = 7;
+constexpr uint32_t kSubPerTs = 32;
 constexpr uint32_t kCyclesPerMs = 16000;
-
-enum Phase : uint8_t {
-  PH_IDLE = 0,  // between blocks / not playing
-  PH_PILOT,
-  PH_SYNC1,
-  PH_SYNC2,
-  PH_DATA,
-  PH_PULSESEQ,  // 0x13: a list of explicit pulses
-  PH_DIRECT,    // 0x15: each data BIT is the line level for t_bit0 t-states
-  PH_PAUSE,
-};
+constexpr uint32_t kFirstBlock = 10;  // past "ZXTape!\x1A" + version
+constexpr uint64_t kMaxRun = TAPE_RUN_CYCLES;  // longer holds split
 
 struct tape_state {
   // Playback cursor (serialized).
-  uint32_t pos = 0;    // byte offset of the CURRENT block header
-  uint32_t block = 0;  // block ordinal
-  uint8_t phase = PH_IDLE;
+  uint64_t cycle = 0;  // tape time at the start of the current run
+  uint32_t run = 0;    // the run on the wire (== nruns at the end)
+  uint32_t left = 0;   // master cycles left in it (0 = not entered)
+  uint32_t block = 0;  // block ordinal holding `run`
   uint8_t level = 0;
   uint8_t playing = 0;
   uint8_t line_mode = 0;
   uint8_t line_level = 0;
   uint8_t motor_seen = 0;
   uint8_t error = 0;
-  // Current-block decode state.
-  uint32_t data_off = 0;  // offset of the data bytes (0x10/0x11/0x14)
-  uint32_t data_len = 0;
-  uint32_t byte_idx = 0;
-  uint8_t bit_idx = 0;       // 0..7, MSB first
-  uint8_t last_used = 8;     // used bits in the final byte
-  uint8_t pulse_half = 0;    // which half of the bit's pulse pair
-  uint16_t pulses_left = 0;  // pilot / pure-tone / pulse-seq counter
-  uint16_t seq_idx = 0;
-  // Timings for the block in flight (t-states), pause in ms.
-  uint16_t t_pilot = 2168, t_sync1 = 667, t_sync2 = 735, t_bit0 = 855,
-           t_bit1 = 1710;
-  uint16_t pause_ms = 0;
-  int32_t sub_remaining = 0;  // current pulse, in 1/32-t-state sub-units
-  uint32_t pause_cycles = 0;  // pause countdown, master cycles
 
   // Live wiring (never serialized) — keep LAST.
-  const uint8_t* cdt = nullptr;
-  size_t len = 0;
+  TapeStream media = {};
+  uint8_t attached = 0;
 
   // Decoded-bit observation ring for the host tape scope's BITS view. Placed
-  // AFTER cdt/len — past the offsetof(cdt) save cut — so it is never serialized
-  // (pure host visualization). Each data bit the deck emits is recorded here
-  // and drained by tape_drain_bits. 256-entry; uint8_t indices wrap mod 256 and
-  // a full ring drops the oldest bit.
+  // AFTER the media — past the offsetof(media) save cut — so it is never
+  // serialized (pure host visualization). Each data bit the deck emits is
+  // recorded here and drained by tape_drain_bits. 256-entry; uint8_t indices
+  // wrap mod 256 and a full ring drops the oldest bit.
   uint8_t bit_ring[256] = {};
   uint8_t bit_wr = 0;  // write index
   uint8_t bit_rd = 0;  // drain index
@@ -69,284 +46,237 @@ struct tape_state {
 
 tape_state* self_of(void* self) { return static_cast<tape_state*>(self); }
 
-uint8_t rd8(const tape_state* t, uint32_t off) {
-  return off < t->len ? t->cdt[off] : 0;
-}
-uint16_t rd16(const tape_state* t, uint32_t off) {
-  return static_cast<uint16_t>(rd8(t, off) | (rd8(t, off + 1) << 8));
-}
-uint32_t rd24(const tape_state* t, uint32_t off) {
-  return rd8(t, off) | (rd8(t, off + 1) << 8) | (rd8(t, off + 2) << 16);
-}
+uint32_t run_cycles(TapeRun r) { return r & TAPE_RUN_CYCLES; }
 
-// Byte length of the CDT block at `pos` (0 = unsizable → stop walking). The
-// host block table (tape_scan_blocks) walks the same sizes via
-// tape_cdt_block_len, so a block ordinal here matches the UI's.
-uint32_t block_len(const tape_state* t, uint32_t pos) {
-  return tape_cdt_block_len(t->cdt, static_cast<uint32_t>(t->len), pos);
-}
-
-void load_pulse(tape_state* t, uint16_t ts) {
-  t->sub_remaining = static_cast<int32_t>(ts) * kSubPerTs;
-}
+// --- Compiler: CDT blocks -> runs (tape-device.md §3) ---
 
-// Record one decoded data bit for the host scope's BITS view (drained by
-// tape_drain_bits). uint8_t indices wrap mod 256; if the ring is full the
-// oldest unread bit is dropped so recent history always wins.
-void push_bit(tape_state* t, uint8_t bit) {
-  t->bit_ring[t->bit_wr++] = bit ? 1 : 0;
-  if (t->bit_wr == t->bit_rd) t->bit_rd++;
-}
+struct Compiler {
+  const uint8_t* cdt;
+  uint32_t len;
+  TapeRun* runs;
+  uint32_t runs_cap;
+  uint32_t nruns = 0;
+  uint64_t cycle = 0;
+  uint32_t residual = 0;  // sub-units owed to the next pulse
+  uint8_t level = 0;
+  bool stopped = false;  // the last run is a marker
 
-void stop(tape_state* t) {
-  t->playing = 0;
-  t->phase = PH_IDLE;
-}
+  uint8_t rd8(uint32_t off) const { return off < len ? cdt[off] : 0; }
+  uint16_t rd16(uint32_t off) const {
+    return static_cast<uint16_t>(rd8(off) | (rd8(off + 1) << 8));
+  }
+  uint32_t rd24(uint32_t off) const {
+    return rd16(off) | (static_cast<uint32_t>(rd8(off + 2)) << 16);
+  }
 
-// Enter the block at t->pos; skip metadata; set up the pulse machinery.
-void start_block(tape_state* t) {
-  if (t->cdt == nullptr) {
-    stop(t);
-    return;
+  static uint32_t level_bit(uint8_t lv) { return lv ? uint32_t{TAPE_RUN_LEVEL} : 0u; }
+  void put(TapeRun r) {
+    if (nruns < runs_cap) runs[nruns] = r;
+    nruns++;
+    stopped = run_cycles(r) == 0;
+  }
+  // Hold `lv` for `cycles`; `flags` (a data bit) go on the first piece.
+  void hold(uint64_t cycles, uint8_t lv, uint32_t flags) {
+    while (cycles > 0) {
+      const uint32_t c =
+          static_cast<uint32_t>(cycles < kMaxRun ? cycles : kMaxRun);
+      put(c | level_bit(lv) | flags);
+      flags = 0;
+      cycles -= c;
+      cycle += c;
+    }
   }
-  for (;;) {
-    if (t->pos >= t->len) {
-      stop(t);
-      return;  // end of tape
+  // `ts` t-states in whole master cycles, carrying the remainder on.
+  uint32_t cycles_of(uint16_t ts) {
+    const uint32_t sub = (static_cast<uint32_t>(ts) * kSubPerTs) + residual;
+    residual = sub % kSubPerCycle;
+    if (sub < kSubPerCycle) {  // a 0-ts pulse still lasts a cycle
+      residual = 0;
+      return 1;
     }
-    const uint8_t id = rd8(t, t->pos);
-    const uint32_t body = t->pos + 1;
-    switch (id) {
-      case 0x10:  // standard speed data
-        t->pause_ms = rd16(t, body);
-        t->data_len = rd16(t, body + 2);
-        t->data_off = body + 4;
-        t->t_pilot = 2168;
-        t->t_sync1 = 667;
-        t->t_sync2 = 735;
-        t->t_bit0 = 855;
-        t->t_bit1 = 1710;
-        t->last_used = 8;
-        t->pulses_left = rd8(t, t->data_off) < 0x80 ? 8063 : 3223;
-        t->phase = PH_PILOT;
-        load_pulse(t, t->t_pilot);
-        t->byte_idx = 0;
-        t->bit_idx = 0;
-        t->pulse_half = 0;
-        t->pos = t->data_off + t->data_len;
+    return sub / kSubPerCycle;
+  }
+  // One pulse: hold the current level, toggle at its end.
+  void pulse(uint16_t ts, uint32_t flags = 0) {
+    hold(cycles_of(ts), level, flags);
+    level ^= 1;
+  }
+  void pause(uint16_t ms) {
+    if (ms == 0) return;
+    level = 0;
+    hold(static_cast<uint64_t>(ms) * kCyclesPerMs, 0, 0);
+  }
+  // Bytes at `off`, MSB first, `last_used` bits of the final byte; each bit
+  // is a pulse PAIR of its period.
+  void data(uint32_t off, uint32_t n, uint8_t last_used, uint16_t t0,
+            uint16_t t1) {
+    n = off < len ? (n < len - off ? n : len - off) : 0;  // truncated file
+    for (uint32_t i = 0; i < n; ++i) {
+      const uint8_t byte = rd8(off + i);
+      const int bits = (i + 1 == n && last_used >= 1 && last_used <= 8)
+                           ? last_used
+                           : 8;
+      for (int b = 0; b < bits; ++b) {
+        const bool one = ((byte >> (7 - b)) & 1) != 0;
+        pulse(one ? t1 : t0, TAPE_RUN_BIT | (one ? uint32_t{TAPE_RUN_ONE} : 0u));
+        pulse(one ? t1 : t0);
+      }
+    }
+  }
+  // 0x15: each bit IS the level for `ts` t-states; the last one persists.
+  // Samples are not data bits (no BITS-scope flag), so a stretch of equal
+  // samples compiles to one run: a sampled tone is a run per half-wave, not
+  // one per sample.
+  void direct(uint32_t off, uint32_t n, uint8_t last_used, uint16_t ts) {
+    n = off < len ? (n < len - off ? n : len - off) : 0;
+    uint64_t held = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+      const uint8_t byte = rd8(off + i);
+      const int bits = (i + 1 == n && last_used >= 1 && last_used <= 8)
+                           ? last_used
+                           : 8;
+      for (int b = 0; b < bits; ++b) {
+        const uint8_t lv = (byte >> (7 - b)) & 1;
+        if (held > 0 && lv != level) {
+          hold(held, level, 0);
+          held = 0;
+        }
+        level = lv;
+        held += cycles_of(ts);
+      }
+    }
+    hold(held, level, 0);
+  }
+
+  // The runs of the block at `pos`. Metadata plays nothing; an unknown
+  // block compiles to the ERROR marker (never guess what it plays).
+  void block(uint32_t pos) {
+    const uint32_t body = pos + 1;
+    switch (rd8(pos)) {
+      case 0x10: {  // standard speed data
+        const uint32_t n = rd16(body + 2);
+        for (int i = rd8(body + 4) < 0x80 ? 8063 : 3223; i > 0; --i)
+          pulse(2168);
+        pulse(667);
+        pulse(735);
+        data(body + 4, n, 8, 855, 1710);
+        pause(rd16(body));
         return;
+      }
       case 0x11:  // turbo speed data
-        t->t_pilot = rd16(t, body);
-        t->t_sync1 = rd16(t, body + 2);
-        t->t_sync2 = rd16(t, body + 4);
-        t->t_bit0 = rd16(t, body + 6);
-        t->t_bit1 = rd16(t, body + 8);
-        t->pulses_left = rd16(t, body + 10);
-        t->last_used = rd8(t, body + 12);
-        t->pause_ms = rd16(t, body + 13);
-        t->data_len = rd24(t, body + 15);
-        t->data_off = body + 18;
-        t->phase = PH_PILOT;
-        load_pulse(t, t->t_pilot);
-        t->byte_idx = 0;
-        t->bit_idx = 0;
-        t->pulse_half = 0;
-        t->pos = t->data_off + t->data_len;
+        for (uint32_t i = rd16(body + 10); i > 0; --i) pulse(rd16(body));
+        pulse(rd16(body + 2));
+        pulse(rd16(body + 4));
+        data(body + 18, rd24(body + 15), rd8(body + 12), rd16(body + 6),
+             rd16(body + 8));
+        pause(rd16(body + 13));
         return;
       case 0x12:  // pure tone
-        t->t_pilot = rd16(t, body);
-        t->pulses_left = rd16(t, body + 2);
-        t->phase = PH_PILOT;
-        // Pure tone ends without sync: reuse PILOT with a "no data" marker.
-        t->data_len = 0;
-        t->data_off = 0;
-        t->pause_ms = 0;
-        load_pulse(t, t->t_pilot);
-        t->pos = body + 4;
+        for (uint32_t i = rd16(body + 2); i > 0; --i) pulse(rd16(body));
         return;
       case 0x13:  // pulse sequence
-        t->pulses_left = rd8(t, body);
-        t->seq_idx = 0;
-        t->data_off = body + 1;  // pulse table
-        t->phase = PH_PULSESEQ;
-        load_pulse(t, rd16(t, t->data_off));
-        t->pos = body + 1 + (static_cast<uint32_t>(t->pulses_left) * 2);
+        for (uint32_t i = 0; i < rd8(body); ++i)
+          pulse(rd16(body + 1 + (i * 2)));
         return;
       case 0x14:  // pure data
-        t->t_bit0 = rd16(t, body);
-        t->t_bit1 = rd16(t, body + 2);
-        t->last_used = rd8(t, body + 4);
-        t->pause_ms = rd16(t, body + 5);
-        t->data_len = rd24(t, body + 7);
-        t->data_off = body + 10;
-        t->phase = PH_DATA;
-        t->byte_idx = 0;
-        t->bit_idx = 0;
-        t->pulse_half = 0;
-        push_bit(t, (rd8(t, t->data_off) & 0x80) ? 1 : 0);  // first data bit
-        load_pulse(t, (rd8(t, t->data_off) & 0x80) ? t->t_bit1 : t->t_bit0);
-        t->pos = t->data_off + t->data_len;
+        data(body + 10, rd24(body + 7), rd8(body + 4), rd16(body),
+             rd16(body + 2));
+        pause(rd16(body + 5));
         return;
-      case 0x15: {  // direct recording: each bit IS the level, no pulse pairs
-        t->t_bit0 = rd16(t, body);  // t-states per sample
-        t->pause_ms = rd16(t, body + 2);
-        t->last_used = rd8(t, body + 4);
-        t->data_len = rd24(t, body + 5);
-        t->data_off = body + 8;
-        t->pos = t->data_off + t->data_len;
-        if (t->data_len == 0) {  // degenerate: nothing to play
-          t->block++;
-          continue;
-        }
-        t->phase = PH_DIRECT;
-        t->byte_idx = 0;
-        t->bit_idx = 0;
-        t->level = (rd8(t, t->data_off) & 0x80) ? 1 : 0;
-        push_bit(t, t->level);
-        load_pulse(t, t->t_bit0);
+      case 0x15:  // direct recording
+        direct(body + 8, rd24(body + 5), rd8(body + 4), rd16(body));
+        pause(rd16(body + 2));
         return;
-      }
-      case 0x20: {  // pause / stop
-        const uint16_t ms = rd16(t, body);
-        t->pos = body + 2;
-        if (ms == 0) {
-          stop(t);
-          return;
+      case 0x20:  // pause, or stop the tape
+        if (rd16(body) == 0) {
+          put(level_bit(level));  // STOP
+        } else {
+          pause(rd16(body));
         }
-        t->phase = PH_PAUSE;
-        t->pause_cycles = ms * kCyclesPerMs;
-        t->level = 0;
         return;
-      }
-      // Metadata: skip by the block's own length rule.
-      case 0x21:
-        t->pos = body + 1 + rd8(t, body);
-        t->block++;
-        continue;
+      case 0x21:  // metadata: nothing on the wire
       case 0x22:
-        t->pos = body;
-        t->block++;
-        continue;
       case 0x30:
-        t->pos = body + 1 + rd8(t, body);
-        t->block++;
-        continue;
       case 0x31:
-        t->pos = body + 2 + rd8(t, body + 1);
-        t->block++;
-        continue;
       case 0x32:
-        t->pos = body + 2 + rd16(t, body);
-        t->block++;
-        continue;
       case 0x33:
-        t->pos = body + 1 + (rd8(t, body) * 3u);
-        t->block++;
-        continue;
+        return;
       default:
-        t->error = 1;  // never guess a length (spec §3)
-        stop(t);
+        put(TAPE_RUN_ERROR | level_bit(level));  // spec §3
         return;
     }
   }
+};
+
+// --- Playback: a cursor over the runs ---
+
+// Record one decoded data bit for the host scope's BITS view (drained by
+// tape_drain_bits). uint8_t indices wrap mod 256; if the ring is full the
+// oldest unread bit is dropped so recent history always wins.
+void push_bit(tape_state* t, uint8_t bit) {
+  t->bit_ring[t->bit_wr++] = bit ? 1 : 0;
+  if (t->bit_wr == t->bit_rd) t->bit_rd++;
 }
 
-void next_block(tape_state* t) {
-  t->block++;
-  if (t->pause_ms) {
-    t->phase = PH_PAUSE;
-    t->pause_cycles = t->pause_ms * kCyclesPerMs;
-    t->pause_ms = 0;
-    t->level = 0;
-    return;
-  }
-  start_block(t);
+// Advance the block ordinal to the one holding the cursor.
+void sync_block(tape_state* t) {
+  const TapeStream& m = t->media;
+  while (t->block + 1 < m.nblocks && m.blocks[t->block + 1].first_run <= t->run)
+    t->block++;
 }
 
-// One pulse boundary reached: toggle and load the next pulse (or advance).
-void pulse_done(tape_state* t) {
-  t->level ^= 1;
-  switch (t->phase) {
-    case PH_PILOT:
-      if (--t->pulses_left > 0) {
-        load_pulse(t, t->t_pilot);
-        return;
-      }
-      if (t->data_off == 0 && t->data_len == 0) {  // pure tone: no sync/data
-        next_block(t);
-        return;
-      }
-      t->phase = PH_SYNC1;
-      load_pulse(t, t->t_sync1);
-      return;
-    case PH_SYNC1:
-      t->phase = PH_SYNC2;
-      load_pulse(t, t->t_sync2);
-      return;
-    case PH_SYNC2:
-      t->phase = PH_DATA;
-      t->pulse_half = 0;
-      push_bit(t, (rd8(t, t->data_off) & 0x80) ? 1 : 0);  // first data bit
-      load_pulse(t, (rd8(t, t->data_off) & 0x80) ? t->t_bit1 : t->t_bit0);
-      return;
-    case PH_DATA: {
-      if (t->pulse_half == 0) {  // second half of the same bit
-        t->pulse_half = 1;
-        const uint8_t byte = rd8(t, t->data_off + t->byte_idx);
-        const uint8_t bit = (byte >> (7 - t->bit_idx)) & 1;
-        load_pulse(t, bit ? t->t_bit1 : t->t_bit0);
-        return;
-      }
-      t->pulse_half = 0;
-      t->bit_idx++;
-      const bool last_byte = (t->byte_idx + 1 == t->data_len);
-      const uint8_t bits_in_byte = last_byte ? t->last_used : 8;
-      if (t->bit_idx >= bits_in_byte) {
-        t->bit_idx = 0;
-        t->byte_idx++;
-      }
-      if (t->byte_idx >= t->data_len) {
-        next_block(t);
-        return;
-      }
-      const uint8_t byte = rd8(t, t->data_off + t->byte_idx);
-      const uint8_t bit = (byte >> (7 - t->bit_idx)) & 1;
-      push_bit(t, bit);  // next data bit
-      load_pulse(t, bit ? t->t_bit1 : t->t_bit0);
-      return;
-    }
-    case PH_PULSESEQ:
-      if (--t->pulses_left > 0) {
-        t->seq_idx++;
-        load_pulse(t, rd16(t, t->data_off + (t->seq_idx * 2u)));
-        return;
-      }
-      next_block(t);
-      return;
-    case PH_DIRECT: {
-      t->level ^= 1;  // undo the entry toggle: each sample SETS the level
-                      // from its own bit; the last one persists at block end
-      t->bit_idx++;
-      const bool last_byte = (t->byte_idx + 1 == t->data_len);
-      const uint8_t bits_in_byte = last_byte ? t->last_used : 8;
-      if (t->bit_idx >= bits_in_byte) {
-        t->bit_idx = 0;
-        t->byte_idx++;
-      }
-      if (t->byte_idx >= t->data_len) {
-        next_block(t);
-        return;
-      }
-      const uint8_t bit =
-          (rd8(t, t->data_off + t->byte_idx) >> (7 - t->bit_idx)) & 1;
-      t->level = bit;
-      push_bit(t, bit);
-      load_pulse(t, t->t_bit0);
-      return;
+// Put the run under the cursor on the wire (or act on its marker).
+void enter_run(tape_state* t) {
+  const TapeStream& m = t->media;
+  t->left = 0;
+  if (t->run >= m.nruns) {  // end of tape
+    t->playing = 0;
+    sync_block(t);
+    return;
+  }
+  const TapeRun r = m.runs[t->run];
+  t->level = (r & TAPE_RUN_LEVEL) ? 1 : 0;
+  if (run_cycles(r) == 0) {
+    if (r & TAPE_RUN_ERROR) {
+      t->error = 1;  // unknown block: stays under the cursor
+    } else {
+      t->run++;  // stop marker: PLAY resumes after it
     }
-    default:
-      return;
+    t->playing = 0;
+    sync_block(t);
+    return;
   }
+  t->left = run_cycles(r);
+  if (r & TAPE_RUN_BIT) push_bit(t, (r & TAPE_RUN_ONE) ? 1 : 0);
+  sync_block(t);
+}
+
+// The current run has played out: move to the next.
+void next_run(tape_state* t) {
+  t->cycle += run_cycles(t->media.runs[t->run]);
+  t->run++;
+  enter_run(t);
+}
+
+// PLAY: carry on mid-run, or enter the run under the cursor.
+void resume(tape_state* t) {
+  t->playing = 1;
+  if (t->left == 0) enter_run(t);
+}
+
+// Reposition at the start of `run` (tape time `cycle`) in `block`; entering
+// it settles past blocks that play nothing.
+void place(tape_state* t, uint32_t block, uint32_t run, uint64_t cycle) {
+  const uint8_t was_playing = t->playing;
+  t->block = block;
+  t->run = run;
+  t->cycle = cycle;
+  t->left = 0;
+  t->level = 0;
+  t->error = 0;
+  t->bit_wr = t->bit_rd = 0;  // clear the decoded-bit scope ring
+  t->playing = 0;
+  if (was_playing) resume(t);
 }
 
 void tape_tick(void* self, const Bus* __restrict in, Bus* __restrict out) {
@@ -359,18 +289,8 @@ void tape_tick(void* self, const Bus* __restrict in, Bus* __restrict out) {
     return;
   }
 
-  if (t->playing && in->tape.motor && t->phase != PH_IDLE) {
-    if (t->phase == PH_PAUSE) {
-      if (t->pause_cycles > 0) {
-        t->pause_cycles--;
-      } else {
-        start_block(t);
-      }
-    } else {
-      t->sub_remaining -= kSubPerCycle;
-      if (t->sub_remaining <= 0) pulse_done(t);
-    }
-  }
+  if (t->playing && in->tape.motor && t->left > 0 && --t->left == 0)
+    next_run(t);
   out->tape.rdata = t->level != 0;
 }
 
@@ -381,17 +301,18 @@ void tape_reset(void* self) {
 }
 
 size_t tape_dev_state_size(const void* /*unused*/) {
-  return offsetof(tape_state, cdt) + 1;
+  return offsetof(tape_state, media) + 1;
 }
+// Version 2: the run cursor (version 1 was the block-parser cursor).
 void tape_save(const void* self, void* buf) {
   uint8_t* b = static_cast<uint8_t*>(buf);
-  b[0] = 1;
-  std::memcpy(b + 1, self, offsetof(tape_state, cdt));
+  b[0] = 2;
+  std::memcpy(b + 1, self, offsetof(tape_state, media));
 }
 void tape_load(void* self, const void* buf) {
   const uint8_t* b = static_cast<const uint8_t*>(buf);
-  if (b[0] != 1) return;
-  std::memcpy(self, b + 1, offsetof(tape_state, cdt));
+  if (b[0] != 2) return;
+  std::memcpy(self, b + 1, offsetof(tape_state, media));
 }
 
 }  // namespace
@@ -453,6 +374,59 @@ uint32_t tape_cdt_block_len(const uint8_t* cdt, uint32_t len, uint32_t pos) {
   }
 }
 
+int tape_firmware_record(const uint8_t* cdt, uint32_t len, uint32_t pos,
+                         uint8_t sync, uint8_t* dst, uint32_t n,
+                         uint64_t* lead) {
+  if (cdt == nullptr || n == 0 || pos >= len) return -1;
+  const Compiler c{cdt, len, nullptr, 0};  // its readers only
+  const uint32_t body = pos + 1;
+  uint32_t data = 0, size = 0, pilot = 0;
+  uint16_t zero = 855, one = 1710, pilot_ts = 2168;
+  switch (c.rd8(pos)) {
+    case 0x10:
+      data = body + 4;
+      size = c.rd16(body + 2);
+      pilot = c.rd8(data) < 0x80 ? 8063 : 3223;
+      break;
+    case 0x11:
+      if (c.rd8(body + 12) != 8) return -1;  // a ragged last byte
+      data = body + 18;
+      size = c.rd24(body + 15);
+      pilot_ts = c.rd16(body);
+      pilot = c.rd16(body + 10);
+      zero = c.rd16(body + 6);
+      one = c.rd16(body + 8);
+      break;
+    default:
+      return -1;
+  }
+  // CAS READ times each bit against the leader: the cells must be the
+  // firmware's own shape, whatever the baud rate.
+  if (zero == 0 || 2u * one < 3u * zero || 2u * one > 5u * zero) return -1;
+  const uint32_t segs = (n + 255) / 256;
+  if (data > len || size > len - data || size < 1 + (segs * 258u) ||
+      c.rd8(data) != sync)
+    return -1;
+  for (uint32_t s = 0; s < segs; ++s) {
+    const uint32_t seg = data + 1 + (s * 258u);
+    uint16_t crc = 0xFFFF;  // X^16+X^12+X^5+1, complemented, high byte first
+    for (uint32_t i = 0; i < 256; ++i) {
+      crc = static_cast<uint16_t>(crc ^ (c.rd8(seg + i) << 8));
+      for (int b = 0; b < 8; ++b)
+        crc = static_cast<uint16_t>((crc & 0x8000) ? (crc << 1) ^ 0x1021
+                                                   : crc << 1);
+    }
+    if (static_cast<uint16_t>(~crc) !=
+        ((c.rd8(seg + 256) << 8) | c.rd8(seg + 257)))
+      return -1;
+  }
+  for (uint32_t i = 0; i < n; ++i)
+    dst[i] = c.rd8(data + 1 + ((i / 256) * 258u) + (i % 256));
+  if (lead != nullptr)
+    *lead = static_cast<uint64_t>(pilot) * pilot_ts * kSubPerTs / kSubPerCycle;
+  return 0;
+}
+
 Device tape_init(void* storage) {
   // NOLINTNEXTLINE(misc-const-correctness): pointer is stored in Device::self
   // (void*), cannot be const
@@ -470,80 +444,138 @@ Device tape_init(void* storage) {
 
 void tape_peek(const Device* dev, TapeRegs* out) {
   const tape_state* t = static_cast<const tape_state*>(dev->self);
-  out->attached = t->cdt != nullptr;
+  const TapeStream& m = t->media;
+  out->attached = t->attached;
   out->playing = t->playing;
   out->motor = t->motor_seen;
   out->level = t->level;
   out->line_mode = t->line_mode;
   out->error = t->error;
   out->block = t->block;
-  out->pos = t->pos;
+  out->pos = t->block < m.nblocks ? m.blocks[t->block].pos : kFirstBlock;
+  out->cycle = t->cycle;
+  if (t->left > 0) out->cycle += run_cycles(m.runs[t->run]) - t->left;
+  out->total = m.total;
 }
 
-int tape_attach_cdt(const Device* dev, const uint8_t* data, size_t len) {
-  tape_state* t = self_of(dev->self);
-  if (data == nullptr || len < 10 || std::memcmp(data, "ZXTape!\x1a", 8) != 0)
+int tape_compile_cdt(const uint8_t* cdt, size_t len, TapeRun* runs,
+                     uint32_t runs_cap, TapeBlock* blocks, uint32_t blocks_cap,
+                     TapeStream* out) {
+  if (cdt == nullptr || len < kFirstBlock ||
+      std::memcmp(cdt, "ZXTape!\x1a", 8) != 0)
     return -1;
-  t->cdt = data;
-  t->len = len;
+  Compiler c{cdt, static_cast<uint32_t>(len < UINT32_MAX ? len : UINT32_MAX),
+             runs, runs_cap};
+  uint32_t nblocks = 0;
+  for (uint32_t pos = kFirstBlock; pos < c.len;) {
+    if (nblocks < blocks_cap)
+      blocks[nblocks] = TapeBlock{c.nruns, pos, c.cycle};
+    nblocks++;
+    c.block(pos);
+    // The same sizing as the host block table, so ordinals agree; past an
+    // unknown block too, so seeking beyond it works.
+    const uint32_t sz = tape_cdt_block_len(cdt, c.len, pos);
+    if (sz == 0 || pos + sz <= pos) break;  // unsizable / overflow guard
+    pos += sz;
+  }
+  // The last pulse's closing edge: a STOP marker carries it onto the wire.
+  if (c.nruns > 0 && !c.stopped) c.put(Compiler::level_bit(c.level));
+  *out = TapeStream{runs, c.nruns, blocks, nblocks, c.cycle};
+  return (c.nruns > runs_cap || nblocks > blocks_cap) ? -2 : 0;
+}
+
+void tape_attach_stream(const Device* dev, const TapeStream* stream) {
+  tape_state* t = self_of(dev->self);
+  t->media = *stream;
+  t->attached = 1;
   tape_rewind(dev);
-  return 0;
 }
 
 void tape_eject(const Device* dev) {
   tape_state* t = self_of(dev->self);
-  t->cdt = nullptr;
-  t->len = 0;
-  stop(t);
+  t->media = TapeStream{};
+  t->attached = 0;
+  t->run = t->left = t->block = 0;
+  t->cycle = 0;
+  t->playing = 0;
   t->error = 0;
 }
 
 void tape_play(const Device* dev, int on) {
   tape_state* t = self_of(dev->self);
-  if (on && !t->playing && t->cdt != nullptr) {
-    t->playing = 1;
-    if (t->phase == PH_IDLE) start_block(t);
+  if (on && !t->playing && t->attached) {
+    resume(t);
   } else if (!on) {
     t->playing = 0;
   }
 }
 
 void tape_rewind(const Device* dev) {
-  tape_state* t = self_of(dev->self);
-  const uint8_t was_playing = t->playing;
-  t->pos = 10;  // past "ZXTape!\x1A" + version
-  t->block = 0;
-  t->phase = PH_IDLE;
-  t->level = 0;
-  t->error = 0;
-  t->bit_wr = t->bit_rd = 0;  // clear the decoded-bit scope ring
-  t->playing = 0;
-  if (was_playing) tape_play(dev, 1);
+  place(self_of(dev->self), 0, 0, 0);
 }
 
 void tape_seek(const Device* dev, uint32_t block_ordinal) {
   tape_state* t = self_of(dev->self);
-  if (t->cdt == nullptr) return;
-  // Walk the deck's OWN cdt from the first block, skipping `block_ordinal`
-  // blocks by size (layout-independent: the legacy pbTapeImage strips the
-  // 10-byte header, so a byte offset taken from it lands 10 bytes short here).
-  uint32_t pos = 10, blk = 0;  // 10 = past "ZXTape!\x1A" + version
-  for (; blk < block_ordinal; ++blk) {
-    if (pos >= t->len) break;
-    const uint32_t sz = block_len(t, pos);
-    if (sz == 0 || pos + sz <= pos) break;  // unsizable / overflow guard
-    pos += sz;
+  const TapeStream& m = t->media;
+  if (!t->attached || block_ordinal >= m.nblocks) return;
+  const TapeBlock& b = m.blocks[block_ordinal];
+  place(t, block_ordinal, b.first_run, b.start);
+}
+
+void tape_seek_cycle(const Device* dev, uint64_t cycle) {
+  tape_state* t = self_of(dev->self);
+  const TapeStream& m = t->media;
+  if (!t->attached || m.nblocks == 0) return;
+  // The last block starting at or before `cycle`, then its runs.
+  uint32_t lo = 0, hi = m.nblocks;
+  while (hi - lo > 1) {
+    const uint32_t mid = lo + ((hi - lo) / 2);
+    if (m.blocks[mid].start <= cycle) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
   }
-  if (blk != block_ordinal || pos < 10 || pos >= t->len) return;  // unreachable
+  uint32_t run = m.blocks[lo].first_run;
+  uint64_t at = m.blocks[lo].start;
+  while (run < m.nruns && at + run_cycles(m.runs[run]) <= cycle)
+    at += run_cycles(m.runs[run++]);
   const uint8_t was_playing = t->playing;
-  t->pos = pos;
-  t->block = block_ordinal;
-  t->phase = PH_IDLE;
-  t->level = 0;
-  t->error = 0;
-  t->bit_wr = t->bit_rd = 0;  // clear the decoded-bit scope ring
   t->playing = 0;
-  if (was_playing) tape_play(dev, 1);  // start_block enters block_ordinal
+  place(t, lo, run, at);
+  // Land mid-run: enter it (no marker has cycles) and spend the difference.
+  if (run < m.nruns && cycle > at) {
+    enter_run(t);
+    t->left -= static_cast<uint32_t>(cycle - at);
+  }
+  if (was_playing) resume(t);
+}
+
+uint64_t tape_cycles_to_edge(const Device* dev) {
+  const tape_state* t = static_cast<const tape_state*>(dev->self);
+  const TapeStream& m = t->media;
+  if (t->line_mode || !t->playing || t->left == 0) return 0;
+  uint64_t n = t->left;
+  for (uint32_t r = t->run + 1; r < m.nruns; ++r) {
+    const TapeRun w = m.runs[r];
+    if (run_cycles(w) == 0 || ((w & TAPE_RUN_LEVEL) != 0) != (t->level != 0))
+      break;
+    n += run_cycles(w);
+  }
+  return n;
+}
+
+void tape_advance(const Device* dev, uint64_t cycles) {
+  tape_state* t = self_of(dev->self);
+  if (t->line_mode) return;
+  while (cycles > 0 && t->playing && t->left > 0) {
+    if (cycles < t->left) {
+      t->left -= static_cast<uint32_t>(cycles);
+      return;
+    }
+    cycles -= t->left;
+    next_run(t);
+  }
 }
 
 // Drain decoded data bits recorded since the last call (host BITS-view scope):
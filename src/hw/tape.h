@@ -1,6 +1,7 @@
 /* tape.h — the cassette deck as a Device: CDT/TZX playback + live line-in.
  * THE SPEC: docs/hardware/tape-device.md. Drives tape.rdata; reads tape.motor.
- * Media is a caller-owned CDT buffer (live wiring, never serialized). */
+ * Media is a caller-owned pulse stream compiled from the CDT at insert time
+ * (live wiring, never serialized). */
 #ifndef KONCPC_HW_TAPE_H
 #define KONCPC_HW_TAPE_H
 
@@ -21,27 +22,85 @@ typedef struct TapeRegs {
   uint8_t line_mode; /* live line-in follows tape_line_level() */
   uint8_t error;     /* unknown block stopped playback */
   uint32_t block;    /* current CDT block ordinal (0-based) */
-  uint32_t pos;      /* byte offset into the CDT buffer */
+  uint32_t pos;      /* byte offset of that block's header in the CDT */
+  uint64_t cycle;    /* master cycles of tape played before the cursor */
+  uint64_t total;    /* master cycles of the whole tape */
 } TapeRegs;
 
 size_t tape_state_size(void);
 Device tape_init(void* storage);
 void tape_peek(const Device* dev, TapeRegs* out);
 
-/* Insert a CDT/TZX (caller-owned; must outlive the attachment). Returns 0,
- * -1 if the header is not "ZXTape!\x1A". Rewinds. */
-int tape_attach_cdt(const Device* dev, const uint8_t* data, size_t len);
+/* --- The compiled pulse stream (tape-device.md §3) ---
+ *
+ * A CDT is compiled once, at insert time, into runs: each run holds rdata at
+ * one level for a whole number of master cycles (the 7/32 t-state residual
+ * carries from run to run, so the stream never drifts). A run of ZERO cycles
+ * is a marker that sets the level and stops the deck: STOP (a 0x20 pause of
+ * 0 ms, and the end of the tape — the cursor moves past it) or ERROR (an
+ * unknown block — the cursor stays). The block index has one entry per CDT
+ * block, metadata included, with the block's first run and its start time,
+ * so seeking is O(1). */
+typedef uint32_t TapeRun;
+enum : uint32_t {
+  TAPE_RUN_CYCLES = 0x1FFFFFFFu, /* master cycles (long pauses split) */
+  TAPE_RUN_LEVEL = 1u << 29,     /* rdata during the run */
+  TAPE_RUN_BIT = 1u << 30,       /* a data bit starts here (BITS scope) */
+  TAPE_RUN_ONE = 1u << 31,       /* ... and its value is 1 */
+  TAPE_RUN_ERROR = 1u << 30,     /* on a marker: ERROR, not STOP */
+};
+
+typedef struct TapeBlock {
+  uint32_t first_run; /* index of the block's first run (== the next block's
+                         when it plays nothing) */
+  uint32_t pos;       /* byte offset of the block header in the CDT */
+  uint64_t start;     /* master cycles of tape before the block */
+} TapeBlock;
+
+typedef struct TapeStream {
+  const TapeRun* runs;
+  uint32_t nruns;
+  const TapeBlock* blocks;
+  uint32_t nblocks;
+  uint64_t total; /* master cycles of the whole tape */
+} TapeStream;
+
+/* Compile a CDT/TZX into caller-owned `runs` / `blocks` and describe the
+ * result in `out`. Returns 0; -1 if the header is not "ZXTape!\x1A"; -2 if a
+ * capacity is too small, with out->nruns / out->nblocks set to the sizes
+ * needed (so compiling once with zero capacities sizes the buffers). */
+int tape_compile_cdt(const uint8_t* cdt, size_t len, TapeRun* runs,
+                     uint32_t runs_cap, TapeBlock* blocks, uint32_t blocks_cap,
+                     TapeStream* out);
+
+/* Insert a compiled tape (the arrays are caller-owned and must outlive the
+ * attachment). Rewinds. */
+void tape_attach_stream(const Device* dev, const TapeStream* stream);
 void tape_eject(const Device* dev);
 
 /* The deck's PLAY button (the firmware owns the motor relay separately). */
 void tape_play(const Device* dev, int on);
 void tape_rewind(const Device* dev);
 
-/* Seek the deck to the Nth CDT block: walks the deck's own cdt by block size to
- * that ordinal (layout-independent — do NOT pass a legacy pbTapeImage offset).
- * Playback resets to the block's start; if PLAY was down it resumes there.
- * Out-of-range ordinals are ignored. */
+/* Seek the deck to the Nth CDT block through the block index (O(1);
+ * ordinals match tape_cdt_block_len walks — do NOT pass a legacy pbTapeImage
+ * offset). Playback resets to the block's start; if PLAY was down it resumes
+ * there. Out-of-range ordinals are ignored. */
 void tape_seek(const Device* dev, uint32_t block_ordinal);
+/* Seek to a time: `cycle` master cycles into the tape (clamped to its end),
+ * mid-pulse if that is where it falls. The position scrubber's primitive. */
+void tape_seek_cycle(const Device* dev, uint64_t cycle);
+
+/* Clock-wake contract: master cycles of motor-on play before rdata next
+ * changes level, or before the deck stops on a marker / the end of the tape
+ * (0 = nothing scheduled: not playing, in line-in mode, or at the end). A
+ * scheduler may skip the deck's tick for fewer cycles than that — the wire
+ * holds still — and re-apply them with tape_advance() before the next real
+ * tick. Walks the stream forward over same-level runs. */
+uint64_t tape_cycles_to_edge(const Device* dev);
+/* Play `cycles` motor-on master cycles at once, exactly as that many ticks
+ * would (bits still reach the scope ring). */
+void tape_advance(const Device* dev, uint64_t cycles);
 
 /* Byte length of the CDT block at `pos` in a raw CDT/TZX buffer — the SAME
  * sizing the deck walks with, exported so the host's block table
@@ -49,6 +108,18 @@ void tape_seek(const Device* dev, uint32_t block_ordinal);
  * for an unsizable position (walkers must stop). */
 uint32_t tape_cdt_block_len(const uint8_t* cdt, uint32_t len, uint32_t pos);
 
+/* The flash loader's view of a block (tape-device.md §8): if the CDT block
+ * at `pos` is a firmware record CAS READ would accept for sync byte `sync`
+ * and `n` bytes — a 0x10/0x11 block with plain bit cells (a one about twice
+ * a zero), `sync` first, then every 256-byte segment the read spans with its
+ * complemented CRC-16 intact — copy the first `n` payload bytes to `dst` and
+ * return 0. `lead` (optional) receives the pilot tone's length in master
+ * cycles. Returns -1 for anything else (custom, turbo-shaped or damaged
+ * blocks play as pulses). */
+int tape_firmware_record(const uint8_t* cdt, uint32_t len, uint32_t pos,
+                         uint8_t sync, uint8_t* dst, uint32_t n,
+                         uint64_t* lead);
+
 /* Drain decoded data bits recorded since the last call (host BITS-view scope):
  * copies up to `max` bits (each 0/1) into `out`, oldest first, returns the
  * count. The deck decodes these while playing data blocks. */
@@ -168,6 +168,13 @@ namespace {
 // and the border width is mode-independent.
 constexpr int kVisChars = 48;
 constexpr int kVBackPorch = 36;
+// Active-relative X span a sprite can cover: 10-bit X plus 16 px at ×4.
+constexpr int kSprLayerW = 1024 + (16 * 4);
+// Render-less (hash-only) mode: the running frame hash starts from the 32-bit
+// FNV offset basis and folds one word per step with the FNV prime.
+constexpr uint32_t kHashSeed = 2166136261u;
+constexpr uint32_t kHashPrime = 16777619u;
+constexpr int kMaxCellW = 64;  // hs_cell width: canvases up to 48·64 px wide
 
 struct video_state {
   const Device* gate_array = nullptr;
@@ -185,6 +192,34 @@ struct video_state {
   uint8_t cc_border[48] = {};       // one border cell (16 px), built per call
   uint32_t snap_gen = 0xFFFFFFFF;   // asic_vid_gen of the held line snapshot
                                     // (F8 R17); sentinel = no snapshot held
+  // Per-line sprite layer: the line's culled candidates (lc_* below) resolved
+  // ONCE into composited 4-bit sprite colours per active-relative X, priority
+  // already applied — so a cell reads one byte per pixel instead of walking
+  // its candidates through asic_vid_sprite_pixel. Built lazily by the first
+  // sprite-overlapped cell of a line; invalid after every plus_refresh_line
+  // and whenever a sprite pixel write moves asic_vid_sprite_gen (pixels are
+  // read live, so a mid-line write must show from the next cell on). Derived
+  // data, so it sits above beam_col with the other caches.
+  uint8_t sl_px[kSprLayerW] = {};  // 0 = no sprite at this X
+  int sl_lo = 0, sl_hi = 0;        // extent the last build wrote (to clear)
+  uint32_t sl_gen = 0;             // asic_vid_sprite_gen at the last build
+  bool sl_valid = false;
+  // Render-less mode (video_set_hash_only): the beam, edges and fetch latch
+  // run exactly as painted, but each visible cell folds its render INPUTS
+  // (position, DISPEN, mode, the two fetched bytes, the ink set) into a
+  // running hash instead of writing pixels. A run-local observation, not
+  // machine state — a load restarts it mid-frame — so it stays out of the
+  // serialized tail with the caches.
+  bool hash_only = false;
+  uint32_t hs_run = kHashSeed;   // this frame so far
+  uint32_t hs_frame = kHashSeed;  // the last completed frame (VSYNC rise)
+  uint8_t hs_ink[17] = {};        // inks the fingerprint below was taken of
+  uint32_t hs_ink_fp = kHashSeed;
+  bool hs_ink_valid = false;
+  uint8_t hs_cell[kMaxCellW * 3] = {};  // Plus cells paint here, then fold
+  // Frame skipping (video_set_skip_paint): visible cells neither fetch nor
+  // paint; the framebuffer keeps the last painted frame. Hash-only wins.
+  bool skip_paint = false;
   int beam_col = 0;    // visible char column of the beam (0..kVisChars-1)
   int beam_row = 0;    // visible scanline of the beam (0..fb_h-1)
   uint8_t fetch0 = 0;  // byte 0 of the character, latched off the RAM fetch bus
@@ -223,6 +258,71 @@ struct video_state {
 
 video_state* vself(void* self) { return static_cast<video_state*>(self); }
 
+void hash_fold(uint32_t& h, uint32_t word) { h = (h ^ word) * kHashPrime; }
+
+// Where a visible cell paints: the framebuffer row, or — render-less — the
+// one-cell scratch the hash folds from.
+uint8_t* cell_dst(video_state* v, int x0) {
+  if (v->hash_only) return v->hs_cell;
+  return v->fb + (((static_cast<size_t>(v->beam_row) * v->fb_w) + x0) * 3);
+}
+
+// A visible cell under frame skipping: nothing to paint, but the Plus sprite
+// Y origin is frame state the painted frames after this one read, so it is
+// still established here.
+bool cell_skipped(video_state* v, bool dispen) {
+  if (!v->skip_paint || v->hash_only) return false;
+  if (v->plus_active && dispen && v->first_active_row < 0)
+    v->first_active_row = v->beam_row;
+  return true;
+}
+
+// VSYNC rise: the running hash becomes the frame's, and restarts.
+void hash_frame_edge(video_state* v) {
+  v->hs_frame = v->hs_run;
+  v->hs_run = kHashSeed;
+}
+
+// The cell's beam position leads every fold, so the same content at a
+// different place (a moved R2/R7, a scrolled split) hashes differently.
+void hash_cell_pos(video_state* v) {
+  hash_fold(v->hs_run, (static_cast<uint32_t>(v->beam_row & 0xFFFF) << 8) |
+                           static_cast<uint32_t>(v->beam_col & 0xFF));
+}
+
+// Classic cell, render-less: the two fetched bytes + mode under the current
+// ink set, or the border ink. The inks fold as a fingerprint re-taken only
+// when they move (a 17-byte compare per cell, not a per-pixel lookup), so
+// the hash tracks render state rather than pixels — an unused ink changing
+// still changes it, which a regression assertion wants anyway.
+void hash_cell_classic(video_state* v, const GateArrayRegs* g, uint8_t mode,
+                       bool dispen, uint8_t byte0, uint8_t byte1) {
+  hash_cell_pos(v);
+  if (!dispen) {
+    hash_fold(v->hs_run, 0x100u | (g->ink[16] & 0x1F));
+    return;
+  }
+  if (!v->hs_ink_valid || std::memcmp(v->hs_ink, g->ink, 17) != 0) {
+    std::memcpy(v->hs_ink, g->ink, 17);
+    v->hs_ink_fp = kHashSeed;
+    for (unsigned char k : v->hs_ink) hash_fold(v->hs_ink_fp, k & 0x1F);
+    v->hs_ink_valid = true;
+  }
+  hash_fold(v->hs_run, 0x01000000u | (static_cast<uint32_t>(mode & 3) << 16) |
+                           (static_cast<uint32_t>(byte0) << 8) | byte1);
+  hash_fold(v->hs_run, v->hs_ink_fp);
+}
+
+// Plus cell, render-less: the compositor painted into hs_cell (sprites and
+// the line's 12-bit palette are too much state to fingerprint); fold it.
+void hash_cell_plus(video_state* v, int char_w) {
+  hash_cell_pos(v);
+  const uint8_t* p = v->hs_cell;
+  for (int i = 0; i < char_w; ++i, p += 3)
+    hash_fold(v->hs_run, (static_cast<uint32_t>(p[0]) << 16) |
+                             (static_cast<uint32_t>(p[1]) << 8) | p[2]);
+}
+
 // Refresh the per-scanline Plus snapshot (sprite attributes + 12-bit palette).
 // Reading once per line means mid-frame register changes land on the next line
 // — the pin-level analog of a raster split.
@@ -278,6 +378,7 @@ void plus_refresh_line(video_state* v) {
   // beam_row - first_active_row is 0 either way.
   const int py =
       (v->first_active_row < 0) ? 0 : v->beam_row - v->first_active_row;
+  v->sl_valid = false;  // new candidate set — the layer rebuilds on demand
   v->lc_n = 0;
   for (int i = 0; i < 16; ++i) {
     const int mx = v->spr_mx[i], my = v->spr_my[i];
@@ -297,6 +398,34 @@ void plus_refresh_line(video_state* v) {
   }
 }
 
+// Resolve the line's sprite candidates into sl_px: each candidate's pixel row
+// is fetched once and magnified into its span. Painted lowest priority first,
+// opaque pixels only, so sprite 0 lands last and wins — the same first-opaque-
+// in-ascending-order rule the per-pixel candidate walk applied.
+void plus_build_sprite_layer(video_state* v) {
+  if (v->sl_hi > v->sl_lo)
+    std::memset(v->sl_px + v->sl_lo, 0,
+                static_cast<size_t>(v->sl_hi - v->sl_lo));
+  int lo = kSprLayerW, hi = 0;
+  for (int c = v->lc_n - 1; c >= 0; --c) {
+    uint8_t row[16];
+    asic_vid_sprite_row(v->asic, v->lc_id[c], v->lc_row[c], row);
+    const int mx = 1 << v->lc_shift[c];
+    const int sx = v->lc_sx[c];
+    for (int col = 0; col < 16; ++col) {
+      if (row[col] == 0) continue;  // transparent: lower sprites show through
+      uint8_t* dst = v->sl_px + sx + (col * mx);
+      for (int m = 0; m < mx; ++m) dst[m] = row[col];
+    }
+    if (sx < lo) lo = sx;
+    if (v->lc_xend[c] > hi) hi = v->lc_xend[c];
+  }
+  v->sl_lo = lo;
+  v->sl_hi = hi;
+  v->sl_gen = asic_vid_sprite_gen(v->asic);
+  v->sl_valid = true;
+}
+
 // Map a final palette index (0..31) to RGB. A programmed 12-bit entry expands
 // its 4-bit components to 8-bit (×17: 0x0→0, 0xF→255); an unprogrammed screen/
 // border entry (≤16) falls through to the classic ink colour underneath; an
@@ -394,8 +523,7 @@ void render_cell_plus(video_state* v, const GateArrayRegs* g, uint8_t mode,
                       bool dispen, uint8_t byte1, int x0, int char_w) {
   if (dispen && v->first_active_row < 0)
     v->first_active_row = v->beam_row;  // sprite Y origin: first active line
-  uint8_t* px =
-      v->fb + (((static_cast<size_t>(v->beam_row) * v->fb_w) + x0) * 3);
+  uint8_t* px = cell_dst(v, x0);
   if (!dispen) {  // border — palette entry 16 (no sprites over border)
     uint8_t r, gg, b;
     if (v->pal_set[16]) {  // line-expanded (the common programmed case)
@@ -419,15 +547,18 @@ void render_cell_plus(video_state* v, const GateArrayRegs* g, uint8_t mode,
   const int hs = v->hscroll;  // horizontal soft scroll (background only)
 
   // Sprite cull, X half — the Y half ran once per line in plus_refresh_line
-  // (the snapshot is line-constant, so this is byte-identical to the old
-  // per-cell 16-sprite scan). Ascending order preserves sprite-0-wins.
-  int cand[16];
-  int ncand = 0;
+  // (the snapshot is line-constant). Only decides whether the cell needs the
+  // sprite layer at all; the layer itself holds the resolved priorities.
+  bool sprites = false;
   const int cell_x1 = px_xbase + char_w;
   for (int c = 0; c < v->lc_n; ++c) {
     if (cell_x1 <= v->lc_sx[c] || px_xbase >= v->lc_xend[c]) continue;
-    cand[ncand++] = c;
+    sprites = true;
+    break;
   }
+  if (sprites &&
+      (!v->sl_valid || v->sl_gen != asic_vid_sprite_gen(v->asic)))
+    plus_build_sprite_layer(v);
 
   // Fast path (F8 R12): no sprite overlaps this cell and no soft scroll —
   // the 16 pixels are two straight byte paints. pal_set-pure halves cache
@@ -435,7 +566,7 @@ void render_cell_plus(video_state* v, const GateArrayRegs* g, uint8_t mode,
   // impure halves (live-ink fallback) repaint every cell. hscroll is
   // line-constant, so with hs == 0 prev_pen is never read before the next
   // HSYNC-fall reset — its carry update is skipped.
-  if (hs == 0 && ncand == 0 && char_w == 16) {
+  if (hs == 0 && !sprites && char_w == 16) {
     const uint8_t bytes2[2] = {v->fetch0, byte1};
     for (int k = 0; k < 2; ++k) {
       const uint8_t byte = bytes2[k];
@@ -466,21 +597,10 @@ void render_cell_plus(video_state* v, const GateArrayRegs* g, uint8_t mode,
     const int src = lx - hs;
     int index = (src >= 0) ? cell_pen[src < 16 ? src : 15]
                            : v->prev_pen[(16 + src) & 0x0F];
-    for (int cc = 0; cc < ncand; ++cc) {
-      // The per-pixel X test stays (the cell overlaps the sprite, but this
-      // pixel may fall outside it); first opaque candidate wins (sprite 0
-      // keeps the highest priority).
-      const int c = cand[cc];
-      const int dx = (px_xbase + lx) - v->lc_sx[c];
-      if (dx < 0) continue;
-      const int col = dx >> v->lc_shift[c];
-      if (col >= 16) continue;
-      const uint8_t s =
-          asic_vid_sprite_pixel(v->asic, v->lc_id[c], col, v->lc_row[c]);
-      if (s) {
-        index = 16 + s;
-        break;
-      }
+    if (sprites) {  // the sprite layer is not scrolled
+      const int sx = px_xbase + lx;
+      const uint8_t s = (sx < kSprLayerW) ? v->sl_px[sx] : 0;
+      if (s) index = 16 + s;
     }
     if (v->pal_set[index]) {  // line-expanded (the common programmed case)
       px[0] = v->line_rgb[index][0];
@@ -565,12 +685,17 @@ void render_char(video_state* v, const Bus* in, uint8_t byte1) {
   const bool visible = !in->vid.hsync && !in->vid.vsync && v->beam_col >= 0 &&
                        v->beam_col < kVisChars && v->beam_row >= 0 &&
                        v->beam_row < v->fb_h;
-  if (!visible) return;
+  if (!visible || cell_skipped(v, in->vid.dispen)) return;
   GateArrayRegs g{};
   ga_peek(v->gate_array, &g);
   const int x0 = v->beam_col * char_w;
   if (v->plus_active) {  // Plus: 12-bit palette + per-pixel sprite compositing
     render_cell_plus(v, &g, g.mode, in->vid.dispen, byte1, x0, char_w);
+    if (v->hash_only) hash_cell_plus(v, char_w);
+    return;
+  }
+  if (v->hash_only) {
+    hash_cell_classic(v, &g, g.mode, in->vid.dispen, v->fetch0, byte1);
     return;
   }
   render_cell_classic(v, &g, g.mode, in->vid.dispen, v->fetch0, byte1, x0,
@@ -580,7 +705,7 @@ void render_char(video_state* v, const Bus* in, uint8_t byte1) {
 void video_tick(void* self, const Bus* __restrict in, Bus* __restrict out) {
   (void)out;
   video_state* v = vself(self);
-  if (!v->gate_array || !v->fb) return;
+  if (!v->gate_array || (!v->fb && !v->hash_only)) return;
 
   const bool hsync = in->vid.hsync, vsync = in->vid.vsync;
   const bool hs_rise = hsync && !v->hsync_prev;
@@ -591,6 +716,7 @@ void video_tick(void* self, const Bus* __restrict in, Bus* __restrict out) {
 
   if (vs_rise) {
     v->frames++;
+    if (v->hash_only) hash_frame_edge(v);
     v->beam_row = -kVBackPorch;
     v->first_active_row = -1;  // sprite Y origin re-established each frame
   }  // new frame
@@ -648,6 +774,7 @@ void video_load(void* self, const void* buf) {
   const uint8_t* b = static_cast<const uint8_t*>(buf);
   if (b[0] != 1) return;
   std::memcpy(&v->beam_col, b + 1, kVideoLogicalLen);  // wiring untouched
+  v->sl_valid = false;  // the loaded line cull owns no layer yet
 }
 
 }  // namespace
@@ -678,6 +805,26 @@ void video_attach_asic(const Device* vid, const Device* asic) {
   static_cast<video_state*>(vid->self)->asic = asic;
 }
 
+void video_set_hash_only(const Device* vid, int on) {
+  video_state* v = vself(vid->self);
+  if (v->hash_only == (on != 0)) return;
+  v->hash_only = on != 0;
+  v->hs_run = v->hs_frame = kHashSeed;  // the first full frame is the first
+  v->hs_ink_valid = false;              // hash that means anything
+}
+
+void video_set_skip_paint(const Device* vid, int on) {
+  vself(vid->self)->skip_paint = on != 0;
+}
+
+int video_hash_only(const Device* vid) {
+  return static_cast<const video_state*>(vid->self)->hash_only ? 1 : 0;
+}
+
+uint32_t video_frame_hash(const Device* vid) {
+  return static_cast<const video_state*>(vid->self)->hs_frame;
+}
+
 void video_peek(const Device* vid, VideoRegs* out) {
   const video_state* v = static_cast<const video_state*>(vid->self);
   out->mode = 0;
@@ -688,7 +835,7 @@ void video_peek(const Device* vid, VideoRegs* out) {
 void video_batch_cells(const Device* vid, const uint8_t* ram,
                        const CrtcCharView* views, int count) {
   video_state* v = vself(vid->self);
-  if (!v->gate_array || !v->fb || count <= 0) return;
+  if (!v->gate_array || (!v->fb && !v->hash_only) || count <= 0) return;
   // Inks are constant across the run — any write catches the renderer up
   // first (catch-up-then-apply), so one peek covers every cell. The screen
   // MODE is not: its latch moves at HSYNCs inside the run, which is why each
@@ -701,7 +848,7 @@ void video_batch_cells(const Device* vid, const uint8_t* ram,
   // (the one pixel-layout definition), so hits are byte-identical to the
   // uncached paint. Geometry-gated to the native 16-px cell; other canvas
   // widths (none ship) fall back to the direct painter.
-  const bool cc_on = !v->plus_active && char_w == 16;
+  const bool cc_on = !v->plus_active && char_w == 16 && !v->hash_only;
   if (cc_on) {
     std::memset(v->cc_valid, 0, sizeof(v->cc_valid));
     uint8_t r, gg, b;
@@ -718,6 +865,7 @@ void video_batch_cells(const Device* vid, const uint8_t* ram,
       // Beam movement — video_tick's edge rules verbatim (VSYNC wins).
       if (view.edges & (1u << CRTC_EDGE_VSYNC_RISE)) {
         v->frames++;
+        if (v->hash_only) hash_frame_edge(v);
         v->beam_row = -kVBackPorch;
         v->first_active_row = -1;
       } else if (view.edges & (1u << CRTC_EDGE_HSYNC_RISE)) {
@@ -739,7 +887,8 @@ void video_batch_cells(const Device* vid, const uint8_t* ram,
                          !(view.levels & CRTC_LVL_VSYNC) && v->beam_col >= 0 &&
                          v->beam_col < kVisChars && v->beam_row >= 0 &&
                          v->beam_row < v->fb_h;
-    if (visible) {
+    if (visible &&
+        !cell_skipped(v, (view.levels & CRTC_LVL_DISPEN) != 0)) {
       // The hardware fetches every microsecond regardless, but the byte-0
       // latch is only OBSERVABLE at a drain boundary — the assignment after
       // this loop reproduces the final latch, so per-view fetches (address
@@ -755,6 +904,9 @@ void video_batch_cells(const Device* vid, const uint8_t* ram,
         if (active) v->fetch0 = byte0;  // render_cell_plus reads the latch
         render_cell_plus(v, &g, view.mode, active, byte1, v->beam_col * char_w,
                          char_w);
+        if (v->hash_only) hash_cell_plus(v, char_w);
+      } else if (v->hash_only) {
+        hash_cell_classic(v, &g, view.mode, active, byte0, byte1);
       } else if (cc_on) {
         uint8_t* px = v->fb + (((static_cast<size_t>(v->beam_row) * v->fb_w) +
                                 (static_cast<size_t>(v->beam_col) * 16)) *
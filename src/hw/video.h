@@ -78,6 +78,26 @@ void video_attach_asic(const Device* vid, const Device* asic);
 
 void video_peek(const Device* vid, VideoRegs* out);
 
+/* Render-less mode (CI hash runs). The Device keeps its full beam timing and
+ * bus behaviour — sync edges, the fetch latch, frame counting — but paints no
+ * pixels: each visible cell instead folds its render inputs (beam position,
+ * DISPEN, mode, the two fetched bytes and the ink set; Plus cells fold their
+ * composited colours) into a running FNV-1a hash, published at every VSYNC
+ * rise. Both execution shapes fold the same cells in the same order, so the
+ * hash is tier-independent. The framebuffer may be null while this is on
+ * (w/h still bound the visible window). Toggling restarts the hash. */
+void video_set_hash_only(const Device* vid, int on);
+int video_hash_only(const Device* vid);
+/* Hash of the last completed frame (render-less mode only). */
+uint32_t video_frame_hash(const Device* vid);
+
+/* Frame skipping (uncapped / warp runs): while on, visible cells are neither
+ * fetched nor painted — beam timing, edges, frame counting and every piece of
+ * saved state run exactly as painted — so the framebuffer holds the last
+ * painted frame. Meant to be flipped at frame boundaries; a mid-frame flip
+ * leaves a partly painted frame. Ignored while render-less mode is on. */
+void video_set_skip_paint(const Device* vid, int on);
+
 /* --- Fast-tier catch-up renderer (video-device.md §batch, plan §4.4) ---
  *
  * Consume a run of CRTC character views (crtc.h CrtcCharView — the chain
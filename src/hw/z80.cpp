@@ -2633,4 +2633,21 @@ void z80_poke(const Device* dev, const Z80Regs* in) {
   z->instr_count = 0;
 }
 
+void z80_redirect(const Device* dev, const Z80Regs* in) {
+  z80_state* z = static_cast<z80_state*>(dev->self);
+  z->af.v = in->af;
+  z->bc.v = in->bc;
+  z->de.v = in->de;
+  z->hl.v = in->hl;
+  z->af2.v = in->af_;
+  z->bc2.v = in->bc_;
+  z->de2.v = in->de_;
+  z->hl2.v = in->hl_;
+  z->ix.v = in->ix;
+  z->iy.v = in->iy;
+  z->sp.v = in->sp;
+  z->pc.v = in->pc;
+  z->wz.v = in->wz;
+}
+
 }  // extern "C"
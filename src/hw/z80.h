@@ -38,6 +38,13 @@ void z80_peek(const Device* dev, Z80Regs* out);
  * Only the register/flag/interrupt fields of *in are consumed. */
 void z80_poke(const Device* dev, const Z80Regs* in);
 
+/* At a clean instruction boundary (z80_batch_ready), load the register pairs
+ * (af..wz of *in: the main and alternate sets, IX/IY, SP, PC) WITHOUT
+ * resetting the engine: tstates, instr_count, I/R, the interrupt mode and
+ * latches all carry on. For machine-level traps that complete a ROM routine
+ * mid-frame (the tape flash loader returning from CAS READ). */
+void z80_redirect(const Device* dev, const Z80Regs* in);
+
 /* --- Batch (instruction-granularity) execution — the RunTier::Fast driver.
  *
  * Runs the SAME micro-op sequences as the per-cycle engine (dual-mode, not a
@@ -53,6 +53,7 @@ extern byte* pbTapeImageEnd;
 void tape_scan_blocks() {
   imgui_state.tape_block_offsets.clear();
   imgui_state.tape_current_block = 0;
+  imgui_state.tape_ms = imgui_state.tape_total_ms = 0;
   if (pbTapeImage.empty()) return;
 
   byte* base = pbTapeImage.data();
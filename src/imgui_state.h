@@ -85,11 +85,11 @@ struct ImGuiUIState {
   float z80_time_avg_us = 0.0f;
 
   // Audio diagnostics (updated each second)
-  int audio_underruns = 0;          // times SDL queue was empty when we pushed
-  int audio_near_underruns = 0;     // times queue was below 1 buffer
+  int audio_underruns = 0;          // times the device found the ring empty
+  int audio_near_underruns = 0;     // pushes with the ring below half target
   int audio_pushes = 0;             // total pushes this second
-  float audio_queue_avg_ms = 0.0f;  // average queue depth in ms
-  float audio_queue_min_ms = 0.0f;  // minimum queue depth in ms
+  float audio_queue_avg_ms = 0.0f;  // average audio ring fill in ms
+  float audio_queue_min_ms = 0.0f;  // minimum audio ring fill in ms
   float audio_push_interval_max_us = 0.0f;  // longest gap between pushes
 
   // Options dialog state
@@ -114,6 +114,9 @@ struct ImGuiUIState {
   // Tape block index (built on tape load)
   std::vector<byte*> tape_block_offsets;
   int tape_current_block = 0;
+  // Deck position and tape length in ms (engine=1; 0 = unknown).
+  uint32_t tape_ms = 0;
+  uint32_t tape_total_ms = 0;
 
   // File dialog async state
   FileDialogAction pending_dialog = FileDialogAction::None;
@@ -15,6 +15,7 @@ bool g_speedtest_open = false;
 #include <SDL3/SDL_dialog.h>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cstdio>
@@ -24,7 +25,9 @@ bool g_speedtest_open = false;
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <thread>
 
 #include "amdrum.h"
 #include "amx_mouse.h"
@@ -53,6 +56,7 @@ bool g_speedtest_open = false;
 #include "serial_interface.h"
 #include "slotshandler.h"
 #include "smartwatch.h"
+#include "stringutils.h"
 #include "symbiface.h"
 #include "symfile.h"
 #include "tape_line_in.h"
@@ -248,9 +252,113 @@ void create_new_disk(const std::string& path, const std::string& fname) {
 }
 }  // namespace
 
+// A disk load running off the UI thread. An IPF decodes every track before
+// the disc plays, which takes long enough on a big image to freeze the window:
+// the dialog hands it to a worker and the frame draws its progress instead
+// (render_disk_load). The worker only fills a private decode; the UI thread
+// installs it once it is done (disk_load_busy), so the live drive never
+// changes under the running machine. Other dialogs wait in `pending_dialog`
+// until it lands.
 namespace {
+struct DiskLoadJob {
+  std::thread worker;
+  std::atomic<int> done{0};
+  std::atomic<int> total{0};  // 0 until the flux decode starts reporting
+  std::atomic<bool> finished{false};
+  t_disk_decode decoded;
+  t_slot* slot = nullptr;
+  char drive = 'A';
+  std::string path, fname;
+  ~DiskLoadJob() {
+    if (worker.joinable()) worker.join();
+  }
+};
+std::unique_ptr<DiskLoadJob> g_disk_load;
+
+// Only the IPF containers are slow enough to be worth a worker.
+bool load_in_background(const std::string& path) {
+  const std::string ext =
+      path.size() >= 4 ? stringutils::lower(path.substr(path.size() - 4)) : "";
+  return ext == ".ipf" || ext == ".raw";
+}
+
+void finish_disk_load(int result, char drive, const std::string& path,
+                      const std::string& fname) {
+  if (result == 0) {
+    imgui_toast_success(std::string("Drive ") + drive + ": " + fname);
+    mru_push(CPC.mru_disks, path);
+  } else {
+    imgui_toast_error("Failed to load disk: " + fname);
+  }
+}
+
+void load_disk(t_slot& slot, char drive, const std::string& path,
+               const std::string& fname) {
+  slot.file = path;
+  if (!load_in_background(path)) {
+    finish_disk_load(file_load(slot), drive, path, fname);
+    return;
+  }
+  g_disk_load = std::make_unique<DiskLoadJob>();
+  DiskLoadJob* job = g_disk_load.get();
+  job->slot = &slot;
+  job->drive = drive;
+  job->path = path;
+  job->fname = fname;
+  job->worker = std::thread([job] {
+    disk_decode(job->path, job->decoded, [job](int done, int total) {
+      job->total.store(total, std::memory_order_relaxed);
+      job->done.store(done, std::memory_order_relaxed);
+    });
+    job->finished.store(true, std::memory_order_release);
+  });
+}
+
+// Reap a finished background load. True while one is still running.
+bool disk_load_busy() {
+  if (!g_disk_load) return false;
+  if (!g_disk_load->finished.load(std::memory_order_acquire)) return true;
+  g_disk_load->worker.join();
+  finish_disk_load(disk_install(*g_disk_load->slot, g_disk_load->decoded),
+                   g_disk_load->drive, g_disk_load->path, g_disk_load->fname);
+  g_disk_load.reset();
+  return false;
+}
+
+// The running load's progress bar, bottom-centre, drawn like the toasts.
+void render_disk_load() {
+  if (!g_disk_load) return;
+  const int done = g_disk_load->done.load(std::memory_order_relaxed);
+  const int total = g_disk_load->total.load(std::memory_order_relaxed);
+  const float frac =
+      total > 0 ? static_cast<float>(done) / static_cast<float>(total) : 0.0f;
+  const std::string label = "Decoding " + g_disk_load->fname + " into drive " +
+                            g_disk_load->drive;
+  ImVec2 const vpPos = ImGui::GetMainViewport()->Pos;
+  ImVec2 const vpSize = ImGui::GetMainViewport()->Size;
+  ImVec2 const textSize = ImGui::CalcTextSize(label.c_str());
+  float const boxW = std::max(textSize.x + 16.0f, 240.0f);
+  float const boxH = textSize.y + 24.0f;
+  float const x = vpPos.x + ((vpSize.x - boxW) * 0.5f);
+  float const y = vpPos.y + vpSize.y - 40.0f - boxH;
+  ImDrawList* dl = ImGui::GetForegroundDrawList();
+  dl->AddRectFilled(ImVec2(x, y), ImVec2(x + boxW, y + boxH),
+                    IM_COL32(0x18, 0x18, 0x20, 210), 4.0f);
+  dl->AddRect(ImVec2(x, y), ImVec2(x + boxW, y + boxH),
+              IM_COL32(0x50, 0x50, 0x70, 200), 4.0f);
+  dl->AddText(ImVec2(x + 8.0f, y + 6.0f), IM_COL32(0xD0, 0xD0, 0xD0, 255),
+              label.c_str());
+  float const barY = y + textSize.y + 10.0f;
+  dl->AddRectFilled(ImVec2(x + 8.0f, barY), ImVec2(x + boxW - 8.0f, barY + 6.0f),
+                    IM_COL32(0x30, 0x30, 0x40, 255), 2.0f);
+  dl->AddRectFilled(ImVec2(x + 8.0f, barY),
+                    ImVec2(x + 8.0f + ((boxW - 16.0f) * frac), barY + 6.0f),
+                    IM_COL32(0x50, 0x90, 0xE0, 255), 2.0f);
+}
+
 void process_pending_dialog() {
   if (imgui_state.pending_dialog == FileDialogAction::None) return;
+  if (disk_load_busy()) return;  // keep it queued until the load lands
 
   FileDialogAction const action = imgui_state.pending_dialog;
   std::string const path = imgui_state.pending_dialog_result;
@@ -266,24 +374,12 @@ void process_pending_dialog() {
   switch (action) {
     case FileDialogAction::LoadDiskA:
     case FileDialogAction::LoadDiskA_LED:
-      CPC.driveA.file = path;
-      if (file_load(CPC.driveA) == 0) {
-        imgui_toast_success("Drive A: " + fname);
-        mru_push(CPC.mru_disks, path);
-      } else {
-        imgui_toast_error("Failed to load disk: " + fname);
-      }
+      load_disk(CPC.driveA, 'A', path, fname);
       CPC.current_dsk_path = dir;
       break;
     case FileDialogAction::LoadDiskB:
     case FileDialogAction::LoadDiskB_LED:
-      CPC.driveB.file = path;
-      if (file_load(CPC.driveB) == 0) {
-        imgui_toast_success("Drive B: " + fname);
-        mru_push(CPC.mru_disks, path);
-      } else {
-        imgui_toast_error("Failed to load disk: " + fname);
-      }
+      load_disk(CPC.driveB, 'B', path, fname);
       CPC.current_dsk_path = dir;
       break;
     case FileDialogAction::SaveDiskA:
@@ -585,6 +681,25 @@ void imgui_init_ui() {
       []() {
         imgui_state.show_plotter_preview = !imgui_state.show_plotter_preview;
       });
+  // Library tab picks load through the same path as the file dialogs
+  g_command_palette.set_library_handler([](const library::Entry& e) {
+    switch (e.kind) {
+      case library::Kind::Disk:
+      case library::Kind::Flux:
+        imgui_state.pending_dialog = FileDialogAction::LoadDiskA;
+        break;
+      case library::Kind::Tape:
+        imgui_state.pending_dialog = FileDialogAction::LoadTape;
+        break;
+      case library::Kind::Snapshot:
+        imgui_state.pending_dialog = FileDialogAction::LoadSnapshot;
+        break;
+      case library::Kind::Cartridge:
+        imgui_state.pending_dialog = FileDialogAction::LoadCartridge;
+        break;
+    }
+    imgui_state.pending_dialog_result = e.path;
+  });
 }
 
 // ─────────────────────────────────────────────────
@@ -613,6 +728,7 @@ void imgui_render_ui() {
     }
   }
 
+  disk_load_busy();  // reap a finished background disk load
   process_pending_dialog();
   // Dockspace host must be rendered before other windows so they can dock into
   // it
@@ -639,6 +755,8 @@ void imgui_render_ui() {
   g_devtools_ui.render();
   g_command_palette.render();
 
+  render_disk_load();
+
   // ── Toast notifications ──
   {
     ImGuiIO const& io = ImGui::GetIO();
@@ -1138,11 +1256,10 @@ extern "C" void koncpc_request_file_dialog(int action) {
       break;
     }
     case FileDialogAction::LoadDiskB: {
-      // No flux formats (scp/hfe/a2r) here on purpose: flux capture is
-      // drive-A-only (side-0/drive-A FDC seam) — see drive_extensions() in
-      // slotshandler.cpp, which the loader enforces.
+      // Same formats as drive A: drive B plays flux too (drive_extensions()
+      // in slotshandler.cpp, which the loader enforces).
       static const SDL_DialogFileFilter f[] = {
-          {"Disk Images", "dsk;ipf;raw;zip"}};
+          {"Disk Images", "dsk;ipf;raw;scp;hfe;a2r;zip"}};
       SDL_ShowOpenFileDialog(file_dialog_callback, ud, mainSDLWindow, f, 1,
                              CPC.current_dsk_path.c_str(), false);
       break;
@@ -1457,6 +1574,15 @@ void imgui_render_menubar() {
     if (ImGui::MenuItem("Eject Tape", nullptr, false, !pbTapeImage.empty())) {
       imgui_state.eject_confirm_tape = true;
     }
+    {
+      bool flash = CPC.tape_flash_load != 0;
+      if (ImGui::MenuItem("Flash Load Tapes", nullptr, &flash))
+        CPC.tape_flash_load = flash ? 1 : 0;
+      if (ImGui::IsItemHovered())
+        ImGui::SetTooltip(
+            "Standard firmware blocks load instantly; custom and turbo\n"
+            "loaders still play in real time.");
+    }
     ImGui::Separator();
     if (ImGui::MenuItem("Load Cartridge...")) {
       koncpc_request_file_dialog(
@@ -2194,15 +2320,10 @@ void imgui_render_statusbar() {
             // Ask to confirm eject
             imgui_state.eject_confirm_drive = drv;
           } else {
-            // Load disk. Per-drive filters: drive A takes the flux
-            // containers, drive B must not (flux is drive-A-only — see
-            // drive_extensions() in slotshandler.cpp).
-            static const SDL_DialogFileFilter drive_a_filters[] = {
+            // Load disk. Both drives take the same formats, flux included
+            // (drive_extensions() in slotshandler.cpp).
+            static const SDL_DialogFileFilter disk_filters[] = {
                 {"Disk Images", "dsk;ipf;raw;scp;hfe;a2r;zip"}};
-            static const SDL_DialogFileFilter drive_b_filters[] = {
-                {"Disk Images", "dsk;ipf;raw;zip"}};
-            const SDL_DialogFileFilter* disk_filters =
-                drv == 0 ? drive_a_filters : drive_b_filters;
             auto act = drv == 0 ? FileDialogAction::LoadDiskA_LED
                                 : FileDialogAction::LoadDiskB_LED;
             SDL_ShowOpenFileDialog(
@@ -2444,10 +2565,17 @@ void imgui_render_statusbar() {
       // ── Block counter ──
       if (tape_loaded && !imgui_state.tape_block_offsets.empty()) {
         ImGui::SameLine(0, 4);
-        char blockStr[32];
-        snprintf(blockStr, sizeof(blockStr), "%d/%d",
-                 imgui_state.tape_current_block + 1,
-                 static_cast<int>(imgui_state.tape_block_offsets.size()));
+        char blockStr[48];
+        int const n = snprintf(
+            blockStr, sizeof(blockStr), "%d/%d",
+            imgui_state.tape_current_block + 1,
+            static_cast<int>(imgui_state.tape_block_offsets.size()));
+        if (imgui_state.tape_total_ms > 0 && n > 0) {  // engine=1: exact time
+          unsigned const at = imgui_state.tape_ms / 1000;
+          unsigned const len = imgui_state.tape_total_ms / 1000;
+          snprintf(blockStr + n, sizeof(blockStr) - n, " %u:%02u/%u:%02u",
+                   at / 60, at % 60, len / 60, len % 60);
+        }
         ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.45f, 0.45f, 0.45f, 1.0f));
         ImGui::AlignTextToFramePadding();
         ImGui::TextUnformatted(blockStr);
@@ -2699,6 +2827,7 @@ void imgui_render_statusbar() {
         CPC.tape.file.clear();
         imgui_state.tape_block_offsets.clear();
         imgui_state.tape_current_block = 0;
+        imgui_state.tape_ms = imgui_state.tape_total_ms = 0;
         imgui_state.eject_confirm_tape = false;
         ImGui::CloseCurrentPopup();
       }
@@ -4672,8 +4801,8 @@ void imgui_render_devtools() {
         snprintf(abuf, sizeof(abuf), "snd:%.0fms", s_queue_avg_ms);
         if (devbar_readout(abuf, "snd:999ms")) {
           ImGui::BeginTooltip();
-          ImGui::Text("Audio queue avg: %.1f ms", s_queue_avg_ms);
-          ImGui::Text("Audio queue min: %.1f ms", s_queue_min_ms);
+          ImGui::Text("Audio ring avg: %.1f ms", s_queue_avg_ms);
+          ImGui::Text("Audio ring min: %.1f ms", s_queue_min_ms);
           ImGui::Text("Push interval max: %.0f us", s_push_interval_max_us);
           ImGui::Text("Pushes/sec: %d", s_pushes);
           ImGui::Text("Underruns/sec: %d", s_underruns);
@@ -5,7 +5,12 @@
 
 #include "ipf_decode.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
+#include <mutex>
+#include <thread>
 
 #include "log.h"
 
@@ -53,9 +58,11 @@ void sample_bits(const std::vector<uint8_t>& bytes, uint32_t nbits,
 
 // ---- Weak-bit RNG (§4.3) --------------------------------------------------
 // splitmix64 — deterministic when seeded, decent distribution. Exact choice is
-// not load-bearing (spec §4.3): only "flakey tracks vary, stable don't".
+// not load-bearing (spec §4.3): only "flakey tracks vary, stable don't". The
+// state moves by kSplitmixStep per draw, so n draws ahead is one multiply.
+constexpr uint64_t kSplitmixStep = 0x9E3779B97F4A7C15ULL;
 inline uint64_t splitmix64(uint64_t& state) {
-  uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  uint64_t z = (state += kSplitmixStep);
   z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
   z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
   return z ^ (z >> 31);
@@ -99,21 +106,26 @@ struct MfmBuilder {
 }  // namespace
 
 // ---- CRC-32/ISO-HDLC ------------------------------------------------------
-uint32_t crc32(const uint8_t* data, size_t len) {
-  static uint32_t table[256];
-  static bool init = false;
-  if (!init) {
-    for (uint32_t i = 0; i < 256; ++i) {
-      uint32_t c = i;
-      for (int k = 0; k < 8; ++k)
-        c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
-      table[i] = c;
-    }
-    init = true;
+// The table is built at compile time: decode runs on several threads at once
+// (Image::decode_passes), so a lazily filled static would race.
+namespace {
+constexpr std::array<uint32_t, 256> make_crc32_table() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t c = i;
+    for (int k = 0; k < 8; ++k)
+      c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+    table[i] = c;
   }
+  return table;
+}
+constexpr std::array<uint32_t, 256> kCrc32Table = make_crc32_table();
+}  // namespace
+
+uint32_t crc32(const uint8_t* data, size_t len) {
   uint32_t crc = 0xFFFFFFFFu;
   for (size_t i = 0; i < len; ++i)
-    crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+    crc = kCrc32Table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
   return crc ^ 0xFFFFFFFFu;
 }
 
@@ -529,7 +541,7 @@ bool Image::parse_block_streams(int cyl, int head,
 }
 
 bool Image::decode_track(const ImgeRec& imge, const DataRec& data,
-                         CleanTrackMFM& out) {
+                         CleanTrackMFM& out, uint64_t& rng) const {
   out.bits.clear();
   out.nbits = 0;
   out.flakey = (imge.track_flags & 1u) != 0u;
@@ -610,7 +622,7 @@ bool Image::decode_track(const ImgeRec& imge, const DataRec& data,
         case DataType::Fuzzy: {
           uint32_t const decn = data_in_bit ? e.size : e.size * 8u;
           for (uint32_t k = 0; k < decn; ++k) {
-            uint64_t const r = splitmix64(rng_state_);
+            uint64_t const r = splitmix64(rng);
             mb.emit_decoded_bit(static_cast<uint8_t>(r & 1u));
           }
           break;
@@ -660,6 +672,11 @@ bool Image::decode_track(const ImgeRec& imge, const DataRec& data,
 }
 
 bool Image::lock_track(int cyl, int head, CleanTrackMFM& out) {
+  return lock_pass(cyl, head, out, rng_state_);
+}
+
+bool Image::lock_pass(int cyl, int head, CleanTrackMFM& out,
+                      uint64_t& rng) const {
   out.bits.clear();
   out.nbits = 0;
   out.flakey = false;
@@ -668,7 +685,74 @@ bool Image::lock_track(int cyl, int head, CleanTrackMFM& out) {
   if (ir == nullptr) return true;  // absent ⇒ empty (unformatted)
   const DataRec* dr = find_data(ir->data_key);
   if (dr == nullptr) return true;  // no data ⇒ empty
-  return decode_track(*ir, *dr, out);
+  return decode_track(*ir, *dr, out, rng);
+}
+
+// Mirrors decode_track's early outs: a pass that renders nothing draws
+// nothing. A track that fails to parse fails its decode as well, so what it
+// would have drawn never matters.
+uint64_t Image::fuzzy_draws(int cyl, int head) const {
+  const ImgeRec* ir = find_imge(cyl, head);
+  if (ir == nullptr) return 0;
+  const DataRec* dr = find_data(ir->data_key);
+  if (dr == nullptr) return 0;
+  if (ir->density == 1u || ir->block_count == 0u || dr->extra_len == 0u ||
+      ir->data_bits + ir->gap_bits == 0u)
+    return 0;
+  std::vector<BlockDesc> descs;
+  std::vector<BlockStreams> streams;
+  if (!parse_streams(buf_.data() + dr->extra_off, dr->extra_len,
+                     static_cast<uint32_t>(info_.encoder_type),
+                     ir->block_count, descs, streams))
+    return 0;
+  uint64_t draws = 0;
+  for (size_t bi = 0; bi < descs.size(); ++bi) {
+    bool const data_in_bit = (descs[bi].block_flags & 0x4u) != 0u;
+    for (const DataElem& e : streams[bi].data)
+      if (e.type == DataType::Fuzzy) draws += data_in_bit ? e.size : e.size * 8u;
+  }
+  return draws;
+}
+
+void Image::plan_pass(std::vector<Pass>& passes, int cyl, int head) {
+  Pass p;
+  p.cyl = cyl;
+  p.head = head;
+  p.rng = rng_state_;
+  rng_state_ += fuzzy_draws(cyl, head) * kSplitmixStep;
+  passes.push_back(std::move(p));
+}
+
+// Workers claim passes in plan order. Every pass runs even after a failure:
+// the callers pick the first failure in plan order, as the serial loop did.
+bool Image::decode_passes(std::vector<Pass>& passes, unsigned threads,
+                          const Progress& progress) const {
+  int const total = static_cast<int>(passes.size());
+  std::atomic<int> next{0};
+  std::atomic<bool> failed{false};
+  std::mutex report;
+  int done = 0;
+  auto work = [&] {
+    for (;;) {
+      int const i = next.fetch_add(1, std::memory_order_relaxed);
+      if (i >= total) return;
+      Pass& p = passes[static_cast<size_t>(i)];
+      uint64_t rng = p.rng;
+      p.ok = lock_pass(p.cyl, p.head, p.mfm, rng);
+      if (!p.ok) failed.store(true, std::memory_order_relaxed);
+      if (progress) {
+        std::lock_guard<std::mutex> lock(report);
+        progress(++done, total);
+      }
+    }
+  };
+  if (threads == 0) threads = std::max(std::thread::hardware_concurrency(), 1u);
+  threads = std::min(threads, static_cast<unsigned>(std::max(total, 1)));
+  std::vector<std::thread> pool;
+  for (unsigned i = 1; i < threads; ++i) pool.emplace_back(work);
+  work();  // the calling thread decodes too
+  for (std::thread& t : pool) t.join();
+  return !failed.load(std::memory_order_relaxed);
 }
 
 // ---------------------------------------------------------------------------
@@ -678,20 +762,23 @@ bool Image::lock_track(int cyl, int head, CleanTrackMFM& out) {
 // ---------------------------------------------------------------------------
 namespace {
 
-// CRC-16/CCITT (poly 0x1021), used for ID/data field checksums.
-uint16_t crc16_ccitt_step(uint16_t crc, uint8_t b) {
-  static uint16_t table[256];
-  static bool init = false;
-  if (!init) {
-    for (int i = 0; i < 256; ++i) {
-      uint16_t w = static_cast<uint16_t>(i << 8);
-      for (int j = 0; j < 8; ++j)
-        w = static_cast<uint16_t>((w << 1) ^ ((w & 0x8000u) ? 0x1021u : 0u));
-      table[i] = w;
-    }
-    init = true;
+// CRC-16/CCITT (poly 0x1021), used for ID/data field checksums. Compile-time
+// table, like crc32's.
+constexpr std::array<uint16_t, 256> make_crc16_table() {
+  std::array<uint16_t, 256> table{};
+  for (int i = 0; i < 256; ++i) {
+    uint16_t w = static_cast<uint16_t>(i << 8);
+    for (int j = 0; j < 8; ++j)
+      w = static_cast<uint16_t>((w << 1) ^ ((w & 0x8000u) ? 0x1021u : 0u));
+    table[i] = w;
   }
-  return static_cast<uint16_t>((crc << 8) ^ table[((crc >> 8) ^ b) & 0xFFu]);
+  return table;
+}
+constexpr std::array<uint16_t, 256> kCrc16Table = make_crc16_table();
+
+uint16_t crc16_ccitt_step(uint16_t crc, uint8_t b) {
+  return static_cast<uint16_t>((crc << 8) ^
+                               kCrc16Table[((crc >> 8) ^ b) & 0xFFu]);
 }
 
 struct Scanner {
@@ -867,7 +954,7 @@ void scan_track(const CleanTrackMFM& mfm, std::vector<SectorTmp>& sectors,
 
 }  // namespace
 
-Status Image::fill_drive(t_drive* drive) {
+Status Image::fill_drive(t_drive* drive, unsigned threads) {
   if (drive == nullptr) return Status::BadRecord;
   if (!open_) return Status::BadRecord;
 
@@ -877,66 +964,86 @@ Status Image::fill_drive(t_drive* drive) {
   drive->sides = static_cast<unsigned int>(info_.max_head - info_.min_head);
   drive->altered = false;
 
-  for (int cyl = info_.min_cyl; cyl <= info_.max_cyl; ++cyl) {
-    for (int head = info_.min_head; head <= info_.max_head; ++head) {
-      t_track* pt = &drive->track[cyl][head];
-      std::memset(pt, 0, sizeof(*pt));
-
-      CleanTrackMFM mfm;
-      if (!lock_track(cyl, head, mfm)) {
-        LOG_ERROR("IPF: track " << cyl << "." << head << " failed to decode");
-        return Status::DecodeError;  // whole-load abort (§5.4)
-      }
-      if (mfm.nbits == 0) continue;  // unformatted ⇒ zeroed t_track
-
-      std::vector<SectorTmp> sectors;
-      std::vector<uint8_t> decoded;
-      scan_track(mfm, sectors, decoded);
-      if (sectors.empty()) continue;
-
-      pt->sectors = static_cast<unsigned int>(sectors.size());
-      pt->size = static_cast<unsigned int>(decoded.size());
-      pt->data = new byte[decoded.size()];
-      std::memcpy(pt->data, decoded.data(), decoded.size());
-      for (size_t i = 0; i < sectors.size(); ++i) {
-        const SectorTmp& st = sectors[i];
-        t_sector& ps = pt->sector[i];
-        for (int k = 0; k < 4; ++k) ps.CHRN[k] = st.chrn[k];
-        for (int k = 0; k < 4; ++k) ps.flags[k] = st.flags[k];
-        ps.setSizes(st.size, st.size);
-        ps.setData(pt->data + (st.has_data ? st.data_off : 0));
-      }
+  std::vector<Pass> passes;
+  for (int cyl = info_.min_cyl; cyl <= info_.max_cyl; ++cyl)
+    for (int head = info_.min_head; head <= info_.max_head; ++head)
+      plan_pass(passes, cyl, head);
+  decode_passes(passes, threads, {});
+
+  for (const Pass& p : passes) {
+    int const cyl = p.cyl;
+    int const head = p.head;
+    t_track* pt = &drive->track[cyl][head];
+    std::memset(pt, 0, sizeof(*pt));
+
+    const CleanTrackMFM& mfm = p.mfm;
+    if (!p.ok) {
+      LOG_ERROR("IPF: track " << cyl << "." << head << " failed to decode");
+      return Status::DecodeError;  // whole-load abort (§5.4)
+    }
+    if (mfm.nbits == 0) continue;  // unformatted ⇒ zeroed t_track
+
+    std::vector<SectorTmp> sectors;
+    std::vector<uint8_t> decoded;
+    scan_track(mfm, sectors, decoded);
+    if (sectors.empty()) continue;
+
+    pt->sectors = static_cast<unsigned int>(sectors.size());
+    pt->size = static_cast<unsigned int>(decoded.size());
+    pt->data = new byte[decoded.size()];
+    std::memcpy(pt->data, decoded.data(), decoded.size());
+    for (size_t i = 0; i < sectors.size(); ++i) {
+      const SectorTmp& st = sectors[i];
+      t_sector& ps = pt->sector[i];
+      for (int k = 0; k < 4; ++k) ps.CHRN[k] = st.chrn[k];
+      for (int k = 0; k < 4; ++k) ps.flags[k] = st.flags[k];
+      ps.setSizes(st.size, st.size);
+      ps.setData(pt->data + (st.has_data ? st.data_off : 0));
     }
   }
   return Status::Ok;
 }
 
-std::vector<t_mfm_track> Image::mirror_side0(int revs) {
+std::vector<t_mfm_track> Image::mirror_side0(int revs,
+                                             const Progress& progress,
+                                             unsigned threads) {
   std::vector<t_mfm_track> cyls;
   if (!open_ || revs <= 0) return cyls;
   int const max_cyl = info_.max_cyl;
+  // Plan every pass the serial mirror would run, in its order: one per
+  // cylinder, `revs` for a flakey one. An empty flakey cylinder draws nothing,
+  // so planning its spare passes leaves every later RNG state where it was.
+  std::vector<Pass> passes;
+  std::vector<size_t> first(static_cast<size_t>(max_cyl) + 1);
+  for (int cyl = 0; cyl <= max_cyl; ++cyl) {
+    first[static_cast<size_t>(cyl)] = passes.size();
+    int const n = track_flakey(cyl, 0) ? revs : 1;
+    for (int rv = 0; rv < n; ++rv) plan_pass(passes, cyl, 0);
+  }
+  decode_passes(passes, threads, progress);
+
   for (int cyl = 0; cyl <= max_cyl; ++cyl) {
     t_mfm_track track;
-    CleanTrackMFM first;
-    if (!lock_track(cyl, 0, first)) return {};
-    if (first.nbits == 0) {
+    Pass& p0 = passes[first[static_cast<size_t>(cyl)]];
+    if (!p0.ok) return {};
+    if (p0.mfm.nbits == 0) {
       cyls.push_back(track);  // empty ⇒ absent slot
       continue;
     }
     t_mfm_rev r0;
-    r0.bits = first.bits;
-    r0.nbits = first.nbits;
+    r0.bits = std::move(p0.mfm.bits);
+    r0.nbits = p0.mfm.nbits;
     track.push_back(std::move(r0));
     for (int rv = 1; rv < revs; ++rv) {
-      if (first.flakey) {
-        CleanTrackMFM pass;
-        if (!lock_track(cyl, 0, pass) || pass.nbits == 0) {
+      if (p0.mfm.flakey) {
+        Pass& pass = passes[first[static_cast<size_t>(cyl)] + rv];
+        if (!pass.ok || pass.mfm.nbits == 0) {
           track.push_back(track.back());  // pad with last
           continue;
         }
         t_mfm_rev rr;
-        rr.bits = std::move(pass.bits);
-        rr.nbits = pass.nbits;
+        rr.bits = std::move(pass.mfm.bits);
+        rr.nbits = pass.mfm.nbits;
         track.push_back(std::move(rr));
       } else {
         track.push_back(track.front());  // stable ⇒ reuse
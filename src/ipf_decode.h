@@ -21,6 +21,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <vector>
 
 #include "hw_views.h"  // t_drive / t_track / t_sector, DSK_TRACKMAX/SIDEMAX
@@ -48,6 +49,11 @@ enum class Status : std::uint8_t {
 };
 const char* status_str(Status s);
 
+// ---- Whole-image decode progress -------------------------------------------
+// `done` of `total` track passes decoded. Called from the decode threads, one
+// call at a time, so a UI can publish it to its own frame through an atomic.
+using Progress = std::function<void(int done, int total)>;
+
 // ---- Parsed geometry (mirrors CleanImageInfo, spec §5.1) ------------------
 struct CleanImageInfo {
   int min_cyl = 0;
@@ -117,6 +123,12 @@ struct BlockDesc {
 // Holds a copy of the file bytes + the parsed record set + a per-image weak-bit
 // RNG. lock_track() runs one decode pass and advances the RNG so consecutive
 // passes of a flakey track differ (§4.3/§4.4).
+//
+// The whole-image decodes (fill_drive, mirror_side0) spread their track passes
+// over a thread pool. The RNG is splitmix64, whose state advances by a fixed
+// step per draw, so each pass's starting state is known before it runs (its
+// Fuzzy bit count, §3.1): a pooled decode is bit-identical to decoding the
+// passes one after another with lock_track.
 class Image {
  public:
   Image() = default;
@@ -151,11 +163,14 @@ class Image {
   // passed open() first. On any per-track decode failure returns an error and
   // does NOT leave a half-filled drive claiming success (§5.4 whole-load
   // abort). The caller owns the new[] buffers (free via free_drive_tracks()).
-  Status fill_drive(t_drive* drive);
+  // `threads` decode workers (0 = one per core, 1 = the calling thread only).
+  Status fill_drive(t_drive* drive, unsigned threads = 0);
 
   // side-0 flux mirror: `revs` decode passes per cylinder (§5.2). Non-flakey
-  // cylinders reuse one pass; flakey cylinders decode `revs` times.
-  std::vector<t_mfm_track> mirror_side0(int revs);
+  // cylinders reuse one pass; flakey cylinders decode `revs` times. `progress`
+  // (optional) counts the passes; `threads` as for fill_drive.
+  std::vector<t_mfm_track> mirror_side0(int revs, const Progress& progress = {},
+                                        unsigned threads = 0);
 
   // Parse-only accessor for the stream-element unit tests (§7 vectors).
   // Decode the block descriptors + stream lists of (cyl, head) without MFM
@@ -176,13 +191,32 @@ class Image {
     uint32_t extra_len = 0;
   };
 
+  // One planned decode pass of a whole-image decode.
+  struct Pass {
+    int cyl = 0, head = 0;
+    uint64_t rng = 0;  // weak-bit RNG state the pass starts from
+    CleanTrackMFM mfm;
+    bool ok = false;
+  };
+
   const ImgeRec* find_imge(int cyl, int head) const;
   const DataRec* find_data(uint32_t data_key) const;
 
-  // Decode one pass into `out` given the matched IMGE + DATA. Returns false on
-  // inconsistency; a legitimately empty track returns true, out.nbits == 0.
+  // Decode one pass into `out` given the matched IMGE + DATA, drawing weak
+  // bits from `rng`. Returns false on inconsistency; a legitimately empty
+  // track returns true, out.nbits == 0.
   bool decode_track(const ImgeRec& imge, const DataRec& data,
-                    CleanTrackMFM& out);
+                    CleanTrackMFM& out, uint64_t& rng) const;
+  // lock_track against an explicit RNG state.
+  bool lock_pass(int cyl, int head, CleanTrackMFM& out, uint64_t& rng) const;
+  // RNG draws one pass of (cyl, head) makes: its Fuzzy bit count.
+  uint64_t fuzzy_draws(int cyl, int head) const;
+  // Queue the next pass of (cyl, head), advancing rng_state_ past it exactly
+  // as lock_track would.
+  void plan_pass(std::vector<Pass>& passes, int cyl, int head);
+  // Run every planned pass on `threads` workers. False if any pass failed.
+  bool decode_passes(std::vector<Pass>& passes, unsigned threads,
+                     const Progress& progress) const;
 
   std::vector<uint8_t> buf_;  // owned copy of the whole file
   std::vector<ImgeRec> imges_;
@@ -36,6 +36,8 @@ inline Uint32 MapRGBSurface(SDL_Surface* surface, Uint8 r, Uint8 g, Uint8 b) {
 
 #include "amdrum.h"
 #include "amx_mouse.h"
+#include "audio_render.h"
+#include "audio_ring.h"
 #include "autotype.h"
 #include "avi_recorder.h"
 #include "configuration.h"
@@ -57,7 +59,9 @@ inline Uint32 MapRGBSurface(SDL_Surface* surface, Uint8 r, Uint8 g, Uint8 b) {
 #include "m4board_http.h"
 #include "macos_menu.h"
 #include "memory_bus.h"
+#include "media_library.h"
 #include "memutils.h"
+#include "png_dump.h"
 #include "serial_interface.h"
 #include "smartwatch.h"
 #include "startup_manifest.h"
@@ -129,6 +133,10 @@ extern SDL_Renderer* renderer;
 
 namespace {
 SDL_AudioStream* audio_stream = nullptr;
+// Emulation -> AY device handoff (audio_ring.h): audio_push_buffer is the
+// producer, ay_audio_callback on SDL's audio thread the consumer.
+AudioRing g_audio_ring;
+double g_audio_target_ms = 30.0;
 }  // namespace
 // Independent host cosmetic-sound stream (drive/tape SFX). It owns its own
 // logical audio device on the default output, so SDL/the OS mixes it with the
@@ -162,6 +170,11 @@ namespace {
 dword g_exit_target = 0;
 }  // namespace
 namespace {
+// --render-audio: rendered offline once the autocmd has been typed, then exit.
+bool g_render_pending = false;
+AudioRenderOptions g_render_opts;
+}  // namespace
+namespace {
 dword g_exit_start_ticks = 0;
 }  // namespace
 
@@ -238,6 +251,9 @@ std::thread::id g_main_thread_id{};
 // doCleanUp() can join it instead of letting it run past global destruction.
 namespace {
 std::thread g_z80_thread;
+// Machine slice length for paced frames (µs): a quarter frame bounds the
+// audio and input latency the frame granularity used to add.
+constexpr uint32_t kEmuSliceUs = 5000;
 }  // namespace
 // Protects the imgui_state stats fields written by the Z80 thread and read by
 // the render thread (frame_time_avg_us, z80_time_avg_us, audio_*, etc.).
@@ -1228,98 +1244,60 @@ namespace {
 uint64_t audio_last_push_tick = 0;  // perf counter of last push
 }  // namespace
 namespace {
-int audio_underrun_count = 0;  // underruns: queue was empty
+int audio_underrun_count = 0;  // underruns: the device found the ring empty
+}  // namespace
+namespace {
+uint64_t audio_underruns_seen = 0;  // ring underrun total at the last push
 }  // namespace
 namespace {
-int audio_near_underrun_count = 0;  // near-underruns: queue < half buffer
+int audio_near_underrun_count = 0;  // near-underrun: fill < half the target
 }  // namespace
 namespace {
 int audio_push_count = 0;  // successful pushes this reporting period
 }  // namespace
 namespace {
-double audio_queue_sum_bytes = 0;  // sum of queue depths (for average)
+double audio_fill_sum_ms = 0;  // sum of ring fills at push (for average)
 }  // namespace
 namespace {
-int audio_queue_min_bytes = INT_MAX;  // min queue depth this period
+double audio_fill_min_ms = 1e9;  // min ring fill this period
 }  // namespace
 namespace {
 uint64_t audio_push_interval_max =
     0;  // longest gap between pushes (perf ticks)
 }  // namespace
 
-// Push completed audio buffer into SDL stream (called from main loop on
-// EC_SOUND_BUFFER). SDL handles internal queuing and feeds the hardware at the
-// correct rate.
+// Push a completed stretch of interleaved stereo s16 into the audio ring
+// (called from the emulation loop). The ring absorbs pacing jitter and the
+// device callback resamples toward the target latency, so there is no queue
+// polling, silence top-up or whole-buffer dropping here: with the limiter off
+// the ring's own overrun ceiling bounds the latency (audio skips ahead).
 namespace {
 void audio_push_buffer(const byte* data, int len) {
   if (!audio_stream || !CPC.snd_ready || len <= 0) return;
 
   uint64_t const now = SDL_GetPerformanceCounter();
 
-  // Measure queue depth BEFORE pushing.
-  int queued = SDL_GetAudioStreamQueued(audio_stream);
-  queued = std::max(queued, 0);  // SDL error — treat as empty
-
-  // Cap total latency (beads-49ir). With the speed limiter off the emulation is
-  // unpaced and produces audio hundreds of times faster than the 44.1kHz sink
-  // drains it; with no ceiling the SDL queue grows without bound and audio lags
-  // the picture by seconds. Drop the buffer once the queue already holds more
-  // than ~160ms. That is well above the 80ms underrun floor topped up below, so
-  // paced playback (queue ~80ms) never trips it; unpaced audio then tracks
-  // realtime with bounded latency (skipping ahead) instead of backlogging.
-  const int max_queue_bytes = static_cast<int>(CPC.snd_buffersize) * 8;
-  if (queued >= max_queue_bytes) return;
-
-  // Detect underruns (skip if we have no previous push timestamp to
-  // compute an interval from — e.g. the very first push after init).
-  if (audio_last_push_tick > 0) {
-    // [[maybe_unused]]: consumed only by LOG_DEBUG, which release compiles out.
-    [[maybe_unused]] double const interval_ms =
-        static_cast<double>(now - audio_last_push_tick) * 1000.0 / perfFreq;
-    if (queued == 0) {
-      audio_underrun_count++;
-      LOG_DEBUG("Audio UNDERRUN: queue empty, interval " << interval_ms
-                                                         << "ms");
-    } else if (queued < len / 2) {
-      // Below half a buffer — real danger of audible artifact
-      audio_near_underrun_count++;
-      LOG_DEBUG("Audio near-underrun: queue " << queued << "B (< " << len / 2
-                                              << "B), interval " << interval_ms
-                                              << "ms");
-    }
-  }
-  audio_queue_sum_bytes += queued;
-  audio_queue_min_bytes = std::min(queued, audio_queue_min_bytes);
-
-  // Push to SDL — only update timing/count on success
-  if (!SDL_PutAudioStreamData(audio_stream, data, len)) {
-    LOG_DEBUG("Audio: SDL_PutAudioStreamData failed: " << SDL_GetError());
-    return;
-  }
-
-  // Maintain minimum queue depth to absorb macOS compositor stalls
-  // (observed up to ~70ms). Target: 4 frames = 80ms headroom.
-  // Top-up with silence so the hardware never runs dry mid-stall.
-  // Adds at most 80ms audio latency — acceptable for emulation.
-  {
-    // Use snd_buffersize (one full CPC frame) as the chunk unit, not the
-    // current push size which can be a small partial frame at end-of-frame.
-    const int frame_bytes = static_cast<int>(CPC.snd_buffersize);
-    const int target_bytes = frame_bytes * 4;  // ~80ms at 50Hz
-    int const queued_now = SDL_GetAudioStreamQueued(audio_stream);
-    if (queued_now >= 0 && queued_now < target_bytes) {
-      static std::vector<byte> silence_frame;
-      if (static_cast<int>(silence_frame.size()) != frame_bytes)
-        silence_frame.assign(static_cast<size_t>(frame_bytes), 0);
-      int deficit = target_bytes - queued_now;
-      while (deficit >= frame_bytes) {
-        SDL_PutAudioStreamData(audio_stream, silence_frame.data(), frame_bytes);
-        deficit -= frame_bytes;
-      }
-    }
-  }
-
-  // Measure push interval (after successful push)
+  // Measure the fill BEFORE pushing; fold in the underruns the callback has
+  // counted since the last push.
+  const AudioRingStats st = g_audio_ring.stats();
+  const double fill_ms = st.fill_ms();
+  if (st.underruns != audio_underruns_seen) {
+    audio_underrun_count += static_cast<int>(st.underruns - audio_underruns_seen);
+    audio_underruns_seen = st.underruns;
+    LOG_DEBUG("Audio UNDERRUN: ring ran dry (" << st.underruns << " total)");
+  } else if (audio_last_push_tick > 0 && fill_ms < st.target_ms() / 2) {
+    // Below half the target — the steering is losing ground.
+    audio_near_underrun_count++;
+    LOG_DEBUG("Audio near-underrun: ring " << fill_ms << "ms (target "
+                                           << st.target_ms() << "ms)");
+  }
+  audio_fill_sum_ms += fill_ms;
+  audio_fill_min_ms = std::min(fill_ms, audio_fill_min_ms);
+
+  g_audio_ring.push(reinterpret_cast<const int16_t*>(data),
+                    static_cast<size_t>(len) / (2 * sizeof(int16_t)));
+
+  // Measure push interval
   if (audio_last_push_tick > 0) {
     uint64_t const interval = now - audio_last_push_tick;
     audio_push_interval_max = std::max(interval, audio_push_interval_max);
@@ -1337,6 +1315,37 @@ void audio_push_buffer(const byte* data, int len) {
 }
 }  // namespace
 
+// SDL get-callback for the AY stream: runs on SDL's audio thread and pulls
+// exactly what the device asks for out of the ring, resampled to the device
+// rate. `additional_amount` is in the stream's source format (stereo S16 => 4
+// bytes/frame).
+namespace {
+void SDLCALL ay_audio_callback(void* /*userdata*/, SDL_AudioStream* stream,
+                               int additional_amount, int /*total_amount*/) {
+  if (additional_amount <= 0) return;
+  constexpr int kBytesPerFrame = 2 * static_cast<int>(sizeof(int16_t));
+  int frames_needed = additional_amount / kBytesPerFrame;
+  int16_t chunk[512 * 2];  // 512 stereo frames per iteration
+  while (frames_needed > 0) {
+    int const n = frames_needed < 512 ? frames_needed : 512;
+    g_audio_ring.pull(chunk, static_cast<size_t>(n));
+    SDL_PutAudioStreamData(stream, chunk, n * kBytesPerFrame);
+    frames_needed -= n;
+  }
+}
+}  // namespace
+
+bool audio_ring_stats(AudioRingStats& out) {
+  if (!audio_stream || !g_audio_ring.configured()) return false;
+  out = g_audio_ring.stats();
+  return true;
+}
+
+void audio_set_latency_ms(double ms) {
+  g_audio_target_ms = ms;
+  if (g_audio_ring.configured()) g_audio_ring.set_target_ms(ms);
+}
+
 namespace {
 int audio_align_samples(int given) {
   int actual = 1;
@@ -1382,40 +1391,40 @@ int audio_init() {
 
   int const sample_frames =
       audio_align_samples(desired.freq * FRAME_PERIOD_MS / 1000);
+  // The device buffer only has to cover callback scheduling: the ring holds
+  // the latency budget (g_audio_target_ms), so ask for ~5 ms periods.
+  int const device_frames = audio_align_samples(desired.freq * 5 / 1000);
   char frames_hint[32];
-  snprintf(frames_hint, sizeof(frames_hint), "%d", sample_frames);
+  snprintf(frames_hint, sizeof(frames_hint), "%d", device_frames);
   SDL_SetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES, frames_hint);
 
+  // The machine renders interleaved stereo s16 at subcycle::kAudioHz; the
+  // ring resamples that to the device rate, so the stream's source is always
+  // stereo S16 at desired.freq (SDL converts to the device's own format).
+  SDL_AudioSpec stream_spec;
+  stream_spec.freq = desired.freq;
+  stream_spec.format = SDL_AUDIO_S16;
+  stream_spec.channels = 2;
+  g_audio_ring.configure(static_cast<int>(subcycle::kAudioHz), desired.freq,
+                         g_audio_target_ms);
+  audio_underruns_seen = 0;
   audio_stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK,
-                                           &desired, nullptr, nullptr);
+                                           &stream_spec, ay_audio_callback,
+                                           nullptr);
   if (audio_stream == nullptr) {
     LOG_ERROR("Could not open audio: " << SDL_GetError());
     return 1;
   }
 
-  LOG_VERBOSE("Audio: Desired: Freq: "
-              << desired.freq << ", Format: " << desired.format
-              << ", Channels: " << static_cast<int>(desired.channels)
-              << ", Frames: " << sample_frames);
+  LOG_VERBOSE("Audio: Freq: " << desired.freq << ", device frames: "
+                              << device_frames << ", target latency: "
+                              << g_audio_target_ms << "ms");
 
   CPC.snd_buffersize = sample_frames * SDL_AUDIO_FRAMESIZE(desired);
   pbSndBuffer = std::make_unique<byte[]>(CPC.snd_buffersize);
   pbSndBufferEnd = pbSndBuffer.get() + CPC.snd_buffersize;
   CPC.snd_bufferptr = pbSndBuffer.get();
 
-  // Pre-buffer 2 silent buffers (~46ms at 44100Hz) so the SDL queue has
-  // enough margin to absorb occasional compositor stalls (~69ms observed).
-  // Done BEFORE resuming the device so SDL doesn't start draining immediately.
-  // Adds ~46ms of audio latency — acceptable for an emulator.
-  {
-    std::vector<byte> silence(CPC.snd_buffersize, 0);
-    for (int i = 0; i < 2; i++) {
-      if (!SDL_PutAudioStreamData(audio_stream, silence.data(),
-                                  static_cast<int>(CPC.snd_buffersize))) {
-        LOG_ERROR("Audio: pre-buffer failed: " << SDL_GetError());
-      }
-    }
-  }
   SDL_ResumeAudioDevice(SDL_GetAudioStreamDevice(audio_stream));
   CPC.snd_ready = true;
   audio_apply_volume();
@@ -1536,6 +1545,13 @@ void cpc_resume() {
 
 void cpc_pause_and_wait() {
   cpc_pause();
+  // On the Z80 thread itself (an IPC command drained between frames) the Z80
+  // is outside z80_execute() by construction, and waiting for its flag would
+  // wait forever. The flag stays untouched: other threads still see the
+  // truth.
+  if (g_z80_thread.joinable() &&
+      std::this_thread::get_id() == g_z80_thread.get_id())
+    return;
   // Spin until the Z80 thread has exited z80_execute() and entered its sleep
   // loop. g_z80_quiescent is set true by z80_thread_main before sleeping, false
   // before entering z80_execute().  In headless mode the Z80 runs on the
@@ -1623,6 +1639,19 @@ void mouse_init() {
   set_cursor_visibility(CPC.phazer_emulation);
 }
 
+// Publish the refresh rate of the display the main window is on (the primary
+// one when there is no window) for the bridge's frame-skip pacing. SDL display
+// queries are main-thread only; the Z80 thread just reads the result.
+namespace {
+void publish_display_hz() {
+  SDL_DisplayID const display = mainSDLWindow != nullptr
+                                    ? SDL_GetDisplayForWindow(mainSDLWindow)
+                                    : SDL_GetPrimaryDisplay();
+  const SDL_DisplayMode* mode = SDL_GetCurrentDisplayMode(display);
+  subcycle_bridge_set_display_hz(mode != nullptr ? mode->refresh_rate : 0.0f);
+}
+}  // namespace
+
 // Pull `win` back onto a display if it has ended up (almost) entirely off every
 // monitor's usable area — windows drift off-screen from a saved position on a
 // now-disconnected display, or from OS window-management nudges. `min_visible`
@@ -2007,6 +2036,23 @@ std::string getConfigurationFilename(bool forWrite) {
   return "";
 }
 
+// The media library index (media_library.h): $KONCPC_LIBRARY, else beside the
+// per-user configuration, else in the working directory.
+static std::string libraryIndexFilename() {
+  if (const char* env = getenv("KONCPC_LIBRARY")) return env;
+  std::filesystem::path dir;
+  if (const char* xdg = getenv("XDG_CONFIG_HOME")) {
+    dir = std::filesystem::path(xdg) / "koncepcja";
+  } else if (const char* home = getenv("HOME")) {
+    dir = std::filesystem::path(home) / ".config" / "koncepcja";
+  } else {
+    return std::string(chAppPath) + "/koncepcja.library";
+  }
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  return (dir / "koncepcja.library").string();
+}
+
 void loadConfiguration(t_CPC& CPC, const std::string& configFilename) {
   config::Config conf;
   conf.parseFile(configFilename);
@@ -2191,6 +2237,7 @@ void loadConfiguration(t_CPC& CPC, const std::string& configFilename) {
   g_amdrum.enabled = read_flag("sound", "amdrum", 0) != 0;
   g_drive_sounds.disk_enabled = read_flag("sound", "disk_sounds", 0) != 0;
   g_drive_sounds.tape_enabled = read_flag("sound", "tape_sounds", 0) != 0;
+  CPC.tape_flash_load = read_flag("system", "tape_flash_load", 1);
   tape_line_out_set_volume(conf.getIntValue("sound", "tape_data_volume", 35) /
                            100.0f);
   // Drive Sound Lab tuning (params + volume/pan). Applied to
@@ -2408,6 +2455,7 @@ bool saveConfiguration(t_CPC& CPC, const std::string& configFilename) {
   conf.setStringValue("sound", "drivesnd_params",
                       drive_sounds_params_to_string());
   conf.setIntValue("system", "smartwatch", g_smartwatch.enabled ? 1 : 0);
+  conf.setIntValue("system", "tape_flash_load", CPC.tape_flash_load);
   conf.setIntValue("input", "amx_mouse", g_amx_mouse.enabled ? 1 : 0);
   // Via Value, not int: PhazerType converts implicitly to both Value and
   // bool, so a direct static_cast<int> is ambiguous.
@@ -2871,21 +2919,50 @@ void loadBreakpoints() {
 }
 }  // namespace
 
-bool dumpScreenTo(const std::string& path) {
-  // Read the latest PUBLISHED frame — the emulation's actual output. The
-  // presented surface (video_render_surface) can go stale when the present
-  // path stalls (occluded macOS window / remote desktop) even though the
-  // emulation keeps producing frames; screenshots must not photograph that.
-  // Falls back to the presented surface, then back_surface (headless).
+namespace {
+
+// Hand the screen to `fn` as RGBA32 pixels (w, h, pitch). Reads the latest
+// PUBLISHED frame — the emulation's actual output. The presented surface
+// (video_render_surface) can go stale when the present path stalls (occluded
+// macOS window / remote desktop) even though the emulation keeps producing
+// frames; screenshots must not photograph that. Falls back to the presented
+// surface, then back_surface (headless).
+template <typename Fn>
+bool with_screen_pixels(Fn&& fn) {
   SDL_Surface* surf = video_ring_published_peek();
   if (!surf) surf = video_render_surface();
   if (!surf) surf = back_surface;
   if (!surf) return false;
-  if (SDL_SavePNG(surf, path)) {
-    LOG_ERROR("Could not write screenshot file to " + path);
-    return false;
-  }
-  return true;
+  SDL_Surface* rgba = surf;
+  if (surf->format != SDL_PIXELFORMAT_RGBA32) {  // 16-bit scaler surfaces
+    rgba = SDL_ConvertSurface(surf, SDL_PIXELFORMAT_RGBA32);
+    if (!rgba) return false;
+  }
+  const bool ok = fn(static_cast<const uint8_t*>(rgba->pixels), rgba->w,
+                     rgba->h, rgba->pitch);
+  if (rgba != surf) SDL_DestroySurface(rgba);
+  return ok;
+}
+
+}  // namespace
+
+bool dumpScreenTo(const std::string& path) {
+  return with_screen_pixels(
+      [&](const uint8_t* px, int w, int h, int pitch) {
+        const PngWriteResult r = write_png_rgba(path, px, w, h, pitch);
+        if (!r.ok) {
+          LOG_ERROR("Could not write screenshot file to " + path + ": " +
+                    r.error);
+        }
+        return r.ok;
+      });
+}
+
+bool queueScreenDump(PngDumpPool& pool, const std::string& path) {
+  return with_screen_pixels([&](const uint8_t* px, int w, int h, int pitch) {
+    pool.submit(path, px, w, h, pitch);
+    return true;
+  });
 }
 
 namespace {
@@ -3140,11 +3217,28 @@ void z80_thread_main() {
   // confirming the decouple holds (it was 15-45% before the ring).
   static uint64_t s_render_wait_accum = 0;
 
+  // Paced frames run as ~5 ms slices (subcycle_bridge_set_slicing): each
+  // slice's audio goes to the ring as soon as it is made, and the matrix is
+  // re-read between slices, so sound and key presses no longer wait a whole
+  // frame. The frame loop below still sees one call per frame.
+  BridgeSliceIO slice_io;
+  slice_io.audio = [](void*, const int16_t* samples, size_t count) {
+    if (CPC.snd_enabled && !g_emu_paused.load(std::memory_order_relaxed))
+      audio_push_buffer(reinterpret_cast<const byte*>(samples),
+                        static_cast<int>(count * sizeof(int16_t)));
+  };
+  slice_io.rows = [](void*, uint8_t rows[16]) {
+    for (int i = 0; i < 16; i++)
+      rows[i] = keyboard_matrix_live[i].load(std::memory_order_relaxed);
+  };
+  subcycle_bridge_set_slicing(kEmuSliceUs, slice_io);
+
   while (!g_z80_thread_quit.load(std::memory_order_relaxed)) {
     if (g_emu_paused.load(std::memory_order_relaxed)) {
       // Mark quiescent so cpc_pause_and_wait() callers know we are safe to
       // inspect.
       g_z80_quiescent.store(true, std::memory_order_release);
+      ipc_drain_commands();
       std::this_thread::sleep_for(std::chrono::milliseconds(1));
       continue;
     }
@@ -3241,15 +3335,10 @@ void z80_thread_main() {
             imgui_state.audio_queue_min_ms = 0;
             imgui_state.audio_push_interval_max_us = 0;
           } else {
-            double const avg_bytes = audio_queue_sum_bytes / audio_push_count;
-            int frame_size = CPC.snd_stereo ? 4 : 2;
-            if (CPC.snd_bits == 0) frame_size /= 2;
-            int const sample_rate = freq_table[CPC.snd_playback_rate];
-            double const bytes_per_ms = sample_rate * frame_size / 1000.0;
             imgui_state.audio_queue_avg_ms =
-                static_cast<float>(avg_bytes / bytes_per_ms);
+                static_cast<float>(audio_fill_sum_ms / audio_push_count);
             imgui_state.audio_queue_min_ms =
-                static_cast<float>(audio_queue_min_bytes / bytes_per_ms);
+                static_cast<float>(audio_fill_min_ms);
             imgui_state.audio_push_interval_max_us = static_cast<float>(
                 static_cast<double>(audio_push_interval_max) * 1000000.0 /
                 perfFreq);
@@ -3257,8 +3346,8 @@ void z80_thread_main() {
           audio_underrun_count = 0;
           audio_near_underrun_count = 0;
           audio_push_count = 0;
-          audio_queue_sum_bytes = 0;
-          audio_queue_min_bytes = INT_MAX;
+          audio_fill_sum_ms = 0;
+          audio_fill_min_ms = 1e9;
           audio_push_interval_max = 0;
         }  // g_imgui_stats_mutex
       }
@@ -3336,7 +3425,8 @@ void z80_thread_main() {
                                        // the probe before this frame runs
         // Sub-cycle engine: one whole frame of the pin-level board. Keyboard
         // comes from the published matrix (so autotype/IPC/session all work);
-        // audio uses the existing SDL push path; pacing is the bridge's own
+        // audio uses the existing SDL push path — per slice when paced (the
+        // sink above), per frame otherwise; pacing is the bridge's own
         // 50 Hz deadline (the legacy limiter below only acts on
         // EC_CYCLE_COUNT, which this engine never emits).
         uint8_t rows[16];
@@ -3344,21 +3434,16 @@ void z80_thread_main() {
           rows[i] = keyboard_matrix_live[i].load(std::memory_order_relaxed);
         if (tape_line_in_active())  // mic -> Schmitt -> the deck's line queue
           tape_line_in_pump(*subcycle_bridge_machine());
-        // Blit at presentation rate, not emulation rate: the bridge's scaled
-        // blit is a second full-frame format conversion (the machine's video
-        // device already rendered into its own fb — that cost is inherent,
-        // like the legacy renderer's). An uncapped run emits thousands of
-        // frames a second while the render side consumes ~60; converting
-        // every one of them was measured at ~2 ms/frame — a 6× cap on the
-        // Fast tier under §8.3. Capped (50 Hz) sessions blit every frame as
-        // before; consumers (display, screenshots, recorders) see a surface
-        // at most one presentation period stale.
-        static uint64_t s_last_blit = 0;
-        const uint64_t blit_now = SDL_GetPerformanceCounter();
-        const bool blit_due =
-            limit_now ||
-            blit_now - s_last_blit >= SDL_GetPerformanceFrequency() / 60;
-        if (blit_due) s_last_blit = blit_now;
+        // Paint and blit at presentation rate, not emulation rate: an
+        // uncapped run emits thousands of frames a second while the render
+        // side consumes one per display refresh. Converting every one of
+        // them was measured at ~2 ms/frame — a 6× cap on the Fast tier under
+        // §8.3 — and the video device's own painting is the next cap, so
+        // frames not due for presentation are run with the pixel path off
+        // (frame skipping, subcycle_bridge.h). Capped (50 Hz) sessions paint
+        // and blit every frame as before; consumers (display, screenshots,
+        // recorders) see a surface at most one presentation period stale.
+        const bool blit_due = subcycle_bridge_present_due(limit_now);
         const std::vector<int16_t>& frame_audio = subcycle_bridge_frame(
             rows, blit_due ? back_surface : nullptr, limit_now);
         if (!frame_audio.empty() && CPC.snd_enabled &&
@@ -3499,6 +3584,11 @@ void z80_thread_main() {
 
       ipc_check_vbl_events();
 
+      // IPC commands that touch machine state run here, between frames (a
+      // command that pauses-and-waits returns at once on this thread — see
+      // cpc_pause_and_wait).
+      ipc_drain_commands();
+
       if (g_m4board.activity_frames > 0) g_m4board.activity_frames--;
 
       if (g_ym_recorder.is_recording()) {
@@ -3775,15 +3865,13 @@ bool render_one_frame() {
   displayTimeAccum.fetch_add(displayEnd - displayStart,
                              std::memory_order_relaxed);
   if (audio_stream && CPC.snd_ready) {
-    int queued = SDL_GetAudioStreamQueued(audio_stream);
-    queued = std::max(queued, 0);
-    audio_queue_min_bytes = std::min(queued, audio_queue_min_bytes);
-    if (queued < static_cast<int>(CPC.snd_buffersize) / 2 &&
-        audio_push_count > 0) {
+    const AudioRingStats st = g_audio_ring.stats();
+    audio_fill_min_ms = std::min(st.fill_ms(), audio_fill_min_ms);
+    if (st.fill_ms() < st.target_ms() / 2 && audio_push_count > 0) {
       [[maybe_unused]] double const display_ms =
           static_cast<double>(displayEnd - displayStart) * 1000.0 / perfFreq;
-      LOG_DEBUG("Audio low queue after display: "
-                << queued << "B, display took " << display_ms << "ms");
+      LOG_DEBUG("Audio low ring after display: "
+                << st.fill_ms() << "ms, display took " << display_ms << "ms");
     }
   }
   video_take_pending_window_screenshot();
@@ -3852,6 +3940,26 @@ int koncpc_main(int argc, char** argv) {
   g_log_fps = args.fps;
   g_exit_on_break = args.exitOnBreak;
 
+  // --render-audio: headless, and --exit-after is the render length rather
+  // than a wall-clock exit.
+  if (!args.renderAudio.empty()) {
+    g_render_opts.wav_path = args.renderAudio;
+    g_render_opts.ym_path = args.renderYm;
+    if (!audio_render_parse_length(args.exitAfter, g_render_opts.max_frames)) {
+      fprintf(stderr, "--render-audio needs --exit-after=<n>f|<n>s|<n>ms\n");
+      _exit(1);
+    }
+    if (!args.renderUntil.empty() &&
+        !audio_render_parse_until(args.renderUntil, g_render_opts)) {
+      fprintf(stderr, "bad --render-until '%s' (silence:<frames>)\n",
+              args.renderUntil.c_str());
+      _exit(1);
+    }
+    g_headless = true;
+    g_render_pending = true;
+    args.exitAfter.clear();
+  }
+
   // Parse --exit-after spec: Nf (frames), Ns (seconds), Nms (milliseconds)
   if (!args.exitAfter.empty()) {
     const std::string& spec = args.exitAfter;
@@ -3905,6 +4013,7 @@ int koncpc_main(int argc, char** argv) {
 
   std::string const config_file = getConfigurationFilename();
   loadConfiguration(CPC, config_file);  // retrieve the emulator configuration
+  library::service().set_path(libraryIndexFilename());
   if (CPC.printer) {
     if (!printer_start()) {  // start capturing printer output, if enabled
       CPC.printer = 0;
@@ -4093,6 +4202,7 @@ int koncpc_main(int argc, char** argv) {
             CPC.rom_path.c_str());
     cleanExit(ERR_CPC_ROM_MISSING, false);
   }
+  publish_display_hz();
   if (!g_headless) {
     g_z80_thread = std::thread(z80_thread_main);
   }
@@ -4593,6 +4703,10 @@ int koncpc_main(int argc, char** argv) {
             koncpc_rescue_window_onscreen(mainSDLWindow, 1);
           }
           break;
+        case SDL_EVENT_WINDOW_DISPLAY_CHANGED:
+        case SDL_EVENT_DISPLAY_CURRENT_MODE_CHANGED:
+          publish_display_hz();
+          break;
         case SDL_EVENT_WINDOW_FOCUS_GAINED:
           if (CPC.auto_pause) {
             cpc_resume();
@@ -4678,16 +4792,10 @@ int koncpc_main(int argc, char** argv) {
           imgui_state.audio_queue_min_ms = 0;
           imgui_state.audio_push_interval_max_us = 0;
         } else if (audio_push_count > 0) {
-          // Convert queue depth from bytes to milliseconds
-          double const avg_bytes = audio_queue_sum_bytes / audio_push_count;
-          int frame_size = CPC.snd_stereo ? 4 : 2;  // 16-bit stereo=4, mono=2
-          if (CPC.snd_bits == 0) frame_size /= 2;   // 8-bit halves it
-          int const sample_rate = freq_table[CPC.snd_playback_rate];
-          double const bytes_per_ms = sample_rate * frame_size / 1000.0;
           imgui_state.audio_queue_avg_ms =
-              static_cast<float>(avg_bytes / bytes_per_ms);
+              static_cast<float>(audio_fill_sum_ms / audio_push_count);
           imgui_state.audio_queue_min_ms =
-              static_cast<float>(audio_queue_min_bytes / bytes_per_ms);
+              static_cast<float>(audio_fill_min_ms);
           imgui_state.audio_push_interval_max_us =
               static_cast<float>(static_cast<double>(audio_push_interval_max) *
                                  1000000.0 / perfFreq);
@@ -4695,8 +4803,8 @@ int koncpc_main(int argc, char** argv) {
         audio_underrun_count = 0;
         audio_near_underrun_count = 0;
         audio_push_count = 0;
-        audio_queue_sum_bytes = 0;
-        audio_queue_min_bytes = INT_MAX;
+        audio_fill_sum_ms = 0;
+        audio_fill_min_ms = 1e9;
         audio_push_interval_max = 0;
       }
 
@@ -4785,12 +4893,8 @@ int koncpc_main(int argc, char** argv) {
             rows[i] = keyboard_matrix_live[i].load(std::memory_order_relaxed);
           if (tape_line_in_active())
             tape_line_in_pump(*subcycle_bridge_machine());
-          static uint64_t s_last_blit_hl = 0;
-          const uint64_t blit_now = SDL_GetPerformanceCounter();
           const bool blit_due =
-              CPC.limit_speed != 0 ||
-              blit_now - s_last_blit_hl >= SDL_GetPerformanceFrequency() / 60;
-          if (blit_due) s_last_blit_hl = blit_now;
+              subcycle_bridge_present_due(CPC.limit_speed != 0);
           const std::vector<int16_t>& frame_audio = subcycle_bridge_frame(
               rows, blit_due ? back_surface : nullptr, false);
           if (!frame_audio.empty() && CPC.snd_enabled && !CPC.paused) {
@@ -4888,6 +4992,26 @@ int koncpc_main(int argc, char** argv) {
           lastFrameStart = now;
         }
 
+        // --render-audio: the autocmd (if any) has been typed at real speed;
+        // the rest runs unpaced straight into the file.
+        if (g_render_pending && !g_autotype_queue.is_active()) {
+          g_render_pending = false;
+          subcycle::Machine* mach = subcycle_bridge_machine();
+          if (!mach) {
+            LOG_ERROR("--render-audio needs the sub-cycle engine");
+            cleanExit(1, false);
+          }
+          AudioRenderResult const r = render_audio_offline(*mach, g_render_opts);
+          if (!r.ok) {
+            LOG_ERROR("render: " << r.error);
+            cleanExit(1, false);
+          }
+          LOG_INFO("render: " << r.frames << " frames, " << r.audio_seconds()
+                              << " s of audio in " << r.wall_seconds << " s"
+                              << (r.stopped_on_silence ? " (silence)" : ""));
+          cleanExit(0, false);
+        }
+
         // Check --exit-after condition
         if (g_exit_mode == EXIT_FRAMES &&
             dwFrameCountOverall >= g_exit_target) {
@@ -4909,6 +5033,8 @@ int koncpc_main(int argc, char** argv) {
 
         // IPC mouse input — flush staged deltas/buttons into the devices
         ipc_drain_input();
+        // IPC commands that touch machine state — between frames
+        ipc_drain_commands();
 
 #ifdef __APPLE__
         // Update Dock icon with CPC screen preview (~1fps at 50fps emulation)
@@ -5092,21 +5218,18 @@ int koncpc_main(int argc, char** argv) {
             displayTimeAccum.fetch_add(displayEnd - displayStart,
                                        std::memory_order_relaxed);
 
-            // Check audio queue after display (GL viewport stalls drain it)
-            // Sample audio queue depth after display — catches GL stalls.
+            // Sample the audio ring's fill after display — catches GL stalls.
             // Only updates min (underrun counting is done in audio_push_buffer
             // to avoid double-counting).
             if (audio_stream && CPC.snd_ready) {
-              int queued = SDL_GetAudioStreamQueued(audio_stream);
-              queued = std::max(queued, 0);
-              audio_queue_min_bytes = std::min(queued, audio_queue_min_bytes);
-              if (queued < static_cast<int>(CPC.snd_buffersize) / 2 &&
-                  audio_push_count > 0) {
+              const AudioRingStats st = g_audio_ring.stats();
+              audio_fill_min_ms = std::min(st.fill_ms(), audio_fill_min_ms);
+              if (st.fill_ms() < st.target_ms() / 2 && audio_push_count > 0) {
                 [[maybe_unused]] double const display_ms =
                     static_cast<double>(displayEnd - displayStart) * 1000.0 /
                     perfFreq;
-                LOG_DEBUG("Audio low queue after display: "
-                          << queued << "B, display took " << display_ms
+                LOG_DEBUG("Audio low ring after display: "
+                          << st.fill_ms() << "ms, display took " << display_ms
                           << "ms");
               }
             }
@@ -5125,6 +5248,7 @@ int koncpc_main(int argc, char** argv) {
       // work)
       if (g_m4_http.is_running()) g_m4_http.drain_pending();
       ipc_drain_input();
+      ipc_drain_commands();
       std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
     }
 
@@ -20,6 +20,8 @@
 #include "types.h"
 
 class InputMapper;
+class PngDumpPool;
+struct AudioRingStats;
 
 // Version is injected by the build system from the top-level VERSION
 // file (CMake: target_compile_definitions; makefile: KONCPC_VERSION).
@@ -210,6 +212,7 @@ class t_CPC {
   unsigned int keyboard_line;
   unsigned int tape_motor;
   unsigned int tape_play_button;
+  unsigned int tape_flash_load;  // trap CAS READ: standard records load at once
   unsigned int printer;
   unsigned int printer_port;
   unsigned int mf2;
@@ -571,6 +574,8 @@ void cpc_resume();
 void cpc_pause_and_wait();
 void bin_load(const std::string& filename, const size_t offset);
 bool dumpScreenTo(const std::string& path);
+// Copy the screen into `pool` for a background PNG encode to `path`.
+bool queueScreenDump(PngDumpPool& pool, const std::string& path);
 void dumpScreen();
 int emulator_init();
 
@@ -598,6 +603,9 @@ void audio_pause();
 void audio_resume();
 void audio_enable();        // runtime "Enable Sound": lazily opens the stream
 void audio_apply_volume();  // push CPC.snd_volume to the AY stream's gain
+// The AY ring's live counters (audio_ring.h); false while no stream is open.
+bool audio_ring_stats(AudioRingStats& out);
+void audio_set_latency_ms(double ms);  // the ring's target fill (2..250 ms)
 void mouse_init();
 int video_init();
 void video_shutdown();
@@ -18,12 +18,16 @@
 #include <algorithm>
 #include <cctype>
 #include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <iomanip>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <sstream>
@@ -37,7 +41,7 @@
 #include <ws2tcpip.h>
 #else
 #include <netinet/in.h>
-#include <sys/select.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #endif
@@ -45,6 +49,8 @@
 #include "SDL3/SDL.h"
 #include "amx_mouse.h"
 #include "asic_debug.h"
+#include "audio_render.h"
+#include "audio_ring.h"
 #include "avi_recorder.h"
 #include "config_profile.h"
 #include "cpc_key_tables.h"
@@ -63,9 +69,11 @@
 #include "koncepcja.h"
 #include "m4board.h"
 #include "m4board_http.h"
+#include "media_library.h"
 #include "phazer_type.h"
 #include "plotter.h"
 #include "plotter_view.h"
+#include "png_dump.h"
 #include "pokes.h"
 #include "serial_interface.h"
 #include "session_recording.h"
@@ -233,6 +241,18 @@ std::string err_with_context(int code, const std::string& msg) {
 }
 }  // namespace
 
+// AVI encoder pipeline counters, as status fields.
+namespace {
+std::string avi_pipeline_fields() {
+  const AviRecorder::PipelineStats st = g_avi_recorder.pipeline_stats();
+  return "queued=" + std::to_string(st.queued) + "/" +
+         std::to_string(st.capacity) +
+         " peak=" + std::to_string(st.queue_peak) +
+         " dropped=" + std::to_string(st.dropped_frames) +
+         " waits=" + std::to_string(st.backpressure_waits);
+}
+}  // namespace
+
 // Direct keyboard matrix manipulation that works even when CPC.paused is true.
 // applyKeypress() refuses to act when paused, but IPC input commands need to
 // set keys before resuming emulation for frame stepping.
@@ -472,10 +492,10 @@ void init_command_registry() {
       "render)\n"
       "  z80_time_avg_us     — Z80 execution wall-clock\n"
       "  sleep_time_avg_us   — idle sleep between frames\n"
-      "  audio_queue_avg_ms  — avg SDL audio queue depth over the last second\n"
-      "  audio_queue_min_ms  — min SDL audio queue depth (underrun indicator)\n"
+      "  audio_queue_avg_ms  — avg audio ring fill over the last second\n"
+      "  audio_queue_min_ms  — min audio ring fill (underrun indicator)\n"
       "  audio_underruns     — actual underrun count since last sample\n"
-      "  audio_near_underruns — near-underrun count (queue < 1 buffer)\n"
+      "  audio_near_underruns — near-underrun count (fill < half the target)\n"
       "Used by Phase 8 perf verification to compare GPU vs GL plugin timing.",
       [](const auto&, const auto&) {
         // Snapshot under the lock, format outside — avoids holding the
@@ -550,6 +570,15 @@ void init_command_registry() {
                    "(with optional exit code); use 'disconnect' to close only "
                    "the connection.");
 
+  register_command(
+      "binary", "CORE", "binary",
+      "Switch this connection to binary frames",
+      "Replies 'OK binary v1', after which the connection speaks "
+      "length-prefixed binary frames (u32 len | u32 id | u8 op | payload, "
+      "little-endian) carrying raw memory ranges, device state blobs, the "
+      "framebuffer, audio blocks or text commands, answered in order with the "
+      "same id. Op 5 returns to text. See docs/ipc-protocol.md.");
+
   register_command("pause", "CORE", "pause", "Pause emulation",
                    "Stops the Z80 CPU and machine timers. The UI remains "
                    "responsive and can still be used to inspect state.");
@@ -567,6 +596,7 @@ void init_command_registry() {
   register_command(
       "tape", "MEDIA",
       "tape play|stop|rewind|eject|status | tape seek <block> | "
+      "tape flash [on|off] | "
       "tape volume [0-100] | tape linein on [left|right|mix] | tape linein off",
       "Cassette deck control",
       "play/stop drive the PLAY button (the firmware owns the motor relay). "
@@ -590,8 +620,6 @@ void init_command_registry() {
       "extension.\n"
       "  Disks   (.dsk .ipf .raw) and flux images (.scp .hfe .a2r) load into "
       "Drive A.\n"
-      "          Flux formats are Drive A only — the FDC's flux capture is "
-      "side-0/drive-A.\n"
       "  Tapes   (.cdt .voc), snapshots (.sna), cartridges (.cpr), raw "
       "binaries (.bin at 0x6000).");
 
@@ -602,6 +630,16 @@ void init_command_registry() {
                    "the effective tier and whether a KONCPC_TIER/KONCPC_WAKE "
                    "env pin overrides the policy.");
 
+  register_command(
+      "audio", "SYSTEM", "audio [stats] | audio latency <ms>",
+      "Audio ring latency and underrun statistics",
+      "The emulation hands audio to the device through a lock-free ring; an\n"
+      "adaptive resampler steers its fill toward a target latency.\n"
+      "  stats (default): OK target_ms= fill_ms= ratio= underruns= dropped=\n"
+      "    pushed= pulled= src_hz= dst_hz= — counters are since the stream\n"
+      "    opened; ratio is the live rate correction (1.000000 = nominal).\n"
+      "  latency <ms>: set the target fill (2-250, default 30).");
+
   register_command("regs", "DEBUG", "regs",
                    "Get all Z80 and core hardware registers",
                    "Returns a comprehensive list of all Z80 registers (AF, BC, "
@@ -783,19 +821,50 @@ void init_command_registry() {
       "Manage machine snapshots",
       "Saves or loads the entire state of the emulated CPC into a .SNA file.");
 
-  register_command("record", "MEDIA", "record wav|ym|avi <start|stop> [path]",
+  register_command(
+      "library", "MEDIA",
+      "library scan [dir...] | library status | library find <query> "
+      "[limit=N]",
+      "Search the indexed media collection",
+      "Indexes and searches a collection of disc, tape, snapshot and "
+      "cartridge images (and .zip archives holding one).\n"
+      "  scan:   Rescan the given directories (default: the previous scan's) "
+      "in the background; unchanged files are not re-read.\n"
+      "  status: Entry count, scan progress and the last scan error.\n"
+      "  find:   Fuzzy-match file names, AMSDOS catalogs, formats and "
+      "protection hints; one line per hit: score, kind, path, then "
+      "format=, hints= and catalog= (limit defaults to 20).");
+
+  register_command("record", "MEDIA",
+                   "record wav|ym|avi <start|stop|status> [path] | "
+                   "record render <wav> <length> [ym=<path>] "
+                   "[until=silence:N] | record status",
                    "Record audio or video",
                    "Records the emulator output to various file formats.\n"
-                   "  wav:  Record audio to a WAV file.\n"
-                   "  ym:   Record PSG registers to a YM file.\n"
-                   "  avi:  Record video and audio to an AVI file.");
+                   "  wav:    Record audio to a WAV file.\n"
+                   "  ym:     Record PSG registers to a YM file.\n"
+                   "  avi:    Record video and audio to an AVI file;\n"
+                   "          'record avi start <path> [quality|zmbv]' — MJPEG\n"
+                   "          at quality 1-100, or lossless ZMBV.\n"
+                   "  render: Fast-forward the machine unpaced and write\n"
+                   "          <length> (<n>f, <n>s, <n>ms) of its audio to a\n"
+                   "          16-bit stereo WAV, plus a YM file with ym=;\n"
+                   "          until=silence:N ends once N frames are silent.\n"
+                   "  status: Every recorder's state, with the AVI encoder "
+                   "queue depth, dropped frames and back-pressure waits.");
 
   register_command(
-      "frames", "MEDIA", "frames dump <pattern> <count>",
+      "frames", "MEDIA",
+      "frames dump <pattern> <count> [delay_cs] [level=N filter=F jobs=N "
+      "queue=N]",
       "Dump series of frames",
       "Dumps a sequence of frames to an animated GIF (if pattern ends in .gif) "
       "or a series of PNG files. Pattern can include %d or %04d for frame "
-      "numbering.");
+      "numbering. delay_cs is the GIF frame delay and is ignored for PNGs. "
+      "PNGs are 8-bit paletted when a frame fits 256 colours and are encoded "
+      "on a worker pool; level is the zlib level (0-9), filter one of "
+      "auto|none|sub|up|avg|paeth|all. The reply reports saved and failed "
+      "frames, bytes, and queue use.");
 
   register_command(
       "devtools", "TOOLS", "devtools <on|off|show|hide> [name]",
@@ -904,11 +973,18 @@ void init_command_registry() {
                    "  list: Show all registered events.");
 
   register_command("hash", "DEBUG",
-                   "hash vram | hash mem <addr> <len> | hash regs",
+                   "hash vram | hash mem <addr> <len> | hash regs | "
+                   "hash render <pixels|hash> | hash frame",
                    "CRC32 hashes for CI assertions",
                    "Compute CRC32 of screen surface, memory range, or packed "
                    "register state.\n"
-                   "Useful for deterministic regression testing.");
+                   "Useful for deterministic regression testing.\n"
+                   "  render hash:   Render-less mode: frames paint nothing and "
+                   "fold their render inputs into a per-frame hash instead "
+                   "(applies at the next frame).\n"
+                   "  render pixels: Back to normal painting.\n"
+                   "  frame:         Hash of the last completed frame (render "
+                   "hash mode only).");
 
   register_command(
       "autotype", "INPUT", "autotype <text> | autotype status | autotype clear",
@@ -1136,6 +1212,19 @@ std::string handle_command(const std::string& line) {
         snprintf(buf, sizeof(buf), "OK crc32=%08lX\n", crc);
         return {buf};
       }
+      if (parts[1] == "render" && parts.size() >= 3) {
+        if (parts[2] != "hash" && parts[2] != "pixels")
+          return "ERR 400 usage: hash render <pixels|hash>\n";
+        subcycle_bridge_set_hash_only(parts[2] == "hash");
+        return "OK\n";
+      }
+      if (parts[1] == "frame") {
+        if (!subcycle_bridge_hash_only())
+          return "ERR 409 not-in-hash-mode (hash render hash)\n";
+        snprintf(buf, sizeof(buf), "OK frame=%08X\n",
+                 static_cast<unsigned>(subcycle_bridge_frame_hash()));
+        return {buf};
+      }
       if (parts[1] == "mem" && parts.size() >= 4) {
         unsigned int addr, len;
         try {
@@ -1232,6 +1321,30 @@ std::string handle_command(const std::string& line) {
              " effective=" + subcycle_bridge_effective_tier_name() +
              " pinned=" + (subcycle_bridge_tier_env_pinned() ? "1" : "0");
     }
+    if (cmd == "audio") {
+      if (parts.size() >= 3 && parts[1] == "latency") {
+        char* end = nullptr;
+        const double ms = std::strtod(parts[2].c_str(), &end);
+        if (end == parts[2].c_str() || *end != '\0' || ms < 2 || ms > 250)
+          return "ERR 400 bad-args (latency 2-250 ms)\n";
+        audio_set_latency_ms(ms);
+      } else if (parts.size() >= 2 && parts[1] != "stats") {
+        return "ERR 400 bad-args (audio [stats] | audio latency <ms>)\n";
+      }
+      AudioRingStats st;
+      if (!audio_ring_stats(st)) return "ERR 503 no-audio-stream\n";
+      char buf[320];
+      snprintf(buf, sizeof(buf),
+               "OK target_ms=%.1f fill_ms=%.1f ratio=%.6f underruns=%llu "
+               "dropped=%llu pushed=%llu pulled=%llu src_hz=%d dst_hz=%d\n",
+               st.target_ms(), st.fill_ms(), st.ratio,
+               static_cast<unsigned long long>(st.underruns),
+               static_cast<unsigned long long>(st.dropped),
+               static_cast<unsigned long long>(st.pushed),
+               static_cast<unsigned long long>(st.pulled), st.src_rate,
+               st.dst_rate);
+      return {buf};
+    }
     if (cmd == "pause") {
       cpc_pause();
       return ok_with_context();
@@ -1674,8 +1787,8 @@ std::string handle_command(const std::string& line) {
       }
       if (parts[1] == "seek" && parts.size() >= 3) {
         // tape seek <block> — jump the deck to the Nth scanned block
-        // (engine=1); the deck walks its own cdt to the ordinal. Applied on the
-        // Z80 thread at the frame boundary. Range-checked against the host
+        // (engine=1) through the deck's block index. Applied on the Z80
+        // thread at the frame boundary. Range-checked against the host
         // block table.
         if (!mach) return "ERR 409 subcycle-engine-only\n";
         if (imgui_state.tape_block_offsets.empty()) return "ERR 409 no-tape\n";
@@ -1704,8 +1817,11 @@ std::string handle_command(const std::string& line) {
              << " pos=" << tr.pos
              << " linein=" << static_cast<int>(tr.line_mode)
              << " lineout=" << (tape_line_out_active() ? 1 : 0)
-             << " error=" << static_cast<int>(tr.error);
+             << " error=" << static_cast<int>(tr.error)
+             << " ms=" << (tr.cycle / 16000)
+             << " total_ms=" << (tr.total / 16000);
         }
+        os << " flash=" << (CPC.tape_flash_load ? 1 : 0);
         // Loaded cassette path (CPC.tape.file). Printed outside the `mach`
         // gate so it reports under either engine. Trailing field: existing
         // parsers keyed to the front of the line are unaffected.
@@ -1713,6 +1829,22 @@ std::string handle_command(const std::string& line) {
         os << "\n";
         return os.str();
       }
+      if (parts[1] == "flash") {
+        // tape flash [on|off] — instant loading of standard firmware records
+        // (CAS READ trap, tape-device.md §8); no arg reports. Persists via
+        // [system] tape_flash_load.
+        if (parts.size() >= 3) {
+          if (parts[2] == "on") {
+            CPC.tape_flash_load = 1;
+          } else if (parts[2] == "off") {
+            CPC.tape_flash_load = 0;
+          } else {
+            return "ERR 400 bad-args\n";
+          }
+        }
+        return std::string("OK flash=") + (CPC.tape_flash_load ? "1" : "0") +
+               "\n";
+      }
       if (parts[1] == "volume") {
         // tape volume [<0-100>] — level of the tape data monitor ("screech");
         // no arg reports. Persists via [sound] tape_data_volume.
@@ -2557,7 +2689,7 @@ std::string handle_command(const std::string& line) {
     if (cmd == "trace")
       return "ERR 400 usage: trace (on|off|dump|on_crash|status)\n";
 
-    // Frame dumps: frames dump <path_pattern> <count> [delay_cs]
+    // Frame dumps: frames dump <path_pattern> <count> [delay_cs] [opts...]
     // If path ends in .gif → animated GIF; otherwise → PNG series
     if (cmd == "frames" && parts.size() >= 4 && parts[1] == "dump") {
       const std::string& pattern = parts[2];
@@ -2579,7 +2711,7 @@ std::string handle_command(const std::string& line) {
         int delay_cs = 2;  // default: 50fps (matches CPC VBL rate)
         if (parts.size() >= 5) delay_cs = parse_int(parts[4]);
         GifRecorder gif;
-        if (!gif.begin(back_surface->w, back_surface->h, delay_cs)) {
+        if (!gif.begin(pattern, back_surface->w, back_surface->h, delay_cs)) {
           return "ERR 500 gif-begin-failed\n";
         }
         for (int i = 0; i < frame_count; i++) {
@@ -2595,7 +2727,7 @@ std::string handle_command(const std::string& line) {
           gif.add_frame(static_cast<const uint8_t*>(back_surface->pixels),
                         back_surface->pitch);
         }
-        if (gif.end(pattern)) {
+        if (gif.end()) {
           char buf[64];
           snprintf(buf, sizeof(buf), "OK frames=%d\n", frame_count);
           return {buf};
@@ -2603,8 +2735,52 @@ std::string handle_command(const std::string& line) {
         return "ERR 500 gif-write-failed\n";
       }
 
-      // PNG series output
-      int saved = 0;
+      // PNG series output: frames are copied into a bounded queue and
+      // encoded on a worker pool while the next ones are emulated.
+      PngOptions png_opts;
+      int jobs = 0;
+      size_t queue_cap = 16;
+      for (size_t a = 4; a < parts.size(); a++) {
+        const std::string& opt = parts[a];
+        const size_t eq = opt.find('=');
+        // The positional delay_cs is GIF-only; PNG series have always taken
+        // and ignored it, so scripts can share one command line for both.
+        if (a == 4 && eq == std::string::npos && !opt.empty() &&
+            opt.find_first_not_of("0123456789") == std::string::npos)
+          continue;
+        if (eq == std::string::npos) return "ERR 400 bad-option " + opt + "\n";
+        const std::string key = opt.substr(0, eq);
+        const std::string val = opt.substr(eq + 1);
+        try {
+          if (key == "level") {
+            png_opts.zlib_level = parse_int(val);
+            if (png_opts.zlib_level < 0 || png_opts.zlib_level > 9)
+              return "ERR 400 bad-level (0-9)\n";
+          } else if (key == "filter") {
+            if (!png_filter_from_string(val, png_opts.filter))
+              return "ERR 400 bad-filter (auto|none|sub|up|avg|paeth|all)\n";
+          } else if (key == "jobs") {
+            jobs = parse_int(val);
+            if (jobs < 1 || jobs > 64) return "ERR 400 bad-jobs (1-64)\n";
+          } else if (key == "queue") {
+            const int q = parse_int(val);
+            if (q < 1 || q > 256) return "ERR 400 bad-queue (1-256)\n";
+            queue_cap = static_cast<size_t>(q);
+          } else {
+            return "ERR 400 bad-option " + opt + "\n";
+          }
+        } catch (const std::exception&) {
+          return "ERR 400 bad-option " + opt + "\n";
+        }
+      }
+      if (pattern.find('%') != std::string::npos &&
+          pattern.find("%04d") == std::string::npos &&
+          pattern.find("%d") == std::string::npos) {
+        return "ERR 400 bad-format (only %d or %04d supported)\n";
+      }
+      auto const t0 = std::chrono::steady_clock::now();
+      PngDumpPool pool(jobs, queue_cap, png_opts);
+      int missed = 0;  // frames with no surface to copy
       for (int i = 0; i < frame_count; i++) {
         if (g_ipc_instance) {
           g_ipc_instance->frame_step_remaining.store(1);
@@ -2614,29 +2790,40 @@ std::string handle_command(const std::string& line) {
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
           }
         }
-        char fname[512];
+        std::string fname = pattern;
         if (pattern.find('%') != std::string::npos) {
           // Safe replacement for common patterns
-          std::string fname_str = pattern;
           size_t p;
-          if ((p = fname_str.find("%04d")) != std::string::npos) {
+          if ((p = fname.find("%04d")) != std::string::npos) {
             char buf[16];
             snprintf(buf, sizeof(buf), "%04d", i);
-            fname_str.replace(p, 4, buf);
-          } else if ((p = fname_str.find("%d")) != std::string::npos) {
-            fname_str.replace(p, 2, std::to_string(i));
-          } else {
-            return "ERR 400 bad-format (only %d or %04d supported)\n";
+            fname.replace(p, 4, buf);
+          } else if ((p = fname.find("%d")) != std::string::npos) {
+            fname.replace(p, 2, std::to_string(i));
           }
-          snprintf(fname, sizeof(fname), "%s", fname_str.c_str());
         } else {
-          snprintf(fname, sizeof(fname), "%s_%04d.png", pattern.c_str(), i);
+          char buf[16];
+          snprintf(buf, sizeof(buf), "_%04d.png", i);
+          fname += buf;
         }
-        if (dumpScreenTo(fname)) saved++;
+        if (!queueScreenDump(pool, fname)) missed++;
       }
-      char buf[64];
-      snprintf(buf, sizeof(buf), "OK saved=%d\n", saved);
-      return {buf};
+      const PngDumpPool::Report rep = pool.finish();
+      auto const ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - t0)
+                          .count();
+      char buf[256];
+      snprintf(buf, sizeof(buf),
+               "OK saved=%u failed=%u paletted=%u bytes=%llu jobs=%d "
+               "peak=%u/%zu waits=%llu ms=%lld",
+               rep.written, rep.failed + static_cast<uint32_t>(missed),
+               rep.paletted, static_cast<unsigned long long>(rep.bytes),
+               pool.threads(), rep.queue_peak, queue_cap,
+               static_cast<unsigned long long>(rep.waits),
+               static_cast<long long>(ms));
+      std::string out = buf;
+      if (!rep.first_error.empty()) out += " error=\"" + rep.first_error + "\"";
+      return out + "\n";
     }
 
     // Input replay commands
@@ -3600,6 +3787,58 @@ std::string handle_command(const std::string& line) {
     }
 
     // --- Disk management commands ---
+    if (cmd == "library") {
+      if (parts.size() < 2)
+        return "ERR 400 missing subcommand (scan|status|find)\n";
+      library::Service& lib = library::service();
+      if (parts[1] == "scan") {
+        std::vector<std::string> roots(parts.begin() + 2, parts.end());
+        if (lib.scanning()) return "ERR 409 scan-in-progress\n";
+        if (!lib.start_scan(std::move(roots)))
+          return "ERR 400 usage: library scan <dir...>\n";
+        return "OK scanning\n";
+      }
+      if (parts[1] == "status") {
+        std::ostringstream resp;
+        resp << "OK entries=" << lib.size()
+             << " scanning=" << (lib.scanning() ? 1 : 0)
+             << " done=" << lib.scan_done() << " total=" << lib.scan_total()
+             << " index=\"" << lib.path() << "\"";
+        const std::string err = lib.last_error();
+        if (!err.empty()) resp << " error=\"" << err << "\"";
+        resp << "\n";
+        return resp.str();
+      }
+      if (parts[1] == "find") {
+        std::string query;
+        size_t limit = 20;
+        for (size_t i = 2; i < parts.size(); i++) {
+          if (parts[i].rfind("limit=", 0) == 0) {
+            try {
+              limit = std::stoul(parts[i].substr(6));
+            } catch (const std::exception&) {
+              return "ERR 400 bad-limit\n";
+            }
+            continue;
+          }
+          if (!query.empty()) query += ' ';
+          query += parts[i];
+        }
+        if (query.empty())
+          return "ERR 400 usage: library find <query> [limit=N]\n";
+        std::ostringstream resp;
+        resp << "OK\n";
+        for (const library::Hit& h : lib.query(query, limit)) {
+          const library::Entry& e = h.entry;
+          resp << h.score << " " << library::kind_name(e.kind) << " \""
+               << e.path << "\" format=\"" << e.format << "\" hints=\""
+               << e.hints << "\" catalog=\"" << e.catalog << "\"\n";
+        }
+        return resp.str();
+      }
+      return "ERR 400 unknown library subcommand\n";
+    }
+
     if (cmd == "disk") {
       if (parts.size() < 2)
         return "ERR 400 missing subcommand "
@@ -3900,6 +4139,59 @@ std::string handle_command(const std::string& line) {
 
     // --- WAV audio recording ---
     if (cmd == "record" && parts.size() >= 2) {
+      // One line for every recorder; the AVI entry carries its encoder
+      // pipeline counters (queue depth, drops, back-pressure waits).
+      if (parts[1] == "status") {
+        std::string out = "OK";
+        out += g_wav_recorder.is_recording()
+                   ? " wav=" + g_wav_recorder.current_path()
+                   : std::string(" wav=idle");
+        out += g_ym_recorder.is_recording()
+                   ? " ym=" + g_ym_recorder.current_path()
+                   : std::string(" ym=idle");
+        if (g_avi_recorder.is_recording()) {
+          out += " avi=" + g_avi_recorder.current_path() +
+                 " frames=" + std::to_string(g_avi_recorder.frame_count()) +
+                 " " + avi_pipeline_fields();
+        } else {
+          out += " avi=idle";
+        }
+        return out + "\n";
+      }
+      // Offline render: fast-forward the paused machine and write its audio
+      // without pacing. `record render <wav> <length> [ym=<path>]
+      // [until=silence:<frames>]`; the length is capped by `until`.
+      if (parts[1] == "render") {
+        if (parts.size() < 4)
+          return "ERR 400 usage: record render <wav> <length>\n";
+        subcycle::Machine* mach = subcycle_bridge_machine();
+        if (!mach) return "ERR 503 no-subcycle-engine\n";
+        AudioRenderOptions opts;
+        opts.wav_path = parts[2];
+        if (!audio_render_parse_length(parts[3], opts.max_frames))
+          return "ERR 400 bad-length (<n>f|<n>s|<n>ms)\n";
+        for (size_t i = 4; i < parts.size(); i++) {
+          if (parts[i].rfind("ym=", 0) == 0) {
+            opts.ym_path = parts[i].substr(3);
+          } else if (parts[i].rfind("until=", 0) == 0) {
+            if (!audio_render_parse_until(parts[i].substr(6), opts))
+              return "ERR 400 bad-until (silence:<frames>)\n";
+          } else {
+            return "ERR 400 bad-option " + parts[i] + "\n";
+          }
+        }
+        bool const was_paused = CPC.paused;
+        if (!was_paused) cpc_pause_and_wait();
+        AudioRenderResult const r = render_audio_offline(*mach, opts);
+        if (!was_paused) cpc_resume();
+        if (!r.ok) return "ERR " + r.error + "\n";
+        char timing[96];
+        snprintf(timing, sizeof(timing), " seconds=%.2f wall=%.2f",
+                 r.audio_seconds(), r.wall_seconds);
+        return "OK frames=" + std::to_string(r.frames) + timing +
+               " ym_frames=" + std::to_string(r.ym_frames) +
+               " silence=" + (r.stopped_on_silence ? "1" : "0") + "\n";
+      }
       if (parts[1] == "wav") {
         if (parts.size() < 3)
           return "ERR 400 missing-action (start|stop|status)\n";
@@ -3957,17 +4249,22 @@ std::string handle_command(const std::string& line) {
         if (parts[2] == "start") {
           if (parts.size() < 4) return "ERR 400 missing-path\n";
           int quality = 85;
+          AviRecorder::Codec codec = AviRecorder::Codec::Mjpeg;
           if (parts.size() >= 5) {
-            try {
-              quality = parse_int(parts[4]);
-            } catch (const std::exception&) {
+            if (parts[4] == "zmbv" || parts[4] == "lossless") {
+              codec = AviRecorder::Codec::Zmbv;
+            } else {
+              try {
+                quality = parse_int(parts[4]);
+              } catch (const std::exception&) {
+              }
             }
           }
           uint32_t const rate = SAMPLE_RATES[CPC.snd_playback_rate];
           uint16_t const bits = CPC.snd_bits ? 16 : 8;
           uint16_t const channels = CPC.snd_stereo ? 2 : 1;
-          auto err =
-              g_avi_recorder.start(parts[3], quality, rate, channels, bits);
+          auto err = g_avi_recorder.start(parts[3], quality, rate, channels,
+                                          bits, codec);
           if (err.empty()) return "OK\n";
           return "ERR " + err + "\n";
         }
@@ -3982,15 +4279,16 @@ std::string handle_command(const std::string& line) {
             return "OK recording " + g_avi_recorder.current_path() +
                    " frames=" + std::to_string(g_avi_recorder.frame_count()) +
                    " bytes=" + std::to_string(g_avi_recorder.bytes_written()) +
-                   "\n";
+                   " " + avi_pipeline_fields() + "\n";
           }
           return "OK idle\n";
         }
         return "ERR 400 bad-avi-cmd (start|stop|status)\n";
       }
-      return "ERR 400 bad-record-cmd (wav|ym|avi)\n";
+      return "ERR 400 bad-record-cmd (wav|ym|avi|render|status)\n";
     }
-    if (cmd == "record") return "ERR 400 usage: record (wav|ym|avi)\n";
+    if (cmd == "record")
+      return "ERR 400 usage: record (wav|ym|avi|render|status)\n";
 
     // --- Poke commands ---
     if (cmd == "poke" && parts.size() >= 2) {
@@ -5412,132 +5710,569 @@ void ipc_check_vbl_events() {
   if (g_ipc_instance) g_ipc_instance->check_vbl_events();
 }
 
-#ifdef _WIN32
 
-void KoncepcjaIpcServer::run() {
-  WSADATA wsa;
-  if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return;
+// --- Frame gate ---
+//
+// Commands that touch machine state run on the emulation thread between
+// frames (ipc_drain_commands), never alongside z80_execute(). A session hands
+// over its whole run of consecutive gated commands (text lines or binary
+// frames) as one batch, so a client that pipelines pays one frame boundary per
+// batch rather than one per command.
+namespace {
 
-  SOCKET server_fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-  if (server_fd == INVALID_SOCKET) {
-    WSACleanup();
-    return;
+// One command, bound to its arguments; returns the bytes to send back.
+using IpcJob = std::function<std::string()>;
+
+struct GateBatch {
+  std::vector<IpcJob> jobs;
+  std::vector<std::string> replies;
+  bool claimed = false;  // the emulation thread has taken it
+  bool done = false;
+};
+
+std::mutex g_gate_mutex;  // guards g_gate_queue and every batch's flags
+std::condition_variable g_gate_cv;
+std::deque<GateBatch*> g_gate_queue;
+std::atomic<bool> g_gate_pending{false};  // fast-path: skip the lock when idle
+// Steady-clock ms of the last drain (0 = never). A stale stamp means nothing is
+// draining — startup, a modal dialog, a test without a main loop — and the
+// commands run on the session's worker instead, as they always used to.
+std::atomic<int64_t> g_gate_last_drain_ms{0};
+std::atomic<bool> g_gate_pinned{false};  // ipc_pin_command_gate(true)
+constexpr int64_t kGateLiveMs = 500;
+constexpr int kGateWaitMs = 2000;
+
+// Serializes gated commands wherever they run, so two clients never interleave
+// inside one command even when the gate falls back to the workers.
+std::mutex g_ipc_exec_mutex;
+// Serializes the commands that block on the emulation thread (they share the
+// frame-step counter and the repaint handshake).
+std::mutex g_ipc_orchestrate_mutex;
+
+int64_t ipc_now_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::string run_jobs(const std::vector<IpcJob>& jobs) {
+  std::scoped_lock const lock(g_ipc_exec_mutex);
+  std::string out;
+  for (const auto& job : jobs) out += job();
+  return out;
+}
+
+std::string run_gated(std::vector<IpcJob> jobs) {
+  int64_t const last = g_gate_last_drain_ms.load(std::memory_order_acquire);
+  if (!g_gate_pinned.load(std::memory_order_acquire) &&
+      (last == 0 || ipc_now_ms() - last > kGateLiveMs))
+    return run_jobs(jobs);
+
+  GateBatch batch;
+  batch.jobs = std::move(jobs);
+  std::unique_lock<std::mutex> lock(g_gate_mutex);
+  g_gate_queue.push_back(&batch);
+  g_gate_pending.store(true, std::memory_order_release);
+  if (!g_gate_cv.wait_for(lock, std::chrono::milliseconds(kGateWaitMs),
+                          [&] { return batch.claimed; })) {
+    // The emulation thread stopped draining (shutdown, a blocking dialog):
+    // take the batch back rather than leave the client hanging.
+    g_gate_queue.erase(
+        std::find(g_gate_queue.begin(), g_gate_queue.end(), &batch));
+    g_gate_pending.store(!g_gate_queue.empty(), std::memory_order_release);
+    lock.unlock();
+    return run_jobs(batch.jobs);
+  }
+  g_gate_cv.wait(lock, [&] { return batch.done; });
+  std::string out;
+  for (const auto& r : batch.replies) out += r;
+  return out;
+}
+
+// Commands that block on the emulation thread (frame stepping, waits, the
+// repaint and window-screenshot handshakes, tap-and-hold input) or tear it
+// down. Queued behind a frame boundary they would wait for frames the
+// emulation thread cannot run while it is draining them, so they stay on the
+// session's worker.
+bool ipc_orchestrates(const std::string& cmd) {
+  const std::string name = cmd.substr(0, cmd.find_first_of(" \t"));
+  return name == "step" || name == "wait" || name == "repaint" ||
+         name == "screenshot" || name == "frames" || name == "input" ||
+         name == "quit";
+}
+
+}  // namespace
+
+bool ipc_commands_pending() {
+  return g_gate_pending.load(std::memory_order_acquire);
+}
+
+void ipc_pin_command_gate(bool live) {
+  g_gate_pinned.store(live, std::memory_order_release);
+  if (!live) g_gate_last_drain_ms.store(0, std::memory_order_release);
+}
+
+void ipc_drain_commands() {
+  g_gate_last_drain_ms.store(ipc_now_ms(), std::memory_order_release);
+  if (!g_gate_pending.load(std::memory_order_acquire)) return;
+  std::unique_lock<std::mutex> lock(g_gate_mutex);
+  while (!g_gate_queue.empty()) {
+    GateBatch* b = g_gate_queue.front();
+    g_gate_queue.pop_front();
+    g_gate_pending.store(!g_gate_queue.empty(), std::memory_order_relaxed);
+    b->claimed = true;
+    lock.unlock();
+    g_gate_cv.notify_all();
+    std::vector<std::string> replies;
+    {
+      std::scoped_lock const exec(g_ipc_exec_mutex);
+      for (const auto& job : b->jobs) replies.push_back(job());
+    }
+    lock.lock();
+    b->replies = std::move(replies);
+    b->done = true;
+    g_gate_cv.notify_all();
   }
+}
 
-  int opt = 1;
-  setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR,
-             reinterpret_cast<const char*>(&opt), sizeof(opt));
+// --- Binary mode ---
+//
+// `binary` switches a connection to length-prefixed frames (docs/ipc-protocol.md
+// § Binary mode), for tooling that pulls memory, device state, pictures and
+// sound every frame: no hex, no files. Little-endian throughout.
+//   request:  u32 len | u32 id | u8 op     | payload   (len counts id onward)
+//   response: u32 len | u32 id | u8 status | payload   (status 0 OK, 1 ERR)
+// An ERR payload is the text protocol's "ERR <code> <reason>\n" line.
+namespace {
 
-  sockaddr_in addr{};
-  addr.sin_family = AF_INET;
-  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+enum : uint8_t {
+  kOpText = 0,   // payload: a command line; reply: its text replies
+  kOpMem = 1,    // payload: u8 space, u32 addr, u32 len; reply: the bytes
+  kOpState = 2,  // payload: device name ("" = whole machine); reply: the blob
+  kOpFrame = 3,  // reply: u16 w, u16 h, u8 format (0 = RGB24), pixels
+  kOpAudio = 4,  // reply: u32 rate, u8 channels, s16 samples since last time
+  kOpLeave = 5,  // back to the text protocol after this frame
+};
 
-  int bound_port = 0;
-  for (int p = kBasePort; p < kBasePort + kMaxPortAttempts; p++) {
-    addr.sin_port = htons(static_cast<uint16_t>(p));
-    if (bind(server_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) !=
-        SOCKET_ERROR) {
-      bound_port = p;
+enum : uint8_t {
+  kMemCpu = 0,   // the Z80's view: ROM overlays as the CPU reads them
+  kMemBank = 1,  // the banked RAM under any ROM overlay (mem read --view=ram)
+  kMemPhys = 2,  // physical RAM, base 64K then expansion banks, linear
+};
+
+constexpr uint32_t kFrameHeader = 9;           // len + id + op/status
+constexpr uint32_t kMaxRequestFrame = 1 << 16;  // longest request body
+constexpr uint32_t kMaxMemRead = 4u << 20;      // a 4 MB expansion, whole
+// Audio held for a binary client between requests: 2 s of 44.1 kHz stereo.
+constexpr size_t kAudioCaptureMax = size_t{44100} * 2 * 2;
+
+void put_le(std::string& out, uint32_t v, int bytes) {
+  for (int i = 0; i < bytes; i++)
+    out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+}
+
+uint32_t get_le32(const std::string& in, size_t at) {
+  uint32_t v = 0;
+  for (int i = 3; i >= 0; i--)
+    v = (v << 8) | static_cast<uint8_t>(in[at + static_cast<size_t>(i)]);
+  return v;
+}
+
+std::string ipc_frame(uint32_t id, uint8_t status, const std::string& payload) {
+  std::string out;
+  out.reserve(kFrameHeader + payload.size());
+  put_le(out, static_cast<uint32_t>(payload.size() + 5), 4);
+  put_le(out, id, 4);
+  out.push_back(static_cast<char>(status));
+  out += payload;
+  return out;
+}
+
+std::string ipc_frame_err(uint32_t id, const std::string& line) {
+  return ipc_frame(id, 1, line);
+}
+
+// Audio made since a binary client last asked. Armed by the first kOpAudio;
+// filled on the emulation thread through the bridge's tap.
+struct IpcAudioCapture {
+  std::mutex mutex;
+  std::vector<int16_t> samples;
+  bool armed = false;
+};
+IpcAudioCapture g_ipc_audio;
+
+void ipc_audio_tap(void*, const int16_t* samples, size_t count) {
+  std::scoped_lock const lock(g_ipc_audio.mutex);
+  std::vector<int16_t>& buf = g_ipc_audio.samples;
+  buf.insert(buf.end(), samples, samples + count);
+  if (buf.size() > kAudioCaptureMax)  // nobody is draining: keep the newest
+    buf.erase(buf.begin(), buf.end() - kAudioCaptureMax);
+}
+
+std::string ipc_binary_mem(uint32_t id, const std::string& p) {
+  if (p.size() != 9) return ipc_frame_err(id, "ERR 400 bad-mem-request\n");
+  uint8_t const space = static_cast<uint8_t>(p[0]);
+  uint32_t const addr = get_le32(p, 1);
+  uint32_t const len = get_le32(p, 5);
+  // Every bound is checked before `out` is sized: `len` is the client's.
+  std::string out;
+  switch (space) {
+    case kMemCpu:
+    case kMemBank:
+      if (len > 0x10000) return ipc_frame_err(id, "ERR 413 len>65536\n");
+      out.resize(len);
+      for (uint32_t i = 0; i < len; i++) {
+        auto const a = static_cast<word>(addr + i);
+        out[i] = static_cast<char>(space == kMemCpu
+                                       ? z80_read_mem(a)
+                                       : z80_read_mem_via_write_bank(a));
+      }
+      break;
+    case kMemPhys: {
+      subcycle::Machine const* m = subcycle_bridge_machine();
+      size_t const ram = m != nullptr ? m->ram_size()
+                                      : static_cast<size_t>(CPC.ram_size) * 1024;
+      if (len > kMaxMemRead || addr > ram || len > ram - addr)
+        return ipc_frame_err(id, "ERR 416 out-of-range\n");
+      out.resize(len);
+      for (uint32_t i = 0; i < len; i++) {
+        uint32_t const a = addr + i;
+        out[i] = static_cast<char>(z80_read_mem_raw_bank(
+            static_cast<word>(a % 16384), static_cast<int>(a / 16384)));
+      }
       break;
     }
+    default:
+      return ipc_frame_err(id, "ERR 400 bad-space (0=cpu 1=bank 2=phys)\n");
   }
-  if (bound_port == 0) {
-    LOG_ERROR("IPC: could not bind to any port in range "
-              << kBasePort << "-" << (kBasePort + kMaxPortAttempts - 1));
-    closesocket(server_fd);
-    WSACleanup();
-    return;
+  return ipc_frame(id, 0, out);
+}
+
+std::string ipc_binary_state(uint32_t id, const std::string& name) {
+  subcycle::Machine* m = subcycle_bridge_machine();
+  if (m == nullptr) return ipc_frame_err(id, "ERR 503 no-machine\n");
+  if (name.empty()) {
+    std::vector<uint8_t> const blob = m->save_devices();
+    return ipc_frame(id, 0, std::string(blob.begin(), blob.end()));
   }
+  Board const* board = m->board();
+  for (int i = 0; i < board->count; i++) {
+    const Device& dev = board->dev[i];
+    if (dev.name == nullptr || name != dev.name) continue;
+    std::string blob(dev.state_size(dev.self), '\0');
+    dev.save(dev.self, blob.data());
+    return ipc_frame(id, 0, blob);
+  }
+  return ipc_frame_err(id, "ERR 404 unknown-device\n");
+}
 
-  if (listen(server_fd, 1) == SOCKET_ERROR) {
-    closesocket(server_fd);
-    WSACleanup();
-    return;
+std::string ipc_binary_picture(uint32_t id) {
+  const uint8_t* fb = subcycle_bridge_framebuffer();
+  if (fb == nullptr) return ipc_frame_err(id, "ERR 503 no-machine\n");
+  std::string out;
+  size_t const bytes = size_t{subcycle::kFbWidth} * subcycle::kFbHeight * 3;
+  out.reserve(5 + bytes);
+  put_le(out, subcycle::kFbWidth, 2);
+  put_le(out, subcycle::kFbHeight, 2);
+  out.push_back(0);  // RGB24
+  out.append(reinterpret_cast<const char*>(fb), bytes);
+  return ipc_frame(id, 0, out);
+}
+
+std::string ipc_binary_audio(uint32_t id) {
+  if (subcycle_bridge_machine() == nullptr)
+    return ipc_frame_err(id, "ERR 503 no-machine\n");
+  std::vector<int16_t> samples;
+  {
+    std::scoped_lock const lock(g_ipc_audio.mutex);
+    if (!g_ipc_audio.armed) {
+      g_ipc_audio.armed = true;
+      subcycle_bridge_set_audio_tap(&ipc_audio_tap, nullptr);
+    }
+    samples.swap(g_ipc_audio.samples);
   }
+  std::string out;
+  out.reserve(5 + (samples.size() * 2));
+  put_le(out, 44100, 4);
+  out.push_back(2);
+  for (int16_t const v : samples) put_le(out, static_cast<uint16_t>(v), 2);
+  return ipc_frame(id, 0, out);
+}
 
-  actual_port.store(bound_port);
-  LOG_INFO("IPC: listening on port " << bound_port);
+// One binary request, answered as a frame. Runs where a text command would.
+std::string ipc_run_frame(uint32_t id, uint8_t op, const std::string& payload) {
+  switch (op) {
+    case kOpText: {
+      std::string reply;
+      for (const auto& cmd : split_semicolons(payload))
+        reply += handle_command(cmd);
+      return ipc_frame(id, reply.rfind("ERR", 0) == 0 ? 1 : 0, reply);
+    }
+    case kOpMem:
+      return ipc_binary_mem(id, payload);
+    case kOpState:
+      return ipc_binary_state(id, payload);
+    case kOpFrame:
+      return ipc_binary_picture(id);
+    case kOpAudio:
+      return ipc_binary_audio(id);
+    case kOpLeave:
+      return ipc_frame(id, 0, "");
+    default:
+      return ipc_frame_err(id, "ERR 400 unknown-op\n");
+  }
+}
 
-  while (running.load()) {
-    fd_set readfds;
-    FD_ZERO(&readfds);
-    FD_SET(server_fd, &readfds);
-    timeval tv{0, 200000};  // 200ms
-
-    int ready = select(0, &readfds, nullptr, nullptr, &tv);
-    if (ready <= 0) continue;
-
-    sockaddr_in client{};
-    int len = sizeof(client);
-    SOCKET client_fd =
-        accept(server_fd, reinterpret_cast<sockaddr*>(&client), &len);
-    if (client_fd == INVALID_SOCKET) continue;
-
-    // Persistent connection: read lines until client disconnects, sends
-    // "disconnect", or idle timeout.
-    std::string buffer;
-    char buf[1024];
-    bool client_quit = false;
-    while (running.load() && !client_quit) {
-      fd_set cfds;
-      FD_ZERO(&cfds);
-      FD_SET(client_fd, &cfds);
-      timeval ctv{60, 0};  // 60s idle timeout
-
-      int cready = select(0, &cfds, nullptr, nullptr, &ctv);
-      if (cready <= 0) break;  // timeout or error
-
-      int n = recv(client_fd, buf, sizeof(buf) - 1, 0);
-      if (n <= 0) break;  // client disconnected or error
-      buf[n] = 0;
-      buffer.append(buf);
-
-      // Extract and dispatch complete lines
-      size_t pos;
-      while ((pos = buffer.find('\n')) != std::string::npos) {
-        std::string raw_line = buffer.substr(0, pos);
-        buffer.erase(0, pos + 1);
-        if (!raw_line.empty() && raw_line.back() == '\r') raw_line.pop_back();
-
-        // Split on semicolons for command chaining
-        auto cmds = split_semicolons(raw_line);
-        for (const auto& cmd : cmds) {
-          if (cmd == "disconnect") {
-            client_quit = true;
-            break;
-          }
-          auto reply = handle_command(cmd);
-          send(client_fd, reply.c_str(), static_cast<int>(reply.size()), 0);
-        }
-        if (client_quit) break;
-      }
+}  // namespace
+
+// --- Sessions ---
+namespace {
+
+#ifdef _WIN32
+using ipc_socket = SOCKET;
+constexpr ipc_socket kNoSocket = INVALID_SOCKET;
+int ipc_poll(pollfd* fds, size_t n, int ms) {
+  return WSAPoll(fds, static_cast<ULONG>(n), ms);
+}
+void ipc_close(ipc_socket s) { closesocket(s); }
+void ipc_hangup(ipc_socket s) { shutdown(s, SD_BOTH); }
+#else
+using ipc_socket = int;
+constexpr ipc_socket kNoSocket = -1;
+int ipc_poll(pollfd* fds, size_t n, int ms) {
+  return ::poll(fds, static_cast<nfds_t>(n), ms);
+}
+void ipc_close(ipc_socket s) { ::close(s); }
+void ipc_hangup(ipc_socket s) { ::shutdown(s, SHUT_RDWR); }
+#endif
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;  // a vanished client is not a signal
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+constexpr int kListenBacklog = 16;
+constexpr size_t kMaxSessions = 16;
+constexpr int kPollMs = 200;
+constexpr int64_t kIdleTimeoutMs = 60 * 1000;
+
+bool ipc_send_all(ipc_socket fd, const std::string& data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    auto const n = ::send(fd, data.data() + sent,
+                          static_cast<int>(data.size() - sent), kSendFlags);
+    if (n <= 0) return false;
+    sent += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+// One request as the poll loop parsed it: a text command, the `binary`
+// handshake, or a binary-mode frame.
+struct IpcRequest {
+  enum class Kind : uint8_t { Text, Hello, Frame } kind = Kind::Text;
+  std::string text;  // the command (Text) or the frame's payload (Frame)
+  uint32_t id = 0;   // Frame only
+  uint8_t op = 0;
+};
+
+// Frames run where their text equivalent would; a kOpText frame is a command
+// line like any other.
+bool ipc_request_orchestrates(const IpcRequest& r) {
+  if (r.kind == IpcRequest::Kind::Text) return ipc_orchestrates(r.text);
+  if (r.kind != IpcRequest::Kind::Frame || r.op != kOpText) return false;
+  auto const cmds = split_semicolons(r.text);
+  return std::any_of(cmds.begin(), cmds.end(), ipc_orchestrates);
+}
+
+IpcJob ipc_request_job(IpcRequest r) {
+  switch (r.kind) {
+    case IpcRequest::Kind::Hello:
+      return [] { return std::string("OK binary v1\n"); };
+    case IpcRequest::Kind::Frame:
+      return [r = std::move(r)] { return ipc_run_frame(r.id, r.op, r.text); };
+    case IpcRequest::Kind::Text:
+      break;
+  }
+  return [cmd = std::move(r.text)] { return handle_command(cmd); };
+}
+
+// One client connection. The poll loop owns the socket and feeds `queue`; the
+// session's worker runs the queue in order and writes the replies, so a client
+// blocked in `step frame` or `wait` never stalls another.
+struct IpcSession {
+  ipc_socket fd = kNoSocket;
+  std::string inbuf;        // unparsed input (poll loop only)
+  bool binary = false;      // parse inbuf as frames (poll loop only)
+  bool input_done = false;  // EOF, `disconnect` or idle (poll loop only)
+  std::mutex mutex;         // guards queue / closing
+  std::condition_variable cv;
+  std::deque<IpcRequest> queue;
+  bool closing = false;  // no more commands will arrive
+  std::atomic<bool> busy{false};
+  std::atomic<bool> finished{false};  // the worker has hung up
+  std::atomic<int64_t> last_active_ms{0};
+  std::thread worker;
+};
+
+void ipc_session_worker(IpcSession& s) {
+  for (;;) {
+    std::vector<IpcJob> batch;
+    bool orchestrate = false;
+    {
+      std::unique_lock<std::mutex> lock(s.mutex);
+      s.cv.wait(lock, [&] { return !s.queue.empty() || s.closing; });
+      if (s.queue.empty()) break;
+      orchestrate = ipc_request_orchestrates(s.queue.front());
+      do {
+        batch.push_back(ipc_request_job(std::move(s.queue.front())));
+        s.queue.pop_front();
+      } while (!orchestrate && !s.queue.empty() &&
+               !ipc_request_orchestrates(s.queue.front()));
+      s.busy.store(true);
+    }
+    std::string reply;
+    if (orchestrate) {
+      std::scoped_lock const lock(g_ipc_orchestrate_mutex);
+      reply = batch.front()();
+    } else {
+      reply = run_gated(std::move(batch));
     }
-    // Dispatch any trailing data without newline (for single-shot clients like
-    // echo|nc)
-    if (!client_quit && !buffer.empty()) {
-      if (!buffer.empty() && buffer.back() == '\r') buffer.pop_back();
-      auto cmds = split_semicolons(buffer);
-      for (const auto& cmd : cmds) {
-        if (cmd == "disconnect") break;
-        auto reply = handle_command(cmd);
-        send(client_fd, reply.c_str(), static_cast<int>(reply.size()), 0);
+    s.last_active_ms.store(ipc_now_ms());
+    s.busy.store(false);
+    if (!ipc_send_all(s.fd, reply)) {
+      std::scoped_lock const lock(s.mutex);
+      s.queue.clear();
+      s.closing = true;
+    }
+  }
+  ipc_hangup(s.fd);
+  s.finished.store(true, std::memory_order_release);
+}
+
+// Stop reading a session: nothing more will be queued, and the worker hangs up
+// once it has answered what is.
+void ipc_end_input(IpcSession& s, bool drop_queued) {
+  s.input_done = true;
+  {
+    std::scoped_lock const lock(s.mutex);
+    if (drop_queued) s.queue.clear();
+    s.closing = true;
+  }
+  s.cv.notify_one();
+}
+
+void ipc_queue(IpcSession& s, IpcRequest r) {
+  {
+    std::scoped_lock const lock(s.mutex);
+    s.queue.push_back(std::move(r));
+  }
+  s.cv.notify_one();
+}
+
+// What the rest of the input is after a line.
+enum class LineEnd : uint8_t { More, Disconnect, Binary };
+
+// Queue one line's commands. `disconnect` and `binary` end the line (whatever
+// follows them on it is dropped).
+LineEnd ipc_queue_line(IpcSession& s, std::string line) {
+  if (!line.empty() && line.back() == '\r') line.pop_back();
+  for (auto& cmd : split_semicolons(line)) {
+    if (cmd == "disconnect") return LineEnd::Disconnect;
+    if (cmd == "binary") {
+      ipc_queue(s, {IpcRequest::Kind::Hello, {}, 0, 0});
+      return LineEnd::Binary;
+    }
+    ipc_queue(s, {IpcRequest::Kind::Text, std::move(cmd), 0, 0});
+  }
+  return LineEnd::More;
+}
+
+// Queue every complete line / frame in inbuf. False when the session must stop
+// reading (`disconnect`, or a frame too malformed to resynchronise after).
+bool ipc_parse_input(IpcSession& s) {
+  size_t at = 0;
+  bool ok = true;
+  while (ok) {
+    if (s.binary) {
+      if (s.inbuf.size() - at < 4) break;
+      uint32_t const len = get_le32(s.inbuf, at);
+      if (len < 5 || len > kMaxRequestFrame) {
+        ok = false;
+        break;
+      }
+      if (s.inbuf.size() - at - 4 < len) break;
+      IpcRequest r{IpcRequest::Kind::Frame, s.inbuf.substr(at + 9, len - 5),
+                   get_le32(s.inbuf, at + 4),
+                   static_cast<uint8_t>(s.inbuf[at + 8])};
+      at += 4 + len;
+      if (r.op == kOpLeave) s.binary = false;
+      ipc_queue(s, std::move(r));
+    } else {
+      size_t const pos = s.inbuf.find('\n', at);
+      if (pos == std::string::npos) break;
+      std::string line = s.inbuf.substr(at, pos - at);
+      at = pos + 1;
+      switch (ipc_queue_line(s, std::move(line))) {
+        case LineEnd::Disconnect:
+          ok = false;
+          break;
+        case LineEnd::Binary:
+          s.binary = true;
+          break;
+        case LineEnd::More:
+          break;
       }
     }
-    closesocket(client_fd);
   }
+  s.inbuf.erase(0, at);
+  return ok;
+}
 
-  closesocket(server_fd);
-  WSACleanup();
+// Read what the client sent. Complete lines and frames are queued as they
+// arrive; a trailing text line without a newline is dispatched at EOF
+// (single-shot clients like `echo -n ping | nc`).
+void ipc_read_session(IpcSession& s) {
+  char buf[4096];
+  auto const n = ::recv(s.fd, buf, static_cast<int>(sizeof(buf)), 0);
+  if (n <= 0) {
+    if (!s.binary && !s.inbuf.empty()) ipc_queue_line(s, std::move(s.inbuf));
+    s.inbuf.clear();
+    ipc_end_input(s, false);
+    return;
+  }
+  s.last_active_ms.store(ipc_now_ms());
+  s.inbuf.append(buf, static_cast<size_t>(n));
+  if (!ipc_parse_input(s)) {
+    s.inbuf.clear();
+    ipc_end_input(s, false);
+  }
 }
 
-#else  // POSIX
+}  // namespace
 
 void KoncepcjaIpcServer::run() {
-  int const server_fd = ::socket(AF_INET, SOCK_STREAM, 0);
-  if (server_fd < 0) return;
+#ifdef _WIN32
+  WSADATA wsa;
+  if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return;
+#endif
+  auto finish = [](ipc_socket fd) {
+    if (fd != kNoSocket) ipc_close(fd);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+  };
+
+  ipc_socket const server_fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (server_fd == kNoSocket) {
+    finish(kNoSocket);
+    return;
+  }
 
   int opt = 1;
-  setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+  setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR,
+             reinterpret_cast<const char*>(&opt), sizeof(opt));
 
   sockaddr_in addr{};
   addr.sin_family = AF_INET;
@@ -5555,89 +6290,87 @@ void KoncepcjaIpcServer::run() {
   if (bound_port == 0) {
     LOG_ERROR("IPC: could not bind to any port in range "
               << kBasePort << "-" << (kBasePort + kMaxPortAttempts - 1));
-    ::close(server_fd);
+    finish(server_fd);
     return;
   }
 
-  if (listen(server_fd, 1) < 0) {
-    ::close(server_fd);
+  if (listen(server_fd, kListenBacklog) != 0) {
+    finish(server_fd);
     return;
   }
 
   actual_port.store(bound_port);
   LOG_INFO("IPC: listening on port " << bound_port);
 
+  // One poll() over the listener and every session still sending; the
+  // sessions' workers run the commands.
+  std::vector<std::unique_ptr<IpcSession>> sessions;
+  std::vector<pollfd> fds;
+  std::vector<IpcSession*> polled;
   while (running.load()) {
-    fd_set readfds;
-    FD_ZERO(&readfds);
-    FD_SET(server_fd, &readfds);
-    timeval tv{0, 200000};  // 200ms
-
-    int const ready = select(server_fd + 1, &readfds, nullptr, nullptr, &tv);
-    if (ready <= 0) continue;
-
-    sockaddr_in client{};
-    socklen_t len = sizeof(client);
-    int const client_fd =
-        accept(server_fd, reinterpret_cast<sockaddr*>(&client), &len);
-    if (client_fd < 0) continue;
-
-    // Persistent connection: read lines until client disconnects, sends
-    // "disconnect", or idle timeout.
-    std::string buffer;
-    char buf[1024];
-    // NOLINTNEXTLINE(misc-const-correctness): clang-tidy FP — variable is
-    // mutated (out-param/compound-assign/loop/reference)
-    bool client_quit = false;
-    while (running.load() && !client_quit) {
-      fd_set cfds;
-      FD_ZERO(&cfds);
-      FD_SET(client_fd, &cfds);
-      timeval ctv{60, 0};  // 60s idle timeout
-
-      int const cready = select(client_fd + 1, &cfds, nullptr, nullptr, &ctv);
-      if (cready <= 0) break;  // timeout or error
-
-      ssize_t const n = read(client_fd, buf, sizeof(buf) - 1);
-      if (n <= 0) break;  // client disconnected or error
-      buf[n] = 0;
-      buffer.append(buf);
-
-      // Extract and dispatch complete lines
-      size_t pos;
-      while ((pos = buffer.find('\n')) != std::string::npos) {
-        std::string raw_line = buffer.substr(0, pos);
-        buffer.erase(0, pos + 1);
-        if (!raw_line.empty() && raw_line.back() == '\r') raw_line.pop_back();
-
-        // Split on semicolons for command chaining
-        auto cmds = split_semicolons(raw_line);
-        for (const auto& cmd : cmds) {
-          if (cmd == "disconnect") {
-            client_quit = true;
-            break;
-          }
-          auto reply = handle_command(cmd);
-          (void)write(client_fd, reply.c_str(), reply.size());
+    fds.clear();
+    polled.clear();
+    fds.push_back({server_fd, POLLIN, 0});
+    for (auto& s : sessions) {
+      if (s->input_done) continue;
+      fds.push_back({s->fd, POLLIN, 0});
+      polled.push_back(s.get());
+    }
+
+    int const ready = ipc_poll(fds.data(), fds.size(), kPollMs);
+    int64_t const now = ipc_now_ms();
+    if (ready > 0) {
+      for (size_t i = 0; i < polled.size(); i++) {
+        if (fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))
+          ipc_read_session(*polled[i]);
+      }
+      if (fds[0].revents & POLLIN) {
+        sockaddr_in client{};
+        socklen_t len = sizeof(client);
+        ipc_socket const client_fd =
+            accept(server_fd, reinterpret_cast<sockaddr*>(&client), &len);
+        if (client_fd != kNoSocket && sessions.size() >= kMaxSessions) {
+          ipc_send_all(client_fd, "ERR 503 too-many-clients\n");
+          ipc_close(client_fd);
+        } else if (client_fd != kNoSocket) {
+#ifdef SO_NOSIGPIPE
+          setsockopt(client_fd, SOL_SOCKET, SO_NOSIGPIPE, &opt, sizeof(opt));
+#endif
+          auto s = std::make_unique<IpcSession>();
+          s->fd = client_fd;
+          s->last_active_ms.store(now);
+          IpcSession& ref = *s;
+          s->worker = std::thread([&ref] { ipc_session_worker(ref); });
+          sessions.push_back(std::move(s));
         }
-        if (client_quit) break;
       }
     }
-    // Dispatch any trailing data without newline (for single-shot clients like
-    // echo|nc)
-    if (!client_quit && !buffer.empty()) {
-      if (!buffer.empty() && buffer.back() == '\r') buffer.pop_back();
-      auto cmds = split_semicolons(buffer);
-      for (const auto& cmd : cmds) {
-        if (cmd == "disconnect") break;
-        auto reply = handle_command(cmd);
-        (void)write(client_fd, reply.c_str(), reply.size());
+
+    for (auto it = sessions.begin(); it != sessions.end();) {
+      IpcSession& s = **it;
+      if (!s.input_done && !s.busy.load() &&
+          now - s.last_active_ms.load() > kIdleTimeoutMs) {
+        std::scoped_lock const lock(s.mutex);
+        if (s.queue.empty()) {
+          s.input_done = true;
+          s.closing = true;
+          s.cv.notify_one();
+        }
+      }
+      if (s.finished.load(std::memory_order_acquire)) {
+        s.worker.join();
+        ipc_close(s.fd);
+        it = sessions.erase(it);
+      } else {
+        ++it;
       }
     }
-    ::close(client_fd);
   }
 
-  ::close(server_fd);
+  for (auto& s : sessions) ipc_end_input(*s, true);
+  for (auto& s : sessions) {
+    s->worker.join();
+    ipc_close(s->fd);
+  }
+  finish(server_fd);
 }
-
-#endif  // _WIN32
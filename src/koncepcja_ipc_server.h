@@ -23,7 +23,10 @@ struct IpcEvent {
   std::string command;  // IPC command to execute when triggered
 };
 
-// konCePCja IPC Server
+// konCePCja IPC Server. One poll() loop on the server thread accepts any
+// number of clients (up to a cap); each session runs its commands in order on
+// its own worker, and commands that touch machine state are handed to the
+// emulation thread at its next frame boundary (ipc_drain_commands).
 class KoncepcjaIpcServer {
  public:
   ~KoncepcjaIpcServer();
@@ -93,3 +96,17 @@ void ipc_check_vbl_events();
 // MUST be called once per frame on the main thread — the IPC server thread only
 // accumulates; this applies. Cheap no-op when nothing is pending.
 void ipc_drain_input();
+
+// Run the IPC commands queued for the emulation thread. MUST be called on the
+// thread that runs z80_execute() (the Z80 thread, or the main loop when
+// headless) at every frame boundary and while paused — the IPC sessions hand
+// machine-state commands here so they never run mid-frame. Cheap no-op when
+// nothing is queued.
+void ipc_drain_commands();
+
+// Test hooks for the frame gate. ipc_commands_pending(): a batch is waiting
+// for ipc_drain_commands(). ipc_pin_command_gate(true) routes commands to the
+// gate whether or not anything has drained lately; false forgets every drain,
+// so commands run on the sessions again until the next one.
+bool ipc_commands_pending();
+void ipc_pin_command_gate(bool live);
@@ -97,9 +97,8 @@ struct KryoFluxTrack {
 int kryoflux_decode_stream(const uint8_t* data, size_t len, KryoFluxTrack& out);
 
 /* Transcode a SINGLE stream (one track) into an SCP image, placing the track at
- * SCP slot = cyl*2 + side. Note: the flux decoder is side-0 only, so side-1
- * (odd) slots are stored but not decoded by src/hw/flux — matching the
- * documented single-sided-consumption limit. Returns 0 or a negative code. */
+ * SCP slot = cyl*2 + side. The header declares both sides, so a side-1 (odd)
+ * slot decodes as head 1 in src/hw/flux. Returns 0 or a negative code. */
 int kryoflux_stream_to_scp(const uint8_t* data, size_t len, uint8_t cyl,
                            uint8_t side, std::vector<uint8_t>& out);
 
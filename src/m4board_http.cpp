@@ -17,6 +17,8 @@
    - POST /upload.html       — upload file (form action target)
    - GET /status             — JSON status (extension)
    - POST /reset             — reset CPC (extension)
+   - GET /preview.bmp|.png   — current screen (extension)
+   - WS  /ws/preview?fps=N&mode=delta|full — live screen stream (extension)
 */
 
 #include "m4board_http.h"
@@ -25,6 +27,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <cstring>
 #include <filesystem>
 #include <sstream>
@@ -34,6 +37,7 @@
 #include "log.h"
 #include "m4board.h"
 #include "m4board_web_assets.h"
+#include "png_dump.h"
 #include "rom_identify.h"
 #include "z80_view.h"
 
@@ -1072,23 +1076,27 @@ M4HttpServer::HttpResponse M4HttpServer::handle_static(const HttpRequest& req) {
   return resp;
 }
 
-// ── Live preview (BMP snapshot, thread-safe) ─────────────
-// update_preview_snapshot() is called from the main thread each frame
-// (in drain_pending). handle_preview() returns the cached BMP under a mutex,
-// avoiding direct back_surface access from the HTTP thread.
+// ── Live preview (on-demand capture, encoded on the HTTP thread) ─────
+// The HTTP thread raises preview_wanted_; update_preview_snapshot(), called
+// from drain_pending() on the main thread, answers with a raw copy of
+// back_surface. With no client asking, the main thread does nothing.
 
-void M4HttpServer::update_preview_snapshot() {
-  if (!back_surface || !back_surface->pixels) {
-    std::scoped_lock const lock(preview_mutex_);
-    preview_bmp_.clear();  // clear stale snapshot
-    return;
-  }
+namespace {
+
+// How long a request waits for the main thread to capture (it runs every
+// emulated frame, so this only expires while the emulator is not draining,
+// e.g. during a blocking dialog).
+constexpr int kPreviewWaitMs = 200;
 
-  int const w = back_surface->w;
-  int const h = back_surface->h;
-  int const pitch = back_surface->pitch;
-  int const bpp = 4;  // RGBA32
+// Delta stream message: 12-byte header, then a PNG of the changed rect.
+//   0  'K' 'P'  magic
+//   2  flags    bit 0: keyframe (whole frame; resize the canvas)
+//   3  0        reserved
+//   4  u16 LE   frame width     6  u16 LE  frame height
+//   8  u16 LE   rect x         10  u16 LE  rect y
+constexpr size_t kPreviewHeader = 12;
 
+std::vector<uint8_t> preview_bmp(const uint8_t* rgba, int w, int h) {
   int const row_size = (((w * 3) + 3) / 4) * 4;
   int const pixel_data_size = row_size * h;
   int const file_size = 14 + 40 + pixel_data_size;
@@ -1122,41 +1130,180 @@ void M4HttpServer::update_preview_snapshot() {
   write32(p + 46, 0);
   write32(p + 50, 0);
 
-  const uint8_t* src = static_cast<const uint8_t*>(back_surface->pixels);
   for (int y = h - 1; y >= 0; y--) {
-    const uint8_t* row = src + (y * pitch);
+    const uint8_t* row = rgba + (static_cast<size_t>(y) * w * 4);
     uint8_t* dst_row = p + 54 + ((h - 1 - y) * row_size);
     for (int x = 0; x < w; x++) {
-      dst_row[(x * 3) + 0] = row[(x * bpp) + 2];  // B
-      dst_row[(x * 3) + 1] = row[(x * bpp) + 1];  // G
-      dst_row[(x * 3) + 2] = row[(x * bpp) + 0];  // R
+      dst_row[(x * 3) + 0] = row[(x * 4) + 2];  // B
+      dst_row[(x * 3) + 1] = row[(x * 4) + 1];  // G
+      dst_row[(x * 3) + 2] = row[(x * 4) + 0];  // R
     }
   }
+  return bmp;
+}
 
-  {
-    std::scoped_lock const lock(preview_mutex_);
-    preview_bmp_ = std::move(bmp);
-  }
+void put16(uint8_t* p, int v) {
+  p[0] = static_cast<uint8_t>(v & 0xFF);
+  p[1] = static_cast<uint8_t>((v >> 8) & 0xFF);
 }
 
-M4HttpServer::HttpResponse M4HttpServer::handle_preview(
-    const HttpRequest& /*unused*/) {
-  HttpResponse resp;
+// Preview PNGs favour speed: the stream is live, not archival.
+PngOptions preview_png_options() {
+  PngOptions o;
+  o.zlib_level = 3;
+  return o;
+}
 
+}  // namespace
+
+void M4HttpServer::update_preview_snapshot() {
+  if (!preview_wanted_.exchange(false)) return;
   std::scoped_lock const lock(preview_mutex_);
-  if (preview_bmp_.empty()) {
+  if (!back_surface || !back_surface->pixels) {
+    preview_.w = preview_.h = 0;
+  } else {
+    // RGBA32; copy the rows packed (the surface pitch may be padded).
+    int const w = back_surface->w;
+    int const h = back_surface->h;
+    size_t const row = static_cast<size_t>(w) * 4;
+    preview_.rgba.resize(row * static_cast<size_t>(h));
+    const uint8_t* src = static_cast<const uint8_t*>(back_surface->pixels);
+    for (int y = 0; y < h; y++)
+      memcpy(preview_.rgba.data() + (row * y),
+             src + (static_cast<size_t>(y) * back_surface->pitch), row);
+    preview_.w = w;
+    preview_.h = h;
+  }
+  preview_.seq++;
+  preview_cv_.notify_all();
+}
+
+bool M4HttpServer::grab_preview(PreviewFrame& out, uint64_t& seen,
+                                int timeout_ms) {
+  std::unique_lock<std::mutex> lk(preview_mutex_);
+  uint64_t const asked_at = preview_.seq;
+  preview_wanted_.store(true);
+  preview_cv_.wait_for(lk, std::chrono::milliseconds(timeout_ms), [&] {
+    return preview_.seq != asked_at || !running.load();
+  });
+  // On a timeout an older capture still serves a poll (seen == 0).
+  if (preview_.seq == seen || preview_.w <= 0) return false;
+  seen = preview_.seq;
+  out.w = preview_.w;
+  out.h = preview_.h;
+  out.seq = preview_.seq;
+  out.rgba.assign(preview_.rgba.begin(), preview_.rgba.end());
+  return true;
+}
+
+M4HttpServer::HttpResponse M4HttpServer::handle_preview(
+    const HttpRequest& req) {
+  HttpResponse resp;
+  PreviewFrame frame;
+  uint64_t seen = 0;
+  if (!grab_preview(frame, seen, kPreviewWaitMs)) {
     resp.status = 503;
     resp.status_text = "Service Unavailable";
     resp.body = "No video surface";
     return resp;
   }
 
-  resp.body.assign(reinterpret_cast<const char*>(preview_bmp_.data()),
-                   preview_bmp_.size());
-  resp.content_type = "image/bmp";
+  std::vector<uint8_t> image;
+  if (req.path == "/preview.png") {
+    if (!encode_png_rgba(image, frame.rgba.data(), frame.w, frame.h,
+                         frame.w * 4, preview_png_options())
+             .ok) {
+      resp.status = 500;
+      resp.status_text = "Internal Server Error";
+      resp.body = "PNG encode failed";
+      return resp;
+    }
+    resp.content_type = "image/png";
+  } else {
+    image = preview_bmp(frame.rgba.data(), frame.w, frame.h);
+    resp.content_type = "image/bmp";
+  }
+  resp.body.assign(reinterpret_cast<const char*>(image.data()), image.size());
   return resp;
 }
 
+M4HttpServer::PreviewStream M4HttpServer::preview_stream_for(
+    const HttpRequest& req) {
+  PreviewStream st;
+  std::string const fps = get_query_param(req.query_string, "fps");
+  if (!fps.empty()) {
+    try {
+      st.interval_ms = 1000 / std::clamp(std::stoi(fps), 1, 50);
+    } catch (const std::exception&) {
+    }
+  }
+  st.delta = get_query_param(req.query_string, "mode") != "full";
+  return st;
+}
+
+bool M4HttpServer::next_preview_message(PreviewStream& st,
+                                        std::vector<uint8_t>& msg) {
+  if (!grab_preview(st.cur, st.seen, kPreviewWaitMs)) return false;
+  const PreviewFrame& cur = st.cur;
+  bool const key = st.prev.seq == 0 || st.prev.w != cur.w || st.prev.h != cur.h;
+
+  // Changed rectangle against what the client already shows.
+  int x0 = 0, y0 = 0, x1 = cur.w, y1 = cur.h;  // half-open
+  if (!key) {
+    size_t const row = static_cast<size_t>(cur.w) * 4;
+    auto row_differs = [&](int y) {
+      return memcmp(cur.rgba.data() + (row * y), st.prev.rgba.data() + (row * y),
+                    row) != 0;
+    };
+    while (y0 < cur.h && !row_differs(y0)) y0++;
+    if (y0 == cur.h) return false;  // identical frame: send nothing
+    while (y1 > y0 && !row_differs(y1 - 1)) y1--;
+    x0 = cur.w;
+    x1 = 0;
+    for (int y = y0; y < y1; y++) {
+      const uint32_t* a =
+          reinterpret_cast<const uint32_t*>(cur.rgba.data() + (row * y));
+      const uint32_t* b =
+          reinterpret_cast<const uint32_t*>(st.prev.rgba.data() + (row * y));
+      int l = 0;
+      while (l < x0 && a[l] == b[l]) l++;
+      int r = cur.w;
+      while (r > std::max(x1, l) && a[r - 1] == b[r - 1]) r--;
+      x0 = std::min(x0, l);
+      x1 = std::max(x1, r);
+    }
+    if (!st.delta) {  // full mode: the whole frame whenever anything changed
+      x0 = y0 = 0;
+      x1 = cur.w;
+      y1 = cur.h;
+    }
+  }
+
+  std::vector<uint8_t> png;
+  const uint8_t* origin =
+      cur.rgba.data() + ((static_cast<size_t>(y0) * cur.w) + x0) * 4;
+  if (!encode_png_rgba(png, origin, x1 - x0, y1 - y0, cur.w * 4,
+                       preview_png_options())
+           .ok)
+    return false;
+  msg.clear();
+  if (st.delta) {
+    msg.resize(kPreviewHeader);
+    msg[0] = 'K';
+    msg[1] = 'P';
+    msg[2] = key ? 1 : 0;
+    msg[3] = 0;
+    put16(&msg[4], cur.w);
+    put16(&msg[6], cur.h);
+    put16(&msg[8], x0);
+    put16(&msg[10], y0);
+  }
+  msg.insert(msg.end(), png.begin(), png.end());
+  std::swap(st.prev, st.cur);
+  st.seen = st.prev.seq;
+  return true;
+}
+
 // ── ROM slot API ─────────────────────────────────────────
 
 M4HttpServer::HttpResponse M4HttpServer::handle_roms_api(
@@ -1233,7 +1380,7 @@ M4HttpServer::HttpResponse M4HttpServer::handle_request(
       resp = handle_config_cgi(req);
     } else if (req.path == "/status") {
       resp = handle_status(req);
-    } else if (req.path == "/preview.bmp") {
+    } else if (req.path == "/preview.bmp" || req.path == "/preview.png") {
       resp = handle_preview(req);
     } else if (req.path == "/roms.json") {
       resp = handle_roms_api(req);
@@ -1354,16 +1501,8 @@ void M4HttpServer::drain_pending() {
       cpc_pause();
     LOG_INFO("M4 HTTP: " << (CPC.paused ? "paused" : "resumed"));
   }
-  // Update preview snapshot for the HTTP thread (~5fps, only when server is
-  // running)
-  {
-    static int preview_frame_counter = 0;
-    if (running.load() &&
-        ++preview_frame_counter >= 10) {  // every 10 frames = ~5fps at 50Hz
-      preview_frame_counter = 0;
-      update_preview_snapshot();
-    }
-  }
+  // Answer a preview capture request from the HTTP thread, if there is one.
+  if (running.load()) update_preview_snapshot();
 
   if (pending_nmi.exchange(false)) {
     if (CPC.mf2 && !(dwMF2Flags & MF2_ACTIVE)) {
@@ -1573,13 +1712,15 @@ void M4HttpServer::run() {
             accept + "\r\n\r\n";
         sock_send(client, handshake.data(), static_cast<int>(handshake.size()));
         LOG_INFO("M4 HTTP: WebSocket preview client connected");
+        PreviewStream stream = preview_stream_for(req);
+        std::vector<uint8_t> msg;
         while (running.load()) {
-          HttpResponse frame = handle_preview(req);
-          if (frame.status == 200 && !frame.body.empty()) {
-            if (!ws_send_binary(client, frame.body.data(), frame.body.size()))
-              break;
+          auto const tick = std::chrono::steady_clock::now() +
+                            std::chrono::milliseconds(stream.interval_ms);
+          if (next_preview_message(stream, msg)) {
+            if (!ws_send_binary(client, msg.data(), msg.size())) break;
           }
-          std::this_thread::sleep_for(std::chrono::milliseconds(200));
+          std::this_thread::sleep_until(tick);
           u_long avail = 0;
           ioctlsocket(client, FIONREAD, &avail);
           if (avail >= 2) {
@@ -1796,15 +1937,19 @@ void M4HttpServer::run() {
 
         LOG_INFO("M4 HTTP: WebSocket preview client connected");
 
-        // Push BMP frames at ~5fps until client disconnects or server stops
+        // Push changed frames at the client's rate (default 5 fps) until it
+        // disconnects or the server stops; an unchanged frame costs one raw
+        // copy and a compare, nothing on the wire.
+        PreviewStream stream = preview_stream_for(req);
+        std::vector<uint8_t> msg;
         while (running.load()) {
-          HttpResponse frame = handle_preview(req);
-          if (frame.status == 200 && !frame.body.empty()) {
-            if (!ws_send_binary(client, frame.body.data(), frame.body.size()))
+          auto const tick = std::chrono::steady_clock::now() +
+                            std::chrono::milliseconds(stream.interval_ms);
+          if (next_preview_message(stream, msg)) {
+            if (!ws_send_binary(client, msg.data(), msg.size()))
               break;  // client disconnected
           }
-          // ~5fps: sleep 200ms between frames
-          std::this_thread::sleep_for(std::chrono::milliseconds(200));
+          std::this_thread::sleep_until(tick);
 
           // Check for incoming WebSocket frames (non-blocking).
           // Only break on close frame (opcode 0x8) or connection reset.
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <mutex>
 #include <string>
@@ -98,7 +99,7 @@ class M4HttpServer {
   HttpResponse handle_status(const HttpRequest& req);
   HttpResponse handle_static(const HttpRequest& req);
   HttpResponse handle_sd_file(const HttpRequest& req);
-  HttpResponse handle_preview(const HttpRequest& req);
+  HttpResponse handle_preview(const HttpRequest& req);  // BMP or PNG
   HttpResponse handle_roms_api(const HttpRequest& req);
 
   // Utility
@@ -120,9 +121,33 @@ class M4HttpServer {
   mutable std::mutex port_mutex_;
   std::vector<M4PortMapping> port_mappings_;
 
-  // Surface snapshot for preview — updated by main thread, read by HTTP thread.
+  // Live preview. Capture is on demand: the HTTP thread asks for a frame and
+  // the main thread copies back_surface's raw pixels at its next
+  // drain_pending() — nothing else, and nothing at all while no client
+  // wants one. Encoding (BMP/PNG) happens on the HTTP thread.
+  struct PreviewFrame {
+    int w = 0, h = 0;
+    uint64_t seq = 0;           // capture counter, 0 = none yet
+    std::vector<uint8_t> rgba;  // packed rows
+  };
   mutable std::mutex preview_mutex_;
-  std::vector<uint8_t> preview_bmp_;  // BMP-encoded snapshot
+  std::condition_variable preview_cv_;
+  PreviewFrame preview_;  // latest capture
+  std::atomic<bool> preview_wanted_{false};
+  // Request a capture and wait up to timeout_ms for it; copies the latest
+  // frame into `out` if it is newer than `seen` (which is updated).
+  bool grab_preview(PreviewFrame& out, uint64_t& seen, int timeout_ms);
+
+  // One WebSocket preview stream (/ws/preview?fps=N&mode=delta|full).
+  struct PreviewStream {
+    int interval_ms = 200;
+    bool delta = true;  // rect messages with a header vs whole PNGs
+    uint64_t seen = 0;
+    PreviewFrame cur, prev;  // prev: what the client holds
+  };
+  static PreviewStream preview_stream_for(const HttpRequest& req);
+  // The next message for `st`, or false when the frame is unchanged.
+  bool next_preview_message(PreviewStream& st, std::vector<uint8_t>& msg);
 
   // Status snapshots — written by main thread in drain_pending(), read by HTTP
   // thread.
@@ -131,7 +156,7 @@ class M4HttpServer {
   std::atomic<int> snapshot_screen_h{0};
 
  public:
-  // Called from main thread to update the preview snapshot.
+  // Called from main thread: serve a pending preview capture request.
   void update_preview_snapshot();
 
   // Deferred actions — set by HTTP thread, consumed by main loop.
@@ -38,7 +38,7 @@ static const char m4_web_index_html_src[] = R"HTML(<!DOCTYPE html>
 
 <!-- Floating preview overlay (visible on all pages when enabled) -->
 <div id="preview-overlay" class="preview-overlay" style="display:none">
-  <img id="preview-img" alt="" class="preview-img">
+  <canvas id="preview-img" class="preview-img" width="384" height="272"></canvas>
   <div class="preview-controls">
     <label class="preview-toggle-label"><input type="checkbox" id="preview-toggle" onchange="togglePreview(this.checked)"> Live</label>
   </div>
@@ -341,22 +341,37 @@ function togglePreview(on) {
     var overlay = document.getElementById('preview-overlay');
     overlay.style.display = '';
     var proto = location.protocol === 'https:' ? 'wss:' : 'ws:';
-    previewWs = new WebSocket(proto + '//' + location.host + '/ws/preview');
-    previewWs.binaryType = 'blob';
+    // Delta stream: each message is a 12-byte header (magic 'KP', flags
+    // bit 0 = keyframe, frame w/h, rect x/y as u16 LE) and a PNG of the
+    // changed rect. Decodes are async, so rects are drawn in arrival order.
+    previewWs = new WebSocket(proto + '//' + location.host + '/ws/preview?fps=10&mode=delta');
+    previewWs.binaryType = 'arraybuffer';
+    var chain = Promise.resolve();
     previewWs.onmessage = function(ev) {
-      var img = document.getElementById('preview-img');
-      var url = URL.createObjectURL(ev.data);
-      img.onload = function() { URL.revokeObjectURL(url); };
-      img.src = url;
+      var hdr = new DataView(ev.data, 0, 12);
+      if (hdr.getUint8(0) !== 0x4B || hdr.getUint8(1) !== 0x50) return;
+      var key = hdr.getUint8(2) & 1;
+      var fw = hdr.getUint16(4, true), fh = hdr.getUint16(6, true);
+      var x = hdr.getUint16(8, true), y = hdr.getUint16(10, true);
+      var png = new Blob([ev.data.slice(12)], { type: 'image/png' });
+      chain = chain.then(function() { return createImageBitmap(png); })
+        .then(function(bmp) {
+          var canvas = document.getElementById('preview-img');
+          if (key && (canvas.width !== fw || canvas.height !== fh)) {
+            canvas.width = fw;
+            canvas.height = fh;
+          }
+          canvas.getContext('2d').drawImage(bmp, x, y);
+          bmp.close();
+        }).catch(function(){});
       if (!previewSized) sizePreview();
     };
     previewWs.onclose = function() {
       previewWs = null;
       document.getElementById('preview-toggle').checked = false;
-      // Show a blank placeholder on disconnect
-      var img = document.getElementById('preview-img');
-      img.removeAttribute('src');
-      img.alt = 'Disconnected';
+      // Blank the canvas on disconnect
+      var canvas = document.getElementById('preview-img');
+      canvas.getContext('2d').clearRect(0, 0, canvas.width, canvas.height);
     };
     previewWs.onerror = function() {
       if (previewWs) { previewWs.close(); previewWs = null; }
@@ -368,9 +383,9 @@ function togglePreview(on) {
 function sizePreview() {
   fetch('/status').then(function(r) { return r.json(); }).then(function(s) {
     if (s.screen_w && s.screen_h) {
-      var img = document.getElementById('preview-img');
-      img.style.width = Math.round(s.screen_w / 2) + 'px';
-      img.style.height = Math.round(s.screen_h / 2) + 'px';
+      var canvas = document.getElementById('preview-img');
+      canvas.style.width = Math.round(s.screen_w / 2) + 'px';
+      canvas.style.height = Math.round(s.screen_h / 2) + 'px';
       previewSized = true;
     }
   }).catch(function(){});
@@ -0,0 +1,342 @@
+/* media_file.cpp — see media_file.h. */
+
+#include "media_file.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>  // _commit
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace media {
+
+namespace {
+
+constexpr char kMagic[4] = {'K', 'J', 'N', 'L'};
+constexpr char kTrailer[4] = {'K', 'E', 'N', 'D'};
+constexpr uint32_t kVersion = 1;
+// magic + version + image length + entry count
+constexpr size_t kHeaderLen = 4 + 4 + 8 + 4;
+
+std::vector<uint8_t> read_all(const std::string& path) {
+  std::ifstream f(path, std::ios::binary);
+  return {(std::istreambuf_iterator<char>(f)),
+          std::istreambuf_iterator<char>()};
+}
+
+void put_le(std::vector<uint8_t>& out, uint64_t v, int bytes) {
+  for (int i = 0; i < bytes; ++i)
+    out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+uint64_t get_le(const uint8_t* p, int bytes) {
+  uint64_t v = 0;
+  for (int i = bytes - 1; i >= 0; --i) v = (v << 8) | p[i];
+  return v;
+}
+
+uint32_t crc_of(const uint8_t* p, size_t n) {
+  uLong crc = crc32(0L, nullptr, 0);
+  while (n > 0) {  // zlib's length is a uInt: feed large journals in pieces
+    const uInt chunk = n > 0x40000000u ? 0x40000000u : static_cast<uInt>(n);
+    crc = crc32(crc, p, chunk);
+    p += chunk;
+    n -= chunk;
+  }
+  return static_cast<uint32_t>(crc);
+}
+
+// Flush `f` through to the device: the journal's whole point is ordering.
+bool sync_file(FILE* f) {
+  if (fflush(f) != 0) return false;
+#ifdef _WIN32
+  return _commit(_fileno(f)) == 0;
+#else
+  return fsync(fileno(f)) == 0;
+#endif
+}
+
+bool seek_to(FILE* f, uint64_t off) {
+#ifdef _WIN32
+  return _fseeki64(f, static_cast<__int64>(off), SEEK_SET) == 0;
+#else
+  return fseeko(f, static_cast<off_t>(off), SEEK_SET) == 0;
+#endif
+}
+
+// Size of `path` on disk, or -1 when it does not exist.
+int64_t file_size(const std::string& path) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (f == nullptr) return -1;
+#ifdef _WIN32
+  _fseeki64(f, 0, SEEK_END);
+  const int64_t n = _ftelli64(f);
+#else
+  fseeko(f, 0, SEEK_END);
+  const int64_t n = ftello(f);
+#endif
+  fclose(f);
+  return n;
+}
+
+bool write_file(const std::string& path, const uint8_t* p, size_t n) {
+  FILE* f = fopen(path.c_str(), "wb");
+  if (f == nullptr) return false;
+  const bool ok = fwrite(p, 1, n, f) == n && sync_file(f);
+  return fclose(f) == 0 && ok;
+}
+
+// Patch each at[i] (offset, lens[i] bytes) into `path` in place; sync it.
+bool patch(const std::string& path,
+           const std::vector<std::pair<uint64_t, const uint8_t*>>& at,
+           const std::vector<uint64_t>& lens) {
+  FILE* f = fopen(path.c_str(), "r+b");
+  if (f == nullptr) return false;
+  bool ok = true;
+  for (size_t i = 0; ok && i < at.size(); ++i)
+    ok = seek_to(f, at[i].first) &&
+         fwrite(at[i].second, 1, lens[i], f) == lens[i];
+  ok = ok && sync_file(f);
+  return fclose(f) == 0 && ok;
+}
+
+void add_range(std::vector<Range>& out, uint64_t off, uint64_t len) {
+  if (len == 0) return;
+  if (!out.empty() && out.back().off + out.back().len == off)
+    out.back().len += len;
+  else
+    out.push_back({off, len});
+}
+
+}  // namespace
+
+Buffer::Buffer(std::vector<uint8_t> bytes) : heap_(std::move(bytes)) {}
+
+Buffer::Buffer(Buffer&& o) noexcept
+    : map_(std::exchange(o.map_, nullptr)),
+      map_len_(std::exchange(o.map_len_, 0)),
+      stamp_(o.stamp_),
+      heap_(std::move(o.heap_)) {
+  o.heap_.clear();
+}
+
+Buffer& Buffer::operator=(Buffer&& o) noexcept {
+  if (this != &o) {
+    clear();
+    map_ = std::exchange(o.map_, nullptr);
+    map_len_ = std::exchange(o.map_len_, 0);
+    stamp_ = o.stamp_;
+    heap_ = std::move(o.heap_);
+    o.heap_.clear();
+  }
+  return *this;
+}
+
+void Buffer::clear() {
+#ifndef _WIN32
+  if (map_ != nullptr) munmap(map_, map_len_);
+#endif
+  map_ = nullptr;
+  map_len_ = 0;
+  heap_.clear();
+  heap_.shrink_to_fit();
+}
+
+Buffer Buffer::map(const std::string& path) {
+#ifndef _WIN32
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return {};
+  struct stat st {};
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    const auto n = static_cast<size_t>(st.st_size);
+    void* p = mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);  // the mapping holds its own reference
+    if (p != MAP_FAILED) {
+      Buffer b;
+      b.map_ = static_cast<uint8_t*>(p);
+      b.map_len_ = n;
+      b.stamp_ = {static_cast<uint64_t>(st.st_dev),
+                  static_cast<uint64_t>(st.st_ino), n,
+                  static_cast<int64_t>(st.st_mtime)};
+      return b;
+    }
+  } else {
+    close(fd);
+  }
+#endif
+  return Buffer(read_all(path));
+}
+
+bool Buffer::stamp_of(const std::string& path, Stamp& out) {
+#ifndef _WIN32
+  struct stat st {};
+  if (stat(path.c_str(), &st) != 0) return false;
+  out = {static_cast<uint64_t>(st.st_dev), static_cast<uint64_t>(st.st_ino),
+         static_cast<uint64_t>(st.st_size), static_cast<int64_t>(st.st_mtime)};
+  return true;
+#else
+  (void)path;
+  (void)out;
+  return false;
+#endif
+}
+
+bool Buffer::backs(const std::string& path) const {
+  if (map_ == nullptr) return true;
+  Stamp now;
+  return stamp_of(path, now) && now == stamp_;
+}
+
+void Buffer::restamp(const std::string& path) {
+  Stamp now;
+  if (map_ != nullptr && stamp_of(path, now)) stamp_ = now;
+}
+
+std::vector<Range> dsk_track_ranges(const uint8_t* dsk, size_t len,
+                                    const uint8_t* written, int ntracks) {
+  std::vector<Range> out;
+  if (dsk == nullptr || written == nullptr || len < 0x100) return out;
+  const bool extended = std::memcmp(dsk, "EXTENDED", 8) == 0;
+  if (!extended && std::memcmp(dsk, "MV - CPC", 8) != 0) return out;
+  const int tracks = dsk[0x30];
+  const int sides = dsk[0x31] == 2 ? 2 : 1;
+  const uint64_t std_size = dsk[0x32] | (dsk[0x33] << 8);
+  uint64_t off = 0x100;
+  for (int t = 0; t < tracks; ++t) {
+    for (int s = 0; s < sides; ++s) {
+      const int idx = (t * sides) + s;
+      uint64_t size = std_size;
+      if (extended) size = 0x34 + idx < 0x100 ? dsk[0x34 + idx] << 8 : 0;
+      const bool hit = t < ntracks && (written[t] >> s) & 1;
+      if (hit && off < len) add_range(out, off, std::min(size, len - off));
+      off += size;
+    }
+  }
+  return out;
+}
+
+std::vector<Range> region_ranges(const uint8_t* written, size_t nregions,
+                                 uint32_t region_sectors, size_t len) {
+  std::vector<Range> out;
+  if (written == nullptr || region_sectors == 0) return out;
+  const uint64_t span = static_cast<uint64_t>(region_sectors) * 512;
+  for (size_t r = 0; r < nregions; ++r) {
+    if (((written[r >> 3] >> (r & 7)) & 1) == 0) continue;
+    const uint64_t off = r * span;
+    if (off >= len) break;
+    add_range(out, off, std::min<uint64_t>(span, len - off));
+  }
+  return out;
+}
+
+bool write_back(const std::string& path, const uint8_t* image, size_t len,
+                const std::vector<Range>& ranges, std::string& err) {
+  if (file_size(path) != static_cast<int64_t>(len)) {
+    // Nothing on disk to patch: replace the file whole, atomically.
+    const std::string tmp = path + ".tmp";
+    if (!write_file(tmp, image, len)) {
+      std::remove(tmp.c_str());
+      err = "cannot write " + tmp;
+      return false;
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());  // Windows rename() will not replace
+#endif
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+      err = "cannot rename " + tmp + " over " + path;
+      return false;
+    }
+    return true;
+  }
+  if (ranges.empty()) return true;
+
+  std::vector<uint8_t> jnl(kMagic, kMagic + 4);
+  put_le(jnl, kVersion, 4);
+  put_le(jnl, len, 8);
+  put_le(jnl, ranges.size(), 4);
+  std::vector<std::pair<uint64_t, const uint8_t*>> at;
+  std::vector<uint64_t> lens;
+  for (const Range& r : ranges) {
+    if (r.off > len || r.len > len - r.off) {
+      err = "write-back range past the end of the image";
+      return false;
+    }
+    put_le(jnl, r.off, 8);
+    put_le(jnl, r.len, 8);
+    jnl.insert(jnl.end(), image + r.off, image + r.off + r.len);
+    at.emplace_back(r.off, image + r.off);
+    lens.push_back(r.len);
+  }
+  put_le(jnl, crc_of(jnl.data() + 4, jnl.size() - 4), 4);
+  jnl.insert(jnl.end(), kTrailer, kTrailer + 4);
+
+  const std::string jpath = path + ".journal";
+  if (!write_file(jpath, jnl.data(), jnl.size())) {
+    std::remove(jpath.c_str());  // torn: the image is still intact
+    err = "cannot write journal " + jpath;
+    return false;
+  }
+  if (!patch(path, at, lens)) {
+    err = "cannot patch " + path + " (journal kept for recovery)";
+    return false;
+  }
+  std::remove(jpath.c_str());
+  return true;
+}
+
+bool recover(const std::string& path) {
+  const std::string jpath = path + ".journal";
+  const std::vector<uint8_t> j = read_all(jpath);
+  if (j.empty()) {
+    std::remove(jpath.c_str());  // harmless when there is none
+    return false;
+  }
+  bool ok = j.size() >= kHeaderLen + 8 &&
+            std::memcmp(j.data(), kMagic, 4) == 0 &&
+            std::memcmp(j.data() + j.size() - 4, kTrailer, 4) == 0 &&
+            get_le(j.data() + 4, 4) == kVersion;
+  const size_t body_end = j.size() - 8;  // the CRC, then the trailer
+  ok = ok && get_le(j.data() + body_end, 4) == crc_of(j.data() + 4,
+                                                      body_end - 4);
+  ok = ok && file_size(path) == static_cast<int64_t>(get_le(j.data() + 8, 8));
+  std::vector<std::pair<uint64_t, const uint8_t*>> at;
+  std::vector<uint64_t> lens;
+  if (ok) {
+    const uint64_t image_len = get_le(j.data() + 8, 8);
+    const uint64_t count = get_le(j.data() + 16, 4);
+    size_t p = kHeaderLen;
+    for (uint64_t i = 0; ok && i < count; ++i) {
+      ok = p + 16 <= body_end;
+      if (!ok) break;
+      const uint64_t off = get_le(j.data() + p, 8);
+      const uint64_t n = get_le(j.data() + p + 8, 8);
+      p += 16;
+      ok = n <= body_end - p && off <= image_len && n <= image_len - off;
+      if (!ok) break;
+      at.emplace_back(off, j.data() + p);
+      lens.push_back(n);
+      p += n;
+    }
+    ok = ok && p == body_end;
+  }
+  // A complete journal finishes the interrupted patch; a torn one was never
+  // applied, so dropping it leaves the image as it was.
+  const bool replayed = ok && patch(path, at, lens);
+  if (ok && !replayed) return false;  // keep it: the next attach retries
+  std::remove(jpath.c_str());
+  return replayed;
+}
+
+}  // namespace media
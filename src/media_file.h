@@ -0,0 +1,114 @@
+/* media_file — host-side backing for the writable disc and IDE images the
+ * sub-cycle machine mutates in place (fdc-device.md §10, symbiface-device.md
+ * §2).
+ *
+ * Buffer maps an image file copy-on-write (MAP_PRIVATE): attach costs no read,
+ * pages fault in as the FDC / IDE touch them, and the machine's writes stay
+ * private to the process until the host persists them. Where mapping is not
+ * available (Windows, an empty file) it falls back to an owned heap copy, so
+ * callers never branch on the backing.
+ *
+ * A mapping trusts the file to stay put: truncated in place, its untouched
+ * pages fault (SIGBUS); edited in place, they show the edit. The program's own
+ * writers never do either — write_back patches only pages the machine already
+ * made private, and a Save-As replaces the file by rename (flux_write_file).
+ * Against anyone else, the buffer remembers the file it mapped (device,
+ * inode, size, mtime): backs() tells whether it is still that file, and the
+ * host checks it before a write-back instead of mixing its image into one it
+ * no longer knows.
+ *
+ * write_back persists just the byte ranges the machine wrote, through a
+ * journal beside the image: the ranges are first written to `<image>.journal`
+ * and synced, then patched into the image, then the journal is removed. A
+ * crash mid-patch leaves a complete journal that recover() replays on the
+ * next attach; a crash mid-journal leaves a torn one that recover() discards
+ * (the image was not touched yet). Either way the image is never half-old,
+ * half-new.
+ *
+ * Journal layout (little-endian): "KJNL", u32 version (1), u64 image length,
+ * u32 entry count, then per entry u64 offset, u64 length and the bytes; a
+ * u32 zlib CRC-32 of everything after the magic, then "KEND".
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace media {
+
+class Buffer {
+ public:
+  Buffer() = default;
+  explicit Buffer(std::vector<uint8_t> bytes);  // owned heap copy
+  Buffer(Buffer&& o) noexcept;
+  Buffer& operator=(Buffer&& o) noexcept;
+  Buffer(const Buffer&) = delete;
+  Buffer& operator=(const Buffer&) = delete;
+  ~Buffer() { clear(); }
+
+  /* Map `path` copy-on-write (or read it, where mapping is unavailable).
+   * Empty on a missing / unreadable file. */
+  static Buffer map(const std::string& path);
+
+  /* True when `path` is still the file this buffer mapped, at the size and
+   * mtime it had then (always true for a heap copy). */
+  bool backs(const std::string& path) const;
+  /* Take `path` as the mapped file again — after the host's own write_back
+   * moved its mtime (or renamed a new file in). */
+  void restamp(const std::string& path);
+
+  uint8_t* data() { return map_ != nullptr ? map_ : heap_.data(); }
+  const uint8_t* data() const { return map_ != nullptr ? map_ : heap_.data(); }
+  size_t size() const { return map_ != nullptr ? map_len_ : heap_.size(); }
+  bool empty() const { return size() == 0; }
+  bool mapped() const { return map_ != nullptr; }
+  void clear();
+
+ private:
+  struct Stamp {
+    uint64_t dev = 0, ino = 0, size = 0;
+    int64_t mtime = 0;
+    bool operator==(const Stamp& o) const {
+      return dev == o.dev && ino == o.ino && size == o.size &&
+             mtime == o.mtime;
+    }
+  };
+  static bool stamp_of(const std::string& path, Stamp& out);
+
+  uint8_t* map_ = nullptr;
+  size_t map_len_ = 0;
+  Stamp stamp_;  // the mapped file as it was (mapped() only)
+  std::vector<uint8_t> heap_;
+};
+
+struct Range {
+  uint64_t off;
+  uint64_t len;
+};
+
+/* The file ranges of a DSK / EXTENDED DSK image's written tracks: `written`
+ * is the FDC's write-back map (fdc_media_written_tracks — bit s of entry c =
+ * side s of cylinder c). Adjacent tracks coalesce. Empty on a non-DSK. */
+std::vector<Range> dsk_track_ranges(const uint8_t* dsk, size_t len,
+                                    const uint8_t* written, int ntracks);
+
+/* The file ranges of an IDE image's written regions: `written` is the
+ * Symbiface's region bitmap (sf2_media_written), `region_sectors` its
+ * granularity. Adjacent regions coalesce; the last is clipped to `len`. */
+std::vector<Range> region_ranges(const uint8_t* written, size_t nregions,
+                                 uint32_t region_sectors, size_t len);
+
+/* Persist `ranges` of `image` into `path` through the journal (see above).
+ * When the file's size differs from `len` (a new file, a reformat that grew
+ * the image) the whole image is written instead, via a temporary renamed
+ * over `path`. Returns false and fills `err` on failure. */
+bool write_back(const std::string& path, const uint8_t* image, size_t len,
+                const std::vector<Range>& ranges, std::string& err);
+
+/* Finish or discard an interrupted write_back on `path` (call before
+ * mapping it). Returns true when a complete journal was replayed. */
+bool recover(const std::string& path);
+
+}  // namespace media
@@ -0,0 +1,575 @@
+/* media_library.cpp — see media_library.h. */
+
+#include "media_library.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string_view>
+#include <unordered_map>
+
+#include "disk_file_editor.h"  // disk_list_files: the AMSDOS catalog
+#include "flux_ingest.h"       // flux::sniff: which flux container
+#include "hw_views.h"          // t_drive
+#include "search_engine.h"     // search_detail::fuzzy_score
+#include "slotshandler.h"      // dsk_load / dsk_eject
+#include "zip_archive.h"
+
+namespace library {
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr char kMagic[4] = {'K', 'L', 'I', 'B'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderLen = 16;
+constexpr size_t kRecordLen = 8 + 8 + 4 + 4 + (4 * 4);
+// Everything the slot loaders take, plus archives holding one of them.
+constexpr char kMediaExts[] = ".dsk.ipf.raw.scp.hfe.a2r.cdt.voc.sna.cpr";
+
+uint64_t rd(const uint8_t* p, int bytes) {
+  uint64_t v = 0;
+  for (int i = bytes - 1; i >= 0; --i) v = (v << 8) | p[i];
+  return v;
+}
+
+void put(std::vector<uint8_t>& out, uint64_t v, int bytes) {
+  for (int i = 0; i < bytes; ++i)
+    out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+std::string lower_ext(const std::string& name) {
+  if (name.size() < 4) return "";
+  std::string e = name.substr(name.size() - 4);
+  for (char& c : e)
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  return e;
+}
+
+bool is_media_ext(const std::string& ext, bool zip_too) {
+  if (ext.size() != 4 || ext[0] != '.') return false;
+  if (zip_too && ext == ".zip") return true;
+  return std::string_view(kMediaExts).find(ext) != std::string_view::npos;
+}
+
+int64_t mtime_of(const fs::path& p) {
+  std::error_code ec;
+  const auto t = fs::last_write_time(p, ec);
+  return ec ? 0 : static_cast<int64_t>(t.time_since_epoch().count());
+}
+
+std::vector<uint8_t> read_all(FILE* f) {
+  std::vector<uint8_t> out;
+  uint8_t buf[65536];
+  size_t n = 0;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    out.insert(out.end(), buf, buf + n);
+  return out;
+}
+
+// Format, hints and catalog of a DSK already parsed into `d`.
+void describe_dsk(const std::vector<uint8_t>& bytes, t_drive& d, Entry& e) {
+  const bool extended =
+      bytes.size() >= 8 && memcmp(bytes.data(), "EXTENDED", 8) == 0;
+  const unsigned sides = d.sides + 1;
+  std::string layout = "custom";
+  const t_track& t0 = d.track[0][0];
+  if (d.tracks > 0 && t0.sectors > 0) {
+    const unsigned r = t0.sector[0].CHRN[2];
+    if ((r & 0xC0) == 0xC0) {
+      layout = "DATA";
+    } else if ((r & 0xC0) == 0x40) {
+      layout = "SYSTEM";
+    } else if (r >= 1 && r <= 9) {
+      layout = "IBM";
+    }
+  }
+  e.format = std::string(extended ? "EDSK " : "DSK ") +
+             std::to_string(d.tracks) + "x" + std::to_string(sides) + " " +
+             layout;
+
+  // The usual tells of a copy-protected original: anything a plain
+  // 9-sector 512-byte AMSDOS format never contains.
+  std::set<std::string> hints;
+  if (d.tracks > 42) hints.insert("extra-tracks");
+  bool seen_unformatted = false;
+  for (unsigned t = 0; t < d.tracks; ++t) {
+    for (unsigned s = 0; s < sides; ++s) {
+      const t_track& tr = d.track[t][s];
+      if (tr.sectors == 0) {
+        seen_unformatted = true;
+        continue;
+      }
+      if (seen_unformatted) hints.insert("unformatted-tracks");
+      if (tr.sectors > 10) hints.insert("many-sectors");
+      for (unsigned i = 0; i < tr.sectors; ++i) {
+        const t_sector& sec = tr.sector[i];
+        const unsigned n = sec.CHRN[3];
+        if (n >= 6) hints.insert("oversize-sectors");
+        if (n != tr.sector[0].CHRN[3]) hints.insert("mixed-sizes");
+        if (sec.CHRN[0] != t) hints.insert("odd-ids");
+        if ((sec.flags[0] & 0x20) || (sec.flags[1] & 0x20))
+          hints.insert("crc-errors");
+        if (sec.flags[1] & 0x40) hints.insert("deleted-data");
+        const unsigned nominal = 0x80u << (n & 7);
+        if (n < 6 && sec.getTotalSize() > nominal) hints.insert("weak");
+      }
+    }
+  }
+  for (const std::string& h : hints)
+    e.hints += (e.hints.empty() ? "" : " ") + h;
+
+  std::string err;
+  for (const DiskFileEntry& f : disk_list_files(&d, err))
+    e.catalog += (e.catalog.empty() ? "" : " ") + f.display_name;
+}
+
+// Fill kind / format / hints / catalog from the media bytes; `f` is the same
+// bytes as a stream (dsk_load's input). false when it is not media.
+bool describe(const std::string& ext, const std::vector<uint8_t>& b, FILE* f,
+              Entry& e) {
+  const uint8_t* p = b.data();
+  const size_t n = b.size();
+  if (ext == ".dsk") {
+    auto d = std::make_unique<t_drive>();
+    std::memset(d.get(), 0, sizeof(t_drive));
+    rewind(f);
+    if (dsk_load(f, d.get()) != 0) return false;  // ejected on error
+    e.kind = Kind::Disk;
+    describe_dsk(b, *d, e);
+    dsk_eject(d.get());
+    return true;
+  }
+  if (ext == ".cdt" || ext == ".voc") {
+    e.kind = Kind::Tape;
+    if (ext == ".voc") {
+      e.format = "VOC";
+    } else if (n >= 10 && !memcmp(p, "ZXTape!\x1A", 8)) {
+      char v[32];
+      snprintf(v, sizeof(v), "CDT v%u.%02u", p[8], p[9]);
+      e.format = v;
+    } else {
+      return false;
+    }
+    return true;
+  }
+  if (ext == ".sna") {
+    if (n < 0x100 || memcmp(p, "MV - SNA", 8) != 0) return false;
+    static const char* const kModels[] = {"464", "664", "6128", "?",
+                                          "6128+", "464+", "GX4000"};
+    e.kind = Kind::Snapshot;
+    e.format = "SNA v" + std::to_string(p[0x10]);
+    if (p[0x10] >= 2 && p[0x6D] < 7)
+      e.format += std::string(" ") + kModels[p[0x6D]];
+    const unsigned kb = p[0x6B] | (p[0x6C] << 8);
+    if (kb != 0) e.format += " " + std::to_string(kb) + "K";
+    return true;
+  }
+  if (ext == ".cpr") {
+    if (n < 12 || memcmp(p, "RIFF", 4) != 0 || memcmp(p + 8, "AMS!", 4) != 0)
+      return false;
+    e.kind = Kind::Cartridge;
+    e.format = "CPR " + std::to_string(n / 1024) + "K";
+    return true;
+  }
+  // The flux containers: identified by magic, like the loader does.
+  switch (flux::sniff(p, n, ext)) {
+    case flux::Container::Ipf:
+      e.format = "IPF";
+      break;
+    case flux::Container::Scp:
+      e.format = "SCP";
+      break;
+    case flux::Container::Hfe:
+      e.format = "HFE";
+      break;
+    case flux::Container::A2R:
+      e.format = "A2R";
+      break;
+    case flux::Container::KryoFluxStream:
+      e.format = "KryoFlux";
+      break;
+    default:
+      return false;
+  }
+  e.kind = Kind::Flux;
+  return true;
+}
+
+std::string base_name(const char* path) {
+  const char* slash = std::strrchr(path, '/');
+#ifdef _WIN32
+  const char* bslash = std::strrchr(path, '\\');
+  if (bslash != nullptr && (slash == nullptr || bslash > slash)) slash = bslash;
+#endif
+  return slash != nullptr ? slash + 1 : path;
+}
+
+// Best fuzzy_score of `query` against any space-separated word of `text`: a
+// catalog is a list of names, not one long subsequence target.
+int best_word(const std::string& query, const char* text) {
+  int best = 0;
+  const char* p = text;
+  while (*p != '\0') {
+    const char* end = std::strchr(p, ' ');
+    if (end == nullptr) end = p + std::strlen(p);
+    if (end > p)
+      best = std::max(best, search_detail::fuzzy_score(query, {p, end}));
+    p = *end != '\0' ? end + 1 : end;
+  }
+  return best;
+}
+
+}  // namespace
+
+const char* kind_name(Kind k) {
+  switch (k) {
+    case Kind::Disk:
+      return "disk";
+    case Kind::Flux:
+      return "flux";
+    case Kind::Tape:
+      return "tape";
+    case Kind::Snapshot:
+      return "snapshot";
+    case Kind::Cartridge:
+      return "cartridge";
+  }
+  return "?";
+}
+
+bool index_file(const std::string& path, Entry& out) {
+  std::error_code ec;
+  const uint64_t size = fs::file_size(path, ec);
+  if (ec) return false;
+  std::string ext = lower_ext(path);
+  if (!is_media_ext(ext, true)) return false;
+
+  FILE* f = nullptr;
+  std::string inner;
+  if (ext == ".zip") {
+    zip::t_zip_info zi;
+    zi.filename = path;
+    zi.extensions = kMediaExts;
+    if (zip::dir(&zi) != 0 || zi.filesOffsets.empty()) return false;
+    zi.dwOffset = zi.filesOffsets[0].second;  // what the slot loader picks
+    if (zip::extract(zi, &f) != 0) return false;
+    inner = zi.filesOffsets[0].first;
+    ext = lower_ext(inner);
+  } else {
+    f = fopen(path.c_str(), "rb");
+    if (f == nullptr) return false;
+  }
+  const std::vector<uint8_t> bytes = read_all(f);
+
+  Entry e;
+  e.path = path;
+  e.size = size;
+  e.mtime = mtime_of(path);
+  e.crc = static_cast<uint32_t>(
+      crc32(crc32(0L, nullptr, 0), bytes.data(),
+            static_cast<uInt>(std::min<size_t>(bytes.size(), 0xFFFFFFFFu))));
+  const bool ok = !bytes.empty() && describe(ext, bytes, f, e);
+  fclose(f);
+  if (!ok) return false;
+  if (!inner.empty()) e.format += " (zip: " + inner + ")";
+  out = std::move(e);
+  return true;
+}
+
+std::vector<Entry> scan(const std::vector<std::string>& roots,
+                        const Index* previous, unsigned threads,
+                        const Progress& progress,
+                        const std::atomic<bool>* stop) {
+  struct Job {
+    std::string path;
+    uint64_t size;
+    int64_t mtime;
+  };
+  std::vector<Job> jobs;
+  for (const std::string& root : roots) {
+    std::error_code ec;
+    fs::recursive_directory_iterator it(
+        root, fs::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+      if (!it->is_regular_file(ec)) continue;
+      if (!is_media_ext(lower_ext(it->path().filename().string()), true))
+        continue;
+      const uint64_t size = it->file_size(ec);
+      if (ec) {
+        ec.clear();
+        continue;
+      }
+      jobs.push_back({it->path().string(), size, mtime_of(it->path())});
+    }
+  }
+
+  std::unordered_map<std::string, size_t> known;
+  if (previous != nullptr)
+    for (size_t i = 0; i < previous->size(); ++i)
+      known.emplace(previous->at(i).path, i);
+
+  std::vector<Entry> found(jobs.size());
+  std::vector<char> ok(jobs.size(), 0);
+  std::atomic<size_t> next{0};
+  std::mutex progress_mutex;
+  int done = 0;
+  const int total = static_cast<int>(jobs.size());
+  auto work = [&]() {
+    for (size_t i = next++; i < jobs.size(); i = next++) {
+      if (stop != nullptr && stop->load(std::memory_order_relaxed)) return;
+      const Job& j = jobs[i];
+      const auto k = known.find(j.path);
+      if (k != known.end()) {
+        Entry e = previous->at(k->second);
+        if (e.size == j.size && e.mtime == j.mtime) {
+          found[i] = std::move(e);
+          ok[i] = 1;
+        }
+      }
+      if (ok[i] == 0) ok[i] = index_file(j.path, found[i]) ? 1 : 0;
+      if (progress) {
+        std::scoped_lock const lock(progress_mutex);
+        progress(++done, total);
+      }
+    }
+  };
+  if (threads == 0)
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  threads = std::min<unsigned>(threads, std::max<size_t>(jobs.size(), 1));
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < threads; ++t) pool.emplace_back(work);
+  work();  // the caller is one of the workers
+  for (std::thread& t : pool) t.join();
+
+  std::vector<Entry> out;
+  out.reserve(jobs.size());
+  for (size_t i = 0; i < jobs.size(); ++i)
+    if (ok[i] != 0) out.push_back(std::move(found[i]));
+  std::sort(out.begin(), out.end(),
+            [](const Entry& a, const Entry& b) { return a.path < b.path; });
+  return out;
+}
+
+bool write_index(const std::string& path, const std::vector<Entry>& entries,
+                 std::string& err) {
+  std::vector<uint8_t> recs;
+  std::vector<uint8_t> blob;
+  recs.reserve(entries.size() * kRecordLen);
+  auto intern = [&blob](const std::string& s) {
+    const auto off = static_cast<uint32_t>(blob.size());
+    blob.insert(blob.end(), s.begin(), s.end());
+    blob.push_back(0);
+    return off;
+  };
+  for (const Entry& e : entries) {
+    put(recs, e.size, 8);
+    put(recs, static_cast<uint64_t>(e.mtime), 8);
+    put(recs, e.crc, 4);
+    put(recs, static_cast<uint32_t>(e.kind), 4);
+    put(recs, intern(e.path), 4);
+    put(recs, intern(e.format), 4);
+    put(recs, intern(e.hints), 4);
+    put(recs, intern(e.catalog), 4);
+  }
+  if (blob.size() > 0xFFFFFFFFu) {
+    err = "index too large";
+    return false;
+  }
+  std::vector<uint8_t> head(kMagic, kMagic + 4);
+  put(head, kVersion, 4);
+  put(head, entries.size(), 4);
+  put(head, blob.size(), 4);
+
+  const std::string tmp = path + ".tmp";
+  FILE* f = fopen(tmp.c_str(), "wb");
+  if (f == nullptr) {
+    err = "cannot write " + tmp;
+    return false;
+  }
+  bool ok = fwrite(head.data(), 1, head.size(), f) == head.size() &&
+            fwrite(recs.data(), 1, recs.size(), f) == recs.size() &&
+            fwrite(blob.data(), 1, blob.size(), f) == blob.size();
+  ok = fclose(f) == 0 && ok;
+  if (!ok) {
+    std::remove(tmp.c_str());
+    err = "short write to " + tmp;
+    return false;
+  }
+#ifdef _WIN32
+  std::remove(path.c_str());  // Windows rename() will not replace
+#endif
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    err = "cannot rename " + tmp + " over " + path;
+    return false;
+  }
+  return true;
+}
+
+Index Index::open(const std::string& path) {
+  Index ix;
+  ix.buf_ = media::Buffer::map(path);
+  const uint8_t* p = ix.buf_.data();
+  const size_t n = ix.buf_.size();
+  if (n < kHeaderLen || memcmp(p, kMagic, 4) != 0 ||
+      rd(p + 4, 4) != kVersion)
+    return {};
+  const uint64_t count = rd(p + 8, 4);
+  const uint64_t blob_len = rd(p + 12, 4);
+  const uint64_t blob = kHeaderLen + (count * kRecordLen);
+  // The blob must end in a NUL, so every in-range offset is a C string.
+  if (blob + blob_len != n || (blob_len != 0 && p[n - 1] != 0)) return {};
+  for (uint64_t i = 0; i < count; ++i) {
+    const uint8_t* r = p + kHeaderLen + (i * kRecordLen);
+    for (int s = 0; s < 4; ++s)
+      if (rd(r + 24 + (4 * s), 4) >= blob_len) return {};
+  }
+  ix.count_ = static_cast<size_t>(count);
+  ix.blob_ = static_cast<size_t>(blob);
+  return ix;
+}
+
+const uint8_t* Index::record(size_t i) const {
+  return buf_.data() + kHeaderLen + (i * kRecordLen);
+}
+
+const char* Index::str(uint32_t off) const {
+  return reinterpret_cast<const char*>(buf_.data() + blob_ + off);
+}
+
+Entry Index::at(size_t i) const {
+  const uint8_t* r = record(i);
+  Entry e;
+  e.size = rd(r, 8);
+  e.mtime = static_cast<int64_t>(rd(r + 8, 8));
+  e.crc = static_cast<uint32_t>(rd(r + 16, 4));
+  e.kind = static_cast<Kind>(rd(r + 20, 4));
+  e.path = str(static_cast<uint32_t>(rd(r + 24, 4)));
+  e.format = str(static_cast<uint32_t>(rd(r + 28, 4)));
+  e.hints = str(static_cast<uint32_t>(rd(r + 32, 4)));
+  e.catalog = str(static_cast<uint32_t>(rd(r + 36, 4)));
+  return e;
+}
+
+std::vector<Hit> Index::query(const std::string& query, size_t limit) const {
+  std::vector<std::pair<int, size_t>> scored;
+  for (size_t i = 0; i < count_; ++i) {
+    const uint8_t* r = record(i);
+    auto field = [&](int at) {
+      return str(static_cast<uint32_t>(rd(r + at, 4)));
+    };
+    int best = search_detail::fuzzy_score(query, base_name(field(24)));
+    best = std::max(best, best_word(query, field(36)));  // catalog
+    best = std::max(best, search_detail::fuzzy_score(query, field(28)));
+    best = std::max(best, best_word(query, field(32)));  // hints
+    if (best > 0) scored.emplace_back(best, i);
+  }
+  const size_t keep = std::min(limit, scored.size());
+  // Best score first; ties keep the index's path order.
+  std::partial_sort(scored.begin(), scored.begin() + keep, scored.end(),
+                    [](const auto& a, const auto& b) {
+                      return a.first != b.first ? a.first > b.first
+                                                : a.second < b.second;
+                    });
+  std::vector<Hit> hits;
+  hits.reserve(keep);
+  for (size_t i = 0; i < keep; ++i)
+    hits.push_back({scored[i].first, at(scored[i].second)});
+  return hits;
+}
+
+Service::~Service() {
+  stop_.store(true, std::memory_order_relaxed);
+  join();
+}
+
+void Service::join() {
+  if (worker_.joinable()) worker_.join();
+}
+
+void Service::set_path(const std::string& path) {
+  auto ix = std::make_shared<const Index>(Index::open(path));
+  std::scoped_lock const lock(mutex_);
+  path_ = path;
+  index_ = std::move(ix);
+  gen_.fetch_add(1, std::memory_order_release);
+}
+
+std::string Service::path() const {
+  std::scoped_lock const lock(mutex_);
+  return path_;
+}
+
+std::string Service::last_error() const {
+  std::scoped_lock const lock(mutex_);
+  return error_;
+}
+
+size_t Service::size() const {
+  std::scoped_lock const lock(mutex_);
+  return index_ ? index_->size() : 0;
+}
+
+std::vector<Hit> Service::query(const std::string& q, size_t limit) const {
+  std::shared_ptr<const Index> ix;
+  {
+    std::scoped_lock const lock(mutex_);
+    ix = index_;
+  }
+  return ix ? ix->query(q, limit) : std::vector<Hit>{};
+}
+
+bool Service::start_scan(std::vector<std::string> roots) {
+  if (scanning_.exchange(true, std::memory_order_acq_rel)) return false;
+  join();  // the previous, finished worker
+  std::scoped_lock const lock(mutex_);
+  if (roots.empty()) roots = roots_;
+  if (roots.empty() || path_.empty()) {
+    scanning_.store(false, std::memory_order_release);
+    return false;
+  }
+  roots_ = roots;
+  error_.clear();
+  done_.store(0, std::memory_order_relaxed);
+  total_.store(0, std::memory_order_relaxed);
+  worker_ = std::thread([this, roots = std::move(roots), path = path_,
+                         prev = index_] {
+    std::vector<Entry> entries =
+        scan(roots, prev.get(), 0,
+             [this](int done, int total) {
+               total_.store(total, std::memory_order_relaxed);
+               done_.store(done, std::memory_order_relaxed);
+             },
+             &stop_);
+    std::string err;
+    if (!stop_.load(std::memory_order_relaxed)) {
+      if (write_index(path, entries, err)) {
+        auto ix = std::make_shared<const Index>(Index::open(path));
+        std::scoped_lock const lock(mutex_);
+        index_ = std::move(ix);
+        gen_.fetch_add(1, std::memory_order_release);
+      } else {
+        std::scoped_lock const lock(mutex_);
+        error_ = err;
+      }
+    }
+    scanning_.store(false, std::memory_order_release);
+  });
+  return true;
+}
+
+Service& service() {
+  static Service s;
+  return s;
+}
+
+}  // namespace library
@@ -0,0 +1,139 @@
+/* media_library — a searchable index of a media collection.
+ *
+ * scan() walks directories of .dsk/.ipf/.raw/.scp/.hfe/.a2r/.cdt/.sna/.cpr
+ * files (and .zip archives holding one) on a thread pool and describes each
+ * one: its CRC-32 (zlib's, the rom_identify.h convention), a format line, copy
+ * protection hints read off the DSK track layout, and the AMSDOS catalog
+ * (disk_list_files over the parsed image). A rescan reuses every entry whose
+ * path, size and mtime are unchanged, so only new or touched files are read.
+ *
+ * The result is written to a flat index file and read back through a
+ * media::Buffer map: records are fixed-size and every string lives in one
+ * NUL-separated blob, so opening a 40k-entry index costs one mmap and a query
+ * is a linear fuzzy_score pass (search_engine.h, as the command palette
+ * ranks its commands) over mapped memory.
+ *
+ * Index layout (little-endian): "KLIB", u32 version, u32 record count, u32
+ * blob length; then the records — u64 size, i64 mtime, u32 crc, u32 kind,
+ * u32 offsets of path / format / hints / catalog in the blob — then the blob.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "media_file.h"
+
+namespace library {
+
+enum class Kind : uint32_t { Disk, Flux, Tape, Snapshot, Cartridge };
+
+const char* kind_name(Kind k);
+
+struct Entry {
+  std::string path;
+  uint64_t size = 0;
+  int64_t mtime = 0;  // filesystem clock ticks: compared, never shown
+  uint32_t crc = 0;   // of the media itself (the inner entry of a .zip)
+  Kind kind = Kind::Disk;
+  std::string format;   // "EDSK 42x1 DATA", "SNA v3 6128", "zip: GAME.DSK"...
+  std::string hints;    // protection hints, space separated ("" = none seen)
+  std::string catalog;  // AMSDOS directory, space separated ("" = n/a)
+};
+
+struct Hit {
+  int score;
+  Entry entry;
+};
+
+// Files scanned of the total; called from the pool, serialized.
+using Progress = std::function<void(int done, int total)>;
+
+class Index {
+ public:
+  /* Map an index file; empty (size() == 0) when missing or malformed. */
+  static Index open(const std::string& path);
+
+  size_t size() const { return count_; }
+  Entry at(size_t i) const;
+
+  /* The best `limit` entries for `query`, best first: each scores the best
+   * of its file name, catalog, format and hints. */
+  std::vector<Hit> query(const std::string& query, size_t limit) const;
+
+ private:
+  const uint8_t* record(size_t i) const;
+  const char* str(uint32_t off) const;
+
+  media::Buffer buf_;
+  size_t count_ = 0;
+  size_t blob_ = 0;  // offset of the string blob in buf_
+};
+
+/* Describe one file. false when it is not media (or unreadable). */
+bool index_file(const std::string& path, Entry& out);
+
+/* Scan `roots` recursively. Entries of `previous` whose path, size and mtime
+ * still match are carried over without reading the file. threads = 0 means
+ * one per hardware thread. Sorted by path. Setting *stop makes the workers
+ * quit early; the (partial) result is then meaningless. */
+std::vector<Entry> scan(const std::vector<std::string>& roots,
+                        const Index* previous = nullptr, unsigned threads = 0,
+                        const Progress& progress = {},
+                        const std::atomic<bool>* stop = nullptr);
+
+/* Write `entries` as an index file (temp + rename, so a reader mapping the
+ * old one is never torn). Returns false and fills `err` on failure. */
+bool write_index(const std::string& path, const std::vector<Entry>& entries,
+                 std::string& err);
+
+/* The process-wide library the IPC `library` command and the command
+ * palette share: the open index, and at most one background rescan that
+ * rewrites it and swaps the fresh one in. Thread-safe. */
+class Service {
+ public:
+  ~Service();
+
+  /* Use (and open) the index file at `path`. */
+  void set_path(const std::string& path);
+  std::string path() const;
+
+  /* Rescan `roots` (empty = the roots of the previous scan) on a worker.
+   * false when one is already running or there is nothing to scan. */
+  bool start_scan(std::vector<std::string> roots);
+  bool scanning() const { return scanning_.load(std::memory_order_acquire); }
+  int scan_done() const { return done_.load(std::memory_order_relaxed); }
+  int scan_total() const { return total_.load(std::memory_order_relaxed); }
+  std::string last_error() const;
+
+  size_t size() const;
+  /* Bumped whenever a scan swaps a new index in (UI result caching). */
+  uint64_t generation() const { return gen_.load(std::memory_order_acquire); }
+  std::vector<Hit> query(const std::string& q, size_t limit) const;
+
+ private:
+  void join();
+
+  mutable std::mutex mutex_;
+  std::string path_;
+  std::vector<std::string> roots_;
+  std::string error_;
+  std::shared_ptr<const Index> index_;
+  std::thread worker_;
+  std::atomic<bool> scanning_{false};
+  std::atomic<bool> stop_{false};
+  std::atomic<int> done_{0};
+  std::atomic<int> total_{0};
+  std::atomic<uint64_t> gen_{0};
+};
+
+Service& service();
+
+}  // namespace library
@@ -0,0 +1,327 @@
+// Frame-dump PNG writer — see png_dump.h.
+//
+// Error handling follows savepng.cpp: libpng longjmps out of encode() on a
+// fatal error, so that frame holds only trivially-destructible locals and
+// every resource is owned by a guard in the caller.
+
+#include "png_dump.h"
+
+#include <png.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kNoColour = ~uint32_t{0};
+constexpr int kColourHash = 1024;  // open addressing for <= 256 colours
+
+struct Sink {
+  FILE* f = nullptr;                  // file output, or
+  std::vector<uint8_t>* mem = nullptr;  // in-memory output
+  uint64_t bytes = 0;
+  char error[128] = {};
+};
+
+[[noreturn]] void on_png_error(png_structp png, png_const_charp msg) {
+  Sink* sink = static_cast<Sink*>(png_get_error_ptr(png));
+  if (sink->error[0] == '\0')
+    snprintf(sink->error, sizeof(sink->error), "libpng: %s", msg);
+  png_longjmp(png, 1);
+}
+
+void on_png_write(png_structp png, png_bytep data, png_size_t length) {
+  Sink* sink = static_cast<Sink*>(png_get_io_ptr(png));
+  if (sink->mem) {
+    sink->mem->insert(sink->mem->end(), data, data + length);
+  } else if (fwrite(data, 1, length, sink->f) != length) {
+    snprintf(sink->error, sizeof(sink->error), "write failed: %s",
+             strerror(errno));
+    png_error(png, "write failed");
+  }
+  sink->bytes += length;
+}
+
+void on_png_flush(png_structp /*unused*/) {}
+
+int libpng_filter(PngFilter f, bool paletted) {
+  switch (f) {
+    case PngFilter::None: return PNG_FILTER_NONE;
+    case PngFilter::Sub: return PNG_FILTER_SUB;
+    case PngFilter::Up: return PNG_FILTER_UP;
+    case PngFilter::Avg: return PNG_FILTER_AVG;
+    case PngFilter::Paeth: return PNG_FILTER_PAETH;
+    case PngFilter::All: return PNG_ALL_FILTERS;
+    case PngFilter::Auto: break;
+  }
+  return paletted ? PNG_FILTER_NONE : PNG_ALL_FILTERS;
+}
+
+// Index the image into `idx` (one byte per pixel) with at most 256 palette
+// entries; false when it has more colours.
+bool build_palette(const uint8_t* rgba, int w, int h, int pitch,
+                   std::vector<uint8_t>& idx, png_color* pal, int& npal) {
+  uint32_t keys[kColourHash];
+  uint8_t vals[kColourHash];
+  std::fill(std::begin(keys), std::end(keys), kNoColour);
+  npal = 0;
+  idx.resize(static_cast<size_t>(w) * h);
+  uint32_t last = kNoColour;
+  uint8_t last_idx = 0;
+  for (int y = 0; y < h; ++y) {
+    const uint8_t* p = rgba + (static_cast<size_t>(y) * pitch);
+    uint8_t* d = &idx[static_cast<size_t>(y) * w];
+    for (int x = 0; x < w; ++x, p += 4) {
+      const uint32_t c = (uint32_t{p[0]} << 16) | (uint32_t{p[1]} << 8) | p[2];
+      if (c != last) {  // runs of one colour are the common case
+        uint32_t hh = (c * 2654435761u) >> 22;
+        while (keys[hh] != kNoColour && keys[hh] != c)
+          hh = (hh + 1) & (kColourHash - 1);
+        if (keys[hh] == kNoColour) {
+          if (npal == 256) return false;
+          keys[hh] = c;
+          vals[hh] = static_cast<uint8_t>(npal);
+          pal[npal] = {p[0], p[1], p[2]};
+          npal++;
+        }
+        last = c;
+        last_idx = vals[hh];
+      }
+      d[x] = last_idx;
+    }
+  }
+  return true;
+}
+
+class PngWriter {
+ public:
+  explicit PngWriter(Sink* sink)
+      : png_(png_create_write_struct(PNG_LIBPNG_VER_STRING, sink, on_png_error,
+                                     nullptr)) {
+    if (png_ != nullptr) info_ = png_create_info_struct(png_);
+  }
+  ~PngWriter() {
+    if (png_ != nullptr)
+      png_destroy_write_struct(&png_, info_ != nullptr ? &info_ : nullptr);
+  }
+  PngWriter(const PngWriter&) = delete;
+  PngWriter& operator=(const PngWriter&) = delete;
+
+  bool ok() const { return png_ != nullptr && info_ != nullptr; }
+  png_structp png() const { return png_; }
+  png_infop info() const { return info_; }
+
+ private:
+  png_structp png_ = nullptr;
+  png_infop info_ = nullptr;
+};
+
+// The libpng call sequence; the longjmp target (see the file comment).
+bool encode(png_structp png, png_infop info, Sink* sink, int width, int height,
+            const png_color* pal, int npal, int level, int filter,
+            png_bytep* rows) {
+  // NOLINTNEXTLINE(modernize-avoid-setjmp-longjmp): libpng's error handling
+  // mandates setjmp/longjmp
+  if (setjmp(png_jmpbuf(png)) != 0) return false;
+  png_set_write_fn(png, sink, on_png_write, on_png_flush);
+  png_set_compression_level(png, level);
+  png_set_filter(png, PNG_FILTER_TYPE_BASE, filter);
+  png_set_IHDR(png, info, width, height, 8,
+               pal ? PNG_COLOR_TYPE_PALETTE : PNG_COLOR_TYPE_RGB,
+               PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+               PNG_FILTER_TYPE_DEFAULT);
+  if (pal) png_set_PLTE(png, info, pal, npal);
+  png_write_info(png, info);
+  if (!pal) png_set_filler(png, 0, PNG_FILLER_AFTER);  // drop the x byte
+  png_write_image(png, rows);
+  png_write_end(png, info);
+  return true;
+}
+
+}  // namespace
+
+bool png_filter_from_string(const std::string& name, PngFilter& out) {
+  static const struct {
+    const char* name;
+    PngFilter filter;
+  } kNames[] = {{"auto", PngFilter::Auto}, {"none", PngFilter::None},
+                {"sub", PngFilter::Sub},   {"up", PngFilter::Up},
+                {"avg", PngFilter::Avg},   {"paeth", PngFilter::Paeth},
+                {"all", PngFilter::All}};
+  for (const auto& n : kNames) {
+    if (name == n.name) {
+      out = n.filter;
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace {
+
+// Palette-or-RGB encode of one image into `sink`; false with sink->error set.
+bool encode_into(Sink& sink, const uint8_t* rgba, int width, int height,
+                 int pitch, const PngOptions& opts, bool& paletted) {
+  std::vector<uint8_t> idx;
+  png_color pal[256];
+  int npal = 0;
+  paletted = build_palette(rgba, width, height, pitch, idx, pal, npal);
+
+  std::vector<png_bytep> rows(static_cast<size_t>(height));
+  for (int y = 0; y < height; ++y) {
+    rows[static_cast<size_t>(y)] =
+        paletted ? &idx[static_cast<size_t>(y) * width]
+                 // libpng only reads the rows; the API is not const-clean
+                 : const_cast<png_bytep>(rgba + (static_cast<size_t>(y) * pitch));
+  }
+  PngWriter const writer(&sink);
+  if (!writer.ok()) {
+    snprintf(sink.error, sizeof(sink.error), "libpng init failed");
+    return false;
+  }
+  return encode(writer.png(), writer.info(), &sink, width, height,
+                paletted ? pal : nullptr, npal,
+                std::clamp(opts.zlib_level, 0, 9),
+                libpng_filter(opts.filter, paletted), rows.data());
+}
+
+}  // namespace
+
+PngWriteResult write_png_rgba(const std::string& path, const uint8_t* rgba,
+                              int width, int height, int pitch,
+                              const PngOptions& opts) {
+  PngWriteResult r;
+  if (!rgba || width <= 0 || height <= 0) {
+    r.error = "empty image";
+    return r;
+  }
+  Sink sink;
+  sink.f = fopen(path.c_str(), "wb");
+  if (!sink.f) {
+    r.error = std::string("cannot open: ") + strerror(errno);
+    return r;
+  }
+  bool encoded = encode_into(sink, rgba, width, height, pitch, opts, r.paletted);
+  // Close unconditionally; a failed flush means a truncated file.
+  if (fclose(sink.f) != 0 && encoded) {
+    encoded = false;
+    snprintf(sink.error, sizeof(sink.error), "close failed: %s",
+             strerror(errno));
+  }
+  if (!encoded) {
+    r.error = sink.error;
+    std::remove(path.c_str());
+    return r;
+  }
+  r.ok = true;
+  r.bytes = sink.bytes;
+  return r;
+}
+
+PngWriteResult encode_png_rgba(std::vector<uint8_t>& out, const uint8_t* rgba,
+                               int width, int height, int pitch,
+                               const PngOptions& opts) {
+  PngWriteResult r;
+  out.clear();
+  if (!rgba || width <= 0 || height <= 0) {
+    r.error = "empty image";
+    return r;
+  }
+  Sink sink;
+  sink.mem = &out;
+  if (!encode_into(sink, rgba, width, height, pitch, opts, r.paletted)) {
+    r.error = sink.error;
+    out.clear();
+    return r;
+  }
+  r.ok = true;
+  r.bytes = sink.bytes;
+  return r;
+}
+
+PngDumpPool::PngDumpPool(int threads, size_t max_queued, PngOptions opts)
+    : opts_(opts), max_queued_(std::max<size_t>(1, max_queued)) {
+  if (threads <= 0) {
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::clamp(cores - 1, 1, 8);
+  }
+  workers_.reserve(static_cast<size_t>(threads));
+  for (int i = 0; i < threads; ++i)
+    workers_.emplace_back(&PngDumpPool::worker_main, this);
+}
+
+PngDumpPool::~PngDumpPool() { finish(); }
+
+void PngDumpPool::submit(const std::string& path, const uint8_t* rgba,
+                         int width, int height, int pitch) {
+  if (!rgba || width <= 0 || height <= 0) return;
+  std::unique_lock<std::mutex> lk(mutex_);
+  if (stopping_) return;
+  if (queue_.size() >= max_queued_) {
+    report_.waits++;
+    not_full_.wait(lk, [this] { return queue_.size() < max_queued_; });
+  }
+  Job job;
+  job.path = path;
+  job.width = width;
+  job.height = height;
+  if (!spare_.empty()) {
+    job.data = std::move(spare_.back());
+    spare_.pop_back();
+  }
+  lk.unlock();
+  // Copy outside the lock: workers keep encoding meanwhile.
+  const size_t row = static_cast<size_t>(width) * 4;
+  job.data.resize(row * static_cast<size_t>(height));
+  for (int y = 0; y < height; ++y)
+    std::memcpy(job.data.data() + (row * y),
+                rgba + (static_cast<size_t>(y) * pitch), row);
+  lk.lock();
+  queue_.push_back(std::move(job));
+  report_.queue_peak =
+      std::max(report_.queue_peak, static_cast<uint32_t>(queue_.size()));
+  lk.unlock();
+  not_empty_.notify_one();
+}
+
+void PngDumpPool::worker_main() {
+  std::unique_lock<std::mutex> lk(mutex_);
+  for (;;) {
+    not_empty_.wait(lk, [this] { return stopping_ || !queue_.empty(); });
+    if (queue_.empty()) return;  // stopping and drained
+    Job job = std::move(queue_.front());
+    queue_.pop_front();
+    lk.unlock();
+    not_full_.notify_one();
+
+    const PngWriteResult r = write_png_rgba(
+        job.path, job.data.data(), job.width, job.height, job.width * 4, opts_);
+
+    lk.lock();
+    if (r.ok) {
+      report_.written++;
+      report_.bytes += r.bytes;
+      if (r.paletted) report_.paletted++;
+    } else {
+      report_.failed++;
+      if (report_.first_error.empty())
+        report_.first_error = job.path + ": " + r.error;
+    }
+    if (spare_.size() < max_queued_) spare_.push_back(std::move(job.data));
+  }
+}
+
+PngDumpPool::Report PngDumpPool::finish() {
+  {
+    std::scoped_lock const lk(mutex_);
+    stopping_ = true;
+  }
+  not_empty_.notify_all();
+  for (auto& t : workers_)
+    if (t.joinable()) t.join();
+  std::scoped_lock const lk(mutex_);
+  return report_;
+}
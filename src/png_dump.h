@@ -0,0 +1,95 @@
+#pragma once
+
+// Frame-dump PNG writer: RGBA8 pixels -> PNG file, over libpng, with no SDL
+// dependency (the frame pipeline hands it raw pixels).
+//
+// A CPC frame holds at most 27 classic / 4096 Plus colours and in practice
+// almost always fits 256, so frames are written as 8-bit palette PNGs — about
+// a quarter of the bytes to deflate of RGBA, and a smaller file. A frame that
+// does not fit falls back to 24-bit RGB. Alpha is dropped (frames are opaque).
+//
+// PngDumpPool runs those encodes on worker threads behind a bounded queue, so
+// a bulk `frames dump` overlaps encoding with emulation instead of stalling it.
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// PNG row filter. None suits palette images (the PNG spec's own advice);
+// All lets libpng pick per row, which pays off on 24-bit fallbacks.
+enum class PngFilter { Auto, None, Sub, Up, Avg, Paeth, All };
+
+struct PngOptions {
+  int zlib_level = 6;  // 0-9
+  PngFilter filter = PngFilter::Auto;  // Auto: None if paletted, else All
+};
+
+// Parse "none|sub|up|avg|paeth|all|auto"; false on anything else.
+bool png_filter_from_string(const std::string& name, PngFilter& out);
+
+struct PngWriteResult {
+  bool ok = false;
+  bool paletted = false;
+  uint64_t bytes = 0;
+  std::string error;  // set when !ok
+};
+
+// Encode one RGBA8 (R,G,B,x byte order; pitch in bytes) image to `path`.
+PngWriteResult write_png_rgba(const std::string& path, const uint8_t* rgba,
+                              int width, int height, int pitch,
+                              const PngOptions& opts = {});
+// The same encode into memory (`out` is replaced).
+PngWriteResult encode_png_rgba(std::vector<uint8_t>& out, const uint8_t* rgba,
+                               int width, int height, int pitch,
+                               const PngOptions& opts = {});
+
+class PngDumpPool {
+ public:
+  // threads <= 0 picks from the core count (leaving one for the emulation).
+  explicit PngDumpPool(int threads = 0, size_t max_queued = 16,
+                       PngOptions opts = {});
+  ~PngDumpPool();
+  PngDumpPool(const PngDumpPool&) = delete;
+  PngDumpPool& operator=(const PngDumpPool&) = delete;
+
+  // Copy the frame and queue it for `path`. Blocks only while the queue is
+  // full (counted in Report::waits).
+  void submit(const std::string& path, const uint8_t* rgba, int width,
+              int height, int pitch);
+
+  struct Report {
+    uint32_t written = 0;
+    uint32_t failed = 0;
+    uint32_t paletted = 0;  // of written; the rest are 24-bit RGB
+    uint64_t bytes = 0;
+    uint32_t queue_peak = 0;
+    uint64_t waits = 0;       // submits that had to wait for a slot
+    std::string first_error;  // "<path>: <reason>" of the first failure
+  };
+  // Wait for every queued frame, stop the workers and report. Idempotent.
+  Report finish();
+
+  int threads() const { return static_cast<int>(workers_.size()); }
+
+ private:
+  struct Job {
+    std::string path;
+    int width = 0, height = 0;
+    std::vector<uint8_t> data;  // packed RGBA rows
+  };
+  void worker_main();
+
+  PngOptions opts_;
+  size_t max_queued_;
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_, not_full_;
+  std::deque<Job> queue_;
+  std::vector<std::vector<uint8_t>> spare_;  // recycled frame buffers
+  bool stopping_ = false;
+  Report report_;
+};
@@ -90,17 +90,22 @@ file_loader files_loader_list[] = {
      },
      [](FILE* file) -> int { return ipf_load(file, &driveB); }},
 
-    // Native flux containers (drive-A only — the FDC's flux capture is
-    // side-0/drive-A-only). They carry no legacy t_drive sector view; the
-    // flux itself is transcoded to SCP by flux::to_scp in the mirror branch
-    // below, so the loader is a validated no-op that just lets dispatch
-    // reach that branch.
+    // Native flux containers (either drive). They carry no legacy t_drive
+    // sector view; the flux itself is transcoded to SCP by flux::to_scp in
+    // the mirror branch below, so the loader is a validated no-op that just
+    // lets dispatch reach that branch.
     {DRIVE::DSK_A, ".scp", [](const std::string&) -> int { return 0; },
      [](FILE*) -> int { return 0; }},
+    {DRIVE::DSK_B, ".scp", [](const std::string&) -> int { return 0; },
+     [](FILE*) -> int { return 0; }},
     {DRIVE::DSK_A, ".hfe", [](const std::string&) -> int { return 0; },
      [](FILE*) -> int { return 0; }},
+    {DRIVE::DSK_B, ".hfe", [](const std::string&) -> int { return 0; },
+     [](FILE*) -> int { return 0; }},
     {DRIVE::DSK_A, ".a2r", [](const std::string&) -> int { return 0; },
      [](FILE*) -> int { return 0; }},
+    {DRIVE::DSK_B, ".a2r", [](const std::string&) -> int { return 0; },
+     [](FILE*) -> int { return 0; }},
 
     {DRIVE::SNAPSHOT, ".sna", &snapshot_load, &snapshot_load},
 
@@ -948,10 +953,8 @@ int cartridge_load(FILE* file) {
 std::string drive_extensions(const DRIVE drive) {
   switch (drive) {
     case DRIVE::DSK_A:
-      // Flux containers are drive-A-only (side-0/drive-A flux capture).
-      return ".dsk.ipf.raw.scp.hfe.a2r";
     case DRIVE::DSK_B:
-      return ".dsk.ipf.raw";
+      return ".dsk.ipf.raw.scp.hfe.a2r";
     case DRIVE::TAPE:
       return ".cdt.voc";
     case DRIVE::SNAPSHOT:
@@ -985,7 +988,7 @@ std::vector<uint8_t> read_file_bytes(const std::string& path) {
 }  // namespace
 
 // Still some duplication there... but it cannot really be helped
-int file_load(t_slot& slot) {
+int file_load(t_slot& slot, const flux::Progress& progress) {
   if (slot.file.empty()) {
     // Special casing because this is not an error if called from loadSlots
     LOG_VERBOSE("Ignoring empty filename passed to file_load.")
@@ -1076,14 +1079,15 @@ int file_load(t_slot& slot) {
     } else if (is_flux) {
       // The sub-cycle FDC eats flux: run the raw file bytes through the unified
       // content-sniffing dispatcher (flux::to_scp) into an in-memory SCP
-      // capture. For .ipf/.raw the loader above ran ipf_load into driveA (the
-      // sector view disc-tools/DSK-export need), and to_scp falls back to that
-      // mirror only for CAPS-encoder IPFs. Flux is drive-A-only (fdc.cpp
-      // sel_media), so drive B keeps the legacy path.
-      if (slot.drive == DRIVE::DSK_A) {
+      // capture. For .ipf/.raw the loader above ran ipf_load into the
+      // drive (the sector view disc-tools/DSK-export need), and to_scp falls
+      // back to that mirror only for CAPS-encoder IPFs. Either drive plays
+      // flux (fdc.cpp sel_media).
+      if (slot.drive == DRIVE::DSK_A || slot.drive == DRIVE::DSK_B) {
+        const uint8_t unit = slot.drive == DRIVE::DSK_B ? 1 : 0;
         std::vector<uint8_t> raw = slot_bytes();
         std::vector<uint8_t> scp =
-            flux::to_scp(raw.data(), raw.size(), extension);
+            flux::to_scp(raw.data(), raw.size(), extension, progress);
         if (scp.empty()) {
           LOG_ERROR("subcycle engine: could not transcode " << slot.file
                                                             << " into flux");
@@ -1091,17 +1095,54 @@ int file_load(t_slot& slot) {
           // load. Surface the sector-view error if we had one, else generic.
           return ret != 0 ? ret : ERR_DSK_INVALID;
         }
-        subcycle_bridge_insert_media(std::move(scp), true, 0);
+        subcycle_bridge_insert_media(std::move(scp), true, unit);
         return 0;  // flux transcode is the authority: a successful decode is a
                    // successful load even when the sector-view loader
                    // (ipf_load) failed or was stubbed out in a clean build.
       }
-      LOG_INFO(
-          "subcycle engine: flux is drive-A-only — IPF/RAW in "
-          "drive B stays on the legacy path");
     }
     return ret;
   }
   LOG_ERROR("File format unsupported for " << slot.file);
   return ERR_FILE_UNSUPPORTED;
 }
+
+t_disk_decode::~t_disk_decode() { dsk_eject(&drive); }
+
+int disk_decode(const std::string& path, t_disk_decode& out,
+                const flux::Progress& progress) {
+  const std::string extension =
+      path.size() >= 4 ? stringutils::lower(path.substr(path.size() - 4)) : "";
+  if (extension != ".ipf" && extension != ".raw") {
+    LOG_ERROR("File format unsupported for " << path);
+    return out.result = ERR_FILE_UNSUPPORTED;
+  }
+  // The sector view is best-effort, as in file_load: a CAPS-encoder IPF fails
+  // it yet still plays as flux.
+  const int ret = ipf_load(path, &out.drive);
+  if (!subcycle_bridge_active()) return out.result = ret;
+  std::vector<uint8_t> raw = read_file_bytes(path);
+  out.scp = flux::to_scp(raw.data(), raw.size(), extension, progress);
+  if (out.scp.empty()) {
+    LOG_ERROR("subcycle engine: could not transcode " << path << " into flux");
+    return out.result = ret != 0 ? ret : ERR_DSK_INVALID;
+  }
+  return out.result = 0;
+}
+
+int disk_install(t_slot& slot, t_disk_decode& decoded) {
+  if (decoded.result != 0) return decoded.result;
+  const bool unit_b = slot.drive == DRIVE::DSK_B;
+  t_drive* live = unit_b ? &driveB : &driveA;
+  const bool was_paused = CPC.paused;
+  cpc_pause_and_wait();
+  dsk_eject(live);  // mirrors the eject into the engine
+  const unsigned int head_position = live->current_track;
+  *live = decoded.drive;  // the tracks change hands
+  live->current_track = head_position;
+  decoded.drive = t_drive{};
+  if (!decoded.scp.empty())
+    subcycle_bridge_insert_media(std::move(decoded.scp), true, unit_b ? 1 : 0);
+  if (!was_paused) cpc_resume();
+  return 0;
+}
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "flux_ingest.h"  // flux::Progress
 #include "hw_views.h"
 #include "koncepcja.h"
 
@@ -16,8 +17,8 @@ FILE* extractFile(const std::string& zipfile, const std::string& filename,
                   const std::string& ext);
 
 // The dotted extension list a slot accepts (e.g. ".dsk.ipf.raw.scp.hfe.a2r"
-// for drive A — flux containers are drive-A-only, side-0/drive-A flux
-// capture). THE single source of truth for what each slot loads: the loader
+// for either drive — the sub-cycle FDC plays flux in both). THE single source
+// of truth for what each slot loads: the loader
 // dispatch, the zip prefilter, the drag-&-drop routing and its drift-guard
 // test all consume this. Add a format here, not at the call sites.
 std::string drive_extensions(DRIVE drive);
@@ -47,8 +48,31 @@ int cartridge_load(const std::string& filepath);
 int cartridge_load(FILE* file);
 
 // Smart load: DSK, SNA, CDT, VOC, CPR, or a zip containing one of these.
-// slot.drive must match the type of file being loaded.
-int file_load(t_slot& slot);
+// slot.drive must match the type of file being loaded. `progress` follows the
+// flux transcode of a flux container (flux::to_scp; only an IPF reports).
+int file_load(t_slot& slot, const flux::Progress& progress = {});
+
+// A flux-container disc (.ipf/.raw) decoded off the UI thread. The IPF decode
+// is slow enough to freeze the window, so disk_decode() fills this private
+// copy (the legacy sector view and the engine's SCP flux) without touching
+// the live drive, and disk_install() swaps it in from the UI thread.
+struct t_disk_decode {
+  t_drive drive{};
+  std::vector<uint8_t> scp;  // empty when the sub-cycle engine is off
+  int result = 0;
+  t_disk_decode() = default;
+  t_disk_decode(const t_disk_decode&) = delete;
+  t_disk_decode& operator=(const t_disk_decode&) = delete;
+  ~t_disk_decode();  // frees the tracks of a decode never installed
+};
+// Any thread: decodes `path` into `out` the way file_load would; returns (and
+// stores in out.result) 0 or an ERR_* code.
+int disk_decode(const std::string& path, t_disk_decode& out,
+                const flux::Progress& progress = {});
+// UI thread: installs a successful decode in `slot`'s drive with the Z80
+// paused, taking ownership of its tracks. A failed decode leaves the drive
+// as it was. Returns the decode's result.
+int disk_install(t_slot& slot, t_disk_decode& decoded);
 
 /* SNA <-> the sub-cycle machine (Wave 1); the plain snapshot_load/save route
  * here automatically when the engine is active. Exposed for tests. */
@@ -0,0 +1,85 @@
+/* audio_worker.cpp — the sound timeline ring and its render thread (see
+ * audio_worker.h). */
+
+#include "audio_worker.h"
+
+#include <chrono>
+
+namespace subcycle {
+
+AudioWorker::AudioWorker(const Sink& sink) : sink_(sink) {
+  thread_ = std::thread([this] { run(); });
+}
+
+AudioWorker::~AudioWorker() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    stop_ = true;
+  }
+  work_cv_.notify_one();
+  thread_.join();
+}
+
+void AudioWorker::wake() {
+  // Dekker pair with run(): the worker raises sleeping_ before it re-checks
+  // the ring, the producer publishes head_ before it reads sleeping_ — one
+  // of the two always sees the other (both seq_cst).
+  if (sleeping_.load()) {
+    std::lock_guard<std::mutex> lk(mu_);
+    work_cv_.notify_one();
+  }
+}
+
+void AudioWorker::push(const SoundEvent& ev) {
+  const size_t head = head_.load(std::memory_order_relaxed);
+  while (head - tail_.load(std::memory_order_acquire) >= kCapacity) {
+    wake();  // full: the worker must be draining, then wait for room
+    std::this_thread::yield();
+  }
+  ring_[head & (kCapacity - 1)] = ev;
+  head_.store(head + 1);
+}
+
+void AudioWorker::publish(uint64_t steps, uint64_t accs) {
+  push(SoundEvent{steps, accs, 0, SoundEvent::kMark});
+  wake();
+}
+
+void AudioWorker::finish(uint64_t steps, uint64_t accs) {
+  push(SoundEvent{steps, accs, 0, SoundEvent::kMark});
+  std::unique_lock<std::mutex> lk(mu_);
+  work_cv_.notify_one();
+  done_cv_.wait(lk, [this] {
+    return tail_.load(std::memory_order_acquire) ==
+           head_.load(std::memory_order_relaxed);
+  });
+}
+
+void AudioWorker::run() {
+  std::unique_lock<std::mutex> lk(mu_);
+  for (;;) {
+    sleeping_.store(true);
+    // The timeout is a backstop only; every publish wakes the worker.
+    work_cv_.wait_for(lk, std::chrono::milliseconds(5), [this] {
+      return stop_ || tail_.load(std::memory_order_relaxed) != head_.load();
+    });
+    sleeping_.store(false);
+    if (stop_) return;
+    lk.unlock();
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    for (size_t head = head_.load(); tail != head; head = head_.load()) {
+      for (; tail != head; ++tail) {
+        const SoundEvent& ev = ring_[tail & (kCapacity - 1)];
+        if (ev.reg == SoundEvent::kMark)
+          sink_.advance(sink_.ctx, ev.steps, ev.accs);
+        else
+          sink_.apply(sink_.ctx, ev);
+        tail_.store(tail + 1, std::memory_order_release);  // room to push
+      }
+    }
+    lk.lock();
+    done_cv_.notify_all();
+  }
+}
+
+}  // namespace subcycle
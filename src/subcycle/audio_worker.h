@@ -0,0 +1,86 @@
+/* audio_worker.h — the sound timeline and the thread that renders it.
+ *
+ * WHY: on the per-cycle tiers the PSG's tone/noise/envelope counters and the
+ * band-limited mixer ran inside the master-cycle loop, a 1 MHz cost on the
+ * emulation thread for output nothing else reads. With the worker on, the
+ * emulation thread only LOGS what moves the sound — AY register writes and
+ * DAC level changes — and this thread replays the log into a replica PSG and
+ * the machine's mixer while the frame is still being emulated.
+ *
+ * MODEL: two clocks tag every event — `steps` (1 MHz PSG sound steps done so
+ * far) and `accs` (the per-µs accumulate index, psg-device.md §levels; only
+ * DAC changes and progress marks carry one). The replayer reaches exactly
+ * that (steps, accs) point, then applies the event, so its output is the
+ * in-thread output bit for bit (AudioWorker oracle, audio_worker_test).
+ *
+ * THREADING: one producer (the emulation thread) and one consumer (the
+ * worker), handing over through a lock-free ring. Progress marks ride the
+ * same ring, so the worker always sees a consistent (steps, accs) pair.
+ * finish() is the barrier: after it the sink's state is the producer's
+ * again, and an empty ring leaves the worker touching nothing. */
+#ifndef KONCPC_SUBCYCLE_AUDIO_WORKER_H
+#define KONCPC_SUBCYCLE_AUDIO_WORKER_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace subcycle {
+
+struct SoundEvent {
+  static constexpr uint8_t kDac = 0xFE;   // reg: a DAC level change
+  static constexpr uint8_t kMark = 0xFF;  // reg: progress only (worker-side)
+  uint64_t steps;  // PSG steps done when it happened
+  uint64_t accs;   // accumulates done when it happened
+  int32_t value;   // register value, or the DACs' summed left-channel level
+  uint8_t reg;     // AY register 0..15, or kDac
+};
+
+class AudioWorker {
+ public:
+  struct Sink {
+    void* ctx;
+    // Reach (ev.steps, ev.accs), then apply the event.
+    void (*apply)(void* ctx, const SoundEvent& ev);
+    // Reach (steps, accs).
+    void (*advance)(void* ctx, uint64_t steps, uint64_t accs);
+  };
+
+  explicit AudioWorker(const Sink& sink);
+  ~AudioWorker();
+  AudioWorker(const AudioWorker&) = delete;
+  AudioWorker& operator=(const AudioWorker&) = delete;
+
+  // Producer side. push() logs an event, waiting for room when the ring is
+  // full; publish() hands over progress so the worker can render ahead;
+  // finish() publishes the end point and returns once it is rendered.
+  void push(const SoundEvent& ev);
+  void publish(uint64_t steps, uint64_t accs);
+  void finish(uint64_t steps, uint64_t accs);
+
+ private:
+  static constexpr size_t kCapacity = 4096;  // events; a power of two
+
+  void run();
+  void wake();
+
+  Sink sink_;
+  std::array<SoundEvent, kCapacity> ring_{};
+  alignas(64) std::atomic<size_t> head_{0};  // next slot to write (producer)
+  alignas(64) std::atomic<size_t> tail_{0};  // next slot to read (worker)
+  alignas(64) std::atomic<bool> sleeping_{false};  // worker is (about to be)
+                                                   // waiting on work_cv_
+  std::mutex mu_;
+  std::condition_variable work_cv_;  // producer → worker: ring has work
+  std::condition_variable done_cv_;  // worker → producer: ring drained
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+}  // namespace subcycle
+
+#endif /* KONCPC_SUBCYCLE_AUDIO_WORKER_H */
@@ -0,0 +1,77 @@
+/* flux_predecode.cpp — the background flux decode pool (see
+ * flux_predecode.h). */
+
+#include "flux_predecode.h"
+
+#include <algorithm>
+
+namespace subcycle {
+
+FluxPredecoder::FluxPredecoder(const uint8_t* scp, size_t len,
+                               unsigned threads)
+    : scp_(scp), len_(len) {
+  cyls_ = std::max(flux_scp_cylinders(scp, len), 0);
+  heads_ = std::max(flux_scp_heads(scp, len), 0);
+  revs_ = std::max(flux_scp_revolutions(scp, len), 0);
+  if (cyls_ == 0 || revs_ == 0) {
+    cyls_ = 0;
+    return;
+  }
+  cyl_.reset(new Cylinder[static_cast<size_t>(cyls_)]);
+  if (threads == 0) {
+    const unsigned hw = std::thread::hardware_concurrency();
+    threads = hw > 1 ? hw - 1 : 1;  // leave the emulation thread its core
+  }
+  threads = std::min({threads, kMaxThreads, static_cast<unsigned>(cyls_)});
+  for (unsigned i = 0; i < threads; ++i) pool_.emplace_back([this] { run(); });
+}
+
+FluxPredecoder::~FluxPredecoder() {
+  stop_.store(true, std::memory_order_relaxed);
+  wait();
+}
+
+void FluxPredecoder::wait() {
+  for (std::thread& t : pool_)
+    if (t.joinable()) t.join();
+}
+
+// Workers claim cylinders in order from 0 outwards — where a boot reads
+// first — and publish each one whole.
+void FluxPredecoder::run() {
+  for (;;) {
+    if (stop_.load(std::memory_order_relaxed)) return;
+    const int c = next_.fetch_add(1, std::memory_order_relaxed);
+    if (c >= cyls_) return;
+    Cylinder& cy = cyl_[c];
+    const size_t tracks = static_cast<size_t>(heads_) * revs_;
+    cy.rev.assign(tracks, FluxTrack{});
+    cy.payload.assign(tracks * kPayloadCap, 0);
+    for (size_t i = 0; i < tracks; ++i) {
+      FluxTrack& ft = cy.rev[i];
+      if (flux_decode_track(scp_, len_, static_cast<uint8_t>(c),
+                            static_cast<uint8_t>(i / revs_),
+                            static_cast<uint8_t>(i % revs_), &ft,
+                            &cy.payload[i * kPayloadCap], kPayloadCap) != 0)
+        ft = FluxTrack{};  // unreadable: an unformatted revolution
+    }
+    cy.ready.store(true, std::memory_order_release);
+    done_.fetch_add(1, std::memory_order_acq_rel);
+  }
+}
+
+int FluxPredecoder::lookup(void* ctx, uint8_t cyl, uint8_t head, uint8_t rev,
+                           const FluxTrack** track, const uint8_t** payload) {
+  const FluxPredecoder* self = static_cast<const FluxPredecoder*>(ctx);
+  if (cyl >= self->cyls_ || head >= self->heads_) return 0;
+  const Cylinder& cy = self->cyl_[cyl];
+  if (!cy.ready.load(std::memory_order_acquire)) return 0;
+  // The captures repeat, as in the decoder.
+  const size_t i =
+      (static_cast<size_t>(head) * self->revs_) + (rev % self->revs_);
+  *track = &cy.rev[i];
+  *payload = &cy.payload[i * kPayloadCap];
+  return 1;
+}
+
+}  // namespace subcycle
@@ -0,0 +1,77 @@
+/* flux_predecode.h — decode a whole flux disc in the background at insert.
+ *
+ * WHY: the FDC decodes the track under the head (PLL + MFM scan) lazily,
+ * on the emulation thread, the moment a seek lands. Protected titles that
+ * step constantly stalled a frame on every step. FluxPredecoder decodes every
+ * captured revolution of every side of every cylinder on a small worker pool
+ * into an immutable per-track table and serves it to the FDC through
+ * fdc_set_flux_source; a track the pool has not reached yet still decodes
+ * lazily into the FDC's track cache (fdc.cpp flux_fill), so the disc is
+ * usable from the first cycle and nothing waits on the pool.
+ *
+ * The table holds exactly what flux_decode_track returns, so the FDC
+ * serves the same bytes at the same angles either way (FluxPredecode test). */
+#ifndef KONCPC_SUBCYCLE_FLUX_PREDECODE_H
+#define KONCPC_SUBCYCLE_FLUX_PREDECODE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "hw/flux.h"
+
+namespace subcycle {
+
+class FluxPredecoder {
+ public:
+  // Start decoding `scp` (caller-owned; must outlive this object) on
+  // `threads` workers (0 = one per spare core, at most kMaxThreads).
+  FluxPredecoder(const uint8_t* scp, size_t len, unsigned threads = 0);
+  // Stops the pool between tracks and joins it.
+  ~FluxPredecoder();
+  FluxPredecoder(const FluxPredecoder&) = delete;
+  FluxPredecoder& operator=(const FluxPredecoder&) = delete;
+
+  // FdcFluxSourceFn: `ctx` is the FluxPredecoder.
+  static int lookup(void* ctx, uint8_t cyl, uint8_t head, uint8_t rev,
+                    const FluxTrack** track, const uint8_t** payload);
+
+  int cylinders() const { return cyls_; }
+  int heads() const { return heads_; }
+  int revolutions() const { return revs_; }
+  // Cylinders fully decoded so far; done() once all of them are.
+  int ready() const { return done_.load(std::memory_order_acquire); }
+  bool done() const { return ready() == cyls_; }
+  // Block until the pool has finished (tests, tools).
+  void wait();
+
+ private:
+  static constexpr unsigned kMaxThreads = 4;
+  static constexpr size_t kPayloadCap = 8192;  // fdc.cpp kFluxPayload
+
+  struct Cylinder {
+    std::atomic<bool> ready{false};   // published last, with release
+    std::vector<FluxTrack> rev;       // heads × revs, head-major
+    std::vector<uint8_t> payload;     // heads × revs × kPayloadCap
+  };
+
+  void run();
+
+  const uint8_t* scp_;
+  size_t len_;
+  int cyls_ = 0;
+  int heads_ = 0;
+  int revs_ = 0;
+  std::unique_ptr<Cylinder[]> cyl_;
+  std::atomic<int> next_{0};   // next cylinder to claim
+  std::atomic<int> done_{0};   // cylinders published
+  std::atomic<bool> stop_{false};
+  std::vector<std::thread> pool_;
+};
+
+}  // namespace subcycle
+
+#endif /* KONCPC_SUBCYCLE_FLUX_PREDECODE_H */
@@ -5,6 +5,7 @@
 #include "machine.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 
@@ -97,6 +98,7 @@ bool Machine::build(const uint8_t* rom, size_t rom_len) {
   ga_attach_asic(&gdev_, &adev_);    // Plus PRI deference (no-op on models 0-2)
   mem_attach_asic(&mdev_,
                   &adev_);  // Plus RMR2 low-ROM remap gate (no-op sans cart)
+  psg_set_level_sink(&sdev_, &Machine::au_psg_level, this);  // the mixer
 
   mem_load_lower_rom(&mdev_, rom, 0x4000);           // OS at 0x0000
   mem_load_upper_rom(&mdev_, rom + 0x4000, 0x4000);  // BASIC at 0xC000
@@ -104,6 +106,9 @@ bool Machine::build(const uint8_t* rom, size_t rom_len) {
   // size; the default is the 64K that makes a 6128.
   xmem_.assign(want_expansion_, 0);
   mem_attach_expansion(&mdev_, xmem_.data(), xmem_.size());
+  // A rebuilt FDC starts on its built-in flux cache: hand the budget back.
+  if (!flux_cache_.empty())
+    fdc_set_flux_cache(&fdev_, flux_cache_.data(), flux_cache_.size());
   built_ = true;
   recompose_active();  // establish dormancy + wake-tier validity at
                        // construction (refreshed every frame; this makes
@@ -121,6 +126,15 @@ void Machine::attach_framebuffer(uint8_t* fb, int w, int h) {
   video_attach_asic(&vdev_, &adev_);
 }
 
+void Machine::set_hash_only(bool on) {
+  video_set_hash_only(&vdev_, on ? 1 : 0);
+}
+bool Machine::hash_only() const { return video_hash_only(&vdev_) != 0; }
+uint32_t Machine::frame_hash() const { return video_frame_hash(&vdev_); }
+void Machine::set_skip_paint(bool on) {
+  video_set_skip_paint(&vdev_, on ? 1 : 0);
+}
+
 void Machine::attach_amsdos(const uint8_t* rom16k, size_t len) {
   if (rom16k != nullptr && len >= 0x4000) mem_attach_rom(&mdev_, 7, rom16k);
 }
@@ -139,46 +153,106 @@ void Machine::attach_cartridge(const uint8_t* image, size_t bytes) {
 // NOLINTNEXTLINE(readability-non-const-parameter): pointer written through a
 // cast or passed to a non-const callee
 bool Machine::insert_disk(uint8_t* dsk, size_t len, uint8_t unit) {
+  stop_flux_predecode(unit);
   return fdc_attach_disk(&fdev_, dsk, len, unit) == 0;
 }
 
 bool Machine::disk_dirty() const { return fdc_media_dirty(&fdev_) != 0; }
 void Machine::mark_disk_clean() { fdc_media_mark_clean(&fdev_); }
 
-bool Machine::insert_flux(const uint8_t* scp, size_t len) {
+bool Machine::insert_flux(const uint8_t* scp, size_t len, uint8_t unit) {
+  const uint8_t u = unit & 1;
+  stop_flux_predecode(u);
+  if (flux_cache_.empty()) wire_flux_cache();
+  if (!attach_flux(scp, len, u)) return false;
+  flux_pre_[u].reset(new FluxPredecoder(scp, len));
+  fdc_set_flux_source(&fdev_, &FluxPredecoder::lookup, flux_pre_[u].get(), u);
+  return true;
+}
+
+void Machine::stop_flux_predecode() {
+  stop_flux_predecode(0);
+  stop_flux_predecode(1);
+}
+
+void Machine::stop_flux_predecode(uint8_t unit) {
+  const uint8_t u = unit & 1;
+  fdc_set_flux_source(&fdev_, nullptr, nullptr, u);
+  flux_pre_[u].reset();
+}
+
+void Machine::set_flux_cache_budget(size_t bytes) {
+  flux_cache_budget_ = bytes;
+  if (!flux_cache_.empty()) wire_flux_cache();  // else: at the first insert
+}
+
+// (Re)allocate the FDC's flux cache at the budget. The FDC lets go of the old
+// buffer before it is freed; the cache starts empty either way.
+void Machine::wire_flux_cache() {
+  fdc_set_flux_cache(&fdev_, nullptr, 0);
+  flux_cache_.clear();
+  flux_cache_.shrink_to_fit();
+  if (flux_cache_budget_ < 2 * fdc_flux_slot_size()) return;  // built-in
+  flux_cache_.resize(flux_cache_budget_);
+  fdc_set_flux_cache(&fdev_, flux_cache_.data(), flux_cache_.size());
+}
+
+bool Machine::attach_flux(const uint8_t* scp, size_t len, uint8_t unit) {
   // Synthesize a writable DSK overlay from the flux so a flux-backed disc can
   // be written (Stage 2): clean tracks still serve the rotating flux cache,
   // written tracks serve this overlay. A generous cap covers a full 102-track
-  // DD disc
-  // (~256 + ~8192 bytes/track); flux_scp_to_dsk shrinks it to the real size.
-  constexpr size_t kOverlayCap = 0x100 + (102 * (0x100 + 8192));
-  flux_dsk_.assign(kOverlayCap, 0);
+  // double-sided DD disc (~256 + ~8192 bytes/track); flux_scp_to_dsk shrinks
+  // it to the real size.
+  constexpr size_t kOverlayCap = 0x100 + (2 * 102 * (0x100 + 8192));
+  std::vector<uint8_t>& dsk = flux_dsk_[unit];
+  dsk.assign(kOverlayCap, 0);
   const long dsk_len =
-      flux_scp_to_dsk(scp, len, flux_dsk_.data(), flux_dsk_.size(), nullptr);
+      flux_scp_to_dsk(scp, len, dsk.data(), dsk.size(), nullptr);
   if (dsk_len > 0) {
-    flux_dsk_.resize(static_cast<size_t>(dsk_len));
-    if (fdc_attach_flux_writable(&fdev_, scp, len, flux_dsk_.data(),
-                                 flux_dsk_.size()) == 0)
+    dsk.resize(static_cast<size_t>(dsk_len));
+    if (fdc_attach_flux_writable(&fdev_, scp, len, dsk.data(), dsk.size(),
+                                 unit) == 0)
       return true;
   }
   // Non-standard / un-synthesizable flux: keep the disc playable read-only
   // rather than failing the insert (weak-bit protection still reads).
-  flux_dsk_.clear();
-  return fdc_attach_flux(&fdev_, scp, len) == 0;
+  dsk.clear();
+  return fdc_attach_flux(&fdev_, scp, len, unit) == 0;
 }
 
-void Machine::eject_disk(uint8_t unit) { fdc_eject_disk(&fdev_, unit); }
+void Machine::eject_disk(uint8_t unit) {
+  stop_flux_predecode(unit);
+  fdc_eject_disk(&fdev_, unit);
+}
 
 bool Machine::insert_tape(const uint8_t* cdt, size_t len) {
-  return tape_attach_cdt(&tdev_, cdt, len) == 0;
+  TapeStream s{};
+  if (tape_compile_cdt(cdt, len, nullptr, 0, nullptr, 0, &s) == -1)
+    return false;
+  tape_cdt_.assign(cdt, cdt + len);
+  tape_runs_.assign(s.nruns, 0);
+  tape_blocks_.assign(s.nblocks, TapeBlock{});
+  tape_compile_cdt(cdt, len, tape_runs_.data(), s.nruns, tape_blocks_.data(),
+                   s.nblocks, &s);
+  tape_attach_stream(&tdev_, &s);
+  return true;
+}
+void Machine::eject_tape() {
+  tape_eject(&tdev_);
+  tape_cdt_ = {};
+  tape_runs_ = {};
+  tape_blocks_ = {};
+  flash_pending_ = false;
 }
-void Machine::eject_tape() { tape_eject(&tdev_); }
 void Machine::tape_play_button(bool on) { tape_play(&tdev_, on ? 1 : 0); }
 void Machine::tape_rewind_deck() { tape_rewind(&tdev_); }
 void Machine::tape_seek(uint32_t block_ordinal) {
   ::tape_seek(&tdev_,
               block_ordinal);  // ::-qualified: the free function, not this
 }
+void Machine::tape_seek_cycle(uint64_t cycle) {
+  ::tape_seek_cycle(&tdev_, cycle);
+}
 int Machine::tape_drain_bits(uint8_t* out, int max) {
   return ::tape_drain_bits(&tdev_, out, max);
 }
@@ -228,6 +302,7 @@ std::vector<uint8_t> Machine::save_devices() const {
 }
 
 void Machine::load_devices(const std::vector<uint8_t>& blob) {
+  frame_open_ = false;
   size_t at = 0;
   for (int i = 0; i < board_.count; ++i) {
     const Device& dev = board_.dev[i];
@@ -243,7 +318,11 @@ void Machine::load_devices(const std::vector<uint8_t>& blob) {
   std::memcpy(&board_.master_cycles, blob.data() + at + sizeof(Bus), 8);
 }
 
-void Machine::reset() { board_reset(&board_); }
+void Machine::reset() {
+  board_reset(&board_);
+  frame_open_ = false;
+  flash_pending_ = false;
+}
 
 void Machine::set_key_row(uint8_t row, uint8_t columns) {
   psg_set_key_row(&sdev_, row, columns);
@@ -276,15 +355,109 @@ int Machine::drain_fdc_events(FdcEvent* out, int max) {
   return fdc_drain_events(&fdev_, out, max);
 }
 
-int16_t Machine::emit_sample(long acc, double& dc_x, double& dc_y) const {
-  // Average the accumulated 1 MHz inputs, DC-block (the AY level is unipolar),
-  // scale, clamp.
-  const double raw =
-      static_cast<double>((au_n_ ? acc / au_n_ : 0) * kAudioGain);
-  dc_y = (raw - dc_x) + (0.9975 * dc_y);
-  dc_x = raw;
-  return static_cast<int16_t>(
-      std::clamp<long>(static_cast<long>(dc_y), -32768, 32767));
+namespace {
+
+// Band-limited step (BLEP) kernel: row p is the derivative of a step that
+// lands p/kBlepPhases of an output sample into its window — a Blackman-windowed
+// sinc with its cutoff just under Nyquist. Each row is rounded to sum to
+// exactly 1 << kBlepShift, so the integrated output settles on the level with
+// no drift.
+constexpr int kBlepShift = 15;
+constexpr double kBlepCutoff = 0.45;  // of the host rate
+
+struct BlepKernel {
+  int16_t row[kBlepPhases][kBlepTaps];
+  BlepKernel() {
+    const double pi = 3.14159265358979323846;
+    for (int p = 0; p < kBlepPhases; ++p) {
+      double h[kBlepTaps];
+      double sum = 0;
+      for (int j = 0; j < kBlepTaps; ++j) {
+        // Tap j sits at t samples from the step; centred on the kernel.
+        const double t = (j + 1 - (kBlepTaps / 2)) -
+                         (static_cast<double>(p) / kBlepPhases);
+        const double x = 2 * kBlepCutoff * t;
+        const double sinc = x == 0 ? 1.0 : std::sin(pi * x) / (pi * x);
+        const double w = (t + (kBlepTaps / 2)) / kBlepTaps;  // 0..1 window
+        const double win = 0.42 - (0.5 * std::cos(2 * pi * w)) +
+                           (0.08 * std::cos(4 * pi * w));
+        h[j] = sinc * (w <= 0 || w >= 1 ? 0 : win);
+        sum += h[j];
+      }
+      int total = 0;
+      int peak = 0;
+      for (int j = 0; j < kBlepTaps; ++j) {
+        row[p][j] = static_cast<int16_t>(
+            std::lround(h[j] / sum * (1 << kBlepShift)));
+        total += row[p][j];
+        if (row[p][j] > row[p][peak]) peak = j;
+      }
+      row[p][peak] =
+          static_cast<int16_t>(row[p][peak] + ((1 << kBlepShift) - total));
+    }
+  }
+};
+
+const BlepKernel& blep_kernel() {
+  static const BlepKernel k;
+  return k;
+}
+
+// DC-block pole (0.9975) in Q16.
+constexpr int64_t kDcPole = 65372;
+
+}  // namespace
+
+void Machine::blep_step(long dL, long dR) {
+  const int phase = static_cast<int>((au_phase_ * kBlepPhases) / kPsgHz);
+  const int16_t* k = blep_kernel().row[phase];
+  int32_t* l = &blepL_[au_pending_];
+  int32_t* r = &blepR_[au_pending_];
+  for (int j = 0; j < kBlepTaps; ++j) {
+    l[j] += static_cast<int32_t>(dL * k[j]);
+    r[j] += static_cast<int32_t>(dR * k[j]);
+  }
+}
+
+// Integrate the pending samples' steps, DC-block (the AY level is unipolar),
+// scale, clamp, and append them to audio_. The kernel tails that reach past
+// the last rendered sample slide to the front for the next render.
+void Machine::render_audio() {
+  if (overlay_ != nullptr) {
+    // Forward the FDC's mechanical events to the host drive-sound layer. The
+    // cosmetic audio itself is NOT summed here — it renders on its own SDL
+    // stream (drive_sounds_fill_stereo) and mixes at the device, so the
+    // emulated AY sample stays pure (and deterministic).
+    FdcEvent ev[16];
+    int n;
+    while ((n = fdc_drain_events(&fdev_, ev, 16)) > 0) overlay_->events(ev, n);
+  }
+  au_fold();
+  if (au_pending_ == 0) return;
+  audio_.reserve(audio_.size() + (2 * au_pending_));
+  auto dc_block = [](int64_t x, int64_t& xp, int64_t& y) {
+    y = (x - xp) + ((y * kDcPole) >> 16);
+    xp = x;
+    return static_cast<int16_t>(
+        std::clamp<int64_t>(y >> kBlepShift, -32768, 32767));
+  };
+  for (size_t i = 0; i < au_pending_; ++i) {
+    au_intL_ += blepL_[i];
+    au_intR_ += blepR_[i];
+    audio_.push_back(dc_block(au_intL_ * kAudioGain, dcL_x_, dcL_y_));
+    audio_.push_back(dc_block(au_intR_ * kAudioGain, dcR_x_, dcR_y_));
+  }
+  std::copy(blepL_.begin() + static_cast<long>(au_pending_),
+            blepL_.begin() + static_cast<long>(au_pending_ + kBlepTaps),
+            blepL_.begin());
+  std::copy(blepR_.begin() + static_cast<long>(au_pending_),
+            blepR_.begin() + static_cast<long>(au_pending_ + kBlepTaps),
+            blepR_.begin());
+  std::fill(blepL_.begin() + kBlepTaps,
+            blepL_.begin() + static_cast<long>(au_pending_ + kBlepTaps), 0);
+  std::fill(blepR_.begin() + kBlepTaps,
+            blepR_.begin() + static_cast<long>(au_pending_ + kBlepTaps), 0);
+  au_pending_ = 0;
 }
 
 // Live cassette wires for the host-side scope + drive-sound overlay
@@ -292,6 +465,14 @@ int16_t Machine::emit_sample(long acc, double& dc_x, double& dc_y) const {
 bool Machine::tape_motor() const { return board_.bus.tape.motor; }
 bool Machine::tape_read_level() const { return board_.bus.tape.rdata; }
 
+// Re-apply the motor-on cycles the wake tier let the deck sleep through, so
+// its cursor is exactly where per-cycle ticks would have left it.
+void Machine::settle_tape() {
+  if (wk_tape_skip_ == 0) return;
+  tape_advance(&tdev_, wk_tape_skip_);
+  wk_tape_skip_ = 0;
+}
+
 // Tape OUTPUT capture: sample the cassette wires (data + motor) at the audio
 // rate while armed (machine.h tape_out_capture).
 void Machine::capture_tape_output() {
@@ -339,65 +520,321 @@ void Machine::service_taps(const Bus& committed) {
     }
 }
 
-// One PSG output sample: accumulate the channels, mix the analog-domain DACs
-// (Digiblaster/AmDrum) into the left, and at the host rate emit one stereo pair
-// with the drive-sound overlay panned right.
-void Machine::accumulate_audio() { accumulate_audio_bulk(1); }
+// The tape flash loader (tape-device.md §8). CAS READ is trapped where the
+// firmware jumpblock says it lives (&BCA1 is RST 1 + its lower-ROM address
+// on every model), and only while the lower ROM is paged in — a game's own
+// code at that address in RAM is never mistaken for it. Armed per run, and
+// only with PLAY down: an idle deck costs nothing.
+void Machine::arm_tape_flash() {
+  flash_addr_ = 0;
+  if (!tape_flash_ || tape_cdt_.empty()) return;
+  TapeRegs deck{};
+  tape_peek(&tdev_, &deck);
+  if (deck.playing == 0 || deck.line_mode != 0) return;
+  if (mem_peek_cpu(&mdev_, 0xBCA1) != 0xCF) return;  // not the firmware's
+  flash_addr_ = static_cast<uint16_t>((mem_peek_cpu(&mdev_, 0xBCA2) |
+                                       (mem_peek_cpu(&mdev_, 0xBCA3) << 8)) &
+                                      0x3FFF);
+}
+
+// The fetch edge is mid-instruction, so entry only latches the caller's
+// registers (A = sync byte, HL = destination, DE = length, SP -> the return
+// address); finish_tape_flash acts at the next clean boundary.
+void Machine::service_tape_flash(const Bus& committed) {
+  const bool fetch = committed.cpu.m1 && committed.cpu.mreq && committed.cpu.rd;
+  const bool edge = fetch && !flash_prev_fetch_;
+  flash_prev_fetch_ = fetch;
+  if (flash_pending_) {
+    if (z80_batch_ready(&zdev_) != 0) finish_tape_flash();
+    return;
+  }
+  if (!edge || committed.cpu.addr != flash_addr_) return;
+  MemRegs mr{};
+  mem_peek(&mdev_, &mr);
+  if ((mr.rom_config & 0x04) != 0) return;  // lower ROM paged out: RAM code
+  z80_peek(&zdev_, &flash_entry_);
+  flash_pending_ = true;
+}
+
+// CAS READ's first instruction has retired (it may have pushed below the
+// caller's SP; an interrupt taken on the way in pushes further, and then
+// this waits for the handler to return). Find the record the ROM would sync
+// on next — past pauses and metadata — and if it is a standard firmware
+// record the pulses are not already into, load it and return from CAS READ
+// the way the ROM does on success: carry set (AF = &0045), IX one past the
+// last byte, the motor relay and interrupts as they were. Otherwise the ROM
+// carries on and reads the pulses.
+void Machine::finish_tape_flash() {
+  Z80Regs r{};
+  z80_peek(&zdev_, &r);
+  if (r.instr_count == flash_entry_.instr_count ||
+      static_cast<uint16_t>(flash_entry_.sp - r.sp) > 2)
+    return;  // still pending
+  flash_pending_ = false;
+  const Z80Regs& e = flash_entry_;
+  settle_tape();  // the deck may be asleep mid-run (wake tier)
+  TapeRegs deck{};
+  tape_peek(&tdev_, &deck);
+  if (deck.attached == 0 || deck.playing == 0 || deck.error != 0) return;
+  const auto nblocks = static_cast<uint32_t>(tape_blocks_.size());
+  const auto len = static_cast<uint32_t>(tape_cdt_.size());
+  uint32_t b = deck.block;
+  for (; b < nblocks; ++b) {
+    const uint32_t pos = tape_blocks_[b].pos;
+    const uint8_t id = pos < len ? tape_cdt_[pos] : 0;
+    const bool gap = (id == 0x20 && pos + 2 < len &&
+                      (tape_cdt_[pos + 1] | tape_cdt_[pos + 2]) != 0) ||
+                     id == 0x21 || id == 0x22 || (id >= 0x30 && id <= 0x33);
+    if (!gap) break;
+  }
+  if (b >= nblocks) return;
+  std::vector<uint8_t> rec(e.de);
+  uint64_t lead = 0;
+  if (tape_firmware_record(tape_cdt_.data(), len, tape_blocks_[b].pos,
+                           static_cast<uint8_t>(e.af >> 8), rec.data(), e.de,
+                           &lead) != 0)
+    return;
+  if (b == deck.block && deck.cycle - tape_blocks_[b].start > lead / 2)
+    return;  // half the leader gone: the ROM may already be synced to it
+  for (size_t i = 0; i < rec.size(); ++i)
+    mem_poke_cpu(&mdev_, static_cast<uint16_t>(e.hl + i), rec[i]);
+  r.pc = static_cast<uint16_t>(mem_peek_cpu(&mdev_, e.sp) |
+                               (mem_peek_cpu(&mdev_, e.sp + 1) << 8));
+  r.sp = static_cast<uint16_t>(e.sp + 2);
+  r.af = 0x0045;
+  r.ix = static_cast<uint16_t>(e.hl + e.de);
+  z80_redirect(&zdev_, &r);
+  if (b + 1 < nblocks) {
+    ::tape_seek(&tdev_, b + 1);
+  } else {
+    ::tape_seek_cycle(&tdev_, deck.total);
+  }
+  wk_force_ = true;  // host-side mutation: see set_key_row
+}
+
+// The mixer is event-driven (psg-device.md §levels): the PSG reports each
+// change of its channel levels, a plugged DAC is polled once per µs, and
+// nothing runs on a step where neither moved. The clock is the per-µs
+// accumulate index — the clk.psg commits a per-cycle run samples the levels
+// at — counted rather than run: PSG sound steps, plus a commit whose step is
+// still pending, plus au_skew_ (re-synced at each run start, so steps taken
+// outside a run — debugger single-steps — add no audio, as before).
+uint64_t Machine::au_at(uint64_t steps) const {
+  return steps + static_cast<uint64_t>(au_skew_);
+}
+
+uint64_t Machine::au_now() const {
+  return au_at(psg_sound_steps(&sdev_) + (board_.bus.clk.psg ? 1 : 0));
+}
+
+// Clock the current levels up to accumulate index acc: the held run grows,
+// and only a level change (au_mix) costs a kernel add.
+void Machine::au_to(uint64_t acc) {
+  if (acc <= au_mark_) return;
+  au_mix(au_psgL_ + au_dac_, au_psgR_, acc - au_mark_);
+  au_mark_ = acc;
+}
+
+void Machine::au_set_levels(const uint8_t lv[3]) {
+  // Channel A + B -> left, C + B -> right.
+  au_psgL_ = lv[0] + lv[1];
+  au_psgR_ = lv[2] + lv[1];
+}
+
+// The board PSG's level sink. Step s's new levels are first sampled by the
+// accumulate after it: index s + 1 (+ skew), since accumulate j precedes
+// step j.
+void Machine::au_psg_level(void* ctx, uint64_t step, const uint8_t lv[3]) {
+  Machine* m = static_cast<Machine*>(ctx);
+  if (!m->au_live_) return;  // outside a run: no audio, as per-step never ran
+  m->au_to(m->au_at(step + 1));
+  m->au_set_levels(lv);
+}
 
-// k steps' worth of level-stable accumulation — the k=1 case IS the original
-// per-step accumulate (integer sums of a constant commute), and every
-// host-rate boundary inside the window emits at its exact step.
-void Machine::accumulate_audio_bulk(uint32_t k) {
+// Run start: line the accumulate clock up with the mark the last run ended
+// on, and take the levels as they stand.
+void Machine::au_begin() {
+  au_skew_ = static_cast<int64_t>(au_mark_ - psg_sound_steps(&sdev_) -
+                                  (board_.bus.clk.psg ? 1 : 0));
   uint8_t lv[3];
   psg_levels(&sdev_, lv);
-  long addL = lv[0] + lv[1];        // channel A + B -> left
-  long const addR = lv[2] + lv[1];  // channel C + B -> right
-  // Analog-domain DACs (printer-device.md §3, amdrum-device.md §2): a DAC
-  // swings like one PSG channel, mixed LEFT per the golden master. Their
-  // latches are constant across a bulk window: any write drains audio first
-  // (catch-up-then-apply).
+  au_set_levels(lv);
+  au_dac_on_ = digiblaster_ || amdrum_on_;
+  au_dac_ = dac_level();
+  au_live_ = true;
+}
+
+void Machine::au_end() {
+  au_to(au_now());
+  au_live_ = false;
+}
+
+// A clk.psg commit with a DAC plugged: its accumulate is index S (+ skew) —
+// S steps are done, and this commit's own step is the next one. A change is
+// clocked there, or logged for the worker.
+void Machine::au_dac_poll() {
+  const long dac = dac_level();
+  const uint64_t at = au_at(psg_sound_steps(&sdev_));
+  if (aw_on_) {
+    if (dac == aw_dac_logged_) return;
+    aw_dac_logged_ = dac;
+    aw_->push(SoundEvent{psg_detached_steps(&sdev_), at,
+                         static_cast<int32_t>(dac), SoundEvent::kDac});
+    return;
+  }
+  if (dac == au_dac_) return;
+  au_to(at);
+  au_dac_ = dac;
+}
+
+// Analog-domain DACs (printer-device.md §3, amdrum-device.md §2): a DAC swings
+// like one PSG channel, mixed LEFT per the golden master. Only the per-cycle
+// tiers poll them (au_dac_poll); the Fast tier never runs with one plugged.
+long Machine::dac_level() const {
+  long level = 0;
   if (digiblaster_) {
     PrinterRegs pr;
     printer_peek(&prtdev_, &pr);
-    addL += (static_cast<int>(pr.latch) - 128) * 31 / 128;
+    level += (static_cast<int>(pr.latch) - 128) * 31 / 128;
   }
   // amdrum_on_ is refreshed each frame (plug state changes only between frames
   // via the host) — skips a 1 MHz-rate peek on the common unplugged machine.
   if (amdrum_on_) {
     AmdrumRegs ar;
     amdrum_peek(&addev_, &ar);
-    addL += (static_cast<int>(ar.dac) - 128) * 31 / 128;
-  }
-  while (k > 0) {
-    // Steps until au_phase_ crosses the host-rate boundary (≥ 1 by the
-    // au_phase_ < kPsgHz loop invariant).
-    const long to_boundary = ((kPsgHz - au_phase_) + kAudioHz - 1) / kAudioHz;
-    const uint32_t c = k < static_cast<uint32_t>(to_boundary)
-                           ? k
-                           : static_cast<uint32_t>(to_boundary);
-    au_accL_ += addL * c;
-    au_accR_ += addR * c;
-    au_n_ += static_cast<int>(c);
-    au_phase_ += kAudioHz * static_cast<long>(c);
-    k -= c;
-    if (au_phase_ < kPsgHz) continue;  // not yet a host-rate sample boundary
-    au_phase_ -= kPsgHz;
-    int32_t const left = emit_sample(au_accL_, dcL_x_, dcL_y_);
-    int32_t const right = emit_sample(au_accR_, dcR_x_, dcR_y_);
-    if (overlay_ != nullptr) {
-      // Forward the FDC's mechanical events to the host drive-sound layer. The
-      // cosmetic audio itself is NOT summed here — it renders on its own SDL
-      // stream (drive_sounds_fill_stereo) and mixes at the device, so the
-      // emulated AY sample stays pure (and deterministic).
-      FdcEvent ev[16];
-      int n;
-      while ((n = fdc_drain_events(&fdev_, ev, 16)) > 0)
-        overlay_->events(ev, n);
+    level += (static_cast<int>(ar.dac) - 128) * 31 / 128;
+  }
+  return level;
+}
+
+// k accumulates at a stable level. Only a level CHANGE costs work (one kernel
+// add per channel); a steady stretch joins the held run, and the host-rate
+// clock advances once for the whole run. The sample count is exactly the
+// per-step box filter's (same au_phase_ boundaries), so every tier still
+// yields identical audio.
+void Machine::au_mix(long left, long right, uint32_t k) {
+  if (left != au_lastL_ || right != au_lastR_) {
+    au_fold();  // the step lands where the held run ends
+    blep_step(left - au_lastL_, right - au_lastR_);
+    au_lastL_ = left;
+    au_lastR_ = right;
+  }
+  au_held_ += k;
+}
+
+// Advance the host-rate clock over the held run. One division for the run
+// gives the same boundaries as one per step: floor((p + a*k) / N) is the sum
+// of the per-step quotients.
+void Machine::au_fold() {
+  if (au_held_ == 0) return;
+  const int64_t phase =
+      au_phase_ + (int64_t{kAudioHz} * static_cast<int64_t>(au_held_));
+  au_held_ = 0;
+  au_pending_ += static_cast<size_t>(phase / kPsgHz);
+  au_phase_ = static_cast<long>(phase % kPsgHz);
+  // Room for the next step's kernel past the pending samples. The initial
+  // slots already cover a capped two-frame run_frame; this only guards a
+  // longer stretch between renders.
+  while (au_pending_ + kBlepTaps > blepL_.size()) {
+    const size_t n = 2 * blepL_.size();
+    blepL_.resize(n, 0);
+    blepR_.resize(n, 0);
+  }
+}
+
+// --- Audio worker (audio_worker.h) ---
+
+void Machine::set_audio_worker(bool on) {
+  if (on == (aw_ != nullptr)) return;
+  if (!on) {
+    aw_.reset();
+    return;
+  }
+  if (aw_psg_mem_.empty()) {
+    aw_psg_mem_.assign(psg_state_size(), 0);
+    aw_psg_ = psg_init(aw_psg_mem_.data());
+    psg_set_level_sink(&aw_psg_, &Machine::aw_psg_level, this);
+  }
+  aw_ = std::make_unique<AudioWorker>(
+      AudioWorker::Sink{this, &Machine::aw_apply, &Machine::aw_advance});
+}
+
+// A run's timeline session: the replica takes over from the board PSG's
+// generator, and the board PSG goes to counting steps and reporting writes.
+// The replica's level events land on the same accumulate clock, offset by
+// where the two step counters stood at the handover.
+void Machine::aw_open() {
+  psg_copy_sound(&aw_psg_, &sdev_);
+  aw_steps_ = 0;
+  aw_mixed_ = false;
+  aw_sbase_ = psg_sound_steps(&sdev_);
+  aw_rbase_ = psg_sound_steps(&aw_psg_);
+  aw_dac_logged_ = au_dac_;
+  psg_detach_sound(&sdev_, &Machine::aw_psg_write, this);
+  aw_on_ = true;
+}
+
+// The barrier: once the worker has reached the run's end point the mixer is
+// ours again, and the board PSG gets the generator state back (snapshots,
+// state hashes and peeks see exactly the in-thread machine).
+void Machine::aw_close() {
+  aw_->finish(psg_detached_steps(&sdev_), au_now());
+  psg_detach_sound(&sdev_, nullptr, nullptr);
+  psg_copy_sound(&sdev_, &aw_psg_);
+  aw_on_ = false;
+}
+
+void Machine::aw_psg_write(void* ctx, uint64_t step, uint8_t reg,
+                           uint8_t val) {
+  Machine* m = static_cast<Machine*>(ctx);
+  m->aw_->push(SoundEvent{step, 0, val, reg});
+}
+
+// The replica's level sink (worker thread): replica step r is board step
+// aw_sbase_ + (r - aw_rbase_).
+void Machine::aw_psg_level(void* ctx, uint64_t step, const uint8_t lv[3]) {
+  Machine* m = static_cast<Machine*>(ctx);
+  m->au_to(m->au_at(m->aw_sbase_ + (step - m->aw_rbase_) + 1));
+  m->au_set_levels(lv);
+}
+
+void Machine::aw_apply(void* ctx, const SoundEvent& ev) {
+  Machine* m = static_cast<Machine*>(ctx);
+  m->aw_replay_to(ev.steps);
+  if (ev.reg == SoundEvent::kDac) {
+    m->au_to(ev.accs);
+    m->au_dac_ = ev.value;
+  } else {
+    psg_write(&m->aw_psg_, ev.reg, static_cast<uint8_t>(ev.value));
+    m->aw_mixed_ = false;  // the levels wait for the next real step
+  }
+}
+
+void Machine::aw_advance(void* ctx, uint64_t steps, uint64_t accs) {
+  Machine* m = static_cast<Machine*>(ctx);
+  m->aw_replay_to(steps);
+  m->au_to(accs);
+}
+
+// Step the replica up to the emulation thread's step count. The level events
+// do the mixing, so once a real step has run the mixer against the current
+// registers, a stretch with nothing due in it is skipped whole, exactly as
+// fs_audio_steps does.
+void Machine::aw_replay_to(uint64_t steps) {
+  while (aw_steps_ < steps) {
+    if (aw_mixed_) {
+      const uint32_t quiet = psg_batch_quiet_steps(&aw_psg_);
+      const auto m = static_cast<uint32_t>(
+          std::min<uint64_t>(steps - aw_steps_, quiet - 1));
+      if (m > 0) {
+        psg_batch_skip(&aw_psg_, m);
+        aw_steps_ += m;
+        continue;
+      }
     }
-    audio_.push_back(static_cast<int16_t>(std::clamp(left, -32768, 32767)));
-    audio_.push_back(static_cast<int16_t>(std::clamp(right, -32768, 32767)));
-    au_accL_ = au_accR_ = 0;
-    au_n_ = 0;
+    psg_batch_step(&aw_psg_);
+    aw_steps_++;
+    aw_mixed_ = true;
   }
 }
 
@@ -578,7 +1015,13 @@ void Machine::wake_slot(const Bus& cur, Bus& next) {
   // register-page overlay varies it on a Plus).
   bool w_mem = kFetch || (tuple_changed && strobe) || wk_mem_woke_;
   bool w_vid = kVid || wk_crtc_woke_;
-  bool w_tape = wk_tape_live_ || motor_edge;
+  // Deck: a playing tape's wire holds still until its next edge
+  // (tape_cycles_to_edge), so with the motor running it sleeps up to the
+  // cycle before it and tape_advance() re-applies the skipped cycles at wake.
+  // A motor edge wakes it (skipped cycles are all motor-on).
+  const bool tape_asleep =
+      cur.tape.motor && wk_tape_skip_ + 1 < wk_tape_sleep_;
+  bool w_tape = (wk_tape_live_ && !tape_asleep) || motor_edge;
   bool w_prt = cur.cpu.iorq && cur.cpu.wr;
   // GA: on a quiet cycle (no sync movement, no CPU I/O, no ack) its tick is
   // exactly `phase++` plus bus outputs that are pure functions of that phase —
@@ -714,7 +1157,13 @@ void Machine::wake_slot(const Bus& cur, Bus& next) {
     wk_fdc_skip_++;
   }
   if (wk_probe_on_) prdev_.tick(prdev_.self, in, &next);
-  if (w_tape) tdev_.tick(tdev_.self, in, &next);
+  if (w_tape) {
+    settle_tape();
+    tdev_.tick(tdev_.self, in, &next);
+    wk_tape_sleep_ = wk_tape_live_ ? tape_cycles_to_edge(&tdev_) : 0;
+  } else if (wk_tape_live_) {
+    wk_tape_skip_++;
+  }
   if (w_prt) {
     if (wk_prt_skip_ != 0) {
       printer_advance(&prtdev_, wk_prt_skip_);  // exact timestamp catch-up
@@ -814,12 +1263,12 @@ void Machine::tick_wake() {
 
 // One µs of the chunked fast path: the 16 slots in sequence with no per-cycle
 // dispatch switch and no per-cycle frame bookkeeping beyond what is exact —
-// audio accumulates only after slot 15 (the only commit with clk.psg high, by
-// the phase invariant above), taps drain per slot only while installed, and
-// the frame-exit peek mirrors the per-cycle path's VSYNC-neighbourhood gate
-// slot for slot. The caller guarantees alignment (committed clk.phase == 15),
-// distance from VSYNC, and quiet-frame mode (no capture, no line-in feed, no
-// cycle hook, no armed comparators).
+// a plugged DAC is polled only after slot 15 (the only commit with clk.psg
+// high, by the phase invariant above), taps drain per slot only while
+// installed, and the frame-exit peek mirrors the per-cycle path's
+// VSYNC-neighbourhood gate slot for slot. The caller guarantees alignment
+// (committed clk.phase == 15), distance from VSYNC, and quiet-frame mode (no
+// capture, no line-in feed, no cycle hook, no armed comparators).
 int Machine::run_wake_us(VideoRegs& vr, uint32_t target, bool& vsync_seen) {
   // Ping-pong bus buffers: for the whole µs the committed bus lives in a/b
   // alternately (stack-hot, unaliased with board_), and board_.bus is written
@@ -832,27 +1281,28 @@ int Machine::run_wake_us(VideoRegs& vr, uint32_t target, bool& vsync_seen) {
   Bus* cur = &bufa;
   Bus* nxt = &bufb;
   int n = 0;
-#define KONCPC_WAKE_SLOT(P)                \
-  wake_slot<P>(*cur, *nxt);                \
-  board_.master_cycles += 1;               \
-  n++;                                     \
-  if (tap_count_ != 0) service_taps(*nxt); \
-  if ((P) == 15) accumulate_audio();       \
-  {                                        \
-    const bool was = vsync_seen;           \
-    vsync_seen = nxt->vid.vsync;           \
-    if (vsync_seen || was) {               \
-      video_peek(&vdev_, &vr);             \
-      if (vr.frames >= target) {           \
-        board_.bus = *nxt;                 \
-        return n;                          \
-      }                                    \
-    }                                      \
-  }                                        \
-  {                                        \
-    Bus* flip = cur;                       \
-    cur = nxt;                             \
-    nxt = flip;                            \
+#define KONCPC_WAKE_SLOT(P)                       \
+  wake_slot<P>(*cur, *nxt);                       \
+  board_.master_cycles += 1;                      \
+  n++;                                            \
+  if (tap_count_ != 0) service_taps(*nxt);        \
+  if (flash_addr_ != 0) service_tape_flash(*nxt); \
+  if ((P) == 15 && au_dac_on_) au_dac_poll();     \
+  {                                               \
+    const bool was = vsync_seen;                  \
+    vsync_seen = nxt->vid.vsync;                  \
+    if (vsync_seen || was) {                      \
+      video_peek(&vdev_, &vr);                    \
+      if (vr.frames >= target) {                  \
+        board_.bus = *nxt;                        \
+        return n;                                 \
+      }                                           \
+    }                                             \
+  }                                               \
+  {                                               \
+    Bus* flip = cur;                              \
+    cur = nxt;                                    \
+    nxt = flip;                                   \
   }
   // Quiet-pair elision — the Z80-slot-spacing payoff WITHOUT touching the Z80
   // core: at slots {2,3}, {6,7}, {10,11} every device is provably asleep on a
@@ -944,8 +1394,8 @@ int Machine::run_wake_us(VideoRegs& vr, uint32_t target, bool& vsync_seen) {
 // rel = tstates - fs_t0_, CRTC char k runs at rel master 16k, its irq effect
 // is CPU-visible at rel T-state 4k+1, an access with T1 at rel tau applies
 // after char floor(tau/4), and everything with T1 in µs j lands before cell
-// j's render. Audio units are (sound_step; accumulate) pairs; an AY op with
-// T1 in µs j applies after unit j.
+// j's render. Audio units are sound steps (their level events do the mixing);
+// an AY op with T1 in µs j applies after unit j.
 // ===========================================================================
 
 void Machine::fs_advance_chars(uint64_t target) {
@@ -1046,26 +1496,20 @@ void Machine::fs_render_below(uint64_t target) {
 
 void Machine::fs_audio_steps(uint64_t steps) {
   while (fs_audio_steps_ < steps) {
-    if (fs_audio_accs_ < fs_audio_steps_) {
-      accumulate_audio();  // the previous unit's deferred accumulate — its
-      fs_audio_accs_++;    // levels are stable until this next step
-    }
     psg_batch_step(&sdev_);
     fs_audio_steps_++;
     // F8 bulk: the step above ran the mixer against live registers, and
     // registers cannot move inside this drain (writes drain audio first,
     // then apply) — so until the next counter event the output levels are
-    // provably static. Fold whole (accumulate; step) pairs: m accumulates
-    // of a constant level, then m closed-form counter skips. m stops one
-    // short of the event step, which the next iteration runs for real.
-    if (fs_audio_steps_ < steps && fs_audio_accs_ < fs_audio_steps_) {
+    // provably static and no level event can fire. Skip m steps in closed
+    // form, one short of the event step, which the next iteration runs for
+    // real.
+    if (fs_audio_steps_ < steps) {
       const uint32_t quiet = psg_batch_quiet_steps(&sdev_);
       const uint64_t want = steps - fs_audio_steps_;
       const uint32_t m =
           static_cast<uint32_t>(want < quiet - 1 ? want : quiet - 1);
       if (m > 0) {
-        accumulate_audio_bulk(m);
-        fs_audio_accs_ += m;
         psg_batch_skip(&sdev_, m);
         fs_audio_steps_ += m;
       }
@@ -1331,13 +1775,13 @@ uint8_t Machine::fsb_int_ack(void* ctx, uint64_t now) {
   return 0xFF;
 }
 
-bool Machine::run_frame_fast(VideoRegs& vr, uint32_t target) {
+bool Machine::run_frame_fast(VideoRegs& vr, uint32_t target, uint64_t stop) {
   // ENTRY CONTRACT (checked by the caller): the Z80 sits at a clean boundary
   // (z80_batch_ready) with the committed bus at clk.phase == 0, every device
   // per-cycle-synced. The grid invariant then puts tstates ≡ 0 mod 4.
   fs_t0_ = z80_batch_tstates(&zdev_);
   fs_chars_ = fs_cells_ = 0;
-  fs_audio_steps_ = fs_audio_accs_ = 0;
+  fs_audio_steps_ = 0;
   fs_fdc_done_ = fs_prt_done_ = 0;
   fs_pend_head_ = fs_pend_tail_ = 0;
   fs_vpages_ = 0;
@@ -1365,9 +1809,27 @@ bool Machine::run_frame_fast(VideoRegs& vr, uint32_t target) {
                        &Machine::fsb_io_write,
                        &Machine::fsb_int_ack};
 
+  // The caller's stop (run_until) as a T-state budget. Past it, the batch
+  // hands back like a bail — but only at a boundary whose last char sits in
+  // HSYNC: the exit renders that char's cell before the per-cycle loop runs
+  // the rest of its microsecond, so a writing instruction there could land
+  // after its paint. An HSYNC cell paints nothing (its falling edge latches
+  // the Plus line state, so not that one). Overshoot: under one scanline.
+  const uint64_t m0 = board_.master_cycles;
+  const uint64_t stop_t = stop > m0 ? ((stop - m0) + 3) / 4 : 0;
   const long bound = kMasterPerFrame;  // instruction-count safety bound
   for (long guard = 0; guard < bound && !fs_cut_ && !fs_bail_; ++guard) {
     const uint64_t rel = z80_batch_tstates(&zdev_) - fs_t0_;
+    if (rel >= stop_t) {
+      fs_advance_chars(fs_visible(rel));
+      if (fs_cut_ || fs_bail_) break;
+      if (fs_pend_tail_ > 0) {
+        const CrtcCharView& last = fs_pend_buf_[fs_pend_tail_ - 1];
+        if ((last.levels & CRTC_LVL_HSYNC) != 0 &&
+            (last.edges & (1u << CRTC_EDGE_HSYNC_FALL)) == 0)
+          break;  // slice end
+      }
+    }
     if (z80_batch_halted(&zdev_) != 0) {
       fs_irq_tmax_ = 0;  // this path polls fs_irq() directly per hop — force
                          // the fall-through boundary to re-poll too
@@ -1432,15 +1894,10 @@ bool Machine::run_frame_fast(VideoRegs& vr, uint32_t target) {
   const uint64_t m_next = (4 * (relB - 1)) + 2;  // next per-cycle master
   fs_advance_chars(fs_visible(relB));  // == chars a per-cycle run reaches
   fs_render_below(fs_chars_);  // CPU-ahead cells sit inside VSYNC: no pixels
-  // Audio: all sound steps a per-cycle run reaches (== the char count), then
-  // the final trailing accumulate ONLY if its master (rel 16k+15) has passed
-  // — otherwise the resumed per-cycle loop runs it at that exact master.
+  // Audio: all sound steps a per-cycle run reaches (== the char count). The
+  // accumulate clock needs nothing more — it is read off the step count and
+  // the synthesized bus below.
   fs_audio_steps(fs_chars_);
-  if (fs_audio_accs_ < fs_audio_steps_ &&
-      (16 * (fs_audio_steps_ - 1)) + 15 <= m_next - 1) {
-    accumulate_audio();
-    fs_audio_accs_++;
-  }
   fs_fdc_to(m_next);
   if (m_next > fs_prt_done_) printer_advance(&prtdev_, m_next - fs_prt_done_);
   ga_advance(&gdev_, m_next);  // the ÷16 divider lands exactly
@@ -1587,27 +2044,47 @@ void Machine::recompose_active() {
   fast_valid_ = wake_valid_;
 }
 
-void Machine::run_frame() {
-  if (!built_) return;
-  recompose_active();  // frame-boundary: pick up any plug/unplug since last
-                       // frame
+void Machine::run_frame() { run_until(~uint64_t{0}); }
+
+bool Machine::run_until(uint64_t master_cycle) {
+  if (!built_) return false;
   audio_.clear();
   out_q_.clear();
   VideoRegs vr{};
   video_peek(&vdev_, &vr);
-  const uint32_t target = vr.frames + 1;
-  // Armed-at-frame-start is stable: comparators change on this thread only.
-  const bool watch_probe = probe_armed(&prdev_) != 0;
-  {  // plug state changes only between frames (host thread) — cache for audio
-    AmdrumRegs drum{};
-    amdrum_peek(&addev_, &drum);
-    amdrum_on_ = drum.plugged != 0;
+  // A frame opens on the first run after the last one completed; everything
+  // latched here holds for the whole frame however many runs it is split
+  // into. (A debugger single-step can complete a frame between runs.)
+  if (!frame_open_ || vr.frames >= frame_target_) {
+    recompose_active();  // frame-boundary: pick up any plug/unplug since last
+                         // frame
+    frame_open_ = true;
+    frame_target_ = vr.frames + 1;
+    frame_end_ = board_.master_cycles + (kMasterPerFrame * 2);
+    {  // plug state changes only between frames (host thread) — cache for
+       // audio
+      AmdrumRegs drum{};
+      amdrum_peek(&addev_, &drum);
+      amdrum_on_ = drum.plugged != 0;
+    }
+#ifndef SOLDERED
+    // Latch the tier ONCE per frame — the switch is frame-boundary only (plan
+    // §14 Q7); it never changes mid-frame. effective_run_tier() applies the
+    // composition-aware degradation (Soldered/Wake → Faithful off-canonical).
+    frame_tier_ = effective_run_tier();
+#endif
   }
+  const uint32_t target = frame_target_;
+  const uint64_t stop = std::min(master_cycle, frame_end_);
+  // Fast frames batch their own audio (fs_audio_steps); per-cycle runs hand
+  // the PSG generator and the mix to the worker when there is one.
+  au_begin();
+  if (aw_ != nullptr && frame_tier_ != RunTier::Fast) aw_open();
+  // Armed-at-run-start is stable: comparators change on this thread only.
+  const bool watch_probe = probe_armed(&prdev_) != 0;
+  arm_tape_flash();  // deck buttons and paging are host/run-start state
 #ifndef SOLDERED
-  // Latch the tier ONCE per frame — the switch is frame-boundary only (plan §14
-  // Q7); it never changes mid-frame. effective_run_tier() applies the
-  // composition-aware degradation (Soldered/Wake → Faithful off-canonical).
-  const RunTier tier = effective_run_tier();
+  const RunTier tier = frame_tier_;
   const bool soldered = tier == RunTier::Soldered;
   // Fast tier (F6): frame-quiet gates — modes needing per-cycle attention run
   // the frame on the per-cycle path instead (the ladder's next rung is the
@@ -1620,10 +2097,9 @@ void Machine::run_frame() {
   if (tier == RunTier::Fast) {
     TapeRegs deck{};
     tape_peek(&tdev_, &deck);
-    // digiblaster_: the batch audio defers each unit's accumulate until the
-    // next sound step, which would read a printer-latch write landing in the
-    // gap one microsecond early — per-µs DAC mixing stays on the per-cycle
-    // tiers until it earns its own oracle.
+    // digiblaster_: a DAC is polled per µs (au_dac_poll), which the batch
+    // has no slot for — per-µs DAC mixing stays on the per-cycle tiers until
+    // it earns its own oracle.
     // Taps do NOT gate the batch: run_frame_fast fires them itself at the
     // instruction boundary (F8 — the GUI console taps are always armed, and
     // a tap-gated Fast tier could never engage there). A latched probe hit
@@ -1640,7 +2116,7 @@ void Machine::run_frame() {
         (!wk_serial_on_ ||
          (rs232_quiet(&rsdev_) != 0 && plotter_hp7470a_quiet(&pldev_) != 0));
   }
-  // Wake tier (Gate B6): frame-start is the one boundary where host-side state
+  // Wake tier (Gate B6): run start is the one boundary where host-side state
   // can have changed under the scheduler (pokes, key rows, deck buttons,
   // snapshot loads, a debug single-step via board_tick) — refresh the caches
   // and force-wake everything for the first cycle so no shadow is stale.
@@ -1654,6 +2130,7 @@ void Machine::run_frame() {
     TapeRegs deck{};
     tape_peek(&tdev_, &deck);
     wk_tape_live_ = deck.playing != 0 || deck.line_mode != 0;
+    wk_tape_sleep_ = 0;  // the forced first tick measures it afresh
     wk_probe_on_ = probe_active(&prdev_) != 0;
     wk_asic_on_ = asic_vid_active(&adev_) != 0;
     wk_fdc_quiet_ = fdc_quiet(&fdev_) != 0;  // snapshot loads / host pokes
@@ -1678,9 +2155,8 @@ void Machine::run_frame() {
                         cycle_hook_ == nullptr &&
                         instr_hook_ == nullptr;  // trace needs every retire
 #endif
-  const long bound = kMasterPerFrame * 2;
-  long i = 0;
-  while (i < bound && vr.frames < target) {
+  bool fast_done = false;  // the batch cut the frame (fs_cut_)
+  while (board_.master_cycles < stop && vr.frames < target) {
     // Coprocessor latency (m4-device.md §3): answer a latched M4 command NOW,
     // not at the frame boundary — the ROM's poll loops are written against a
     // microsecond STM32 and time out at frame latency. One load + predictable
@@ -1694,8 +2170,9 @@ void Machine::run_frame() {
     // clocks down; anchoring there would put the batch one master early.
     if (fast_pending && z80_batch_ready(&zdev_) != 0 &&
         board_.bus.clk.phase == 0 && board_.bus.clk.cpu) {
-      if (run_frame_fast(vr, target)) {  // the frame completed batched
+      if (run_frame_fast(vr, target, stop)) {  // the frame completed batched
         fast_frames_run_++;
+        fast_done = true;
         break;
       }
       fast_pending = false;  // could not engage — finish per-cycle
@@ -1710,8 +2187,9 @@ void Machine::run_frame() {
     // the 0..15 chain starts when the committed phase is 0 (slot 15's commit
     // then leaves phase 0 again — chunks tile without re-checking).
     if (chunk_ok && !wk_force_ && board_.bus.clk.phase == 0 &&
-        !board_.bus.vid.vsync && !vsync_seen && i + 16 <= bound) {
-      i += run_wake_us(vr, target, vsync_seen);
+        !board_.bus.vid.vsync && !vsync_seen &&
+        board_.master_cycles + 16 <= stop) {
+      run_wake_us(vr, target, vsync_seen);
       continue;
     }
 #endif
@@ -1739,9 +2217,9 @@ void Machine::run_frame() {
     capture_tape_output();
     feed_tape_line_in();
     service_taps(board_.bus);
+    if (flash_addr_ != 0) service_tape_flash(board_.bus);
     if (watch_probe && probe_pending(&prdev_, nullptr)) break;  // ICE halt
-    if (board_.bus.clk.psg) accumulate_audio();
-    i++;
+    if (au_dac_on_ && board_.bus.clk.psg) au_dac_poll();
 #ifndef SOLDERED
     if (wake) {
       // Frame completion can only move while VSYNC is on the bus (frames
@@ -1772,7 +2250,16 @@ void Machine::run_frame() {
     fdc_advance(&fdev_, wk_fdc_skip_);
     wk_fdc_skip_ = 0;
   }
+  if (wake) settle_tape();
 #endif
+  if (aw_on_) aw_close();
+  au_end();
+  render_audio();
+  video_peek(&vdev_, &vr);  // the wake path only peeks near VSYNC
+  // Done with this frame: it completed, or ran into its two-frame bound.
+  if (fast_done || vr.frames >= target || board_.master_cycles >= frame_end_)
+    frame_open_ = false;
+  return !frame_open_;
 }
 
 bool Machine::add_tap(uint16_t addr, TapFn fn, void* ctx) {
@@ -39,6 +39,8 @@
 #include "hw/tape.h"
 #include "hw/video.h"
 #include "hw/z80.h"
+#include "subcycle/audio_worker.h"
+#include "subcycle/flux_predecode.h"
 
 namespace subcycle {
 
@@ -58,6 +60,10 @@ constexpr uint64_t kMaxFastChars = (kMasterPerFrame * 2) / 16;
 constexpr long kPsgHz = 1000000;
 constexpr long kAudioHz = 44100;
 constexpr int kAudioGain = 280;  // psg level 0..93 -> int16 with headroom
+// Band-limited step synthesis (machine.cpp): kernel length in host samples and
+// sub-sample phase resolution.
+constexpr int kBlepTaps = 32;
+constexpr int kBlepPhases = 64;
 
 // Optional host audio overlay (drive sounds): the machine feeds it the FDC's
 // mechanical events (motor/seek) so a host layer can react. It is events-only —
@@ -77,6 +83,18 @@ class Machine {
   // Caller-owned RGB24 framebuffer (w*h*3). Re-attachable at any time.
   void attach_framebuffer(uint8_t* fb, int w, int h);
 
+  // Render-less mode for CI hash runs: the beam keeps exact timing but paints
+  // nothing; each frame's render inputs fold into frame_hash() (published at
+  // VSYNC rise, tier-independent). The framebuffer may be detached (nullptr,
+  // with the canvas w/h kept) while on. Toggling restarts the hash.
+  void set_hash_only(bool on);
+  bool hash_only() const;
+  uint32_t frame_hash() const;
+  // Frame skipping for uncapped runs: a frame run with this on paints nothing
+  // (timing and state identical to a painted one); the framebuffer keeps the
+  // last painted frame. Flip between run_frame calls.
+  void set_skip_paint(bool on);
+
   // AMSDOS (or any 16K ROM) into upper-ROM slot 7. Caller-owned.
   void attach_amsdos(const uint8_t* rom16k, size_t len);
   // Any caller-owned 16K ROM into an arbitrary upper-ROM slot (e.g. the M4,
@@ -95,23 +113,47 @@ class Machine {
   bool insert_disk(uint8_t* dsk, size_t len, uint8_t unit = 0);
   bool disk_dirty() const;
   void mark_disk_clean();
-  bool insert_flux(const uint8_t* scp, size_t len);
+  // A flux disc decodes in the background from here on (flux_predecode.h);
+  // the pool reads `scp` until it finishes, the disc leaves its drive, or
+  // stop_flux_predecode() — call that before freeing or replacing the SCP.
+  bool insert_flux(const uint8_t* scp, size_t len, uint8_t unit = 0);
   void eject_disk(uint8_t unit = 0);
-
-  // The cassette deck (caller-owned CDT; live wiring). The firmware owns the
+  void stop_flux_predecode();  // both drives
+  void stop_flux_predecode(uint8_t unit);
+  // The running or finished background decode of a drive (nullptr = none).
+  const FluxPredecoder* flux_predecode(uint8_t unit = 0) const {
+    return flux_pre_[unit & 1].get();
+  }
+  // Memory the FDC may spend on decoded flux tracks, both drives together
+  // (fdc_set_flux_cache). Allocated at the first flux insert; a budget under
+  // two tracks leaves the FDC's small built-in cache.
+  static constexpr size_t kFluxCacheDefault = size_t{8} << 20;
+  void set_flux_cache_budget(size_t bytes);
+  size_t flux_cache_budget() const { return flux_cache_budget_; }
+
+  // The cassette deck. insert_tape compiles the CDT into a pulse stream the
+  // machine owns (the caller's buffer is not kept). The firmware owns the
   // motor relay through the PPI; PLAY is the user's button. Line-in mode
   // follows set_tape_line() — the host's Schmitt stage over mic samples.
   bool insert_tape(const uint8_t* cdt, size_t len);
   void eject_tape();
   void tape_play_button(bool on);
   void tape_rewind_deck();
-  // Seek the deck to the Nth CDT block (walks the deck's cdt by block size).
+  // Seek the deck to the Nth CDT block, or to a time on the tape.
   void tape_seek(uint32_t block_ordinal);
+  void tape_seek_cycle(uint64_t cycle);
   // Drain decoded data bits for the host tape scope's BITS view (0/1, oldest
   // first); returns the count copied (<= max).
   int tape_drain_bits(uint8_t* out, int max);
   void tape_line_in(bool on);
   void set_tape_line(bool level);
+  // Flash loading (tape-device.md §8): when the firmware's CAS READ is
+  // entered with PLAY down and the next block is a standard firmware record,
+  // the record lands in RAM at once and CAS READ returns as if it had read
+  // it; anything else (custom/turbo loaders, damaged blocks) plays in real
+  // time. Off by default — the deck is otherwise pulse-exact.
+  void set_tape_flash(bool on) { tape_flash_ = on; }
+  bool tape_flash() const { return tape_flash_; }
 
   // Rate-clocked line-in: append one POST-SCHMITT level per audio sample; the
   // machine consumes them at sample_rate against the 16 MHz master clock
@@ -164,6 +206,22 @@ class Machine {
   // check probe_hit() afterwards; ack + run again to continue the frame.
   void run_frame();
 
+  // Sub-frame slicing: advance until master_cycle() reaches `master_cycle`
+  // or the current frame completes, whichever is first; true when the frame
+  // completed (or hit its two-frame bound). audio() then holds just this
+  // run's samples. Under the per-cycle tiers a frame run as slices ends with
+  // the same samples, framebuffer and machine state as one run_frame(). The
+  // Fast tier stops at the first instruction boundary past the target that
+  // falls in HSYNC, so a slice may overshoot by up to a scanline; there only
+  // the observable output (framebuffer and concatenated audio) is promised
+  // to match, not the RAM/clock state at the frame boundary. The
+  // frame-boundary latches (tier, composition) are taken by the first run of
+  // each frame. Same probe-hit early stop as run_frame().
+  bool run_until(uint64_t master_cycle);
+  bool run_slice(uint32_t us) {
+    return run_until(board_.master_cycles + (uint64_t{us} * 16));
+  }
+
   // --- Runtime speed tiers (Gate B5/B6; plan: docs/plans/
   // 2026-07-09-001-feat-runtier-fast-plan.md) ------------------------------
   // All tiers run the SAME devices over the SAME state and master clock and
@@ -347,6 +405,13 @@ class Machine {
   // This frame's interleaved stereo s16 samples (valid until the next run).
   const std::vector<int16_t>& audio() const { return audio_; }
 
+  // Render the PSG and DACs on a worker thread (audio_worker.h): runs on the
+  // per-cycle tiers only log register writes and DAC changes, and the
+  // worker replays them while the run goes on. audio() is identical either
+  // way; Fast frames always mix in-thread. Switch between runs.
+  void set_audio_worker(bool on);
+  bool audio_worker() const { return aw_ != nullptr; }
+
   // Host audio overlay (drive sounds). May be null. Not owned.
   void set_overlay(AudioOverlay* overlay) { overlay_ = overlay; }
 
@@ -468,6 +533,9 @@ class Machine {
   void symbiface_detach_ide(int drive) { sf2_ide_detach(&sfdev_, drive); }
   bool symbiface_dirty() const { return sf2_media_dirty(&sfdev_) != 0; }
   void symbiface_mark_clean() { sf2_media_mark_clean(&sfdev_); }
+  const uint8_t* symbiface_written(int drive, uint32_t* region_sectors) const {
+    return sf2_media_written(&sfdev_, drive, region_sectors);
+  }
   void symbiface_rtc_time(const uint8_t regs10[10]) {
     sf2_rtc_set_time(&sfdev_, regs10);
   }
@@ -477,17 +545,40 @@ class Machine {
   Board* board() { return &board_; }
 
  private:
-  int16_t emit_sample(long acc, double& dc_x, double& dc_y) const;
+  void blep_step(long dL, long dR);  // a level change at the current step
+  void render_audio();  // pending host-rate samples -> audio_ (+ overlay)
 
   // run_frame's per-master-cycle work, split into named steps (each inlines
   // at -O2). They read/write the machine's live state directly.
   void capture_tape_output();  // sample the cassette wires at the audio rate
+  void settle_tape();          // re-apply the deck's skipped cycles
   void feed_tape_line_in();    // clock one queued live line-in level in
   void service_taps(
       const Bus& committed);  // fire firmware-vector taps this cycle
-  void accumulate_audio();    // one PSG sample + analog DACs + stereo emit
-  void accumulate_audio_bulk(uint32_t k);  // k level-stable steps at once —
-                                           // same arithmetic, boundary-exact
+  void arm_tape_flash();      // run start: resolve CAS READ, or disarm
+  void service_tape_flash(const Bus& committed);  // trap CAS READ this cycle
+  void finish_tape_flash();  // at the boundary: load the record, return
+  // Event-driven mixing on the per-µs accumulate clock (machine.cpp).
+  uint64_t au_at(uint64_t steps) const;  // accumulate index for a step count
+  uint64_t au_now() const;     // accumulates due at the committed bus
+  void au_to(uint64_t acc);    // clock the current levels up to acc
+  void au_set_levels(const uint8_t lv[3]);  // the PSG's share of the mix
+  static void au_psg_level(void* ctx, uint64_t step, const uint8_t lv[3]);
+  void au_begin();     // run start: re-sync the clock, take the levels
+  void au_end();       // run end: clock the levels up to now
+  void au_dac_poll();  // a clk.psg commit with a DAC plugged
+  long dac_level() const;  // the analog DACs' left-channel contribution
+  void au_mix(long left, long right, uint32_t k);  // k steps at these levels
+  void au_fold();  // advance the host-rate clock over the held run
+  // Audio worker: open/close a run's timeline session, and the worker-side
+  // replay (the Sink callbacks, the replica's level sink, the stepping).
+  void aw_open();
+  void aw_close();
+  static void aw_psg_write(void* ctx, uint64_t step, uint8_t reg, uint8_t val);
+  static void aw_psg_level(void* ctx, uint64_t step, const uint8_t lv[3]);
+  static void aw_apply(void* ctx, const SoundEvent& ev);
+  static void aw_advance(void* ctx, uint64_t steps, uint64_t accs);
+  void aw_replay_to(uint64_t steps);
   // The master-cycle tick with every device called by hardcoded direct name
   // instead of the fn-pointer array dispatch — models a fixed "soldered" board
   // and lets the compiler inline each tick. This is the Fast tier (Gate B5);
@@ -505,14 +596,35 @@ class Machine {
       prmem_, prtmem_, admem_, mfmem_, axmem_, swmem_, sfmem_, m4mem_, asmem_,
       tmem_, rsmem_, plmem_, lgmem_;
   void resize_expansion();
+  bool attach_flux(const uint8_t* scp, size_t len,
+                   uint8_t unit);  // insert_flux's attach
+  void wire_flux_cache();
 
   std::vector<uint8_t> xmem_;        // expansion RAM above the base 64K
   size_t want_expansion_ = 0x10000;  // requested expansion (default: 128K CPC)
   bool silicon_ = false;             // Silicon Disc fitted (needs banks 4-7)
-  // Writable-flux DSK overlay (Stage 2): synthesized from the SCP at insert and
-  // owned here, it is the FDC's mutable `image`; the caller's SCP stays the
-  // pristine source. Empty when drive A holds a DSK or a read-only flux dump.
-  std::vector<uint8_t> flux_dsk_;
+  // Writable-flux DSK overlays (Stage 2), per drive: synthesized from the SCP
+  // at insert and owned here, each is the FDC's mutable `image`; the caller's
+  // SCP stays the pristine source. Empty when the drive holds a DSK or a
+  // read-only flux dump.
+  std::vector<uint8_t> flux_dsk_[2];
+  // Background decode of each drive's flux disc, serving the FDC's misses.
+  std::unique_ptr<FluxPredecoder> flux_pre_[2];
+  // The FDC's decoded-track cache (empty until the first flux insert).
+  std::vector<uint8_t> flux_cache_;
+  size_t flux_cache_budget_ = kFluxCacheDefault;
+  // The inserted tape, compiled to the deck's pulse stream (tape.h).
+  std::vector<TapeRun> tape_runs_;
+  std::vector<TapeBlock> tape_blocks_;
+  std::vector<uint8_t> tape_cdt_;  // the CDT itself: the flash loader's source
+  bool tape_flash_ = false;
+  // The flash trap: CAS READ's ROM address for this run (0 = disarmed), the
+  // fetch-edge state, and the caller's registers once it is entered (applied
+  // at the next instruction boundary — the fetch edge is mid-instruction).
+  uint16_t flash_addr_ = 0;
+  bool flash_prev_fetch_ = false;
+  bool flash_pending_ = false;
+  Z80Regs flash_entry_{};
   Device gdev_{}, cdev_{}, pdev_{}, sdev_{}, mdev_{}, vdev_{}, zdev_{}, fdev_{},
       prdev_{}, tdev_{}, prtdev_{}, addev_{}, mfdev_{}, axdev_{}, swdev_{},
       sfdev_{}, m4dev_{}, adev_{}, rsdev_{}, pldev_{}, lgdev_{};
@@ -593,6 +705,8 @@ class Machine {
   uint64_t wk_ga_skip_ = 0;    // GA cycles synthesized since its last tick
   bool wk_fdc_quiet_ = false;  // fdc_quiet() as of its last tick / frame start
   uint64_t wk_fdc_skip_ = 0;   // FDC cycles skipped since its last tick
+  uint64_t wk_tape_sleep_ = 0;  // tape_cycles_to_edge() at its last tick
+  uint64_t wk_tape_skip_ = 0;   // deck cycles skipped since its last tick
   // RS232 + HP7470 plotter wake contract (the bit-serial pair). No skip
   // counter: neither UART runs a free-running per-cycle counter while quiet
   // (tx/rx timers reset on byte start; the plotter's input drain only runs
@@ -611,6 +725,13 @@ class Machine {
   // soldered_available()). build() always adds exactly this many.
   static constexpr int kSolderedDevices = 21;
   RunTier tier_ = RunTier::Wake;  // THE default; frame-boundary swap only
+  // run_until's per-frame latches: a frame split into slices keeps the tier,
+  // target and bound its first run took. Cleared by reset/load_devices so a
+  // restored machine starts a fresh frame.
+  bool frame_open_ = false;
+  uint32_t frame_target_ = 0;  // video frames count that completes the frame
+  uint64_t frame_end_ = 0;     // master-cycle bound (two frames' worth)
+  RunTier frame_tier_ = RunTier::Wake;
 
   // --- Fast tier (F6, epic beads-kmzn): instruction-granularity catch-up
   // scheduling over the batch seams (z80_batch_step + Z80BatchIO; the F4/F5
@@ -623,13 +744,9 @@ class Machine {
   uint64_t fs_t0_ = 0;       // z80 tstates at entry (≡ 0 mod 4 on the grid)
   uint64_t fs_chars_ = 0;    // eager CRTC+GA position (µs since entry)
   uint64_t fs_cells_ = 0;    // lazy renderer position
-  // Audio rides two counters with the ACCUMULATE trailing the STEP by up to
-  // one: chan_level changes only at sound steps, so unit k's accumulate is
-  // valid anywhere between step k and step k+1 — deferring it until just
-  // before step k+1 (or the exit check) means a frame cut can leave it for
-  // the resumed per-cycle loop instead of double-counting it at the seam.
+  // Audio is the sound-step cursor alone: the PSG's level events do the
+  // mixing, and the accumulate clock is read off its step count.
   uint64_t fs_audio_steps_ = 0;
-  uint64_t fs_audio_accs_ = 0;
   uint64_t fs_fdc_done_ = 0;  // FDC master-cycle cursor (rel)
   uint64_t fs_prt_done_ = 0;  // printer master-cycle cursor (rel)
   bool fs_fdc_hot_ = false;   // FDC left its quiet contract mid-frame
@@ -684,7 +801,7 @@ class Machine {
   static uint8_t fsb_int_ack(void* ctx, uint64_t now);
   // Run the frame's remainder under the Fast tier from a clean entry point.
   // Returns false (leaving state per-cycle-consistent) only if nothing ran.
-  bool run_frame_fast(VideoRegs& vr, uint32_t target);
+  bool run_frame_fast(VideoRegs& vr, uint32_t target, uint64_t stop);
 
   struct Tap {
     uint16_t addr;
@@ -702,8 +819,8 @@ class Machine {
   bool out_src_rdata_ = true;
   bool digiblaster_ = false;  // mix the printer latch as a DAC
   bool amdrum_on_ = false;    // frame-start cache of the AmDrum plug state —
-                              // spares accumulate_audio a 1 MHz-rate peek on
-                              // the common unplugged machine (all tiers)
+                              // spares the unplugged machine the per-µs DAC
+                              // poll (all tiers)
   long out_acc_ = 0;
   std::vector<uint8_t> out_q_;  // this frame's outbound wire samples
 
@@ -713,10 +830,37 @@ class Machine {
   int line_rate_ = 44100;
 
   std::vector<int16_t> audio_;
-  long au_phase_ = 0, au_accL_ = 0, au_accR_ = 0;
-  int au_n_ = 0;
-  double dcL_x_ = 0, dcL_y_ = 0, dcR_x_ = 0, dcR_y_ = 0;
+  // Event-driven audio: level changes land as band-limited steps in blepL_/R_
+  // (one slot per host sample, kBlepTaps of kernel tail past the pending
+  // ones); render_audio integrates and DC-blocks them once per run.
+  long au_phase_ = 0;      // host-rate clock, in PSG steps x kAudioHz
+  size_t au_pending_ = 0;  // host samples completed since the last render
+  uint64_t au_held_ = 0;   // steps at the current levels not yet clocked
+  long au_lastL_ = 0, au_lastR_ = 0;  // levels the timeline has reached
+  long au_psgL_ = 0, au_psgR_ = 0;    // the PSG's share of the levels to mix
+  long au_dac_ = 0;                   // the DACs' (left only)
+  uint64_t au_mark_ = 0;   // accumulate index clocked so far
+  int64_t au_skew_ = 0;    // accumulate index minus (steps + pending commit)
+  bool au_live_ = false;   // a run is open: level events are mixed
+  bool au_dac_on_ = false; // a DAC is plugged this run: poll it per µs
+  std::vector<int32_t> blepL_ = std::vector<int32_t>(4096, 0);
+  std::vector<int32_t> blepR_ = std::vector<int32_t>(4096, 0);
+  int64_t au_intL_ = 0, au_intR_ = 0;  // integrated level, Q15
+  int64_t dcL_x_ = 0, dcL_y_ = 0, dcR_x_ = 0, dcR_y_ = 0;
   AudioOverlay* overlay_ = nullptr;
+  // Audio worker. The emulation thread owns the first group; the worker owns
+  // the replica PSG, the aw_* replay cursor and the mixer state above from
+  // aw_open() until aw_close() returns. Replica step r is board step
+  // aw_sbase_ + (r - aw_rbase_).
+  std::unique_ptr<AudioWorker> aw_;
+  bool aw_on_ = false;       // this run logs the timeline instead of mixing
+  long aw_dac_logged_ = 0;   // DAC level as last logged
+  std::vector<uint8_t> aw_psg_mem_;
+  Device aw_psg_{};          // the replica PSG the worker steps
+  uint64_t aw_steps_ = 0;    // replay cursor: steps done this run
+  bool aw_mixed_ = false;    // a real step has mixed since the last write
+  uint64_t aw_sbase_ = 0;    // board PSG's step count at aw_open
+  uint64_t aw_rbase_ = 0;    // the replica's
 
   CycleHook cycle_hook_ = nullptr;  // per-cycle input-replay seam (Gate B2)
   void* cycle_hook_ctx_ = nullptr;
@@ -14,6 +14,7 @@
 #include <fstream>
 #include <mutex>
 #include <string>
+#include <thread>
 
 #include "amdrum.h"        // legacy g_amdrum: the UI toggles its enabled flag
 #include "amx_mouse.h"     // legacy g_amx_mouse: SDL events fill its counters
@@ -33,6 +34,7 @@
 #include "koncepcja.h"
 #include "log.h"
 #include "m4board.h"  // legacy g_m4board: the deferred command executor
+#include "media_file.h"  // copy-on-write DSK/IDE maps + journaled write-back
 #include "serial_interface.h"  // g_serial_interface config → the serial pair
 #include "silicon_disc.h"  // legacy g_silicon_disc: the battery buffer anchor
 #include "smartwatch.h"  // legacy g_smartwatch: the UI toggles its enabled flag
@@ -77,12 +79,12 @@ struct Bridge {
                                   // keeps SDL on its fast blit paths (F8: the
                                   // one-pass scale+convert fell into
                                   // SDL_Blit_Slow — ~10 ms/frame on E-cores)
-  std::vector<uint8_t> rom, amsdos, media;  // machine wiring: must outlive it
-  std::vector<uint8_t>
-      media_b;                  // drive B DSK image (unit 1): also must outlive
+  std::vector<uint8_t> rom, amsdos;  // machine wiring: must outlive it
+  media::Buffer media;          // drive A image (a .dsk maps copy-on-write)
+  media::Buffer media_b;        // drive B image (unit 1): also must outlive
   std::vector<uint8_t> mf2rom;  // Multiface II 8K ROM (optional)
   std::atomic<bool> mf2_stop{false};  // deferred STOP (UI -> Z80 thread)
-  std::vector<uint8_t> ide_img[2];    // Symbiface IDE images (owned)
+  media::Buffer ide_img[2];           // Symbiface IDE images (mapped, owned)
   std::string ide_path[2];            // their files, for write-back
   bool sf2_ide_loaded = false;
   std::vector<uint8_t> m4rom;  // M4 Board 16K ROM (owned)
@@ -90,6 +92,12 @@ struct Bridge {
   std::vector<uint8_t> serialrom;   // SI card serial BIOS 16K ROM (owned)
   std::vector<uint8_t> tape_media;  // cassette in the deck (owner)
   uint64_t next_deadline = 0;       // 50 Hz pacing (performance-counter ticks)
+  uint32_t slice_us = 0;            // sub-frame slicing (0 = whole frames)
+  BridgeSliceIO slice_io;
+  // IPC capture: set from any thread, called on the emulation thread. The
+  // context is published before the function (see feed_audio_tap).
+  std::atomic<void (*)(void*, const int16_t*, size_t)> audio_tap{nullptr};
+  std::atomic<void*> audio_tap_ctx{nullptr};
   bool active = false;
 
   // Tape host-side mirror (engine=1): each frame debug_sync mirrors the deck's
@@ -117,6 +125,20 @@ struct Bridge {
   double bench_secs = 0.0;
   std::vector<uint8_t> bench_snap;  // disposable-run state snapshot
 
+  // Render-less hash mode (IPC "hash render"): requested from any thread,
+  // latched by the Z80 thread at the frame boundary; the last completed
+  // frame's hash is published back for the reader.
+  std::atomic<int> hash_only_want{-1};  // -1 none pending, else 0/1
+  std::atomic<bool> hash_only_on{false};
+  std::atomic<uint32_t> frame_hash{0};
+
+  // Frame skipping (uncapped runs): the present period the Z80 thread paints
+  // at, from the refresh rate the main thread publishes; frames in between
+  // run with the video Device's painting off. last_present is Z80-thread-
+  // owned.
+  std::atomic<uint64_t> present_period{0};  // perf-counter ticks, 0 = 60 Hz
+  uint64_t last_present = 0;
+
   // Hot-swap handoff (UI thread → Z80 thread): the FDC's media is live wiring
   // and must not change mid-tick, so swaps land here and the emulation thread
   // applies them at its next frame boundary.
@@ -136,11 +158,6 @@ std::vector<uint8_t> read_file(const std::string& path) {
           std::istreambuf_iterator<char>()};
 }
 
-bool ends_with(const std::string& s, const char* suffix) {
-  const size_t n = std::strlen(suffix);
-  return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
-}
-
 // Lowercased 4-char extension (".dsk", ".scp", ...) of `path`, or "" if too
 // short. Every media extension we route on is exactly 4 chars.
 std::string lower_ext(const std::string& path) {
@@ -175,18 +192,12 @@ std::vector<uint8_t> read_media_file(const std::string& path,
   }
   zi.dwOffset =
       zi.filesOffsets[0].second;  // Use the first media entry found by dir().
-  FILE* f = nullptr;
-  if (zip::extract(zi, &f) != 0 || f == nullptr) {
+  std::vector<uint8_t> out;  // inflated in memory; the cache serves re-reads
+  if (zip::extract_to(zi, out) != 0) {
     LOG_ERROR("subcycle engine: cannot extract " << zi.filesOffsets[0].first
                                                  << " from " << path);
     return {};
   }
-  std::vector<uint8_t> out;
-  uint8_t buf[65536];
-  size_t n = 0;
-  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
-    out.insert(out.end(), buf, buf + n);
-  fclose(f);
   ext = lower_ext(zi.filesOffsets[0].first);
   LOG_INFO("subcycle engine: " << path << " -> " << zi.filesOffsets[0].first
                                << " (" << out.size() << " bytes)");
@@ -226,19 +237,57 @@ DriveSoundOverlay g_drive_overlay;
 // the frame path below; also serves the paused "repaint").
 void blit_fb(Bridge& b, SDL_Surface* dst);
 
-// One-line note on whether the drive-A disc is flux and, if so, whether it got
+// One-line note on whether a drive's disc is flux and, if so, whether it got
 // a writable DSK overlay (Stage 2) or fell back to read-only (non-standard
 // flux). Self-gating (silent on a DSK disc) so the caller stays a plain call.
-void log_flux_writability(Bridge& b) {
+void log_flux_writability(Bridge& b, uint8_t unit) {
   size_t scp_len = 0;
-  if (fdc_media_flux_scp(b.machine.fdc(), scp_len) == nullptr) return;
+  if (fdc_media_flux_scp(b.machine.fdc(), scp_len, unit) == nullptr) return;
   size_t img_len = 0;
-  const bool writable = fdc_media_image(b.machine.fdc(), img_len) != nullptr;
-  LOG_INFO("subcycle engine: drive A flux is "
+  const bool writable =
+      fdc_media_image_unit(b.machine.fdc(), unit, img_len) != nullptr;
+  LOG_INFO("subcycle engine: drive " << (unit == 0 ? "A" : "B")
+           << " flux is "
            << (writable ? "WRITABLE (DSK overlay synthesized)"
                         : "read-only (non-standard flux; not synthesizable)"));
 }
 
+// Attach a slot file to a drive at engine build. Every flux container
+// (.ipf/.raw/.scp/.hfe/.a2r) goes through the unified content-sniffing
+// dispatcher (flux::to_scp) into an in-memory SCP capture so the sub-cycle
+// FDC plays it as flux, weak bits included; .dsk keeps the legacy sector
+// path. Either drive takes either kind (fdc.cpp sel_media).
+void attach_slot_file(Bridge& b, uint8_t unit, const std::string& path) {
+  media::Buffer& buf = unit == 0 ? b.media : b.media_b;
+  const char* drive = unit == 0 ? "A" : "B";
+  std::string ext = lower_ext(path);  // the INNER extension for a .zip
+  bool flux = false;
+  if (ext == ".dsk") {
+    // A plain DSK maps copy-on-write: writes stay private until
+    // flush_dirty_media_unit persists the written tracks (fdc-device.md §10).
+    if (media::recover(path))
+      LOG_INFO("subcycle engine: finished an interrupted write-back to "
+               << path);
+    buf = media::Buffer::map(path);
+  } else {
+    std::vector<uint8_t> raw = read_media_file(path, ext);
+    flux = is_flux_ext(ext);
+    buf = media::Buffer(flux ? flux::to_scp(raw.data(), raw.size(), ext)
+                             : std::move(raw));
+  }
+  const bool ok =
+      !buf.empty() &&
+      (flux ? b.machine.insert_flux(buf.data(), buf.size(), unit)
+            : b.machine.insert_disk(buf.data(), buf.size(), unit));
+  if (ok) {
+    LOG_INFO("subcycle engine: drive " << drive << " <- " << path);
+    log_flux_writability(b, unit);  // self-gating: silent unless flux
+  } else {
+    LOG_ERROR("subcycle engine: cannot attach " << path << " to drive "
+                                                << drive);
+  }
+}
+
 }  // namespace
 
 bool subcycle_bridge_start() {
@@ -266,6 +315,9 @@ bool subcycle_bridge_start() {
     return false;
   }
   b.machine.set_overlay(&g_drive_overlay);  // drive sounds (self-gated on cfg)
+  // Per-cycle frames render the PSG and DACs on a worker thread — only where
+  // a spare core exists for it, else the handoff just adds context switches.
+  b.machine.set_audio_worker(std::thread::hardware_concurrency() > 2);
   if (model == 3 && pbCartridgeImage != nullptr) {
     // Plus: hand the memory device the WHOLE parsed CPR (32 x 16K banks, the
     // unused ones zeroed) so RMR2 / ROM-select can page any bank — not just the
@@ -348,7 +400,10 @@ bool subcycle_bridge_start() {
                                  g_symbiface.ide_slave.image_path.c_str()};
     for (int d = 0; d < 2; ++d) {
       if (keys[d][0] == '\0') continue;
-      b.ide_img[d] = read_file(keys[d]);
+      if (media::recover(keys[d]))
+        LOG_INFO("subcycle engine: finished an interrupted write-back to "
+                 << keys[d]);
+      b.ide_img[d] = media::Buffer::map(keys[d]);
       if (b.ide_img[d].size() >= 512) {
         b.ide_path[d] = keys[d];
         b.machine.symbiface_attach_ide(d, b.ide_img[d].data(),
@@ -370,49 +425,15 @@ bool subcycle_bridge_start() {
   if (b.fbsurf == nullptr)
     LOG_ERROR("subcycle engine: SDL_CreateSurfaceFrom: " << SDL_GetError());
 
-  if (!CPC.driveA.file.empty()) {
-    // Every flux container (.ipf/.raw/.scp/.hfe/.a2r) goes through the unified
-    // content-sniffing dispatcher (flux::to_scp) into an in-memory SCP capture
-    // so the sub-cycle FDC plays it as flux, weak bits included. .dsk keeps the
-    // legacy sector path. Flux is drive-A-only (fdc.cpp sel_media). For a
-    // CAPS-encoder IPF, to_scp mirrors the legacy driveA the slot loader
-    // already ipf_load-ed (loadSlots ran before subcycle_bridge_start).
-    std::string ext;  // the INNER extension when the slot file is a .zip
-    std::vector<uint8_t> raw = read_media_file(CPC.driveA.file, ext);
-    const bool flux = is_flux_ext(ext);
-    if (flux) {
-      b.media = flux::to_scp(raw.data(), raw.size(), ext);
-    } else {
-      b.media = std::move(raw);
-    }
-    const bool ok =
-        !b.media.empty() &&
-        (flux ? b.machine.insert_flux(b.media.data(), b.media.size())
-              : b.machine.insert_disk(b.media.data(), b.media.size()));
-    if (ok) {
-      LOG_INFO("subcycle engine: drive A <- " << CPC.driveA.file);
-      log_flux_writability(b);  // self-gating: silent unless drive A is flux
-    } else {
-      LOG_ERROR("subcycle engine: cannot attach " << CPC.driveA.file);
-    }
-  }
-
-  // Drive B (unit 1): DSK only — the CPC's second drive has no flux path, and
-  // the FDC's flux capture is drive-A-only (fdc.cpp sel_media). Loaded at
-  // engine build when the app already routed a second image to CPC.driveB
-  // (two-disk CLI, config slot_b). Runtime hot-swap into B is a separate
-  // follow-up (PendingMedia carries no unit yet — beads-xsdc).
-  if (!CPC.driveB.file.empty() && !ends_with(CPC.driveB.file, ".scp")) {
-    std::string ext_b;
-    b.media_b = read_media_file(CPC.driveB.file, ext_b);
-    if (!b.media_b.empty() &&
-        b.machine.insert_disk(b.media_b.data(), b.media_b.size(), 1)) {
-      LOG_INFO("subcycle engine: drive B <- " << CPC.driveB.file);
-    } else {
-      LOG_ERROR("subcycle engine: cannot attach " << CPC.driveB.file
-                                                  << " to drive B");
-    }
-  }
+  // Decoded flux tracks, both drives together (fdc-device.md §7b): the
+  // Machine default unless KONCPC_FLUX_CACHE_MB pins it (0 = the FDC's
+  // small built-in cache).
+  if (const char* mb = std::getenv("KONCPC_FLUX_CACHE_MB"))
+    b.machine.set_flux_cache_budget(std::strtoul(mb, nullptr, 10) << 20);
+  // Drive B (unit 1) loads when the app already routed a second image to
+  // CPC.driveB (two-disk CLI, config slot_b).
+  if (!CPC.driveA.file.empty()) attach_slot_file(b, 0, CPC.driveA.file);
+  if (!CPC.driveB.file.empty()) attach_slot_file(b, 1, CPC.driveB.file);
 
   // Firmware-vector taps: re-register the app's already-installed console
   // hooks (telnet TXT_OUTPUT / CP/M BDOS) as machine taps — registers still
@@ -567,6 +588,18 @@ int subcycle_bridge_bench_fps(int tier) {
   return g_bridge.bench_fps[tier].load(std::memory_order_relaxed);
 }
 
+void subcycle_bridge_set_hash_only(bool on) {
+  g_bridge.hash_only_want.store(on ? 1 : 0, std::memory_order_release);
+}
+
+bool subcycle_bridge_hash_only() {
+  return g_bridge.hash_only_on.load(std::memory_order_acquire);
+}
+
+uint32_t subcycle_bridge_frame_hash() {
+  return g_bridge.frame_hash.load(std::memory_order_acquire);
+}
+
 subcycle::Machine* subcycle_bridge_machine() {
   return g_bridge.active ? &g_bridge.machine : nullptr;
 }
@@ -645,6 +678,7 @@ void sync_serial_backend(Bridge& b) {
 // existing checkboxes drive the sub-cycle Devices unchanged.
 void sync_peripheral_flags(Bridge& b) {
   b.machine.set_digiblaster(CPC.snd_pp_device != 0);  // printer-device.md §3
+  b.machine.set_tape_flash(CPC.tape_flash_load != 0);  // tape-device.md §8
   // Printer /BUSY strap (PPI Port B bit 6): READY while a virtual printer is
   // attached ([printer] config), busy like an unconnected Centronics port
   // otherwise. Without this the firmware's print-wait loop (MC WAIT PRINTER)
@@ -919,6 +953,8 @@ int subcycle_bridge_debug_sync() {
       imgui_state.tape_current_block = static_cast<int>(tr.block) >= nblk
                                            ? nblk - 1
                                            : static_cast<int>(tr.block);
+      imgui_state.tape_ms = static_cast<uint32_t>(tr.cycle / 16000);
+      imgui_state.tape_total_ms = static_cast<uint32_t>(tr.total / 16000);
     }
   }
 
@@ -1062,15 +1098,24 @@ void flush_sf2_ide(Bridge& b) {
   if (!b.machine.symbiface_dirty()) return;  // symbiface-device.md §2
   for (int d = 0; d < 2; ++d) {
     if (b.ide_path[d].empty() || b.ide_img[d].empty()) continue;
-    FILE* f = fopen(b.ide_path[d].c_str(), "wb");
-    if (f == nullptr) {
-      LOG_ERROR("subcycle engine: cannot write back IDE image "
-                << b.ide_path[d]);
+    // Only the regions WRITE SECTORS touched go back, journaled.
+    uint32_t per = 1;
+    const uint8_t* map = b.machine.symbiface_written(d, &per);
+    const std::vector<media::Range> ranges =
+        media::region_ranges(map, SF2_DIRTY_REGIONS, per, b.ide_img[d].size());
+    if (!b.ide_img[d].backs(b.ide_path[d])) {
+      LOG_ERROR("subcycle engine: " << b.ide_path[d]
+                << " changed on disk since it was attached — IDE write-back "
+                   "skipped");
+      continue;
+    }
+    std::string err;
+    if (!media::write_back(b.ide_path[d], b.ide_img[d].data(),
+                           b.ide_img[d].size(), ranges, err)) {
+      LOG_ERROR("subcycle engine: IDE write-back failed: " << err);
       continue;
     }
-    const size_t n = fwrite(b.ide_img[d].data(), 1, b.ide_img[d].size(), f);
-    if (fclose(f) != 0 || n != b.ide_img[d].size())
-      LOG_ERROR("subcycle engine: short write saving IDE " << b.ide_path[d]);
+    b.ide_img[d].restamp(b.ide_path[d]);
   }
   b.machine.symbiface_mark_clean();
 }
@@ -1081,6 +1126,7 @@ void subcycle_bridge_stop() {
   flush_dirty_media_unit(b, 0);  // shutdown: both discs keep their writes
   flush_dirty_media_unit(b, 1);
   flush_sf2_ide(b);  // and the IDE images keep theirs
+  b.machine.stop_flux_predecode();  // b.media dies before b.machine
   if (g_silicon_disc.enabled && g_silicon_disc.data != nullptr)
     b.machine.silicon_disc_save(g_silicon_disc.data, SILICON_DISC_SIZE);
   if (b.fbsurf != nullptr) {
@@ -1208,40 +1254,49 @@ namespace {
 
 // Shared write-back core for drive A and drive B.
 void flush_dirty_media_unit(Bridge& b, uint8_t unit) {
-  std::vector<uint8_t>& buf = unit == 0 ? b.media : b.media_b;
+  media::Buffer& buf = unit == 0 ? b.media : b.media_b;
   const std::string& path = unit == 0 ? CPC.driveA.file : CPC.driveB.file;
   bool& altered = unit == 0 ? driveA.altered : driveB.altered;
   const char* label = unit == 0 ? "drive A" : "drive B";
   if (fdc_media_dirty_unit(b.machine.fdc(), unit) == 0) return;
   if (buf.empty() || path.empty()) return;
-  // A dirty writable-flux disc (drive A) must be re-encoded to a flux container
+  // A dirty writable-flux disc must be re-encoded to a flux container
   // (scp_from_disk over the dirty map) before write-back — the format-picker UI
   // is Stage 4. `buf` here is the pristine SCP, so writing it back would
   // clobber the file with the *unmodified* capture; skip until export lands.
-  if (unit == 0) {
-    size_t scp_len = 0;
-    if (fdc_media_flux_scp(b.machine.fdc(), scp_len) != nullptr) {
-      LOG_INFO(
-          "subcycle engine: drive A flux write-back deferred to export "
-          "(Stage 4) — writes are live in the overlay");
-      return;
-    }
+  size_t scp_len = 0;
+  if (fdc_media_flux_scp(b.machine.fdc(), scp_len, unit) != nullptr) {
+    LOG_INFO("subcycle engine: " << label
+             << " flux write-back deferred to export "
+                "(Stage 4) — writes are live in the overlay");
+    return;
   }
-  FILE* f = fopen(path.c_str(), "wb");
-  if (f == nullptr) {
-    LOG_ERROR("subcycle engine: cannot write back " << label << " DSK to "
-                                                    << path);
+  // Only the tracks the FDC wrote go back, through the journal (a file whose
+  // size no longer matches is rewritten whole).
+  int ntracks = 0;
+  const uint8_t* written =
+      fdc_media_written_tracks(b.machine.fdc(), ntracks, unit);
+  const std::vector<media::Range> ranges =
+      media::dsk_track_ranges(buf.data(), buf.size(), written, ntracks);
+  // The mapping only speaks for the file it was made from: one truncated,
+  // replaced or edited since would get a patch over contents the image never
+  // saw (or fault on its untouched pages). Keep the writes in memory instead.
+  if (!buf.backs(path)) {
+    LOG_ERROR("subcycle engine: " << path << " changed on disk since "
+              << label << " attached it — write-back skipped");
     return;
   }
-  const size_t n = fwrite(buf.data(), 1, buf.size(), f);
-  if (fclose(f) != 0 || n != buf.size()) {
-    LOG_ERROR("subcycle engine: short write saving " << label << " DSK to "
-                                                     << path);
+  std::string err;
+  if (!media::write_back(path, buf.data(), buf.size(), ranges, err)) {
+    LOG_ERROR("subcycle engine: cannot write back " << label << " DSK to "
+                                                    << path << ": " << err);
     return;
   }
+  buf.restamp(path);
   fdc_media_mark_clean_unit(b.machine.fdc(), unit);
   altered = false;
-  LOG_INFO("subcycle engine: " << label << " DSK written back to " << path);
+  LOG_INFO("subcycle engine: " << label << " DSK written back to " << path
+                               << " (" << ranges.size() << " track runs)");
 }
 
 void apply_pending_media(Bridge& b) {
@@ -1251,22 +1306,17 @@ void apply_pending_media(Bridge& b) {
   const PendingMedia kind = b.swap_kind.exchange(PendingMedia::kNone);
   const uint8_t unit = b.swap_unit.exchange(0, std::memory_order_acq_rel);
   const char* drive = unit == 0 ? "A" : "B";
-  std::vector<uint8_t>& buf = unit == 0 ? b.media : b.media_b;
+  media::Buffer& buf = unit == 0 ? b.media : b.media_b;
   switch (kind) {
     case PendingMedia::kDisk:
     case PendingMedia::kFlux: {
-      if (kind == PendingMedia::kFlux && unit != 0) {
-        // Reject BEFORE touching buf: the FDC still holds the current
-        // drive-B buffer, and replacing it here would dangle that pointer.
-        LOG_ERROR("subcycle engine: flux is drive-A-only — swap ignored");
-        b.swap_bytes.clear();
-        break;
-      }
       flush_dirty_media_unit(b, unit);  // the outgoing disc keeps its writes
-      buf = std::move(b.swap_bytes);
-      const bool ok = (kind == PendingMedia::kFlux)
-                          ? b.machine.insert_flux(buf.data(), buf.size())
-                          : b.machine.insert_disk(buf.data(), buf.size(), unit);
+      b.machine.stop_flux_predecode(unit);  // it still reads buf
+      buf = media::Buffer(std::move(b.swap_bytes));
+      const bool ok =
+          (kind == PendingMedia::kFlux)
+              ? b.machine.insert_flux(buf.data(), buf.size(), unit)
+              : b.machine.insert_disk(buf.data(), buf.size(), unit);
       if (ok) {
         LOG_INFO("subcycle engine: drive "
                  << drive << " hot-swapped (" << buf.size() << " bytes"
@@ -1304,8 +1354,72 @@ void apply_pending_media(Bridge& b) {
   }
 }
 
+// Drift-corrected wall-clock pacing: wait out the deadline, then move it on
+// by `ticks` (the legacy limiter only paces EC_CYCLE_COUNT exits, which this
+// engine never emits).
+void pace_deadline(Bridge& b, uint64_t ticks) {
+  const uint64_t freq = SDL_GetPerformanceFrequency();
+  uint64_t now = SDL_GetPerformanceCounter();
+  if (b.next_deadline == 0 || now > b.next_deadline + (freq / 4))
+    b.next_deadline = now;  // (re)sync after start, pause, or a long stall
+  while (now < b.next_deadline) {
+    const uint64_t remaining_ms = (b.next_deadline - now) * 1000 / freq;
+    SDL_Delay(remaining_ms > 2 ? static_cast<Uint32>(remaining_ms - 1) : 0);
+    now = SDL_GetPerformanceCounter();
+  }
+  b.next_deadline += ticks;
+}
+
+// Hand a frame's or slice's audio to the IPC tap, if one is attached.
+void feed_audio_tap(Bridge& b, const std::vector<int16_t>& audio) {
+  auto* const tap = b.audio_tap.load(std::memory_order_acquire);
+  if (tap != nullptr && !audio.empty())
+    tap(b.audio_tap_ctx.load(std::memory_order_relaxed), audio.data(),
+        audio.size());
+}
+
+// One frame as slices: each slice's audio goes straight to the sink and is
+// paced by the emulated time it covered (16 master cycles per µs), so the
+// device hears it within a slice of the machine making it.
+void run_frame_sliced(Bridge& b) {
+  const uint64_t freq = SDL_GetPerformanceFrequency();
+  const BridgeSliceIO& io = b.slice_io;
+  for (;;) {
+    const uint64_t m0 = b.machine.master_cycle();
+    const bool done = b.machine.run_slice(b.slice_us);
+    const std::vector<int16_t>& audio = b.machine.audio();
+    if (io.audio != nullptr && !audio.empty())
+      io.audio(io.ctx, audio.data(), audio.size());
+    feed_audio_tap(b, audio);
+    pace_deadline(b, freq * (b.machine.master_cycle() - m0) / 16000000);
+    if (done || b.machine.probe_hit(nullptr)) return;  // hit: as run_frame
+    if (io.rows != nullptr) {
+      uint8_t rows[16];
+      io.rows(io.ctx, rows);
+      for (uint8_t row = 0; row < 16; ++row)
+        b.machine.set_key_row(row, rows[row]);
+    }
+  }
+}
+
 }  // namespace
 
+// NOLINTNEXTLINE(misc-use-internal-linkage): external API (kon_cpc_ja.cpp)
+void subcycle_bridge_set_slicing(uint32_t us, const BridgeSliceIO& io) {
+  g_bridge.slice_us = us;
+  g_bridge.slice_io = io;
+}
+
+// NOLINTNEXTLINE(misc-use-internal-linkage): external API (IPC server)
+void subcycle_bridge_set_audio_tap(void (*tap)(void* ctx,
+                                               const int16_t* samples,
+                                               size_t count),
+                                   void* ctx) {
+  g_bridge.audio_tap.store(nullptr, std::memory_order_release);
+  g_bridge.audio_tap_ctx.store(ctx, std::memory_order_relaxed);
+  g_bridge.audio_tap.store(tap, std::memory_order_release);
+}
+
 // NOLINTNEXTLINE(misc-use-internal-linkage): external API consumed by other
 // translation units/tests; internal linkage would break the link
 const std::vector<int16_t>& subcycle_bridge_frame(const uint8_t rows[16],
@@ -1362,6 +1476,11 @@ const std::vector<int16_t>& subcycle_bridge_frame(const uint8_t rows[16],
   }
 
   apply_pending_media(b);  // hot-swaps land between frames, never mid-tick
+  if (const int want = b.hash_only_want.exchange(-1, std::memory_order_acq_rel);
+      want >= 0) {
+    b.machine.set_hash_only(want != 0);
+    b.hash_only_on.store(want != 0, std::memory_order_release);
+  }
   if (b.mf2_stop.exchange(false, std::memory_order_acq_rel))
     b.machine.mf2_stop_button();  // the red button, between frames
 
@@ -1392,28 +1511,54 @@ const std::vector<int16_t>& subcycle_bridge_frame(const uint8_t rows[16],
     if (b.machine.run_tier() != want) b.machine.set_run_tier(want);
   }
 
-  b.machine.run_frame();
-
-  blit_fb(b, dst);
+  // Only frames that will be shown are painted: a capped run shows every
+  // frame; an uncapped one only those subcycle_bridge_present_due() picked
+  // (dst set). The rest keep exact timing with the pixel path off.
+  b.machine.set_skip_paint(!limit && dst == nullptr);
+  const bool sliced = limit && b.slice_us != 0;
+  if (sliced) {
+    run_frame_sliced(b);  // paces as it goes
+  } else {
+    b.machine.run_frame();
+    const std::vector<int16_t>& audio = b.machine.audio();
+    feed_audio_tap(b, audio);
+  }
 
-  if (limit) {  // drift-corrected 50 Hz deadline (the legacy limiter only
-                // paces EC_CYCLE_COUNT exits, which this engine never emits)
-    const uint64_t freq = SDL_GetPerformanceFrequency();
-    const uint64_t tick = freq / 50;
-    uint64_t now = SDL_GetPerformanceCounter();
-    if (b.next_deadline == 0 || now > b.next_deadline + (freq / 4))
-      b.next_deadline = now;  // (re)sync after start, pause, or a long stall
-    while (now < b.next_deadline) {
-      const uint64_t remaining_ms = (b.next_deadline - now) * 1000 / freq;
-      SDL_Delay(remaining_ms > 2 ? static_cast<Uint32>(remaining_ms - 1) : 0);
-      now = SDL_GetPerformanceCounter();
-    }
-    b.next_deadline += tick;
+  if (b.machine.hash_only()) {  // nothing painted: keep the last picture up
+    b.frame_hash.store(b.machine.frame_hash(), std::memory_order_release);
   } else {
+    blit_fb(b, dst);
+  }
+
+  if (!limit) {
     b.next_deadline = 0;
+  } else if (!sliced) {  // drift-corrected 50 Hz deadline
+    pace_deadline(b, SDL_GetPerformanceFrequency() / 50);
   }
 
-  return b.machine.audio();
+  return sliced ? g_empty_audio : b.machine.audio();
+}
+
+// NOLINTNEXTLINE(misc-use-internal-linkage): external API (kon_cpc_ja.cpp)
+bool subcycle_bridge_present_due(bool limit) {
+  Bridge& b = g_bridge;
+  // The host's present rate bounds what an uncapped run can show; a 144 Hz
+  // panel gets 144 painted frames, a 50 Hz one 50.
+  uint64_t period = b.present_period.load(std::memory_order_relaxed);
+  if (period == 0) period = SDL_GetPerformanceFrequency() / 60;
+  const uint64_t now = SDL_GetPerformanceCounter();
+  if (!limit && now - b.last_present < period) return false;
+  b.last_present = now;
+  return true;
+}
+
+// NOLINTNEXTLINE(misc-use-internal-linkage): external API (kon_cpc_ja.cpp)
+void subcycle_bridge_set_display_hz(float hz) {
+  if (hz < 24.0f || hz > 500.0f) hz = 60.0f;
+  g_bridge.present_period.store(
+      static_cast<uint64_t>(
+          static_cast<double>(SDL_GetPerformanceFrequency()) / hz),
+      std::memory_order_relaxed);
 }
 
 /* Re-blit the machine's CURRENT framebuffer without running a frame (the IPC
@@ -1423,6 +1568,12 @@ void subcycle_bridge_repaint(SDL_Surface* dst) {
   if (b.active) blit_fb(b, dst);
 }
 
+// NOLINTNEXTLINE(misc-use-internal-linkage): external API (IPC server)
+const uint8_t* subcycle_bridge_framebuffer() {
+  Bridge& b = g_bridge;
+  return b.active && !b.fb.empty() ? b.fb.data() : nullptr;
+}
+
 namespace {
 void blit_fb(Bridge& b, SDL_Surface* dst) {
   if (dst != nullptr && b.fbsurf != nullptr) {
@@ -11,6 +11,7 @@
 #ifndef KONCPC_SUBCYCLE_BRIDGE_H
 #define KONCPC_SUBCYCLE_BRIDGE_H
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -42,14 +43,68 @@ void subcycle_bridge_stop();
 
 /* Run one emulated frame: rows[16] is the published keyboard matrix (bit
  * clear = pressed); dst receives the picture (scaled blit, may be null);
- * limit paces to the 50 Hz wall clock with drift correction. Returns the
+ * limit paces to the 50 Hz wall clock with drift correction. Uncapped
+ * (limit false) frames with a null dst are not painted at all — frame
+ * skipping; the machine framebuffer keeps the last shown frame. Returns the
  * frame's interleaved stereo s16 44 100 Hz samples. */
 const std::vector<int16_t>& subcycle_bridge_frame(const uint8_t rows[16],
                                                   SDL_Surface* dst, bool limit);
 
+/* Sub-frame slicing for paced (limit) frames: with us > 0 each frame runs as
+ * us-microsecond machine slices, each paced to its own share of the wall
+ * clock. After every slice io.audio receives that slice's samples and
+ * io.rows (when set) refreshes the keyboard matrix, so sound reaches the
+ * device a few ms after it is made and key presses land mid-frame; the
+ * frame's picture and sound otherwise match a whole run (Machine::run_until
+ * says what each tier promises). subcycle_bridge_frame then
+ * returns no audio — the sink had it all. 0 restores whole frames; uncapped
+ * runs always take whole frames. Z80 thread only. */
+struct BridgeSliceIO {
+  void (*audio)(void* ctx, const int16_t* samples, size_t count) = nullptr;
+  void (*rows)(void* ctx, uint8_t rows[16]) = nullptr;
+  void* ctx = nullptr;
+};
+void subcycle_bridge_set_slicing(uint32_t us, const BridgeSliceIO& io);
+
+/* A second listener for the machine's audio (the IPC binary mode's audio
+ * blocks): every sample a frame or slice makes is also handed to `tap`,
+ * whether or not the sound device plays it. Null detaches. Any thread: the
+ * IPC arms it from whichever thread runs the command; `tap` is called on the
+ * emulation thread and may still run once with the old ctx while a detach
+ * lands. */
+void subcycle_bridge_set_audio_tap(void (*tap)(void* ctx,
+                                               const int16_t* samples,
+                                               size_t count),
+                                   void* ctx);
+
+/* Frame-skip policy for the caller's dst choice: true when this frame should
+ * be shown (always when limit; uncapped, once per host present period — the
+ * display's refresh rate, so N−1 of every N frames skip the pixel path at
+ * whatever N the engine's speed makes). */
+bool subcycle_bridge_present_due(bool limit);
+
+/* The host display's refresh rate, for subcycle_bridge_present_due(). SDL
+ * display queries are main-thread only, so the main thread publishes it (at
+ * start-up and when the window's display or mode changes); implausible or
+ * unknown rates (<24 or >500 Hz, 0) mean 60. Any thread. */
+void subcycle_bridge_set_display_hz(float hz);
+
 /* Re-blit the CURRENT framebuffer without running a frame (IPC "repaint"). */
 void subcycle_bridge_repaint(SDL_Surface* dst);
 
+/* The machine's own RGB24 framebuffer, subcycle::kFbWidth x kFbHeight x 3 —
+ * the last painted frame, unscaled — or null when the engine is inactive.
+ * Read it between frames (emulation thread). */
+const uint8_t* subcycle_bridge_framebuffer();
+
+/* Render-less mode for CI hash runs (IPC "hash render"): frames keep exact
+ * timing but paint and blit nothing; each frame's render inputs fold into a
+ * hash instead. Thread-safe request, applied at the next frame boundary.
+ * frame_hash() is the last completed frame's (0 before the first). */
+void subcycle_bridge_set_hash_only(bool on);
+bool subcycle_bridge_hash_only();
+uint32_t subcycle_bridge_frame_hash();
+
 /* Media hot-swap. Thread-safe: callable from the main/UI thread
  * while the emulation runs — the swap is deferred and applied by the Z80
  * thread at the next frame boundary (the FDC's media is live wiring; it must
@@ -84,7 +139,7 @@ void subcycle_bridge_eject_tape();
 
 /* Deferred tape block-seek: the tape UI (render thread) requests a jump to the
  * Nth CDT block; the Z80 thread applies it at the next frame boundary (the deck
- * is live wiring). The deck walks its own cdt to the ordinal —
+ * is live wiring). The deck jumps through its own block index —
  * layout-independent. */
 void subcycle_bridge_request_tape_seek(uint32_t block_ordinal);
 
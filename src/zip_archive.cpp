@@ -1,7 +1,8 @@
 /* zip_archive — see zip_archive.h. Authored from the PKWARE APPNOTE
  * (sections 4.3.6/4.3.7/4.3.12/4.3.16): scan back to the End Of Central
  * Directory record, walk the central directory for extension matches, and
- * inflate (or copy, for stored entries) from the local header on extract. */
+ * inflate (or copy, for stored entries) from the local header on extract.
+ * Both steps go through the stamp-keyed LRU described in the header. */
 
 #include "zip_archive.h"
 
@@ -15,10 +16,15 @@
 #include <windows.h>  // MAX_PATH for the named-temporary path in extract()
 #endif
 
+#include <sys/stat.h>
 #include <zlib.h>
 
+#include <algorithm>
 #include <cerrno>
+#include <cstdint>
 #include <cstring>
+#include <list>
+#include <mutex>
 
 #include "errors.h"
 #include "log.h"
@@ -55,14 +61,79 @@ bool name_matches(const byte* name, word name_len, const std::string& exts) {
   return false;
 }
 
-}  // namespace
+// Identity of an archive on disk. The mtime alone is too coarse: a same-size
+// rewrite within its 1 s granularity would keep the stamp, so the key also
+// takes its nanoseconds (where stat has them), the inode (a save-by-rename
+// replaces it) and the ctime (any write or rename bumps it).
+struct Stamp {
+  std::string path;
+  int64_t size = -1;
+  int64_t mtime = 0;
+  int64_t mtime_ns = 0;
+  int64_t ctime = 0;
+  uint64_t inode = 0;
+  bool operator==(const Stamp& o) const {
+    return size == o.size && mtime == o.mtime && mtime_ns == o.mtime_ns &&
+           ctime == o.ctime && inode == o.inode && path == o.path;
+  }
+};
 
-namespace zip {
+bool stamp_of(const std::string& path, Stamp& out) {
+  struct stat st {};
+  if (stat(path.c_str(), &st) != 0) return false;
+  out.path = path;
+  out.size = static_cast<int64_t>(st.st_size);
+  out.mtime = static_cast<int64_t>(st.st_mtime);
+#if defined(__APPLE__)
+  out.mtime_ns = static_cast<int64_t>(st.st_mtimespec.tv_nsec);
+#elif !defined(_WIN32)
+  out.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_nsec);
+#endif
+  out.ctime = static_cast<int64_t>(st.st_ctime);
+  out.inode = static_cast<uint64_t>(st.st_ino);
+  return true;
+}
 
-int dir(t_zip_info* zi) {
-  FILE* f = fopen(zi->filename.c_str(), "rb");
+// The whole central directory of one archive (name, local-header offset),
+// unfiltered: dir() applies each caller's extension list on top.
+struct CachedDir {
+  Stamp stamp;
+  std::vector<std::pair<std::string, dword>> entries;
+};
+
+struct CachedEntry {
+  Stamp stamp;
+  dword offset = 0;
+  std::vector<byte> bytes;
+};
+
+constexpr size_t kDirCacheSlots = 4;
+// Room for every disc of a typical multi-disc archive (~200K each).
+constexpr size_t kEntryCacheBytes = size_t{16} << 20;
+
+std::mutex g_cache_mutex;
+std::list<CachedDir> g_dirs;        // most recently used first
+std::list<CachedEntry> g_entries;   // most recently used first
+size_t g_entry_bytes = 0;
+
+void cache_entry(const Stamp& stamp, dword offset,
+                 const std::vector<byte>& bytes) {
+  if (bytes.size() > kEntryCacheBytes) return;
+  std::scoped_lock const lock(g_cache_mutex);
+  g_entries.push_front({stamp, offset, bytes});
+  g_entry_bytes += bytes.size();
+  while (g_entry_bytes > kEntryCacheBytes) {
+    g_entry_bytes -= g_entries.back().bytes.size();
+    g_entries.pop_back();
+  }
+}
+
+// Read and walk the central directory of `filename` into `out`.
+int read_directory(const std::string& filename,
+                   std::vector<std::pair<std::string, dword>>& out) {
+  FILE* f = fopen(filename.c_str(), "rb");
   if (f == nullptr) {
-    LOG_ERROR("File not found or not readable: " << zi->filename);
+    LOG_ERROR("File not found or not readable: " << filename);
     return ERR_FILE_NOT_FOUND;
   }
   auto closer = [&]() { fclose(f); };
@@ -71,7 +142,7 @@ int dir(t_zip_info* zi) {
   if (fseek(f, 0, SEEK_END) != 0) return ERR_FILE_BAD_ZIP;
   const long file_len = ftell(f);
   if (file_len < static_cast<long>(kEocdLen)) {
-    LOG_ERROR("Couldn't read zip file (too short): " << zi->filename);
+    LOG_ERROR("Couldn't read zip file (too short): " << filename);
     return ERR_FILE_BAD_ZIP;
   }
 
@@ -81,7 +152,7 @@ int dir(t_zip_info* zi) {
   std::vector<byte> tail(static_cast<size_t>(tail_len));
   if (fseek(f, file_len - tail_len, SEEK_SET) != 0 ||
       fread(tail.data(), tail.size(), 1, f) != 1) {
-    LOG_ERROR("Couldn't read zip file: " << zi->filename);
+    LOG_ERROR("Couldn't read zip file: " << filename);
     return ERR_FILE_BAD_ZIP;
   }
   long eocd = -1;
@@ -93,7 +164,7 @@ int dir(t_zip_info* zi) {
   }
   if (eocd < 0) {
     LOG_ERROR(
-        "Couldn't read zip file (no central directory): " << zi->filename);
+        "Couldn't read zip file (no central directory): " << filename);
     return ERR_FILE_BAD_ZIP;
   }
   const word entries = le16(tail.data() + eocd + 10);
@@ -101,18 +172,18 @@ int dir(t_zip_info* zi) {
   const dword cd_offset = le32(tail.data() + eocd + 16);
   if (cd_size == 0 || entries == 0) {
     LOG_ERROR(
-        "Couldn't read zip file (no central directory): " << zi->filename);
+        "Couldn't read zip file (no central directory): " << filename);
     return ERR_FILE_BAD_ZIP;
   }
   if (static_cast<long>(cd_size) > file_len) {  // corrupt: larger than file
-    LOG_ERROR("Couldn't read zip file (bad directory size): " << zi->filename);
+    LOG_ERROR("Couldn't read zip file (bad directory size): " << filename);
     return ERR_FILE_BAD_ZIP;
   }
 
   std::vector<byte> cd(cd_size);
   if (fseek(f, static_cast<long>(cd_offset), SEEK_SET) != 0 ||
       fread(cd.data(), cd.size(), 1, f) != 1) {
-    LOG_ERROR("Couldn't read zip file: " << zi->filename);
+    LOG_ERROR("Couldn't read zip file: " << filename);
     return ERR_FILE_BAD_ZIP;
   }
 
@@ -125,68 +196,42 @@ int dir(t_zip_info* zi) {
     const word comment_len = le16(p + 32);
     const dword local_off = le32(p + 42);
     if (p + 46 + name_len > end) break;  // name runs past the directory
-    if (name_matches(p + 46, name_len, zi->extensions)) {
-      zi->filesOffsets.emplace_back(
-          std::string(reinterpret_cast<const char*>(p + 46), name_len),
-          local_off);
-      zi->dwOffset = local_off;
-    }
+    out.emplace_back(
+        std::string(reinterpret_cast<const char*>(p + 46), name_len),
+        local_off);
     p += 46 + name_len + extra_len + comment_len;
   }
-
-  if (zi->filesOffsets.empty()) {
-    LOG_ERROR("Empty zip file: " << zi->filename);
-    return ERR_FILE_EMPTY_ZIP;
-  }
   return 0;
 }
 
-int extract(const t_zip_info& zi, FILE** pfileOut) {
-#ifdef WINDOWS
-  // Windows tmpfile() wants the root directory; use a named temporary.
-  char tmpFilePath[MAX_PATH];
-  snprintf(tmpFilePath, sizeof(tmpFilePath), ".\\koncpc_tmp_XXXXXX");
-  if (_mktemp_s(tmpFilePath, strlen(tmpFilePath) + 1) != 0) {
-    LOG_ERROR("Couldn't unzip file: Couldn't generate temporary file name: "
-              << strerror(errno));
-    return ERR_FILE_UNZIP_FAILED;
-  }
-  *pfileOut = fopen(tmpFilePath, "w+b");
-#else
-  *pfileOut = tmpfile();
-#endif
-  if (*pfileOut == nullptr) {
-    LOG_ERROR("Couldn't unzip file: Couldn't create temporary file: "
-              << strerror(errno));
-    return ERR_FILE_UNZIP_FAILED;
-  }
-  auto fail = [&]() {
-    fclose(*pfileOut);
-    *pfileOut = nullptr;
-    return ERR_FILE_UNZIP_FAILED;
-  };
-
-  FILE* in = fopen(zi.filename.c_str(), "rb");
+// Stream the entry whose local header sits at `offset` through
+// `sink(bytes, n)` (false = abort). `size_hint` receives the local header's
+// uncompressed size (0 with a data descriptor) before the first chunk.
+template <typename Sink>
+int inflate_entry(const std::string& filename, dword offset, size_t& size_hint,
+                  Sink&& sink) {
+  FILE* in = fopen(filename.c_str(), "rb");
   if (in == nullptr) {
-    LOG_ERROR("Couldn't open zip file for reading: " << zi.filename);
-    return fail();
+    LOG_ERROR("Couldn't open zip file for reading: " << filename);
+    return ERR_FILE_UNZIP_FAILED;
   }
   auto closer = [&]() { fclose(in); };
   memutils::scope_exit<decltype(closer)> const cs(closer);
 
   byte hdr[30];
-  if (fseek(in, static_cast<long>(zi.dwOffset), SEEK_SET) != 0 ||
+  if (fseek(in, static_cast<long>(offset), SEEK_SET) != 0 ||
       fread(hdr, sizeof(hdr), 1, in) != 1 || le32(hdr) != kLocalSig) {
-    LOG_ERROR("Couldn't read zip file: " << zi.filename);
-    return fail();
+    LOG_ERROR("Couldn't read zip file: " << filename);
+    return ERR_FILE_UNZIP_FAILED;
   }
   const word method = le16(hdr + 8);       // 0 = stored, 8 = deflate
   const dword comp_size = le32(hdr + 18);  // 0 with a data descriptor (bit 3)
+  size_hint = le32(hdr + 22);
   const long data_off =
-      static_cast<long>(zi.dwOffset) + 30 + le16(hdr + 26) + le16(hdr + 28);
+      static_cast<long>(offset) + 30 + le16(hdr + 26) + le16(hdr + 28);
   if (fseek(in, data_off, SEEK_SET) != 0) {
-    LOG_ERROR("Couldn't read zip file: " << zi.filename);
-    return fail();
+    LOG_ERROR("Couldn't read zip file: " << filename);
+    return ERR_FILE_UNZIP_FAILED;
   }
 
   std::vector<byte> ibuf(16384), obuf(16384);
@@ -196,18 +241,15 @@ int extract(const t_zip_info& zi, FILE** pfileOut) {
     while (left > 0) {
       const size_t want = left < ibuf.size() ? left : ibuf.size();
       if (fread(ibuf.data(), want, 1, in) != 1) {
-        LOG_ERROR("Couldn't unzip file (truncated): " << zi.filename);
-        return fail();
-      }
-      if (fwrite(ibuf.data(), want, 1, *pfileOut) != 1) {
-        LOG_ERROR("Couldn't unzip file: Couldn't write to output file");
-        return fail();
+        LOG_ERROR("Couldn't unzip file (truncated): " << filename);
+        return ERR_FILE_UNZIP_FAILED;
       }
+      if (!sink(ibuf.data(), want)) return ERR_FILE_UNZIP_FAILED;
       left -= static_cast<dword>(want);
     }
   } else if (method == 8) {  // deflate: raw stream (no zlib header)
     z_stream z{};
-    if (inflateInit2(&z, -MAX_WBITS) != Z_OK) return fail();
+    if (inflateInit2(&z, -MAX_WBITS) != Z_OK) return ERR_FILE_UNZIP_FAILED;
     auto zend = [&]() { inflateEnd(&z); };
     memutils::scope_exit<decltype(zend)> const zs(zend);
 
@@ -231,25 +273,146 @@ int extract(const t_zip_info& zi, FILE** pfileOut) {
         z.avail_out = static_cast<uInt>(obuf.size());
         status = inflate(&z, Z_NO_FLUSH);
         const size_t produced = obuf.size() - z.avail_out;
-        if (produced != 0 && fwrite(obuf.data(), produced, 1, *pfileOut) != 1) {
-          LOG_ERROR("Couldn't unzip file: Couldn't write to output file");
-          return fail();
-        }
+        if (produced != 0 && !sink(obuf.data(), produced))
+          return ERR_FILE_UNZIP_FAILED;
       }
     }
     if (status != Z_STREAM_END) {
-      LOG_ERROR("Couldn't unzip file: " << zi.filename << " (" << status
-                                        << ")");
-      return fail();
+      LOG_ERROR("Couldn't unzip file: " << filename << " (" << status << ")");
+      return ERR_FILE_UNZIP_FAILED;
     }
   } else {
     LOG_ERROR("Couldn't unzip file: unsupported compression method " << method
                                                                      << ")");
-    return fail();
+    return ERR_FILE_UNZIP_FAILED;
+  }
+  return 0;
+}
+
+}  // namespace
+
+namespace zip {
+
+int dir(t_zip_info* zi) {
+  Stamp stamp;
+  const bool stamped = stamp_of(zi->filename, stamp);
+  std::vector<std::pair<std::string, dword>> entries;
+  bool hit = false;
+  if (stamped) {
+    std::scoped_lock const lock(g_cache_mutex);
+    for (auto it = g_dirs.begin(); it != g_dirs.end(); ++it) {
+      if (!(it->stamp == stamp)) continue;
+      g_dirs.splice(g_dirs.begin(), g_dirs, it);
+      entries = it->entries;
+      hit = true;
+      break;
+    }
+  }
+  if (!hit) {
+    const int rc = read_directory(zi->filename, entries);
+    if (rc != 0) return rc;
+    if (stamped) {
+      std::scoped_lock const lock(g_cache_mutex);
+      g_dirs.push_front({stamp, entries});
+      if (g_dirs.size() > kDirCacheSlots) g_dirs.pop_back();
+    }
+  }
+
+  for (auto& e : entries) {
+    if (!name_matches(reinterpret_cast<const byte*>(e.first.data()),
+                      static_cast<word>(e.first.size()), zi->extensions))
+      continue;
+    zi->dwOffset = e.second;
+    zi->filesOffsets.push_back(std::move(e));
+  }
+
+  if (zi->filesOffsets.empty()) {
+    LOG_ERROR("Empty zip file: " << zi->filename);
+    return ERR_FILE_EMPTY_ZIP;
   }
+  return 0;
+}
+
+int extract(const t_zip_info& zi, FILE** pfileOut) {
+#ifdef WINDOWS
+  // Windows tmpfile() wants the root directory; use a named temporary.
+  char tmpFilePath[MAX_PATH];
+  snprintf(tmpFilePath, sizeof(tmpFilePath), ".\\koncpc_tmp_XXXXXX");
+  if (_mktemp_s(tmpFilePath, strlen(tmpFilePath) + 1) != 0) {
+    LOG_ERROR("Couldn't unzip file: Couldn't generate temporary file name: "
+              << strerror(errno));
+    return ERR_FILE_UNZIP_FAILED;
+  }
+  *pfileOut = fopen(tmpFilePath, "w+b");
+#else
+  *pfileOut = tmpfile();
+#endif
+  if (*pfileOut == nullptr) {
+    LOG_ERROR("Couldn't unzip file: Couldn't create temporary file: "
+              << strerror(errno));
+    return ERR_FILE_UNZIP_FAILED;
+  }
+  auto fail = [&]() {
+    fclose(*pfileOut);
+    *pfileOut = nullptr;
+    return ERR_FILE_UNZIP_FAILED;
+  };
+
+  size_t size_hint = 0;
+  FILE* const out = *pfileOut;
+  if (inflate_entry(zi.filename, zi.dwOffset, size_hint,
+                    [out](const byte* p, size_t n) {
+                      if (fwrite(p, n, 1, out) == 1) return true;
+                      LOG_ERROR(
+                          "Couldn't unzip file: Couldn't write to output "
+                          "file");
+                      return false;
+                    }) != 0)
+    return fail();
 
   fseek(*pfileOut, 0, SEEK_SET);
   return 0;
 }
 
+int extract_to(const t_zip_info& zi, std::vector<byte>& out) {
+  out.clear();
+  Stamp stamp;
+  const bool stamped = stamp_of(zi.filename, stamp);
+  if (stamped) {
+    std::scoped_lock const lock(g_cache_mutex);
+    for (auto it = g_entries.begin(); it != g_entries.end(); ++it) {
+      if (it->offset != zi.dwOffset || !(it->stamp == stamp)) continue;
+      g_entries.splice(g_entries.begin(), g_entries, it);
+      out = it->bytes;
+      return 0;
+    }
+  }
+  size_t size_hint = 0;
+  bool reserved = false;
+  const int rc = inflate_entry(zi.filename, zi.dwOffset, size_hint,
+                               [&](const byte* p, size_t n) {
+                                 // The header's claim is untrusted: cap
+                                 // the up-front reservation.
+                                 if (!reserved)
+                                   out.reserve(std::min(size_hint,
+                                                        kEntryCacheBytes));
+                                 reserved = true;
+                                 out.insert(out.end(), p, p + n);
+                                 return true;
+                               });
+  if (rc != 0) {
+    out.clear();
+    return rc;
+  }
+  if (stamped) cache_entry(stamp, zi.dwOffset, out);
+  return 0;
+}
+
+void clear_cache() {
+  std::scoped_lock const lock(g_cache_mutex);
+  g_dirs.clear();
+  g_entries.clear();
+  g_entry_bytes = 0;
+}
+
 }  // namespace zip
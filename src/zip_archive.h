@@ -1,6 +1,12 @@
 /* zip_archive — minimal ZIP reading for slot-file loading: list an archive's
- * entries by extension and inflate one entry to a temporary FILE*. Authored
- * from the PKWARE APPNOTE (no minizip dependency; zlib does the inflate). */
+ * entries by extension and inflate one entry to a temporary FILE* or straight
+ * into memory. Authored from the PKWARE APPNOTE (no minizip dependency; zlib
+ * does the inflate).
+ *
+ * Parsed central directories and in-memory inflated entries are kept in a
+ * small LRU keyed by archive path + size + mtime (to the nanosecond) + inode
+ * + ctime, so flipping between the discs of a multi-disc archive re-reads
+ * nothing; rewriting the archive changes its stamp and misses the cache. */
 
 #pragma once
 
@@ -31,4 +37,12 @@ int dir(t_zip_info* zi);
  * supported. Returns 0 or ERR_FILE_UNZIP_FAILED. */
 int extract(const t_zip_info& zi, FILE** pfileOut);
 
+/* As extract(), but inflate into `out` (replaced) with no temporary file. A
+ * recently extracted entry of an unchanged archive is copied from the cache
+ * instead of inflated again. Returns 0 or ERR_FILE_UNZIP_FAILED. */
+int extract_to(const t_zip_info& zi, std::vector<byte>& out);
+
+/* Forget every cached directory and entry. */
+void clear_cache();
+
 }  // namespace zip
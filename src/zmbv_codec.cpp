@@ -0,0 +1,241 @@
+#include "zmbv_codec.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint8_t kFlagKeyframe = 0x01;
+constexpr uint8_t kFlagPalette = 0x02;  // delta frame carries a palette XOR
+
+constexpr uint32_t kNoColour = ~uint32_t{0};
+constexpr int kColourHash = 1024;  // open addressing for <= 256 colours
+
+}  // namespace
+
+struct ZmbvEncoder::State {
+  int w = 0, h = 0;
+  z_stream zs{};
+  bool zs_ok = false;
+  int since_key = 0;
+  bool need_key = true;
+  uint8_t format = kFormat8bpp;
+
+  std::vector<uint32_t> prev_rgb;  // 0x00RRGGBB, the last frame
+  std::vector<uint32_t> cur_rgb;
+  std::vector<uint8_t> prev_px;    // last frame, coded pixel bytes
+  std::vector<uint8_t> cur_px;
+  uint32_t pal[256] = {};
+  int npal = 0;
+  uint32_t hkeys[kColourHash];
+  uint8_t hvals[kColourHash];
+
+  std::vector<uint8_t> raw;  // uncompressed payload, reused
+
+  int bpp() const { return format == kFormat8bpp ? 1 : 4; }
+
+  void clear_palette() {
+    npal = 0;
+    std::fill(std::begin(hkeys), std::end(hkeys), kNoColour);
+  }
+  // Palette index of c, adding it if there is room; -1 when full.
+  int colour_index(uint32_t c) {
+    uint32_t hh = (c * 2654435761u) >> 22;
+    while (hkeys[hh] != kNoColour) {
+      if (hkeys[hh] == c) return hvals[hh];
+      hh = (hh + 1) & (kColourHash - 1);
+    }
+    if (npal == 256) return -1;
+    hkeys[hh] = c;
+    hvals[hh] = static_cast<uint8_t>(npal);
+    pal[npal] = c;
+    return npal++;
+  }
+
+  // Code pixel i of cur_rgb into cur_px; false when the palette is full.
+  bool code_pixel(size_t i) {
+    const uint32_t c = cur_rgb[i];
+    if (format == kFormat8bpp) {
+      const int k = colour_index(c);
+      if (k < 0) return false;
+      cur_px[i] = static_cast<uint8_t>(k);
+    } else {  // little-endian 0x00RRGGBB: B, G, R, 0
+      uint8_t* p = &cur_px[i * 4];
+      p[0] = static_cast<uint8_t>(c);
+      p[1] = static_cast<uint8_t>(c >> 8);
+      p[2] = static_cast<uint8_t>(c >> 16);
+      p[3] = 0;
+    }
+    return true;
+  }
+
+  bool compress(std::vector<uint8_t>& out) {
+    zs.next_in = raw.data();
+    zs.avail_in = static_cast<uInt>(raw.size());
+    for (;;) {
+      const size_t have = out.size();
+      out.resize(have + raw.size() + 1024);
+      zs.next_out = out.data() + have;
+      zs.avail_out = static_cast<uInt>(out.size() - have);
+      if (deflate(&zs, Z_SYNC_FLUSH) == Z_STREAM_ERROR) return false;
+      out.resize(out.size() - zs.avail_out);
+      if (zs.avail_out != 0) return true;  // all input consumed and flushed
+    }
+  }
+
+  bool keyframe(std::vector<uint8_t>& out) {
+    // Format: 8 bpp when the whole image fits a fresh palette.
+    clear_palette();
+    format = kFormat8bpp;
+    for (uint32_t c : cur_rgb) {
+      if (colour_index(c) < 0) {
+        format = kFormat32bpp;
+        break;
+      }
+    }
+    const size_t n = static_cast<size_t>(w) * h;
+    cur_px.assign(n * bpp(), 0);
+    for (size_t i = 0; i < n; ++i) code_pixel(i);
+
+    out.push_back(kFlagKeyframe);
+    out.insert(out.end(), {0 /*major*/, 1 /*minor*/, 1 /*zlib*/, format,
+                           static_cast<uint8_t>(kBlock),
+                           static_cast<uint8_t>(kBlock)});
+    raw.clear();
+    if (format == kFormat8bpp) {
+      for (int i = 0; i < 256; ++i) {
+        const uint32_t c = i < npal ? pal[i] : 0;
+        raw.insert(raw.end(), {static_cast<uint8_t>(c >> 16),
+                               static_cast<uint8_t>(c >> 8),
+                               static_cast<uint8_t>(c)});
+      }
+    }
+    raw.insert(raw.end(), cur_px.begin(), cur_px.end());
+    if (deflateReset(&zs) != Z_OK) return false;
+    since_key = 0;
+    need_key = false;
+    return compress(out);
+  }
+
+  // Delta frame; false (with nothing emitted) when it has to be a keyframe.
+  bool delta(std::vector<uint8_t>& out, bool& ok) {
+    const int bx_n = (w + kBlock - 1) / kBlock, by_n = (h + kBlock - 1) / kBlock;
+    const size_t table = ((static_cast<size_t>(bx_n) * by_n * 2) + 3) & ~size_t{3};
+    uint32_t pal_before[256];
+    std::memcpy(pal_before, pal, sizeof(pal));
+    const int npal_before = npal;
+
+    raw.assign(table, 0);
+    const int bpp_ = bpp();
+    size_t blk = 0;
+    for (int by = 0; by < by_n; ++by) {
+      for (int bx = 0; bx < bx_n; ++bx, ++blk) {
+        const int x0 = bx * kBlock, y0 = by * kBlock;
+        const int bw = std::min(kBlock, w - x0), bh = std::min(kBlock, h - y0);
+        bool changed = false;
+        for (int y = y0; y < y0 + bh && !changed; ++y) {
+          const size_t row = (static_cast<size_t>(y) * w) + x0;
+          changed = std::memcmp(&cur_rgb[row], &prev_rgb[row],
+                                static_cast<size_t>(bw) * 4) != 0;
+        }
+        if (!changed) continue;  // vector (0,0), no XOR data
+        raw[blk * 2] = 1;        // (dx << 1) | has-XOR, dx = dy = 0
+        for (int y = y0; y < y0 + bh; ++y) {
+          const size_t row = (static_cast<size_t>(y) * w) + x0;
+          for (int x = 0; x < bw; ++x) {
+            if (!code_pixel(row + x)) {  // palette overflow: rewind
+              std::memcpy(pal, pal_before, sizeof(pal));
+              npal = npal_before;
+              return false;
+            }
+          }
+          const uint8_t* c = &cur_px[row * bpp_];
+          const uint8_t* p = &prev_px[row * bpp_];
+          for (int k = 0; k < bw * bpp_; ++k)
+            raw.push_back(static_cast<uint8_t>(c[k] ^ p[k]));
+        }
+      }
+    }
+    // Unchanged blocks still hold the previous frame's coded pixels.
+    const bool pal_changed = npal != npal_before;
+    out.push_back(pal_changed ? kFlagPalette : 0);
+    if (pal_changed) {  // palette XOR precedes the block table
+      std::vector<uint8_t> px(768);
+      for (int i = 0; i < 256; ++i) {
+        const uint32_t d = pal[i] ^ pal_before[i];
+        px[(i * 3) + 0] = static_cast<uint8_t>(d >> 16);
+        px[(i * 3) + 1] = static_cast<uint8_t>(d >> 8);
+        px[(i * 3) + 2] = static_cast<uint8_t>(d);
+      }
+      raw.insert(raw.begin(), px.begin(), px.end());
+    }
+    ok = compress(out);
+    return true;
+  }
+};
+
+ZmbvEncoder::ZmbvEncoder() = default;
+
+ZmbvEncoder::~ZmbvEncoder() {
+  if (st_ && st_->zs_ok) deflateEnd(&st_->zs);
+}
+
+bool ZmbvEncoder::reset(int width, int height) {
+  if (width <= 0 || height <= 0) return false;
+  if (!st_) {
+    st_ = std::make_unique<State>();
+    // Level 4: DOSBox's own capture setting — most of the ratio of 9 at a
+    // fraction of the cost; delta frames are tiny either way.
+    if (deflateInit(&st_->zs, 4) != Z_OK) {
+      st_.reset();
+      return false;
+    }
+    st_->zs_ok = true;
+  }
+  State& s = *st_;
+  s.w = width;
+  s.h = height;
+  const size_t n = static_cast<size_t>(width) * height;
+  s.prev_rgb.assign(n, 0);
+  s.cur_rgb.assign(n, 0);
+  s.prev_px.clear();
+  s.cur_px.clear();
+  s.need_key = true;
+  s.since_key = 0;
+  return true;
+}
+
+bool ZmbvEncoder::encode(const uint8_t* rgba, int pitch,
+                         std::vector<uint8_t>& out, bool& keyframe) {
+  if (!st_ || !rgba) return false;
+  State& s = *st_;
+  for (int y = 0; y < s.h; ++y) {
+    const uint8_t* p = rgba + (static_cast<size_t>(y) * pitch);
+    uint32_t* d = &s.cur_rgb[static_cast<size_t>(y) * s.w];
+    for (int x = 0; x < s.w; ++x, p += 4)
+      d[x] = (static_cast<uint32_t>(p[0]) << 16) |
+             (static_cast<uint32_t>(p[1]) << 8) | p[2];
+  }
+  out.clear();
+  bool ok = true;
+  keyframe = s.need_key || s.since_key >= kKeyInterval;
+  if (!keyframe) {
+    // Delta codes changed blocks in place over prev_px's copy.
+    s.cur_px = s.prev_px;
+    if (!s.delta(out, ok)) {
+      out.clear();
+      keyframe = true;
+    }
+  }
+  if (keyframe) ok = s.keyframe(out);
+  if (!ok) {
+    s.need_key = true;  // the zlib stream is unusable until a reset
+    return false;
+  }
+  s.since_key++;
+  std::swap(s.prev_rgb, s.cur_rgb);
+  std::swap(s.prev_px, s.cur_px);
+  return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Lossless screen-capture encoder in the ZMBV format (DOSBox "Zip Motion
+// Block Video", FourCC "ZMBV" — decoded by FFmpeg, VLC, mpv and DOSBox's VfW
+// codec). A frame is one flag byte (keyframe/palette-change), a 6-byte format
+// header on keyframes, then a zlib stream that runs across frames until the
+// next keyframe resets it. Keyframes carry the whole image; delta frames a
+// per-16x16-block table plus the XOR of each changed block against the
+// previous frame, so a mostly static CPC screen costs a few bytes.
+//
+// Palette-aware: a keyframe whose image has at most 256 colours (every
+// classic CPC frame; almost every Plus one) is coded 8 bpp with a palette
+// that later frames may only grow (new colours take free slots — existing
+// indices never move, so unchanged blocks stay unchanged). A frame that
+// overflows it forces a keyframe, in 32 bpp if it must be.
+class ZmbvEncoder {
+ public:
+  ZmbvEncoder();
+  ~ZmbvEncoder();
+  ZmbvEncoder(const ZmbvEncoder&) = delete;
+  ZmbvEncoder& operator=(const ZmbvEncoder&) = delete;
+
+  // Start a new stream; the first frame after this is a keyframe.
+  bool reset(int width, int height);
+
+  // Encode one frame (RGBA8 — R,G,B,x byte order — pitch in bytes) into
+  // `out` (replaced). `keyframe` reports whether it is independently
+  // decodable (the AVI index flags it).
+  bool encode(const uint8_t* rgba, int pitch, std::vector<uint8_t>& out,
+              bool& keyframe);
+
+  static constexpr int kBlock = 16;         // block edge, pixels
+  static constexpr int kKeyInterval = 300;  // forced keyframe every 6 s
+  // Format codes from the ZMBV keyframe header.
+  static constexpr uint8_t kFormat8bpp = 4;
+  static constexpr uint8_t kFormat32bpp = 8;
+
+ private:
+  struct State;  // zlib stream + frame buffers, opaque to avoid header leak
+  std::unique_ptr<State> st_;
+};
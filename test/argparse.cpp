@@ -76,6 +76,21 @@ TEST(argParseTest, cfgOverrideInvalid) {
   ASSERT_TRUE(args.cfgOverrides.empty());
 }
 
+TEST(argParseTest, renderAudioOptions) {
+  const char* argv[] = {"./koncepcja", "--render-audio=/tmp/tune.wav",
+                        "-Y", "/tmp/tune.ym", "--render-until=silence:100",
+                        "--exit-after=300s"};
+  CapriceArgs args;
+  std::vector<std::string> slot_list;
+
+  parseArguments(6, const_cast<char**>(argv), slot_list, args);
+  ASSERT_EQ(0, slot_list.size());
+  ASSERT_EQ("/tmp/tune.wav", args.renderAudio);
+  ASSERT_EQ("/tmp/tune.ym", args.renderYm);
+  ASSERT_EQ("silence:100", args.renderUntil);
+  ASSERT_EQ("300s", args.exitAfter);
+}
+
 TEST(argParseTest, replaceKoncpcKeysNoKeyword) {
   std::string command = "print \"Hello, world !\"";
 
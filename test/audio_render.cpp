@@ -0,0 +1,147 @@
+#include "audio_render.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "subcycle/machine.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::vector<uint8_t> read_file(const std::string& path) {
+  std::ifstream f(path, std::ios::binary);
+  return {(std::istreambuf_iterator<char>(f)),
+          std::istreambuf_iterator<char>()};
+}
+
+uint32_t le32(const std::vector<uint8_t>& b, size_t at) {
+  return b[at] | (b[at + 1] << 8) | (b[at + 2] << 16) |
+         (static_cast<uint32_t>(b[at + 3]) << 24);
+}
+
+uint32_t be32(const std::vector<uint8_t>& b, size_t at) {
+  return (static_cast<uint32_t>(b[at]) << 24) | (b[at + 1] << 16) |
+         (b[at + 2] << 8) | b[at + 3];
+}
+
+class AudioRenderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rom_ = read_file("rom/cpc6128.rom");
+    if (rom_.size() < 0x8000) rom_ = read_file("../rom/cpc6128.rom");
+    if (rom_.size() < 0x8000) GTEST_SKIP() << "rom/cpc6128.rom not found";
+    ASSERT_TRUE(machine_.build(rom_.data(), rom_.size()));
+    dir_ = fs::temp_directory_path() / "audio_render_test";
+    fs::create_directories(dir_);
+  }
+  void TearDown() override {
+    if (!dir_.empty()) fs::remove_all(dir_);
+  }
+  std::string path(const std::string& name) { return (dir_ / name).string(); }
+
+  // Type `sound 1,239,50,15` RETURN through before_frame (one key per 8
+  // frames), after the firmware's boot.
+  static void type_sound(subcycle::Machine& m, uint32_t frame) {
+    static const uint8_t kSeq[] = {0x74, 0x42, 0x52, 0x56, 0x75, 0x57,
+                                   0x80, 0x47, 0x81, 0x71, 0x41, 0x47,
+                                   0x61, 0x40, 0x47, 0x80, 0x61, 0x22};
+    if (frame < 120) return;
+    const uint32_t k = (frame - 120) / 4;
+    if (k / 2 >= sizeof(kSeq)) return;
+    if ((frame - 120) % 4 == 0) m.key(kSeq[k / 2], k % 2 == 0);
+  }
+
+  std::vector<uint8_t> rom_;
+  subcycle::Machine machine_;
+  fs::path dir_;
+};
+
+}  // namespace
+
+TEST(AudioRenderParse, LengthsAndConditions) {
+  uint32_t f = 0;
+  EXPECT_TRUE(audio_render_parse_length("300s", f));
+  EXPECT_EQ(f, 15000u);
+  EXPECT_TRUE(audio_render_parse_length("100f", f));
+  EXPECT_EQ(f, 100u);
+  EXPECT_TRUE(audio_render_parse_length("1000ms", f));
+  EXPECT_EQ(f, 50u);
+  EXPECT_TRUE(audio_render_parse_length("42", f));
+  EXPECT_EQ(f, 42u);
+  EXPECT_FALSE(audio_render_parse_length("0", f));
+  EXPECT_FALSE(audio_render_parse_length("5x", f));
+  EXPECT_FALSE(audio_render_parse_length("", f));
+
+  AudioRenderOptions o;
+  EXPECT_TRUE(audio_render_parse_until("silence:50", o));
+  EXPECT_EQ(o.silent_frames, 50u);
+  EXPECT_FALSE(audio_render_parse_until("silence:", o));
+  EXPECT_FALSE(audio_render_parse_until("pc:4000", o));
+}
+
+// The rendered WAV holds exactly the samples the frames produced, the YM
+// file one register frame per emulated frame, and the SOUND note is in it.
+TEST_F(AudioRenderTest, WritesWavAndYmForTheFrames) {
+  AudioRenderOptions o;
+  o.wav_path = path("out.wav");
+  o.ym_path = path("out.ym");
+  o.max_frames = 330;
+  o.before_frame = [this](uint32_t frame) { type_sound(machine_, frame); };
+  const AudioRenderResult r = render_audio_offline(machine_, o);
+  ASSERT_TRUE(r.ok) << r.error;
+  EXPECT_EQ(r.frames, 330u);
+  EXPECT_EQ(r.ym_frames, 330u);
+  EXPECT_FALSE(r.stopped_on_silence);
+  EXPECT_NEAR(r.audio_seconds(), 330 * 0.019968, 0.05);
+
+  const std::vector<uint8_t> wav = read_file(o.wav_path);
+  ASSERT_GE(wav.size(), 44u);
+  EXPECT_EQ(std::string(wav.begin(), wav.begin() + 4), "RIFF");
+  EXPECT_EQ(le32(wav, 24), 44100u);
+  EXPECT_EQ(le32(wav, 40), r.sample_frames * 4);
+  EXPECT_EQ(wav.size(), 44 + (r.sample_frames * 4));
+  int peak = 0;
+  for (size_t i = 44; i + 1 < wav.size(); i += 2) {
+    const auto s = static_cast<int16_t>(wav[i] | (wav[i + 1] << 8));
+    peak = std::max(peak, s < 0 ? -s : static_cast<int>(s));
+  }
+  EXPECT_GT(peak, 2000) << "the typed SOUND command is in the render";
+
+  const std::vector<uint8_t> ym = read_file(o.ym_path);
+  ASSERT_GE(ym.size(), 16u);
+  EXPECT_EQ(std::string(ym.begin(), ym.begin() + 4), "YM5!");
+  EXPECT_EQ(be32(ym, 12), 330u);
+}
+
+// until=silence: the render ends once the note has played out, well before
+// the frame cap, and the machine is back on the tier it had.
+TEST_F(AudioRenderTest, StopsOnSilenceAfterSoundAndRestoresTier) {
+  machine_.set_run_tier(subcycle::Machine::RunTier::Wake);
+  AudioRenderOptions o;
+  o.wav_path = path("s.wav");
+  o.max_frames = 5000;
+  o.silent_frames = 50;
+  o.before_frame = [this](uint32_t frame) { type_sound(machine_, frame); };
+  const AudioRenderResult r = render_audio_offline(machine_, o);
+  ASSERT_TRUE(r.ok) << r.error;
+  EXPECT_TRUE(r.stopped_on_silence);
+  EXPECT_GT(r.frames, 264u) << "not before the note was typed and played";
+  EXPECT_LT(r.frames, 1000u);
+  EXPECT_EQ(machine_.run_tier(), subcycle::Machine::RunTier::Wake);
+}
+
+TEST_F(AudioRenderTest, ReportsUnwritablePath) {
+  AudioRenderOptions o;
+  o.wav_path = path("no/such/dir.wav");
+  o.max_frames = 10;
+  const AudioRenderResult r = render_audio_offline(machine_, o);
+  EXPECT_FALSE(r.ok);
+  EXPECT_NE(r.error.find("dir.wav"), std::string::npos);
+  EXPECT_EQ(r.frames, 0u);
+}
@@ -0,0 +1,152 @@
+#include "audio_ring.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::vector<int16_t> ramp(size_t frames, int16_t start = 0) {
+  std::vector<int16_t> v(frames * 2);
+  for (size_t i = 0; i < frames; ++i) {
+    v[i * 2] = static_cast<int16_t>(start + i);
+    v[(i * 2) + 1] = static_cast<int16_t>(-(start + static_cast<int>(i)));
+  }
+  return v;
+}
+
+// Producer and device running at slightly different clocks, in lockstep
+// chunks: `src_per_frame` source frames per 20 ms against 10 ms device pulls.
+// Returns the mean fill (ms) the device saw over the last 10 seconds.
+double run_drift(AudioRing& ring, double src_per_frame, int seconds) {
+  std::vector<int16_t> out(441 * 2);
+  double owed = 0;
+  std::vector<int16_t> src = ramp(2000);
+  double seen = 0;
+  int samples = 0;
+  for (int f = 0; f < seconds * 50; ++f) {
+    owed += src_per_frame;
+    const auto n = static_cast<size_t>(owed);
+    owed -= static_cast<double>(n);
+    ring.push(src.data(), n);
+    for (int p = 0; p < 2; ++p) {
+      if (f >= (seconds - 10) * 50) {
+        seen += ring.stats().fill_ms();
+        samples++;
+      }
+      ring.pull(out.data(), 441);
+    }
+  }
+  return samples ? seen / samples : 0;
+}
+
+}  // namespace
+
+TEST(AudioRing, SilentUntilPrimedThenPassesSamplesThrough) {
+  AudioRing ring;
+  ring.configure(44100, 44100, 10);  // 441 frames
+  std::vector<int16_t> out(100 * 2, 123);
+  auto src = ramp(300, 1);
+  ring.push(src.data(), 300);
+  ring.pull(out.data(), 100);
+  for (int16_t s : out) EXPECT_EQ(s, 0) << "below target: not primed";
+
+  src = ramp(300, 301);
+  ring.push(src.data(), 300);
+  ring.pull(out.data(), 100);
+  // At the target the correction is ~0, so samples come through unchanged.
+  for (size_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(out[i * 2], static_cast<int16_t>(i + 1)) << i;
+    EXPECT_EQ(out[(i * 2) + 1], -static_cast<int16_t>(i + 1)) << i;
+  }
+  EXPECT_EQ(ring.stats().underruns, 0u);
+}
+
+TEST(AudioRing, UnderrunPlaysSilenceAndReprimes) {
+  AudioRing ring;
+  ring.configure(44100, 44100, 5);
+  auto src = ramp(300, 1000);
+  ring.push(src.data(), 300);
+  std::vector<int16_t> out(400 * 2);
+  ring.pull(out.data(), 400);
+  EXPECT_EQ(ring.stats().underruns, 1u);
+  EXPECT_NE(out[0], 0);
+  EXPECT_EQ(out[399 * 2], 0) << "the tail past the data is silence";
+  ring.push(src.data(), 100);  // below the 220-frame target again
+  ring.pull(out.data(), 10);
+  EXPECT_EQ(out[0], 0);
+  EXPECT_EQ(ring.stats().underruns, 1u) << "waiting to re-prime is not a new one";
+}
+
+TEST(AudioRing, OverrunDropsBeyondCeiling) {
+  AudioRing ring;
+  ring.configure(44100, 44100, 30);
+  auto src = ramp(2000);
+  size_t accepted = 0;
+  for (int i = 0; i < 20; ++i) accepted += ring.push(src.data(), 2000);
+  const AudioRingStats s = ring.stats();
+  EXPECT_EQ(s.fill_frames, accepted);
+  EXPECT_LE(s.fill_ms(), 30.0 + 100 + 1);  // target + one 100 ms headroom
+  EXPECT_EQ(s.dropped + s.pushed, 40000u);
+  EXPECT_GT(s.dropped, 0u);
+}
+
+// The producer runs 0.3% fast, then 0.3% slow: the steering holds the fill
+// near the target with no underruns and no drops either way.
+TEST(AudioRing, SteersFillTowardTargetUnderClockDrift) {
+  for (double drift : {1.003, 0.997}) {
+    AudioRing ring;
+    ring.configure(44100, 44100, 30);
+    const double seen = run_drift(ring, 882 * drift, 60);
+    const AudioRingStats s = ring.stats();
+    EXPECT_EQ(s.underruns, 0u) << drift;
+    EXPECT_EQ(s.dropped, 0u) << drift;
+    EXPECT_NEAR(seen, 30.0, 2.0) << drift;
+    EXPECT_NEAR(s.ratio, drift, 0.002) << drift;
+  }
+}
+
+// 44.1 kHz source into a 48 kHz device: 882 source frames become 960 device
+// frames per emulated frame, with the fill held at the target.
+TEST(AudioRing, ResamplesToTheDeviceRate) {
+  AudioRing r2;
+  r2.configure(44100, 48000, 30);
+  std::vector<int16_t> out(960 * 2);
+  auto src = ramp(882);
+  for (int f = 0; f < 50 * 30; ++f) {
+    r2.push(src.data(), 882);
+    r2.pull(out.data(), 960);  // 20 ms at 48 kHz
+  }
+  const AudioRingStats s = r2.stats();
+  EXPECT_EQ(s.underruns, 0u);
+  EXPECT_EQ(s.dropped, 0u);
+  EXPECT_NEAR(s.fill_ms(), 30.0, 21.0);
+}
+
+TEST(AudioRing, ConcurrentProducerAndConsumer) {
+  AudioRing ring;
+  ring.configure(44100, 44100, 20);
+  std::atomic<bool> stop{false};
+  std::thread consumer([&] {
+    std::vector<int16_t> out(256 * 2);
+    while (!stop.load()) {
+      ring.pull(out.data(), 256);
+      // Samples are interpolated between ramp values: never out of range.
+      for (size_t i = 0; i < 256; ++i)
+        ASSERT_EQ(out[i * 2], static_cast<int16_t>(-out[(i * 2) + 1]));
+      std::this_thread::yield();
+    }
+  });
+  auto src = ramp(441);
+  for (int i = 0; i < 2000; ++i) {
+    ring.push(src.data(), 441);
+    std::this_thread::yield();
+  }
+  stop = true;
+  consumer.join();
+  const AudioRingStats s = ring.stats();
+  EXPECT_EQ(s.pushed + s.dropped, 2000u * 441);
+}
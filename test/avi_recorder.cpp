@@ -205,12 +205,15 @@ TEST_F(AviRecorderTest, VideoFrameCaptureIncrementsCount) {
 
   auto frame = make_test_frame(64, 48, 255, 0, 0);
   recorder_.capture_video_frame(frame.data(), 64, 48, 64 * 4);
+  recorder_.flush();  // the count is of frames in the file
   EXPECT_EQ(recorder_.frame_count(), 1u);
 
   recorder_.capture_video_frame(frame.data(), 64, 48, 64 * 4);
+  recorder_.flush();
   EXPECT_EQ(recorder_.frame_count(), 2u);
 
   recorder_.capture_video_frame(frame.data(), 64, 48, 64 * 4);
+  recorder_.flush();
   EXPECT_EQ(recorder_.frame_count(), 3u);
 
   uint32_t total = recorder_.stop();
@@ -227,6 +230,7 @@ TEST_F(AviRecorderTest, BytesWrittenIncreases) {
 
   auto frame = make_test_frame(64, 48, 0, 255, 0);
   recorder_.capture_video_frame(frame.data(), 64, 48, 64 * 4);
+  recorder_.flush();  // encoding and writes run on the worker
 
   EXPECT_GT(recorder_.bytes_written(), initial);
 
@@ -288,11 +292,13 @@ TEST_F(AviRecorderTest, AudioCaptureWritesData) {
   // Write some audio samples
   std::vector<int16_t> samples(1024, 0x1234);
   recorder_.capture_audio_samples(samples.data(), samples.size());
+  recorder_.flush();
 
   uint64_t bytes_after_audio = recorder_.bytes_written();
 
   auto frame = make_test_frame(64, 48, 255, 255, 0);
   recorder_.capture_video_frame(frame.data(), 64, 48, 64 * 4);
+  recorder_.flush();
 
   uint64_t bytes_after_video = recorder_.bytes_written();
   EXPECT_GT(bytes_after_video, bytes_after_audio);
@@ -324,6 +330,7 @@ TEST_F(AviRecorderTest, StatusReportsCorrectValues) {
 
   auto frame = make_test_frame(64, 48, 100, 100, 100);
   recorder_.capture_video_frame(frame.data(), 64, 48, 64 * 4);
+  recorder_.flush();  // the count is of frames in the file
   EXPECT_EQ(recorder_.frame_count(), 1u);
   EXPECT_GT(recorder_.bytes_written(), 0u);
 
@@ -332,4 +339,103 @@ TEST_F(AviRecorderTest, StatusReportsCorrectValues) {
   EXPECT_TRUE(recorder_.current_path().empty());
 }
 
+// The worker writes chunks in capture order: a long interleaved burst (more
+// chunks than queue slots) must land with every idx1 entry pointing at its
+// chunk and the audio intact. A loaded machine may still drop a video frame
+// past the backpressure deadline, so the counts are checked after stop():
+// every frame is either in the file or counted as dropped.
+TEST_F(AviRecorderTest, AsyncPipelineKeepsOrderAndIndexConsistent) {
+  std::string path = tmp_path("pipeline.avi");
+  ASSERT_TRUE(recorder_.start(path, 85, 44100, 2, 16).empty());
+
+  constexpr int kFrames = 3 * static_cast<int>(AviRecorder::kQueueSlots);
+  std::vector<int16_t> samples(882 * 2);
+  for (int f = 0; f < kFrames; f++) {
+    for (size_t i = 0; i < samples.size(); i++)
+      samples[i] = static_cast<int16_t>((f * 1000) + static_cast<int>(i));
+    recorder_.capture_audio_samples(samples.data(), samples.size());
+    auto frame = make_test_frame(64, 48, static_cast<uint8_t>(f * 3), 0, 0);
+    recorder_.capture_video_frame(frame.data(), 64, 48, 64 * 4);
+  }
+  const AviRecorder::PipelineStats st = recorder_.pipeline_stats();
+  EXPECT_EQ(st.capacity, AviRecorder::kQueueSlots);
+  EXPECT_GE(st.queue_peak, 1u);
+  const uint32_t frames = recorder_.stop();
+  EXPECT_EQ(frames + st.dropped_frames, static_cast<uint32_t>(kFrames));
+
+  auto data = read_file(path);
+  size_t movi = 0, idx1 = 0;
+  for (size_t i = 0; i + 4 <= data.size(); i++) {
+    if (movi == 0 && memcmp(data.data() + i, "movi", 4) == 0) movi = i;
+    if (memcmp(data.data() + i, "idx1", 4) == 0) idx1 = i;
+  }
+  ASSERT_GT(movi, 0u);
+  ASSERT_GT(idx1, movi);
+  const uint32_t entries = read_u32(data, idx1 + 4) / 16;
+  ASSERT_EQ(entries, frames + static_cast<uint32_t>(kFrames));
+  uint32_t audio = 0;
+  uint32_t video = 0;
+  for (uint32_t e = 0; e < entries; e++) {
+    const size_t ent = idx1 + 8 + (e * 16);
+    // idx1 offsets here count from just past the 'movi' fourcc.
+    const size_t chunk = movi + 4 + read_u32(data, ent + 8);
+    const bool is_audio = bytes_match(data, ent, "01wb", 4);
+    const char* want = is_audio ? "01wb" : "00dc";
+    ASSERT_TRUE(bytes_match(data, ent, want, 4)) << "entry " << e;
+    ASSERT_TRUE(bytes_match(data, chunk, want, 4)) << "chunk " << e;
+    EXPECT_EQ(read_u32(data, chunk + 4), read_u32(data, ent + 12));
+    if (is_audio) {  // first sample of the next frame's audio, in order
+      EXPECT_EQ(static_cast<int16_t>(read_u16(data, chunk + 8)),
+                static_cast<int16_t>(audio * 1000));
+      audio++;
+    } else {
+      video++;
+    }
+  }
+  EXPECT_EQ(audio, static_cast<uint32_t>(kFrames));
+  EXPECT_EQ(video, frames);
+}
+
 #endif  // HAS_LIBJPEG
+
+// === ZMBV needs only zlib, so these run with or without libjpeg ===
+
+TEST_F(AviRecorderTest, ZmbvStreamDeclaresCodecAndIndexesKeyframes) {
+  std::string path = tmp_path("zmbv.avi");
+  ASSERT_TRUE(recorder_
+                  .start(path, 85, 44100, 2, 16, AviRecorder::Codec::Zmbv)
+                  .empty());
+  EXPECT_EQ(recorder_.codec(), AviRecorder::Codec::Zmbv);
+  auto frame = make_test_frame(64, 48, 0, 0, 128);
+  for (int f = 0; f < 4; f++) {
+    frame[static_cast<size_t>(f) * 4] = 255;  // one pixel changes per frame
+    recorder_.capture_video_frame(frame.data(), 64, 48, 64 * 4);
+  }
+  // A ZMBV stream has one frame size: the encoder skips this frame, and it
+  // must not be counted as recorded.
+  auto small = make_test_frame(32, 24, 0, 0, 128);
+  recorder_.capture_video_frame(small.data(), 32, 24, 32 * 4);
+  recorder_.flush();
+  EXPECT_EQ(recorder_.frame_count(), 4u);
+  EXPECT_EQ(recorder_.stop(), 4u);
+
+  auto data = read_file(path);
+  ASSERT_GT(data.size(), 200u);
+  // Video strh.fccHandler and strf.biCompression
+  EXPECT_TRUE(bytes_match(data, 112, "ZMBV", 4));
+  EXPECT_TRUE(bytes_match(data, 188, "ZMBV", 4));
+  EXPECT_EQ(read_u16(data, 186), 32);  // biBitCount
+
+  size_t idx1 = 0;
+  for (size_t i = 0; i + 4 <= data.size(); i++)
+    if (memcmp(data.data() + i, "idx1", 4) == 0) idx1 = i;
+  ASSERT_GT(idx1, 0u);
+  ASSERT_EQ(read_u32(data, idx1 + 4), 4u * 16);
+  for (uint32_t e = 0; e < 4; e++) {
+    const size_t ent = idx1 + 8 + (e * 16);
+    ASSERT_TRUE(bytes_match(data, ent, "00dc", 4));
+    // Only the first frame is a keyframe; the rest are small deltas.
+    EXPECT_EQ(read_u32(data, ent + 4), e == 0 ? 0x10u : 0u) << "entry " << e;
+    if (e > 0) EXPECT_LT(read_u32(data, ent + 12), 64u);
+  }
+}
@@ -169,7 +169,9 @@ TEST(DriveMediumTest, FluxDiscIsPresentDespiteAnEmptySectorView) {
   EXPECT_TRUE(m.present) << "a flux disc read as an empty drive";
   EXPECT_TRUE(m.flux);
   EXPECT_EQ(m.tracks, 80u) << "cylinder count comes from the flux medium";
-  EXPECT_EQ(m.sides, 1u) << "the FDC captures side 0 only";
+  EXPECT_EQ(m.sides, 1u) << "a single-sided capture by default";
+  EXPECT_EQ(drive_medium_from(caps, 0, 0, 80, 2).sides, 2u)
+      << "a double-sided capture reports both sides";
 }
 
 // A written flux disc grows a DSK overlay, so it reports both capabilities.
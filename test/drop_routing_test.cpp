@@ -50,12 +50,8 @@ TEST(DropRouting, DriveARejectsNonDiskMedia) {
     EXPECT_FALSE(extension_in_dotted_list(a, e)) << e;
 }
 
-// Flux stays drive-A-only by FDC design (side-0/drive-A flux capture). The
-// drive-B dialogs and docs rely on this holding.
-TEST(DropRouting, DriveBExcludesFluxByDesign) {
-  const std::string b = drive_extensions(DRIVE::DSK_B);
-  for (const char* e : {".dsk", ".ipf", ".raw"})
-    EXPECT_TRUE(extension_in_dotted_list(b, e)) << e;
-  for (const char* e : {".scp", ".hfe", ".a2r"})
-    EXPECT_FALSE(extension_in_dotted_list(b, e)) << e;
+// The FDC plays flux in either drive, so a two-drive copy setup can run
+// from flux: drive B takes exactly what drive A does.
+TEST(DropRouting, DriveBAcceptsFluxLikeDriveA) {
+  EXPECT_EQ(drive_extensions(DRIVE::DSK_B), drive_extensions(DRIVE::DSK_A));
 }
@@ -0,0 +1,167 @@
+/* flux_convert_test.cpp — the batch conversion core behind koncepcja_convert
+ * (src/flux_convert.{h,cpp}): one image through the Save-As pipeline, with its
+ * weak-sector report, and a directory tree converted into a mirrored output
+ * tree (skips, collisions and failures reported per file). */
+
+#include "flux_convert.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "hw/flux_synth.h"  // fluxsynth::amsdos_content / scp_from_sectors
+
+namespace {
+
+namespace fs = std::filesystem;
+using Status = FluxConvertResult::Status;
+
+std::vector<uint8_t> amsdos_scp(int tracks) {
+  return fluxsynth::scp_from_sectors(fluxsynth::amsdos_content(tracks));
+}
+
+class FluxConvertTree : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = fs::path(::testing::TempDir()) /
+           (std::string("flux_convert_test_") +
+            ::testing::UnitTest::GetInstance()->current_test_info()->name());
+    fs::remove_all(dir_);
+    fs::create_directories(dir_);
+  }
+  void TearDown() override { fs::remove_all(dir_); }
+
+  void put(const std::string& name, const std::vector<uint8_t>& bytes) const {
+    const fs::path p = dir_ / name;
+    fs::create_directories(p.parent_path());
+    std::ofstream f(p, std::ios::binary);
+    f.write(reinterpret_cast<const char*>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+  }
+  std::vector<uint8_t> get(const std::string& name) const {
+    std::ifstream f(dir_ / name, std::ios::binary);
+    return {(std::istreambuf_iterator<char>(f)),
+            std::istreambuf_iterator<char>()};
+  }
+
+  fs::path dir_;
+};
+
+}  // namespace
+
+TEST(FluxConvert, ScpToDskAndHfe) {
+  const std::vector<uint8_t> scp = amsdos_scp(3);
+  FluxWeakReport weak{};
+  std::string err;
+  const std::vector<uint8_t> dsk = flux_convert_bytes(
+      scp.data(), scp.size(), ".scp", SaveFormat::Dsk, &weak, err);
+  ASSERT_FALSE(dsk.empty()) << err;
+  EXPECT_EQ(std::memcmp(dsk.data(), "MV - CPCEMU", 11), 0);
+  EXPECT_EQ(dsk[0x30], 3) << "tracks";
+  EXPECT_EQ(weak.count, 0);
+
+  const std::vector<uint8_t> hfe = flux_convert_bytes(
+      scp.data(), scp.size(), ".scp", SaveFormat::Hfe, nullptr, err);
+  ASSERT_FALSE(hfe.empty()) << err;
+  EXPECT_EQ(std::memcmp(hfe.data(), "HXCPICFE", 8), 0);
+
+  // And back: the HFE converts to the same DSK.
+  EXPECT_EQ(flux_convert_bytes(hfe.data(), hfe.size(), ".hfe",
+                               SaveFormat::Dsk, nullptr, err),
+            dsk);
+}
+
+TEST(FluxConvert, ReportsWeakSectors) {
+  std::vector<std::vector<fluxsynth::Sector>> d = fluxsynth::amsdos_content(2);
+  d[1][4].corrupt_data = true;  // &C5 on track 1
+  const std::vector<uint8_t> scp = fluxsynth::scp_from_sectors(d);
+  FluxWeakReport weak{};
+  std::string err;
+  ASSERT_FALSE(flux_convert_bytes(scp.data(), scp.size(), ".scp",
+                                  SaveFormat::Dsk, &weak, err)
+                   .empty())
+      << err;
+  ASSERT_EQ(weak.count, 1);
+  EXPECT_EQ(weak.sec[0].cyl, 1);
+  EXPECT_EQ(weak.sec[0].sector_id, 0xC5);
+  EXPECT_STREQ(flux_weak_reason_text(weak.sec[0].reason), "crc");
+}
+
+TEST(FluxConvert, RefusesWhatIsNotFlux) {
+  const std::vector<uint8_t> junk(4096, 0x42);
+  std::string err;
+  EXPECT_TRUE(flux_convert_bytes(junk.data(), junk.size(), ".scp",
+                                 SaveFormat::Dsk, nullptr, err)
+                  .empty());
+  EXPECT_FALSE(err.empty());
+}
+
+TEST_F(FluxConvertTree, MirrorsTheTreeAndReportsEveryFile) {
+  const std::vector<uint8_t> scp = amsdos_scp(2);
+  put("in/a.scp", scp);
+  put("in/sub/b.scp", scp);
+  put("in/sub/broken.scp", std::vector<uint8_t>(64, 0));
+  put("in/notes.txt", {'x'});
+
+  FluxConvertOptions opt;
+  opt.to = SaveFormat::Dsk;
+  opt.out_dir = (dir_ / "out").string();
+  opt.threads = 2;
+  int calls = 0;
+  const std::vector<FluxConvertResult> r = flux_convert_tree(
+      {(dir_ / "in").string()}, opt,
+      [&](const FluxConvertResult&, int done, int total) {
+        ++calls;
+        EXPECT_EQ(done, calls);
+        EXPECT_EQ(total, 3);
+      });
+  ASSERT_EQ(r.size(), 3u) << "notes.txt is not a flux image";
+  EXPECT_EQ(calls, 3);
+  EXPECT_EQ(r[0].status, Status::Converted) << r[0].error;
+  EXPECT_EQ(r[1].status, Status::Converted) << r[1].error;
+  EXPECT_EQ(r[2].status, Status::Failed);
+  EXPECT_EQ(r[2].input, (dir_ / "in/sub/broken.scp").string());
+  EXPECT_FALSE(r[2].error.empty());
+  EXPECT_FALSE(get("out/a.dsk").empty());
+  EXPECT_EQ(get("out/sub/b.dsk"), get("out/a.dsk"));
+
+  // A second pass leaves existing outputs alone unless asked.
+  const std::vector<FluxConvertResult> again =
+      flux_convert_tree({(dir_ / "in").string()}, opt);
+  EXPECT_EQ(again[0].status, Status::Skipped);
+  opt.overwrite = true;
+  EXPECT_EQ(flux_convert_tree({(dir_ / "in/a.scp").string()}, opt)[0].status,
+            Status::Converted);
+}
+
+TEST_F(FluxConvertTree, SkipsTargetsAndCollisions) {
+  const std::vector<uint8_t> scp = amsdos_scp(2);
+  put("game.scp", scp);
+  FluxConvertOptions opt;
+  opt.to = SaveFormat::Scp;
+  std::vector<FluxConvertResult> r =
+      flux_convert_tree({(dir_ / "game.scp").string()}, opt);
+  ASSERT_EQ(r.size(), 1u);
+  EXPECT_EQ(r[0].status, Status::Skipped) << "already an SCP";
+
+  // game.scp and game.hfe would both become game.dsk: the first one wins.
+  std::string err;
+  put("game.hfe", flux_convert_bytes(scp.data(), scp.size(), ".scp",
+                                     SaveFormat::Hfe, nullptr, err));
+  opt.to = SaveFormat::Dsk;
+  r = flux_convert_tree({dir_.string()}, opt);
+  ASSERT_EQ(r.size(), 2u);
+  EXPECT_EQ(r[0].status, Status::Converted) << r[0].error;
+  EXPECT_EQ(r[1].status, Status::Skipped);
+  EXPECT_NE(r[1].error.find("same output"), std::string::npos);
+
+  r = flux_convert_tree({(dir_ / "missing").string()}, opt);
+  ASSERT_EQ(r.size(), 1u);
+  EXPECT_EQ(r[0].status, Status::Failed);
+}
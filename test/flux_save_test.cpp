@@ -188,8 +188,8 @@ TEST(FluxSave, SectorBackedSavesDskEqualToImage) {
   EXPECT_EQ(out, dsk) << "sector-backed DSK save == the live image";
 }
 
-// Drive B (unit 1) is sector-only and sourced from the FDC's media1 image, not
-// the legacy driveB struct.
+// A sector disc in drive B (unit 1) is sourced from the FDC's media1 image,
+// not the legacy driveB struct.
 TEST(FluxSave, DriveBSectorImageFromLiveMedium) {
   std::vector<uint8_t> dsk(0x100 + 102 * (0x100 + 8192), 0);
   const std::vector<uint8_t> scp = scp_from_sectors(amsdos_content(2));
@@ -204,7 +204,7 @@ TEST(FluxSave, DriveBSectorImageFromLiveMedium) {
 
   const FluxSaveCaps caps = flux_save_caps_dev(&dev, 1);
   EXPECT_TRUE(caps.can_dsk);
-  EXPECT_FALSE(caps.can_scp) << "flux is drive-A-only";
+  EXPECT_FALSE(caps.can_scp) << "drive B holds a sector disc";
 
   std::string err;
   const std::vector<uint8_t> out =
@@ -346,6 +346,33 @@ TEST(FluxSave, PureCoreSectorAndUnsupported) {
   EXPECT_FALSE(err.empty());
 }
 
+// The flux writers are side-0 only: a double-sided capture is refused as
+// .scp/.hfe (it would lose side 1) and still saves as .dsk.
+TEST(FluxSave, PureCoreRefusesDoubleSidedFluxExport) {
+  const std::vector<std::vector<Sector>> src = amsdos_content(2);
+  Prng rng(0x51DE);
+  std::vector<std::vector<std::vector<uint32_t>>> tracks;
+  for (const std::vector<Sector>& cyl : src)  // each cylinder, both heads
+    for (int head = 0; head < 2; ++head)
+      tracks.push_back({bits_to_flux(track_bits(cyl), 80.0, 0.0, &rng)});
+  const std::vector<uint8_t> scp = build_scp(tracks, 2);
+  ASSERT_EQ(flux_scp_heads(scp.data(), scp.size()), 2);
+  const std::vector<uint8_t> image = {1, 2, 3, 4, 5};
+  for (SaveFormat fmt : {SaveFormat::Scp, SaveFormat::Hfe}) {
+    std::string err;
+    const std::vector<uint8_t> out = flux_save_bytes_from_medium(
+        scp.data(), scp.size(), image.data(), image.size(), nullptr, 0, fmt,
+        err);
+    EXPECT_TRUE(out.empty());
+    EXPECT_NE(err.find(".dsk"), std::string::npos) << err;
+  }
+  std::string err;
+  EXPECT_EQ(flux_save_bytes_from_medium(scp.data(), scp.size(), image.data(),
+                                        image.size(), nullptr, 0,
+                                        SaveFormat::Dsk, err),
+            image);
+}
+
 // A null Device / inactive engine is handled without a crash.
 TEST(FluxSave, NullDeviceReportsError) {
   std::string err;
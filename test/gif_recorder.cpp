@@ -2,6 +2,17 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
 TEST(GifRecorderTest, DestructorWithoutRecordingDoesNotCrash) {
   // A GifRecorder that was never started should destroy cleanly.
   GifRecorder gif;
@@ -19,3 +30,260 @@ TEST(GifRecorderTest, FrameCountStartsAtZero) {
   GifRecorder gif;
   EXPECT_EQ(gif.frame_count(), 0);
 }
+
+namespace {
+
+// Minimal GIF89a reader for the round-trip tests: composites every image onto
+// a canvas (disposal "keep", transparency honoured) and returns the canvas
+// after each frame plus the frame delays and local colour tables.
+struct DecodedGif {
+  int w = 0, h = 0;
+  std::vector<std::vector<uint32_t>> frames;  // 0x00RRGGBB
+  std::vector<std::vector<uint32_t>> tables;  // each frame's local table
+  std::vector<int> delays;
+  bool ok = false;
+};
+
+std::vector<uint8_t> lzw_decode(const std::vector<uint8_t>& data, int min_bits,
+                                size_t want) {
+  std::vector<uint8_t> out;
+  const int clear = 1 << min_bits;
+  std::vector<std::vector<uint8_t>> dict;
+  auto reset = [&] {
+    dict.assign(static_cast<size_t>(clear) + 2, {});
+    for (int i = 0; i < clear; ++i) dict[i] = {static_cast<uint8_t>(i)};
+  };
+  reset();
+  int bits = min_bits + 1;
+  size_t bitpos = 0;
+  int prev = -1;
+  while (out.size() < want && bitpos + bits <= data.size() * 8) {
+    int code = 0;
+    for (int i = 0; i < bits; ++i, ++bitpos)
+      code |= ((data[bitpos / 8] >> (bitpos % 8)) & 1) << i;
+    if (code == clear) {
+      reset();
+      bits = min_bits + 1;
+      prev = -1;
+      continue;
+    }
+    if (code == clear + 1) break;
+    std::vector<uint8_t> entry;
+    if (code < static_cast<int>(dict.size())) {
+      entry = dict[code];
+    } else {
+      entry = dict[prev];
+      entry.push_back(dict[prev][0]);
+    }
+    out.insert(out.end(), entry.begin(), entry.end());
+    if (prev >= 0 && dict.size() < 4096) {
+      std::vector<uint8_t> add = dict[prev];
+      add.push_back(entry[0]);
+      dict.push_back(add);
+      if (dict.size() == (1u << bits) && bits < 12) bits++;
+    }
+    prev = code;
+  }
+  return out;
+}
+
+DecodedGif read_gif(const std::string& path) {
+  DecodedGif g;
+  std::ifstream f(path, std::ios::binary);
+  std::vector<uint8_t> b((std::istreambuf_iterator<char>(f)),
+                         std::istreambuf_iterator<char>());
+  if (b.size() < 13 || std::memcmp(b.data(), "GIF89a", 6) != 0) return g;
+  g.w = b[6] | (b[7] << 8);
+  g.h = b[8] | (b[9] << 8);
+  std::vector<uint32_t> canvas(static_cast<size_t>(g.w) * g.h, 0);
+  size_t p = 13;
+  if (b[10] & 0x80) p += 3u << ((b[10] & 7) + 1);
+  int delay = 0, transp = -1;
+  auto sub_blocks = [&](std::vector<uint8_t>* into) {
+    while (p < b.size() && b[p] != 0) {
+      if (into) into->insert(into->end(), b.begin() + p + 1,
+                             b.begin() + p + 1 + b[p]);
+      p += b[p] + 1;
+    }
+    p++;
+  };
+  while (p < b.size()) {
+    const uint8_t tag = b[p++];
+    if (tag == 0x3B) {
+      g.ok = true;
+      break;
+    }
+    if (tag == 0x21) {
+      const uint8_t label = b[p++];
+      if (label == 0xF9) {
+        delay = b[p + 2] | (b[p + 3] << 8);
+        transp = (b[p + 1] & 1) ? b[p + 4] : -1;
+      }
+      sub_blocks(nullptr);
+      continue;
+    }
+    if (tag != 0x2C) return g;
+    const int x0 = b[p] | (b[p + 1] << 8), y0 = b[p + 2] | (b[p + 3] << 8);
+    const int rw = b[p + 4] | (b[p + 5] << 8), rh = b[p + 6] | (b[p + 7] << 8);
+    const uint8_t flags = b[p + 8];
+    p += 9;
+    std::vector<uint32_t> pal;
+    if (flags & 0x80) {
+      for (int i = 0; i < (1 << ((flags & 7) + 1)); ++i, p += 3)
+        pal.push_back((b[p] << 16) | (b[p + 1] << 8) | b[p + 2]);
+    }
+    g.tables.push_back(pal);
+    const int min_bits = b[p++];
+    std::vector<uint8_t> data;
+    sub_blocks(&data);
+    const std::vector<uint8_t> idx =
+        lzw_decode(data, min_bits, static_cast<size_t>(rw) * rh);
+    if (idx.size() != static_cast<size_t>(rw) * rh) return g;
+    for (int y = 0; y < rh; ++y)
+      for (int x = 0; x < rw; ++x) {
+        const uint8_t i = idx[(static_cast<size_t>(y) * rw) + x];
+        if (i == transp) continue;
+        canvas[(static_cast<size_t>(y0 + y) * g.w) + x0 + x] = pal.at(i);
+      }
+    g.frames.push_back(canvas);
+    g.delays.push_back(delay);
+  }
+  return g;
+}
+
+// A 4-byte-per-pixel frame (R,G,B,x) from a packed 0x00RRGGBB canvas.
+std::vector<uint8_t> to_rgba(const std::vector<uint32_t>& c) {
+  std::vector<uint8_t> out;
+  for (uint32_t v : c)
+    out.insert(out.end(), {static_cast<uint8_t>(v >> 16),
+                           static_cast<uint8_t>(v >> 8),
+                           static_cast<uint8_t>(v), 0xFF});
+  return out;
+}
+
+}  // namespace
+
+TEST(GifRecorderTest, RoundTripsExactColoursWithDeltaFramesAndMergedDelays) {
+  constexpr int kW = 96, kH = 40;
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "koncpc_gif_rt.gif").string();
+  // CPC-like content: 27-level colours in noisy blocks, then a small change,
+  // then a repeat of that frame (must merge into the previous delay).
+  std::vector<uint32_t> a(static_cast<size_t>(kW) * kH);
+  for (size_t i = 0; i < a.size(); ++i) {
+    const uint32_t lv[3] = {0x00, 0x80, 0xFF};
+    a[i] = (lv[(i * 7) % 3] << 16) | (lv[(i / 5) % 3] << 8) | lv[(i / 13) % 3];
+  }
+  std::vector<uint32_t> b = a;
+  for (int y = 10; y < 14; ++y)
+    for (int x = 30; x < 50; ++x) b[(static_cast<size_t>(y) * kW) + x] = 0xFF80;
+
+  GifRecorder gif;
+  ASSERT_TRUE(gif.begin(path, kW, kH, 2));
+  for (const auto* f : {&a, &b, &b, &a}) {
+    const std::vector<uint8_t> px = to_rgba(*f);
+    ASSERT_TRUE(gif.add_frame(px.data(), kW * 4));
+  }
+  EXPECT_EQ(gif.frame_count(), 4);
+  ASSERT_TRUE(gif.end());
+  EXPECT_FALSE(gif.is_recording());
+
+  const DecodedGif d = read_gif(path);
+  std::remove(path.c_str());
+  ASSERT_TRUE(d.ok);
+  ASSERT_EQ(d.frames.size(), 3u);  // the repeated frame merged
+  EXPECT_EQ(d.frames[0], a);
+  EXPECT_EQ(d.frames[1], b);
+  EXPECT_EQ(d.frames[2], a);
+  EXPECT_EQ(d.delays, (std::vector<int>{2, 4, 2}));
+}
+
+TEST(GifRecorderTest, ManyColourFramesStillDecodeAndLzwTableResets) {
+  // > 255 colours forces the colour-cube fallback; 256x64 noise overflows
+  // the 4096-entry LZW dictionary several times.
+  constexpr int kW = 256, kH = 64;
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "koncpc_gif_many.gif").string();
+  std::vector<uint32_t> c(static_cast<size_t>(kW) * kH);
+  uint32_t s = 12345;
+  for (auto& v : c) {
+    s = (s * 1103515245u) + 12345u;
+    v = (s >> 8) & 0xFFFFFF;
+  }
+  GifRecorder gif;
+  ASSERT_TRUE(gif.begin(path, kW, kH));
+  const std::vector<uint8_t> px = to_rgba(c);
+  ASSERT_TRUE(gif.add_frame(px.data(), kW * 4));
+  ASSERT_TRUE(gif.end());
+  const DecodedGif d = read_gif(path);
+  std::remove(path.c_str());
+  ASSERT_TRUE(d.ok);
+  ASSERT_EQ(d.frames.size(), 1u);
+  for (size_t i = 0; i < c.size(); ++i) {  // within one cube step per channel
+    for (int sh : {16, 8, 0}) {
+      const int want = static_cast<int>((c[i] >> sh) & 0xFF);
+      const int got = static_cast<int>((d.frames[0][i] >> sh) & 0xFF);
+      ASSERT_LE(std::abs(want - got), 52) << "pixel " << i;
+    }
+  }
+}
+
+// Delta frames reserve colour 0 for transparency and still write its table
+// entry, which must come from a set value rather than whatever the worker's
+// stack held (in practice the previous frame's palette). The same frames must
+// encode to the same bytes, and a delta frame's table must not depend on the
+// colours of the frame before it.
+TEST(GifRecorderTest, DeltaFramesEncodeDeterministically) {
+  constexpr int kW = 32, kH = 16;
+  std::vector<uint32_t> p(static_cast<size_t>(kW) * kH, 0x000080);
+  p[0] = 0xFF0000;  // the first colour of p's palette
+  std::vector<uint32_t> q = p;
+  q[0] = 0x00FF00;  // ... and of q's
+  std::vector<uint32_t> c = p;  // repaints pixel 0, so c is the same delta
+  c[0] = 0xFFFF00;              // over p and over q
+  for (int x = 4; x < 12; ++x) c[(static_cast<size_t>(5) * kW) + x] = 0xFFFF00;
+  auto encode = [&](const std::string& name,
+                    std::initializer_list<const std::vector<uint32_t>*> fs) {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / name).string();
+    GifRecorder gif;
+    EXPECT_TRUE(gif.begin(path, kW, kH));
+    for (const auto* f : fs) {
+      const std::vector<uint8_t> px = to_rgba(*f);
+      EXPECT_TRUE(gif.add_frame(px.data(), kW * 4));
+    }
+    EXPECT_TRUE(gif.end());
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)),
+                            std::istreambuf_iterator<char>());
+    const DecodedGif d = read_gif(path);
+    std::remove(path.c_str());
+    return std::make_pair(bytes, d);
+  };
+  const auto first = encode("koncpc_gif_det1.gif", {&p, &c});
+  const auto again = encode("koncpc_gif_det2.gif", {&p, &c});
+  ASSERT_FALSE(first.first.empty());
+  EXPECT_EQ(first.first, again.first) << "same frames, same bytes";
+
+  const auto other = encode("koncpc_gif_det3.gif", {&q, &c});
+  ASSERT_TRUE(first.second.ok);
+  ASSERT_TRUE(other.second.ok);
+  ASSERT_EQ(first.second.tables.size(), 2u);
+  ASSERT_EQ(other.second.tables.size(), 2u);
+  EXPECT_EQ(first.second.tables[1], other.second.tables[1])
+      << "the delta frame's table leaked the previous frame's palette";
+  EXPECT_EQ(first.second.tables[1].at(0), 0u) << "transparent slot";
+  EXPECT_EQ(other.second.frames[1], c);
+}
+
+TEST(GifRecorderTest, AbortRemovesThePartialFile) {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "koncpc_gif_abort.gif").string();
+  GifRecorder gif;
+  ASSERT_TRUE(gif.begin(path, 8, 8));
+  const std::vector<uint8_t> px(8 * 8 * 4, 0x40);
+  ASSERT_TRUE(gif.add_frame(px.data(), 8 * 4));
+  gif.abort();
+  EXPECT_FALSE(gif.is_recording());
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
@@ -268,6 +268,45 @@ TEST(Asic, RegisterDecodeSpritesPaletteDma) {
   EXPECT_EQ(en, 0) << "channel 0 was not enabled";
 }
 
+// The sprite layer's bulk row read and its key: asic_vid_sprite_row is the
+// row-at-once form of asic_vid_sprite_pixel, and only a pixel write moves
+// asic_vid_sprite_gen (attributes/palette ride asic_vid_gen). A load re-keys
+// it past every value seen, and the blob stays canonical (generation zeroed).
+TEST(Asic, SpriteRowAndPixelGeneration) {
+  AsicRig rig;
+  make_rig(rig);
+  unlock_and_map(rig);
+
+  const uint32_t g0 = asic_vid_sprite_gen(&rig.asic);
+  for (int x = 0; x < 16; ++x)
+    cpu_write(rig, static_cast<uint16_t>(0x4000 | (7 << 8) | (9 << 4) | x),
+              static_cast<uint8_t>(x ^ 5));
+  const uint32_t g1 = asic_vid_sprite_gen(&rig.asic);
+  EXPECT_NE(g1, g0) << "a pixel write moves the sprite generation";
+
+  uint8_t row[16];
+  asic_vid_sprite_row(&rig.asic, 7, 9, row);
+  for (int x = 0; x < 16; ++x)
+    EXPECT_EQ(row[x], asic_vid_sprite_pixel(&rig.asic, 7, x, 9)) << "x=" << x;
+
+  cpu_write(rig, 0x6400, 0x12);      // palette
+  cpu_write(rig, 0x6000 + 7 * 8, 3);  // sprite 7 X low
+  EXPECT_EQ(asic_vid_sprite_gen(&rig.asic), g1)
+      << "attribute/palette writes leave the pixel generation alone";
+
+  std::vector<uint8_t> a(rig.asic.state_size(rig.asic.self));
+  std::vector<uint8_t> b(a.size());
+  rig.asic.save(rig.asic.self, a.data());
+  cpu_write(rig, 0x4000 | (7 << 8) | (9 << 4), 0x05);  // same value, gen moves
+  rig.asic.save(rig.asic.self, b.data());
+  EXPECT_EQ(a, b) << "the generation never enters the blob";
+  const uint32_t live = asic_vid_sprite_gen(&rig.asic);
+  rig.asic.load(rig.asic.self, a.data());
+  EXPECT_GT(asic_vid_sprite_gen(&rig.asic), live) << "load re-keys";
+  asic_vid_sprite_row(&rig.asic, 7, 9, row);
+  EXPECT_EQ(row[3], 3 ^ 5) << "pixels round-trip";
+}
+
 // Regression (Burnin' Rubber title derail): the &4000-&7FFF register page is
 // overlaid only when the ASIC is BOTH unlocked AND paged in by RMR2 (its
 // membank field == 3). The unlock knock alone must NOT map it. Games unlock the
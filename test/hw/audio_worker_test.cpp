@@ -0,0 +1,199 @@
+/* audio_worker_test.cpp — Machine::set_audio_worker: the PSG and DACs
+ * rendered on a worker thread from the register-write timeline are the
+ * in-thread audio, bit for bit.
+ *
+ * The oracle runs twin machines, one with the worker, through a program that
+ * exercises every input of the mix: the firmware's MC SOUND REGISTER
+ * (&BD34) sets up tone, noise and a repeating hardware envelope, then a
+ * loop steps the Digiblaster DAC on the printer port while the envelope
+ * runs. After every run the twins must agree on the samples, the PSG's
+ * whole sound state (copied back from the replica) and RAM. */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "hw/psg.h"
+#include "subcycle/machine.h"
+
+namespace {
+
+using RunTier = subcycle::Machine::RunTier;
+
+std::vector<uint8_t> read_file(const char* path) {
+  std::ifstream f(path, std::ios::binary);
+  return std::vector<uint8_t>((std::istreambuf_iterator<char>(f)),
+                              std::istreambuf_iterator<char>());
+}
+
+// At &8000: for each (reg, value) pair of the table, CALL &BD34; then step
+// the Digiblaster (OUT (&EFxx), A) by 13 every ~60 µs, forever.
+const uint8_t kProgram[] = {
+    0x21, 0x30, 0x80,  // 8000 ld hl,table
+    0x7E,              // 8003 ld a,(hl)
+    0xFE, 0xFF,        // 8004 cp &ff
+    0x28, 0x0B,        // 8006 jr z,dac (8013)
+    0x23,              // 8008 inc hl
+    0x4E,              // 8009 ld c,(hl)
+    0x23,              // 800A inc hl
+    0xE5,              // 800B push hl
+    0xCD, 0x34, 0xBD,  // 800C call &bd34 (MC SOUND REGISTER)
+    0xE1,              // 800F pop hl
+    0x18, 0xF1,        // 8010 jr 8003
+    0x00,              // 8012 (pad)
+    0x01, 0x00, 0xEF,  // 8013 dac: ld bc,&ef00
+    0x3E, 0x00,        // 8016 ld a,0
+    0xED, 0x79,        // 8018 out (c),a
+    0xC6, 0x0D,        // 801A add a,13
+    0x16, 0x0C,        // 801C ld d,12
+    0x15,              // 801E dec d
+    0x20, 0xFD,        // 801F jr nz,801E
+    0x18, 0xF5,        // 8021 jr 8018
+};
+const uint8_t kTable[] = {
+    0, 0x77, 1, 0x00,   // channel A tone
+    6, 0x0B,            // noise period
+    7, 0x36,            // tone A + noise B
+    8, 0x10, 9, 0x0C,   // A on the envelope, B fixed
+    11, 0x40, 12, 0x00, // envelope period
+    13, 0x0E,           // triangle, repeating
+    0xFF,
+};
+
+struct Twin {
+  subcycle::Machine m;
+  std::vector<int16_t> audio;  // this run's samples
+};
+
+void boot(Twin& t, const std::vector<uint8_t>& rom, RunTier tier, bool worker) {
+  ASSERT_TRUE(t.m.build(rom.data(), rom.size()));
+  t.m.set_run_tier(tier);
+  t.m.set_digiblaster(true);
+  t.m.set_audio_worker(worker);
+  ASSERT_EQ(t.m.audio_worker(), worker);
+}
+
+// The boot, then the program: PC at &8000 once BASIC is up.
+void start_program(Twin& t) {
+  for (size_t i = 0; i < sizeof(kProgram); ++i)
+    t.m.poke_mem(static_cast<uint16_t>(0x8000 + i), kProgram[i]);
+  for (size_t i = 0; i < sizeof(kTable); ++i)
+    t.m.poke_mem(static_cast<uint16_t>(0x8030 + i), kTable[i]);
+  Z80Regs r = t.m.regs();
+  r.pc = 0x8000;
+  t.m.set_regs(r);
+}
+
+void expect_same_sound_state(const subcycle::Machine& a,
+                             const subcycle::Machine& b, int run) {
+  PsgRegs pa{}, pb{};
+  psg_peek(a.psg(), &pa);
+  psg_peek(b.psg(), &pb);
+  EXPECT_EQ(std::memcmp(pa.reg, pb.reg, sizeof(pa.reg)), 0) << "run " << run;
+  EXPECT_EQ(pa.tone_out, pb.tone_out) << "run " << run;
+  EXPECT_EQ(pa.noise_out, pb.noise_out) << "run " << run;
+  EXPECT_EQ(pa.env_level, pb.env_level) << "run " << run;
+  EXPECT_EQ(pa.env_step, pb.env_step) << "run " << run;
+  EXPECT_EQ(std::memcmp(pa.chan_level, pb.chan_level, 3), 0) << "run " << run;
+}
+
+class AudioWorkerOracle : public ::testing::TestWithParam<RunTier> {
+ protected:
+  void SetUp() override {
+    rom_ = read_file("rom/cpc6128.rom");
+    if (rom_.size() < 0x8000) rom_ = read_file("../rom/cpc6128.rom");
+    if (rom_.size() < 0x8000) GTEST_SKIP() << "rom/cpc6128.rom not found";
+  }
+  std::vector<uint8_t> rom_;
+};
+
+}  // namespace
+
+// Whole frames, then 3.3 ms slices (runs that end mid-µs on either side of
+// a sound step): every run's samples and the PSG state match the in-thread
+// twin exactly.
+TEST_P(AudioWorkerOracle, WorkerAudioIsTheInThreadAudio) {
+  Twin ref, wk;
+  boot(ref, rom_, GetParam(), false);
+  boot(wk, rom_, GetParam(), true);
+  if (HasFatalFailure()) return;
+  for (int i = 0; i < 100; ++i) {
+    ref.m.run_frame();
+    wk.m.run_frame();
+  }
+  start_program(ref);
+  start_program(wk);
+
+  size_t samples = 0;
+  int peak = 0;
+  for (int run = 0; run < 160; ++run) {
+    if (run < 40) {
+      ref.m.run_frame();
+      wk.m.run_frame();
+    } else {
+      ref.m.run_slice(3300);
+      wk.m.run_slice(3300);
+    }
+    ASSERT_EQ(ref.m.audio().size(), wk.m.audio().size()) << "run " << run;
+    ASSERT_TRUE(ref.m.audio() == wk.m.audio()) << "samples differ, run " << run;
+    expect_same_sound_state(ref.m, wk.m, run);
+    if (HasFailure()) return;
+    samples += ref.m.audio().size();
+    for (int16_t s : ref.m.audio()) peak = std::max<int>(peak, s < 0 ? -s : s);
+  }
+  EXPECT_EQ(ref.m.master_cycle(), wk.m.master_cycle());
+  for (size_t a = 0; a < ref.m.ram_size(); ++a)
+    ASSERT_EQ(ref.m.ram_read(a), wk.m.ram_read(a)) << "RAM at " << a;
+  EXPECT_GT(samples, 40000u);
+  EXPECT_GT(peak, 2000) << "the program made sound";
+}
+
+INSTANTIATE_TEST_SUITE_P(Tiers, AudioWorkerOracle,
+                         ::testing::Values(RunTier::Faithful,
+                                           RunTier::Soldered, RunTier::Wake),
+                         [](const ::testing::TestParamInfo<RunTier>& info) {
+                           switch (info.param) {
+                             case RunTier::Faithful: return "Faithful";
+                             case RunTier::Soldered: return "Soldered";
+                             default: return "Wake";
+                           }
+                         });
+
+// Tier changes at frame boundaries hand the generator between the worker
+// (per-cycle frames) and the Fast batch (in-thread) without a seam, and the
+// worker can be switched off and on between runs.
+TEST(AudioWorker, HandsOverAcrossTiersAndToggles) {
+  std::vector<uint8_t> rom = read_file("rom/cpc6128.rom");
+  if (rom.size() < 0x8000) rom = read_file("../rom/cpc6128.rom");
+  if (rom.size() < 0x8000) GTEST_SKIP() << "rom/cpc6128.rom not found";
+  Twin ref, wk;
+  boot(ref, rom, RunTier::Wake, false);
+  boot(wk, rom, RunTier::Wake, true);
+  ref.m.set_digiblaster(false);  // the Fast batch stays off with a DAC wired
+  wk.m.set_digiblaster(false);
+  if (HasFatalFailure()) return;
+  for (int i = 0; i < 100; ++i) {
+    ref.m.run_frame();
+    wk.m.run_frame();
+  }
+  start_program(ref);
+  start_program(wk);
+  const RunTier cycle[] = {RunTier::Fast, RunTier::Wake, RunTier::Faithful,
+                           RunTier::Fast, RunTier::Soldered};
+  for (int frame = 0; frame < 150; ++frame) {
+    const RunTier tier = cycle[(frame / 7) % 5];
+    ref.m.set_run_tier(tier);
+    wk.m.set_run_tier(tier);
+    if (frame == 60) wk.m.set_audio_worker(false);
+    if (frame == 80) wk.m.set_audio_worker(true);
+    ref.m.run_frame();
+    wk.m.run_frame();
+    ASSERT_TRUE(ref.m.audio() == wk.m.audio()) << "frame " << frame;
+    expect_same_sound_state(ref.m, wk.m, frame);
+    if (HasFailure()) return;
+  }
+  EXPECT_GT(wk.m.fast_frames_run(), 0u) << "the Fast batch took part";
+}
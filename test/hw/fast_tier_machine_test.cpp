@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <fstream>
 #include <vector>
@@ -236,3 +237,77 @@ TEST(FastTierMachine, ResetUnderFastDoesNotRunAway) {
   EXPECT_LT(t.m.audio().size(), 4000u)
       << "machine did not recover to normal framing after reset";
 }
+
+// Render-less (hash-only) mode: both tiers fold the same cells in the same
+// order, so the per-frame hash must match exactly — the same contract the
+// framebuffer comparison above holds — while the framebuffer is never
+// touched. A static Ready screen hashes stably; the boot's changing screen
+// does not.
+TEST(FastTierMachine, HashOnlyFramesMatchWakeAndPaintNothing) {
+  std::vector<uint8_t> rom = read_file("rom/cpc6128.rom");
+  if (rom.size() < 0x8000) rom = read_file("../rom/cpc6128.rom");
+  if (rom.size() < 0x8000) GTEST_SKIP() << "rom/cpc6128.rom not found";
+
+  Twin fast, wake;
+  boot(fast, rom, subcycle::Machine::RunTier::Fast);
+  boot(wake, rom, subcycle::Machine::RunTier::Wake);
+  std::fill(fast.fb.begin(), fast.fb.end(), 0x5A);
+  fast.m.set_hash_only(true);
+  wake.m.set_hash_only(true);
+  wake.m.attach_framebuffer(nullptr, subcycle::kFbWidth, subcycle::kFbHeight);
+  ASSERT_TRUE(fast.m.hash_only());
+
+  std::vector<uint32_t> hashes;
+  for (int i = 0; i < 150; ++i) {
+    fast.frame();
+    wake.frame();
+    ASSERT_EQ(fast.m.frame_hash(), wake.m.frame_hash())
+        << "frame hash diverged at boot frame " << i;
+    hashes.push_back(fast.m.frame_hash());
+  }
+  for (uint8_t v : fast.fb) ASSERT_EQ(v, 0x5A) << "hash-only mode painted";
+  EXPECT_NE(hashes[20], hashes[149]) << "boot and Ready screen hash equal";
+  EXPECT_EQ(hashes[148], hashes[149]) << "static Ready screen hash unstable";
+
+  // Turning it off paints again.
+  fast.m.set_hash_only(false);
+  fast.frame();
+  int painted = 0;
+  for (uint8_t v : fast.fb)
+    if (v != 0x5A) painted++;
+  EXPECT_GT(painted, 100000);
+}
+
+// Frame skipping: a twin that paints one frame in three must match an
+// always-painting twin on every painted frame, keep the framebuffer frozen on
+// skipped ones, and end in a byte-identical device state — skipping changes
+// the pixel path only, never timing. Run per tier shape (batch and per-cycle).
+TEST(FastTierMachine, SkippedFramesKeepStateAndPaintOnlyShownFrames) {
+  std::vector<uint8_t> rom = read_file("rom/cpc6128.rom");
+  if (rom.size() < 0x8000) rom = read_file("../rom/cpc6128.rom");
+  if (rom.size() < 0x8000) GTEST_SKIP() << "rom/cpc6128.rom not found";
+
+  for (auto tier :
+       {subcycle::Machine::RunTier::Fast, subcycle::Machine::RunTier::Wake}) {
+    Twin ref, skip;
+    boot(ref, rom, tier);
+    boot(skip, rom, tier);
+    for (int i = 0; i < 120; ++i) {
+      const bool shown = (i % 3) == 2;
+      const uint64_t before = fnv1a(skip.fb.data(), kFbLen);
+      skip.m.set_skip_paint(!shown);
+      ref.frame();
+      skip.frame();
+      if (shown) {
+        ASSERT_EQ(fnv1a(ref.fb.data(), kFbLen), fnv1a(skip.fb.data(), kFbLen))
+            << "shown frame " << i << " differs from the painted twin";
+      } else {
+        ASSERT_EQ(before, fnv1a(skip.fb.data(), kFbLen))
+            << "skipped frame " << i << " painted";
+      }
+    }
+    EXPECT_EQ(ref.m.save_devices(), skip.m.save_devices())
+        << "frame skipping changed machine state";
+    EXPECT_EQ(ref.audio, skip.audio);
+  }
+}
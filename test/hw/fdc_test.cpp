@@ -7,6 +7,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
@@ -405,8 +406,8 @@ TEST(Fdc, ReadDataDeliversSectorAndResult) {
 // head_track, cmd_drive_status, the READ/WRITE byte serves, do_format — routes
 // by the selected unit (sel_media / track_pos[unit]). These started as RED
 // specs and now guard that wiring; the `unit=0` control assertions guard
-// against a broken harness masquerading as the feature. (Flux capture stays
-// drive-A-only — fdc_attach_flux only fills `media`.)
+// against a broken harness masquerading as the feature. (Flux media on drive
+// B are covered with the FdcFlux tests.)
 
 TEST(Fdc, DualDriveB_Unit1ReportsReadyWhenDiskAttached) {
   FdcRig rig;
@@ -618,6 +619,12 @@ TEST(Fdc, WriteDataRoundTripMutatesTheImage) {
   EXPECT_EQ(r[0] & 0x40, 0x40) << "ST0: AT (normal EOT termination)";
   EXPECT_EQ(r[1], 0x80) << "ST1: End of Cylinder only";
   EXPECT_EQ(fdc_media_dirty(&rig.dev), 1) << "the image diverged";
+  int ntracks = 0;
+  const uint8_t* written = fdc_media_written_tracks(&rig.dev, ntracks);
+  ASSERT_NE(written, nullptr);
+  ASSERT_GE(ntracks, 2);
+  EXPECT_EQ(written[0], 0x01) << "write-back map: track 0, side 0 only";
+  EXPECT_EQ(written[1], 0x00);
 
   // The bytes must be readable back through the chip...
   command(rig, {0x46, 0x00, 0x00, 0x00, 0xC1, 0x02, 0xC2, 0x2A, 0xFF});
@@ -630,6 +637,7 @@ TEST(Fdc, WriteDataRoundTripMutatesTheImage) {
 
   fdc_media_mark_clean(&rig.dev);
   EXPECT_EQ(fdc_media_dirty(&rig.dev), 0);
+  EXPECT_EQ(written[0], 0x00) << "mark_clean empties the write-back map";
 }
 
 TEST(Fdc, WriteUnderfeedOverruns) {
@@ -690,6 +698,9 @@ TEST(Fdc, FormatTrackRewritesTheTrackInPlace) {
   ASSERT_EQ(r.size(), 7u);
   EXPECT_EQ(r[0] & 0xC0, 0x00) << "ST0: normal termination";
   EXPECT_EQ(fdc_media_dirty(&rig.dev), 1);
+  int ntracks = 0;
+  EXPECT_EQ(fdc_media_written_tracks(&rig.dev, ntracks)[0], 0x01)
+      << "the formatted track is queued for write-back";
 
   // READ ID must now serve the fresh IDs; the data must be the filler.
   command(rig, {0x0A, 0x00});
@@ -913,6 +924,7 @@ TEST(FdcBoot, AmsdosCataloguesTheDisc) {
 #include "flux_synth.h"
 #include "hw/a2r.h"
 #include "hw/flux.h"
+#include "subcycle/flux_predecode.h"
 
 namespace {
 using namespace fluxsynth;
@@ -996,6 +1008,202 @@ TEST(FdcFlux, WeakSectorAlternatesAcrossReadsPhysically) {
       << "every read returned one of the captures";
 }
 
+// The background pre-decode (flux-media.md §7a): with a finished
+// FluxPredecoder wired as the flux source, every cache miss is served from
+// its table — the same bytes the lazy decode reads — across a seek.
+TEST(FdcFlux, ServesPreDecodedTracksAcrossSeeks) {
+  FdcRig rig;
+  make_fdc(rig);
+  const std::vector<std::vector<Sector>> src = amsdos_content(2);
+  const std::vector<uint8_t> scp = scp_from_sectors(src);
+  ASSERT_EQ(fdc_attach_flux(&rig.dev, scp.data(), scp.size()), 0);
+  subcycle::FluxPredecoder pre(scp.data(), scp.size(), 2);
+  pre.wait();
+  ASSERT_TRUE(pre.done());
+  struct Counted {
+    subcycle::FluxPredecoder* pre;
+    int hits;
+  } counted{&pre, 0};
+  fdc_set_flux_source(
+      &rig.dev,
+      [](void* ctx, uint8_t cyl, uint8_t head, uint8_t rev,
+         const FluxTrack** t, const uint8_t** p) {
+        Counted* c = static_cast<Counted*>(ctx);
+        const int ok =
+            subcycle::FluxPredecoder::lookup(c->pre, cyl, head, rev, t, p);
+        c->hits += ok;
+        return ok;
+      },
+      &counted);
+  motor_on_ready(rig);
+
+  for (uint8_t cyl = 0; cyl < 2; ++cyl) {
+    if (cyl > 0) {
+      command(rig, {0x0F, 0x00, cyl});  // SEEK
+      spin_ms(rig, 32 + 1);
+      command(rig, {0x08});
+      read_result(rig, 2);
+    }
+    command(rig, {0x46, 0x00, cyl, 0x00, 0xC3, 0x02, 0xC3, 0x2A, 0xFF});
+    const std::vector<uint8_t> data = read_result(rig, 512);
+    const Sector* c3 = nullptr;
+    for (const Sector& s : src[cyl])
+      if (s.r == 0xC3) c3 = &s;
+    ASSERT_NE(c3, nullptr);
+    ASSERT_EQ(data.size(), c3->data.size());
+    EXPECT_EQ(std::memcmp(data.data(), c3->data.data(), data.size()), 0)
+        << "cylinder " << int(cyl);
+    read_result(rig, 7);
+  }
+  EXPECT_EQ(counted.hits, 2) << "one pre-decoded revolution per cylinder";
+}
+
+namespace {
+
+// SEEK `unit` to `cyl` and acknowledge the seek-end interrupt.
+void seek_flux(FdcRig& rig, uint8_t unit, uint8_t cyl) {
+  command(rig, {0x0F, unit, cyl});
+  spin_ms(rig, (2 * 32) + 1);
+  command(rig, {0x08});
+  read_result(rig, 2);
+}
+
+// READ DATA of one 512-byte sector; the result phase is drained.
+std::vector<uint8_t> read_flux_sector(FdcRig& rig, uint8_t unit, uint8_t head,
+                                      uint8_t cyl, uint8_t r) {
+  command(rig, {0x46, static_cast<uint8_t>((head << 2) | unit), cyl, head, r,
+                0x02, r, 0x2A, 0xFF});
+  std::vector<uint8_t> data = read_result(rig, 512);
+  read_result(rig, 7);
+  return data;
+}
+
+}  // namespace
+
+// A double-sided dump answers both heads (flux-media.md §5): side 1 carries
+// its own sectors (H = 1), read through HD = 1 on every cylinder.
+TEST(FdcFlux, ReadsBothSidesOfADoubleSidedDump) {
+  FdcRig rig;
+  make_fdc(rig);
+  const std::vector<std::vector<Sector>> side0 = amsdos_content(2);
+  std::vector<std::vector<Sector>> side1 = side0;
+  for (std::vector<Sector>& cyl : side1)
+    for (Sector& s : cyl) {
+      s.h = 1;
+      std::fill(s.data.begin(), s.data.end(), static_cast<uint8_t>(0x10 + s.c));
+    }
+  Prng rng(0x2517);
+  std::vector<std::vector<std::vector<uint32_t>>> tracks;
+  for (size_t c = 0; c < side0.size(); ++c) {
+    tracks.push_back({bits_to_flux(track_bits(side0[c]), 80.0, 0.0, &rng)});
+    tracks.push_back({bits_to_flux(track_bits(side1[c]), 80.0, 0.0, &rng)});
+  }
+  const std::vector<uint8_t> scp = build_scp(tracks, 2);
+  ASSERT_EQ(flux_scp_heads(scp.data(), scp.size()), 2);
+  ASSERT_EQ(fdc_attach_flux(&rig.dev, scp.data(), scp.size()), 0);
+  motor_on_ready(rig);
+
+  for (uint8_t cyl = 0; cyl < 2; ++cyl) {
+    if (cyl > 0) seek_flux(rig, 0, cyl);
+    const std::vector<uint8_t> h0 = read_flux_sector(rig, 0, 0, cyl, 0xC1);
+    ASSERT_EQ(h0.size(), 512u);
+    EXPECT_EQ(h0, side0[cyl][0].data) << "side 0, cylinder " << int(cyl);
+    const std::vector<uint8_t> h1 = read_flux_sector(rig, 0, 1, cyl, 0xC1);
+    ASSERT_EQ(h1.size(), 512u);
+    EXPECT_EQ(h1[0], 0x10 + cyl) << "side 1, cylinder " << int(cyl);
+    EXPECT_EQ(h1[511], 0x10 + cyl);
+  }
+}
+
+// Drive B plays flux too, next to a DSK in drive A: a two-drive copy setup.
+TEST(FdcFlux, DriveBPlaysFluxBesideADiskInDriveA) {
+  FdcRig rig;
+  make_fdc(rig);
+  std::vector<uint8_t> dsk = build_dsk(2);
+  paint_sectors(dsk, 0xAA);
+  const std::vector<std::vector<Sector>> src = amsdos_content(2);
+  const std::vector<uint8_t> scp = scp_from_sectors(src);
+  ASSERT_EQ(fdc_attach_disk(&rig.dev, dsk.data(), dsk.size(), 0), 0);
+  ASSERT_EQ(fdc_attach_flux(&rig.dev, scp.data(), scp.size(), 1), 0);
+  motor_on_ready(rig);
+
+  command(rig, {0x04, 0x01});  // SENSE DRIVE STATUS, drive B
+  EXPECT_EQ(read_result(rig, 1)[0] & 0x60, 0x60) << "RY | WP: read-only flux";
+  EXPECT_EQ(read_flux_sector(rig, 0, 0, 0, 0xC1)[0], 0xAA) << "drive A: DSK";
+  seek_flux(rig, 1, 1);
+  EXPECT_EQ(read_flux_sector(rig, 1, 0, 1, 0xC3), src[1][2].data)
+      << "drive B: flux, after its own seek";
+  size_t len = 0;
+  EXPECT_EQ(fdc_media_flux_scp(&rig.dev, len, 1), scp.data());
+  EXPECT_EQ(fdc_media_flux_scp(&rig.dev, len, 0), nullptr);
+}
+
+// Every captured revolution takes its turn under the head (flux-media.md
+// §7), and with a cache big enough for them all (§7b) each is decoded once:
+// re-reads rotate through the captures without decoding anything again.
+TEST(FdcFlux, EveryCaptureRotatesWithoutReDecoding) {
+  FdcRig rig;
+  make_fdc(rig);
+  std::vector<uint8_t> cache((16 * fdc_flux_slot_size()) + 64);
+  fdc_set_flux_cache(&rig.dev, cache.data(), cache.size());
+  constexpr int kRevs = 5;
+  const std::vector<std::vector<Sector>> src = amsdos_content(1);
+  Prng rng(0x7EA5);
+  std::vector<std::vector<uint32_t>> revs;
+  for (int r = 0; r < kRevs; ++r) {
+    std::vector<std::vector<Sector>> cap = src;
+    std::memset(cap[0][4].data.data() + 100, 0x50 + r, 16);  // C5 differs
+    revs.push_back(bits_to_flux(track_bits(cap[0]), 80.0, 0.0, &rng));
+  }
+  const std::vector<uint8_t> scp = build_scp({revs});
+  ASSERT_EQ(fdc_attach_flux(&rig.dev, scp.data(), scp.size()), 0);
+  motor_on_ready(rig);
+
+  bool seen[kRevs] = {};
+  for (int pass = 0; pass < 15; ++pass) {
+    const std::vector<uint8_t> data = read_flux_sector(rig, 0, 0, 0, 0xC5);
+    ASSERT_EQ(data.size(), 512u);
+    const int r = data[100] - 0x50;
+    ASSERT_TRUE(r >= 0 && r < kRevs) << "every read returned one capture";
+    seen[r] = true;
+    spin_ms(rig, 73);  // decorrelate the next read from the revolution
+  }
+  int distinct = 0;
+  for (bool s : seen) distinct += s ? 1 : 0;
+  EXPECT_GT(distinct, 2) << "more than two captures rotate";
+
+  FdcRegs f{};
+  fdc_peek(&rig.dev, &f);
+  EXPECT_GE(f.flux_slots, 16u);
+  EXPECT_LE(f.flux_fills, static_cast<uint32_t>(kRevs))
+      << "each capture decoded at most once";
+}
+
+// A cache of two tracks evicts the least recently used one: re-reading
+// cylinder 0 between the others keeps it resident.
+TEST(FdcFlux, SmallCacheEvictsTheLeastRecentlyUsedTrack) {
+  FdcRig rig;
+  make_fdc(rig);
+  std::vector<uint8_t> cache((2 * fdc_flux_slot_size()) + 64);
+  fdc_set_flux_cache(&rig.dev, cache.data(), cache.size());
+  const std::vector<std::vector<Sector>> src = amsdos_content(3);
+  const std::vector<uint8_t> scp = scp_from_sectors(src);
+  ASSERT_EQ(fdc_attach_flux(&rig.dev, scp.data(), scp.size()), 0);
+  motor_on_ready(rig);
+
+  uint8_t at = 0;
+  for (uint8_t cyl : {0, 1, 0, 2, 0}) {
+    if (cyl != at) seek_flux(rig, 0, cyl);
+    at = cyl;
+    EXPECT_EQ(read_flux_sector(rig, 0, 0, cyl, 0xC2), src[cyl][1].data)
+        << "cylinder " << int(cyl);
+  }
+  FdcRegs f{};
+  fdc_peek(&rig.dev, &f);
+  EXPECT_EQ(f.flux_slots, 2u);
+  EXPECT_EQ(f.flux_fills, 3u) << "cylinder 0 never left the cache";
+}
+
 // beads-mwpg: validate the flux decoder against a REAL SuperCard Pro capture,
 // not our own synth encoder (the FdcFlux tests above round-trip through
 // scp_from_sectors / build_scp, so an encoder+decoder shared bug is invisible).
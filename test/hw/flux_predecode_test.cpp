@@ -0,0 +1,146 @@
+/* flux_predecode_test.cpp — subcycle::FluxPredecoder: the background pool's
+ * table is exactly what flux_decode_track returns for every cylinder, side and
+ * captured revolution, however many workers race for the cylinders, and a
+ * stopped pool never publishes a half-decoded cylinder. */
+
+#include "subcycle/flux_predecode.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "flux_synth.h"
+#include "hw/flux.h"
+
+namespace {
+
+using namespace fluxsynth;
+
+// Three cylinders, two captures each; capture 1 of cylinder 1 carries a
+// weak sector, so the revolutions genuinely differ.
+std::vector<uint8_t> weak_disc() {
+  const std::vector<std::vector<Sector>> src = amsdos_content(3);
+  std::vector<std::vector<Sector>> rev1 = src;
+  std::memset(rev1[1][2].data.data() + 40, 0xE5, 32);
+  Prng rng(0x5EED);
+  std::vector<std::vector<std::vector<uint32_t>>> tracks;
+  for (size_t t = 0; t < src.size(); ++t)
+    tracks.push_back({bits_to_flux(track_bits(src[t]), 80.0, 0.0, &rng),
+                      bits_to_flux(track_bits(rev1[t]), 80.0, 0.0, &rng)});
+  return build_scp(tracks);
+}
+
+void expect_same_track(const FluxTrack& a, const uint8_t* pa,
+                       const FluxTrack& b, const uint8_t* pb, int cyl,
+                       int rev) {
+  ASSERT_EQ(a.count, b.count) << "cyl " << cyl << " rev " << rev;
+  ASSERT_EQ(a.payload_used, b.payload_used) << "cyl " << cyl << " rev " << rev;
+  EXPECT_EQ(std::memcmp(a.sec, b.sec, sizeof(FluxSector) * a.count), 0)
+      << "sector map, cyl " << cyl << " rev " << rev;
+  EXPECT_EQ(std::memcmp(pa, pb, a.payload_used), 0)
+      << "payload, cyl " << cyl << " rev " << rev;
+}
+
+}  // namespace
+
+TEST(FluxPredecode, TableIsTheLazyDecodeForEveryTrack) {
+  const std::vector<uint8_t> scp = weak_disc();
+  for (unsigned threads : {1u, 3u}) {
+    subcycle::FluxPredecoder pre(scp.data(), scp.size(), threads);
+    pre.wait();
+    ASSERT_TRUE(pre.done());
+    ASSERT_EQ(pre.cylinders(), 3);
+    ASSERT_EQ(pre.revolutions(), 2);
+    for (int c = 0; c < 3; ++c) {
+      for (int r = 0; r < 4; ++r) {  // revs 2, 3 wrap to the captures
+        const FluxTrack* t = nullptr;
+        const uint8_t* p = nullptr;
+        ASSERT_EQ(subcycle::FluxPredecoder::lookup(
+                      &pre, static_cast<uint8_t>(c), 0,
+                      static_cast<uint8_t>(r), &t, &p),
+                  1);
+        FluxTrack lazy{};
+        std::vector<uint8_t> pay(8192);
+        ASSERT_EQ(flux_decode_track_rev(scp.data(), scp.size(),
+                                        static_cast<uint8_t>(c),
+                                        static_cast<uint8_t>(r), &lazy,
+                                        pay.data(), pay.size()),
+                  0);
+        EXPECT_EQ(lazy.count, 9);
+        expect_same_track(*t, p, lazy, pay.data(), c, r);
+      }
+    }
+    const FluxTrack* t = nullptr;
+    const uint8_t* p = nullptr;
+    EXPECT_EQ(subcycle::FluxPredecoder::lookup(&pre, 3, 0, 0, &t, &p), 0)
+        << "past the capture: the FDC decodes (nothing) itself";
+  }
+}
+
+TEST(FluxPredecode, StoppedPoolPublishesOnlyWholeCylinders) {
+  const std::vector<uint8_t> scp = weak_disc();
+  subcycle::FluxPredecoder pre(scp.data(), scp.size(), 2);
+  // Racing the pool: any cylinder it reports is complete, revolution 1
+  // (decoded last) included. Destroying it mid-way joins cleanly.
+  for (int c = 0; c < 3; ++c) {
+    const FluxTrack* t = nullptr;
+    const uint8_t* p = nullptr;
+    if (subcycle::FluxPredecoder::lookup(&pre, static_cast<uint8_t>(c), 0, 1,
+                                         &t, &p) != 0)
+      EXPECT_EQ(t->count, 9) << "cylinder " << c;
+  }
+  EXPECT_LE(pre.ready(), 3);
+}
+
+TEST(FluxPredecode, DoubleSidedTableServesBothHeads) {
+  const std::vector<std::vector<Sector>> side0 = amsdos_content(2);
+  std::vector<std::vector<Sector>> side1 = side0;
+  for (std::vector<Sector>& cyl : side1)
+    for (Sector& sec : cyl) sec.h = 1;
+  Prng rng(0x2B0D);
+  std::vector<std::vector<std::vector<uint32_t>>> tracks;
+  for (size_t c = 0; c < side0.size(); ++c) {
+    tracks.push_back({bits_to_flux(track_bits(side0[c]), 80.0, 0.0, &rng)});
+    tracks.push_back({bits_to_flux(track_bits(side1[c]), 80.0, 0.0, &rng)});
+  }
+  const std::vector<uint8_t> scp = build_scp(tracks, 2);
+  subcycle::FluxPredecoder pre(scp.data(), scp.size(), 2);
+  pre.wait();
+  ASSERT_EQ(pre.heads(), 2);
+  for (int c = 0; c < 2; ++c) {
+    for (int h = 0; h < 2; ++h) {
+      const FluxTrack* t = nullptr;
+      const uint8_t* p = nullptr;
+      ASSERT_EQ(subcycle::FluxPredecoder::lookup(&pre, static_cast<uint8_t>(c),
+                                                 static_cast<uint8_t>(h), 0,
+                                                 &t, &p),
+                1);
+      FluxTrack lazy{};
+      std::vector<uint8_t> pay(8192);
+      ASSERT_EQ(flux_decode_track(scp.data(), scp.size(),
+                                  static_cast<uint8_t>(c),
+                                  static_cast<uint8_t>(h), 0, &lazy,
+                                  pay.data(), pay.size()),
+                0);
+      EXPECT_EQ(lazy.sec[0].chrn[1], h);
+      expect_same_track(*t, p, lazy, pay.data(), c, h);
+    }
+  }
+  const FluxTrack* t = nullptr;
+  const uint8_t* p = nullptr;
+  EXPECT_EQ(subcycle::FluxPredecoder::lookup(&pre, 0, 2, 0, &t, &p), 0)
+      << "no third head";
+}
+
+TEST(FluxPredecode, NotAnScpDecodesNothing) {
+  const uint8_t junk[64] = {'N', 'O', 'P', 'E'};
+  subcycle::FluxPredecoder pre(junk, sizeof(junk), 2);
+  pre.wait();
+  EXPECT_EQ(pre.cylinders(), 0);
+  EXPECT_TRUE(pre.done());
+  const FluxTrack* t = nullptr;
+  const uint8_t* p = nullptr;
+  EXPECT_EQ(subcycle::FluxPredecoder::lookup(&pre, 0, 0, 0, &t, &p), 0);
+}
@@ -127,38 +127,42 @@ inline std::vector<uint32_t> bits_to_flux(const std::vector<uint8_t>& bits,
   return out;
 }
 
-// SCP container: header + 168-slot offset table + per-cylinder TRK blocks.
-// tracks[cyl][rev] = flux intervals. Standard slot mapping (cyl*2, side 0).
+// SCP container: header + 168-slot offset table + per-track TRK blocks.
+// tracks[t][rev] = flux intervals, t = cyl * heads + head. Standard slot
+// mapping (cyl*2 + head); heads = 2 writes a double-sided dump.
 inline std::vector<uint8_t> build_scp(
-    const std::vector<std::vector<std::vector<uint32_t>>>& tracks) {
-  const size_t cyls = tracks.size();
+    const std::vector<std::vector<std::vector<uint32_t>>>& tracks,
+    size_t heads = 1) {
+  const size_t cyls = tracks.size() / heads;
   const size_t revs = tracks[0].size();
   std::vector<uint8_t> f(0x2B0, 0);
   std::memcpy(f.data(), "SCP", 3);
   f[0x03] = 0x22;  // version (uninterpreted)
   f[0x04] = 0x80;  // disk type (uninterpreted)
   f[0x05] = static_cast<uint8_t>(revs);
-  f[0x06] = 0;                                     // start track
-  f[0x07] = static_cast<uint8_t>((cyls - 1) * 2);  // end track
-  f[0x08] = 0x01;                                  // flags: index-cued
-  f[0x09] = 0;                                     // 16-bit cells
-  f[0x0A] = 1;                                     // side 0 only
-  f[0x0B] = 0;                                     // resolution: 25 ns ticks
+  const size_t end_track = ((cyls - 1) * 2) + heads - 1;
+  f[0x06] = 0;                                // start track
+  f[0x07] = static_cast<uint8_t>(end_track);  // end track
+  f[0x08] = 0x01;                             // flags: index-cued
+  f[0x09] = 0;                                // 16-bit cells
+  f[0x0A] = heads == 2 ? 0 : 1;               // both sides / side 0 only
+  f[0x0B] = 0;                                // resolution: 25 ns ticks
   auto w32 = [&](size_t off, uint32_t v) {
     f[off] = static_cast<uint8_t>(v & 0xFF);
     f[off + 1] = static_cast<uint8_t>((v >> 8) & 0xFF);
     f[off + 2] = static_cast<uint8_t>((v >> 16) & 0xFF);
     f[off + 3] = static_cast<uint8_t>(v >> 24);
   };
-  for (size_t cyl = 0; cyl < cyls; cyl++) {
+  for (size_t t = 0; t < tracks.size(); t++) {
+    const size_t slot = ((t / heads) * 2) + (t % heads);
     const size_t tdh = f.size();
-    w32(0x10 + 4 * (cyl * 2), static_cast<uint32_t>(tdh));
-    f.insert(f.end(), {'T', 'R', 'K', static_cast<uint8_t>(cyl * 2)});
+    w32(0x10 + 4 * slot, static_cast<uint32_t>(tdh));
+    f.insert(f.end(), {'T', 'R', 'K', static_cast<uint8_t>(slot)});
     f.resize(f.size() + 12 * revs, 0);  // revolution table, patched below
     for (size_t r = 0; r < revs; r++) {
       const size_t data_off = f.size() - tdh;
       uint32_t duration = 0, words = 0;
-      for (uint32_t v : tracks[cyl][r]) {
+      for (uint32_t v : tracks[t][r]) {
         duration += v;
         while (v >= 0x10000) {  // overflow convention: 0x0000 = +65536 ticks
           f.push_back(0);
@@ -443,3 +443,148 @@ TEST(Flux, Stage3RevolutionsCarryTheirOwnData) {
             0)
       << "rev 2 = capture 0 again";
 }
+
+TEST(Flux, DoubleSidedDumpDecodesBothHeadsIntoATwoSidedDsk) {
+  // Side 1 carries its own sectors (H = 1, its own payload): the decoder
+  // reads each side from its own slot and the DSK interleaves them
+  // (track-info index = cyl * 2 + head), as a double-sided DSK does.
+  const std::vector<std::vector<Sector>> side0 = amsdos_content(2);
+  std::vector<std::vector<Sector>> side1 = side0;
+  for (std::vector<Sector>& cyl : side1)
+    for (Sector& sec : cyl) {
+      sec.h = 1;
+      std::memset(sec.data.data(), 0x20 + sec.c, sec.data.size());
+    }
+  Prng rng(0xD51D);
+  std::vector<std::vector<std::vector<uint32_t>>> tracks;
+  for (size_t c = 0; c < side0.size(); c++) {
+    tracks.push_back({bits_to_flux(track_bits(side0[c]), 80.0, 0.0, &rng)});
+    tracks.push_back({bits_to_flux(track_bits(side1[c]), 80.0, 0.0, &rng)});
+  }
+  const std::vector<uint8_t> scp = build_scp(tracks, 2);
+  EXPECT_EQ(flux_scp_heads(scp.data(), scp.size()), 2);
+  EXPECT_EQ(flux_scp_cylinders(scp.data(), scp.size()), 2);
+  const std::vector<uint8_t> single = scp_from_sectors(side0);
+  EXPECT_EQ(flux_scp_heads(single.data(), single.size()), 1);
+
+  FluxTrack trk;
+  std::vector<uint8_t> payload(8192);
+  ASSERT_EQ(flux_decode_track(scp.data(), scp.size(), 1, 1, 0, &trk,
+                              payload.data(), payload.size()),
+            0);
+  ASSERT_EQ(trk.count, 9);
+  EXPECT_EQ(trk.sec[0].chrn[1], 1) << "side 1's own ID fields";
+  EXPECT_EQ(payload[trk.sec[0].off], 0x21) << "and its own payload";
+  ASSERT_EQ(flux_decode_track(single.data(), single.size(), 1, 1, 0, &trk,
+                              payload.data(), payload.size()),
+            0);
+  EXPECT_EQ(trk.count, 0) << "no side 1 on a single-sided dump";
+
+  std::vector<uint8_t> dsk;
+  ASSERT_GT(convert(scp, dsk), 0);
+  EXPECT_EQ(dsk[0x30], 2);
+  EXPECT_EQ(dsk[0x31], 2) << "two sides";
+  for (int t = 0; t < 4; t++) {
+    const uint8_t* th = dsk_track(dsk, t);
+    ASSERT_EQ(std::memcmp(th, "Track-Info", 10), 0) << "track " << t;
+    EXPECT_EQ(th[0x10], t / 2) << "cylinder, track " << t;
+    EXPECT_EQ(th[0x11], t % 2) << "side, track " << t;
+    EXPECT_EQ(th[0x18 + 1], t % 2) << "sector H, track " << t;
+    const std::vector<Sector>& want = (t % 2 ? side1 : side0)[t / 2];
+    EXPECT_EQ(std::memcmp(th + 0x100, want[0].data.data(), 512), 0)
+        << "payload, track " << t;
+  }
+  // The unchanged FDC accepts the result as a double-sided disc.
+  std::vector<uint8_t> fmem(fdc_state_size());
+  Device fdev = fdc_init(fmem.data());
+  EXPECT_EQ(fdc_attach_disk(&fdev, dsk.data(), dsk.size()), 0);
+}
+
+// ---- Fixed-point PLL: bit-identical to the double-precision oracle ---------
+// (docs/hardware/flux-media.md §2.) Every cylinder and captured revolution of
+// the corpora above — clean, jittered, off-speed both ways, overflow words,
+// two revolutions, mixed sizes — must yield the same bitcells, cell for cell.
+
+namespace {
+
+void expect_pll_identical(const std::vector<uint8_t>& scp, const char* what) {
+  const int cyls = flux_scp_cylinders(scp.data(), scp.size());
+  const int revs = flux_scp_revolutions(scp.data(), scp.size());
+  ASSERT_GT(cyls, 0) << what;
+  std::vector<uint8_t> fixed(1 << 16), ref(1 << 16);
+  for (int c = 0; c < cyls; c++) {
+    for (int r = 0; r < revs; r++) {
+      const long nf = flux_pll_bitcells(scp.data(), scp.size(),
+                                        static_cast<uint8_t>(c),
+                                        static_cast<uint8_t>(r), 0,
+                                        fixed.data(), fixed.size());
+      const long nr = flux_pll_bitcells(scp.data(), scp.size(),
+                                        static_cast<uint8_t>(c),
+                                        static_cast<uint8_t>(r), 1, ref.data(),
+                                        ref.size());
+      ASSERT_GT(nr, 20000) << what << ": a whole track, cyl " << c;
+      ASSERT_EQ(nf, nr) << what << ": cyl " << c << " rev " << r;
+      EXPECT_EQ(std::memcmp(fixed.data(), ref.data(),
+                            static_cast<size_t>((nr + 7) / 8)),
+                0)
+          << what << ": bitcells differ, cyl " << c << " rev " << r;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(FluxPll, FixedPointMatchesTheReferenceOnTheCorpus) {
+  const std::vector<std::vector<Sector>> src = amsdos_content(4);
+  expect_pll_identical(scp_from_sectors(src), "clean");
+  expect_pll_identical(scp_from_sectors(src, 80.0, 0.10, 0xC0FFEE),
+                       "jitter ±10%");
+  expect_pll_identical(scp_from_sectors(src, 80.0 * 1.02, 0.05, 0xF00D),
+                       "+2% speed");
+  expect_pll_identical(scp_from_sectors(src, 80.0 * 0.97, 0.08, 0xABCD),
+                       "-3% speed");
+
+  Prng rng(1);
+  std::vector<uint32_t> flux = bits_to_flux(track_bits(src[0]), 80.0, 0.0, &rng);
+  flux.insert(flux.begin(), 0x10000 + 160);
+  flux.insert(flux.begin() + 2000, 0x20000 + 80);
+  expect_pll_identical(build_scp({{flux}}), "overflow words");
+
+  std::vector<std::vector<Sector>> rev1 = src;
+  std::memset(rev1[1][4].data.data() + 100, 0x55, 16);
+  std::vector<std::vector<std::vector<uint32_t>>> tracks;
+  for (size_t t = 0; t < src.size(); t++)
+    tracks.push_back({bits_to_flux(track_bits(src[t]), 80.0, 0.06, &rng),
+                      bits_to_flux(track_bits(rev1[t]), 80.8, 0.06, &rng)});
+  expect_pll_identical(build_scp(tracks), "two revolutions");
+
+  std::vector<std::vector<Sector>> mixed = amsdos_content(2);
+  mixed[1].clear();
+  for (int s = 0; s < 4; s++)
+    mixed[1].push_back({1, 0, static_cast<uint8_t>(0x01 + s), 1,
+                        std::vector<uint8_t>(256, static_cast<uint8_t>(s)),
+                        false});
+  expect_pll_identical(scp_from_sectors(mixed, 80.0, 0.04, 7), "mixed sizes");
+}
+
+TEST(FluxPll, BitcellsRejectWhatTheDecoderRejects) {
+  const std::vector<uint8_t> scp = scp_from_sectors(amsdos_content(1));
+  std::vector<uint8_t> bits(1 << 16);
+  EXPECT_EQ(flux_pll_bitcells(scp.data(), scp.size(), 5, 0, 0, bits.data(),
+                              bits.size()),
+            0)
+      << "absent cylinder: no bitcells";
+  const std::vector<uint8_t> junk(0x400, 0xAA);
+  EXPECT_LT(flux_pll_bitcells(junk.data(), junk.size(), 0, 0, 0, bits.data(),
+                              bits.size()),
+            0);
+  // A short buffer cuts the stream; the prefix is still the same cells.
+  std::vector<uint8_t> small(64);
+  ASSERT_EQ(flux_pll_bitcells(scp.data(), scp.size(), 0, 0, 0, small.data(),
+                              small.size()),
+            64 * 8);
+  ASSERT_GT(flux_pll_bitcells(scp.data(), scp.size(), 0, 0, 0, bits.data(),
+                              bits.size()),
+            64 * 8);
+  EXPECT_EQ(std::memcmp(small.data(), bits.data(), small.size()), 0);
+}
@@ -7,6 +7,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <cstdint>
 #include <fstream>
 #include <vector>
@@ -88,6 +89,44 @@ TEST(SubcycleMachine, BootsTypesAndSounds) {
   EXPECT_GT(nonzero3, 100000) << "reboot reached the Ready screen again";
 }
 
+namespace {
+
+// RMS of the left channel over `frames` frames of a channel-A square tone.
+double tone_rms(subcycle::Machine& m, uint16_t period, int frames) {
+  m.psg_poke(0, static_cast<uint8_t>(period));
+  m.psg_poke(1, static_cast<uint8_t>(period >> 8));
+  m.psg_poke(7, 0x3E);  // tone A only
+  m.psg_poke(8, 15);
+  for (int i = 0; i < 10; ++i) m.run_frame();  // settle the DC block
+  double sum = 0;
+  size_t n = 0;
+  for (int i = 0; i < frames; ++i) {
+    m.run_frame();
+    for (size_t k = 0; k < m.audio().size(); k += 2, ++n)
+      sum += static_cast<double>(m.audio()[k]) * m.audio()[k];
+  }
+  return n ? std::sqrt(sum / static_cast<double>(n)) : 0;
+}
+
+}  // namespace
+
+// The PSG's level steps are rendered band-limited: a square well above the
+// host Nyquist (period 2 = 31.25 kHz) is filtered out instead of folding back
+// into the audible band (a box filter leaves ~35% of it aliased to 12.85 kHz).
+TEST(SubcycleMachine, UltrasonicToneDoesNotAlias) {
+  std::vector<uint8_t> rom = read_file("rom/cpc6128.rom");
+  if (rom.size() < 0x8000) GTEST_SKIP() << "rom/cpc6128.rom not found";
+
+  subcycle::Machine m;
+  ASSERT_TRUE(m.build(rom.data(), rom.size()));
+  for (int i = 0; i < 60; ++i) m.run_frame();
+  const double audible = tone_rms(m, 64, 10);  // ~977 Hz
+  const double ultrasonic = tone_rms(m, 2, 10);
+  EXPECT_GT(audible, 2000);
+  EXPECT_LT(ultrasonic, audible * 0.05)
+      << "audible " << audible << " ultrasonic " << ultrasonic;
+}
+
 #include <cstdio>
 #include <filesystem>
 
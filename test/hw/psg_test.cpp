@@ -1,11 +1,14 @@
 /* psg_test.cpp — the AY-3-8912 PSG Device: register file + masks, the AY-bus
  * latch/write/read protocol, keyboard read-back on register 14, tone toggle
- * rate, and the 10 envelope shapes. See docs/hardware/psg-device.md. */
+ * rate, the 10 envelope shapes, and the level events. See
+ * docs/hardware/psg-device.md. */
 
 #include "hw/psg.h"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <vector>
 
@@ -48,6 +51,15 @@ void ay_write(PsgRig& rig, uint8_t reg, uint8_t val) {
   ay_cycle(rig, true, true, reg);   // latch address
   ay_cycle(rig, true, false, val);  // write value
 }
+struct LevelLog {
+  std::vector<uint64_t> steps;
+  std::vector<std::array<uint8_t, 3>> levels;
+};
+void log_levels(void* ctx, uint64_t step, const uint8_t lv[3]) {
+  auto* log = static_cast<LevelLog*>(ctx);
+  log->steps.push_back(step);
+  log->levels.push_back({lv[0], lv[1], lv[2]});
+}
 // Advance the PSG sound engine by n 1 MHz steps.
 void psg_clocks(PsgRig& rig, int n) {
   for (int i = 0; i < n; ++i) {
@@ -220,3 +232,41 @@ TEST(Psg, AmplitudeScalesToFiveBits) {
         << ")";
   }
 }
+
+// psg-device.md §levels: a step that moves a channel level reports it, tagged
+// with its own index; a step that does not reports nothing. The oracle is the
+// levels sampled after every step.
+TEST(Psg, LevelEventsReportEachChangeAtItsStep) {
+  PsgRig rig;
+  make_psg(rig);
+  LevelLog log;
+  psg_set_level_sink(&rig.dev, log_levels, &log);
+  ay_write(rig, 0, 0x03);  // tone A period 3: a toggle every 24 steps
+  ay_write(rig, 7, 0x3E);  // tone A only
+  ay_write(rig, 8, 0x0C);
+  ay_write(rig, 9, 0x05);  // B: a fixed level, moved once below
+  LevelLog want;
+  uint8_t was[3];
+  psg_levels(&rig.dev, was);
+  for (int i = 0; i < 200; ++i) {
+    if (i == 90) ay_write(rig, 9, 0x09);
+    const uint64_t step = psg_sound_steps(&rig.dev);
+    psg_clocks(rig, 1);
+    uint8_t lv[3];
+    psg_levels(&rig.dev, lv);
+    if (lv[0] != was[0] || lv[1] != was[1] || lv[2] != was[2])
+      log_levels(&want, step, lv);
+    std::copy(lv, lv + 3, was);
+  }
+  EXPECT_EQ(psg_sound_steps(&rig.dev), 200u);
+  EXPECT_GT(want.steps.size(), 5u) << "the tone moved the level";
+  EXPECT_EQ(log.steps, want.steps);
+  EXPECT_EQ(log.levels, want.levels);
+  // The batch pair counts too: a closed-form skip is steps without events.
+  const size_t events = log.steps.size();
+  const uint32_t quiet = psg_batch_quiet_steps(&rig.dev);
+  ASSERT_GT(quiet, 1u);
+  psg_batch_skip(&rig.dev, quiet - 1);
+  EXPECT_EQ(psg_sound_steps(&rig.dev), 200u + quiet - 1);
+  EXPECT_EQ(log.steps.size(), events);
+}
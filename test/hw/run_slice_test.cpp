@@ -0,0 +1,184 @@
+/* run_slice_test.cpp — Machine::run_until / run_slice: a frame run as
+ * sub-frame slices is the same frame.
+ *
+ * Each tier runs a 6128 (boot, a typed SOUND command, the note) twice: once
+ * by run_frame(), once by fixed-length slices that straddle frame boundaries
+ * at arbitrary points. Faithful and Wake are per-cycle, so the two twins
+ * must agree on everything — framebuffer at every frame end, the
+ * concatenated audio stream, RAM and the master clock. Fast slices end at
+ * the first instruction boundary in HSYNC past the target (and re-enter the
+ * batch at the next clean point), which can move where the frame is cut by
+ * an instruction — the same cut caveat fast_tier_machine_test documents — so
+ * there the framebuffer and the concatenated audio are what is exact.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+#include "subcycle/machine.h"
+
+namespace {
+
+using RunTier = subcycle::Machine::RunTier;
+
+std::vector<uint8_t> read_file(const char* path) {
+  std::ifstream f(path, std::ios::binary);
+  return std::vector<uint8_t>((std::istreambuf_iterator<char>(f)),
+                              std::istreambuf_iterator<char>());
+}
+
+uint64_t fnv1a(const uint8_t* p, size_t n) {
+  uint64_t h = 1469598103934665603ULL;
+  for (size_t i = 0; i < n; ++i) h = (h ^ p[i]) * 1099511628211ULL;
+  return h;
+}
+
+constexpr size_t kFbLen =
+    static_cast<size_t>(subcycle::kFbWidth) * subcycle::kFbHeight * 3;
+
+struct Twin {
+  subcycle::Machine m;
+  std::vector<uint8_t> fb = std::vector<uint8_t>(kFbLen, 0);
+  std::vector<int16_t> audio;  // concatenated across every run
+  uint32_t slice_us = 0;       // 0: whole frames
+  uint32_t slices = 0;
+
+  // One frame, by whichever driver this twin uses.
+  void frame() {
+    if (slice_us == 0) {
+      m.run_frame();
+      take_audio();
+      return;
+    }
+    bool done = false;
+    while (!done) {
+      done = m.run_slice(slice_us);
+      take_audio();
+      slices++;
+    }
+  }
+  void take_audio() {
+    audio.insert(audio.end(), m.audio().begin(), m.audio().end());
+  }
+};
+
+void boot(Twin& t, const std::vector<uint8_t>& rom, RunTier tier) {
+  ASSERT_TRUE(t.m.build(rom.data(), rom.size()));
+  t.m.attach_framebuffer(t.fb.data(), subcycle::kFbWidth, subcycle::kFbHeight);
+  t.m.set_run_tier(tier);
+}
+
+// Boot, type `sound 1,239,50,15`, let the note play; compare after every
+// frame (a fatal failure on the first divergence).
+void run_pair(Twin& whole, Twin& sliced, int boot_frames) {
+  int frame_no = 0;
+  auto step = [&]() {
+    whole.frame();
+    sliced.frame();
+    ++frame_no;
+    return fnv1a(whole.fb.data(), kFbLen) == fnv1a(sliced.fb.data(), kFbLen);
+  };
+  for (int i = 0; i < boot_frames; ++i)
+    ASSERT_TRUE(step()) << "framebuffer diverged at boot frame " << frame_no;
+  const uint8_t seq[] = {0x74, 0x42, 0x52, 0x56, 0x75, 0x57, 0x80, 0x47, 0x81,
+                         0x71, 0x41, 0x47, 0x61, 0x40, 0x47, 0x80, 0x61, 0x22};
+  for (uint8_t code : seq) {
+    for (int down = 1; down >= 0; --down) {
+      whole.m.key(code, down != 0);
+      sliced.m.key(code, down != 0);
+      for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(step()) << "framebuffer diverged at frame " << frame_no;
+    }
+  }
+  for (int i = 0; i < 30; ++i)
+    ASSERT_TRUE(step()) << "framebuffer diverged at frame " << frame_no;
+}
+
+void expect_audio_prefix_equal(const Twin& a, const Twin& b, size_t max_skew) {
+  const size_t common = std::min(a.audio.size(), b.audio.size());
+  const size_t skew = std::max(a.audio.size(), b.audio.size()) - common;
+  EXPECT_LE(skew, max_skew) << "audio stream lengths drifted apart";
+  ASSERT_GT(common, 50000u) << "audio streams suspiciously short";
+  size_t first_diff = common;
+  for (size_t i = 0; i < common; ++i) {
+    if (a.audio[i] != b.audio[i]) {
+      first_diff = i;
+      break;
+    }
+  }
+  EXPECT_EQ(first_diff, common)
+      << "concatenated audio diverged at sample " << first_diff;
+  int peak = 0;
+  for (int16_t s : a.audio) peak = std::max<int>(peak, s < 0 ? -s : s);
+  EXPECT_GT(peak, 2000) << "the SOUND command played";
+}
+
+class RunSlice : public ::testing::TestWithParam<RunTier> {
+ protected:
+  void SetUp() override {
+    rom_ = read_file("rom/cpc6128.rom");
+    if (rom_.size() < 0x8000) rom_ = read_file("../rom/cpc6128.rom");
+    if (rom_.size() < 0x8000) GTEST_SKIP() << "rom/cpc6128.rom not found";
+  }
+  std::vector<uint8_t> rom_;
+};
+
+}  // namespace
+
+// 4.7 ms slices: never a divisor of the frame, so every frame boundary falls
+// mid-slice at a different offset.
+TEST_P(RunSlice, SlicedFramesMatchWholeFrames) {
+  const RunTier tier = GetParam();
+  Twin whole, sliced;
+  sliced.slice_us = 4700;
+  boot(whole, rom_, tier);
+  boot(sliced, rom_, tier);
+  ASSERT_EQ(sliced.m.effective_run_tier(), tier);
+  run_pair(whole, sliced, 120);
+  if (HasFatalFailure()) return;
+  EXPECT_GT(sliced.slices, 4u * 200) << "frames really were split";
+
+  if (tier == RunTier::Fast) {
+    expect_audio_prefix_equal(whole, sliced, 4);
+    EXPECT_GT(sliced.m.fast_frames_run(), 0u) << "the batch driver engaged";
+    return;
+  }
+  expect_audio_prefix_equal(whole, sliced, 0);
+  EXPECT_EQ(whole.m.master_cycle(), sliced.m.master_cycle());
+  ASSERT_EQ(whole.m.ram_size(), sliced.m.ram_size());
+  for (size_t a = 0; a < whole.m.ram_size(); ++a)
+    ASSERT_EQ(whole.m.ram_read(a), sliced.m.ram_read(a)) << "RAM at " << a;
+}
+
+INSTANTIATE_TEST_SUITE_P(Tiers, RunSlice,
+                         ::testing::Values(RunTier::Faithful, RunTier::Wake,
+                                           RunTier::Fast),
+                         [](const ::testing::TestParamInfo<RunTier>& info) {
+                           switch (info.param) {
+                             case RunTier::Faithful: return "Faithful";
+                             case RunTier::Wake: return "Wake";
+                             default: return "Fast";
+                           }
+                         });
+
+// A run shorter than a microsecond chunk stops exactly on its target, and
+// 1 µs slices walk a frame one microsecond at a time.
+TEST(RunSliceApi, TinySlicesAdvanceAndFrameEndReports) {
+  std::vector<uint8_t> rom = read_file("rom/cpc6128.rom");
+  if (rom.size() < 0x8000) rom = read_file("../rom/cpc6128.rom");
+  if (rom.size() < 0x8000) GTEST_SKIP() << "rom/cpc6128.rom not found";
+  subcycle::Machine m;
+  ASSERT_TRUE(m.build(rom.data(), rom.size()));
+  for (int i = 0; i < 3; ++i) m.run_frame();
+  const uint64_t t0 = m.master_cycle();
+  EXPECT_FALSE(m.run_until(t0 + 5));
+  EXPECT_EQ(m.master_cycle(), t0 + 5);
+  int runs = 0;
+  while (!m.run_slice(1)) runs++;
+  EXPECT_GT(runs, 10000) << "a 1 µs slice is one µs, not a frame";
+  EXPECT_FALSE(m.run_slice(1)) << "the next run opens a new frame";
+}
@@ -586,9 +586,9 @@ TEST(StateRoundtrip, AsicInstanceIndependent) {
 }
 
 /* --- Tape deck: attach a minimal CDT and play it, advancing the playback
- * cursor (the serialized prefix). The CDT image is wiring behind the `cdt`
- * pointer; the instance-independence case gives each deck its OWN CDT buffer
- * (distinct address) to prove that pointer is excluded. --- */
+ * cursor (the serialized prefix). The compiled stream is wiring behind the
+ * `media` pointers; the instance-independence case gives each deck its OWN
+ * stream (distinct addresses) to prove those pointers are excluded. --- */
 
 std::vector<uint8_t> minimal_cdt() {
   std::vector<uint8_t> c = {'Z', 'X', 'T', 'a', 'p', 'e', '!', 0x1a, 1, 20};
@@ -602,8 +602,22 @@ std::vector<uint8_t> minimal_cdt() {
   return c;
 }
 
-void play_tape(const Device& d, const std::vector<uint8_t>& cdt) {
-  tape_attach_cdt(&d, cdt.data(), cdt.size());
+// The compiled stream the deck plays from (caller-owned, like the CDT).
+struct TapeMedia {
+  std::vector<TapeRun> runs = std::vector<TapeRun>(8192);
+  std::vector<TapeBlock> blocks = std::vector<TapeBlock>(16);
+  TapeStream stream{};
+};
+
+void play_tape(const Device& d, const std::vector<uint8_t>& cdt,
+               TapeMedia& m) {
+  ASSERT_EQ(tape_compile_cdt(cdt.data(), cdt.size(), m.runs.data(),
+                             static_cast<uint32_t>(m.runs.size()),
+                             m.blocks.data(),
+                             static_cast<uint32_t>(m.blocks.size()),
+                             &m.stream),
+            0);
+  tape_attach_stream(&d, &m.stream);
   tape_play(&d, 1);
   Bus in = bus_resting();
   in.tape.motor = true;
@@ -617,7 +631,8 @@ TEST(StateRoundtrip, TapeRoundTrips) {
   std::vector<uint8_t> mem(tape_state_size(), 0);
   Device d = tape_init(mem.data());
   const std::vector<uint8_t> cdt = minimal_cdt();
-  expect_roundtrip(d, [&] { play_tape(d, cdt); });
+  TapeMedia media;
+  expect_roundtrip(d, [&] { play_tape(d, cdt, media); });
 }
 
 TEST(StateRoundtrip, TapeInstanceIndependentExcludesCdtPointer) {
@@ -626,8 +641,9 @@ TEST(StateRoundtrip, TapeInstanceIndependentExcludesCdtPointer) {
   Device b = tape_init(mb.data());
   const std::vector<uint8_t> ca = minimal_cdt(),
                              cb = minimal_cdt();  // distinct
-  play_tape(a, ca);
-  play_tape(b, cb);
+  TapeMedia ma_media, mb_media;
+  play_tape(a, ca, ma_media);
+  play_tape(b, cb, mb_media);
   expect_instance_independent(a, b);
 }
 
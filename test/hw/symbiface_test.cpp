@@ -166,6 +166,36 @@ TEST(Symbiface, MultiSectorWriteAndReadChain) {
     EXPECT_EQ(io_read(rig, 0xFD08), static_cast<uint8_t>(255 - i));
 }
 
+// The write-back map: a 4096-sector image splits into 1024 regions of 4
+// sectors; a write to LBA 2049 marks region 512 alone, and mark_clean clears
+// it with the dirty flag.
+TEST(Symbiface, WrittenMapLocatesTheWrite) {
+  Sf2Rig rig;
+  make_rig(rig);
+  std::vector<uint8_t> img(4096 * 512, 0);
+  uint32_t per = 0;
+  EXPECT_EQ(sf2_media_written(&rig.dev, 0, &per), nullptr) << "no image yet";
+  sf2_ide_attach(&rig.dev, 0, img.data(), img.size());
+  const uint8_t* map = sf2_media_written(&rig.dev, 0, &per);
+  ASSERT_NE(map, nullptr);
+  EXPECT_EQ(per, 4u);
+
+  io_write(rig, 0xFD0E, 0xE0);  // LBA mode, master
+  io_write(rig, 0xFD0A, 0x01);
+  io_write(rig, 0xFD0B, 0x01);  // LBA 0x801 = 2049
+  io_write(rig, 0xFD0C, 0x08);
+  io_write(rig, 0xFD0D, 0x00);
+  io_write(rig, 0xFD0F, 0x30);  // WRITE SECTORS
+  for (int i = 0; i < 512; ++i) io_write(rig, 0xFD08, 0xA5);
+  ASSERT_EQ(img[2049 * 512], 0xA5);
+  for (int r = 0; r < SF2_DIRTY_REGIONS; ++r)
+    EXPECT_EQ((map[r >> 3] >> (r & 7)) & 1, r == 512 ? 1 : 0) << "region " << r;
+
+  sf2_media_mark_clean(&rig.dev);
+  EXPECT_EQ(sf2_media_dirty(&rig.dev), 0);
+  EXPECT_EQ(map[512 >> 3], 0);
+}
+
 TEST(Symbiface, RtcServesFedTimeAndCmosNvram) {
   Sf2Rig rig;
   make_rig(rig);
@@ -294,3 +294,92 @@ TEST(TapeSeek, DeckWalksToBlockOrdinalAndIgnoresOutOfRange) {
   EXPECT_EQ(tr.block, blk_before);
   EXPECT_EQ(tr.pos, pos_before);
 }
+
+// Flash loading (tape-device.md §8): the same RUN" with the trap on. Both
+// records go straight into RAM at CAS READ, so the program runs as soon as
+// the firmware is done with its messages — the ~9s of tape never plays —
+// and the deck is left past the data record, where the ROM would have
+// stopped it.
+TEST(TapeFlash, FirmwareRecordsLoadWithoutPlayingThePulses) {
+  std::vector<uint8_t> rom = read_file("rom/cpc6128.rom");
+  if (rom.size() < 0x8000) rom = read_file("../rom/cpc6128.rom");
+  if (rom.size() < 0x8000) GTEST_SKIP() << "rom/cpc6128.rom not found";
+
+  const char* listing = "10 PRINT \"FLASH OK\"\r\n";
+  std::vector<uint8_t> body(listing, listing + strlen(listing));
+  std::vector<uint8_t> cdt = make_firmware_cdt("FLASH", 0x16, body);
+
+  subcycle::Machine m;
+  ASSERT_TRUE(m.build(rom.data(), rom.size()));
+  m.set_tape_flash(true);
+  g_machine = &m;
+  g_text.clear();
+  ASSERT_TRUE(m.add_tap(0xBB5A, collect_txt, nullptr));
+
+  for (int i = 0; i < 150; ++i) m.run_frame();
+  ASSERT_TRUE(m.insert_tape(cdt.data(), cdt.size()));
+  m.tape_play_button(true);
+  tap(m, 0x62);
+  tap(m, 0x52);
+  tap(m, 0x56);
+  tap_shifted(m, 0x81);
+  tap(m, 0x22);
+  for (int i = 0; i < 25; ++i) m.run_frame();
+  tap(m, 0x57);
+
+  int frames = 0;
+  bool ran = false;
+  for (; frames < 900 && !ran; ++frames) {
+    m.run_frame();
+    ran = g_text.find("FLASH OK") != std::string::npos;
+  }
+  g_machine = nullptr;
+
+  EXPECT_TRUE(ran) << "got: " << g_text;
+  // The firmware's own motor spin-up wait stays; the records themselves
+  // (~6s of leader and data at 2000 baud) do not play.
+  EXPECT_LT(frames, 200) << "the records played in real time";
+  TapeRegs tr{};
+  tape_peek(m.tape(), &tr);
+  EXPECT_EQ(tr.cycle, tr.total) << "the deck ends past the data record";
+}
+
+// A damaged record is not flashed: the trap leaves CAS READ to the pulses,
+// and the firmware's own CRC check reports the error the tape really has.
+TEST(TapeFlash, DamagedRecordFallsBackToThePulses) {
+  std::vector<uint8_t> rom = read_file("rom/cpc6128.rom");
+  if (rom.size() < 0x8000) rom = read_file("../rom/cpc6128.rom");
+  if (rom.size() < 0x8000) GTEST_SKIP() << "rom/cpc6128.rom not found";
+
+  std::vector<uint8_t> body(64, 0x2A);
+  std::vector<uint8_t> cdt = make_firmware_cdt("BAD", 0x16, body);
+  cdt[cdt.size() - 40] ^= 0x01;  // a payload byte of the data record
+
+  subcycle::Machine m;
+  ASSERT_TRUE(m.build(rom.data(), rom.size()));
+  m.set_tape_flash(true);
+  for (int i = 0; i < 150; ++i) m.run_frame();
+  ASSERT_TRUE(m.insert_tape(cdt.data(), cdt.size()));
+  m.tape_play_button(true);
+  tap(m, 0x62);
+  tap(m, 0x52);
+  tap(m, 0x56);
+  tap_shifted(m, 0x81);
+  tap(m, 0x22);
+  for (int i = 0; i < 25; ++i) m.run_frame();
+  tap(m, 0x57);
+
+  // The header flashes; the data record then plays, bit by bit.
+  uint32_t data_block = 0;
+  bool played = false;
+  for (int i = 0; i < 600 && !played; ++i) {
+    m.run_frame();
+    TapeRegs tr{};
+    tape_peek(m.tape(), &tr);
+    if (data_block == 0 && tr.block == 2) data_block = tr.block;
+    uint8_t bits[256];
+    played = data_block != 0 &&
+             m.tape_drain_bits(bits, static_cast<int>(sizeof(bits))) > 0;
+  }
+  EXPECT_TRUE(played) << "the damaged record never reached the wire";
+}
@@ -28,6 +28,27 @@ std::vector<uint8_t> cdt_std_block(const std::vector<uint8_t>& payload,
   return c;
 }
 
+// A compiled tape: the deck plays out of these (caller-owned) arrays.
+struct Media {
+  std::vector<TapeRun> runs;
+  std::vector<TapeBlock> blocks;
+  TapeStream stream{};
+};
+
+// Compile `cdt` into `m` (sizing pass, then the real one) and insert it.
+int attach(const Device& dev, const std::vector<uint8_t>& cdt, Media& m) {
+  const int sized = tape_compile_cdt(cdt.data(), cdt.size(), nullptr, 0,
+                                     nullptr, 0, &m.stream);
+  if (sized == -1) return -1;
+  m.runs.assign(m.stream.nruns, 0);
+  m.blocks.assign(m.stream.nblocks, TapeBlock{});
+  const int rc = tape_compile_cdt(cdt.data(), cdt.size(), m.runs.data(),
+                                  m.stream.nruns, m.blocks.data(),
+                                  m.stream.nblocks, &m.stream);
+  if (rc == 0) tape_attach_stream(&dev, &m.stream);
+  return rc;
+}
+
 struct Pulse {
   uint8_t level;
   uint32_t cycles;
@@ -65,7 +86,8 @@ TEST(Tape, StandardBlockDecodesBackByteExact) {
 
   std::vector<uint8_t> mem(tape_state_size());
   Device dev = tape_init(mem.data());
-  ASSERT_EQ(tape_attach_cdt(&dev, cdt.data(), cdt.size()), 0);
+  Media media;
+  ASSERT_EQ(attach(dev, cdt, media), 0);
   tape_play(&dev, 1);
 
   const std::vector<Pulse> pulses = record(dev, 60'000'000);
@@ -101,7 +123,7 @@ TEST(Tape, StandardBlockDecodesBackByteExact) {
 }
 
 // An unknown block id must LATCH the error flag and stop — the deck never
-// guesses a block length (tape.cpp start_block default, spec §3). Currently
+// guesses what a block plays (it compiles to the ERROR marker, spec §3). Currently
 // only the 0x10 path was exercised.
 TEST(Tape, UnknownBlockLatchesErrorAndStops) {
   std::vector<uint8_t> cdt = {'Z', 'X', 'T', 'a', 'p', 'e', '!', 0x1a, 1, 20};
@@ -110,7 +132,8 @@ TEST(Tape, UnknownBlockLatchesErrorAndStops) {
   cdt.push_back(0x00);
   std::vector<uint8_t> mem(tape_state_size());
   Device dev = tape_init(mem.data());
-  ASSERT_EQ(tape_attach_cdt(&dev, cdt.data(), cdt.size()), 0);
+  Media media;
+  ASSERT_EQ(attach(dev, cdt, media), 0);
   tape_play(&dev, 1);
   record(dev, 100'000);  // a few ticks: start_block runs and bails
   TapeRegs r{};
@@ -128,7 +151,8 @@ TEST(Tape, StopBlockHaltsWithoutError) {
   cdt.push_back(0x00);
   std::vector<uint8_t> mem(tape_state_size());
   Device dev = tape_init(mem.data());
-  ASSERT_EQ(tape_attach_cdt(&dev, cdt.data(), cdt.size()), 0);
+  Media media;
+  ASSERT_EQ(attach(dev, cdt, media), 0);
   tape_play(&dev, 1);
   record(dev, 100'000);
   TapeRegs r{};
@@ -162,7 +186,8 @@ TEST(Tape, TurboBlockHonoursItsOwnTimings) {
 
   std::vector<uint8_t> mem(tape_state_size());
   Device dev = tape_init(mem.data());
-  ASSERT_EQ(tape_attach_cdt(&dev, cdt.data(), cdt.size()), 0);
+  Media media;
+  ASSERT_EQ(attach(dev, cdt, media), 0);
   tape_play(&dev, 1);
   const std::vector<Pulse> pulses = record(dev, 20'000'000);
   ASSERT_GE(pulses.size(), 200u) << "the turbo pilot tone played";
@@ -183,10 +208,10 @@ std::vector<uint8_t> tzx_header() {
   return {'Z', 'X', 'T', 'a', 'p', 'e', '!', 0x1a, 1, 20};
 }
 std::vector<Pulse> play(const std::vector<uint8_t>& cdt, Device& dev,
-                        std::vector<uint8_t>& mem) {
+                        std::vector<uint8_t>& mem, Media& media) {
   mem.assign(tape_state_size(), 0);
   dev = tape_init(mem.data());
-  EXPECT_EQ(tape_attach_cdt(&dev, cdt.data(), cdt.size()), 0);
+  EXPECT_EQ(attach(dev, cdt, media), 0);
   tape_play(&dev, 1);
   return record(dev, 20'000'000);
 }
@@ -200,7 +225,8 @@ TEST(Tape, PureToneBlockPlaysThePilotCount) {
   w16(cdt, 50);    // number of pulses
   std::vector<uint8_t> mem;
   Device dev{};
-  const std::vector<Pulse> pulses = play(cdt, dev, mem);
+  Media media;
+  const std::vector<Pulse> pulses = play(cdt, dev, mem, media);
   ASSERT_GE(pulses.size(), 50u) << "the pure tone played its pulses";
   for (int i = 1; i < 40; ++i)
     EXPECT_NEAR(pulses[i].cycles, 2168 * 32 / 7, 2) << "tone period honoured";
@@ -219,7 +245,8 @@ TEST(Tape, PulseSequenceBlockEmitsEachExplicitPulse) {
   w16(cdt, 3000);
   std::vector<uint8_t> mem;
   Device dev{};
-  const std::vector<Pulse> pulses = play(cdt, dev, mem);
+  Media media;
+  const std::vector<Pulse> pulses = play(cdt, dev, mem, media);
   ASSERT_GE(pulses.size(), 3u);
   EXPECT_NEAR(pulses[0].cycles, 1000 * 32 / 7, 2);
   EXPECT_NEAR(pulses[1].cycles, 2000 * 32 / 7, 2);
@@ -244,7 +271,8 @@ TEST(Tape, PureDataBlockClocksBitsWithoutAPilot) {
   cdt.push_back(0xFF);  // 8 one-bits
   std::vector<uint8_t> mem;
   Device dev{};
-  const std::vector<Pulse> pulses = play(cdt, dev, mem);
+  Media media;
+  const std::vector<Pulse> pulses = play(cdt, dev, mem, media);
   ASSERT_GE(pulses.size(), 16u) << "8 one-bits × 2 pulses each, no pilot";
   EXPECT_NEAR(pulses[0].cycles, 1710 * 32 / 7, 2) << "first bit is a '1'";
   EXPECT_NEAR(pulses[1].cycles, pulses[0].cycles, 3) << "the pair is symmetric";
@@ -257,7 +285,8 @@ TEST(Tape, MotorGatesPlaybackAndLineInFollowsHostLevel) {
   const std::vector<uint8_t> cdt = cdt_std_block({0x00}, 0);
   std::vector<uint8_t> mem(tape_state_size());
   Device dev = tape_init(mem.data());
-  ASSERT_EQ(tape_attach_cdt(&dev, cdt.data(), cdt.size()), 0);
+  Media media;
+  ASSERT_EQ(attach(dev, cdt, media), 0);
   tape_play(&dev, 1);
 
   // Motor OFF: the timeline must not advance (firmware owns the relay).
@@ -300,7 +329,10 @@ TEST(Tape, DirectRecordingBlockDrivesLevelsSampleExact) {
 
   std::vector<uint8_t> mem(tape_state_size());
   Device dev = tape_init(mem.data());
-  ASSERT_EQ(tape_attach_cdt(&dev, cdt.data(), cdt.size()), 0);
+  Media media;
+  ASSERT_EQ(attach(dev, cdt, media), 0);
+  // 1111, 0000, then eight alternating samples, then the closing STOP.
+  EXPECT_EQ(media.stream.nruns, 11u) << "equal samples share one run";
   tape_play(&dev, 1);
 
   const std::vector<Pulse> pulses = record(dev, 1'000'000);
@@ -319,3 +351,173 @@ TEST(Tape, DirectRecordingBlockDrivesLevelsSampleExact) {
     EXPECT_NEAR(pulses[i].cycles, one, 6) << "sample " << i;
   }
 }
+
+// The compiled stream: a sizing pass reports what it needs, the block index
+// carries every block (metadata too) with its exact start time, and pulses
+// carry the 7/32 remainder so a block's length is exact to the cycle.
+TEST(Tape, CompiledStreamIndexesBlocksWithExactTimes) {
+  std::vector<uint8_t> cdt = tzx_header();
+  cdt.push_back(0x12);  // block 0: 7 pulses of 1000 ts = 32000 cycles
+  w16(cdt, 1000);
+  w16(cdt, 7);
+  cdt.push_back(0x21);  // block 1: group start (metadata, plays nothing)
+  cdt.push_back(1);
+  cdt.push_back('G');
+  cdt.push_back(0x20);  // block 2: 2 ms pause
+  w16(cdt, 2);
+  cdt.push_back(0x13);  // block 3: one 35-ts pulse = 160 cycles
+  cdt.push_back(1);
+  w16(cdt, 35);
+
+  TapeStream s{};
+  EXPECT_EQ(tape_compile_cdt(cdt.data(), cdt.size(), nullptr, 0, nullptr, 0,
+                             &s),
+            -2);
+  EXPECT_EQ(s.nblocks, 4u);
+  EXPECT_EQ(tape_compile_cdt(cdt.data(), 9, nullptr, 0, nullptr, 0, &s), -1);
+
+  std::vector<uint8_t> mem(tape_state_size());
+  Device dev = tape_init(mem.data());
+  Media media;
+  ASSERT_EQ(attach(dev, cdt, media), 0);
+  ASSERT_EQ(media.blocks.size(), 4u);
+  EXPECT_EQ(media.blocks[0].start, 0u);
+  EXPECT_EQ(media.blocks[1].start, 32000u) << "7 x 1000 ts x 32/7, exactly";
+  EXPECT_EQ(media.blocks[1].first_run, media.blocks[2].first_run);
+  EXPECT_EQ(media.blocks[2].start, 32000u);
+  EXPECT_EQ(media.blocks[3].start, 32000u + 32000u);
+  EXPECT_EQ(media.stream.total, 32000u + 32000u + 160u);
+  EXPECT_EQ(media.blocks[3].pos, cdt.size() - 4);
+
+  TapeRegs r{};
+  tape_peek(&dev, &r);
+  EXPECT_EQ(r.total, media.stream.total);
+  EXPECT_EQ(r.cycle, 0u);
+
+  // Block seek is an index lookup; the metadata block settles on the pause
+  // once PLAY enters it.
+  tape_seek(&dev, 3);
+  tape_peek(&dev, &r);
+  EXPECT_EQ(r.block, 3u);
+  EXPECT_EQ(r.cycle, 64000u);
+  tape_seek(&dev, 1);
+  tape_play(&dev, 1);
+  tape_peek(&dev, &r);
+  EXPECT_EQ(r.block, 2u);
+  EXPECT_EQ(r.cycle, 32000u);
+  EXPECT_EQ(r.pos, media.blocks[2].pos);
+
+  // Time seek lands mid-pulse and keeps playing from there.
+  tape_seek_cycle(&dev, 10000);
+  tape_peek(&dev, &r);
+  EXPECT_EQ(r.block, 0u);
+  EXPECT_EQ(r.cycle, 10000u);
+  EXPECT_EQ(r.playing, 1);
+  EXPECT_EQ(r.level, 0) << "pulse 2 of the tone (0-based: 4571..9142 is 1)";
+  tape_seek_cycle(&dev, ~uint64_t{0});
+  tape_peek(&dev, &r);
+  EXPECT_EQ(r.cycle, media.stream.total) << "clamped to the end";
+  EXPECT_EQ(r.playing, 0);
+}
+
+// The wake contract: skipping tape_cycles_to_edge() - 1 cycles with
+// tape_advance leaves the wire exactly where per-cycle ticks would, and the
+// edge then lands on the predicted cycle.
+TEST(Tape, EdgePredictionMatchesTicking) {
+  const std::vector<uint8_t> cdt = cdt_std_block({0x5A, 0x00}, 1);
+  std::vector<uint8_t> ma(tape_state_size()), mb(tape_state_size());
+  Device ticked = tape_init(ma.data());
+  Device batched = tape_init(mb.data());
+  Media media_a, media_b;
+  ASSERT_EQ(attach(ticked, cdt, media_a), 0);
+  ASSERT_EQ(attach(batched, cdt, media_b), 0);
+  tape_play(&ticked, 1);
+  tape_play(&batched, 1);
+
+  Bus in = bus_resting();
+  in.tape.motor = true;
+  Bus out = bus_resting();
+  int edges = 0;
+  for (;;) {
+    const uint64_t n = tape_cycles_to_edge(&batched);
+    if (n == 0) break;
+    tape_advance(&batched, n - 1);
+    for (uint64_t i = 0; i < n - 1; ++i) ticked.tick(ticked.self, &in, &out);
+    TapeRegs a{}, b{};
+    tape_peek(&ticked, &a);
+    tape_peek(&batched, &b);
+    ASSERT_EQ(a.level, b.level) << "edge " << edges;
+    ASSERT_EQ(a.cycle, b.cycle) << "edge " << edges;
+    const uint8_t before = a.level;
+    ticked.tick(ticked.self, &in, &out);
+    batched.tick(batched.self, &in, &out);
+    tape_peek(&ticked, &a);
+    tape_peek(&batched, &b);
+    ASSERT_EQ(a.level, b.level);
+    if (b.playing) {
+      ASSERT_NE(b.level, before) << "the edge came on time";
+    }
+    ++edges;
+  }
+  EXPECT_EQ(edges, 8063 + 2 + (16 * 2)) << "header pilot, sync, bit pulses";
+  uint8_t bits[64];
+  EXPECT_EQ(tape_drain_bits(&batched, bits, 64), 16)
+      << "skipped runs still report their data bits";
+}
+
+// The flash loader's record check: a firmware record (sync byte, 256-byte
+// segments each with its complemented CRC-16, trailer) in a standard block
+// copies out byte-exact; a wrong sync, a read longer than the record, a
+// damaged segment or a block that is not data all refuse.
+TEST(Tape, FirmwareRecordCopiesOutOnlyWhenIntact) {
+  std::vector<uint8_t> rec = {0x16};
+  for (int s = 0; s < 2; ++s) {
+    uint16_t crc = 0xFFFF;
+    for (int i = 0; i < 256; ++i) {
+      const auto b = static_cast<uint8_t>((s * 256) + (i * 7));
+      rec.push_back(b);
+      crc = static_cast<uint16_t>(crc ^ (b << 8));
+      for (int k = 0; k < 8; ++k)
+        crc = static_cast<uint16_t>((crc & 0x8000) ? (crc << 1) ^ 0x1021
+                                                   : crc << 1);
+    }
+    rec.push_back(static_cast<uint8_t>(~crc >> 8));
+    rec.push_back(static_cast<uint8_t>(~crc & 0xFF));
+  }
+  rec.insert(rec.end(), 4, 0xFF);
+  std::vector<uint8_t> cdt = cdt_std_block(rec, 1000);
+  const auto len = static_cast<uint32_t>(cdt.size());
+
+  std::vector<uint8_t> out(300);
+  uint64_t lead = 0;
+  ASSERT_EQ(tape_firmware_record(cdt.data(), len, 10, 0x16, out.data(), 300,
+                                 &lead),
+            0);
+  for (int i = 0; i < 300; ++i)
+    ASSERT_EQ(out[i], rec[1 + ((i / 256) * 258) + (i % 256)]) << i;
+  EXPECT_EQ(lead, 8063ull * 2168 * 32 / 7) << "a header-flag pilot";
+
+  EXPECT_EQ(tape_firmware_record(cdt.data(), len, 10, 0x2C, out.data(), 300,
+                                 nullptr),
+            -1)
+      << "sync";
+  std::vector<uint8_t> big(513);
+  EXPECT_EQ(tape_firmware_record(cdt.data(), len, 10, 0x16, big.data(), 513,
+                                 nullptr),
+            -1)
+      << "a third segment that is not there";
+  cdt[15 + 300] ^= 0x40;  // inside the second segment
+  EXPECT_EQ(tape_firmware_record(cdt.data(), len, 10, 0x16, out.data(), 300,
+                                 nullptr),
+            -1)
+      << "crc";
+  EXPECT_EQ(tape_firmware_record(cdt.data(), len, 10, 0x16, out.data(), 256,
+                                 nullptr),
+            0)
+      << "a read that stops short of the damage";
+  const std::vector<uint8_t> tone = {'Z', 'X', 'T', 'a', 'p', 'e', '!', 0x1a,
+                                     1,   20,  0x12, 0x78, 0x08, 0x10, 0x00};
+  EXPECT_EQ(tape_firmware_record(tone.data(), 15, 10, 0x16, out.data(), 1,
+                                 nullptr),
+            -1);
+}
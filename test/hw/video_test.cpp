@@ -6,6 +6,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstdio>
@@ -599,6 +600,129 @@ TEST(Video, PlusSpriteOverlapPriorityCull) {
   EXPECT_NEAR(green, 128, 40) << "transparent half filled by the lower sprite";
 }
 
+// The per-line sprite layer magnifies each span (×2 doubles every sprite
+// pixel horizontally) and follows sprite pixel RAM writes: pixels are read
+// live, so rewriting half the sprite between frames must recolour exactly
+// that half, and a write mid-line must show from the next cell — a layer
+// keyed only on the line snapshot would keep the old one.
+TEST(Video, PlusSpriteLayerMagnifiesAndTracksPixelWrites) {
+  const uint8_t seq[] = {0x81};  // GA mode 1 (only the mode matters in Plus)
+  std::vector<uint8_t> gmem(ga_state_size());
+  Device gdev = ga_init(gmem.data());
+  std::vector<uint8_t> cmem(crtc_state_size());
+  Device cdev = crtc_init(cmem.data());
+  std::vector<uint8_t> mmem(mem_state_size());
+  Device mdev = mem_init(mmem.data());
+  std::vector<uint8_t> vmem(video_state_size());
+  Device vdev = video_init(vmem.data());
+  std::vector<uint8_t> amem(asic_state_size());
+  Device adev = asic_init(amem.data());
+  Injector inj{seq, static_cast<int>(sizeof(seq)),
+               static_cast<int>(sizeof(seq))};
+
+  Board board;
+  board_init(&board);
+  board_add(&board, gdev);
+  board_add(&board, inj_device(&inj));
+  board_add(&board, cdev);
+  board_add(&board, mdev);
+  board_add(&board, adev);
+  board_add(&board, vdev);
+  board_reset(&board);
+  asic_set_plugged(&adev, 1);
+
+  const uint8_t std_regs[10] = {63, 40, 46, 0x8E, 38, 0, 25, 30, 0, 7};
+  for (uint8_t i = 0; i < 10; ++i) crtc_poke_reg(&cdev, i, std_regs[i]);
+  crtc_poke_reg(&cdev, 12, 0x30);
+
+  bus_unlock(&board);
+  bus_set_palette(&board, 0, 0xF, 0x0, 0xF);   // background pen 0 → magenta
+  bus_set_palette(&board, 16, 0x0, 0xF, 0xF);  // border → cyan
+  bus_set_palette(&board, 17, 0xF, 0xF, 0x0);  // sprite colour 1 → yellow
+  bus_set_palette(&board, 18, 0x0, 0xF, 0x0);  // sprite colour 2 → green
+
+  for (int y = 0; y < 16; ++y)
+    for (int x = 0; x < 16; ++x)
+      bus_pgwrite(&board, static_cast<uint16_t>(0x4000 | (y << 4) | x), 1);
+  bus_pgwrite(&board, 0x6000 + 0, 40);  // sprite 0 X = 40
+  bus_pgwrite(&board, 0x6000 + 1, 0x00);
+  bus_pgwrite(&board, 0x6000 + 2, 10);  // sprite 0 Y = 10
+  bus_pgwrite(&board, 0x6000 + 3, 0x00);
+  bus_pgwrite(&board, 0x6000 + 4, (2 << 2) | 1);  // ×2 wide, ×1 tall
+
+  const int w = 768, h = 272;
+  std::vector<uint8_t> fb(static_cast<size_t>(w) * h * 3, 0);
+  video_attach(&vdev, &gdev, fb.data(), w, h);
+  video_attach_asic(&vdev, &adev);
+  inj.tick = 0;
+
+  auto run_frames = [&](uint32_t until) {
+    VideoRegs vr{};
+    video_peek(&vdev, &vr);
+    for (int tick = 0; tick < 1400000 && vr.frames < until; ++tick) {
+      board_tick(&board);
+      video_peek(&vdev, &vr);
+    }
+    return vr.frames;
+  };
+  auto count = [&](uint8_t r, uint8_t g, uint8_t b) {
+    int n = 0;
+    for (int i = 0; i < w * h; ++i)
+      if (fb[i * 3] == r && fb[i * 3 + 1] == g && fb[i * 3 + 2] == b) n++;
+    return n;
+  };
+  ASSERT_GE(run_frames(3), 3u);
+  EXPECT_EQ(count(255, 255, 0), 32 * 16) << "16 columns ×2 wide, 16 rows";
+  EXPECT_EQ(count(0, 255, 0), 0);
+
+  // Rewrite the left half to colour 2 and let two more frames paint.
+  for (int y = 0; y < 16; ++y)
+    for (int x = 0; x < 8; ++x)
+      bus_pgwrite(&board, static_cast<uint16_t>(0x4000 | (y << 4) | x), 2);
+  ASSERT_GE(run_frames(5), 5u);
+  EXPECT_EQ(count(0, 255, 0), 16 * 16) << "the rewritten half shows";
+  EXPECT_EQ(count(255, 255, 0), 16 * 16) << "the untouched half stays";
+
+  // Mid-line: a write landing while the beam is inside the sprite must show
+  // from the next cell on, while the cells already painted keep the old
+  // pixels — the layer is rebuilt within the line, not only at HSYNC.
+  int y0 = -1, x0 = -1;
+  for (int i = 0; i < w * h && y0 < 0; ++i)
+    if (fb[i * 3] == 0 && fb[i * 3 + 1] == 255 && fb[i * 3 + 2] == 0) {
+      y0 = i / w;
+      x0 = i % w;
+    }
+  ASSERT_GE(y0, 0);
+  const int row = y0 + 4;
+  auto px = [&](int x) { return &fb[(static_cast<size_t>(row) * w + x) * 3]; };
+  bus_set_palette(&board, 19, 0xF, 0x0, 0x0);  // sprite colour 3 → red
+  VideoRegs vr{};
+  video_peek(&vdev, &vr);
+  for (int tick = 0; tick < 400000 && vr.cur_row != row - 1; ++tick) {
+    board_tick(&board);
+    video_peek(&vdev, &vr);
+  }
+  ASSERT_EQ(vr.cur_row, row - 1);
+  std::fill_n(px(0), w * 3, uint8_t{0});
+  for (int tick = 0; tick < 2000 && px(x0)[1] == 0; ++tick) board_tick(&board);
+  ASSERT_EQ(px(x0)[1], 255) << "the left half has been painted";
+  ASSERT_EQ(px(x0 + 31)[0] | px(x0 + 31)[1] | px(x0 + 31)[2], 0)
+      << "the right half is still ahead of the beam";
+
+  for (int y = 0; y < 16; ++y)
+    for (int x = 0; x < 16; ++x)
+      bus_pgwrite(&board, static_cast<uint16_t>(0x4000 | (y << 4) | x), 3);
+  video_peek(&vdev, &vr);
+  for (int tick = 0; tick < 2000 && vr.cur_row == row; ++tick) {
+    board_tick(&board);
+    video_peek(&vdev, &vr);
+  }
+  EXPECT_EQ(px(x0)[0], 0) << "pixels painted before the write stay green";
+  EXPECT_EQ(px(x0)[1], 255);
+  EXPECT_EQ(px(x0 + 31)[0], 255) << "pixels after the write are recoloured";
+  EXPECT_EQ(px(x0 + 31)[1], 0);
+}
+
 TEST(Video, PlusSplitScreenSwapsDisplayBase) {
   std::vector<uint8_t> gmem(ga_state_size());
   Device gdev = ga_init(gmem.data());
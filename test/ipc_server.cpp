@@ -10,6 +10,7 @@
 #include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <cstring>
@@ -23,6 +24,7 @@
 #include "cpc_key_tables.h"
 #include "koncepcja.h"
 #include "koncepcja_ipc_server.h"
+#include "subcycle_bridge.h"
 #include "symfile.h"
 #include "video_host.h"
 #include "z80_view.h"
@@ -121,6 +123,74 @@ std::string send_command(const std::string& command) {
   return response;
 }
 
+// A persistent client: unlike send_command(), it keeps the connection open
+// across commands, the way a debugger front end does.
+class IpcClient {
+ public:
+  IpcClient() {
+    int const port = g_test_server ? g_test_server->port() : 6543;
+    fd_ = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    connected_ = ::connect(fd_, reinterpret_cast<sockaddr*>(&addr),
+                           sizeof(addr)) == 0;
+  }
+  ~IpcClient() {
+#ifdef _WIN32
+    closesocket(fd_);
+#else
+    ::close(fd_);
+#endif
+  }
+  IpcClient(const IpcClient&) = delete;
+  IpcClient& operator=(const IpcClient&) = delete;
+
+  bool connected() const { return connected_; }
+
+  // Send one line and read one reply line.
+  std::string ask(const std::string& command) {
+    std::string const line = command + "\n";
+    ::send(fd_, line.data(), static_cast<int>(line.size()), 0);
+    return read_line();
+  }
+
+  void send_raw(const std::string& bytes) {
+    ::send(fd_, bytes.data(), static_cast<int>(bytes.size()), 0);
+  }
+
+  std::string read_exact(size_t n) {
+    std::string out;
+    char buf[4096];
+    while (out.size() < n) {
+      size_t const want = std::min(sizeof(buf), n - out.size());
+      auto const got = ::recv(fd_, buf, static_cast<int>(want), 0);
+      if (got <= 0) break;
+      out.append(buf, static_cast<size_t>(got));
+    }
+    return out;
+  }
+
+  std::string read_line() {
+    std::string reply;
+    char c = 0;
+    while (::recv(fd_, &c, 1, 0) == 1) {
+      reply.push_back(c);
+      if (c == '\n') break;
+    }
+    return reply;
+  }
+
+ private:
+#ifdef _WIN32
+  SOCKET fd_;
+#else
+  int fd_;
+#endif
+  bool connected_ = false;
+};
+
 class IpcServerTest : public testing::Test {
  protected:
   static void SetUpTestSuite() {
@@ -627,4 +697,216 @@ TEST_F(IpcServerTest, KeyJoyInjectionRequiresInputMapper) {
   CPC.InputMapper = saved;
 }
 
+// ─────────────────────────────────────────────────
+// Sessions: every connection gets its own command queue, so a client holding
+// its connection open no longer locks everyone else out until it idles away.
+// ─────────────────────────────────────────────────
+
+TEST_F(IpcServerTest, ConcurrentClientsAreServedTogether) {
+  z80.AF.b.h = 0x12;
+  IpcClient first;
+  IpcClient second;
+  ASSERT_TRUE(first.connected());
+  ASSERT_TRUE(second.connected());
+  EXPECT_EQ(first.ask("reg get A"), "OK 12\n");
+  EXPECT_OK(second.ask("reg set A 0x34"));
+  EXPECT_EQ(send_command("reg get A"), "OK 34\n");
+  EXPECT_EQ(first.ask("reg get A; reg get A"), "OK 34\n");
+  EXPECT_EQ(first.read_line(), "OK 34\n") << "the chained second reply";
+}
+
+TEST_F(IpcServerTest, MachineCommandsWaitForTheFrameBoundary) {
+  // With the gate live, register writes are handed to the "emulation thread"
+  // — this test — instead of running on the session.
+  ipc_pin_command_gate(true);
+  std::string reply;
+  std::thread client([&] { reply = send_command("reg set A 0x5A"); });
+  while (!ipc_commands_pending()) std::this_thread::yield();
+  EXPECT_EQ(z80.AF.b.h, 0x00) << "ran before a frame boundary";
+
+  ipc_drain_commands();
+  client.join();
+  EXPECT_OK(reply);
+  EXPECT_EQ(z80.AF.b.h, 0x5A);
+  ipc_pin_command_gate(false);
+}
+
+// ─────────────────────────────────────────────────
+// Binary mode: `binary` switches the connection to length-prefixed frames
+// (u32 len | u32 id | u8 op | payload, little-endian), answered in order
+// with the request's id.
+// ─────────────────────────────────────────────────
+
+std::string le32(uint32_t v) {
+  std::string out;
+  for (int i = 0; i < 4; i++) out.push_back(static_cast<char>(v >> (8 * i)));
+  return out;
+}
+
+std::string request_frame(uint32_t id, uint8_t op, const std::string& body) {
+  return le32(static_cast<uint32_t>(body.size() + 5)) + le32(id) +
+         static_cast<char>(op) + body;
+}
+
+struct ReplyFrame {
+  uint32_t id = 0;
+  uint8_t status = 0xFF;
+  std::string payload;
+};
+
+ReplyFrame read_frame(IpcClient& c) {
+  std::string const head = c.read_exact(9);
+  ReplyFrame f;
+  if (head.size() != 9) return f;
+  auto u32 = [&](size_t at) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--)
+      v = (v << 8) | static_cast<uint8_t>(head[at + static_cast<size_t>(i)]);
+    return v;
+  };
+  f.id = u32(4);
+  f.status = static_cast<uint8_t>(head[8]);
+  f.payload = c.read_exact(u32(0) - 5);
+  return f;
+}
+
+TEST_F(IpcServerTest, BinaryFramesCarryRawMemoryInRequestOrder) {
+  IpcClient c;
+  ASSERT_TRUE(c.connected());
+  EXPECT_OK(c.ask("mem write 0x4000 DEADBEEF"));
+
+  // The handshake and the first frames may share a packet.
+  std::string const mem = std::string(1, '\0') + le32(0x4000) + le32(4);
+  c.send_raw("binary\n" + request_frame(7, 1, mem) +
+             request_frame(8, 0, "reg get A") + request_frame(9, 1, "bad"));
+  EXPECT_EQ(c.read_line(), "OK binary v1\n");
+
+  ReplyFrame f = read_frame(c);
+  EXPECT_EQ(f.id, 7u);
+  EXPECT_EQ(f.status, 0);
+  EXPECT_EQ(f.payload, std::string("\xDE\xAD\xBE\xEF", 4));
+
+  f = read_frame(c);
+  EXPECT_EQ(f.id, 8u);
+  EXPECT_EQ(f.status, 0);
+  EXPECT_EQ(f.payload.substr(0, 3), "OK ");
+
+  f = read_frame(c);
+  EXPECT_EQ(f.id, 9u);
+  EXPECT_EQ(f.status, 1);
+  EXPECT_EQ(f.payload, "ERR 400 bad-mem-request\n");
+
+  // Op 5 hands the connection back to the text protocol.
+  c.send_raw(request_frame(10, 5, ""));
+  f = read_frame(c);
+  EXPECT_EQ(f.id, 10u);
+  EXPECT_EQ(f.status, 0);
+  EXPECT_EQ(c.ask("ping"), "OK pong\n");
+}
+
+TEST_F(IpcServerTest, BinaryPhysicalReadsStopAtTheEndOfRam) {
+  CPC.ram_size = 128;
+  IpcClient c;
+  ASSERT_TRUE(c.connected());
+  auto phys = [](uint32_t addr, uint32_t len) {
+    return std::string(1, '\x02') + le32(addr) + le32(len);
+  };
+  c.send_raw("binary\n" + request_frame(1, 1, phys(128 * 1024 - 2, 4)) +
+             request_frame(2, 1, phys(128 * 1024 + 1, 0)) +
+             request_frame(3, 1, phys(0, 0xFFFFFFFFu)));
+  EXPECT_EQ(c.read_line(), "OK binary v1\n");
+  for (uint32_t id = 1; id <= 3; id++) {
+    ReplyFrame const f = read_frame(c);
+    EXPECT_EQ(f.id, id);
+    EXPECT_EQ(f.status, 1);
+    EXPECT_EQ(f.payload, "ERR 416 out-of-range\n") << "request " << id;
+  }
+}
+
+TEST_F(IpcServerTest, BinaryOversizedRequestDropsTheConnection) {
+  IpcClient c;
+  ASSERT_TRUE(c.connected());
+  // The length alone is enough: the server must not wait for 64K+ of body.
+  c.send_raw("binary\n" + le32((1u << 16) + 1) + le32(1) + '\x00');
+  EXPECT_EQ(c.read_line(), "OK binary v1\n");
+  EXPECT_EQ(c.read_exact(9), "") << "expected the server to hang up";
+}
+
+TEST_F(IpcServerTest, BinaryMachineOpsNeedTheEngine) {
+  ASSERT_FALSE(subcycle_bridge_active());
+  IpcClient c;
+  ASSERT_TRUE(c.connected());
+  c.send_raw("binary\n" + request_frame(1, 2, "") + request_frame(2, 3, "") +
+             request_frame(3, 4, ""));
+  EXPECT_EQ(c.read_line(), "OK binary v1\n");
+  for (uint32_t id = 1; id <= 3; id++) {
+    ReplyFrame const f = read_frame(c);
+    EXPECT_EQ(f.id, id);
+    EXPECT_EQ(f.status, 1);
+    EXPECT_EQ(f.payload, "ERR 503 no-machine\n") << "request " << id;
+  }
+}
+
+// Ops 2-4 against a running sub-cycle machine. This test plays the emulation
+// thread: it runs the frames itself between requests.
+TEST_F(IpcServerTest, BinaryStateFrameAndAudioFromTheEngine) {
+  t_CPC const saved = CPC;
+  CPC.model = 2;
+  CPC.ram_size = 128;
+  CPC.rom_path = "rom";
+  if (!std::filesystem::exists("rom/cpc6128.rom")) CPC.rom_path = "../rom";
+  if (!subcycle_bridge_start()) {
+    CPC = saved;
+    GTEST_SKIP() << "rom/cpc6128.rom not found";
+  }
+  IpcClient c;
+  ASSERT_TRUE(c.connected());
+  c.send_raw("binary\n" + request_frame(1, 2, "") +
+             request_frame(2, 2, "psg") + request_frame(3, 2, "nosuch") +
+             request_frame(4, 3, "") + request_frame(5, 4, ""));
+  EXPECT_EQ(c.read_line(), "OK binary v1\n");
+
+  ReplyFrame f = read_frame(c);  // the whole machine
+  EXPECT_EQ(f.status, 0);
+  EXPECT_FALSE(f.payload.empty());
+  f = read_frame(c);  // one device
+  EXPECT_EQ(f.status, 0);
+  EXPECT_FALSE(f.payload.empty());
+  f = read_frame(c);
+  EXPECT_EQ(f.id, 3u);
+  EXPECT_EQ(f.status, 1);
+  EXPECT_EQ(f.payload, "ERR 404 unknown-device\n");
+
+  f = read_frame(c);  // u16 width, u16 height, u8 format, RGB24 pixels
+  EXPECT_EQ(f.status, 0);
+  ASSERT_GE(f.payload.size(), 5u);
+  size_t const w = static_cast<uint8_t>(f.payload[0]) |
+                   (static_cast<uint8_t>(f.payload[1]) << 8);
+  size_t const h = static_cast<uint8_t>(f.payload[2]) |
+                   (static_cast<uint8_t>(f.payload[3]) << 8);
+  EXPECT_EQ(f.payload[4], 0);
+  EXPECT_EQ(f.payload.size(), 5 + (w * h * 3));
+
+  f = read_frame(c);  // arms the capture: nothing made yet
+  EXPECT_EQ(f.status, 0);
+  EXPECT_EQ(f.payload, le32(44100) + '\x02');
+
+  uint8_t rows[16];
+  std::memset(rows, 0xFF, sizeof(rows));
+  std::string made;  // what the tap must have seen, as s16le
+  for (int i = 0; i < 3; i++) {
+    for (int16_t const v : subcycle_bridge_frame(rows, nullptr, false)) {
+      made.push_back(static_cast<char>(v & 0xFF));
+      made.push_back(static_cast<char>((v >> 8) & 0xFF));
+    }
+  }
+  EXPECT_FALSE(made.empty());
+  c.send_raw(request_frame(6, 4, ""));
+  f = read_frame(c);
+  EXPECT_EQ(f.status, 0);
+  EXPECT_EQ(f.payload, le32(44100) + '\x02' + made);
+  subcycle_bridge_stop();
+  CPC = saved;
+}
+
 }  // namespace
@@ -281,6 +281,48 @@ std::vector<uint8_t> block0_data_area() {
   return a;
 }
 
+// A two-sided disc of `cyls` cylinders, one block per track: every third
+// cylinder is a flakey Sync + Fuzzy track, the rest carry one 512-byte sector
+// (C/H from the track). Mixing the two makes each pass's starting weak-bit
+// RNG state depend on every pass before it.
+std::vector<uint8_t> build_mixed_disc(uint32_t cyls) {
+  std::vector<uint8_t> gap(34);
+  for (int i = 0; i < 22; ++i) gap[i] = 0x4E;
+  std::vector<uint8_t> f;
+  put_bytes(f, caps_record());
+  put_bytes(f, info_record(2, cyls - 1, 1));
+  uint32_t key = 1;
+  for (uint32_t c = 0; c < cyls; ++c) {
+    for (uint32_t h = 0; h < 2; ++h, ++key) {
+      const bool fuzzy = c % 3 == 1;
+      std::vector<uint8_t> a;
+      put_bytes(a, data_elem(ipf::DataType::Sync, sync_sample()));
+      if (fuzzy) {
+        put_bytes(a, fuzzy_elem(100 + c));
+      } else {
+        std::vector<uint8_t> payload(512);
+        for (int i = 0; i < 512; ++i)
+          payload[i] = static_cast<uint8_t>(i + c * 5 + h);
+        put_bytes(a, id_field(static_cast<uint8_t>(c), static_cast<uint8_t>(h),
+                              1, 2));
+        put_bytes(a, data_elem(ipf::DataType::Gap, gap));
+        put_bytes(a, data_elem(ipf::DataType::Sync, sync_sample()));
+        put_bytes(a, data_field(payload));
+      }
+      a.push_back(0x00);
+      uint32_t const data_bits = fuzzy ? 48 + 16 * (100 + c) : 8992;
+      uint32_t const gap_bits = fuzzy ? 0 : 1024;
+      std::vector<uint8_t> extra;
+      put_bytes(extra, block_desc(data_bits, gap_bits, 0, 0, 0x4E, 32));
+      put_bytes(extra, a);
+      put_bytes(f, imge_record(c, h, 2, data_bits, gap_bits, 1,
+                               fuzzy ? 1u : 0u, 0, key));
+      put_bytes(f, data_record(key, extra));
+    }
+  }
+  return f;
+}
+
 }  // namespace
 
 // ---------------------------------------------------------------------------
@@ -563,6 +605,107 @@ TEST(IpfDecode, FuzzyTrackVariesBetweenPasses) {
               cyls[0][1].bits != cyls[0][2].bits);
 }
 
+// The pooled mirror is the serial one: every revolution of every cylinder,
+// weak bits included, matches decoding the passes one by one with
+// lock_track — and the RNG carries on from the same state afterwards.
+TEST(IpfDecode, PooledMirrorMatchesSerialPasses) {
+  const std::vector<uint8_t> f = build_mixed_disc(9);
+  constexpr int kRevs = 3;
+
+  ipf::Image serial;
+  serial.seed_rng(0xD15C);
+  ASSERT_EQ(serial.open(f), Status::Ok);
+  std::vector<t_mfm_track> want;
+  for (int c = 0; c < 9; ++c) {
+    t_mfm_track track;
+    ipf::CleanTrackMFM first;
+    ASSERT_TRUE(serial.lock_track(c, 0, first));
+    ASSERT_GT(first.nbits, 0u);
+    track.push_back({first.bits, first.nbits});
+    for (int rv = 1; rv < kRevs; ++rv) {
+      if (!first.flakey) {
+        track.push_back(track.front());
+        continue;
+      }
+      ipf::CleanTrackMFM pass;
+      ASSERT_TRUE(serial.lock_track(c, 0, pass));
+      track.push_back({pass.bits, pass.nbits});
+    }
+    want.push_back(track);
+  }
+  ipf::CleanTrackMFM want_next;
+  ASSERT_TRUE(serial.lock_track(1, 0, want_next));
+  const std::vector<uint8_t> want_scp = scp_from_mfm_tracks(want);
+  ASSERT_FALSE(want_scp.empty());
+
+  for (unsigned threads : {1u, 4u}) {
+    ipf::Image img;
+    img.seed_rng(0xD15C);
+    ASSERT_EQ(img.open(f), Status::Ok);
+    EXPECT_EQ(scp_from_mfm_tracks(img.mirror_side0(kRevs, {}, threads)),
+              want_scp)
+        << threads << " threads";
+    ipf::CleanTrackMFM next;
+    ASSERT_TRUE(img.lock_track(1, 0, next));
+    EXPECT_EQ(next.bits, want_next.bits) << "RNG state after the mirror";
+  }
+}
+
+TEST(IpfDecode, PooledFillDriveMatchesOneThread) {
+  const std::vector<uint8_t> f = build_mixed_disc(9);
+  t_drive one, four;
+  std::memset(&one, 0, sizeof(one));
+  std::memset(&four, 0, sizeof(four));
+  ipf::Image a, b;
+  ASSERT_EQ(a.open(f), Status::Ok);
+  ASSERT_EQ(b.open(f), Status::Ok);
+  ASSERT_EQ(a.fill_drive(&one, 1), Status::Ok);
+  ASSERT_EQ(b.fill_drive(&four, 4), Status::Ok);
+  EXPECT_EQ(one.sides, 1u);
+  for (int c = 0; c < 9; ++c) {
+    for (int h = 0; h < 2; ++h) {
+      const t_track& x = one.track[c][h];
+      const t_track& y = four.track[c][h];
+      ASSERT_EQ(x.sectors, y.sectors) << c << "." << h;
+      ASSERT_EQ(x.size, y.size) << c << "." << h;
+      if (x.size != 0)
+        EXPECT_EQ(std::memcmp(x.data, y.data, x.size), 0) << c << "." << h;
+      if (c % 3 != 1) {
+        ASSERT_EQ(x.sectors, 1u) << c << "." << h;
+        EXPECT_EQ(x.sector[0].CHRN[1], static_cast<unsigned>(h));
+      }
+    }
+  }
+  ipf::free_drive_tracks(&one);
+  ipf::free_drive_tracks(&four);
+}
+
+// Progress counts every pass once (9 cylinders, 3 of them flakey × 3 revs)
+// and ends at the total; the dispatcher forwards it.
+TEST(IpfDecode, MirrorReportsProgressPerPass) {
+  const std::vector<uint8_t> f = build_mixed_disc(9);
+  int calls = 0, last = 0, total = 0;
+  bool ordered = true;
+  auto progress = [&](int done, int of) {
+    ++calls;
+    ordered = ordered && done == last + 1;
+    last = done;
+    total = of;
+  };
+  ipf::Image img;
+  ASSERT_EQ(img.open(f), Status::Ok);
+  ASSERT_EQ(img.mirror_side0(3, progress, 4).size(), 9u);
+  EXPECT_EQ(total, 6 + 3 * 3);
+  EXPECT_EQ(calls, total);
+  EXPECT_EQ(last, total);
+  EXPECT_TRUE(ordered);
+
+  calls = last = total = 0;
+  EXPECT_FALSE(flux::to_scp(f.data(), f.size(), ".ipf", progress).empty());
+  EXPECT_EQ(last, 15);
+  EXPECT_EQ(calls, 15);
+}
+
 // ---------------------------------------------------------------------------
 // Hostile / malformed input rejection (§2.1 robustness).
 // ---------------------------------------------------------------------------
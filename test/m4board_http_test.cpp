@@ -408,6 +408,14 @@ TEST_F(M4HttpTest, PreviewReturns503WhenNoSurface) {
   EXPECT_EQ(503, extract_status(resp));
 }
 
+TEST_F(M4HttpTest, PreviewPngReturns503WhenNoSurface) {
+  // Capture is on demand; with no surface the request still ends in a 503
+  // rather than an empty image.
+  auto resp = http_get(port_, "/preview.png");
+  ASSERT_FALSE(resp.empty());
+  EXPECT_EQ(503, extract_status(resp));
+}
+
 TEST_F(M4HttpTest, RomsApiReturnsJson) {
   auto resp = http_get(port_, "/roms.json");
   ASSERT_FALSE(resp.empty());
@@ -0,0 +1,239 @@
+#include "media_file.h"
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+class MediaFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = ::testing::TempDir() + "media_file_test_" +
+            ::testing::UnitTest::GetInstance()->current_test_info()->name() +
+            ".img";
+  }
+  void TearDown() override {
+    std::remove(path_.c_str());
+    std::remove((path_ + ".journal").c_str());
+    std::remove((path_ + ".tmp").c_str());
+  }
+
+  void put(const std::vector<uint8_t>& bytes) const {
+    std::ofstream f(path_, std::ios::binary);
+    f.write(reinterpret_cast<const char*>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+  }
+  std::vector<uint8_t> get(const std::string& p) const {
+    std::ifstream f(p, std::ios::binary);
+    return {(std::istreambuf_iterator<char>(f)),
+            std::istreambuf_iterator<char>()};
+  }
+
+  void put_journal(const std::vector<uint8_t>& bytes) const {
+    std::ofstream f(path_ + ".journal", std::ios::binary);
+    f.write(reinterpret_cast<const char*>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+  }
+
+  std::string path_;
+};
+
+std::vector<uint8_t> pattern(size_t n) {
+  std::vector<uint8_t> v(n);
+  for (size_t i = 0; i < n; ++i) v[i] = static_cast<uint8_t>(i * 7 + 3);
+  return v;
+}
+
+// A standard DSK header: `tracks` x `sides`, every track `size` bytes.
+std::vector<uint8_t> std_dsk(int tracks, int sides, int size) {
+  std::vector<uint8_t> d(0x100 + static_cast<size_t>(tracks * sides * size));
+  std::memcpy(d.data(), "MV - CPCEMU Disk-File\r\nDisk-Info\r\n", 34);
+  d[0x30] = static_cast<uint8_t>(tracks);
+  d[0x31] = static_cast<uint8_t>(sides);
+  d[0x32] = static_cast<uint8_t>(size & 0xFF);
+  d[0x33] = static_cast<uint8_t>(size >> 8);
+  return d;
+}
+
+void le(std::vector<uint8_t>& v, uint64_t x, int n) {
+  for (int i = 0; i < n; ++i) v.push_back(static_cast<uint8_t>(x >> (8 * i)));
+}
+
+// A one-entry journal in the media_file.h layout.
+std::vector<uint8_t> journal(size_t image_len, uint64_t off,
+                             const std::vector<uint8_t>& bytes) {
+  std::vector<uint8_t> j = {'K', 'J', 'N', 'L'};
+  le(j, 1, 4);
+  le(j, image_len, 8);
+  le(j, 1, 4);
+  le(j, off, 8);
+  le(j, bytes.size(), 8);
+  j.insert(j.end(), bytes.begin(), bytes.end());
+  le(j, crc32(0L, j.data() + 4, static_cast<uInt>(j.size() - 4)), 4);
+  j.insert(j.end(), {'K', 'E', 'N', 'D'});
+  return j;
+}
+
+}  // namespace
+
+TEST_F(MediaFileTest, MappedWritesStayPrivateToTheProcess) {
+  const std::vector<uint8_t> orig = pattern(8192);
+  put(orig);
+  media::Buffer b = media::Buffer::map(path_);
+  ASSERT_EQ(b.size(), orig.size());
+  EXPECT_EQ(std::vector<uint8_t>(b.data(), b.data() + b.size()), orig);
+  b.data()[100] ^= 0xFF;  // the machine writes into the image...
+  b.clear();
+  EXPECT_EQ(get(path_), orig) << "...but the file only changes on write_back";
+
+  media::Buffer moved(std::move(b));
+  EXPECT_TRUE(moved.empty());
+  EXPECT_TRUE(media::Buffer::map(path_ + ".missing").empty());
+}
+
+TEST_F(MediaFileTest, MappingKnowsWhenItsFileChangesUnderIt) {
+  const std::vector<uint8_t> orig = pattern(8192);
+  put(orig);
+  media::Buffer b = media::Buffer::map(path_);
+  ASSERT_TRUE(b.mapped());
+  EXPECT_TRUE(b.backs(path_));
+
+  // The host's own write-back, then restamp: still the same file.
+  b.data()[10] ^= 0xFF;
+  std::string err;
+  ASSERT_TRUE(media::write_back(path_, b.data(), b.size(), {{0, 16}}, err))
+      << err;
+  b.restamp(path_);
+  EXPECT_TRUE(b.backs(path_));
+
+  // A Save-As renames a new file in: the mapping keeps the old one whole.
+  const std::vector<uint8_t> mine(b.data(), b.data() + b.size());
+  {
+    std::ofstream f(path_ + ".tmp", std::ios::binary);
+    f.write("short", 5);
+  }
+  ASSERT_EQ(std::rename((path_ + ".tmp").c_str(), path_.c_str()), 0);
+  EXPECT_FALSE(b.backs(path_));
+  EXPECT_EQ(std::vector<uint8_t>(b.data(), b.data() + b.size()), mine);
+  b.restamp(path_);
+  EXPECT_TRUE(b.backs(path_));
+
+  // Truncated in place: caught without touching the (now faulting) pages.
+  put(orig);
+  media::Buffer c = media::Buffer::map(path_);
+  ASSERT_TRUE(c.mapped());
+  put(pattern(100));
+  EXPECT_FALSE(c.backs(path_));
+
+  media::Buffer heap(pattern(16));  // a heap copy has no file to lose
+  EXPECT_TRUE(heap.backs(path_ + ".missing"));
+}
+
+TEST_F(MediaFileTest, WriteBackPatchesOnlyTheRanges) {
+  std::vector<uint8_t> img = pattern(4096);
+  put(img);
+  std::vector<uint8_t> other = img;
+  for (uint8_t& c : other) c ^= 0x5A;  // what the host will hold in memory
+  std::string err;
+  ASSERT_TRUE(media::write_back(path_, other.data(), other.size(),
+                                {{512, 256}, {3000, 96}}, err))
+      << err;
+  const std::vector<uint8_t> disk = get(path_);
+  ASSERT_EQ(disk.size(), img.size());
+  for (size_t i = 0; i < disk.size(); ++i) {
+    const bool in = (i >= 512 && i < 768) || (i >= 3000 && i < 3096);
+    ASSERT_EQ(disk[i], in ? other[i] : img[i]) << "offset " << i;
+  }
+  EXPECT_TRUE(get(path_ + ".journal").empty()) << "a clean commit drops it";
+}
+
+TEST_F(MediaFileTest, WriteBackRewritesAFileOfAnotherSizeWhole) {
+  put(pattern(100));
+  const std::vector<uint8_t> img = pattern(300);
+  std::string err;
+  ASSERT_TRUE(media::write_back(path_, img.data(), img.size(), {}, err));
+  EXPECT_EQ(get(path_), img);
+}
+
+TEST_F(MediaFileTest, RecoverReplaysACompleteJournal) {
+  const std::vector<uint8_t> img = pattern(2048);
+  put(img);
+  // A crash after the journal was synced, before the image was patched.
+  const std::vector<uint8_t> fresh(300, 0xEE);
+  put_journal(journal(img.size(), 512, fresh));
+  EXPECT_TRUE(media::recover(path_));
+  std::vector<uint8_t> want = img;
+  std::copy(fresh.begin(), fresh.end(), want.begin() + 512);
+  EXPECT_EQ(get(path_), want);
+  EXPECT_TRUE(get(path_ + ".journal").empty());
+  EXPECT_FALSE(media::recover(path_)) << "no journal: nothing to replay";
+}
+
+TEST_F(MediaFileTest, RecoverDiscardsATornJournal) {
+  const std::vector<uint8_t> img = pattern(2048);
+  put(img);
+  // A crash while the journal itself was being written: no trailer.
+  std::vector<uint8_t> j = journal(img.size(), 512, std::vector<uint8_t>(300));
+  j.resize(j.size() - 3);
+  put_journal(j);
+  EXPECT_FALSE(media::recover(path_));
+  EXPECT_EQ(get(path_), img) << "the image was never touched";
+  EXPECT_TRUE(get(path_ + ".journal").empty()) << "and the torn journal goes";
+
+  // A journal for an image of another size is not ours to apply either.
+  put_journal(journal(img.size() * 2, 0, std::vector<uint8_t>(16)));
+  EXPECT_FALSE(media::recover(path_));
+  EXPECT_EQ(get(path_), img);
+}
+
+TEST_F(MediaFileTest, DskTrackRangesFollowTheTrackTable) {
+  // Standard: 3 tracks, 2 sides, 0x1300 per track.
+  const std::vector<uint8_t> s = std_dsk(3, 2, 0x1300);
+  const uint8_t written[3] = {0x00, 0x02, 0x03};  // 1/1, 2/0, 2/1
+  const std::vector<media::Range> r =
+      media::dsk_track_ranges(s.data(), s.size(), written, 3);
+  ASSERT_EQ(r.size(), 1u) << "adjacent tracks coalesce";
+  EXPECT_EQ(r[0].off, 0x100u + 3 * 0x1300u);
+  EXPECT_EQ(r[0].len, 3 * 0x1300u);
+
+  // Extended: per-track sizes from the table at 0x34; an unformatted (0)
+  // track takes no space.
+  std::vector<uint8_t> e(0x100 + 0x1200 + 0x1500);
+  std::memcpy(e.data(), "EXTENDED CPC DSK File\r\nDisk-Info\r\n", 34);
+  e[0x30] = 3;
+  e[0x31] = 1;
+  e[0x34] = 0x12;
+  e[0x35] = 0x00;
+  e[0x36] = 0x15;
+  const uint8_t w2[3] = {0x01, 0x01, 0x01};
+  const std::vector<media::Range> x =
+      media::dsk_track_ranges(e.data(), e.size(), w2, 3);
+  ASSERT_EQ(x.size(), 1u);
+  EXPECT_EQ(x[0].off, 0x100u);
+  EXPECT_EQ(x[0].len, 0x1200u + 0x1500u);
+
+  const uint8_t none[3] = {};
+  EXPECT_TRUE(media::dsk_track_ranges(s.data(), s.size(), none, 3).empty());
+  EXPECT_TRUE(media::dsk_track_ranges(pattern(512).data(), 512, written, 3)
+                  .empty())
+      << "not a DSK";
+}
+
+TEST(MediaFile, RegionRangesClipTheLastRegion) {
+  uint8_t map[2] = {0x81, 0x01};  // regions 0, 7 and 8
+  const std::vector<media::Range> r =
+      media::region_ranges(map, 16, 4, 8 * 2048 + 1024);
+  ASSERT_EQ(r.size(), 2u);
+  EXPECT_EQ(r[0].off, 0u);
+  EXPECT_EQ(r[0].len, 2048u);
+  EXPECT_EQ(r[1].off, 7u * 2048);
+  EXPECT_EQ(r[1].len, 2048u + 1024u) << "region 8 is clipped to the image";
+}
@@ -0,0 +1,179 @@
+#include "media_library.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+class MediaLibraryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = fs::path(::testing::TempDir()) /
+           (std::string("media_library_test_") +
+            ::testing::UnitTest::GetInstance()->current_test_info()->name());
+    fs::remove_all(dir_);
+    fs::create_directories(dir_);
+  }
+  void TearDown() override { fs::remove_all(dir_); }
+
+  std::string put(const std::string& name,
+                  const std::vector<uint8_t>& bytes) const {
+    const fs::path p = dir_ / name;
+    fs::create_directories(p.parent_path());
+    std::ofstream f(p, std::ios::binary);
+    f.write(reinterpret_cast<const char*>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+    return p.string();
+  }
+  std::string index_path() const { return (dir_ / "lib.idx").string(); }
+
+  fs::path dir_;
+};
+
+// A version 3 6128 snapshot header (plus a little RAM).
+std::vector<uint8_t> sna() {
+  std::vector<uint8_t> s(0x100 + 1024);
+  std::memcpy(s.data(), "MV - SNA", 8);
+  s[0x10] = 3;
+  s[0x6B] = 128;
+  s[0x6D] = 2;
+  return s;
+}
+
+// A CDT holding one pure-tone block.
+std::vector<uint8_t> cdt() {
+  std::vector<uint8_t> t = {'Z', 'X', 'T', 'a', 'p', 'e', '!', 0x1A, 1, 20};
+  t.insert(t.end(), {0x12, 0x78, 0x08, 0x10, 0x00});
+  return t;
+}
+
+library::Entry entry(const std::string& path, library::Kind kind,
+                     const std::string& format, const std::string& catalog) {
+  library::Entry e;
+  e.path = path;
+  e.size = 1234;
+  e.mtime = 42;
+  e.crc = 0xCAFEF00D;
+  e.kind = kind;
+  e.format = format;
+  e.catalog = catalog;
+  return e;
+}
+
+}  // namespace
+
+TEST_F(MediaLibraryTest, IndexFileDescribesSnapshotsAndTapes) {
+  library::Entry e;
+  ASSERT_TRUE(library::index_file(put("game.sna", sna()), e));
+  EXPECT_EQ(e.kind, library::Kind::Snapshot);
+  EXPECT_EQ(e.format, "SNA v3 6128 128K");
+  EXPECT_EQ(e.size, sna().size());
+  EXPECT_NE(e.crc, 0u);
+
+  ASSERT_TRUE(library::index_file(put("GAME.CDT", cdt()), e));
+  EXPECT_EQ(e.kind, library::Kind::Tape);
+  EXPECT_EQ(e.format, "CDT v1.20");
+
+  EXPECT_FALSE(library::index_file(put("notes.txt", cdt()), e));
+  EXPECT_FALSE(library::index_file(put("bad.sna", cdt()), e))
+      << "the extension alone does not make it media";
+}
+
+TEST_F(MediaLibraryTest, WrittenIndexReadsBack) {
+  const std::vector<library::Entry> in = {
+      entry("/m/a.dsk", library::Kind::Disk, "EDSK 42x1 DATA", "DISC.BAS"),
+      entry("/m/b.cdt", library::Kind::Tape, "CDT v1.20", "")};
+  std::string err;
+  ASSERT_TRUE(library::write_index(index_path(), in, err)) << err;
+  const library::Index ix = library::Index::open(index_path());
+  ASSERT_EQ(ix.size(), 2u);
+  for (size_t i = 0; i < in.size(); ++i) {
+    const library::Entry e = ix.at(i);
+    EXPECT_EQ(e.path, in[i].path);
+    EXPECT_EQ(e.size, in[i].size);
+    EXPECT_EQ(e.mtime, in[i].mtime);
+    EXPECT_EQ(e.crc, in[i].crc);
+    EXPECT_EQ(e.kind, in[i].kind);
+    EXPECT_EQ(e.format, in[i].format);
+    EXPECT_EQ(e.catalog, in[i].catalog);
+  }
+}
+
+TEST_F(MediaLibraryTest, MalformedIndexOpensEmpty) {
+  EXPECT_EQ(library::Index::open(index_path()).size(), 0u) << "missing";
+  put("lib.idx", {'K', 'L', 'I', 'B', 1, 0, 0, 0, 200, 0, 0, 0, 0, 0, 0, 0});
+  EXPECT_EQ(library::Index::open(index_path()).size(), 0u)
+      << "200 records promised, none present";
+  put("lib.idx", {'N', 'O', 'P', 'E'});
+  EXPECT_EQ(library::Index::open(index_path()).size(), 0u);
+}
+
+TEST_F(MediaLibraryTest, QueryRanksNamesAndCatalogWords) {
+  const std::vector<library::Entry> in = {
+      entry("/m/Barbarian.dsk", library::Kind::Disk, "DSK 40x1 DATA",
+            "BARB.BAS BARB.BIN"),
+      entry("/m/compil.dsk", library::Kind::Disk, "DSK 40x1 DATA",
+            "RICK.BAS RICK2.BIN"),
+      entry("/m/Rick Dangerous.cdt", library::Kind::Tape, "CDT v1.20", "")};
+  std::string err;
+  ASSERT_TRUE(library::write_index(index_path(), in, err)) << err;
+  const library::Index ix = library::Index::open(index_path());
+
+  const std::vector<library::Hit> hits = ix.query("rick", 10);
+  ASSERT_EQ(hits.size(), 2u) << "the tape by name, the compilation by catalog";
+  for (const library::Hit& h : hits) EXPECT_GT(h.score, 0);
+  EXPECT_GE(hits[0].score, hits[1].score);
+
+  ASSERT_EQ(ix.query("barb", 10).size(), 1u);
+  EXPECT_EQ(ix.query("barb", 10)[0].entry.path, "/m/Barbarian.dsk");
+  EXPECT_EQ(ix.query("rick", 1).size(), 1u) << "limit";
+  EXPECT_TRUE(ix.query("zzzz", 10).empty());
+}
+
+TEST_F(MediaLibraryTest, RescanReusesUnchangedEntries) {
+  const std::string snap = put("games/one.sna", sna());
+  put("games/deep/two.cdt", cdt());
+  put("games/readme.txt", {'h', 'i'});
+
+  std::vector<library::Entry> first =
+      library::scan({(dir_ / "games").string()}, nullptr, 2);
+  ASSERT_EQ(first.size(), 2u);
+  EXPECT_EQ(first[0].path, (dir_ / "games/deep/two.cdt").string());
+  EXPECT_EQ(first[1].path, snap);
+
+  // Doctor the stored description: a rescan that trusts size + mtime keeps
+  // it, so the file was not read again.
+  first[1].format = "carried over";
+  std::string err;
+  ASSERT_TRUE(library::write_index(index_path(), first, err)) << err;
+  const library::Index prev = library::Index::open(index_path());
+  int last_done = 0;
+  int last_total = 0;
+  const std::vector<library::Entry> again =
+      library::scan({(dir_ / "games").string()}, &prev, 2,
+                    [&](int done, int total) {
+                      last_done = done;
+                      last_total = total;
+                    });
+  ASSERT_EQ(again.size(), 2u);
+  EXPECT_EQ(again[1].format, "carried over");
+  EXPECT_EQ(last_done, 2);
+  EXPECT_EQ(last_total, 2);
+
+  // Once the file changes size it is described afresh.
+  std::vector<uint8_t> bigger = sna();
+  bigger.resize(bigger.size() + 1024);
+  put("games/one.sna", bigger);
+  const std::vector<library::Entry> third =
+      library::scan({(dir_ / "games").string()}, &prev, 2);
+  ASSERT_EQ(third.size(), 2u);
+  EXPECT_EQ(third[1].format, "SNA v3 6128 128K");
+}
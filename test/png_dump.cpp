@@ -0,0 +1,199 @@
+#include "png_dump.h"
+
+#include <gtest/gtest.h>
+#include <png.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Decoded {
+  bool ok = false;
+  int width = 0, height = 0;
+  int color_type = -1;
+  std::vector<uint32_t> rgb;  // 0x00RRGGBB
+};
+
+// Read a PNG back through libpng's simplified API as RGB.
+Decoded read_png(const std::string& path) {
+  Decoded d;
+  png_image img{};
+  img.version = PNG_IMAGE_VERSION;
+  if (!png_image_begin_read_from_file(&img, path.c_str())) return d;
+  d.color_type = (img.format & PNG_FORMAT_FLAG_COLORMAP) ? PNG_COLOR_TYPE_PALETTE
+                                                          : PNG_COLOR_TYPE_RGB;
+  img.format = PNG_FORMAT_RGB;
+  std::vector<uint8_t> buf(PNG_IMAGE_SIZE(img));
+  if (!png_image_finish_read(&img, nullptr, buf.data(), 0, nullptr)) return d;
+  d.width = static_cast<int>(img.width);
+  d.height = static_cast<int>(img.height);
+  d.rgb.resize(buf.size() / 3);
+  for (size_t i = 0; i < d.rgb.size(); ++i)
+    d.rgb[i] = (uint32_t{buf[i * 3]} << 16) | (uint32_t{buf[(i * 3) + 1]} << 8) |
+               buf[(i * 3) + 2];
+  d.ok = true;
+  return d;
+}
+
+struct Image {
+  int w, h;
+  std::vector<uint8_t> rgba;
+  Image(int w_, int h_) : w(w_), h(h_), rgba(static_cast<size_t>(w_) * h_ * 4) {}
+  void set(int x, int y, uint32_t c) {
+    uint8_t* p = &rgba[((static_cast<size_t>(y) * w) + x) * 4];
+    p[0] = static_cast<uint8_t>(c >> 16);
+    p[1] = static_cast<uint8_t>(c >> 8);
+    p[2] = static_cast<uint8_t>(c);
+    p[3] = 0xFF;
+  }
+  std::vector<uint32_t> rgb() const {
+    std::vector<uint32_t> v(static_cast<size_t>(w) * h);
+    for (size_t i = 0; i < v.size(); ++i)
+      v[i] = (uint32_t{rgba[i * 4]} << 16) | (uint32_t{rgba[(i * 4) + 1]} << 8) |
+             rgba[(i * 4) + 2];
+    return v;
+  }
+};
+
+Image cpc_image(int w, int h, int seed = 0) {
+  Image img(w, h);
+  static const uint32_t kInks[] = {0x000080, 0xFFFF00, 0x00FFFF, 0xFF0000,
+                                   0x808080};
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x)
+      img.set(x, y, kInks[((x / 4) + (y / 2) + seed) % 5]);
+  return img;
+}
+
+class PngDumpTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = fs::temp_directory_path() / "png_dump_test";
+    fs::create_directories(dir_);
+  }
+  void TearDown() override { fs::remove_all(dir_); }
+  std::string path(const std::string& name) { return (dir_ / name).string(); }
+  fs::path dir_;
+};
+
+}  // namespace
+
+TEST_F(PngDumpTest, FewColoursWritePaletteImage) {
+  Image img = cpc_image(96, 40);
+  const PngWriteResult r =
+      write_png_rgba(path("pal.png"), img.rgba.data(), img.w, img.h, img.w * 4);
+  ASSERT_TRUE(r.ok) << r.error;
+  EXPECT_TRUE(r.paletted);
+  EXPECT_EQ(r.bytes, fs::file_size(path("pal.png")));
+  Decoded d = read_png(path("pal.png"));
+  ASSERT_TRUE(d.ok);
+  EXPECT_EQ(d.color_type, PNG_COLOR_TYPE_PALETTE);
+  EXPECT_EQ(d.width, 96);
+  EXPECT_EQ(d.height, 40);
+  EXPECT_EQ(d.rgb, img.rgb());
+}
+
+TEST_F(PngDumpTest, ManyColoursFallBackToRgb) {
+  Image img(64, 64);
+  for (int y = 0; y < 64; ++y)
+    for (int x = 0; x < 64; ++x)
+      img.set(x, y, static_cast<uint32_t>((y * 64) + x) * 0x000F0Fu);
+  for (PngFilter f : {PngFilter::Auto, PngFilter::None, PngFilter::Paeth}) {
+    PngOptions opts;
+    opts.filter = f;
+    opts.zlib_level = 1;
+    const PngWriteResult r = write_png_rgba(
+        path("rgb.png"), img.rgba.data(), img.w, img.h, img.w * 4, opts);
+    ASSERT_TRUE(r.ok) << r.error;
+    EXPECT_FALSE(r.paletted);
+    Decoded d = read_png(path("rgb.png"));
+    ASSERT_TRUE(d.ok);
+    EXPECT_EQ(d.color_type, PNG_COLOR_TYPE_RGB);
+    EXPECT_EQ(d.rgb, img.rgb());
+  }
+}
+
+TEST_F(PngDumpTest, PitchLargerThanRowIsHonoured) {
+  Image img = cpc_image(10, 6);
+  const int pitch = (10 * 4) + 24;
+  std::vector<uint8_t> padded(static_cast<size_t>(pitch) * 6, 0xEE);
+  for (int y = 0; y < 6; ++y)
+    std::copy_n(&img.rgba[static_cast<size_t>(y) * 40], 40,
+                &padded[static_cast<size_t>(y) * pitch]);
+  ASSERT_TRUE(write_png_rgba(path("pitch.png"), padded.data(), 10, 6, pitch).ok);
+  EXPECT_EQ(read_png(path("pitch.png")).rgb, img.rgb());
+}
+
+TEST_F(PngDumpTest, UnwritablePathReportsError) {
+  Image img = cpc_image(8, 8);
+  const PngWriteResult r = write_png_rgba((dir_ / "no/such/dir.png").string(),
+                                          img.rgba.data(), 8, 8, 32);
+  EXPECT_FALSE(r.ok);
+  EXPECT_FALSE(r.error.empty());
+}
+
+TEST_F(PngDumpTest, InMemoryEncodeMatchesFile) {
+  Image img = cpc_image(33, 17);
+  std::vector<uint8_t> mem;
+  const PngWriteResult m =
+      encode_png_rgba(mem, img.rgba.data(), img.w, img.h, img.w * 4);
+  ASSERT_TRUE(m.ok) << m.error;
+  EXPECT_TRUE(m.paletted);
+  EXPECT_EQ(m.bytes, mem.size());
+  ASSERT_TRUE(
+      write_png_rgba(path("m.png"), img.rgba.data(), img.w, img.h, img.w * 4)
+          .ok);
+  std::FILE* f = std::fopen(path("m.png").c_str(), "rb");
+  ASSERT_NE(f, nullptr);
+  std::vector<uint8_t> disk(mem.size() + 1);
+  const size_t n = std::fread(disk.data(), 1, disk.size(), f);
+  std::fclose(f);
+  disk.resize(n);
+  EXPECT_EQ(disk, mem);
+}
+
+TEST(PngFilterName, ParsesKnownNames) {
+  PngFilter f = PngFilter::Auto;
+  EXPECT_TRUE(png_filter_from_string("paeth", f));
+  EXPECT_EQ(f, PngFilter::Paeth);
+  EXPECT_TRUE(png_filter_from_string("none", f));
+  EXPECT_EQ(f, PngFilter::None);
+  EXPECT_FALSE(png_filter_from_string("best", f));
+}
+
+// More frames than queue slots across several workers: every frame lands,
+// intact, and the report accounts for all of them.
+TEST_F(PngDumpTest, PoolWritesEveryFrameAndReports) {
+  constexpr int kFrames = 40;
+  std::vector<Image> frames;
+  {
+    PngDumpPool pool(3, 4);
+    EXPECT_EQ(pool.threads(), 3);
+    for (int i = 0; i < kFrames; ++i) {
+      frames.push_back(cpc_image(48, 20, i));
+      pool.submit(path("f" + std::to_string(i) + ".png"),
+                  frames.back().rgba.data(), 48, 20, 48 * 4);
+    }
+    pool.submit(dir_.string() + "/missing/x.png", frames[0].rgba.data(), 48,
+                20, 48 * 4);
+    const PngDumpPool::Report rep = pool.finish();
+    EXPECT_EQ(rep.written, static_cast<uint32_t>(kFrames));
+    EXPECT_EQ(rep.paletted, static_cast<uint32_t>(kFrames));
+    EXPECT_EQ(rep.failed, 1u);
+    EXPECT_NE(rep.first_error.find("missing"), std::string::npos);
+    EXPECT_GE(rep.queue_peak, 1u);
+    EXPECT_LE(rep.queue_peak, 4u);
+    EXPECT_GT(rep.bytes, 0u);
+    EXPECT_EQ(pool.finish().written, rep.written);  // idempotent
+  }
+  for (int i = 0; i < kFrames; ++i) {
+    Decoded d = read_png(path("f" + std::to_string(i) + ".png"));
+    ASSERT_TRUE(d.ok) << i;
+    EXPECT_EQ(d.rgb, frames[static_cast<size_t>(i)].rgb()) << i;
+  }
+}
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <string>
 #include <vector>
 
 #include "errors.h"
@@ -18,6 +19,72 @@
  *     - hello.dsk
  */
 
+namespace {
+
+// A one-entry STORED (method 0) zip holding `name` = `payload`.
+void write_stored_zip(const std::filesystem::path& path,
+                      const std::string& name, const std::string& payload) {
+  std::vector<uint8_t> z;
+  auto le16 = [&](uint16_t v) {
+    z.push_back(v & 0xFF);
+    z.push_back(v >> 8);
+  };
+  auto le32 = [&](uint32_t v) {
+    for (int i = 0; i < 4; ++i) z.push_back((v >> (8 * i)) & 0xFF);
+  };
+  // Local header (PK\3\4): method 0, sizes = payload, then name + data.
+  le32(0x04034b50);
+  le16(20);
+  le16(0);
+  le16(0);
+  le16(0);
+  le16(0);
+  le32(0);  // crc (unchecked by the loader)
+  le32(payload.size());
+  le32(payload.size());
+  le16(name.size());
+  le16(0);
+  z.insert(z.end(), name.begin(), name.end());
+  z.insert(z.end(), payload.begin(), payload.end());
+  const uint32_t cd_off = z.size();
+  // Central directory entry (PK\1\2) pointing at local offset 0.
+  le32(0x02014b50);
+  le16(20);
+  le16(20);
+  le16(0);
+  le16(0);
+  le16(0);
+  le16(0);
+  le32(0);
+  le32(payload.size());
+  le32(payload.size());
+  le16(name.size());
+  le16(0);
+  le16(0);
+  le16(0);
+  le16(0);
+  le32(0);
+  le32(0);
+  z.insert(z.end(), name.begin(), name.end());
+  const uint32_t cd_size = z.size() - cd_off;
+  // EOCD (PK\5\6).
+  le32(0x06054b50);
+  le16(0);
+  le16(0);
+  le16(1);
+  le16(1);
+  le32(cd_size);
+  le32(cd_off);
+  le16(0);
+  {
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(z.data()),
+              static_cast<std::streamsize>(z.size()));
+  }
+}
+
+}  // namespace
+
 TEST(Zip, DirOnFileWithNoMatchingEntry) {
   zip::t_zip_info file_infos;
   file_infos.filename = "test/zip/test1.zip";
@@ -131,63 +198,7 @@ TEST(Zip, ExtractsAStoredEntry) {
   const fs::path path = fs::temp_directory_path() / "koncpc_zip_stored.zip";
   const std::string payload = "stored payload";
   const std::string name = "file.dsk";
-  std::vector<uint8_t> z;
-  auto le16 = [&](uint16_t v) {
-    z.push_back(v & 0xFF);
-    z.push_back(v >> 8);
-  };
-  auto le32 = [&](uint32_t v) {
-    for (int i = 0; i < 4; ++i) z.push_back((v >> (8 * i)) & 0xFF);
-  };
-  // Local header (PK\3\4): method 0, sizes = payload, then name + data.
-  le32(0x04034b50);
-  le16(20);
-  le16(0);
-  le16(0);
-  le16(0);
-  le16(0);
-  le32(0);  // crc (unchecked by the loader)
-  le32(payload.size());
-  le32(payload.size());
-  le16(name.size());
-  le16(0);
-  z.insert(z.end(), name.begin(), name.end());
-  z.insert(z.end(), payload.begin(), payload.end());
-  const uint32_t cd_off = z.size();
-  // Central directory entry (PK\1\2) pointing at local offset 0.
-  le32(0x02014b50);
-  le16(20);
-  le16(20);
-  le16(0);
-  le16(0);
-  le16(0);
-  le16(0);
-  le32(0);
-  le32(payload.size());
-  le32(payload.size());
-  le16(name.size());
-  le16(0);
-  le16(0);
-  le16(0);
-  le16(0);
-  le32(0);
-  le32(0);
-  z.insert(z.end(), name.begin(), name.end());
-  const uint32_t cd_size = z.size() - cd_off;
-  // EOCD (PK\5\6).
-  le32(0x06054b50);
-  le16(0);
-  le16(0);
-  le16(1);
-  le16(1);
-  le32(cd_size);
-  le32(cd_off);
-  le16(0);
-  {
-    std::ofstream out(path, std::ios::binary);
-    out.write(reinterpret_cast<const char*>(z.data()),
-              static_cast<std::streamsize>(z.size()));
-  }
+  write_stored_zip(path, name, payload);
 
   zip::t_zip_info info;
   info.filename = path.string();
@@ -205,3 +216,62 @@ TEST(Zip, ExtractsAStoredEntry) {
   std::error_code ec;
   fs::remove(path, ec);
 }
+
+// The in-memory extractor yields exactly what the temp-file one does.
+TEST(Zip, ExtractToMatchesExtract) {
+  zip::t_zip_info info;
+  info.filename = "test/zip/test1.zip";
+  info.extensions = ".dsk";
+  ASSERT_EQ(0, zip::dir(&info));
+  for (const auto& entry : info.filesOffsets) {
+    info.dwOffset = entry.second;
+    FILE* f = nullptr;
+    ASSERT_EQ(0, zip::extract(info, &f));
+    std::vector<byte> want;
+    byte buf[4096];
+    size_t n = 0;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+      want.insert(want.end(), buf, buf + n);
+    fclose(f);
+    std::vector<byte> got;
+    ASSERT_EQ(0, zip::extract_to(info, got)) << entry.first;
+    EXPECT_EQ(want, got) << entry.first;
+    ASSERT_EQ(0, zip::extract_to(info, got)) << "served from the cache";
+    EXPECT_EQ(want, got) << entry.first;
+  }
+}
+
+// The directory and entry caches are keyed by the archive's stamp: rewriting
+// it, in place or by rename, must never serve the old contents.
+TEST(Zip, CacheMissesARewrittenArchive) {
+  namespace fs = std::filesystem;
+  const fs::path path = fs::temp_directory_path() / "koncpc_zip_cache.zip";
+  zip::clear_cache();
+  auto read = [&](const std::string& ext) {
+    zip::t_zip_info info;
+    info.filename = path.string();
+    info.extensions = ext;
+    std::vector<byte> out;
+    if (zip::dir(&info) != 0 || zip::extract_to(info, out) != 0)
+      return std::string("?");
+    return std::string(out.begin(), out.end());
+  };
+  write_stored_zip(path, "one.dsk", "first disc");
+  EXPECT_EQ("first disc", read(".dsk"));
+  EXPECT_EQ("first disc", read(".dsk"));
+  write_stored_zip(path, "two.sna", "a snapshot, longer");
+  EXPECT_EQ("?", read(".dsk")) << "the cached directory was not reused";
+  EXPECT_EQ("a snapshot, longer", read(".sna"));
+
+  // Same size and the same mtime, swapped in by rename (how editors save):
+  // only the inode and ctime tell it apart.
+  const fs::path next = path.string() + ".new";
+  write_stored_zip(next, "two.sna", "a snapshot, LONGER");
+  ASSERT_EQ(fs::file_size(next), fs::file_size(path));
+  fs::last_write_time(next, fs::last_write_time(path));
+  fs::rename(next, path);
+  EXPECT_EQ("a snapshot, LONGER", read(".sna")) << "the cached entry is stale";
+  std::error_code ec;
+  fs::remove(path, ec);
+  EXPECT_EQ("?", read(".sna")) << "a vanished archive is not served";
+}
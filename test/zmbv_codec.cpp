@@ -0,0 +1,234 @@
+#include "zmbv_codec.h"
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Minimal ZMBV decoder (the subset the encoder emits: zlib, 8/32 bpp, zero
+// motion vectors) producing 0x00RRGGBB pixels.
+class ZmbvDecoder {
+ public:
+  ZmbvDecoder(int w, int h) : w_(w), h_(h) {
+    inflateInit(&zs_);
+    rgb_.assign(static_cast<size_t>(w) * h, 0);
+  }
+  ~ZmbvDecoder() { inflateEnd(&zs_); }
+
+  bool decode(const std::vector<uint8_t>& frame) {
+    if (frame.empty()) return false;
+    const uint8_t flags = frame[0];
+    size_t at = 1;
+    if (flags & 0x01) {
+      if (frame.size() < 7 || frame[3] != 1 || frame[5] != 16 ||
+          frame[6] != 16)
+        return false;
+      format_ = frame[4];
+      at = 7;
+      inflateReset(&zs_);
+    }
+    std::vector<uint8_t> raw;
+    if (!inflate_all(frame.data() + at, frame.size() - at, raw)) return false;
+    const int bpp = format_ == ZmbvEncoder::kFormat8bpp ? 1 : 4;
+    const size_t n = static_cast<size_t>(w_) * h_;
+    size_t p = 0;
+    if (flags & 0x01) {
+      if (bpp == 1) {
+        if (raw.size() < 768) return false;
+        std::memcpy(pal_, raw.data(), 768);
+        p = 768;
+      }
+      if (raw.size() != p + (n * bpp)) return false;
+      px_.assign(raw.begin() + static_cast<long>(p), raw.end());
+    } else {
+      if (flags & 0x02) {
+        for (int i = 0; i < 768; ++i) pal_[i] ^= raw[i];
+        p = 768;
+      }
+      const int bx_n = (w_ + 15) / 16, by_n = (h_ + 15) / 16;
+      const size_t table = p;
+      p += (static_cast<size_t>(bx_n) * by_n * 2 + 3) & ~size_t{3};
+      for (int b = 0; b < bx_n * by_n; ++b) {
+        if (raw[table + (b * 2)] == 0) continue;
+        const int x0 = (b % bx_n) * 16, y0 = (b / bx_n) * 16;
+        const int bw = std::min(16, w_ - x0), bh = std::min(16, h_ - y0);
+        for (int y = y0; y < y0 + bh; ++y)
+          for (int k = 0; k < bw * bpp; ++k)
+            px_[(((static_cast<size_t>(y) * w_) + x0) * bpp) + k] ^= raw[p++];
+      }
+      if (p != raw.size()) return false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      if (bpp == 1) {
+        const uint8_t* c = &pal_[px_[i] * 3];
+        rgb_[i] = (uint32_t{c[0]} << 16) | (uint32_t{c[1]} << 8) | c[2];
+      } else {
+        const uint8_t* c = &px_[i * 4];
+        rgb_[i] = (uint32_t{c[2]} << 16) | (uint32_t{c[1]} << 8) | c[0];
+      }
+    }
+    return true;
+  }
+
+  uint8_t format() const { return format_; }
+  const std::vector<uint32_t>& rgb() const { return rgb_; }
+
+ private:
+  bool inflate_all(const uint8_t* in, size_t len, std::vector<uint8_t>& out) {
+    zs_.next_in = const_cast<uint8_t*>(in);
+    zs_.avail_in = static_cast<uInt>(len);
+    uint8_t buf[4096];
+    do {
+      zs_.next_out = buf;
+      zs_.avail_out = sizeof(buf);
+      const int rc = inflate(&zs_, Z_SYNC_FLUSH);
+      if (rc != Z_OK && rc != Z_BUF_ERROR) return false;
+      out.insert(out.end(), buf, buf + (sizeof(buf) - zs_.avail_out));
+    } while (zs_.avail_in != 0 || zs_.avail_out == 0);
+    return true;
+  }
+
+  int w_, h_;
+  z_stream zs_{};
+  uint8_t format_ = 0;
+  uint8_t pal_[768] = {};
+  std::vector<uint8_t> px_;
+  std::vector<uint32_t> rgb_;
+};
+
+struct Frame {
+  int w, h;
+  std::vector<uint8_t> rgba;
+  Frame(int w_, int h_) : w(w_), h(h_), rgba(static_cast<size_t>(w_) * h_ * 4) {}
+  void set(int x, int y, uint32_t c) {
+    uint8_t* p = &rgba[((static_cast<size_t>(y) * w) + x) * 4];
+    p[0] = static_cast<uint8_t>(c >> 16);
+    p[1] = static_cast<uint8_t>(c >> 8);
+    p[2] = static_cast<uint8_t>(c);
+    p[3] = 0xFF;
+  }
+  std::vector<uint32_t> rgb() const {
+    std::vector<uint32_t> v(static_cast<size_t>(w) * h);
+    for (size_t i = 0; i < v.size(); ++i)
+      v[i] = (uint32_t{rgba[i * 4]} << 16) | (uint32_t{rgba[(i * 4) + 1]} << 8) |
+             rgba[(i * 4) + 2];
+    return v;
+  }
+};
+
+// A CPC-like frame: a handful of colours in bands, odd size so edge blocks
+// are partial.
+Frame cpc_frame(int w, int h) {
+  Frame f(w, h);
+  static const uint32_t kInks[] = {0x000080, 0xFFFF00, 0x00FFFF, 0xFF0000};
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x) f.set(x, y, kInks[((x / 8) + (y / 4)) & 3]);
+  return f;
+}
+
+}  // namespace
+
+TEST(ZmbvCodec, KeyframeAndDeltasRoundTripExactly) {
+  constexpr int kW = 100, kH = 37;
+  ZmbvEncoder enc;
+  ASSERT_TRUE(enc.reset(kW, kH));
+  ZmbvDecoder dec(kW, kH);
+  Frame f = cpc_frame(kW, kH);
+  std::vector<uint8_t> out;
+  bool key = false;
+
+  ASSERT_TRUE(enc.encode(f.rgba.data(), kW * 4, out, key));
+  EXPECT_TRUE(key);
+  ASSERT_TRUE(dec.decode(out));
+  EXPECT_EQ(dec.format(), ZmbvEncoder::kFormat8bpp);
+  EXPECT_EQ(dec.rgb(), f.rgb());
+
+  for (int i = 0; i < 5; ++i) {
+    f.set((i * 23) % kW, (i * 7) % kH, 0xFFFF00);
+    f.set(kW - 1, kH - 1, i & 1 ? 0x000080 : 0xFF0000);  // partial corner block
+    ASSERT_TRUE(enc.encode(f.rgba.data(), kW * 4, out, key));
+    EXPECT_FALSE(key);
+    ASSERT_TRUE(dec.decode(out)) << "frame " << i;
+    EXPECT_EQ(dec.rgb(), f.rgb()) << "frame " << i;
+  }
+}
+
+TEST(ZmbvCodec, UnchangedFrameIsTiny) {
+  constexpr int kW = 384, kH = 272;
+  ZmbvEncoder enc;
+  ASSERT_TRUE(enc.reset(kW, kH));
+  Frame f = cpc_frame(kW, kH);
+  std::vector<uint8_t> out;
+  bool key = false;
+  ASSERT_TRUE(enc.encode(f.rgba.data(), kW * 4, out, key));
+  ASSERT_TRUE(enc.encode(f.rgba.data(), kW * 4, out, key));
+  EXPECT_FALSE(key);
+  EXPECT_LT(out.size(), 64u);
+}
+
+TEST(ZmbvCodec, NewColourGrowsPaletteInDelta) {
+  constexpr int kW = 32, kH = 32;
+  ZmbvEncoder enc;
+  ASSERT_TRUE(enc.reset(kW, kH));
+  ZmbvDecoder dec(kW, kH);
+  Frame f = cpc_frame(kW, kH);
+  std::vector<uint8_t> out;
+  bool key = false;
+  ASSERT_TRUE(enc.encode(f.rgba.data(), kW * 4, out, key));
+  ASSERT_TRUE(dec.decode(out));
+
+  f.set(3, 3, 0x123456);
+  ASSERT_TRUE(enc.encode(f.rgba.data(), kW * 4, out, key));
+  EXPECT_FALSE(key);
+  EXPECT_EQ(out[0], 0x02);  // palette-change flag
+  ASSERT_TRUE(dec.decode(out));
+  EXPECT_EQ(dec.rgb(), f.rgb());
+}
+
+TEST(ZmbvCodec, PaletteOverflowForcesKeyframeAnd32bpp) {
+  constexpr int kW = 32, kH = 32;  // 1024 pixels: room for > 256 colours
+  ZmbvEncoder enc;
+  ASSERT_TRUE(enc.reset(kW, kH));
+  ZmbvDecoder dec(kW, kH);
+  Frame f = cpc_frame(kW, kH);
+  std::vector<uint8_t> out;
+  bool key = false;
+  ASSERT_TRUE(enc.encode(f.rgba.data(), kW * 4, out, key));
+  ASSERT_TRUE(dec.decode(out));
+
+  for (int y = 0; y < kH; ++y)
+    for (int x = 0; x < kW; ++x)
+      f.set(x, y, static_cast<uint32_t>((y * kW) + x) * 0x010203u);
+  ASSERT_TRUE(enc.encode(f.rgba.data(), kW * 4, out, key));
+  EXPECT_TRUE(key);
+  ASSERT_TRUE(dec.decode(out));
+  EXPECT_EQ(dec.format(), ZmbvEncoder::kFormat32bpp);
+  EXPECT_EQ(dec.rgb(), f.rgb());
+
+  f.set(0, 0, 0xABCDEF);  // 32 bpp deltas never overflow
+  ASSERT_TRUE(enc.encode(f.rgba.data(), kW * 4, out, key));
+  EXPECT_FALSE(key);
+  ASSERT_TRUE(dec.decode(out));
+  EXPECT_EQ(dec.rgb(), f.rgb());
+}
+
+TEST(ZmbvCodec, KeyframeEveryInterval) {
+  constexpr int kW = 16, kH = 16;
+  ZmbvEncoder enc;
+  ASSERT_TRUE(enc.reset(kW, kH));
+  Frame f = cpc_frame(kW, kH);
+  std::vector<uint8_t> out;
+  int keys = 0;
+  for (int i = 0; i < (2 * ZmbvEncoder::kKeyInterval) + 1; ++i) {
+    bool key = false;
+    ASSERT_TRUE(enc.encode(f.rgba.data(), kW * 4, out, key));
+    if (key) {
+      EXPECT_EQ(i % ZmbvEncoder::kKeyInterval, 0) << "frame " << i;
+      keys++;
+    }
+  }
+  EXPECT_EQ(keys, 3);
+}
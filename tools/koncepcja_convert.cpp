@@ -0,0 +1,129 @@
+/* koncepcja_convert — headless batch flux / disc conversion.
+ *
+ * Converts IPF / KryoFlux RAW / A2R / HFE / SCP images — single files or
+ * whole directory trees — to .dsk, .scp or .hfe on every core, through the
+ * same pipeline as the emulator's Save-As (src/flux_convert.h). One line per
+ * file on stdout, with the weak / suspect sectors the decode flagged:
+ *
+ *   ok    games/elite.ipf -> games/elite.dsk weak=2 [0/0/C1 crc] [4/0/C3 ...]
+ *   skip  games/elite.scp: already scp
+ *   FAIL  games/odd.raw: unsupported or corrupt flux image
+ *
+ * then a summary on stderr. Exit status: 0 when nothing failed, 1 when a
+ * file failed, 2 on bad usage.
+ *
+ * Usage: koncepcja_convert --to dsk|scp|hfe [-o OUTDIR] [-j N] [--force]
+ *                          PATH...
+ *   -o OUTDIR  write under OUTDIR, mirroring each directory argument's tree
+ *              (default: beside each input)
+ *   -j N       worker threads (default: one per hardware thread)
+ *   --force    replace existing outputs (default: skip them)
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "flux_convert.h"
+
+namespace {
+
+int usage() {
+  std::fprintf(stderr,
+               "usage: koncepcja_convert --to dsk|scp|hfe [-o OUTDIR] [-j N] "
+               "[--force] PATH...\n");
+  return 2;
+}
+
+void print_result(const FluxConvertResult& r) {
+  switch (r.status) {
+    case FluxConvertResult::Status::Converted: {
+      std::printf("ok    %s -> %s", r.input.c_str(), r.output.c_str());
+      if (r.weak.count > 0) {
+        std::printf(" weak=%d", r.weak.count);
+        const int shown = r.weak.count < FLUX_WEAK_MAX ? r.weak.count
+                                                       : FLUX_WEAK_MAX;
+        for (int i = 0; i < shown; ++i) {
+          const FluxWeakSector& s = r.weak.sec[i];
+          std::printf(" [%u/%u/%02X %s]", s.cyl, s.side, s.sector_id,
+                      flux_weak_reason_text(s.reason));
+        }
+        if (shown < r.weak.count) std::printf(" ...");
+      }
+      std::printf("\n");
+      break;
+    }
+    case FluxConvertResult::Status::Skipped:
+      std::printf("skip  %s: %s\n", r.input.c_str(), r.error.c_str());
+      break;
+    case FluxConvertResult::Status::Failed:
+      std::printf("FAIL  %s: %s\n", r.input.c_str(), r.error.c_str());
+      break;
+  }
+  std::fflush(stdout);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  FluxConvertOptions opt;
+  bool have_to = false;
+  std::vector<std::string> inputs;
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--to") && i + 1 < argc) {
+      const std::string to = argv[++i];
+      if (to == "dsk") {
+        opt.to = SaveFormat::Dsk;
+      } else if (to == "scp") {
+        opt.to = SaveFormat::Scp;
+      } else if (to == "hfe") {
+        opt.to = SaveFormat::Hfe;
+      } else {
+        return usage();
+      }
+      have_to = true;
+    } else if (!std::strcmp(argv[i], "-o") && i + 1 < argc) {
+      opt.out_dir = argv[++i];
+    } else if (!std::strcmp(argv[i], "-j") && i + 1 < argc) {
+      const int n = std::atoi(argv[++i]);
+      if (n < 1) return usage();
+      opt.threads = static_cast<unsigned>(n);
+    } else if (!std::strcmp(argv[i], "--force")) {
+      opt.overwrite = true;
+    } else if (argv[i][0] == '-') {
+      return usage();
+    } else {
+      inputs.emplace_back(argv[i]);
+    }
+  }
+  if (!have_to || inputs.empty()) return usage();
+
+  int converted = 0, skipped = 0, failed = 0, weak_files = 0, weak_sectors = 0;
+  flux_convert_tree(inputs, opt,
+                    [&](const FluxConvertResult& r, int /*done*/,
+                        int /*total*/) {
+                      print_result(r);
+                      switch (r.status) {
+                        case FluxConvertResult::Status::Converted:
+                          ++converted;
+                          break;
+                        case FluxConvertResult::Status::Skipped:
+                          ++skipped;
+                          break;
+                        case FluxConvertResult::Status::Failed:
+                          ++failed;
+                          break;
+                      }
+                      if (r.weak.count > 0) {
+                        ++weak_files;
+                        weak_sectors += r.weak.count;
+                      }
+                    });
+  std::fprintf(stderr,
+               "koncepcja_convert: %d converted, %d skipped, %d failed; "
+               "%d weak sectors in %d files\n",
+               converted, skipped, failed, weak_sectors, weak_files);
+  return failed > 0 ? 1 : 0;
+}